@@ -0,0 +1,139 @@
+// Micro-benchmark for the built-in audio kernels: samples/second per kernel and instruction set
+#include "media/AudioKernels.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace DarkPlay::Media::AudioKernels;
+
+namespace {
+
+constexpr size_t BLOCK_FRAMES = 512;
+constexpr int CHANNELS = 2;
+constexpr int SURROUND_CHANNELS = 6;
+constexpr int WIDE_SURROUND_CHANNELS = 8;
+constexpr double MIN_RUN_SECONDS = 0.25;
+
+volatile float g_sink = 0.0f; // Keeps results observable so nothing is optimised away
+
+// Runs body (which processes samplesPerCall samples) until MIN_RUN_SECONDS have passed
+double measure(size_t samplesPerCall, const std::function<void()>& body)
+{
+    using Clock = std::chrono::steady_clock;
+
+    for (int i = 0; i < 64; ++i) {
+        body(); // Warm caches and the branch predictor
+    }
+
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double> elapsed{};
+    do {
+        for (int i = 0; i < 256; ++i) {
+            body();
+        }
+        calls += 256;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < MIN_RUN_SECONDS);
+
+    return static_cast<double>(calls * samplesPerCall) / elapsed.count();
+}
+
+void report(const char* kernel, double samplesPerSecond)
+{
+    std::printf("  %-24s %10.1f Msamples/s\n", kernel, samplesPerSecond / 1e6);
+}
+
+void runSuite()
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    std::vector<float> stereo(BLOCK_FRAMES * CHANNELS);
+    std::vector<float> surround(BLOCK_FRAMES * SURROUND_CHANNELS);
+    std::vector<float> wideSurround(BLOCK_FRAMES * WIDE_SURROUND_CHANNELS);
+    std::vector<float> scratch(BLOCK_FRAMES * SURROUND_CHANNELS);
+    std::vector<int16_t> pcm(BLOCK_FRAMES * CHANNELS);
+    for (float& sample : stereo) {
+        sample = distribution(random);
+    }
+    for (float& sample : surround) {
+        sample = distribution(random);
+    }
+    for (float& sample : wideSurround) {
+        sample = distribution(random);
+    }
+
+    const size_t stereoSamples = stereo.size();
+
+    report("applyGain", measure(stereoSamples, [&]() {
+        applyGain(stereo.data(), stereoSamples, 0.999f);
+        applyGain(stereo.data(), stereoSamples, 1.001f);
+    }) * 2.0);
+
+    report("applyGainRamp", measure(stereoSamples, [&]() {
+        applyGainRamp(stereo.data(), BLOCK_FRAMES, CHANNELS, 0.999f, 1.001f);
+    }));
+
+    report("floatToInt16", measure(stereoSamples, [&]() {
+        floatToInt16(stereo.data(), pcm.data(), stereoSamples);
+    }));
+
+    report("int16ToFloat", measure(stereoSamples, [&]() {
+        int16ToFloat(pcm.data(), scratch.data(), stereoSamples);
+    }));
+
+    report("downmix 5.1 -> stereo", measure(surround.size(), [&]() {
+        downmixToStereo(surround.data(), scratch.data(), BLOCK_FRAMES, SURROUND_CHANNELS);
+    }));
+
+    report("downmix 7.1 -> stereo", measure(wideSurround.size(), [&]() {
+        downmixToStereo(wideSurround.data(), scratch.data(), BLOCK_FRAMES, WIDE_SURROUND_CHANNELS);
+    }));
+
+    report("dotProduct (32 taps)", measure(32, [&]() {
+        g_sink = g_sink + dotProduct(stereo.data(), stereo.data() + 32, 32);
+    }));
+
+    // Input samples per second through a 44.1 -> 48 kHz stereo conversion
+    SincResampler resampler(CHANNELS, BLOCK_FRAMES);
+    resampler.setRatio(44100.0 / 48000.0);
+    std::vector<float> resampled(resampler.maxOutputFrames(BLOCK_FRAMES) * CHANNELS);
+    report("SincResampler 44.1->48k", measure(stereoSamples, [&]() {
+        resampler.process(stereo.data(), BLOCK_FRAMES, resampled.data(), resampled.size() / CHANNELS);
+    }));
+
+    // Input samples per second through a 1.5x tempo change at 48 kHz
+    TimeStretch stretch(CHANNELS, 48000, BLOCK_FRAMES);
+    stretch.setRate(1.5);
+    std::vector<float> stretched(BLOCK_FRAMES * CHANNELS);
+    report("TimeStretch 1.5x", measure(stereoSamples, [&]() {
+        stretch.write(stereo.data(), BLOCK_FRAMES);
+        while (stretch.read(stretched.data(), BLOCK_FRAMES) > 0) {
+        }
+    }));
+
+    for (float sample : scratch) {
+        g_sink = g_sink + sample;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::printf("DarkPlay audio kernels, %zu-frame blocks\n", BLOCK_FRAMES);
+
+    for (InstructionSet set : {InstructionSet::Scalar, InstructionSet::AVX2, InstructionSet::NEON}) {
+        if (!isSupported(set)) {
+            continue;
+        }
+        setInstructionSet(set);
+        std::printf("\n[%s]\n", instructionSetName(set));
+        runSuite();
+    }
+
+    return 0;
+}
@@ -0,0 +1,493 @@
+// Headless playback benchmark: startup, time-to-first-frame, seek latency, playlist
+// advance gap, ConfigManager throughput and plugin load times, reported as JSON
+#include "controllers/MediaController.h"
+#include "core/Application.h"
+#include "core/ConfigManager.h"
+#include "core/PluginManager.h"
+#include "media/KeyframeIndex.h"
+#include "media/MediaManager.h"
+#include "utils/QtEnvironmentSetup.h"
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QTimer>
+#include <QVideoFrame>
+#include <QVideoSink>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+
+using namespace DarkPlay;
+
+namespace {
+
+constexpr int SCHEMA_VERSION = 1;
+constexpr int POLL_INTERVAL_MS = 1;
+constexpr qint64 SEEK_END_MARGIN_MS = 1000;
+constexpr qint64 ADVANCE_LEAD_MS = 1500; // Playback starts this far before the end of an item
+
+QElapsedTimer g_clock;
+
+double elapsedMs(qint64 fromNs, qint64 toNs)
+{
+    return static_cast<double>(toNs - fromNs) / 1e6;
+}
+
+// Spins the event loop until done() holds or timeoutMs passes
+bool waitUntil(const std::function<bool()>& done, int timeoutMs)
+{
+    if (done()) {
+        return true;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QEventLoop loop;
+    QTimer poll;
+    poll.setInterval(POLL_INTERVAL_MS);
+    QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+        if (done() || timer.hasExpired(timeoutMs)) {
+            loop.quit();
+        }
+    });
+    poll.start();
+    loop.exec();
+    return done();
+}
+
+void settle(int ms)
+{
+    waitUntil([]() { return false; }, ms);
+}
+
+QJsonObject distribution(QList<double> samples)
+{
+    QJsonObject result;
+    result["count"] = static_cast<int>(samples.size());
+    if (samples.isEmpty()) {
+        return result;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double p) {
+        const auto index = static_cast<qsizetype>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples.at(std::min(index, samples.size() - 1));
+    };
+
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result["meanMs"] = sum / static_cast<double>(samples.size());
+    result["p50Ms"] = percentile(0.50);
+    result["p95Ms"] = percentile(0.95);
+    result["p99Ms"] = percentile(0.99);
+    result["maxMs"] = samples.last();
+    return result;
+}
+
+/**
+ * @brief Video sink with no renderer: it only timestamps the frames it receives
+ *
+ * Audio-only media never delivers frames; position updates stand in for them.
+ */
+class FrameProbe
+{
+public:
+    FrameProbe()
+        : m_sink(std::make_unique<QVideoSink>())
+    {
+        // Direct: stamp frames on the delivering thread, before any queueing
+        QObject::connect(m_sink.get(), &QVideoSink::videoFrameChanged, m_sink.get(),
+                         [this](const QVideoFrame& frame) {
+                             if (frame.isValid()) {
+                                 m_lastStartUs.store(frame.startTime(), std::memory_order_relaxed);
+                                 m_lastArrivalNs.store(g_clock.nsecsElapsed(), std::memory_order_relaxed);
+                                 m_frames.fetch_add(1, std::memory_order_release);
+                             }
+                         }, Qt::DirectConnection);
+    }
+
+    [[nodiscard]] QVideoSink* sink() const { return m_sink.get(); }
+    [[nodiscard]] quint64 frames() const { return m_frames.load(std::memory_order_acquire); }
+    [[nodiscard]] qint64 lastStartUs() const { return m_lastStartUs.load(std::memory_order_relaxed); }
+    [[nodiscard]] qint64 lastArrivalNs() const { return m_lastArrivalNs.load(std::memory_order_relaxed); }
+
+    void markActivity()
+    {
+        m_lastArrivalNs.store(g_clock.nsecsElapsed(), std::memory_order_relaxed);
+        m_frames.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    std::unique_ptr<QVideoSink> m_sink;
+    std::atomic<quint64> m_frames{0};
+    std::atomic<qint64> m_lastStartUs{-1};
+    std::atomic<qint64> m_lastArrivalNs{0};
+};
+
+struct Options {
+    QStringList mediaFiles;
+    int seeks{50};
+    int repeats{3};
+    int configOperations{10000};
+    int timeoutMs{10000};
+    quint32 seed{42};
+};
+
+class Benchmark
+{
+public:
+    Benchmark(Controllers::MediaController& controller, const Options& options)
+        : m_controller(controller)
+        , m_options(options)
+        , m_random(options.seed)
+    {
+        m_controller.setVideoSink(m_probe.sink());
+
+        // Audio-only media: position updates are the only sign of playback
+        QObject::connect(&m_controller, &Controllers::MediaController::positionChanged, &m_controller,
+                         [this](qint64 position) {
+                             if (position > 0 && !m_controller.hasVideo()) {
+                                 m_probe.markActivity();
+                             }
+                         });
+    }
+
+    QJsonObject measureMedia(const QString& filePath)
+    {
+        QJsonObject result;
+        result["file"] = QFileInfo(filePath).fileName();
+
+        const std::optional<double> coldMs = timeToFirstFrame(filePath);
+        if (!coldMs) {
+            result["error"] = "No frame within the timeout";
+            return result;
+        }
+        result["timeToFirstFrameMs"] = *coldMs;
+        result["durationMs"] = m_controller.duration();
+        result["hasVideo"] = m_controller.hasVideo();
+
+        QList<double> warm;
+        for (int i = 0; i < m_options.repeats; ++i) {
+            if (const auto ms = timeToFirstFrame(filePath)) {
+                warm.append(*ms);
+            }
+        }
+        result["warmTimeToFirstFrame"] = distribution(warm);
+
+        QJsonObject seeks;
+        seeks["exact"] = measureSeeks(Media::SeekMode::Exact);
+
+        // Fast seeks are only meaningful once the keyframe table exists
+        QElapsedTimer indexTimer;
+        indexTimer.start();
+        auto* keyframes = Media::KeyframeIndex::instance();
+        const bool indexed = waitUntil([&]() { return keyframes->lookup(filePath).has_value(); }, m_options.timeoutMs);
+        result["keyframeIndexAvailable"] = indexed;
+        if (indexed) {
+            result["keyframeIndexWaitMs"] = static_cast<double>(indexTimer.nsecsElapsed()) / 1e6;
+            result["keyframeCount"] = static_cast<int>(keyframes->lookup(filePath)->keyframesMs.size());
+            seeks["fast"] = measureSeeks(Media::SeekMode::Fast);
+        }
+        result["seek"] = seeks;
+
+        m_controller.stop();
+        return result;
+    }
+
+    QJsonObject measurePlaylistAdvance(const QStringList& files)
+    {
+        QJsonObject result;
+        if (files.size() < 2) {
+            result["skipped"] = "Needs at least two media files";
+            return result;
+        }
+
+        QStringList urls;
+        for (const QString& file : files) {
+            urls.append(QUrl::fromLocalFile(file).toString());
+        }
+
+        Media::MediaManager* manager = m_controller.mediaManager();
+        const bool autoPlay = manager->autoPlay();
+        const bool preroll = manager->prerollEnabled();
+        manager->setAutoPlay(true);
+        manager->setPlaylist(urls);
+
+        manager->setPrerollEnabled(false);
+        result["plain"] = measureAdvances(static_cast<int>(urls.size()));
+        manager->setPrerollEnabled(true);
+        result["preroll"] = measureAdvances(static_cast<int>(urls.size()));
+
+        manager->setPrerollEnabled(preroll);
+        manager->setAutoPlay(autoPlay);
+        m_controller.stop();
+        return result;
+    }
+
+private:
+    std::optional<double> timeToFirstFrame(const QString& filePath)
+    {
+        m_controller.stop();
+        settle(50);
+
+        const quint64 framesBefore = m_probe.frames();
+        const qint64 startNs = g_clock.nsecsElapsed();
+        if (!m_controller.openFile(filePath)) {
+            return std::nullopt;
+        }
+        m_controller.play();
+
+        if (!waitUntil([&]() { return m_probe.frames() > framesBefore; }, m_options.timeoutMs)) {
+            return std::nullopt;
+        }
+        return elapsedMs(startNs, m_probe.lastArrivalNs());
+    }
+
+    // Paused seeks to random targets: request to the first frame shown afterwards
+    QJsonObject measureSeeks(Media::SeekMode mode)
+    {
+        QJsonObject result;
+        const qint64 duration = m_controller.duration();
+        if (duration <= SEEK_END_MARGIN_MS || !m_controller.hasVideo()) {
+            result["skipped"] = "Needs video longer than a second";
+            return result;
+        }
+
+        m_controller.setSeekMode(mode);
+        m_controller.pause();
+        settle(100);
+
+        std::uniform_int_distribution<qint64> targets(0, duration - SEEK_END_MARGIN_MS);
+        QList<double> latencies;
+        QList<double> landingErrors;
+        int timeouts = 0;
+        for (int i = 0; i < m_options.seeks; ++i) {
+            const qint64 target = targets(m_random);
+            const quint64 framesBefore = m_probe.frames();
+            const qint64 startNs = g_clock.nsecsElapsed();
+            m_controller.seek(target);
+
+            if (!waitUntil([&]() { return m_probe.frames() > framesBefore; }, m_options.timeoutMs)) {
+                ++timeouts;
+                continue;
+            }
+            latencies.append(elapsedMs(startNs, m_probe.lastArrivalNs()));
+            if (m_probe.lastStartUs() >= 0) {
+                landingErrors.append(std::abs(static_cast<double>(m_probe.lastStartUs()) / 1000.0
+                                              - static_cast<double>(target)));
+            }
+            settle(20); // Frames still in flight belong to this seek
+        }
+
+        result = distribution(latencies);
+        result["timeouts"] = timeouts;
+        result["landingError"] = distribution(landingErrors);
+        m_controller.setSeekMode(Media::SeekMode::Exact);
+        return result;
+    }
+
+    // Last frame of one item to the first frame of the next
+    QJsonObject measureAdvances(int count)
+    {
+        Media::MediaManager* manager = m_controller.mediaManager();
+        QList<double> gaps;
+        int timeouts = 0;
+
+        for (int index = 0; index + 1 < count; ++index) {
+            manager->setCurrentIndex(index);
+            manager->play();
+            if (!waitUntil([&]() { return manager->duration() > 0 && manager->state() == Media::PlaybackState::Playing; },
+                           m_options.timeoutMs)) {
+                ++timeouts;
+                continue;
+            }
+            m_controller.seek(std::max<qint64>(0, manager->duration() - ADVANCE_LEAD_MS));
+
+            qint64 lastFrameNs = 0;
+            const auto connection = QObject::connect(manager, &Media::MediaManager::currentIndexChanged, manager,
+                                                     [&](int) { lastFrameNs = m_probe.lastArrivalNs(); });
+            const bool advanced = waitUntil([&]() { return manager->currentIndex() == index + 1; },
+                                            m_options.timeoutMs);
+            const quint64 framesAtAdvance = m_probe.frames();
+            const bool started = advanced
+                && waitUntil([&]() { return m_probe.frames() > framesAtAdvance; }, m_options.timeoutMs);
+            QObject::disconnect(connection);
+
+            if (!started || lastFrameNs == 0) {
+                ++timeouts;
+                continue;
+            }
+            gaps.append(elapsedMs(lastFrameNs, m_probe.lastArrivalNs()));
+        }
+
+        manager->stop();
+        QJsonObject result = distribution(gaps);
+        result["timeouts"] = timeouts;
+        return result;
+    }
+
+    Controllers::MediaController& m_controller;
+    Options m_options;
+    FrameProbe m_probe;
+    std::mt19937 m_random;
+};
+
+QJsonObject measureConfig(Core::ConfigManager& config, int operations)
+{
+    QJsonObject result;
+    constexpr int KEY_COUNT = 64;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < operations; ++i) {
+        config.setValue(QString("bench/key%1").arg(i % KEY_COUNT), i);
+    }
+    const qint64 writeNs = timer.nsecsElapsed();
+
+    timer.restart();
+    qint64 checksum = 0;
+    for (int i = 0; i < operations; ++i) {
+        checksum += config.getValue(QString("bench/key%1").arg(i % KEY_COUNT), 0).toInt();
+    }
+    const qint64 readNs = timer.nsecsElapsed();
+
+    timer.restart();
+    config.sync();
+    const qint64 syncNs = timer.nsecsElapsed();
+
+    for (int i = 0; i < KEY_COUNT; ++i) {
+        config.remove(QString("bench/key%1").arg(i));
+    }
+    config.sync();
+
+    result["operations"] = operations;
+    result["writesPerSecond"] = writeNs > 0 ? static_cast<double>(operations) * 1e9 / static_cast<double>(writeNs) : 0.0;
+    result["readsPerSecond"] = readNs > 0 ? static_cast<double>(operations) * 1e9 / static_cast<double>(readNs) : 0.0;
+    result["syncMs"] = static_cast<double>(syncNs) / 1e6;
+    result["checksum"] = static_cast<double>(checksum); // Keeps the reads observable
+    return result;
+}
+
+QJsonArray pluginTimings(const Core::PluginManager& plugins)
+{
+    QJsonArray result;
+    for (const Core::PluginManager::PluginTiming& timing : plugins.pluginTimings()) {
+        QJsonObject plugin;
+        plugin["name"] = timing.name;
+        plugin["loadUs"] = static_cast<double>(timing.loadUs);
+        plugin["initUs"] = static_cast<double>(timing.initUs);
+        plugin["instantiated"] = timing.instantiated;
+        result.append(plugin);
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    g_clock.start();
+
+    // No window system, and nothing the benchmark writes may touch the user's settings or caches
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QStandardPaths::setTestModeEnabled(true);
+    Core::Application::setApplicationMetadata();
+    Utils::setupOptimalQtEnvironment(true);
+
+    const qint64 constructStartNs = g_clock.nsecsElapsed();
+    Core::Application app(argc, argv);
+    const qint64 constructEndNs = g_clock.nsecsElapsed();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("DarkPlay headless playback benchmark");
+    parser.addHelpOption();
+    parser.addPositionalArgument("media", "Reference media files");
+    const QCommandLineOption outputOption({"o", "output"}, "Write the JSON report to <file> instead of stdout", "file");
+    const QCommandLineOption seeksOption("seeks", "Seeks per file and mode", "count", "50");
+    const QCommandLineOption repeatsOption("repeats", "Warm opens per file", "count", "3");
+    const QCommandLineOption configOption("config-ops", "ConfigManager reads and writes", "count", "10000");
+    const QCommandLineOption timeoutOption("timeout-ms", "Give up on a single wait after this long", "ms", "10000");
+    const QCommandLineOption seedOption("seed", "Seed for the seek targets", "seed", "42");
+    parser.addOptions({outputOption, seeksOption, repeatsOption, configOption, timeoutOption, seedOption});
+    parser.process(app);
+
+    Options options;
+    for (const QString& file : parser.positionalArguments()) {
+        const QFileInfo fileInfo(file);
+        if (!fileInfo.isFile()) {
+            std::fprintf(stderr, "Not a file: %s\n", qPrintable(file));
+            return 2;
+        }
+        options.mediaFiles.append(fileInfo.absoluteFilePath());
+    }
+    options.seeks = std::max(0, parser.value(seeksOption).toInt());
+    options.repeats = std::max(0, parser.value(repeatsOption).toInt());
+    options.configOperations = std::max(1, parser.value(configOption).toInt());
+    options.timeoutMs = std::max(100, parser.value(timeoutOption).toInt());
+    options.seed = parser.value(seedOption).toUInt();
+
+    const qint64 initializeStartNs = g_clock.nsecsElapsed();
+    if (!app.initialize()) {
+        std::fprintf(stderr, "Failed to initialize the application\n");
+        return 1;
+    }
+    const qint64 initializeEndNs = g_clock.nsecsElapsed();
+
+    const qint64 controllerStartNs = g_clock.nsecsElapsed();
+    Controllers::MediaController controller;
+    const qint64 controllerEndNs = g_clock.nsecsElapsed();
+
+    QJsonObject report;
+    report["schemaVersion"] = SCHEMA_VERSION;
+    report["darkplayVersion"] = QCoreApplication::applicationVersion();
+    report["qtVersion"] = QString::fromLatin1(qVersion());
+    report["platform"] = QSysInfo::prettyProductName();
+    report["cpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["engine"] = controller.engineId();
+
+    QJsonObject startup;
+    startup["applicationMs"] = elapsedMs(constructStartNs, constructEndNs);
+    startup["initializeMs"] = elapsedMs(initializeStartNs, initializeEndNs);
+    startup["mediaControllerMs"] = elapsedMs(controllerStartNs, controllerEndNs);
+    report["startup"] = startup;
+
+    report["plugins"] = pluginTimings(*app.pluginManager());
+    report["config"] = measureConfig(*app.configManager(), options.configOperations);
+
+    Benchmark benchmark(controller, options);
+    QJsonArray media;
+    for (const QString& file : std::as_const(options.mediaFiles)) {
+        media.append(benchmark.measureMedia(file));
+    }
+    report["media"] = media;
+    report["playlistAdvance"] = benchmark.measurePlaylistAdvance(options.mediaFiles);
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+            std::fprintf(stderr, "Cannot write %s\n", qPrintable(parser.value(outputOption)));
+            return 1;
+        }
+    } else {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return 0;
+}
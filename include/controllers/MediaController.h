@@ -6,8 +6,14 @@
 #include <QTimer>
 #include <QVideoSink>
 #include <memory>
+#include "media/ExportQueue.h"
 #include "media/MediaManager.h"
+#include "media/VideoFanout.h"
 #include "media/IMediaEngine.h"
+#include "utils/MemoryBudget.h"
+
+namespace DarkPlay::Core { class ResumePositionStore; }
+namespace DarkPlay::Media { class MediaLibrary; class SubtitleService; class ThumbnailService; }
 
 namespace DarkPlay::Controllers {
 
@@ -25,6 +31,13 @@ public:
 
     // Media Manager access
     [[nodiscard]] Media::MediaManager* mediaManager() const { return m_mediaManager.get(); }
+    [[nodiscard]] Media::PlaybackSnapshotPtr snapshot() const noexcept { return m_mediaManager->snapshot(); }
+    [[nodiscard]] Media::ThumbnailService* thumbnailService() const { return m_thumbnailService.get(); }
+    [[nodiscard]] Media::SubtitleService* subtitleService() const { return m_subtitleService.get(); }
+    [[nodiscard]] Media::MediaLibrary* library() const { return m_library.get(); }
+    [[nodiscard]] Media::ExportQueue* exportQueue() const { return m_exportQueue.get(); }
+    // The engine renders into its input; the window and any video wall are its outputs
+    [[nodiscard]] Media::VideoFanout* videoFanout() const { return m_videoFanout.get(); }
 
     // High-level playback control
     bool openFile(const QString& filePath);
@@ -37,6 +50,14 @@ public:
     // Seeking and position
     void seek(qint64 position);
     void seekRelative(qint64 offset);
+    // Slider drags: throttled keyframe seeks while moving, one exact seek on release
+    void scrubTo(qint64 position);
+    void endScrub(qint64 position);
+    // Negative steps go back; pauses playback
+    bool stepFrame(int frames);
+    // Fast snaps user seeks to indexed keyframes, per playback/seekMode
+    void setSeekMode(Media::SeekMode mode);
+    [[nodiscard]] Media::SeekMode seekMode() const;
     [[nodiscard]] qint64 position() const;
     [[nodiscard]] qint64 duration() const;
 
@@ -66,6 +87,32 @@ public:
     void setVideoSink(QVideoSink* sink);
     [[nodiscard]] QVideoSink* videoSink() const;
 
+    // Frame timing instrumentation
+    [[nodiscard]] Media::FrameStats frameStats() const;
+    void reportFramePresented(qint64 presentationTimeUs);
+
+    // Network streaming health (inactive for local files)
+    [[nodiscard]] Media::StreamingStats streamingStats() const;
+
+    // Cache memory by subsystem, against the process-wide budget
+    [[nodiscard]] Utils::MemoryStats memoryStats() const;
+
+    // Outputs showing the video and how far apart they draw the same frame
+    [[nodiscard]] Media::VideoFanoutStats videoFanoutStats() const { return m_videoFanout->stats(); }
+
+    // Where playback is by the master clock, and how far the video strays from it
+    [[nodiscard]] Media::ClockStats clockStats() const { return m_mediaManager->clockStats(); }
+
+    // Transcodes beside playback; endMs -1 runs to the end. Returns the job id
+    int exportRange(const QUrl& source, const QString& outputPath, qint64 startMs = 0, qint64 endMs = -1);
+    // Every playlist entry into directory, one file each; returns the job ids
+    QList<int> exportPlaylist(const QString& directory, const QString& format = QString());
+    // A codec plugin that canEncode() the job's format, else the built-in transcoder (Qt 6.8+)
+    [[nodiscard]] static Media::TranscoderInstance createTranscoder(const Media::ExportJob& job);
+
+    // Id of the active engine in MediaEngineRegistry
+    [[nodiscard]] QString engineId() const { return m_engineId; }
+
 public slots:
     // Convenience slots for UI binding
     void onPlayRequested();
@@ -102,9 +149,48 @@ private slots:
 private:
     void setupConnections();
     void initializeDefaultEngine();  // Remove static keyword
-
+    // Engines come from MediaEngineRegistry, per media/defaultEngine and media/hardwareAcceleration
+    bool installEngine(const QString& engineId, bool hardwareDecoding);
+    // Replaces the engine and reopens the current media where it was
+    void switchEngine(const QString& engineId, bool hardwareDecoding, bool resumePlayback);
+    void connectEnginePlugins();
+    void refreshPluginEngines();
+    void releasePluginEngines(const QString& pluginName);
+    void onHardwareDecodingFailed(const QString& reason);
+    // Recreates the media in an engine that can be created without hardware decoding
+    void fallBackToSoftwareEngine(const QString& reason);
+    void onEngineSettingChanged(const QString& key, const QVariant& value);
+    [[nodiscard]] QString preferredEngineId() const;
+    void connectAudioEffectPlugins();
+    // Resume positions, per playback/rememberPosition
+    void connectResumePositions();
+    void connectSeekMode();
+    // Sidecar subtitles, per media/subtitleAutoLoad
+    void connectSubtitles();
+    void connectLibrary();
+    void connectMemoryBudget();
+    // Export workers, per export/maxJobs
+    void connectExport();
+    [[nodiscard]] Core::ResumePositionStore* resumePositionStore() const;
+    // Hands the enabled IAudioEffectPlugin set to the engine, minus a plugin that is going away
+    void refreshAudioEffects(const QString& excludedPlugin = QString());
+
+    // Declared first so the engine lets go of its input sink before it goes
+    std::unique_ptr<Media::VideoFanout> m_videoFanout;
     std::unique_ptr<Media::MediaManager> m_mediaManager;
+    QString m_engineId;
+    QString m_engineOwner;        // Plugin providing the active engine, empty for built-ins
+    bool m_hardwareDecoding;
+    QString m_softwareFallbackUrl; // Media already retried in software
+    std::unique_ptr<Media::ThumbnailService> m_thumbnailService; // Seek previews for the current file
+    std::unique_ptr<Media::SubtitleService> m_subtitleService;
+    std::unique_ptr<Media::MediaLibrary> m_library;
+    std::unique_ptr<Media::ExportQueue> m_exportQueue;
     QString m_lastError;
+
+    bool m_rememberPosition;
+    QString m_resumeKey;     // Store key of the current media
+    qint64 m_resumeTargetMs; // Ticks before the resume seek lands are not recorded
 };
 
 } // namespace DarkPlay::Controllers
@@ -0,0 +1,66 @@
+#ifndef DARKPLAY_CONTROLLERS_REMOTECONTROL_H
+#define DARKPLAY_CONTROLLERS_REMOTECONTROL_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QPointer>
+#include <QStringList>
+#include "media/IMediaTranscoder.h"
+
+namespace DarkPlay::Controllers {
+
+class MediaController;
+
+/**
+ * @brief Command interface behind the single-instance socket
+ *
+ * Maps request objects ({"command": "open", "path": ...}) onto MediaController
+ * and answers each with a reply object. Commands: open, enqueue, seek, play,
+ * pause, stop, toggle, next, previous, volume, mute, step, status, ping, raise.
+ */
+class RemoteControl : public QObject
+{
+    Q_OBJECT
+
+public:
+    // What a launch asks for: the requests to run here or hand to the running instance
+    struct LaunchRequest {
+        QList<QJsonObject> requests;
+        bool newInstance{false};
+        bool lowMemory{false}; // Applies to this process only, never forwarded
+        QList<Media::ExportJob> exports; // --export: transcoded here without a window, never forwarded
+        int exportJobs{0};               // --jobs, 0 for export/maxJobs
+        QString traceFile; // --trace: this process's timeline, written when it exits
+        bool helpRequested{false};
+        QString message; // Help text or the parse error
+    };
+
+    explicit RemoteControl(MediaController* controller, QObject* parent = nullptr);
+    ~RemoteControl() override;
+
+    [[nodiscard]] QJsonObject execute(const QJsonObject& request);
+
+    // Command line: files or URLs, --enqueue, --seek <ms|[hh:]mm:ss>, --new-instance, --low-memory,
+    // --export <file|dir> with --from, --to, --format, --jobs and --speed, --trace <file>
+    [[nodiscard]] static LaunchRequest parseArguments(const QStringList& arguments);
+
+signals:
+    // A file or URL was opened on request, for the recent files list
+    void mediaOpened(const QString& path);
+    // The window should come to the front
+    void activationRequested();
+
+private:
+    [[nodiscard]] QJsonObject open(const QJsonObject& request);
+    [[nodiscard]] QJsonObject enqueue(const QJsonObject& request);
+    [[nodiscard]] QJsonObject status() const;
+
+    [[nodiscard]] static QString mediaLocation(const QJsonObject& request);
+
+    QPointer<MediaController> m_controller;
+};
+
+} // namespace DarkPlay::Controllers
+
+#endif // DARKPLAY_CONTROLLERS_REMOTECONTROL_H
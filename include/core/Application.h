@@ -12,6 +12,8 @@ namespace DarkPlay::Core {
 class PluginManager;
 class ThemeManager;
 class ConfigManager;
+class ResumePositionStore;
+class StartupProfiler;
 
 /**
  * @brief Main application class that manages core systems
@@ -34,6 +36,9 @@ public:
     // Thread-safe singleton access
     [[nodiscard]] static Application* instance() noexcept;
 
+    // Names that locate settings and data; main() applies them before the instance exists
+    static void setApplicationMetadata();
+
     // Core system accessors with null checks and const correctness
     [[nodiscard]] PluginManager* pluginManager() const noexcept {
         return m_pluginManager.get();
@@ -47,6 +52,14 @@ public:
         return m_configManager.get();
     }
 
+    [[nodiscard]] ResumePositionStore* resumePositionStore() const noexcept {
+        return m_resumePositionStore.get();
+    }
+
+    [[nodiscard]] StartupProfiler* startupProfiler() const noexcept {
+        return m_startupProfiler.get();
+    }
+
     // Application lifecycle with exception safety
     bool initialize() noexcept;
     void shutdown() noexcept;
@@ -68,7 +81,9 @@ private:
     // Ensure proper initialization order
     void validateCoreComponents() const;
 
+    std::unique_ptr<StartupProfiler> m_startupProfiler; // Created first - its clock is the startup baseline
     std::unique_ptr<ConfigManager> m_configManager;
+    std::unique_ptr<ResumePositionStore> m_resumePositionStore;
     std::unique_ptr<ThemeManager> m_themeManager;
     std::unique_ptr<PluginManager> m_pluginManager;
 
@@ -2,18 +2,62 @@
 #define DARKPLAY_CORE_CONFIGMANAGER_H
 
 #include <QObject>
+#include <QHash>
+#include <QSet>
 #include <QSettings>
 #include <QJsonObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
 #include <QVariant>
 #include <QMutex>
-#include <QReadWriteLock>
+#include <atomic>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace DarkPlay::Core {
 
+/**
+ * @brief Typed handle for a configuration key
+ *
+ * Built once, so hot paths skip key validation and carry their own default.
+ * Handles always name absolute keys, whatever group is open.
+ */
+template<typename T>
+class ConfigKey
+{
+public:
+    ConfigKey(QString path, T defaultValue)
+        : m_path(std::move(path))
+        , m_defaultValue(std::move(defaultValue))
+    {
+    }
+
+    [[nodiscard]] const QString& path() const noexcept { return m_path; }
+    [[nodiscard]] const T& defaultValue() const noexcept { return m_defaultValue; }
+
+private:
+    QString m_path;
+    T m_defaultValue;
+};
+
+// Keys read or written from hot paths
+namespace ConfigKeys {
+    inline const ConfigKey<QString> Theme{QStringLiteral("ui/theme"), QStringLiteral("dark")};
+    inline const ConfigKey<double> Volume{QStringLiteral("media/volume"), 0.7};
+    inline const ConfigKey<bool> AutoPlay{QStringLiteral("playback/autoPlay"), true};
+    inline const ConfigKey<QStringList> RecentFiles{QStringLiteral("files/recentFiles"), QStringList()};
+}
+
 /**
  * @brief Thread-safe manager for application configuration and settings
  * Provides RAII-compliant configuration management with proper error handling
+ *
+ * Values live in an immutable in-memory snapshot that readers load without
+ * locking. Writers publish a new snapshot and mark keys dirty; dirty keys go
+ * to QSettings in one batch on a background thread shortly after the last
+ * write, and synchronously on sync().
  */
 class ConfigManager : public QObject
 {
@@ -21,7 +65,7 @@ class ConfigManager : public QObject
 
 public:
     explicit ConfigManager(QObject* parent = nullptr);
-    ~ConfigManager() override = default;
+    ~ConfigManager() override;
 
     // Delete copy and move operations for singleton-like behavior
     ConfigManager(const ConfigManager&) = delete;
@@ -35,6 +79,22 @@ public:
     [[nodiscard]] bool contains(const QString& key) const noexcept;
     bool remove(const QString& key) noexcept;
 
+    // Typed access - no key parsing, the handle carries the default
+    template<typename T>
+    [[nodiscard]] T value(const ConfigKey<T>& key) const
+    {
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        const auto it = current->values.constFind(key.path());
+        return it == current->values.cend() ? key.defaultValue() : it->template value<T>();
+    }
+
+    template<typename T>
+    bool setValue(const ConfigKey<T>& key, const std::type_identity_t<T>& value) noexcept
+    {
+        const QVariant variant = QVariant::fromValue(value);
+        return validateValue(key.path(), variant) && store(key.path(), variant);
+    }
+
     // Sections management - thread-safe
     bool beginGroup(const QString& prefix) noexcept;
     void endGroup() noexcept;
@@ -45,10 +105,13 @@ public:
     [[nodiscard]] QJsonObject getSection(const QString& section) const;
     bool setSection(const QString& section, const QJsonObject& data) noexcept;
 
-    // File operations with error handling
+    // File operations with error handling - sync() writes pending changes and waits for them
     bool sync() noexcept;
     [[nodiscard]] QString fileName() const noexcept;
 
+    // For the few settings needed before the application object exists; reads the file directly
+    [[nodiscard]] static QVariant storedValue(const QString& key, const QVariant& defaultValue = QVariant());
+
     // Default configuration
     bool loadDefaults() noexcept;
     bool resetToDefaults() noexcept;
@@ -63,7 +126,14 @@ signals:
     void errorOccurred(const QString& error);
 
 private:
+    struct Snapshot {
+        QHash<QString, QVariant> values; // By absolute key
+        QStringList groups;              // Open beginGroup() prefixes
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
     void setupDefaults() noexcept;
+    [[nodiscard]] static QString configFilePath();
     [[nodiscard]] static QJsonObject variantMapToJson(const QVariantMap& map) noexcept;
     [[nodiscard]] static QVariantMap jsonToVariantMap(const QJsonObject& json) noexcept;
 
@@ -71,13 +141,30 @@ private:
     [[nodiscard]] bool validateValue(const QString& key, const QVariant& value) const noexcept;
     void emitError(const QString& error) const noexcept;
 
-    std::unique_ptr<QSettings> m_settings;
-    mutable QReadWriteLock m_lock; // Read-write lock for better performance
+    // Snapshot helpers
+    [[nodiscard]] static QString groupPrefix(const Snapshot& snapshot);
+    [[nodiscard]] static QStringList childrenOf(const Snapshot& snapshot, bool groups);
+    bool store(const QString& absoluteKey, const QVariant& value) noexcept;
+    template<typename Mutator>
+    void publish(Mutator&& mutate); // Expects m_writeMutex to be held
+
+    // Write-behind
+    void scheduleFlush();
+    void flushPending();
+
+    std::unique_ptr<QSettings> m_settings; // Only touched on m_ioPool once loaded
+    QString m_fileName;
+    std::atomic<SnapshotPtr> m_snapshot;
+    QMutex m_writeMutex;      // Serialises writers; readers never lock
+    QSet<QString> m_dirtyKeys; // Guarded by m_writeMutex
+    bool m_clearPending{false}; // Guarded by m_writeMutex
     std::atomic<bool> m_initialized{false};
+    std::atomic<bool> m_flushFailed{false};
+
+    QTimer m_flushTimer;
+    QThreadPool m_ioPool;
 
-    // Track group state for proper nesting
-    mutable QString m_currentGroup;
-    mutable int m_groupDepth{0};
+    static constexpr int FLUSH_DELAY_MS = 1000;
 };
 
 } // namespace DarkPlay::Core
@@ -0,0 +1,63 @@
+#ifndef DARKPLAY_CORE_PLUGININDEX_H
+#define DARKPLAY_CORE_PLUGININDEX_H
+
+#include <QFileInfo>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+namespace DarkPlay::Core {
+
+/**
+ * @brief What is known about a plugin library without instantiating it
+ *
+ * Entries are keyed by path, size and modification time and persist under
+ * CacheLocation. They come from the JSON metadata QPluginLoader reads straight
+ * from the file, or from the plugin object itself the first time a library
+ * without usable metadata is instantiated. GUI-thread only.
+ */
+class PluginIndex
+{
+public:
+    struct Entry {
+        qint64 size{0};
+        qint64 modifiedMs{0};
+        QString iid;
+        QString name;       // Empty until the metadata or an instance tells us
+        QString version;
+        QStringList dependencies;
+    };
+
+    PluginIndex();
+    ~PluginIndex();
+
+    PluginIndex(const PluginIndex&) = delete;
+    PluginIndex& operator=(const PluginIndex&) = delete;
+
+    // The entry for a library, read from its metadata when not indexed or stale
+    [[nodiscard]] Entry entry(const QFileInfo& file);
+    void update(const QString& filePath, const Entry& entry);
+
+    // Writes the index if anything changed, dropping libraries that were not seen
+    void save();
+
+    [[nodiscard]] int hits() const noexcept { return m_hits; }
+
+private:
+    void load();
+
+    [[nodiscard]] static Entry readMetaData(const QFileInfo& file);
+    [[nodiscard]] static QString indexPath();
+
+    static constexpr qint32 FORMAT_VERSION = 1;
+
+    QHash<QString, Entry> m_entries;
+    QHash<QString, Entry> m_seen; // Libraries looked up this run; what gets saved
+    bool m_dirty;
+    int m_hits;
+};
+
+} // namespace DarkPlay::Core
+
+#endif // DARKPLAY_CORE_PLUGININDEX_H
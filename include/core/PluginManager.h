@@ -6,6 +6,7 @@
 #include <QStringList>
 #include <QMutex>
 #include <QReadWriteLock>
+#include <QSet>
 #include <memory>
 #include <unordered_map>
 #include <atomic>
@@ -16,9 +17,16 @@ namespace DarkPlay::Plugins { class IPlugin; }
 
 namespace DarkPlay::Core {
 
+class PluginIndex;
+
 /**
  * @brief Thread-safe manager for plugin loading, unloading, and lifecycle
  * Provides RAII-compliant plugin management with proper error handling
+ *
+ * Bulk loading reads names and dependencies from a persistent index of the
+ * libraries' metadata, loads the libraries in parallel in dependency order and
+ * leaves instantiation to the first getPlugin()/getPluginsOfType() that needs
+ * the plugin. Instantiation happens on the manager's thread only.
  */
 class PluginManager : public QObject
 {
@@ -38,6 +46,7 @@ public:
     bool loadPlugin(const QString& filePath) noexcept;
     bool unloadPlugin(const QString& pluginName) noexcept;
     void loadAllPlugins(const QString& pluginsDirectory = "plugins") noexcept;
+    void loadAllPlugins(const QStringList& pluginsDirectories) noexcept;
     void unloadAllPlugins() noexcept;
 
     // Plugin access - thread-safe
@@ -59,18 +68,33 @@ public:
     [[nodiscard]] int loadedPluginCount() const noexcept;
     [[nodiscard]] int enabledPluginCount() const noexcept;
 
+    struct PluginTiming {
+        QString name;
+        qint64 loadUs{0};       // Loading the library
+        qint64 initUs{0};       // Instantiating and initialising the plugin
+        bool instantiated{false};
+    };
+    [[nodiscard]] QList<PluginTiming> pluginTimings() const;
+
 signals:
     void pluginLoaded(const QString& name);
     void pluginUnloaded(const QString& name);
     void pluginEnabled(const QString& name);
     void pluginDisabled(const QString& name);
+    // Emitted synchronously before shutdown() so users can stop calling into the plugin
+    void pluginAboutToShutdown(const QString& name);
     void pluginError(const QString& name, const QString& error);
 
 private:
     struct PluginInfo {
-        QObject* pluginObject{nullptr};           // Raw pointer managed by QPluginLoader
+        QObject* pluginObject{nullptr};           // Raw pointer managed by QPluginLoader; null until instantiated
         std::unique_ptr<QPluginLoader> loader;    // RAII for QPluginLoader
         QString filePath;
+        QString iid;
+        QStringList dependencies;
+        qint64 loadUs{0};
+        qint64 initUs{0};
+        bool failed{false};                       // Instantiation failed; not retried
         std::atomic<bool> enabled{false};
         
         // Custom constructors to handle atomic member
@@ -84,6 +108,11 @@ private:
             : pluginObject(other.pluginObject)
             , loader(std::move(other.loader))
             , filePath(std::move(other.filePath))
+            , iid(std::move(other.iid))
+            , dependencies(std::move(other.dependencies))
+            , loadUs(other.loadUs)
+            , initUs(other.initUs)
+            , failed(other.failed)
             , enabled(other.enabled.load())
         {
             other.pluginObject = nullptr;
@@ -97,6 +126,11 @@ private:
                 pluginObject = other.pluginObject;
                 loader = std::move(other.loader);
                 filePath = std::move(other.filePath);
+                iid = std::move(other.iid);
+                dependencies = std::move(other.dependencies);
+                loadUs = other.loadUs;
+                initUs = other.initUs;
+                failed = other.failed;
                 enabled.store(other.enabled.load());
 
                 other.pluginObject = nullptr;
@@ -110,10 +144,21 @@ private:
     mutable QReadWriteLock m_pluginsLock;
     std::unordered_map<QString, PluginInfo> m_loadedPlugins;
     QString m_pluginsDirectory;
+    std::unique_ptr<PluginIndex> m_index;
 
     // Helper methods
     [[nodiscard]] static bool validatePlugin(const Plugins::IPlugin* plugin) noexcept;
     void initializePlugin(Plugins::IPlugin* plugin);
+
+    // Registers a loaded library; one without a known name is instantiated to learn it
+    [[nodiscard]] QString registerPlugin(std::unique_ptr<QPluginLoader> loader, QString name,
+                                         QString iid, QStringList dependencies, qint64 loadUs);
+
+    // Lazy instantiation, dependencies first; no-ops off the manager's thread
+    bool instantiate(const QString& name, QSet<QString>& visiting);
+    void ensureInstantiated(const QString& name) noexcept;
+    void instantiatePending(const char* iid) noexcept;
+    void markFailed(const QString& name, const QString& error) noexcept;
     void emitError(const QString& pluginName, const QString& error) const noexcept;
     
     // Safe plugin access
@@ -123,6 +168,9 @@ private:
 template<typename T>
 QList<T*> PluginManager::getPluginsOfType() const
 {
+    // The first request for an interface instantiates the plugins that declared it
+    const_cast<PluginManager*>(this)->instantiatePending(qobject_interface_iid<T*>());
+
     QReadLocker locker(&m_pluginsLock);
     
     QList<T*> result;
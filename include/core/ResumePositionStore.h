@@ -0,0 +1,92 @@
+#ifndef DARKPLAY_CORE_RESUMEPOSITIONSTORE_H
+#define DARKPLAY_CORE_RESUMEPOSITIONSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <memory>
+
+namespace DarkPlay::Core {
+
+/**
+ * @brief Per-file playback positions, kept in memory and written behind
+ *
+ * Position ticks only touch an in-memory hash; changed entries are coalesced
+ * and appended to a journal under AppDataLocation every few seconds, and the
+ * journal is compacted once it is mostly superseded records. The file is read
+ * off the GUI thread at startup; a lookup that arrives first waits for it.
+ * GUI-thread only.
+ */
+class ResumePositionStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResumePositionStore(QObject* parent = nullptr);
+    ~ResumePositionStore() override;
+
+    ResumePositionStore(const ResumePositionStore&) = delete;
+    ResumePositionStore& operator=(const ResumePositionStore&) = delete;
+
+    // Where to resume, or 0 when nothing worth resuming is remembered
+    [[nodiscard]] qint64 position(const QString& key);
+
+    // Positions near the start or the end forget the file instead
+    void update(const QString& key, qint64 positionMs, qint64 durationMs);
+    void remove(const QString& key);
+
+    [[nodiscard]] qsizetype count();
+
+    // Writes pending changes and blocks until they are on disk
+    void flush() noexcept;
+
+    static constexpr qint64 MIN_RESUME_MS = 10000;
+    static constexpr qint64 END_MARGIN_MS = 15000;
+
+private:
+    struct Entry {
+        qint64 positionMs{0};
+        qint64 durationMs{0};
+        qint64 updatedSecs{0};
+    };
+    using Entries = QHash<QString, Entry>;
+
+    struct LoadResult {
+        Entries entries;
+        qint64 records{0};
+        bool damaged{false};
+    };
+
+    void ensureLoaded();
+    void markChanged(const QString& key, const Entry& entry);
+    void writeBehind();
+    [[nodiscard]] bool needsCompaction() const noexcept;
+
+    [[nodiscard]] static QString storePath();
+    static void readJournal(const QString& path, LoadResult& result);
+    static bool appendRecords(const QString& path, const Entries& records);
+    static bool writeSnapshot(const QString& path, const Entries& entries);
+    static void pruneOldest(Entries& entries, qsizetype keep);
+
+    static constexpr int FLUSH_INTERVAL_MS = 10000;
+    static constexpr qint64 POSITION_GRANULARITY_MS = 1000; // Smaller moves are not worth a record
+    static constexpr int MAX_ENTRIES = 300000;
+    static constexpr qint64 COMPACTION_SLACK = 10000; // Superseded records tolerated before rewriting
+    static constexpr qint32 FORMAT_VERSION = 1;
+
+    Entries m_entries;
+    Entries m_pending;          // Changed since the last write; positionMs -1 marks a removal
+    qint64 m_journalRecords;    // Records in the file, superseded ones included
+    bool m_journalDamaged;      // A truncated tail must be rewritten before appending
+    bool m_loaded;
+    std::shared_ptr<LoadResult> m_loadResult; // Filled on m_ioPool
+
+    QTimer m_flushTimer;
+    QThreadPool m_ioPool;
+};
+
+} // namespace DarkPlay::Core
+
+#endif // DARKPLAY_CORE_RESUMEPOSITIONSTORE_H
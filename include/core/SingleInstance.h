@@ -0,0 +1,64 @@
+#ifndef DARKPLAY_CORE_SINGLEINSTANCE_H
+#define DARKPLAY_CORE_SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <functional>
+
+class QLocalServer;
+class QLocalSocket;
+
+namespace DarkPlay::Core {
+
+/**
+ * @brief Local socket through which later launches hand their work to the running instance
+ *
+ * The protocol is newline-delimited JSON: each request is an object with a
+ * "command" member and gets exactly one reply object, in order, carrying
+ * "ok" and, on failure, "error". Automation can speak it directly. The socket
+ * is private to the current user. GUI-thread only.
+ */
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Handler = std::function<QJsonObject(const QJsonObject& request)>;
+
+    explicit SingleInstance(QObject* parent = nullptr);
+    ~SingleInstance() override;
+
+    SingleInstance(const SingleInstance&) = delete;
+    SingleInstance& operator=(const SingleInstance&) = delete;
+
+    // Per user, so separate accounts get separate players
+    [[nodiscard]] static QString serverName();
+
+    // Client side, usable before any QCoreApplication exists. False when no instance is listening
+    static bool forward(const QList<QJsonObject>& requests, QList<QJsonObject>* replies = nullptr);
+
+    // Takes over a socket left behind by a crashed instance; false if another one is alive
+    bool listen();
+    [[nodiscard]] bool isListening() const;
+
+    // Requests that arrive before a handler is set are refused
+    void setHandler(Handler handler);
+
+private:
+    void onNewConnection();
+    void processRequests(QLocalSocket* socket);
+    [[nodiscard]] QJsonObject handle(const QByteArray& line) const;
+
+    static constexpr int CONNECT_TIMEOUT_MS = 200;
+    static constexpr int REPLY_TIMEOUT_MS = 5000;
+    static constexpr qint64 MAX_REQUEST_BYTES = 64 * 1024;
+
+    QLocalServer* m_server;
+    Handler m_handler;
+};
+
+} // namespace DarkPlay::Core
+
+#endif // DARKPLAY_CORE_SINGLEINSTANCE_H
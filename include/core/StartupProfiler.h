@@ -0,0 +1,66 @@
+#ifndef DARKPLAY_CORE_STARTUPPROFILER_H
+#define DARKPLAY_CORE_STARTUPPROFILER_H
+
+#include <QString>
+#include <QElapsedTimer>
+#include <vector>
+
+namespace DarkPlay::Core {
+
+/**
+ * @brief Wall-clock timing of the startup phases
+ *
+ * Phases nest in the order they are opened; report() logs the tree once via
+ * qInfo so cold-start regressions show up in every log.
+ */
+class StartupProfiler
+{
+public:
+    /**
+     * @brief RAII phase marker - the phase ends when this goes out of scope
+     */
+    class ScopedPhase
+    {
+    public:
+        ScopedPhase(StartupProfiler* profiler, const QString& name);
+        ~ScopedPhase();
+
+        ScopedPhase(const ScopedPhase&) = delete;
+        ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+    private:
+        StartupProfiler* m_profiler;
+        int m_index;
+    };
+
+    StartupProfiler();
+
+    StartupProfiler(const StartupProfiler&) = delete;
+    StartupProfiler& operator=(const StartupProfiler&) = delete;
+
+    // Manual phase control for spans that do not fit a scope
+    int beginPhase(const QString& name);
+    void endPhase(int index);
+
+    [[nodiscard]] qint64 elapsedMs() const { return m_clock.elapsed(); }
+
+    // Logs the phase tree; only the first call reports
+    void report();
+
+private:
+    struct Phase {
+        QString name;
+        int depth{0};
+        qint64 startNs{0};
+        qint64 durationNs{-1}; // -1 while still open
+    };
+
+    QElapsedTimer m_clock;
+    std::vector<Phase> m_phases;
+    int m_depth;
+    bool m_reported;
+};
+
+} // namespace DarkPlay::Core
+
+#endif // DARKPLAY_CORE_STARTUPPROFILER_H
@@ -0,0 +1,74 @@
+#ifndef DARKPLAY_CORE_THEMECACHE_H
+#define DARKPLAY_CORE_THEMECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <functional>
+#include <optional>
+
+namespace DarkPlay::Core {
+
+/**
+ * @brief Compiled themes and generated stylesheets, built once
+ *
+ * Theme files are keyed by the SHA-1 of their contents, so an edited file is
+ * simply a miss; compiled themes persist under CacheLocation as a QDataStream
+ * index. Generated stylesheets depend on code rather than files and are only
+ * memoised for the session and never released. Thread-safe.
+ */
+class ThemeCache
+{
+public:
+    struct CompiledTheme {
+        QString name;
+        QJsonObject colors;
+        QString styleSheet;
+        QString styleSheetPath;    // External stylesheet the theme was compiled with, if any
+        QByteArray styleSheetHash; // Revalidated on every hit
+    };
+
+    ThemeCache();
+    ~ThemeCache();
+
+    ThemeCache(const ThemeCache&) = delete;
+    ThemeCache& operator=(const ThemeCache&) = delete;
+
+    [[nodiscard]] std::optional<CompiledTheme> theme(const QByteArray& sourceHash);
+    void storeTheme(const QByteArray& sourceHash, const CompiledTheme& theme);
+
+    // The stylesheet for key, generated on first use
+    [[nodiscard]] QString styleSheet(const QString& key, const std::function<QString()>& generate);
+
+    // Writes compiled themes if any were added
+    void save();
+
+    // Compiled themes in RAM; release() saves and drops them, the next lookup reads them back
+    [[nodiscard]] qint64 memoryBytes() const;
+    qint64 release();
+
+    [[nodiscard]] static QByteArray hash(const QByteArray& contents);
+
+private:
+    void ensureLoadedLocked();
+
+    [[nodiscard]] static QString indexPath();
+    [[nodiscard]] static qint64 themeBytes(const QByteArray& sourceHash, const CompiledTheme& theme);
+
+    static constexpr int INDEX_FORMAT_VERSION = 1;
+    static constexpr int MAX_THEMES = 64;
+    static constexpr qint64 COLOR_BYTES = 64;     // One colours entry, as a QJsonObject holds it
+    static constexpr qint64 THEME_OVERHEAD_BYTES = 256;
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, CompiledTheme> m_themes;
+    QHash<QString, QString> m_styleSheets;
+    bool m_loaded;
+    bool m_dirty;
+};
+
+} // namespace DarkPlay::Core
+
+#endif // DARKPLAY_CORE_THEMECACHE_H
@@ -1,6 +1,8 @@
 #ifndef DARKPLAY_CORE_THEMEMANAGER_H
 #define DARKPLAY_CORE_THEMEMANAGER_H
 
+#include "core/ThemeCache.h"
+#include "utils/MemoryBudget.h"
 #include <QObject>
 #include <QJsonObject>
 #include <QMutex>
@@ -9,15 +11,19 @@
 #include <QStyleHints>
 #include <memory>
 #include <atomic>
+#include <functional>
+#include <optional>
 #include <unordered_map>
 
 namespace DarkPlay::Core {
 
 /**
  * @brief Thread-safe manager for application themes and styling
- * Provides RAII-compliant theme management with OS theme adaptation
+ * Provides RAII-compliant theme management with OS theme adaptation.
+ * Loaded theme files other than the current theme, and the compiled-theme
+ * cache, are given back under the memory budget.
  */
-class ThemeManager : public QObject
+class ThemeManager : public QObject, public Utils::MemoryConsumer
 {
     Q_OBJECT
 
@@ -27,7 +33,7 @@ public:
     };
 
     explicit ThemeManager(QObject* parent = nullptr);
-    ~ThemeManager() override = default;
+    ~ThemeManager() override;
 
     // Delete copy and move operations for safety
     ThemeManager(const ThemeManager&) = delete;
@@ -56,6 +62,9 @@ public:
     [[nodiscard]] QJsonObject getColors() const;
     [[nodiscard]] QString getColor(const QString& colorName) const;
 
+    // Generated stylesheets (e.g. the fullscreen overlay) are built once per key
+    [[nodiscard]] QString cachedStyleSheet(const QString& key, const std::function<QString()>& generate);
+
     // Auto theme (follows system theme)
     bool loadAutoTheme() noexcept;
 
@@ -66,6 +75,11 @@ public:
     // Window frame adaptation
     void adaptWindowFrame(QWidget* window) const noexcept;
 
+    // Utils::MemoryConsumer - thread-safe
+    [[nodiscard]] qint64 memoryBytes() const override;
+    [[nodiscard]] qint64 oldestUseMs() const override;
+    qint64 evict(qint64 bytes) override;
+
 signals:
     void themeChanged(const QString& themeName);
     void themeTypeChanged(ThemeType themeType);
@@ -83,6 +97,7 @@ private:
         QString styleSheet;
         QJsonObject colors;
         QPalette palette;
+        qint64 lastUsedMs{0};
 
         // Make it movable but not copyable
         ThemeData() = default;
@@ -101,6 +116,12 @@ private:
     ThemeType m_currentThemeType;
     std::unique_ptr<ThemeData> m_currentThemeData;
 
+    // Compiled theme files and generated stylesheets
+    ThemeCache m_cache;
+    std::atomic<qint64> m_cacheUsedMs{0};
+    std::optional<QPalette> m_darkPalette;
+    std::optional<QPalette> m_lightPalette;
+
     std::atomic<bool> m_initialized{false};
     std::atomic<bool> m_systemThemeAdaptation{true};
     mutable std::atomic<bool> m_isSystemDark{false};
@@ -110,6 +131,7 @@ private:
 
     [[nodiscard]] static QString loadStyleSheetFromFile(const QString& filePath) noexcept;
     [[nodiscard]] static bool validateThemeData(const ThemeData& theme) noexcept;
+    [[nodiscard]] static qint64 themeBytes(const ThemeData& theme) noexcept;
     [[nodiscard]] QPalette createLightPalette() const noexcept;
     [[nodiscard]] QPalette createDarkPalette() const noexcept;
 
@@ -0,0 +1,112 @@
+#ifndef DARKPLAY_MEDIA_ADAPTIVEBITRATECONTROLLER_H
+#define DARKPLAY_MEDIA_ADAPTIVEBITRATECONTROLLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QSize>
+#include <QTimer>
+#include <QUrl>
+#include <functional>
+#include "StreamingStatistics.h"
+
+class QNetworkReply;
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief One rendition advertised by an HLS master playlist
+ */
+struct HlsVariant {
+    QUrl url;
+    qint64 bandwidth{0}; // Bits per second
+    QSize resolution;
+    QString codecs;
+};
+
+/**
+ * @brief Picks HLS variants from measured throughput and playback stalls
+ *
+ * The backend fetches segments itself, so throughput is measured by timing
+ * one segment download of the variant in question: the lowest before the
+ * first pick, the next one up before an up-switch. Repeated or long stalls
+ * switch down straight away; stable playback earns a probe for a switch up.
+ * Lives on the owning engine's thread.
+ */
+class AdaptiveBitrateController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AdaptiveBitrateController(const StreamingOptions& options, QObject* parent = nullptr);
+    ~AdaptiveBitrateController() override;
+
+    AdaptiveBitrateController(const AdaptiveBitrateController&) = delete;
+    AdaptiveBitrateController& operator=(const AdaptiveBitrateController&) = delete;
+
+    // Fetches and parses the playlist, then selects a first variant
+    void start(const QUrl& playlistUrl);
+    void stop();
+
+    [[nodiscard]] const QList<HlsVariant>& variants() const noexcept { return m_variants; }
+    [[nodiscard]] int currentVariant() const noexcept { return m_current; }
+    [[nodiscard]] int switchCount() const noexcept { return m_switches; }
+    [[nodiscard]] double throughputKbps() const noexcept { return m_throughputKbps; }
+
+    // Playback feedback from the engine
+    void setPlaying(bool playing);
+    void reportStall();
+    void reportLongStall();
+
+    // Variants in ascending bandwidth order; empty for a media (non-master) playlist
+    [[nodiscard]] static QList<HlsVariant> parseMasterPlaylist(const QByteArray& playlist, const QUrl& baseUrl);
+    [[nodiscard]] static QUrl firstSegmentUrl(const QByteArray& playlist, const QUrl& baseUrl);
+
+signals:
+    // First selection and every switch; index is -1 for a single-variant stream
+    void variantSelected(const QUrl& url, int index);
+    void failed(const QString& error);
+
+private:
+    using MeasureCallback = std::function<void(bool ok, double kbps)>;
+
+    void onMasterPlaylist(QNetworkReply* reply);
+    void measureVariant(int index, MeasureCallback callback);
+    void recordThroughput(double kbps);
+    [[nodiscard]] int highestSustainable(double kbps) const;
+    void select(int index);
+    void switchDown();
+    void scheduleUpswitchProbe();
+    void probeUpswitch();
+    [[nodiscard]] QNetworkReply* get(const QUrl& url);
+
+    static constexpr double SAFETY_FACTOR = 0.7;          // Keep headroom over the advertised bitrate
+    static constexpr int STALLS_BEFORE_DOWNSWITCH = 2;
+    static constexpr qint64 STALL_WINDOW_MS = 60000;
+    static constexpr int UPSWITCH_STABLE_MS = 45000;
+    static constexpr int MAX_UPSWITCH_BACKOFF_MS = 300000;
+    static constexpr qint64 MEASURE_MAX_BYTES = 2 * 1024 * 1024;
+    static constexpr int MEASURE_TIMEOUT_MS = 6000;
+
+    const StreamingOptions m_options;
+    QNetworkAccessManager m_network;
+    QList<QPointer<QNetworkReply>> m_replies; // Aborted on stop()
+    QUrl m_playlistUrl;
+    QList<HlsVariant> m_variants;
+    int m_current;
+    int m_switches;
+    double m_throughputKbps;
+    quint64 m_generation; // Bumped by stop(); late network callbacks are ignored
+
+    bool m_playing;
+    QElapsedTimer m_clock;
+    QList<qint64> m_recentStalls; // m_clock timestamps
+    QTimer m_upswitchTimer;
+    int m_upswitchBackoffMs;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_ADAPTIVEBITRATECONTROLLER_H
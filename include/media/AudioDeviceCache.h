@@ -0,0 +1,54 @@
+#ifndef DARKPLAY_MEDIA_AUDIODEVICECACHE_H
+#define DARKPLAY_MEDIA_AUDIODEVICECACHE_H
+
+#include <QObject>
+#include <QAudioDevice>
+#include <QList>
+#include <mutex>
+
+class QMediaDevices;
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Process-wide, lazily populated list of audio output devices
+ *
+ * Enumeration touches the platform audio server, so it happens on first use
+ * (never during construction) and once per process instead of once per
+ * engine. The cache follows hot-plug and default-device changes. The device
+ * getters may be called from the engine thread.
+ */
+class AudioDeviceCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Owned by the application object, created on first call
+    [[nodiscard]] static AudioDeviceCache* instance();
+
+    [[nodiscard]] QAudioDevice defaultOutput();
+    [[nodiscard]] QList<QAudioDevice> outputs();
+
+signals:
+    void defaultOutputChanged(const QAudioDevice& device);
+    void outputsChanged();
+
+private slots:
+    void onAudioOutputsChanged();
+
+private:
+    explicit AudioDeviceCache(QObject* parent = nullptr);
+
+    void ensurePopulated();
+    void watchDevices();
+
+    QMediaDevices* m_mediaDevices; // Created with the first enumeration, on our thread
+    std::mutex m_mutex;            // Guards the devices and m_populated
+    QAudioDevice m_defaultOutput;
+    QList<QAudioDevice> m_outputs;
+    bool m_populated;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_AUDIODEVICECACHE_H
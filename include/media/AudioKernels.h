@@ -0,0 +1,178 @@
+#ifndef DARKPLAY_MEDIA_AUDIOKERNELS_H
+#define DARKPLAY_MEDIA_AUDIOKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DarkPlay::Media::AudioKernels {
+
+/**
+ * @brief Vector paths selectable at runtime
+ *
+ * The best path the CPU supports is picked on first use: AVX2+FMA on x86-64,
+ * NEON on AArch64, scalar everywhere else.
+ */
+enum class InstructionSet {
+    Scalar,
+    AVX2,
+    NEON
+};
+
+[[nodiscard]] InstructionSet activeInstructionSet() noexcept;
+[[nodiscard]] bool isSupported(InstructionSet set) noexcept;
+[[nodiscard]] const char* instructionSetName(InstructionSet set) noexcept;
+
+// Forces a path (benchmarks); unsupported sets are ignored. Returns the set now in use
+InstructionSet setInstructionSet(InstructionSet set) noexcept;
+
+// All sample kernels are real-time safe: no allocation, no locks
+
+// samples[i] *= gain
+void applyGain(float* samples, size_t count, float gain) noexcept;
+
+// Linear gain from startGain (first frame) towards endGain (reached after the last frame)
+void applyGainRamp(float* samples, size_t frames, int channels, float startGain, float endGain) noexcept;
+
+// Full-scale int16 <-> [-1, 1] float; floatToInt16 clamps and rounds to nearest
+void int16ToFloat(const int16_t* input, float* output, size_t count) noexcept;
+void floatToInt16(const float* input, int16_t* output, size_t count) noexcept;
+
+// ITU-R BS.775 stereo downmix of 5.1 (FL FR C LFE BL BR) or 7.1 (... SL SR), normalised
+// so a full-scale input cannot clip. LFE is dropped. Returns false for other layouts
+bool downmixToStereo(const float* input, float* output, size_t frames, int inputChannels) noexcept;
+
+// sum(a[i] * b[i])
+[[nodiscard]] float dotProduct(const float* a, const float* b, size_t count) noexcept;
+
+/**
+ * @brief Click-free volume: steps in the target gain are spread over a short ramp
+ */
+class GainRamp
+{
+public:
+    explicit GainRamp(int rampFrames = DEFAULT_RAMP_FRAMES, float initialGain = 1.0f) noexcept;
+
+    // May be called between process() calls; a ramp in progress restarts from the current gain
+    void setTarget(float gain) noexcept;
+    void reset(float gain) noexcept;
+
+    void process(float* samples, size_t frames, int channels) noexcept;
+
+    [[nodiscard]] float currentGain() const noexcept { return m_current; }
+    [[nodiscard]] float targetGain() const noexcept { return m_target; }
+    [[nodiscard]] bool isRamping() const noexcept { return m_remaining > 0; }
+
+    static constexpr int DEFAULT_RAMP_FRAMES = 480; // 10 ms at 48 kHz
+
+private:
+    int m_rampFrames;
+    float m_current;
+    float m_target;
+    size_t m_remaining;
+};
+
+/**
+ * @brief Streaming polyphase windowed-sinc resampler for interleaved float
+ *
+ * ratio = input rate / output rate. The low-pass cutoff follows the ratio, so
+ * downsampling does not alias. Buffers are sized in the constructor; process()
+ * does not allocate. setRatio() must not race process().
+ */
+class SincResampler
+{
+public:
+    SincResampler(int channels, size_t maxInputFrames, int taps = DEFAULT_TAPS, int phases = DEFAULT_PHASES);
+
+    void setRatio(double ratio) noexcept;
+    [[nodiscard]] double ratio() const noexcept { return m_ratio; }
+    void reset() noexcept;
+
+    // Frames of output a call with inputFrames of input can produce at most
+    [[nodiscard]] size_t maxOutputFrames(size_t inputFrames) const noexcept;
+
+    // Consumes up to maxInputFrames of input; returns the number of output frames written
+    size_t process(const float* input, size_t inputFrames, float* output, size_t outputCapacity) noexcept;
+
+    // Input-side delay in frames
+    [[nodiscard]] int latency() const noexcept { return m_taps / 2; }
+
+    static constexpr int DEFAULT_TAPS = 32;
+    static constexpr int DEFAULT_PHASES = 256;
+    static constexpr double MIN_RATIO = 0.25;
+    static constexpr double MAX_RATIO = 4.0;
+
+private:
+    void buildFilter() noexcept;
+
+    int m_channels;
+    int m_taps;
+    int m_phases;
+    size_t m_maxInputFrames;
+    double m_ratio;
+    double m_position; // Fractional read index into the history, in frames
+
+    std::vector<float> m_filter;               // (phases + 1) rows of taps
+    std::vector<std::vector<float>> m_history; // Planar, one row per channel
+    std::vector<float> m_kernel;               // Interpolated taps for one output frame
+    size_t m_historyFrames;
+};
+
+/**
+ * @brief Streaming WSOLA time-stretch for interleaved float: tempo changes, pitch stays
+ *
+ * rate = input duration / output duration, so 1.5 plays 50% faster. Each output
+ * hop overlap-adds a Hann-windowed input segment, picked near its nominal
+ * position where it best continues the previous one. At rate 1 the input comes
+ * out unchanged, only delayed, so moving between rates never clicks. Buffers
+ * are sized in the constructor; write() and read() do not allocate.
+ * setRate() must not race them.
+ */
+class TimeStretch
+{
+public:
+    TimeStretch(int channels, int sampleRate, size_t maxWriteFrames);
+
+    void setRate(double rate) noexcept;
+    [[nodiscard]] double rate() const noexcept { return m_rate; }
+    void reset() noexcept;
+
+    // Frames write() takes right now
+    [[nodiscard]] size_t writeAvailable() const noexcept;
+    // Appends up to inputFrames; returns the frames taken
+    size_t write(const float* input, size_t inputFrames) noexcept;
+    // Returns the output frames written, fewer once it needs more input
+    size_t read(float* output, size_t outputCapacity) noexcept;
+
+    // Input frames taken but not played yet, the unread part of the current hop included
+    [[nodiscard]] double bufferedFrames() const noexcept;
+
+    static constexpr double MIN_RATE = 0.25;
+    static constexpr double MAX_RATE = 4.0;
+
+private:
+    bool produceHop() noexcept;
+    [[nodiscard]] size_t bestSegment(size_t first, size_t last) const noexcept;
+    [[nodiscard]] float similarity(size_t candidate) const noexcept;
+    void compact() noexcept;
+
+    int m_channels;
+    size_t m_hop;    // Output frames per segment; segments are two hops long
+    size_t m_search; // Frames either side of the nominal position
+    double m_rate;
+
+    std::vector<float> m_window; // Hann over one segment; halves overlapping by a hop sum to 1
+    std::vector<float> m_input;  // Interleaved
+    size_t m_inputFrames;
+    bool m_primed;     // A segment has been used since reset()
+    size_t m_previous; // Input frame the last segment started at
+    double m_nominal;  // Where it would have started without searching
+
+    std::vector<float> m_output; // The current hop
+    size_t m_outputRead;
+    size_t m_outputFrames;
+};
+
+} // namespace DarkPlay::Media::AudioKernels
+
+#endif // DARKPLAY_MEDIA_AUDIOKERNELS_H
@@ -0,0 +1,182 @@
+#ifndef DARKPLAY_MEDIA_AUDIOPIPELINE_H
+#define DARKPLAY_MEDIA_AUDIOPIPELINE_H
+
+#include <QObject>
+#include <QAudioBuffer>
+#include <QAudioDevice>
+#include <QAudioFormat>
+#include <QList>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "media/AudioKernels.h"
+#include "utils/SeqLock.h"
+#include "utils/SpscRingBuffer.h"
+
+class QAudioBufferOutput;
+class QAudioSink;
+class QThread;
+
+namespace DarkPlay::Plugins { class IAudioEffectPlugin; }
+
+namespace DarkPlay::Media {
+
+class MediaClock;
+
+/**
+ * @brief Decode -> DSP -> output audio chain for IAudioEffectPlugin
+ *
+ * QMediaPlayer delivers decoded float buffers through QAudioBufferOutput into
+ * an SPSC ring. A time-critical DSP thread runs the effect chain on fixed-size
+ * preallocated blocks and fills a second SPSC ring, which a pull-mode QAudioSink
+ * drains. Volume is applied there with a short ramp, so changes never click.
+ * Ahead of the effects a TimeStretch plays the playback rate without moving the
+ * pitch, and the sink callback tells the MediaClock which media time is audible.
+ * Nothing on the sink callback path allocates or locks; an underrun plays
+ * silence and is counted rather than blocking.
+ *
+ * Requires QAudioBufferOutput (Qt 6.8+); only built when DARKPLAY_HAS_AUDIO_PIPELINE is set.
+ */
+class AudioPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioPipeline(QObject* parent = nullptr);
+    ~AudioPipeline() override;
+
+    AudioPipeline(const AudioPipeline&) = delete;
+    AudioPipeline& operator=(const AudioPipeline&) = delete;
+
+    // Opens the sink on the given device and starts the DSP thread
+    bool start(const QAudioDevice& device);
+    void stop();
+    [[nodiscard]] bool isRunning() const noexcept { return m_running.load(std::memory_order_acquire); }
+
+    // Attach to QMediaPlayer::setAudioBufferOutput() after start()
+    [[nodiscard]] QAudioBufferOutput* bufferOutput() const noexcept { return m_bufferOutput; }
+
+    // Swaps the chain; returns once the DSP thread no longer uses the old one
+    void setEffects(const QList<Plugins::IAudioEffectPlugin*>& effects);
+
+    // Playback control from the engine
+    void setVolume(float volume);
+    void setMuted(bool muted);
+    void setPaused(bool paused);
+    void flush();
+    // Tempo the player runs at; buffers it already shortened are stretched only by what is left
+    void setPlaybackRate(qreal rate);
+
+    // Not owned, may be nullptr; set before start()
+    void setClock(MediaClock* clock) noexcept { m_clock.store(clock, std::memory_order_release); }
+
+    // Diagnostics
+    [[nodiscard]] quint64 underrunCount() const noexcept { return m_underruns.load(std::memory_order_relaxed); }
+    [[nodiscard]] quint64 overrunCount() const noexcept { return m_overruns.load(std::memory_order_relaxed); }
+    [[nodiscard]] quint64 droppedInputFrames() const noexcept
+    {
+        return m_droppedInputFrames.load(std::memory_order_relaxed);
+    }
+
+signals:
+    void errorOccurred(const QString& error);
+
+private slots:
+    void onAudioBufferReceived(const QAudioBuffer& buffer);
+
+private:
+    class OutputDevice;
+    friend class OutputDevice;
+
+    using EffectChain = std::vector<Plugins::IAudioEffectPlugin*>;
+
+    // Frame counters run from start() and only grow; each mark has one writer
+    struct InputMark {
+        quint64 frames{0};         // Decoded frames written to the input ring
+        qint64 endUs{-1};          // Media time they end at, -1 if the player gave none
+        double mediaPerSample{1.0};
+    };
+    struct OutputMark {
+        quint64 frames{0};      // Frames written to the output ring
+        double inputFrame{0.0}; // Input frame the last of them was stretched from
+        double stretchRate{1.0};
+    };
+
+    void dspLoop();
+    void wakeDsp();
+    void waitForChainAcknowledged(quint32 generation);
+    qint64 readOutput(char* data, qint64 maxSize) noexcept;
+    void updateTargetGain();
+    void publishAudible(MediaClock* clock, qint64 wallNs) noexcept;
+    [[nodiscard]] static double stretchRateFor(double playbackRate, double mediaPerSample) noexcept;
+
+    static constexpr int BLOCK_FRAMES = 512;
+    static constexpr int RING_FRAMES = 4096; // ~85 ms at 48 kHz per ring
+    static constexpr int OUTPUT_CHUNK_FRAMES = 256;
+    static constexpr int CHAIN_SWAP_WARN_MS = 200;
+    static constexpr double MIN_MEDIA_PER_SAMPLE = 0.2; // Beyond these the timestamps jumped, not the tempo
+    static constexpr double MAX_MEDIA_PER_SAMPLE = 5.0;
+    static constexpr double MEDIA_PER_SAMPLE_SMOOTHING = 0.25;
+    static constexpr double UNITY_RATE_SNAP = 0.01; // Timestamp jitter, not a tempo
+
+    // Formats: the player always hands us float, the sink may need int16
+    QAudioFormat m_processingFormat;
+    QAudioFormat m_sinkFormat;
+    int m_channels;
+    bool m_sinkIsFloat;
+
+    QAudioBufferOutput* m_bufferOutput;
+    std::unique_ptr<QAudioSink> m_sink;
+    std::unique_ptr<OutputDevice> m_outputDevice;
+    QThread* m_dspThread;
+
+    // Decode -> DSP -> sink
+    Utils::SpscRingBuffer<float> m_inputRing;
+    Utils::SpscRingBuffer<float> m_outputRing;
+    std::vector<float> m_dspBlock;
+    std::vector<float> m_outputChunk;
+    std::vector<qint16> m_pcmChunk;
+    AudioKernels::GainRamp m_outputGain; // Sink callback only
+    std::unique_ptr<AudioKernels::TimeStretch> m_stretch; // DSP thread only
+
+    // Where the audio is in media time, for the clock
+    std::atomic<MediaClock*> m_clock{nullptr};
+    std::atomic<double> m_playbackRate{1.0};
+    std::atomic<double> m_mediaPerSample{1.0}; // Media time per sample time in what the player delivers
+    std::atomic<bool> m_resetInputTiming{false};
+    std::atomic<quint64> m_flushFrame{0}; // First input frame decoded after the last flush
+    std::atomic<qint64> m_sinkBufferFrames{0};
+    Utils::SeqLock<InputMark> m_inputMark;
+    Utils::SeqLock<OutputMark> m_outputMark;
+    quint64 m_inputFramesWritten;  // Decode stage
+    qint64 m_previousStartUs;      // Decode stage
+    qint64 m_previousDurationUs;   // Decode stage
+    quint64 m_inputFramesConsumed; // DSP thread
+    quint64 m_outputFramesWritten; // DSP thread
+    quint64 m_outputFramesRead;    // Sink callback
+
+    // Double-buffered effect chain with a generation handshake
+    std::array<EffectChain, 2> m_chains;
+    std::atomic<int> m_activeChain{0};
+    std::atomic<quint32> m_chainGeneration{0};
+    std::atomic<quint32> m_chainAcknowledged{0};
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_flushInput{false};
+    std::atomic<bool> m_flushOutput{false};
+    std::atomic<quint32> m_wakeSequence{0};
+    std::atomic<quint64> m_underruns{0};
+    std::atomic<quint64> m_overruns{0};
+    std::atomic<quint64> m_droppedInputFrames{0}; // Whole frames lost to input overruns
+    std::atomic<bool> m_paused{true};
+    std::atomic<float> m_targetGain{1.0f};
+
+    float m_volume;
+    bool m_muted;
+    bool m_formatWarningShown;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_AUDIOPIPELINE_H
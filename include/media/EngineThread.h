@@ -0,0 +1,72 @@
+#ifndef DARKPLAY_MEDIA_ENGINETHREAD_H
+#define DARKPLAY_MEDIA_ENGINETHREAD_H
+
+#include <QThread>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Thread the playback engines live on, fed through a command queue
+ *
+ * Any thread may post commands; they run in order on the engine thread. A
+ * command posted with a coalescing key replaces a still-pending one with the
+ * same key, as long as no barrier (a command without a key) is queued between
+ * them, so ten queued seeks run as the last one. Destruction runs everything
+ * already queued, then joins.
+ */
+class EngineThread
+{
+public:
+    using Command = std::function<void()>;
+
+    // Commands that only carry the latest value; None is an ordering barrier
+    enum class Coalesce {
+        None,
+        Seek,
+        Volume,
+        Muted,
+        PlaybackRate,
+        Snapshot,
+        StreamingStats
+    };
+
+    EngineThread();
+    ~EngineThread();
+
+    EngineThread(const EngineThread&) = delete;
+    EngineThread& operator=(const EngineThread&) = delete;
+
+    // Moves an object created elsewhere, typically a fresh engine, onto the engine thread
+    void adopt(QObject* object);
+
+    void post(Command command, Coalesce key = Coalesce::None);
+    // Blocks until the command and everything queued before it has run
+    void postAndWait(Command command);
+
+    [[nodiscard]] bool isCurrentThread() const;
+    [[nodiscard]] quint64 coalescedCount() const noexcept { return m_coalesced.load(std::memory_order_relaxed); }
+
+private:
+    void drain();
+
+    struct Entry {
+        Command command;
+        Coalesce key;
+    };
+
+    QThread m_thread;
+    QObject* m_context; // Lives on m_thread; the queued drain calls are delivered to it
+
+    std::mutex m_mutex;
+    std::deque<Entry> m_queue;
+    bool m_drainScheduled;
+    std::atomic<quint64> m_coalesced;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_ENGINETHREAD_H
@@ -0,0 +1,127 @@
+#ifndef DARKPLAY_MEDIA_EXPORTQUEUE_H
+#define DARKPLAY_MEDIA_EXPORTQUEUE_H
+
+#include <QObject>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "IMediaTranscoder.h"
+
+namespace DarkPlay::Media {
+
+enum class ExportState {
+    Queued,
+    Running,
+    Finished,
+    Failed,
+    Cancelled
+};
+
+struct ExportJobStatus {
+    int id{0};
+    ExportJob job;
+    ExportState state{ExportState::Queued};
+    ExportProgress progress;
+    QString encoder; // Plugin that took the job, empty for the built-in transcoder
+    QString error;
+};
+
+struct TranscoderInstance {
+    std::unique_ptr<IMediaTranscoder> transcoder; // nullptr: nothing can encode the job
+    QString owner;                                 // Plugin that provides it, empty for built-ins
+};
+
+/**
+ * @brief Export jobs run side by side on a bounded set of worker threads
+ *
+ * Each running job gets its own thread and transcoder, the same way the
+ * thumbnail decoders do; the rest wait their turn in order. Transcoders come
+ * from the factory, which picks a plugin that canEncode() the format and
+ * falls back to the built-in one. GUI-thread only.
+ */
+class ExportQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    using TranscoderFactory = std::function<TranscoderInstance(const ExportJob&)>;
+
+    // Container for playlist exports that do not name one
+    static constexpr const char* DEFAULT_FORMAT = "mp4";
+
+    explicit ExportQueue(QObject* parent = nullptr);
+    // Cancels everything and waits for the workers
+    ~ExportQueue() override;
+
+    ExportQueue(const ExportQueue&) = delete;
+    ExportQueue& operator=(const ExportQueue&) = delete;
+
+    void setTranscoderFactory(TranscoderFactory factory);
+
+    // 0 picks from the core count; counts beyond it only apply to jobs not yet started
+    void setMaxJobs(int jobs);
+    [[nodiscard]] int maxJobs() const;
+
+    // An empty format is taken from the output suffix; returns the job id
+    int enqueue(ExportJob job);
+    void cancel(int id);
+    void cancelAll();
+    // Blocks until the plugin's transcoders are gone, for a plugin about to shut down
+    void cancelOwner(const QString& owner);
+
+    [[nodiscard]] QList<ExportJobStatus> jobs() const { return m_jobs; }
+    [[nodiscard]] bool isIdle() const;
+
+    // directory/<source base name>.<format>, numbered past existing files and the taken paths
+    [[nodiscard]] static QString outputPathFor(const QUrl& source, const QString& directory,
+                                               const QString& format, const QStringList& taken = {});
+
+signals:
+    void jobQueued(int id);
+    void jobStarted(int id);
+    void jobProgress(int id, const DarkPlay::Media::ExportProgress& progress);
+    void jobFinished(int id, DarkPlay::Media::ExportState state, const QString& error);
+    // Nothing queued or running any more
+    void idle();
+
+private:
+    struct Worker {
+        int id;
+        QPointer<QThread> thread;    // Deletes itself once finished
+        IMediaTranscoder* transcoder; // Lives on thread; deleted when it finishes
+        QString owner;
+        bool cancelRequested;
+    };
+
+    void scheduleStart();
+    void startNext();
+    void launch(ExportJobStatus& status);
+    void onTranscoderFinished(int id, bool ok, const QString& error);
+    void setFinished(ExportJobStatus& status, ExportState state, const QString& error);
+    // Cancels the transcoders and waits their threads out
+    void stopWorkers(const std::function<bool(const Worker&)>& predicate);
+    [[nodiscard]] ExportJobStatus* findJob(int id);
+    [[nodiscard]] int effectiveMaxJobs() const;
+
+    static constexpr int MAX_AUTO_JOBS = 4; // Consumer GPUs only run a few encode sessions at once
+    static constexpr int STOP_TIMEOUT_MS = 3000;
+
+    TranscoderFactory m_factory;
+    QList<ExportJobStatus> m_jobs;
+    std::vector<Worker> m_workers;
+    int m_maxJobs;
+    int m_nextId;
+    bool m_startPending;
+    bool m_busy; // Something was queued since the last idle()
+};
+
+} // namespace DarkPlay::Media
+
+Q_DECLARE_METATYPE(DarkPlay::Media::ExportState)
+
+#endif // DARKPLAY_MEDIA_EXPORTQUEUE_H
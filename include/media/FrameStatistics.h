@@ -0,0 +1,96 @@
+#ifndef DARKPLAY_MEDIA_FRAMESTATISTICS_H
+#define DARKPLAY_MEDIA_FRAMESTATISTICS_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <array>
+#include <mutex>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Point-in-time frame timing report
+ *
+ * Dropped frames point at the decoder, late frames at the sink delivery and a
+ * high arrival-to-present latency at a busy GUI thread.
+ */
+struct FrameStats {
+    quint64 framesReceived{0};  // Delivered by the video sink
+    quint64 framesPresented{0}; // Drawn by the renderer
+    quint64 framesDropped{0};   // Missing from the presentation timestamp sequence
+    quint64 framesSkipped{0};   // Delivered but superseded before the renderer drew them
+    quint64 framesLate{0};      // Arrived more than one frame interval behind schedule
+    double frameRate{0.0};      // Nominal rate derived from timestamp spacing
+
+    // Sink arrival to on-screen presentation, microseconds
+    qint64 latencyP50Us{0};
+    qint64 latencyP95Us{0};
+    qint64 latencyP99Us{0};
+    int latencySamples{0};
+};
+
+/**
+ * @brief Thread-safe recorder behind FrameStats
+ *
+ * recordArrival() is called from whichever thread the sink delivers frames on,
+ * recordPresented() from the GUI thread once the frame is on screen.
+ */
+class FrameStatistics
+{
+public:
+    FrameStatistics();
+
+    FrameStatistics(const FrameStatistics&) = delete;
+    FrameStatistics& operator=(const FrameStatistics&) = delete;
+
+    // Timestamps are QVideoFrame::startTime() values in microseconds, -1 if unknown
+    void recordArrival(qint64 presentationTimeUs);
+    void recordPresented(qint64 presentationTimeUs);
+
+    // Seek, pause/resume or rate change - the wall-clock schedule starts over
+    void markDiscontinuity();
+    void setPlaybackRate(qreal rate);
+
+    void reset();
+    [[nodiscard]] FrameStats stats() const;
+
+private:
+    static constexpr int PENDING_FRAMES = 16;
+    static constexpr int INTERVAL_SAMPLES = 16;
+    static constexpr int LATENCY_SAMPLES = 512;
+    static constexpr qint64 DISCONTINUITY_US = 1000000; // Forward jumps beyond this are seeks
+
+    struct PendingFrame {
+        qint64 presentationTimeUs{-1};
+        qint64 arrivalUs{0};
+        bool settled{true}; // Presented or already counted as skipped
+    };
+
+    [[nodiscard]] qint64 nowUs() const;
+    [[nodiscard]] qint64 nominalIntervalUs() const;
+    void resetTimingLocked();
+
+    mutable std::mutex m_mutex;
+    QElapsedTimer m_clock;
+    FrameStats m_stats;
+    qreal m_playbackRate;
+
+    // Schedule tracking since the last discontinuity
+    qint64 m_lastPresentationTimeUs;
+    qint64 m_scheduleBaselineUs;
+    bool m_hasBaseline;
+    std::array<qint64, INTERVAL_SAMPLES> m_intervals{};
+    int m_intervalCount;
+    int m_intervalIndex;
+
+    std::array<PendingFrame, PENDING_FRAMES> m_pending;
+    int m_pendingIndex;
+
+    std::array<qint64, LATENCY_SAMPLES> m_latencies{};
+    int m_latencyCount;
+    int m_latencyIndex;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_FRAMESTATISTICS_H
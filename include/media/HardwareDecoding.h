@@ -0,0 +1,48 @@
+#ifndef DARKPLAY_MEDIA_HARDWAREDECODING_H
+#define DARKPLAY_MEDIA_HARDWAREDECODING_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+namespace DarkPlay::Media {
+
+enum class HardwareDecodeApi {
+    Vaapi,
+    Nvdec,
+    VideoToolbox,
+    D3D11VA,
+    Dxva2
+};
+
+/**
+ * @brief Runtime selection of the hardware video decode APIs
+ *
+ * probe() only looks for the devices and drivers an API needs; no decoder is
+ * opened. configure() hands the result to Qt's FFmpeg backend, which reads it
+ * once per process and falls back to software per stream when a device cannot
+ * be initialised. The encoders behind exports get the same APIs minus the
+ * decode-only ones. A QT_FFMPEG_DECODING_HW_DEVICE_TYPES or
+ * QT_FFMPEG_ENCODING_HW_DEVICE_TYPES set by the user wins.
+ */
+class HardwareDecoding
+{
+public:
+    HardwareDecoding() = delete;
+
+    // Available APIs, most preferred first
+    [[nodiscard]] static QList<HardwareDecodeApi> probe();
+
+    // Must run before the first QMediaPlayer is created
+    static void configure(bool enabled);
+
+    [[nodiscard]] static bool isEnabled() noexcept;
+    [[nodiscard]] static QList<HardwareDecodeApi> activeApis();
+
+    [[nodiscard]] static QString apiName(HardwareDecodeApi api);
+    [[nodiscard]] static QByteArray ffmpegDeviceType(HardwareDecodeApi api);
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_HARDWAREDECODING_H
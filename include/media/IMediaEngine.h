@@ -2,9 +2,17 @@
 #define DARKPLAY_MEDIA_IMEDIAENGINE_H
 
 #include <QObject>
+#include <QList>
 #include <QString>
 #include <QUrl>
 #include <QSize>
+#include "FrameStatistics.h"
+#include "MediaClock.h"
+#include "StreamingStatistics.h"
+
+class QVideoSink;
+
+namespace DarkPlay::Plugins { class IAudioEffectPlugin; }
 
 namespace DarkPlay::Media {
 
@@ -22,6 +30,13 @@ enum class MediaType {
     Unknown
 };
 
+enum class SeekMode {
+    Exact, // Decode forward from the previous keyframe to the requested time
+    Fast   // Land on the nearest keyframe
+};
+
+// Engines run on MediaManager's engine thread and are created parentless on the GUI
+// thread; only the frame timing members below are called from other threads
 class IMediaEngine : public QObject {
     Q_OBJECT
 
@@ -40,6 +55,9 @@ public:
     [[nodiscard]] virtual qint64 duration() const = 0;
     virtual void setPosition(qint64 position) = 0;
 
+    // Frame stepping - pauses and moves by whole frames; engines without video return false
+    virtual bool stepFrame(int frames) { Q_UNUSED(frames) return false; }
+
     // Volume control
     [[nodiscard]] virtual int volume() const = 0;
     virtual void setVolume(int volume) = 0;
@@ -61,6 +79,30 @@ public:
     [[nodiscard]] virtual bool hasVideo() const = 0;
     [[nodiscard]] virtual bool hasAudio() const = 0;
 
+    // Video output - engines without video support may ignore the sink
+    virtual void setVideoSink(QVideoSink* sink) { Q_UNUSED(sink) }
+    [[nodiscard]] virtual QVideoSink* videoSink() const { return nullptr; }
+
+    // Frame timing instrumentation - engines without video report empty stats; callable from any thread
+    [[nodiscard]] virtual FrameStats frameStats() const { return {}; }
+    virtual void resetFrameStats() {}
+    virtual void reportFramePresented(qint64 presentationTimeUs) { Q_UNUSED(presentationTimeUs) }
+
+    // Master clock the video is scheduled against - engines without one report ClockSource::None; any thread
+    [[nodiscard]] virtual ClockReading clockReading() const { return {}; }
+    [[nodiscard]] virtual ClockStats clockStats() const { return {}; }
+
+    // Audio effect chain, in processing order - engines without DSP support play unprocessed audio
+    virtual void setAudioEffects(const QList<Plugins::IAudioEffectPlugin*>& effects) { Q_UNUSED(effects) }
+
+    // Network sources - engines without their own buffering hand URLs straight to the backend
+    virtual void setStreamingOptions(const StreamingOptions& options) { Q_UNUSED(options) }
+    [[nodiscard]] virtual StreamingStats streamingStats() const { return {}; }
+
+    // Hardware video decoding - engines that can only choose it per process return false
+    virtual bool setHardwareDecoding(bool enabled) { Q_UNUSED(enabled) return false; }
+    [[nodiscard]] virtual bool hardwareDecodingActive() const { return false; }
+
 signals:
     void stateChanged(PlaybackState state);
     void positionChanged(qint64 position);
@@ -72,6 +114,11 @@ signals:
     void mediaInfoChanged(); // Добавляем недостающий сигнал
     void errorOccurred(const QString& errorString); // Переименовываем error в errorOccurred
     void bufferingProgress(int progress);
+    // The video could not be decoded in hardware; software decoding might succeed
+    void hardwareDecodingFailed(const QString& reason);
+    // setPosition() has landed: the first frame after it, or the first position report without
+    // video. -1 if the position is unknown. MediaManager times out on engines that never emit it
+    void seekCompleted(qint64 position);
 };
 
 } // namespace DarkPlay::Media
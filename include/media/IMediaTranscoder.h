@@ -0,0 +1,62 @@
+#ifndef DARKPLAY_MEDIA_IMEDIATRANSCODER_H
+#define DARKPLAY_MEDIA_IMEDIATRANSCODER_H
+
+#include <QObject>
+#include <QString>
+#include <QUrl>
+
+namespace DarkPlay::Media {
+
+// One file, or a time range of it, re-encoded into outputPath
+struct ExportJob {
+    QUrl source;
+    QString outputPath;
+    qint64 startMs{0};
+    qint64 endMs{-1};            // -1: to the end
+    QString format;              // Container, e.g. "mp4" or "mkv"; the output suffix when empty
+    bool hardwareEncoding{true}; // Plugins decide per job; the built-in encoder per process
+    qreal speed{1.0};            // Decode rate for sources without audio, which is never time-stretched
+};
+
+struct ExportProgress {
+    qint64 processedMs{0}; // Media time encoded so far
+    qint64 totalMs{0};     // Length of the range, 0 until the source is loaded
+    qint64 frames{0};
+    double fps{0.0};
+    double realtimeFactor{0.0}; // Media time over wall time
+    qint64 bytesWritten{0};
+};
+
+/**
+ * @brief Runs one ExportJob from decode to muxed file
+ *
+ * Created parentless on the GUI thread and moved to a worker thread of its
+ * own by ExportQueue, which calls start() and cancel() there. start() must
+ * return promptly and encode event-driven, or cancel() never gets to run; a
+ * worker that does not stop within a few seconds is abandoned. Output goes to
+ * disk as it is encoded; nothing holds more than a few frames.
+ */
+class IMediaTranscoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IMediaTranscoder(QObject* parent = nullptr) : QObject(parent) {}
+    ~IMediaTranscoder() override = default;
+
+    virtual void start(const ExportJob& job) = 0;
+    // Stops early and removes the partial output; finished() follows
+    virtual void cancel() = 0;
+
+signals:
+    // A few times a second while encoding
+    void progressChanged(const DarkPlay::Media::ExportProgress& progress);
+    // Exactly once per start()
+    void finished(bool ok, const QString& error);
+};
+
+} // namespace DarkPlay::Media
+
+Q_DECLARE_METATYPE(DarkPlay::Media::ExportProgress)
+
+#endif // DARKPLAY_MEDIA_IMEDIATRANSCODER_H
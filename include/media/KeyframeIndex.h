@@ -0,0 +1,100 @@
+#ifndef DARKPLAY_MEDIA_KEYFRAMEINDEX_H
+#define DARKPLAY_MEDIA_KEYFRAMEINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include <mutex>
+#include <optional>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Keyframe presentation times of a file's video track
+ */
+struct KeyframeTable {
+    QList<qint64> keyframesMs; // Ascending, rounded up so a seek never lands just before one
+    qint64 frameDurationUs{0}; // Nominal, 0 if the container does not say
+    bool intraOnly{false};     // Every frame is a keyframe; keyframesMs stays empty
+
+    // Keyframe closest to positionMs, or positionMs itself when there is no table to snap to
+    [[nodiscard]] qint64 nearest(qint64 positionMs) const;
+    // First keyframe after / last one before positionMs, if any
+    [[nodiscard]] std::optional<qint64> after(qint64 positionMs) const;
+    [[nodiscard]] std::optional<qint64> before(qint64 positionMs) const;
+};
+
+/**
+ * @brief Persistent per-file keyframe tables for fast seeks
+ *
+ * Tables are read from the container's own index (MP4/MOV sample tables,
+ * Matroska/WebM cues) on a background thread; nothing is decoded. They are
+ * kept next to the metadata cache, keyed by path, size and modification time.
+ * Other containers get no table. lookup() may be called from the engine
+ * thread; everything else is GUI-thread only.
+ */
+class KeyframeIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Owned by the application object, created on first call
+    [[nodiscard]] static KeyframeIndex* instance();
+
+    // Cached table for a local file, if the file is unchanged since it was indexed
+    [[nodiscard]] std::optional<KeyframeTable> lookup(const QString& filePath);
+
+    // Builds the table in the background unless it is cached or unavailable
+    void request(const QString& filePath);
+
+signals:
+    void tableAvailable(const QString& filePath);
+
+private:
+    explicit KeyframeIndex(QObject* parent = nullptr);
+    ~KeyframeIndex() override;
+
+    struct Entry {
+        qint64 size{0};
+        qint64 modifiedMs{0};
+        qint64 lastUsedSecs{0};
+        KeyframeTable table;
+    };
+
+    void ensureLoaded();
+    void onLoaded(const QHash<QString, Entry>& entries);
+    void onBuilt(const QString& filePath, qint64 size, qint64 modifiedMs, const KeyframeTable& table);
+    void scheduleSave();
+    void save();
+
+    [[nodiscard]] static std::optional<KeyframeTable> build(const QString& filePath);
+    [[nodiscard]] static QString indexPath();
+    [[nodiscard]] static QHash<QString, Entry> readIndex(const QString& path);
+    static void writeIndex(const QString& path, QHash<QString, Entry> entries);
+
+    static constexpr int SAVE_DELAY_MS = 2000;
+    static constexpr int MAX_ENTRIES = 256; // A feature film is tens of kilobytes
+    static constexpr int INDEX_FORMAT_VERSION = 1;
+
+    // Guards m_entries, m_loadRequested, m_loaded and m_dirty. m_loaded is only written on the
+    // GUI thread, which may therefore read it without the lock
+    std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    QStringList m_pendingRequests; // Made before the index finished loading
+    QSet<QString> m_requested;     // This session, whether or not a table was found
+    bool m_loadRequested;
+    bool m_loaded;
+    bool m_dirty;
+
+    QTimer m_saveTimer;
+    QThreadPool m_ioPool;
+    QThreadPool m_buildPool;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_KEYFRAMEINDEX_H
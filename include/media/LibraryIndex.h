@@ -0,0 +1,100 @@
+#ifndef DARKPLAY_MEDIA_LIBRARYINDEX_H
+#define DARKPLAY_MEDIA_LIBRARYINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <vector>
+#include "LibraryScanner.h"
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief One search hit
+ */
+struct LibraryEntry {
+    QString path;
+    QString name; // File name with suffix
+    MediaType type{MediaType::Unknown};
+    qint64 size{0};
+    qint64 modifiedMs{0};
+};
+
+struct LibraryQuery {
+    QString text; // Words that must all appear in the file name, in any case
+    MediaType type{MediaType::Unknown}; // Unknown matches both audio and video
+    QString folder; // Only files below it; empty for the whole library
+    int limit{500};
+};
+
+struct LibrarySearchResult {
+    QList<LibraryEntry> entries; // The first limit matches, in index order
+    int matchCount{0};
+    qint64 elapsedUs{0};
+};
+
+/**
+ * @brief In-memory file name index of the media library
+ *
+ * Every case-folded file name is broken into trigrams; a query intersects
+ * the posting lists of its words' trigrams, smallest first, and checks the
+ * few survivors against the names themselves. Words shorter than three
+ * characters only filter, so a query made of nothing else scans the whole
+ * index. Removed files leave holes that are compacted away once they
+ * outnumber the live ones. GUI-thread only.
+ */
+class LibraryIndex
+{
+public:
+    LibraryIndex();
+
+    // True when the file is new or its size or modification time changed
+    bool insert(const LibraryFile& file);
+    bool remove(const QString& path);
+    // The directory and everything below it; returns the number of files dropped
+    int removeUnder(const QString& directory);
+    void clear();
+
+    [[nodiscard]] bool contains(const QString& path) const { return m_byPath.contains(path); }
+    [[nodiscard]] int count() const noexcept { return static_cast<int>(m_byPath.size()); }
+    // Files directly inside the directory
+    [[nodiscard]] std::vector<LibraryFile> filesIn(const QString& directory) const;
+
+    [[nodiscard]] LibrarySearchResult search(const LibraryQuery& query) const;
+
+private:
+    using ItemId = quint32;
+    using Trigram = quint64;
+
+    struct Item {
+        QString path;
+        QString foldedName;
+        qint64 size{0};
+        qint64 modifiedMs{0};
+        quint32 nameOffset{0};
+        MediaType type{MediaType::Unknown};
+        bool alive{false};
+    };
+
+    void indexItem(ItemId id);
+    void kill(ItemId id);
+    void compactIfSparse();
+    [[nodiscard]] LibraryFile fileOf(const Item& item) const;
+
+    // Unique and sorted
+    static void trigramsOf(QStringView text, std::vector<Trigram>& trigrams);
+    [[nodiscard]] static QString parentOf(const QString& path);
+
+    static constexpr int MIN_COMPACT_HOLES = 4096;
+
+    std::vector<Item> m_items;
+    QHash<QString, ItemId> m_byPath;
+    QHash<QString, std::vector<ItemId>> m_byDirectory;
+    QHash<Trigram, std::vector<ItemId>> m_postings; // Ascending ids, holes included
+    int m_holes;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_LIBRARYINDEX_H
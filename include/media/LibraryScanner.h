@@ -0,0 +1,64 @@
+#ifndef DARKPLAY_MEDIA_LIBRARYSCANNER_H
+#define DARKPLAY_MEDIA_LIBRARYSCANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <optional>
+#include <vector>
+#include "IMediaEngine.h"
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief A media file found on disk
+ */
+struct LibraryFile {
+    QString path; // Absolute, with '/' separators
+    qint64 size{0};
+    qint64 modifiedMs{0};
+    MediaType type{MediaType::Unknown};
+};
+
+/**
+ * @brief What one scan worker found since its last report
+ */
+struct LibraryScanBatch {
+    std::vector<LibraryFile> files;
+    QStringList directories; // Every directory listed, for the watcher
+};
+
+/**
+ * @brief The media files and subdirectories directly inside a directory
+ */
+struct DirectoryListing {
+    std::vector<LibraryFile> files;
+    QStringList subdirectories;
+};
+
+namespace LibraryScanner {
+
+// What a walk uses when the caller does not say; directory listing is latency-bound on network shares
+[[nodiscard]] int defaultThreadCount();
+
+/**
+ * Walks the trees under roots with threadCount workers and blocks until done.
+ * Each worker keeps its own deque of directories, takes its newest entry
+ * and, when it runs dry, steals the oldest from another worker, so one deep
+ * tree is spread over all threads without a shared queue. onBatch() is
+ * called from the workers, a few hundred files at a time. Symlinked
+ * directories are not followed. Returns the number of files found, or -1
+ * when cancelled() turned true (polled once per directory).
+ */
+int scan(const QStringList& roots, int threadCount,
+         const std::function<void(LibraryScanBatch&&)>& onBatch,
+         const std::function<bool()>& cancelled = {});
+
+// One directory, not descending; nullopt once it no longer exists
+[[nodiscard]] std::optional<DirectoryListing> listDirectory(const QString& directory);
+
+} // namespace LibraryScanner
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_LIBRARYSCANNER_H
@@ -0,0 +1,102 @@
+#ifndef DARKPLAY_MEDIA_MEDIACLOCK_H
+#define DARKPLAY_MEDIA_MEDIACLOCK_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <atomic>
+#include <mutex>
+#include "utils/SeqLock.h"
+
+namespace DarkPlay::Media {
+
+enum class ClockSource {
+    None,   // Nothing loaded yet
+    Audio,  // What the audio output is playing right now
+    Engine  // The backend's own position, while no audio anchor is fresh
+};
+
+// Everything a frame scheduler needs in one read
+struct ClockReading {
+    qint64 nowUs{-1}; // Media time, -1 if unknown
+    double rate{1.0};
+    ClockSource source{ClockSource::None};
+    bool running{false}; // Playing, so the time moves
+};
+
+struct ClockStats {
+    ClockSource source{ClockSource::None};
+    double rate{1.0};
+    qint64 positionUs{-1};
+    qint64 driftUs{0};    // Presented video minus the clock, smoothed; positive is video ahead
+    qint64 maxDriftUs{0}; // Largest drift either way in the last second
+    quint64 driftSamples{0};
+};
+
+/**
+ * @brief The master playback clock, audio first, and the video's drift from it
+ *
+ * The audio output publishes what it is playing from its own callback, without
+ * locking; between updates the time is extrapolated at the playback rate. With
+ * no fresh audio anchor - no audio, or the backend plays it itself - the
+ * engine's position stands in. Video is the slave: each presented frame is
+ * compared against the clock to measure drift.
+ *
+ * reset(), setRate(), setPaused() and updateFromEngine() come from the engine
+ * thread, updateFromAudio() from the audio thread only; reads are safe anywhere.
+ */
+class MediaClock
+{
+public:
+    MediaClock();
+
+    MediaClock(const MediaClock&) = delete;
+    MediaClock& operator=(const MediaClock&) = delete;
+
+    // Load or seek: the time jumps to mediaUs and earlier audio anchors are void
+    void reset(qint64 mediaUs) noexcept;
+    void setRate(double rate) noexcept;
+    void setPaused(bool paused) noexcept;
+    void updateFromEngine(qint64 mediaUs) noexcept;
+
+    // mediaUs was audible at wallNs, a wallNs() reading taken before the audio state was read
+    void updateFromAudio(qint64 mediaUs, qint64 wallNs) noexcept;
+    [[nodiscard]] qint64 wallNs() const noexcept { return m_wallClock.nsecsElapsed(); }
+
+    [[nodiscard]] qint64 nowUs() const noexcept { return reading().nowUs; }
+    [[nodiscard]] ClockReading reading() const noexcept;
+
+    // A frame that started at frameStartUs went on screen just now
+    void recordVideoPresented(qint64 frameStartUs);
+    [[nodiscard]] ClockStats stats() const;
+
+private:
+    struct Anchor {
+        qint64 mediaUs{-1}; // -1 until the first update
+        qint64 wallNs{0};
+    };
+
+    [[nodiscard]] static bool load(const Utils::SeqLock<Anchor>& anchor, Anchor& value) noexcept;
+
+    static constexpr qint64 AUDIO_STALE_NS = 250000000; // An audio output that went quiet this long is not the master
+    static constexpr qint64 DRIFT_WINDOW_MS = 1000;
+    static constexpr double DRIFT_SMOOTHING = 0.1;
+
+    QElapsedTimer m_wallClock;
+    Utils::SeqLock<Anchor> m_audio;  // Written by the audio thread
+    Utils::SeqLock<Anchor> m_engine; // Written by the engine thread
+    std::atomic<qint64> m_epochNs; // Audio anchors stamped before this predate the last jump
+    std::atomic<double> m_rate;
+    std::atomic<bool> m_paused;
+
+    // Drift, GUI thread
+    mutable std::mutex m_driftMutex;
+    double m_smoothedDriftUs;
+    qint64 m_windowMaxDriftUs;
+    qint64 m_previousWindowMaxDriftUs;
+    qint64 m_windowStartMs;
+    quint64 m_driftSamples;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_MEDIACLOCK_H
@@ -0,0 +1,67 @@
+#ifndef DARKPLAY_MEDIA_MEDIAENGINEREGISTRY_H
+#define DARKPLAY_MEDIA_MEDIAENGINEREGISTRY_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <optional>
+#include "IMediaEngine.h"
+
+namespace DarkPlay::Media {
+
+struct EngineOptions {
+    bool hardwareDecoding{true};
+};
+
+struct EngineDescriptor {
+    QString id;
+    QString displayName;
+    QString owner;      // Plugin that provides the engine, empty for built-ins
+    int priority{0};    // Higher wins when no engine is asked for by id
+    bool perInstanceHardwareDecoding{false}; // Honours EngineOptions::hardwareDecoding per engine
+    std::function<std::unique_ptr<IMediaEngine>(const EngineOptions&)> create;
+};
+
+/**
+ * @brief The IMediaEngine implementations that can be instantiated
+ *
+ * The Qt Multimedia engine is always registered as "qt"; IMediaCodecPlugins
+ * add theirs while they are enabled. GUI-thread only.
+ */
+class MediaEngineRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char* BUILTIN_ENGINE_ID = "qt";
+
+    // Owned by the application object, created on first call
+    [[nodiscard]] static MediaEngineRegistry* instance();
+
+    // Replaces an engine with the same id
+    void registerEngine(EngineDescriptor descriptor);
+    void unregisterEngine(const QString& id);
+    void unregisterOwner(const QString& owner);
+
+    // By descending priority
+    [[nodiscard]] QList<EngineDescriptor> engines() const;
+    [[nodiscard]] std::optional<EngineDescriptor> engine(const QString& id) const;
+
+    // The engine registered as id, or the highest-priority one when there is none
+    [[nodiscard]] std::optional<EngineDescriptor> select(const QString& id) const;
+    [[nodiscard]] std::unique_ptr<IMediaEngine> create(const QString& id, const EngineOptions& options) const;
+
+signals:
+    void enginesChanged();
+
+private:
+    explicit MediaEngineRegistry(QObject* parent = nullptr);
+
+    QList<EngineDescriptor> m_engines; // Kept sorted by descending priority
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_MEDIAENGINEREGISTRY_H
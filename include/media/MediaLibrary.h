@@ -0,0 +1,96 @@
+#ifndef DARKPLAY_MEDIA_MEDIALIBRARY_H
+#define DARKPLAY_MEDIA_MEDIALIBRARY_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <optional>
+#include "LibraryIndex.h"
+#include "LibraryScanner.h"
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief The media files under the library folders, searchable as you type
+ *
+ * Folders are walked in parallel off the GUI thread (see LibraryScanner) and
+ * every directory found is put under a QFileSystemWatcher, which is inotify
+ * on Linux and FSEvents on macOS. A change lists just the directories it
+ * touched, after a short pause to let copies settle, and new files are
+ * handed to the MetadataCache. Watchers only hear about changes made
+ * through this machine; rescan() catches up with a share that others write
+ * to. GUI-thread only.
+ */
+class MediaLibrary : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MediaLibrary(QObject* parent = nullptr);
+    ~MediaLibrary() override;
+
+    MediaLibrary(const MediaLibrary&) = delete;
+    MediaLibrary& operator=(const MediaLibrary&) = delete;
+
+    // library/folders: added folders are walked, removed ones leave the index at once
+    void setFolders(const QStringList& folders);
+    [[nodiscard]] const QStringList& folders() const noexcept { return m_folders; }
+
+    // Drops the index and walks every folder again
+    void rescan();
+
+    [[nodiscard]] bool isScanning() const noexcept { return m_activeScans > 0; }
+    [[nodiscard]] int count() const noexcept { return m_index.count(); }
+    // Directories the watcher refused, usually for want of inotify watches
+    [[nodiscard]] int unwatchedDirectories() const noexcept { return m_unwatched; }
+
+    [[nodiscard]] LibrarySearchResult search(const LibraryQuery& query) const { return m_index.search(query); }
+
+signals:
+    void scanningChanged(bool scanning);
+    // At most every few hundred milliseconds while a walk delivers files
+    void contentsChanged();
+
+private:
+    void startScan(const QStringList& roots);
+    void onScanBatch(quint64 generation, const LibraryScanBatch& batch);
+    void onScanFinished(quint64 generation, const QStringList& roots, int files, qint64 elapsedMs);
+
+    void onDirectoryChanged(const QString& directory);
+    void listChangedDirectories();
+    void onDirectoryListed(quint64 generation, const QString& directory,
+                           const std::optional<DirectoryListing>& listing);
+
+    void watch(const QStringList& directories);
+    void unwatchUnder(const QString& directory);
+    void notifyChanged();
+    [[nodiscard]] bool isInFolders(const QString& path) const;
+
+    [[nodiscard]] static QString normalizedFolder(const QString& folder);
+
+    static constexpr int CHANGE_SETTLE_MS = 500;
+    static constexpr int NOTIFY_INTERVAL_MS = 250;
+
+    std::atomic<quint64> m_generation; // Bumped by rescan(); stale walks stop and their results are dropped
+    QStringList m_folders;
+    LibraryIndex m_index;
+    int m_activeScans;
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_watched;
+    int m_unwatched;
+    QSet<QString> m_changedDirectories;
+    QTimer m_changeTimer;
+    QTimer m_notifyTimer;
+
+    QThreadPool m_ioPool; // One thread: walks and single-directory listings run in order
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_MEDIALIBRARY_H
@@ -4,25 +4,54 @@
 #include <QObject>
 #include <QUrl>
 #include <QStringList>
-#include <QTimer>
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <mutex>
+#include "EngineThread.h"
 #include "IMediaEngine.h"
+#include "PlaybackSnapshot.h"
+
+class QTimer;
 
 namespace DarkPlay::Media {
 
+class Playlist;
+
+/**
+ * @brief GUI-side facade over the playback engines
+ *
+ * The engines live on an EngineThread. Control calls return at once: they
+ * update the snapshot optimistically and queue a command, with bursts of
+ * seeks, volume and rate changes coalesced into the latest value. Engine
+ * state comes back through queued signals into the snapshot. GUI-thread only,
+ * except snapshot().
+ *
+ * Seeks are throttled: at most one is in flight until the engine reports
+ * seekCompleted(), and requests arriving meanwhile collapse into the latest.
+ */
 class MediaManager : public QObject {
     Q_OBJECT
 
 public:
+    using EngineFactory = std::function<std::unique_ptr<IMediaEngine>()>;
+
     explicit MediaManager(QObject* parent = nullptr);
     ~MediaManager() override;
 
-    // Engine management
+    // Engine management - the engine moves to the engine thread; the video sink follows to replacements
     void setMediaEngine(std::unique_ptr<IMediaEngine> engine);
+    // Lives on the engine thread: only the frame statistics may be used directly
     [[nodiscard]] IMediaEngine* mediaEngine() const;
+    void setEngineFactory(EngineFactory factory);
+    // Blocks until queued engine work has run, e.g. before unloading a plugin an engine may use
+    void waitForEngine();
+
+    void setVideoSink(QVideoSink* sink);
+    [[nodiscard]] QVideoSink* videoSink() const noexcept { return m_videoSink; }
+    // The engine answers asynchronously; done(false) when it needs to be recreated instead
+    void setHardwareDecoding(bool enabled, std::function<void(bool applied)> done);
 
-    // Playback control
+    // Playback control - loading is queued, failures arrive as errorOccurred
     bool loadMedia(const QUrl& url);
     void play();
     void pause();
@@ -33,9 +62,18 @@ public:
     [[nodiscard]] qint64 position() const;
     [[nodiscard]] qint64 duration() const;
     void setPosition(qint64 position);
+    // User seeks: follow seekMode(), snapping to KeyframeIndex keyframes in Fast mode
+    void seekTo(qint64 position);
     void seek(qint64 offset);
     void seekForward(qint64 seconds = 10);
     void seekBackward(qint64 seconds = 10);
+    // Slider drags: keyframe seeks follow the handle, endScrub() lands exactly where it was let go
+    void scrubTo(qint64 position);
+    void endScrub(qint64 position);
+    void setSeekMode(SeekMode mode);
+    [[nodiscard]] SeekMode seekMode() const;
+    // True when the step was queued: there is an engine and the media has video
+    bool stepFrame(int frames);
 
     // Volume control
     [[nodiscard]] int volume() const;
@@ -65,9 +103,9 @@ public:
     [[nodiscard]] bool hasVideo() const;
     [[nodiscard]] bool hasAudio() const;
 
-    // Playlist support
+    // Playlist support - edit the playlist in place; the current item follows its row
     void setPlaylist(const QStringList& urls);
-    [[nodiscard]] QStringList playlist() const;
+    [[nodiscard]] Playlist* playlist() const noexcept { return m_playlist; }
     [[nodiscard]] int currentIndex() const;
     void setCurrentIndex(int index);
     void next();
@@ -80,10 +118,39 @@ public:
     [[nodiscard]] bool autoPlay() const;
     void setRepeatMode(bool enabled);
     [[nodiscard]] bool repeatMode() const;
+    // next()/previous() follow the playlist's shuffle order
+    void setShuffle(bool enabled);
+    [[nodiscard]] bool shuffle() const;
+
+    // Gapless pre-roll: the next playlist item is opened in a second, paused
+    // engine shortly before the current one ends and swapped in at the boundary
+    void setPrerollEnabled(bool enabled);
+    [[nodiscard]] bool prerollEnabled() const;
+    void setPrerollLeadTime(int seconds);
+    [[nodiscard]] int prerollLeadTime() const;
 
-    // Thread-safe engine access
     [[nodiscard]] bool hasEngine() const noexcept;
 
+    // Lock-free consistent view of the engine state, safe to read from any thread
+    [[nodiscard]] PlaybackSnapshotPtr snapshot() const noexcept;
+
+    // Frame timing of the active engine
+    [[nodiscard]] FrameStats frameStats() const;
+    void resetFrameStats();
+    void reportFramePresented(qint64 presentationTimeUs);
+    // Master clock of the active engine
+    [[nodiscard]] ClockReading clockReading() const;
+    [[nodiscard]] ClockStats clockStats() const;
+
+    // Audio effect chain applied to the active engine (and to engines swapped in later)
+    void setAudioEffects(const QList<Plugins::IAudioEffectPlugin*>& effects);
+
+    // Network streaming: read-ahead/ABR options take effect on the next load
+    void setStreamingOptions(const StreamingOptions& options);
+    [[nodiscard]] StreamingOptions streamingOptions() const;
+    // The last sample; each call queues a fresh one
+    [[nodiscard]] StreamingStats streamingStats();
+
 signals:
     void mediaLoaded(const QString& url);
     void stateChanged(PlaybackState state);
@@ -94,11 +161,12 @@ signals:
     void playbackRateChanged(qreal rate);
     void mediaInfoChanged();
     void errorOccurred(const QString& error);
-    void playlistChanged();
+    void playlistChanged(); // Replaced wholesale; incremental edits come from Playlist
     void currentIndexChanged(int index);
+    void bufferingProgress(int progress);
+    void hardwareDecodingFailed(const QString& reason);
 
 private slots:
-    void onPositionTimer();
     void onEngineStateChanged(PlaybackState state);
     void onEnginePositionChanged(qint64 position);
     void onEngineDurationChanged(qint64 duration);
@@ -106,34 +174,85 @@ private slots:
     void onEngineMutedChanged(bool muted);
     void onEnginePlaybackRateChanged(qreal rate);
     void onEngineMediaInfoChanged();
+    void onEngineMediaLoaded();
     void onEngineErrorOccurred(const QString& error);
 
 private:
-    void connectEngineSignals();
-    void disconnectEngineSignals();
+    void connectEngineSignals(IMediaEngine* engine);
+    // Detaches the engine and deletes it on the engine thread, after its queued commands
+    void retireEngine(std::unique_ptr<IMediaEngine> engine);
+    void connectPlaylistSignals();
+    void onPlaylistRowsInserted(int first, int last);
+    void onPlaylistRowsRemoved(int first, int last);
+    void onPlaylistRowsMoved(int first, int last, int destinationRow);
     void validatePlaylistIndex();
     void loadCurrentMedia();
     [[nodiscard]] bool isValidIndex(int index) const;
+    [[nodiscard]] int nextIndex() const;
+    [[nodiscard]] int previousIndex() const;
+    // Fast mode: the keyframe nearest target, never on the far side of current
+    [[nodiscard]] qint64 resolveSeekTarget(qint64 current, qint64 target, SeekMode mode) const;
+    [[nodiscard]] qint64 clampToDuration(qint64 position) const;
 
-    // Thread-safe engine operations
-    template<typename Func>
-    auto safeEngineCall(Func&& func) const -> decltype(func(std::declval<IMediaEngine&>()));
+    // Pre-roll helpers
+    void preparePreroll(qint64 position);
+    bool swapToPrerolledEngine();
+    void discardPreroll();
 
+    // Queues func(engine) on the engine thread; false without an engine
     template<typename Func>
-    bool safeEngineCallVoid(Func&& func) const;
+    bool postToEngine(Func&& func, EngineThread::Coalesce key = EngineThread::Coalesce::None);
+    // Posts the seek, or parks it as the deferred one while another is in flight
+    void requestSeek(qint64 position);
+    void postSeek(qint64 position);
+    void publishSeekTarget(qint64 position);
+    void onSeekIssued(quint64 sequence);
+    void settleSeek();
+    [[nodiscard]] bool seekPending() const noexcept { return m_settledSeek != m_seekSequence; }
 
+    // Snapshot publishing - GUI thread only (single writer)
+    template<typename Mutator>
+    void publishSnapshot(Mutator&& mutate);
+    // Reads the whole engine state on its thread; what to announce once it is published
+    enum class Refresh { Quiet, MediaInfo, Swap };
+    void refreshSnapshot(Refresh refresh = Refresh::Quiet);
+    void applyEngineState(const PlaybackSnapshot& state, Refresh refresh);
+
+    std::unique_ptr<EngineThread> m_engineThread;
     std::unique_ptr<IMediaEngine> m_engine;
-    mutable std::recursive_mutex m_engineMutex; // Protect engine access
+    // Bumped per engine, so queued signals from a replaced one are dropped
+    quint64 m_engineGeneration;
+    std::atomic<PlaybackSnapshotPtr> m_snapshot;
+
+    // Engine positions are stale until the latest seek has completed
+    quint64 m_seekSequence; // Handed to the engine thread
+    quint64 m_issuedSeek;   // Started by the engine
+    quint64 m_settledSeek;  // Reported complete, or timed out
+    qint64 m_deferredSeek;  // Latest request waiting for the one in flight; -1 if none
+    QTimer* m_seekTimeout;  // For engines that never report seekCompleted()
 
-    QStringList m_playlist;
+    // Warm engine holding the next playlist item (pre-roll mode)
+    std::unique_ptr<IMediaEngine> m_prerollEngine;
+    EngineFactory m_engineFactory;
+    int m_prerollIndex;
+    quint64 m_prerollGeneration;
+    bool m_prerollEnabled;
+    int m_prerollLeadTimeMs;
+
+    // Kept here so replacement engines get the same setup
+    QVideoSink* m_videoSink;
+    QList<Plugins::IAudioEffectPlugin*> m_audioEffects;
+    StreamingOptions m_streamingOptions;
+    StreamingStats m_streamingStats;
+
+    Playlist* m_playlist;
     int m_currentIndex;
     QString m_currentUrl;
     bool m_autoPlay;
     bool m_repeatMode;
+    bool m_shuffle;
     int m_previousVolume;
-
-    QTimer* m_positionTimer;
-    mutable std::mutex m_playlistMutex; // Protect playlist operations
+    SeekMode m_seekMode;
 };
 
 } // namespace DarkPlay::Media
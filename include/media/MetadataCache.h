@@ -0,0 +1,127 @@
+#ifndef DARKPLAY_MEDIA_METADATACACHE_H
+#define DARKPLAY_MEDIA_METADATACACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <mutex>
+#include <optional>
+#include "IMediaEngine.h"
+#include "utils/MemoryBudget.h"
+
+class QMediaPlayer;
+
+namespace DarkPlay::Media {
+
+class MetadataProber;
+
+/**
+ * @brief What a probe of a media file yields
+ */
+struct MediaInfo {
+    qint64 durationMs{0};
+    QSize resolution;
+    QString videoCodec;
+    QString audioCodec;
+    QString title;
+    int audioTrackCount{0};
+    MediaType mediaType{MediaType::Unknown};
+};
+
+/**
+ * @brief Persistent media metadata, keyed by path, size and modification time
+ *
+ * Entries live in a binary index under AppDataLocation that is read once off
+ * the GUI thread. Missing or stale files are probed in the background by a
+ * private QMediaPlayer; engines also store what they learn while playing.
+ * lookup(), store() and detectMediaType() may be called from the engine
+ * thread; everything else is GUI-thread only. Over the memory budget the
+ * least recently used entries leave RAM and the index and are probed again
+ * when they are next needed.
+ */
+class MetadataCache : public QObject, public Utils::MemoryConsumer
+{
+    Q_OBJECT
+
+public:
+    // Owned by the application object, created on first call
+    [[nodiscard]] static MetadataCache* instance();
+
+    // Cached info for a local file, if the file is unchanged since it was stored
+    [[nodiscard]] std::optional<MediaInfo> lookup(const QString& filePath);
+
+    // Queues background probes for files that are not cached yet
+    void prefetch(const QStringList& filePaths);
+    void store(const QString& filePath, const MediaInfo& info);
+
+    // Best guess without probing: cached type, else the MIME type of the name and contents
+    [[nodiscard]] MediaType detectMediaType(const QString& filePath);
+
+    // What a player that reached LoadedMedia knows about its source
+    [[nodiscard]] static MediaInfo infoFromPlayer(const QMediaPlayer& player);
+
+    [[nodiscard]] static QString formatDuration(qint64 milliseconds);
+
+    // Utils::MemoryConsumer
+    [[nodiscard]] qint64 memoryBytes() const override;
+    [[nodiscard]] qint64 oldestUseMs() const override;
+    qint64 evict(qint64 bytes) override;
+
+signals:
+    void infoAvailable(const QString& filePath, const DarkPlay::Media::MediaInfo& info);
+
+private:
+    explicit MetadataCache(QObject* parent = nullptr);
+    ~MetadataCache() override;
+
+    friend class MetadataProber;
+
+    struct Entry {
+        qint64 size{0};
+        qint64 modifiedMs{0};
+        qint64 lastUsedSecs{0};
+        MediaInfo info;
+    };
+
+    void ensureLoaded();
+    void onLoaded(const QHash<QString, Entry>& entries);
+    void onProbed(const QString& filePath, qint64 size, qint64 modifiedMs, const MediaInfo& info);
+    void scheduleSave();
+    void save();
+
+    [[nodiscard]] static QString indexPath();
+    [[nodiscard]] static QHash<QString, Entry> readIndex(const QString& path);
+    static void writeIndex(const QString& path, QHash<QString, Entry> entries);
+    [[nodiscard]] static qint64 entryBytes(const QString& filePath, const Entry& entry);
+
+    static constexpr int SAVE_DELAY_MS = 2000;
+    static constexpr int MAX_ENTRIES = 50000;
+    static constexpr int INDEX_FORMAT_VERSION = 1;
+    static constexpr qint64 ENTRY_OVERHEAD_BYTES = 160; // Hash node, Entry and string headers
+
+    mutable std::mutex m_mutex; // Guards m_entries, m_entryBytes, m_loadRequested and m_dirty
+    QHash<QString, Entry> m_entries;
+    qint64 m_entryBytes;
+    QStringList m_pendingProbes; // Requested before the index finished loading
+    QSet<QString> m_probeRequested; // This session, whether or not the probe succeeded
+    bool m_loadRequested;
+    bool m_loaded;
+    bool m_dirty;
+
+    QTimer m_saveTimer;
+    QThreadPool m_ioPool;
+    QThread m_probeThread;
+    MetadataProber* m_prober; // Lives on m_probeThread
+};
+
+} // namespace DarkPlay::Media
+
+Q_DECLARE_METATYPE(DarkPlay::Media::MediaInfo)
+
+#endif // DARKPLAY_MEDIA_METADATACACHE_H
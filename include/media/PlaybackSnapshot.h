@@ -0,0 +1,38 @@
+#ifndef DARKPLAY_MEDIA_PLAYBACKSNAPSHOT_H
+#define DARKPLAY_MEDIA_PLAYBACKSNAPSHOT_H
+
+#include <QString>
+#include <QSize>
+#include <memory>
+#include "IMediaEngine.h"
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Immutable, consistent view of the engine state
+ *
+ * Published by MediaManager from the engine's own signals; readers on any
+ * thread obtain the whole state with a single atomic load instead of taking
+ * the engine lock once per getter.
+ */
+struct PlaybackSnapshot {
+    PlaybackState state{PlaybackState::Stopped};
+    MediaType mediaType{MediaType::Unknown};
+    qint64 position{0};
+    qint64 duration{0};
+    int volume{0};
+    bool muted{false};
+    qreal playbackRate{1.0};
+    QString title;
+    QString errorString;
+    QSize videoSize;
+    bool hasVideo{false};
+    bool hasAudio{false};
+    quint64 sequence{0}; // Incremented on every publish
+};
+
+using PlaybackSnapshotPtr = std::shared_ptr<const PlaybackSnapshot>;
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_PLAYBACKSNAPSHOT_H
@@ -0,0 +1,152 @@
+#ifndef DARKPLAY_MEDIA_PLAYLIST_H
+#define DARKPLAY_MEDIA_PLAYLIST_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <vector>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Deterministic permutation of [0, size) computed on demand
+ *
+ * A small Feistel network with cycle walking, so a 100k-item shuffle costs
+ * a seed instead of a 400 KB index table. Both directions are O(1).
+ */
+class ShuffleOrder
+{
+public:
+    ShuffleOrder() = default;
+    ShuffleOrder(int size, quint64 seed);
+
+    [[nodiscard]] int size() const noexcept { return m_size; }
+    [[nodiscard]] quint64 seed() const noexcept { return m_seed; }
+
+    // Row played at the given shuffle position, and the inverse
+    [[nodiscard]] int rowAt(int position) const;
+    [[nodiscard]] int positionOf(int row) const;
+
+private:
+    [[nodiscard]] quint32 round(quint32 half, int roundIndex) const noexcept;
+    [[nodiscard]] quint32 encrypt(quint32 value) const noexcept;
+    [[nodiscard]] quint32 decrypt(quint32 value) const noexcept;
+
+    static constexpr int ROUNDS = 4;
+
+    int m_size{0};
+    quint64 m_seed{0};
+    int m_halfBits{1};
+    quint32 m_halfMask{1};
+};
+
+/**
+ * @brief Playlist storage sized for hundreds of thousands of URLs
+ *
+ * Each entry is a 16-byte record: a stable ID, an interned directory prefix
+ * and the UTF-8 bytes of the last path segment in a shared arena. URL
+ * strings are only built when asked for. Changes are reported with the
+ * same begin/end signal pairs a QAbstractListModel needs, so a view model
+ * can forward them one to one.
+ *
+ * GUI-thread only. M3U/PLS import streams the file on a worker thread and
+ * appends in batches.
+ */
+class Playlist : public QObject
+{
+    Q_OBJECT
+
+public:
+    using EntryId = quint32;
+
+    explicit Playlist(QObject* parent = nullptr);
+    ~Playlist() override;
+
+    Playlist(const Playlist&) = delete;
+    Playlist& operator=(const Playlist&) = delete;
+
+    [[nodiscard]] int count() const noexcept { return static_cast<int>(m_entries.size()); }
+    [[nodiscard]] bool isEmpty() const noexcept { return m_entries.empty(); }
+
+    [[nodiscard]] QString urlAt(int row) const;
+    [[nodiscard]] EntryId idAt(int row) const;
+    // Last path segment, without building the full URL
+    [[nodiscard]] QString displayNameAt(int row) const;
+    // Linear scan over the 16-byte records; -1 if the entry is gone
+    [[nodiscard]] int indexOfId(EntryId id) const;
+
+    // Structural edits; rows follow QAbstractItemModel conventions
+    void insert(int row, const QStringList& urls);
+    void append(const QStringList& urls);
+    void remove(int row, int count = 1);
+    bool move(int row, int count, int destinationRow);
+    void reset(const QStringList& urls);
+    void clear();
+
+    // Shuffle order over the current rows; reshuffled whenever the row count changes
+    [[nodiscard]] const ShuffleOrder& shuffleOrder() const noexcept { return m_shuffleOrder; }
+    void reshuffle();
+
+    // Appends the entries of an .m3u/.m3u8/.pls file; cancels a running import
+    void importFile(const QString& filePath);
+    void cancelImport();
+    [[nodiscard]] bool isImporting() const noexcept { return m_importing; }
+
+signals:
+    void rowsAboutToBeInserted(int first, int last);
+    void rowsInserted(int first, int last);
+    void rowsAboutToBeRemoved(int first, int last);
+    void rowsRemoved(int first, int last);
+    void rowsAboutToBeMoved(int first, int last, int destinationRow);
+    void rowsMoved(int first, int last, int destinationRow);
+    void modelAboutToBeReset();
+    void modelReset();
+
+    void importProgress(int imported);
+    void importFinished(int imported, const QString& error);
+
+private:
+    struct Entry {
+        EntryId id;
+        quint32 prefix;
+        quint32 nameOffset;
+        quint32 nameLength;
+    };
+
+    [[nodiscard]] Entry makeEntry(const QString& url);
+    [[nodiscard]] quint32 internPrefix(const QString& prefix);
+    void releaseEntries(std::vector<Entry>::const_iterator first, std::vector<Entry>::const_iterator last);
+    void compactNames();
+    void updateShuffleOrder();
+
+    // Worker side of importFile(), cancelled when m_importGeneration moves on
+    void runImport(quint64 generation, const QString& filePath);
+    void onImportBatch(quint64 generation, const QStringList& urls);
+    void onImportFinished(quint64 generation, const QString& error);
+
+    static constexpr int IMPORT_BATCH_SIZE = 2000;
+    static constexpr qsizetype MIN_COMPACT_BYTES = 64 * 1024;
+
+    std::vector<Entry> m_entries;
+    QByteArray m_names; // UTF-8 last segments, referenced by offset
+    qsizetype m_garbageBytes;
+    QStringList m_prefixes;
+    QHash<QString, quint32> m_prefixIds;
+    EntryId m_nextId;
+
+    ShuffleOrder m_shuffleOrder;
+
+    std::atomic<quint64> m_importGeneration;
+    bool m_importing;
+    int m_importedCount;
+    QThreadPool m_ioPool;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_PLAYLIST_H
@@ -2,15 +2,20 @@
 #define DARKPLAY_MEDIA_QTMEDIAENGINE_H
 
 #include "IMediaEngine.h"
+#include "MetadataCache.h"
 #include <QMediaPlayer>
 #include <QAudioOutput>
+#include <QList>
+#include <QTimer>
+#include <atomic>
 #include <memory>
-
-// Forward declaration to avoid unused include warning
-class QVideoSink;
+#include <optional>
 
 namespace DarkPlay::Media
 {
+    class AdaptiveBitrateController;
+    class AudioPipeline;
+    class StreamBuffer;
 
     /**
      * @brief Qt Multimedia implementation of IMediaEngine
@@ -32,6 +37,8 @@ namespace DarkPlay::Media
         [[nodiscard]] qint64 position() const override;
         [[nodiscard]] qint64 duration() const override;
         void setPosition(qint64 position) override;
+        // Seeks to the middle of the target frame, timed from the last frame the sink received
+        bool stepFrame(int frames) override;
 
         [[nodiscard]] int volume() const override;
         void setVolume(int volume) override;
@@ -51,8 +58,27 @@ namespace DarkPlay::Media
         [[nodiscard]] bool hasAudio() const override;
 
         // Video output support
-        void setVideoSink(QVideoSink* sink);
-        [[nodiscard]] QVideoSink* videoSink() const;
+        void setVideoSink(QVideoSink* sink) override;
+        [[nodiscard]] QVideoSink* videoSink() const override;
+
+        // Frame timing instrumentation
+        [[nodiscard]] FrameStats frameStats() const override;
+        void resetFrameStats() override;
+        void reportFramePresented(qint64 presentationTimeUs) override;
+
+        // Audio-driven while AudioPipeline plays, the backend's position otherwise
+        [[nodiscard]] ClockReading clockReading() const override { return m_clock.reading(); }
+        [[nodiscard]] ClockStats clockStats() const override { return m_clock.stats(); }
+
+        // Audio effects - routes playback through AudioPipeline while the chain is non-empty or a rate needs stretching
+        void setAudioEffects(const QList<Plugins::IAudioEffectPlugin*>& effects) override;
+
+        // Network sources: progressive HTTP through StreamBuffer, HLS through AdaptiveBitrateController
+        void setStreamingOptions(const StreamingOptions& options) override;
+        [[nodiscard]] StreamingStats streamingStats() const override;
+
+        // Decode APIs are chosen per process by HardwareDecoding; this engine cannot switch
+        [[nodiscard]] bool hardwareDecodingActive() const override;
 
     private slots:
         void onPlayerStateChanged(QMediaPlayer::PlaybackState state);
@@ -60,22 +86,61 @@ namespace DarkPlay::Media
         void onPlayerErrorOccurred(QMediaPlayer::Error error, const QString& errorString);
         void onPlayerPositionChanged(qint64 position);
         void onPlayerDurationChanged(qint64 duration);
+        void onPlayerMetaDataChanged();
         void onAudioOutputVolumeChanged(float volume);
         void onAudioOutputMutedChanged(bool muted);
+        void applyDefaultAudioDevice();
+        void onPlayerBufferProgressChanged(float progress);
+        void onVariantSelected(const QUrl& url, int index);
 
     private:
         [[nodiscard]] PlaybackState convertState(QMediaPlayer::PlaybackState qtState) const;
         [[nodiscard]] MediaType detectMediaType(const QUrl& url) const;
         void updateVideoInfo();
         void initializeAudioOutput();
-        [[nodiscard]] float getSystemVolumeLevel() const;
+        bool enableAudioPipeline();
+        void disableAudioPipeline();
+        [[nodiscard]] bool audioPipelineWanted() const;
+        void openStream(const QUrl& url);
+        void openDirect(const QUrl& url, const QString& mode);
+        void releaseStream();
+        void finishPendingLoad();
+        // Keyframe index, then measured rate, then container metadata; 0 if unknown
+        [[nodiscard]] qint64 frameDurationUs() const;
+
+        static constexpr float DEFAULT_MEDIA_VOLUME = 0.95f;
 
         std::unique_ptr<QMediaPlayer> m_player;
         std::unique_ptr<QAudioOutput> m_audioOutput;
         QVideoSink* m_videoSink; // Not owned
+        QMetaObject::Connection m_sinkFrameConnection;
+        FrameStatistics m_frameStatistics;
+        std::atomic<qint64> m_lastFrameStartUs; // Written on the sink's thread, -1 if none yet
+        std::atomic<bool> m_seekLanding;        // A seek went out and seekCompleted() is still owed
+        qint64 m_stepTargetUs;    // Frame the last step asked for, -1 if none
+        qint64 m_stepFromFrameUs; // Frame on screen when that step was issued
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+        std::unique_ptr<AudioPipeline> m_audioPipeline; // Only while effects or time-stretch are active
+#endif
+        QList<Plugins::IAudioEffectPlugin*> m_audioEffects;
+        MediaClock m_clock;
+        bool m_timeStretch; // A rate other than 1 was set; kept until the next load so speed changes stay seamless
         QString m_lastError;
         QSize m_videoSize;
         MediaType m_currentMediaType;
+        std::optional<MediaInfo> m_cachedInfo; // From MetadataCache until the player has loaded
+        qint64 m_pendingSeek; // setPosition() before the media has loaded, -1 if none
+
+        // Network streaming
+        StreamingOptions m_streamingOptions;
+        StreamingStatistics m_streamingStatistics;
+        std::unique_ptr<StreamBuffer> m_streamBuffer;
+        std::unique_ptr<AdaptiveBitrateController> m_abrController;
+        QTimer m_stallRecoveryTimer;
+        bool m_sourcePending;     // Waiting for the stream probe before setSource
+        bool m_playWhenReady;     // play() arrived while the source was pending
+        qint64 m_resumePosition;  // Restored after a variant switch, -1 if none
+        bool m_resumePlaying;
     };
 
 } // namespace DarkPlay::Media
@@ -0,0 +1,95 @@
+#ifndef DARKPLAY_MEDIA_QTMEDIATRANSCODER_H
+#define DARKPLAY_MEDIA_QTMEDIATRANSCODER_H
+
+#include <QAudioBuffer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMediaFormat>
+#include <QMediaPlayer>
+#include <QMediaRecorder>
+#include <QTimer>
+#include <QVideoFrame>
+#include "IMediaTranscoder.h"
+
+class QAudioBufferInput;
+class QAudioBufferOutput;
+class QMediaCaptureSession;
+class QVideoFrameInput;
+class QVideoSink;
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief The built-in transcoder: QMediaPlayer decodes, QMediaRecorder encodes
+ *
+ * Decoded frames and audio buffers go straight into the capture session's
+ * frame inputs (Qt 6.8+). When the encoder falls behind, the player pauses
+ * until it is ready again, so at most a few frames wait in between. The FFmpeg
+ * backend picks hardware encoders from QT_FFMPEG_ENCODING_HW_DEVICE_TYPES,
+ * see HardwareDecoding::configure().
+ */
+class QtMediaTranscoder : public IMediaTranscoder
+{
+    Q_OBJECT
+
+public:
+    explicit QtMediaTranscoder(QObject* parent = nullptr);
+    ~QtMediaTranscoder() override;
+
+    void start(const ExportJob& job) override;
+    void cancel() override;
+
+    // The container for "mp4", "mkv", ...; UnspecifiedFormat if unknown
+    [[nodiscard]] static QMediaFormat::FileFormat fileFormat(const QString& format);
+
+private:
+    void onMediaStatusChanged(QMediaPlayer::MediaStatus status);
+    void beginRecording();
+    void onVideoFrame(const QVideoFrame& frame);
+    void onAudioBuffer(const QAudioBuffer& buffer);
+    void onRecorderStateChanged(QMediaRecorder::RecorderState state);
+    // Hands over what was held back while the encoder was busy; resumes once all of it is in
+    void drainPending();
+    void stall();
+    void endOfRange();
+    void fail(const QString& error);
+    void finish(bool ok, const QString& error);
+    void reportProgress();
+
+    ExportJob m_job;
+    qint64 m_startUs;
+    qint64 m_endUs;
+
+    QMediaPlayer* m_player;
+    QVideoSink* m_videoSink;
+    QAudioBufferOutput* m_audioOutput;
+    QMediaCaptureSession* m_session;
+    QMediaRecorder* m_recorder;
+    QVideoFrameInput* m_videoInput;
+    QAudioBufferInput* m_audioInput;
+    QTimer* m_progressTimer;
+
+    QList<QVideoFrame> m_pendingFrames;
+    QList<QAudioBuffer> m_pendingAudio;
+    bool m_stalled;
+    bool m_recording;
+    bool m_ending;
+    bool m_finished;
+    QString m_error; // Set once the job has failed; the recorder still has to stop
+
+    QElapsedTimer m_elapsed;
+    qint64 m_frames;
+    qint64 m_droppedFrames; // Beyond MAX_PENDING; only a backend that ignores pause() gets here
+    qint64 m_processedUs;
+    qint64 m_lastProcessedUs;
+    int m_idleTicks; // Progress ticks without new media time
+
+    static constexpr int LOAD_TIMEOUT_MS = 15000;
+    static constexpr int PROGRESS_INTERVAL_MS = 500;
+    static constexpr int STALL_TICKS = 30; // 15 s without progress: the source is stuck
+    static constexpr int MAX_PENDING = 8;  // Frames or buffers held back while the encoder is busy
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_QTMEDIATRANSCODER_H
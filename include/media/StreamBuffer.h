@@ -0,0 +1,141 @@
+#ifndef DARKPLAY_MEDIA_STREAMBUFFER_H
+#define DARKPLAY_MEDIA_STREAMBUFFER_H
+
+#include <QIODevice>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QUrl>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "StreamingStatistics.h"
+#include "utils/MemoryBudget.h"
+
+namespace DarkPlay::Media {
+
+class StreamFetcher;
+
+/**
+ * @brief Seekable read-ahead window over an HTTP(S) resource
+ *
+ * A fetcher thread downloads with Range requests into 256 KB blocks, keeps
+ * the configured window filled ahead of the read position and stops reading
+ * (applying TCP back-pressure) once it is. Blocks that fall out of the RAM
+ * budget spill into a bounded temporary file, so seeking back is usually
+ * free. Stalled connections are re-requested from where they stopped.
+ * Blocks already read are what the memory budget may take back; the window
+ * ahead is only ever shrunk by low-memory mode.
+ *
+ * The backend reads from its demuxer thread; readData() blocks until the
+ * bytes arrive, the buffer is closed or the source fails. Servers without
+ * range support are handed back via fallbackRequired().
+ */
+class StreamBuffer : public QIODevice, public Utils::MemoryConsumer
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        qint64 bytesReceived{0};
+        qint64 bufferedAheadBytes{0};
+        double throughputKbps{0.0};
+        int reconnects{0};
+        int readStalls{0};     // Reads that had to wait for the network
+        qint64 readStallMs{0};
+    };
+
+    StreamBuffer(const QUrl& url, const StreamingOptions& options, QObject* parent = nullptr);
+    ~StreamBuffer() override;
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Opens the device and probes the server; ends in ready(), fallbackRequired() or failed()
+    void start();
+
+    [[nodiscard]] QUrl url() const { return m_url; }
+    [[nodiscard]] Stats stats() const;
+
+    // QIODevice - safe to call from the reading thread
+    [[nodiscard]] bool isSequential() const override { return false; }
+    [[nodiscard]] qint64 size() const override;
+    [[nodiscard]] qint64 bytesAvailable() const override;
+    [[nodiscard]] bool atEnd() const override;
+    bool seek(qint64 position) override;
+    void close() override;
+
+    // Utils::MemoryConsumer - any thread
+    [[nodiscard]] qint64 memoryBytes() const override;
+    [[nodiscard]] qint64 oldestUseMs() const override;
+    qint64 evict(qint64 bytes) override;
+
+    static constexpr qint64 BLOCK_SIZE = 256 * 1024;
+
+signals:
+    void ready();
+    void fallbackRequired(const QString& reason);
+    void failed(const QString& error);
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    friend class StreamFetcher;
+
+    // A block lives either in RAM or in a spill-file slot; only the download frontier is partial
+    struct Block {
+        QByteArray data;
+        qint64 length{0};
+        qint64 diskSlot{-1};
+        qint64 lastUsedMs{0}; // Arrival or last read, MemoryBudget::nowMs()
+    };
+
+    // All *Locked helpers expect m_mutex to be held
+    void storeLocked(qint64 offset, const char* data, qint64 length);
+    [[nodiscard]] qint64 contiguousFromLocked(qint64 offset) const;
+    [[nodiscard]] qint64 firstMissingFromLocked(qint64 offset) const;
+    [[nodiscard]] qint64 copyLocked(qint64 offset, char* data, qint64 maxSize);
+    [[nodiscard]] bool isBlockCompleteLocked(qint64 index, const Block& block) const;
+    void evictLocked();
+    void releaseLocked(std::map<qint64, Block>::iterator block);
+    [[nodiscard]] bool isReleasableBehindLocked(qint64 index, const Block& block) const;
+    [[nodiscard]] qint64 acquireDiskSlotLocked();
+    void requestScheduleLocked();
+
+    static constexpr qint64 BEHIND_RAM_BYTES = 8 * 1024 * 1024;
+    static constexpr int WAIT_SLICE_MS = 100;
+    static constexpr int READ_GIVE_UP_MS = 60000;
+
+    const QUrl m_url;
+    const StreamingOptions m_options;
+    const qint64 m_behindRamBytes; // RAM kept behind the read position before blocks spill
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_dataArrived;
+    std::map<qint64, Block> m_blocks; // By block index
+    qint64 m_total;                   // -1 until the probe has answered
+    qint64 m_readPosition;
+    qint64 m_ramBytes;
+    bool m_closed;
+    bool m_failed;
+    bool m_fetcherPaused;
+
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    std::vector<qint64> m_freeDiskSlots;
+    qint64 m_nextDiskSlot;
+    bool m_spillUnavailable;
+
+    Stats m_stats;
+    std::atomic<bool> m_schedulePending;
+
+    QThread m_fetchThread;
+    StreamFetcher* m_fetcher; // Lives on m_fetchThread
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_STREAMBUFFER_H
@@ -0,0 +1,83 @@
+#ifndef DARKPLAY_MEDIA_STREAMINGSTATISTICS_H
+#define DARKPLAY_MEDIA_STREAMINGSTATISTICS_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <QString>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Network source tuning, applied on the next load
+ */
+struct StreamingOptions {
+    qint64 readAheadBytes{32 * 1024 * 1024}; // RAM window kept ahead of the read position
+    qint64 diskCacheBytes{256 * 1024 * 1024}; // Spill for data that falls out of RAM; 0 disables
+    bool adaptiveBitrate{true};               // Select HLS variants from measured throughput
+    int stallRecoveryMs{8000};                // Reconnect or switch down after a stall this long
+};
+
+/**
+ * @brief Point-in-time report for a network source
+ *
+ * Rebuffering is counted only after playback has started; waiting for the
+ * first frame is startup time instead.
+ */
+struct StreamingStats {
+    bool active{false};          // The current source is a network stream
+    QString mode;                // "Progressive", "HLS", "DASH" or "Direct" (handed to the backend as is)
+    qint64 startupMs{-1};        // Load to first buffered playback, -1 until then
+    int stallCount{0};
+    qint64 rebufferMs{0};        // Total time stalled, including a stall in progress
+    qint64 longestStallMs{0};
+    bool stalled{false};
+    int bufferProgress{0};       // Backend buffer fill, percent
+
+    // Read-ahead buffer (progressive mode)
+    qint64 bytesReceived{0};
+    qint64 bufferedAheadBytes{0};
+    double throughputKbps{0.0};
+    int reconnects{0};
+
+    // Adaptive bitrate (HLS mode)
+    int variantCount{0};
+    int variantIndex{-1};        // Ascending bandwidth order
+    qint64 variantBandwidth{0};  // Bits per second, as advertised
+    int variantSwitches{0};
+};
+
+/**
+ * @brief Stall and startup bookkeeping behind StreamingStats
+ *
+ * Used on the owning engine's thread only; fed from media status changes.
+ */
+class StreamingStatistics
+{
+public:
+    StreamingStatistics() = default;
+
+    StreamingStatistics(const StreamingStatistics&) = delete;
+    StreamingStatistics& operator=(const StreamingStatistics&) = delete;
+
+    void start(const QString& mode);
+    void reset();
+
+    void markBuffered();
+    void markStalled();
+    void setBufferProgress(int progress) noexcept { m_stats.bufferProgress = progress; }
+
+    [[nodiscard]] bool isActive() const noexcept { return m_stats.active; }
+    [[nodiscard]] bool isStalled() const noexcept { return m_stats.stalled; }
+    [[nodiscard]] bool hasStarted() const noexcept { return m_stats.startupMs >= 0; }
+    [[nodiscard]] qint64 currentStallMs() const;
+    [[nodiscard]] StreamingStats stats() const;
+
+private:
+    StreamingStats m_stats;
+    QElapsedTimer m_loadTimer;
+    QElapsedTimer m_stallTimer;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_STREAMINGSTATISTICS_H
@@ -0,0 +1,38 @@
+#ifndef DARKPLAY_MEDIA_SUBTITLEPARSER_H
+#define DARKPLAY_MEDIA_SUBTITLEPARSER_H
+
+#include <QString>
+#include <functional>
+#include <optional>
+#include "SubtitleTrack.h"
+
+class QIODevice;
+
+namespace DarkPlay::Media {
+
+enum class SubtitleFormat {
+    SubRip, // .srt
+    WebVtt, // .vtt
+    Ass     // .ass, .ssa
+};
+
+namespace SubtitleParser {
+
+// From the file suffix; nullopt for anything else
+[[nodiscard]] std::optional<SubtitleFormat> formatForPath(const QString& filePath);
+
+/**
+ * Reads the device line by line, so memory stays at the cues themselves
+ * however large the file. UTF-8 (with or without BOM), falling back to the
+ * local 8-bit encoding once a line is not valid UTF-8. Styling is reduced to
+ * bold, italic and underline. Returns nullptr when cancelled() turns true
+ * (polled every few hundred lines) or no cue could be read.
+ */
+[[nodiscard]] SubtitleTrackPtr parse(QIODevice& device, SubtitleFormat format,
+                                     const std::function<bool()>& cancelled = {});
+
+} // namespace SubtitleParser
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_SUBTITLEPARSER_H
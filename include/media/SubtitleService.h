@@ -0,0 +1,95 @@
+#ifndef DARKPLAY_MEDIA_SUBTITLESERVICE_H
+#define DARKPLAY_MEDIA_SUBTITLESERVICE_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QThreadPool>
+#include <QUrl>
+#include <atomic>
+#include "SubtitleParser.h"
+#include "SubtitleTrack.h"
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief A sidecar subtitle file found next to the media
+ */
+struct SubtitleTrackInfo {
+    QString filePath;
+    QString label; // What the file name adds to the media's, e.g. "en" for movie.en.srt
+    SubtitleFormat format{SubtitleFormat::SubRip};
+};
+
+/**
+ * @brief Sidecar subtitles for the current local file
+ *
+ * Discovery (a directory listing) and parsing run on a background thread;
+ * only the selected track is held in memory. updatePosition() is called on
+ * every position tick: it reuses the last lookup while the position stays
+ * inside the span it was valid for and otherwise asks the track's interval
+ * index, so a tick costs at most O(log n). textChanged() fires only when the
+ * visible cues change. GUI-thread only.
+ */
+class SubtitleService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SubtitleService(QObject* parent = nullptr);
+    ~SubtitleService() override;
+
+    SubtitleService(const SubtitleService&) = delete;
+    SubtitleService& operator=(const SubtitleService&) = delete;
+
+    // Non-local URLs clear the tracks; the previous discovery or parse is cancelled either way
+    void setSource(const QUrl& mediaUrl);
+    void clear();
+
+    // media/subtitleAutoLoad: look for sidecar files and show the preferred one
+    void setAutoLoad(bool enabled);
+    [[nodiscard]] bool autoLoad() const noexcept { return m_autoLoad; }
+
+    [[nodiscard]] const QList<SubtitleTrackInfo>& tracks() const noexcept { return m_tracks; }
+    [[nodiscard]] int currentTrack() const noexcept { return m_currentTrack; }
+    // -1 turns subtitles off
+    void selectTrack(int index);
+
+    void updatePosition(qint64 positionMs);
+    [[nodiscard]] QString currentText() const { return m_text; }
+
+signals:
+    void tracksChanged();
+    void currentTrackChanged(int index);
+    // Rich text for the renderer, empty when nothing shows
+    void textChanged(const QString& html);
+
+private:
+    void discover();
+    void onDiscovered(quint64 generation, const QList<SubtitleTrackInfo>& tracks);
+    void onParsed(quint64 generation, const SubtitleTrackPtr& track);
+    void setText(const QString& html);
+
+    [[nodiscard]] static QList<SubtitleTrackInfo> findSidecars(const QString& mediaPath);
+    [[nodiscard]] static int preferredTrack(const QList<SubtitleTrackInfo>& tracks);
+    [[nodiscard]] static SubtitleTrackPtr load(const SubtitleTrackInfo& info, const std::function<bool()>& cancelled);
+
+    static constexpr qint64 MAX_FILE_BYTES = 64 * 1024 * 1024;
+
+    std::atomic<quint64> m_generation; // Bumped on every source or track change; workers poll it
+    QUrl m_source;
+    bool m_autoLoad;
+
+    QList<SubtitleTrackInfo> m_tracks;
+    int m_currentTrack;
+    SubtitleTrackPtr m_track;
+    SubtitleTrack::Lookup m_lookup; // Last answer, reused while the position stays inside it
+    QString m_text;
+    qint64 m_positionMs;
+
+    QThreadPool m_ioPool;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_SUBTITLESERVICE_H
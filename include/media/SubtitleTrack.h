@@ -0,0 +1,73 @@
+#ifndef DARKPLAY_MEDIA_SUBTITLETRACK_H
+#define DARKPLAY_MEDIA_SUBTITLETRACK_H
+
+#include <QString>
+#include <QStringView>
+#include <memory>
+#include <vector>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Cues of one subtitle file, indexed by time
+ *
+ * Immutable once built, so a track can be shared across threads. Cue text
+ * lives in one arena; a cue itself is 24 bytes. Cues are sorted by start
+ * time and overlaid with an implicit interval tree (each node keeps the
+ * latest end time below it), so cuesAt() costs O(log n) plus the cues it
+ * returns, however many cues overlap elsewhere in the file.
+ */
+class SubtitleTrack
+{
+public:
+    // Showing from startMs up to, not including, endMs
+    struct Cue {
+        qint64 startMs;
+        qint64 endMs;
+        quint32 textOffset;
+        quint32 textLength;
+    };
+
+    // What shows at a position, and until when that answer holds
+    struct Lookup {
+        QString html;           // Active cues in start order, one per line; empty if none
+        qint64 validFromMs{0};  // The lookup position
+        qint64 validUntilMs{0}; // Next cue start or end after it
+    };
+
+    /**
+     * @brief Collects cues in any order; finish() sorts and indexes them
+     */
+    class Builder
+    {
+    public:
+        // Text is the subtitle HTML subset: escaped, with <b>, <i>, <u> and <br>
+        void addCue(qint64 startMs, qint64 endMs, QStringView html);
+        [[nodiscard]] int cueCount() const noexcept { return static_cast<int>(m_cues.size()); }
+        [[nodiscard]] std::shared_ptr<const SubtitleTrack> finish();
+
+    private:
+        std::vector<Cue> m_cues;
+        QString m_text;
+    };
+
+    [[nodiscard]] Lookup cuesAt(qint64 positionMs) const;
+    [[nodiscard]] int cueCount() const noexcept { return static_cast<int>(m_cues.size()); }
+    [[nodiscard]] QStringView text(const Cue& cue) const noexcept;
+
+private:
+    SubtitleTrack() = default;
+
+    qint64 buildIndex(int begin, int end);
+    void collect(int begin, int end, qint64 positionMs, std::vector<int>& active) const;
+
+    std::vector<Cue> m_cues;
+    std::vector<qint64> m_maxEndMs; // Per node of the implicit tree: node (b + e) / 2 spans [b, e)
+    QString m_text;
+};
+
+using SubtitleTrackPtr = std::shared_ptr<const SubtitleTrack>;
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_SUBTITLETRACK_H
@@ -0,0 +1,115 @@
+#ifndef DARKPLAY_MEDIA_THUMBNAILSERVICE_H
+#define DARKPLAY_MEDIA_THUMBNAILSERVICE_H
+
+#include <QObject>
+#include <QBitArray>
+#include <QImage>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QUrl>
+#include "utils/MemoryBudget.h"
+
+namespace DarkPlay::Media {
+
+class ThumbnailDecoder;
+
+/**
+ * @brief Seek-preview thumbnails for the current local file
+ *
+ * Thumbnails are decoded by a small pool of worker threads, each driving its
+ * own QMediaPlayer, so the playing engine is never seeked. They are packed
+ * into sprite sheets and cached under CacheLocation, keyed by a hash of the
+ * file size and its first and last megabyte. Lookups are in-memory crops and
+ * safe to call on every mouse move. Under the memory budget a saved set is
+ * dropped from RAM and read back from disk when the preview is next wanted.
+ */
+class ThumbnailService : public QObject, public Utils::MemoryConsumer
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailService(QObject* parent = nullptr);
+    ~ThumbnailService() override;
+
+    ThumbnailService(const ThumbnailService&) = delete;
+    ThumbnailService& operator=(const ThumbnailService&) = delete;
+
+    // Non-local URLs clear the thumbnails; the previous job is cancelled either way
+    void setSource(const QUrl& url);
+    void clear();
+
+    [[nodiscard]] bool hasThumbnails() const noexcept { return m_decodedCount > 0; }
+    [[nodiscard]] bool isComplete() const noexcept { return m_complete; }
+
+    // Nearest decoded thumbnail to the position, or a null image while evicted sheets reload
+    [[nodiscard]] QImage thumbnailAt(qint64 positionMs);
+
+    // Utils::MemoryConsumer, GUI thread
+    [[nodiscard]] qint64 memoryBytes() const override { return m_sheetBytes; }
+    [[nodiscard]] qint64 oldestUseMs() const override;
+    qint64 evict(qint64 bytes) override;
+
+    static constexpr int THUMBNAIL_WIDTH = 160;
+    static constexpr int THUMBNAIL_HEIGHT = 90;
+
+signals:
+    // Emitted as thumbnails arrive, then once more when the set is complete
+    void thumbnailsUpdated();
+
+private:
+    friend class ThumbnailDecoder;
+
+    // Thumbnail i shows position i * intervalMs and lives in sheets[i / THUMBNAILS_PER_SHEET]
+    struct SpriteSheets {
+        int count{0};
+        qint64 intervalMs{0};
+        QBitArray decoded;
+        QList<QImage> sheets;
+    };
+
+    // Worker thread callbacks, delivered queued on the service's thread
+    void onPlanned(quint64 generation, int count, qint64 intervalMs);
+    void onThumbnailDecoded(quint64 generation, int index, const QImage& image);
+    void onDecoderFinished(quint64 generation);
+    void onCacheLookupFinished(quint64 generation, const QString& cacheKey, const SpriteSheets& cached);
+
+    void startDecoders();
+    void stopDecoders();
+    void storeSheets();
+    void reloadSheets();
+    void updateSheetBytes();
+
+    [[nodiscard]] static QString computeCacheKey(const QString& filePath);
+    [[nodiscard]] static QString cacheDirectory(const QString& cacheKey);
+    [[nodiscard]] static bool loadSheets(const QString& cacheKey, SpriteSheets& result);
+    static void saveSheets(const QString& cacheKey, const SpriteSheets& thumbnails);
+
+    static constexpr int SHEET_COLUMNS = 10;
+    static constexpr int SHEET_ROWS = 10;
+    static constexpr int THUMBNAILS_PER_SHEET = SHEET_COLUMNS * SHEET_ROWS;
+    static constexpr int CACHE_FORMAT_VERSION = 1;
+    static constexpr int MAX_DECODERS = 2;
+
+    quint64 m_generation; // Bumped on every source change; stale results are dropped
+    QUrl m_source;
+    QString m_cacheKey;
+
+    SpriteSheets m_thumbnails;
+    int m_decodedCount;
+    bool m_complete;
+    qint64 m_sheetBytes;
+    qint64 m_lastUseMs;
+    bool m_evicted;   // Complete and saved, but dropped from RAM by the memory budget
+    bool m_reloading;
+
+    QList<QPointer<QThread>> m_decoderThreads; // Delete themselves once finished
+    int m_runningDecoders;
+    QThreadPool m_ioPool; // Hashing, cache reads and writes
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_THUMBNAILSERVICE_H
@@ -0,0 +1,102 @@
+#ifndef DARKPLAY_MEDIA_VIDEOFANOUT_H
+#define DARKPLAY_MEDIA_VIDEOFANOUT_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+#include <QVideoSink>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "MediaClock.h"
+
+namespace DarkPlay::Media {
+
+struct VideoFanoutStats {
+    int outputs{0};
+    quint64 framesDistributed{0};
+    qint64 lastSkewUs{-1}; // Between the first and last output drawing the same frame, -1 if unknown
+    qint64 maxSkewUs{-1};  // Worst of the last second
+    int framesHeld{0};     // Decoded ahead of the clock, waiting for their time
+    quint64 framesDroppedLate{0}; // Due together with a newer one, so never shown
+};
+
+/**
+ * @brief One decoded video stream shown on several sinks
+ *
+ * The engine renders into inputSink() only. Every frame it delivers is handed
+ * to each output in the same pass on the GUI thread; QVideoFrame is shared by
+ * reference, so more outputs cost uploads, never another decode. There is one
+ * clock - the engine's - and all outputs always show what it made current.
+ * Outputs report what they drew to measure how far apart they land.
+ *
+ * While the clock follows the audio, frames that arrive early wait until the
+ * clock reaches them, and of several that are due only the newest is shown;
+ * video slaves to the audio instead of to the decoder's own pacing. Paused,
+ * or without an audio clock, frames go out as they arrive.
+ */
+class VideoFanout : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VideoFanout(QObject* parent = nullptr);
+    ~VideoFanout() override = default;
+
+    VideoFanout(const VideoFanout&) = delete;
+    VideoFanout& operator=(const VideoFanout&) = delete;
+
+    // The sink to hand to the engine
+    [[nodiscard]] QVideoSink* inputSink() noexcept { return &m_input; }
+
+    // Not owned; a destroyed sink drops out by itself. A new output gets the current frame
+    void addOutput(QVideoSink* sink);
+    void removeOutput(QVideoSink* sink);
+    [[nodiscard]] int outputCount() const;
+
+    // An output drew the frame that started at presentationTimeUs
+    void reportPresented(qint64 presentationTimeUs);
+
+    // Read on every frame, GUI thread; without one frames are never held
+    using ClockReader = std::function<ClockReading()>;
+    void setClock(ClockReader reader);
+
+    [[nodiscard]] VideoFanoutStats stats() const;
+
+private:
+    void onFrameArrived(const QVideoFrame& frame);
+    void presentDue();
+    void distribute(const QVideoFrame& frame);
+    [[nodiscard]] ClockReading readClock() const;
+
+    static constexpr qint64 SKEW_WINDOW_MS = 1000;
+    static constexpr size_t MAX_HELD_FRAMES = 4;          // Held frames pin decoder surfaces; hardware pools are small
+    static constexpr qint64 PRESENT_TOLERANCE_US = 2000;  // Due this close to the clock
+    static constexpr qint64 MAX_AHEAD_US = 250000;        // Further ahead the timestamps jumped; show it now
+
+    QVideoSink m_input;
+    std::vector<QPointer<QVideoSink>> m_outputs;
+    QVideoFrame m_currentFrame;
+    quint64 m_framesDistributed;
+
+    // Scheduling against the master clock
+    ClockReader m_clockReader;
+    std::deque<QVideoFrame> m_held; // In arrival order
+    QTimer m_presentTimer;
+    quint64 m_framesDroppedLate;
+
+    // Presentation of the newest frame across the outputs
+    QElapsedTimer m_clock;
+    qint64 m_skewFrameUs; // startTime() of the newest frame handed out
+    qint64 m_skewFirstNs;
+    int m_skewReports;
+    qint64 m_lastSkewUs;
+    qint64 m_windowMaxSkewUs;
+    qint64 m_previousWindowMaxSkewUs;
+    qint64 m_windowStartMs;
+};
+
+} // namespace DarkPlay::Media
+
+#endif // DARKPLAY_MEDIA_VIDEOFANOUT_H
@@ -5,6 +5,8 @@
 #include <QString>
 #include <QJsonObject>
 
+namespace DarkPlay::Media { class IMediaEngine; class IMediaTranscoder; }
+
 namespace DarkPlay {
 namespace Plugins {
 
@@ -49,6 +51,26 @@ public:
     virtual QStringList supportedFormats() const = 0;
     virtual bool canDecode(const QString& format) const = 0;
     virtual bool canEncode(const QString& format) const = 0;
+
+    // Alternative playback engines (libmpv, GStreamer, ...) offered to MediaEngineRegistry
+    virtual QStringList mediaEngineIds() const { return {}; }
+    virtual QString mediaEngineName(const QString& engineId) const { return engineId; }
+    // Caller takes ownership; nullptr if the engine cannot be created
+    virtual Media::IMediaEngine* createMediaEngine(const QString& engineId, bool hardwareDecoding)
+    {
+        Q_UNUSED(engineId)
+        Q_UNUSED(hardwareDecoding)
+        return nullptr;
+    }
+
+    // Export: asked for each job whose container format canEncode() accepts; caller takes
+    // ownership and moves it to a worker thread. nullptr leaves the job to the next encoder
+    virtual Media::IMediaTranscoder* createTranscoder(const QString& format, bool hardwareEncoding)
+    {
+        Q_UNUSED(format)
+        Q_UNUSED(hardwareEncoding)
+        return nullptr;
+    }
 };
 
 /**
@@ -72,6 +94,8 @@ class IAudioEffectPlugin : public IPlugin
     Q_OBJECT
 
 public:
+    // In-place on interleaved float: buffer holds samples (frames) * channels values.
+    // Runs on the real-time DSP thread - must not block, lock or allocate
     virtual void processAudio(float* buffer, int samples, int channels) = 0;
     virtual QWidget* createControlWidget() = 0;
 };
@@ -80,7 +104,9 @@ public:
 } // namespace DarkPlay
 
 Q_DECLARE_INTERFACE(DarkPlay::Plugins::IPlugin, "com.darkplay.IPlugin/1.0")
-Q_DECLARE_INTERFACE(DarkPlay::Plugins::IMediaCodecPlugin, "com.darkplay.IMediaCodecPlugin/1.0")
+// Bumped whenever a virtual is added, so qobject_cast rejects plugins built against an older vtable.
+// 1.1: media engine factory. 1.2: createTranscoder()
+Q_DECLARE_INTERFACE(DarkPlay::Plugins::IMediaCodecPlugin, "com.darkplay.IMediaCodecPlugin/1.2")
 Q_DECLARE_INTERFACE(DarkPlay::Plugins::IThemePlugin, "com.darkplay.IThemePlugin/1.0")
 Q_DECLARE_INTERFACE(DarkPlay::Plugins::IAudioEffectPlugin, "com.darkplay.IAudioEffectPlugin/1.0")
 
@@ -8,6 +8,9 @@ namespace DarkPlay::UI {
 
 /**
  * @brief A custom slider that allows clicking anywhere on the track to jump to that position
+ *
+ * Hovering reports the value under the cursor (for seek previews). A press on
+ * the track can be dragged; sliderReleased() marks the end of the gesture.
  */
 class ClickableSlider : public QSlider
 {
@@ -17,11 +20,22 @@ public:
     explicit ClickableSlider(Qt::Orientation orientation, QWidget *parent = nullptr);
     ~ClickableSlider() override = default;
 
+signals:
+    // position is in slider coordinates
+    void hoverMoved(int value, const QPoint& position);
+    void hoverLeft();
+
 protected:
     void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
 
 private:
     int calculateValueFromPosition(int position) const;
+    [[nodiscard]] int eventPosition(const QMouseEvent *event) const;
+
+    bool m_trackDragging = false;
 };
 
 } // namespace DarkPlay::UI
@@ -0,0 +1,80 @@
+#ifndef DARKPLAY_UI_LIBRARYDIALOG_H
+#define DARKPLAY_UI_LIBRARYDIALOG_H
+
+#include <QDialog>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+namespace DarkPlay::Media {
+class MediaLibrary;
+struct MediaInfo;
+}
+
+namespace DarkPlay::UI {
+
+/**
+ * @brief Search box over the media library
+ *
+ * Every keystroke queries the in-memory index directly. Durations come from
+ * the MetadataCache for the first rows only, once typing pauses, so a slow
+ * share is not stat()ed for every hit.
+ */
+class LibraryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit LibraryDialog(Media::MediaLibrary* library, QWidget* parent = nullptr);
+    ~LibraryDialog() override = default;
+
+signals:
+    void playRequested(const QStringList& filePaths);
+    void enqueueRequested(const QStringList& filePaths);
+
+private slots:
+    void search();
+    void fillDurations();
+    void addFolder();
+    void removeFolder();
+    void onInfoAvailable(const QString& filePath, const DarkPlay::Media::MediaInfo& info);
+
+private:
+    void updateFolders();
+    void updateStatus();
+    void setFolders(const QStringList& folders);
+    [[nodiscard]] QStringList selectedPaths() const;
+
+    static constexpr int RESULT_LIMIT = 500;
+    static constexpr int DURATION_ROWS = 50;
+    static constexpr int DURATION_DELAY_MS = 300;
+
+    Media::MediaLibrary* m_library;
+
+    QLineEdit* m_searchEdit;
+    QComboBox* m_typeCombo;
+    QComboBox* m_folderCombo;
+    QPushButton* m_addFolderButton;
+    QPushButton* m_removeFolderButton;
+    QPushButton* m_rescanButton;
+    QTreeWidget* m_results;
+    QLabel* m_statusLabel;
+    QPushButton* m_playButton;
+    QPushButton* m_enqueueButton;
+
+    QHash<QString, QTreeWidgetItem*> m_rowsByPath; // Rows of the current result, for late durations
+    int m_matchCount;
+    qint64 m_searchUs;
+    QTimer m_durationTimer;
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_LIBRARYDIALOG_H
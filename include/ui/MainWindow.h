@@ -6,16 +6,15 @@
 #include <QPushButton>
 #include <QSlider>
 #include <QLabel>
-#include <QVideoWidget>
 #include <QProgressBar>
 #include <QTimer>
 #include <QMenu>
 #include <QAction>
 #include <QStringList>
 #include <QPointer>
+#include <QElapsedTimer>
+#include <array>
 #include <memory>
-#include <atomic>
-#include <mutex>
 
 // Include necessary headers for Media types
 #include "media/IMediaEngine.h"
@@ -23,10 +22,15 @@
 // Forward declarations
 namespace DarkPlay {
 namespace Core { class Application; }
-namespace Controllers { class MediaController; }
+namespace Controllers { class MediaController; class RemoteControl; }
 namespace UI {
     class ClickableSlider;
     class SettingDialog;
+    class VideoRenderWidget;
+    class StatsOverlay;
+    class SeekPreviewPopup;
+    class LibraryDialog;
+    class VideoWall;
 }
 }
 
@@ -49,6 +53,9 @@ public:
     MainWindow(MainWindow&&) = delete;
     MainWindow& operator=(MainWindow&&) = delete;
 
+    // Commands from later launches and scripts, see Core::SingleInstance
+    [[nodiscard]] Controllers::RemoteControl* remoteControl() const { return m_remoteControl; }
+
 protected:
     void resizeEvent(QResizeEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
@@ -57,12 +64,14 @@ protected:
     void mouseMoveEvent(QMouseEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void leaveEvent(QEvent* event) override;
+    void changeEvent(QEvent* event) override;
 
 private slots:
     // File operations
     void openFile();
     void openRecentFile();
     void clearRecentFiles();
+    void showLibrary();
 
     // Playback controls
     void togglePlayPause();
@@ -71,14 +80,15 @@ private slots:
     void nextTrack();
 
     // Media controller signal handlers
-    void onPositionChanged(qint64 position);
     void onDurationChanged(qint64 duration);
     void onStateChanged(Media::PlaybackState state);
     void onErrorOccurred(const QString& error);
 
     // UI controls
     void onVolumeChanged(int value);
-    void updateTimeLabels();
+
+    // Playback UI refresh stage, the only place sliders and time labels follow playback
+    void refreshPlaybackUi();
 
     // Settings and dialogs
     void showSettings();
@@ -88,6 +98,12 @@ private slots:
     // Theme handling
     void onThemeChanged(const QString& themeName);
 
+    // Frame timing overlay
+    void setStatsOverlayVisible(bool visible);
+
+    // The video across every screen, the window showing it again once stopped
+    void setVideoWallActive(bool active);
+
     // Context menu
     void showContextMenu(const QPoint& position);
 
@@ -103,6 +119,8 @@ private:
     void setupMenuBar();
     void setupStatusBar();
     void connectSignals();
+    void connectRemoteControl();
+    void addLibraryFiles(const QStringList& filePaths, bool playNow);
 
     // Video widget optimization methods
     void optimizeVideoWidgetRendering();
@@ -111,23 +129,36 @@ private:
     // Settings management
     void loadSettings();
     void saveSettings();
+    void applyStreamingSettings();
 
     // Helper methods
     void updatePlayPauseButton();
     void updateRecentFilesMenu();
+    void addRecentFileAction(QMenu* menu, const QString& filePath);
     void addToRecentFiles(const QString& filePath);
     void setAdaptiveLayout();
     void toggleFullScreen();
     void createFullScreenOverlay();
     void updateOverlayPosition();
     void resetControlsHideTimer();
+    void setupPlaybackUiRefresh();
+    void updatePlaybackUiRefresh();
+    void invalidatePlaybackUi();
+    void applyPlaybackPosition(ClickableSlider* slider, qint64 position);
+    // Thumbnail popup while hovering or dragging a position slider; seeking waits for release
+    void connectSeekPreview(ClickableSlider* slider);
+    void showSeekPreview(ClickableSlider* slider, int value, const QPoint& position);
+    void hideSeekPreview();
     // Unified fullscreen UI management
     void showFullScreenUI();
     void hideFullScreenUI();
     [[nodiscard]] static QString formatTime(qint64 milliseconds);
+    // Writes mm:ss into out (at least TIME_TEXT_CAPACITY characters), returns the length
+    static qsizetype formatTime(qint64 milliseconds, QChar* out) noexcept;
 
     // Theme-aware styling for fullscreen mode
     [[nodiscard]] QString generateFullScreenStyleSheet() const;
+    [[nodiscard]] QString fullScreenStyleSheet() const; // Cached per light/dark variant
 
 private:
     // Core application reference
@@ -135,11 +166,12 @@ private:
 
     // Media controller - критический компонент, используем умный указатель
     std::unique_ptr<Controllers::MediaController> m_mediaController;
+    Controllers::RemoteControl* m_remoteControl;
 
     // UI Components - используем Qt parent-child систему для автоматической очистки
     QWidget* m_centralWidget;
     QVBoxLayout* m_mainLayout;
-    QVideoWidget* m_videoWidget;
+    VideoRenderWidget* m_videoWidget;
     QWidget* m_controlsWidget;
 
     // Layout components managed by Qt
@@ -175,10 +207,9 @@ private:
     bool m_controlsVisible;
     bool m_cursorHidden; // Track cursor state to avoid redundant setCursor calls
 
-    // ULTIMATE CRASH PROTECTION: Add flags and mutex for safe slider updates
-    std::atomic<bool> m_sliderUpdatesEnabled{true};
-    std::atomic<bool> m_isDestructing{false};
-    mutable std::recursive_mutex m_sliderMutex;
+    // Slider updates stop while the window is torn down or rebuilt
+    bool m_sliderUpdatesEnabled{true};
+    bool m_isDestructing{false};
 
     // CRITICAL FIX: Use QPointer for safe widget access during destruction
     QPointer<QWidget> m_fullScreenControlsOverlay;
@@ -190,15 +221,61 @@ private:
     QPointer<ClickableSlider> m_fullScreenProgressSlider;
     QPointer<QSlider> m_fullScreenVolumeSlider;
 
-    std::unique_ptr<QTimer> m_updateTimer;
+    // Frame timing overlay, a child of the video widget so it follows it into fullscreen
+    StatsOverlay* m_statsOverlay{nullptr};
+    QPointer<QAction> m_statsAction;
+
+    // Multi-screen output, created on first use; shares the engine's frames with the window
+    QPointer<VideoWall> m_videoWall;
+    QPointer<QAction> m_videoWallAction;
+
+    // Media library search, created on first use and kept for the session
+    QPointer<LibraryDialog> m_libraryDialog;
+
+    // Seek preview, shared by the docked and fullscreen position sliders
+    SeekPreviewPopup* m_seekPreview{nullptr};
+
+    // A time label's text, formatted in place: the labels share the buffer they
+    // show, so the next value goes into the other one and neither reallocates
+    struct TimeText {
+        qint64 seconds{-1};
+        std::array<QString, 2> buffers;
+        int next{0};
+
+        [[nodiscard]] const QString& update(qint64 milliseconds);
+    };
+
+    // What the refresh stage last put on screen
+    struct PlaybackUiState {
+        bool valid{false};
+        quint64 sequence{0};
+        qint64 duration{-1};
+        bool playing{false};
+        TimeText currentTime;
+        TimeText totalTime;
+    };
+
+    std::unique_ptr<QTimer> m_playbackUiTimer;
+    PlaybackUiState m_playbackUi;
+
+    // Allocations and widget updates in the refresh stage, sampled once a second
+    QElapsedTimer m_playbackUiRateClock;
+    quint64 m_playbackUiAllocationsAtSample{0};
+    quint64 m_playbackUiUpdates{0};
+    quint64 m_playbackUiUpdatesAtSample{0};
+    quint64 m_playbackUiAllocationsPerSecond{0};
+    quint64 m_playbackUiUpdatesPerSecond{0};
+
     std::unique_ptr<QTimer> m_controlsHideTimer;
     std::unique_ptr<QTimer> m_mouseMoveDebounceTimer; // Timer to prevent too frequent UI updates
 
     // Constants
-    static constexpr int UPDATE_INTERVAL_MS = 100;
     static constexpr int MAX_RECENT_FILES = 10;
     static constexpr int CONTROLS_HIDE_TIMEOUT_MS = 3000; // 3 seconds
     static constexpr int MOUSE_MOVE_DEBOUNCE_MS = 100; // Debounce mouse move events
+    static constexpr int STATS_OVERLAY_MARGIN = 8;
+    static constexpr int PLAYBACK_UI_INTERVAL_MS = 50; // 20 Hz
+    static constexpr int TIME_TEXT_CAPACITY = 24;
 };
 
 } // namespace DarkPlay::UI
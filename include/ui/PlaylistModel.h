@@ -0,0 +1,49 @@
+#ifndef DARKPLAY_UI_PLAYLISTMODEL_H
+#define DARKPLAY_UI_PLAYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QPointer>
+
+namespace DarkPlay::Media {
+class Playlist;
+}
+
+namespace DarkPlay::UI {
+
+/**
+ * @brief List model view of a Media::Playlist
+ *
+ * Holds no data of its own: rows are read from the playlist on demand and
+ * its change signals are forwarded as the matching begin/end calls, so views
+ * only ever touch the visible rows.
+ */
+class PlaylistModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        UrlRole = Qt::UserRole + 1,
+        EntryIdRole
+    };
+
+    explicit PlaylistModel(Media::Playlist* playlist, QObject* parent = nullptr);
+    ~PlaylistModel() override = default;
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    [[nodiscard]] QHash<int, QByteArray> roleNames() const override;
+
+    [[nodiscard]] Media::Playlist* playlist() const noexcept { return m_playlist; }
+
+    // Row of the playing item, drawn in bold; -1 for none
+    void setCurrentRow(int row);
+
+private:
+    QPointer<Media::Playlist> m_playlist;
+    int m_currentRow;
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_PLAYLISTMODEL_H
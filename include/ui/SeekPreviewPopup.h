@@ -0,0 +1,36 @@
+#ifndef DARKPLAY_UI_SEEKPREVIEWPOPUP_H
+#define DARKPLAY_UI_SEEKPREVIEWPOPUP_H
+
+#include <QFrame>
+#include <QImage>
+
+class QLabel;
+
+namespace DarkPlay::UI {
+
+/**
+ * @brief Floating thumbnail and timestamp shown above a position slider
+ *
+ * A tool-tip style window, so it can extend past the slider and over the video.
+ */
+class SeekPreviewPopup : public QFrame
+{
+    Q_OBJECT
+
+public:
+    explicit SeekPreviewPopup(QWidget* parent = nullptr);
+    ~SeekPreviewPopup() override = default;
+
+    // anchor is the global point the popup's bottom centre points at; a null image shows the time only
+    void showPreview(const QImage& thumbnail, const QString& timeText, const QPoint& anchor);
+
+private:
+    QLabel* m_imageLabel;
+    QLabel* m_timeLabel;
+
+    static constexpr int ANCHOR_GAP = 6;
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_SEEKPREVIEWPOPUP_H
@@ -55,16 +55,26 @@ namespace DarkPlay::UI {
         // General Settings
         QCheckBox* m_autoPlayCheckBox;
         QCheckBox* m_rememberPositionCheckBox;
+        QCheckBox* m_gaplessPrerollCheckBox;
+        QSpinBox* m_prerollSecondsSpinBox;
+        QComboBox* m_seekModeComboBox;
         QLineEdit* m_defaultDirectoryEdit;
         QPushButton* m_browseButton;
         QSpinBox* m_recentFilesCountSpinBox;
+        QCheckBox* m_singleInstanceCheckBox;
 
         // Media Settings
         QSlider* m_defaultVolumeSlider;
         QLabel* m_volumeLabel;
         QCheckBox* m_hardwareAccelerationCheckBox;
+        QLabel* m_hardwareApisLabel;
+        QComboBox* m_engineComboBox;
         QComboBox* m_audioOutputComboBox;
         QCheckBox* m_subtitleAutoLoadCheckBox;
+        QSpinBox* m_readAheadSpinBox;
+        QSpinBox* m_diskCacheSpinBox;
+        QCheckBox* m_adaptiveBitrateCheckBox;
+        QSpinBox* m_stallRecoverySpinBox;
 
         // Interface Settings
         QCheckBox* m_showStatusBarCheckBox;
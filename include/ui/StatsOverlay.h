@@ -0,0 +1,75 @@
+#ifndef DARKPLAY_UI_STATSOVERLAY_H
+#define DARKPLAY_UI_STATSOVERLAY_H
+
+#include <QLabel>
+#include <QTimer>
+#include <functional>
+#include "media/FrameStatistics.h"
+#include "media/MediaClock.h"
+#include "media/StreamingStatistics.h"
+#include "media/VideoFanout.h"
+#include "utils/MemoryBudget.h"
+
+namespace DarkPlay::UI {
+
+// Cost of the window's playback UI refresh stage, see MainWindow::refreshPlaybackUi()
+struct UiRefreshStats {
+    quint64 allocationsPerSecond{0};
+    quint64 updatesPerSecond{0}; // Widget changes it made
+};
+
+/**
+ * @brief Live frame timing readout drawn over the video
+ *
+ * Polls its providers only while visible, so a hidden overlay costs nothing.
+ * Network streams add buffer, rebuffer and bitrate lines; the UI line, shown in
+ * allocation-counting builds, shows what the window's own refresh stage costs,
+ * which should be no allocations.
+ * The memory line breaks the cache budget down by subsystem, and a video wall
+ * adds how far apart its screens draw the same frame. The clock line shows
+ * what drives playback and how far the video strays from it.
+ */
+class StatsOverlay : public QLabel
+{
+    Q_OBJECT
+
+public:
+    using StatsProvider = std::function<Media::FrameStats()>;
+    using StreamingStatsProvider = std::function<Media::StreamingStats()>;
+    using UiStatsProvider = std::function<UiRefreshStats()>;
+    using MemoryStatsProvider = std::function<Utils::MemoryStats()>;
+    using FanoutStatsProvider = std::function<Media::VideoFanoutStats()>;
+    using ClockStatsProvider = std::function<Media::ClockStats()>;
+
+    explicit StatsOverlay(QWidget* parent = nullptr);
+    ~StatsOverlay() override = default;
+
+    void setStatsProvider(StatsProvider provider);
+    void setStreamingStatsProvider(StreamingStatsProvider provider);
+    void setUiStatsProvider(UiStatsProvider provider);
+    void setMemoryStatsProvider(MemoryStatsProvider provider);
+    void setFanoutStatsProvider(FanoutStatsProvider provider);
+    void setClockStatsProvider(ClockStatsProvider provider);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void refresh();
+
+private:
+    StatsProvider m_provider;
+    StreamingStatsProvider m_streamingProvider;
+    UiStatsProvider m_uiProvider;
+    MemoryStatsProvider m_memoryProvider;
+    FanoutStatsProvider m_fanoutProvider;
+    ClockStatsProvider m_clockProvider;
+    QTimer m_refreshTimer;
+
+    static constexpr int REFRESH_INTERVAL_MS = 500;
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_STATSOVERLAY_H
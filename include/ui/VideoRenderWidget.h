@@ -0,0 +1,132 @@
+#ifndef DARKPLAY_UI_VIDEORENDERWIDGET_H
+#define DARKPLAY_UI_VIDEORENDERWIDGET_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <QMatrix4x4>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+#include <QVideoSink>
+#include <array>
+#include <memory>
+
+namespace DarkPlay::UI {
+
+/**
+ * @brief OpenGL video output fed directly from a QVideoSink
+ *
+ * Decoded frames are uploaded in their native layout (NV12/NV21, YUV420P/YV12,
+ * P010/P016 or packed RGB) as one texture per plane, and YUV to RGB conversion
+ * runs in the fragment shader. Formats without a native path fall back to
+ * QVideoFrame::toImage(). Subtitles are rasterised once per change into a
+ * texture and blended over the picture in the same pass. As part of a video
+ * wall it draws only its tile of the picture.
+ */
+class VideoRenderWidget : public QOpenGLWidget, protected QOpenGLFunctions
+{
+    Q_OBJECT
+
+public:
+    explicit VideoRenderWidget(QWidget* parent = nullptr);
+    ~VideoRenderWidget() override;
+
+    VideoRenderWidget(const VideoRenderWidget&) = delete;
+    VideoRenderWidget& operator=(const VideoRenderWidget&) = delete;
+
+    // Sink to hand to the media engine
+    [[nodiscard]] QVideoSink* videoSink() const noexcept { return m_videoSink; }
+
+    // Same semantics as QVideoWidget::setAspectRatioMode
+    void setAspectRatioMode(Qt::AspectRatioMode mode);
+    [[nodiscard]] Qt::AspectRatioMode aspectRatioMode() const noexcept { return m_aspectRatioMode; }
+
+    // Video wall: the picture is fitted to wall and this widget shows the viewport part of it,
+    // both in one coordinate space (virtual desktop pixels). An empty wall shows the whole picture
+    void setWallViewport(const QRectF& wall, const QRectF& viewport);
+
+    // Subtitle rich text as SubtitleService emits it; empty hides the subtitle
+    void setSubtitleText(const QString& html);
+
+signals:
+    // A newly uploaded frame has been drawn; startTime() of that frame in microseconds
+    void framePresented(qint64 presentationTimeUs);
+
+protected:
+    void initializeGL() override;
+    void resizeGL(int w, int h) override;
+    void paintGL() override;
+
+private slots:
+    void onVideoFrameChanged(const QVideoFrame& frame);
+    void cleanupGL();
+
+private:
+    // How the planes are combined in the fragment shader
+    enum class PlaneLayout {
+        None,
+        Packed,     // Single RGBA texture
+        SemiPlanar, // Luma + interleaved chroma (NV12, P010)
+        Planar,     // Luma + two chroma planes (YUV420P)
+        Overlay     // Premultiplied RGBA blended over the picture (subtitles)
+    };
+
+    static constexpr int MAX_PLANES = 3;
+
+    bool uploadFrame();
+    bool uploadNativeFrame(QVideoFrame& frame);
+    bool uploadFallbackFrame(const QVideoFrame& frame);
+    void uploadPlane(int index, int width, int height, int channels, int bytesPerChannel,
+                     const uchar* data, int bytesPerLine);
+    void updateColorMatrix(const QVideoFrameFormat& format, bool swapChroma);
+    void updateQuad();
+    bool createShaderProgram();
+    void drawSubtitle();
+    void uploadSubtitle();
+
+    QVideoSink* m_videoSink;
+    QVideoFrame m_currentFrame;
+    bool m_frameDirty;
+    bool m_presentPending;
+
+    // GL resources - valid only between initializeGL() and cleanupGL()
+    std::unique_ptr<QOpenGLShaderProgram> m_program;
+    QOpenGLBuffer m_vertexBuffer;
+    QOpenGLVertexArrayObject m_vertexArray;
+    std::array<GLuint, MAX_PLANES> m_textures{};
+    std::array<QSize, MAX_PLANES> m_planeSizes;
+    std::array<int, MAX_PLANES> m_planeFormats{};
+    bool m_glInitialized;
+    bool m_hasRedTextures;     // GL_R8/GL_RG8 available (desktop GL or GLES 3)
+    bool m_hasUnpackRowLength; // Strided uploads without repacking
+    bool m_hasShortTextures;   // GL_R16/GL_RG16 available (desktop GL)
+
+    // Current frame description
+    PlaneLayout m_layout;
+    QSize m_frameSize;
+    QMatrix4x4 m_colorMatrix;
+    bool m_swapRedBlue;
+    bool m_mirrored;
+    bool m_bottomToTop;
+    bool m_geometryDirty;
+    QVideoFrameFormat::PixelFormat m_fallbackFormat; // Last format reported as unsupported
+
+    Qt::AspectRatioMode m_aspectRatioMode;
+    QRectF m_wall;
+    QRectF m_wallViewport;
+    QByteArray m_repackBuffer;
+
+    // Subtitle overlay
+    QString m_subtitleHtml;
+    GLuint m_subtitleTexture;
+    QOpenGLBuffer m_subtitleBuffer;
+    QRectF m_videoRect;   // Where the picture lands, in widget coordinates
+    bool m_subtitleDirty; // Text or geometry changed since the last upload
+    bool m_subtitleReady; // The texture and quad hold the current text
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_VIDEORENDERWIDGET_H
@@ -0,0 +1,62 @@
+#ifndef DARKPLAY_UI_VIDEOWALL_H
+#define DARKPLAY_UI_VIDEOWALL_H
+
+#include <QObject>
+#include <QPointer>
+#include <QRect>
+#include <vector>
+
+class QScreen;
+
+namespace DarkPlay::Media {
+class VideoFanout;
+}
+
+namespace DarkPlay::UI {
+
+class VideoRenderWidget;
+
+/**
+ * @brief The video spread across every screen, one full-screen tile each
+ *
+ * The picture is fitted to the bounding box of all screens and each tile draws
+ * its screen's part of it. Tiles are outputs of the fanout, so they all show
+ * the frame the engine made current; Escape on any of them stops the wall.
+ */
+class VideoWall : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit VideoWall(Media::VideoFanout* fanout, QObject* parent = nullptr);
+    ~VideoWall() override;
+
+    VideoWall(const VideoWall&) = delete;
+    VideoWall& operator=(const VideoWall&) = delete;
+
+    void start();
+    void stop();
+    [[nodiscard]] bool isActive() const noexcept { return m_active; }
+    [[nodiscard]] int tileCount() const noexcept { return static_cast<int>(m_tiles.size()); }
+
+signals:
+    void activeChanged(bool active);
+    // The first tile drew a new frame; startTime() of it in microseconds
+    void framePresented(qint64 presentationTimeUs);
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    // Rebuilds the tiles for the screens there are now
+    void layoutTiles();
+    void clearTiles();
+
+    QPointer<Media::VideoFanout> m_fanout;
+    std::vector<VideoRenderWidget*> m_tiles; // Owned, top-level
+    bool m_active;
+};
+
+} // namespace DarkPlay::UI
+
+#endif // DARKPLAY_UI_VIDEOWALL_H
@@ -0,0 +1,57 @@
+#ifndef DARKPLAY_UTILS_ALLOCATIONCOUNTER_H
+#define DARKPLAY_UTILS_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace DarkPlay::Utils {
+
+/**
+ * @brief Counts heap allocations made inside marked hot paths
+ *
+ * Built only with DARKPLAY_COUNT_ALLOCATIONS, since AllocationCounter.cpp then
+ * replaces the global operator new and every allocation in the process, Qt's
+ * and plugins' included, goes through it. Only those made on a thread while a
+ * Scope is open are counted; everywhere else the replacement costs one
+ * thread-local read on top of malloc(). A code path that should never allocate
+ * opens a Scope and total() must stay flat across it. Without the option Scope
+ * and total() are inline no-ops.
+ */
+class AllocationCounter
+{
+public:
+    class Scope
+    {
+    public:
+#ifdef DARKPLAY_COUNT_ALLOCATIONS
+        Scope() noexcept;
+        ~Scope();
+#else
+        Scope() noexcept {}
+#endif
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    [[nodiscard]] static constexpr bool isEnabled() noexcept
+    {
+#ifdef DARKPLAY_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Allocations counted so far, inside any scope on any thread
+#ifdef DARKPLAY_COUNT_ALLOCATIONS
+    [[nodiscard]] static std::uint64_t total() noexcept;
+#else
+    [[nodiscard]] static std::uint64_t total() noexcept { return 0; }
+#endif
+
+    AllocationCounter() = delete;
+};
+
+} // namespace DarkPlay::Utils
+
+#endif // DARKPLAY_UTILS_ALLOCATIONCOUNTER_H
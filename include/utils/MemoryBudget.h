@@ -0,0 +1,127 @@
+#ifndef DARKPLAY_UTILS_MEMORYBUDGET_H
+#define DARKPLAY_UTILS_MEMORYBUDGET_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace DarkPlay::Utils {
+
+/**
+ * @brief A cache whose memory counts against the MemoryBudget
+ *
+ * The budget calls these from the GUI thread, so implementations guard them
+ * like any other cross-thread access. They must never call back into the
+ * budget while holding their own lock.
+ */
+class MemoryConsumer
+{
+public:
+    virtual ~MemoryConsumer() = default;
+
+    // Current estimate; cheap, it is read on every check
+    [[nodiscard]] virtual qint64 memoryBytes() const = 0;
+    // MemoryBudget::nowMs() of the least recently used entry that may go, -1 if none may
+    [[nodiscard]] virtual qint64 oldestUseMs() const = 0;
+    // Drops least recently used entries until bytes are freed or nothing more may go
+    virtual qint64 evict(qint64 bytes) = 0;
+};
+
+struct MemoryUsage {
+    QString name;
+    qint64 bytes{0};
+};
+
+struct MemoryStats {
+    qint64 limitBytes{0};
+    qint64 totalBytes{0};
+    qint64 evictedBytes{0}; // This session
+    bool underPressure{false};
+    bool lowMemoryMode{false};
+    QList<MemoryUsage> consumers; // Consumers with the same name are summed
+};
+
+/**
+ * @brief One byte limit for every cache in the process
+ *
+ * Registered caches are checked every few seconds and whenever one asks for
+ * it. Above the limit, the cache holding the least recently used entry gives
+ * up a slice at a time, which evicts by LRU across all of them. The limit
+ * halves while the OS reports memory pressure (PSI and MemAvailable on Linux,
+ * dispatch memory-pressure events on macOS, the memory load on Windows).
+ * Low-memory mode is decided before startup and shrinks the limit and the
+ * queues that feed the decoders.
+ */
+class MemoryBudget : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Owned by the application object, created on first call from the GUI thread
+    [[nodiscard]] static MemoryBudget* instance();
+
+    // --low-memory or memory/lowMemoryMode; set in main() before anything reads it
+    static void setLowMemoryMode(bool enabled) noexcept;
+    [[nodiscard]] static bool isLowMemoryMode() noexcept;
+
+    // Wall-clock milliseconds, the clock every oldestUseMs() is on
+    [[nodiscard]] static qint64 nowMs();
+
+    // Any thread; unregister before the consumer is destroyed
+    void registerConsumer(const QString& name, MemoryConsumer* consumer);
+    void unregisterConsumer(MemoryConsumer* consumer);
+
+    // 0 picks a share of physical memory
+    void setLimit(qint64 bytes);
+    [[nodiscard]] qint64 limit() const noexcept { return m_limit.load(std::memory_order_relaxed); }
+
+    // Any thread: a consumer grew, check soon. Calls made before the check runs coalesce
+    void requestCheck();
+
+    [[nodiscard]] MemoryStats stats() const;
+    [[nodiscard]] bool isUnderPressure() const noexcept { return m_underPressure; }
+
+signals:
+    void pressureChanged(bool underPressure);
+
+private:
+    explicit MemoryBudget(QObject* parent = nullptr);
+    ~MemoryBudget() override;
+
+    struct Consumer {
+        QString name;
+        MemoryConsumer* consumer;
+    };
+
+    void check();
+    void pollPressure();
+    void setUnderPressure(bool underPressure);
+    void enforceLocked(qint64 target);
+    void setupPressureNotifications();
+
+    [[nodiscard]] static qint64 physicalMemoryBytes();
+    [[nodiscard]] static qint64 defaultLimit(qint64 physicalBytes);
+
+    static constexpr int CHECK_INTERVAL_MS = 5000;
+    static constexpr qint64 EVICT_SLICE_BYTES = 1024 * 1024;
+
+    mutable std::mutex m_mutex; // Guards m_consumers; held while consumers are called
+    std::vector<Consumer> m_consumers;
+    std::atomic<qint64> m_limit;
+    std::atomic<bool> m_checkPending;
+    qint64 m_evictedBytes;
+    bool m_underPressure;
+
+    QTimer m_checkTimer;
+    void* m_pressureSource; // dispatch_source_t on macOS
+
+    static std::atomic<bool> s_lowMemoryMode;
+};
+
+} // namespace DarkPlay::Utils
+
+#endif // DARKPLAY_UTILS_MEMORYBUDGET_H
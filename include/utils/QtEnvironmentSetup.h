@@ -15,9 +15,12 @@ namespace DarkPlay::Utils {
  * Variables are only set if they haven't been defined externally,
  * allowing users to override settings when necessary.
  *
+ * @param hardwareAcceleration Desktop OpenGL and the probed hardware decode
+ *        APIs when true, software rendering and decoding otherwise
+ *
  * @note Must be called BEFORE creating QApplication
  */
-void setupOptimalQtEnvironment();
+void setupOptimalQtEnvironment(bool hardwareAcceleration = true);
 
 /**
  * @brief Outputs current Qt environment settings to log for debugging
@@ -0,0 +1,78 @@
+#ifndef DARKPLAY_UTILS_SEQLOCK_H
+#define DARKPLAY_UTILS_SEQLOCK_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace DarkPlay::Utils {
+
+/**
+ * @brief Single-writer value that any thread reads without locking
+ *
+ * store() never blocks, so it is safe on a real-time audio callback; load()
+ * retries a few times while a store is in flight and then gives up rather
+ * than spin. The value is kept in atomic words, so torn reads are detected,
+ * never undefined.
+ */
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock copies the value word by word");
+
+public:
+    SeqLock() noexcept { store(T{}); }
+    explicit SeqLock(const T& value) noexcept { store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer thread only
+    void store(const T& value) noexcept
+    {
+        std::array<std::uint64_t, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // False if every attempt overlapped a store; value is left alone then
+    bool load(T& value) const noexcept
+    {
+        for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
+            const std::uint64_t sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            std::array<std::uint64_t, WORDS> words{};
+            for (size_t i = 0; i < WORDS; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+                std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    static constexpr int MAX_ATTEMPTS = 4;
+
+    std::atomic<std::uint64_t> m_sequence{0};
+    std::array<std::atomic<std::uint64_t>, WORDS> m_words{};
+};
+
+} // namespace DarkPlay::Utils
+
+#endif // DARKPLAY_UTILS_SEQLOCK_H
@@ -0,0 +1,124 @@
+#ifndef DARKPLAY_UTILS_SPSCRINGBUFFER_H
+#define DARKPLAY_UTILS_SPSCRINGBUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace DarkPlay::Utils {
+
+/**
+ * @brief Wait-free single-producer/single-consumer ring buffer
+ *
+ * Storage is allocated once by reserve(); afterwards write() (producer thread)
+ * and read()/discard() (consumer thread) never allocate or lock, so the
+ * consumer side is safe to use from a real-time audio callback.
+ */
+template<typename T>
+class SpscRingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRingBuffer stores raw samples");
+
+public:
+    SpscRingBuffer() = default;
+    explicit SpscRingBuffer(size_t minimumCapacity) { reserve(minimumCapacity); }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Not thread-safe - call while neither side is running
+    void reserve(size_t minimumCapacity)
+    {
+        size_t capacity = 1;
+        while (capacity < minimumCapacity) {
+            capacity <<= 1;
+        }
+        m_buffer.assign(capacity, T{});
+        m_mask = capacity - 1;
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        m_writeIndex.store(0, std::memory_order_relaxed);
+        m_readIndex.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return m_buffer.size(); }
+
+    // Either side may query; the answer is a lower bound for the caller's side
+    [[nodiscard]] size_t readAvailable() const noexcept
+    {
+        return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] size_t writeAvailable() const noexcept
+    {
+        return capacity() - (m_writeIndex.load(std::memory_order_relaxed) - m_readIndex.load(std::memory_order_acquire));
+    }
+
+    // Producer: returns the number of elements actually written
+    size_t write(const T* data, size_t count) noexcept
+    {
+        const size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        const size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+        count = std::min(count, capacity() - (writeIndex - readIndex));
+        if (count == 0) {
+            return 0;
+        }
+
+        const size_t offset = writeIndex & m_mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(m_buffer.data() + offset, data, first * sizeof(T));
+        std::memcpy(m_buffer.data(), data + first, (count - first) * sizeof(T));
+
+        m_writeIndex.store(writeIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: returns the number of elements actually read
+    size_t read(T* data, size_t count) noexcept
+    {
+        const size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+        count = std::min(count, writeIndex - readIndex);
+        if (count == 0) {
+            return 0;
+        }
+
+        const size_t offset = readIndex & m_mask;
+        const size_t first = std::min(count, capacity() - offset);
+        std::memcpy(data, m_buffer.data() + offset, first * sizeof(T));
+        std::memcpy(data + first, m_buffer.data(), (count - first) * sizeof(T));
+
+        m_readIndex.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: drop up to count elements without copying them
+    size_t discard(size_t count) noexcept
+    {
+        const size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        const size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+        count = std::min(count, writeIndex - readIndex);
+        m_readIndex.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<T> m_buffer;
+    size_t m_mask{0};
+
+    // Separate cache lines so producer and consumer don't false-share
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_writeIndex{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_readIndex{0};
+};
+
+} // namespace DarkPlay::Utils
+
+#endif // DARKPLAY_UTILS_SPSCRINGBUFFER_H
@@ -0,0 +1,70 @@
+#ifndef DARKPLAY_UTILS_TRACE_H
+#define DARKPLAY_UTILS_TRACE_H
+
+#include <QString>
+#include <QtGlobal>
+
+namespace DarkPlay::Utils {
+
+/**
+ * @brief Timed spans and instant events, dumped as a Chrome trace
+ *
+ * Built only with DARKPLAY_ENABLE_TRACING; otherwise the DARKPLAY_TRACE_*
+ * macros expand to nothing and dump() just reports that. Each thread records
+ * into its own fixed ring buffer without locking or allocating, so only the
+ * most recent events per thread survive. Names and categories must be string
+ * literals: only the pointers are kept. dump() writes JSON that
+ * chrome://tracing and ui.perfetto.dev open.
+ */
+class Trace
+{
+public:
+    class Span
+    {
+    public:
+        Span(const char* category, const char* name) noexcept;
+        ~Span();
+
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* m_category;
+        const char* m_name;
+        qint64 m_startNs;
+    };
+
+    // A point on the timeline carrying one number, e.g. a state or a frame time
+    static void instant(const char* category, const char* name, qint64 value) noexcept;
+
+    [[nodiscard]] static constexpr bool isEnabled() noexcept
+    {
+#ifdef DARKPLAY_ENABLE_TRACING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Every thread's buffered events so far; false if tracing is not built in or the file failed
+    static bool dump(const QString& path);
+
+    Trace() = delete;
+};
+
+} // namespace DarkPlay::Utils
+
+#ifdef DARKPLAY_ENABLE_TRACING
+#define DARKPLAY_TRACE_CONCAT_IMPL(a, b) a##b
+#define DARKPLAY_TRACE_CONCAT(a, b) DARKPLAY_TRACE_CONCAT_IMPL(a, b)
+// Times the rest of the enclosing block
+#define DARKPLAY_TRACE_SCOPE(category, name) \
+    const ::DarkPlay::Utils::Trace::Span DARKPLAY_TRACE_CONCAT(darkplayTraceSpan, __LINE__)(category, name)
+#define DARKPLAY_TRACE_INSTANT(category, name, value) \
+    ::DarkPlay::Utils::Trace::instant(category, name, static_cast<qint64>(value))
+#else
+#define DARKPLAY_TRACE_SCOPE(category, name) static_cast<void>(0)
+#define DARKPLAY_TRACE_INSTANT(category, name, value) static_cast<void>(0)
+#endif
+
+#endif // DARKPLAY_UTILS_TRACE_H
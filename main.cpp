@@ -1,15 +1,134 @@
 #include <QApplication>
 #include "core/Application.h"
+#include "core/ConfigManager.h"
+#include "core/SingleInstance.h"
+#include "core/StartupProfiler.h"
+#include "controllers/MediaController.h"
+#include "controllers/RemoteControl.h"
+#include "media/ExportQueue.h"
+#include "media/HardwareDecoding.h"
 #include "ui/MainWindow.h"
+#include "utils/MemoryBudget.h"
 #include "utils/QtEnvironmentSetup.h"
+#include "utils/Trace.h"
+#include <QDir>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QPointer>
+#include <QTimer>
 #include <QDebug>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
 
+namespace {
+
+// --export: every job through one queue, progress on stderr; 0 once all of them succeeded
+int runExports(const DarkPlay::Controllers::RemoteControl::LaunchRequest& launch)
+{
+    using namespace DarkPlay;
+
+    Media::ExportQueue queue;
+    queue.setTranscoderFactory(&Controllers::MediaController::createTranscoder);
+    queue.setMaxJobs(launch.exportJobs > 0 ? launch.exportJobs
+                                           : Core::ConfigManager::storedValue("export/maxJobs", 0).toInt());
+
+    const int total = static_cast<int>(launch.exports.size());
+    QObject::connect(&queue, &Media::ExportQueue::jobProgress, [total](int id, const Media::ExportProgress& progress) {
+        const double percent = progress.totalMs > 0 ? 100.0 * progress.processedMs / progress.totalMs : 0.0;
+        std::fprintf(stderr, "[%d/%d] %5.1f%%  %6.1f fps  %5.2fx realtime  %lld KB\n", id, total, percent,
+                     progress.fps, progress.realtimeFactor, static_cast<long long>(progress.bytesWritten / 1024));
+    });
+    QObject::connect(&queue, &Media::ExportQueue::jobFinished,
+                     [&queue, total](int id, Media::ExportState state, const QString& error) {
+        for (const Media::ExportJobStatus& status : queue.jobs()) {
+            if (status.id != id) {
+                continue;
+            }
+            const QByteArray output = QDir::toNativeSeparators(status.job.outputPath).toLocal8Bit();
+            if (state == Media::ExportState::Finished) {
+                std::fprintf(stderr, "[%d/%d] Wrote %s (%.2fx realtime)\n", id, total, output.constData(),
+                             status.progress.realtimeFactor);
+            } else {
+                std::fprintf(stderr, "[%d/%d] %s failed: %s\n", id, total, output.constData(),
+                             error.toLocal8Bit().constData());
+            }
+        }
+    });
+    QObject::connect(&queue, &Media::ExportQueue::idle, &QCoreApplication::quit);
+
+    for (Media::ExportJob job : launch.exports) {
+        QDir().mkpath(QFileInfo(job.outputPath).absolutePath());
+        job.hardwareEncoding = Media::HardwareDecoding::isEnabled();
+        queue.enqueue(job);
+    }
+    QCoreApplication::exec();
+
+    const QList<Media::ExportJobStatus> jobs = queue.jobs();
+    const bool ok = std::all_of(jobs.cbegin(), jobs.cend(), [](const Media::ExportJobStatus& status) {
+        return status.state == Media::ExportState::Finished;
+    });
+    return ok ? 0 : 1;
+}
+
+// Declared before the application, so the trace covers its teardown too
+struct TraceOnExit {
+    QString path;
+    ~TraceOnExit()
+    {
+        if (!path.isEmpty()) {
+            DarkPlay::Utils::Trace::dump(path);
+        }
+    }
+};
+
+} // namespace
+
 int main(int argc, char *argv[])
 {
+    // The names locate the config file, which is read before the application exists
+    DarkPlay::Core::Application::setApplicationMetadata();
+
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i) {
+        arguments.append(QString::fromLocal8Bit(argv[i]));
+    }
+    const auto launch = DarkPlay::Controllers::RemoteControl::parseArguments(arguments);
+    if (launch.helpRequested || !launch.message.isEmpty()) {
+        std::fputs(launch.message.toLocal8Bit().constData(), launch.helpRequested ? stdout : stderr);
+        return launch.helpRequested ? 0 : 1;
+    }
+
+    // Exports run in this process and need no display
+    const bool headlessExport = !launch.exports.isEmpty();
+    if (headlessExport && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    // Hand the files to a running player and leave before any of the heavy startup work;
+    // a trace is of this process, so it keeps the files
+    if (!launch.newInstance && !headlessExport && launch.traceFile.isEmpty()
+        && DarkPlay::Core::ConfigManager::storedValue("ui/singleInstance", true).toBool()) {
+        QList<QJsonObject> replies;
+        if (DarkPlay::Core::SingleInstance::forward(launch.requests, &replies)) {
+            for (const QJsonObject& reply : replies) {
+                if (!reply.value("ok").toBool()) {
+                    std::fprintf(stderr, "DarkPlay: %s\n", reply.value("error").toString().toLocal8Bit().constData());
+                }
+            }
+            return 0;
+        }
+    }
+
+    // Read by every cache and decoder queue as it is created, so it is settled first
+    DarkPlay::Utils::MemoryBudget::setLowMemoryMode(
+        launch.lowMemory || DarkPlay::Core::ConfigManager::storedValue("memory/lowMemoryMode", false).toBool());
+
     // Setup optimal Qt environment BEFORE creating QApplication
-    DarkPlay::Utils::setupOptimalQtEnvironment();
+    DarkPlay::Utils::setupOptimalQtEnvironment(
+        DarkPlay::Core::ConfigManager::storedValue("media/hardwareAcceleration", true).toBool());
+
+    const TraceOnExit trace{launch.traceFile};
 
     try {
         // Create application instance with RAII
@@ -23,15 +142,24 @@ int main(int argc, char *argv[])
         // Initialize core application systems with proper error handling
         if (!app.initialize()) {
             qCritical() << "Failed to initialize application";
+            if (headlessExport) {
+                return -1;
+            }
             QMessageBox::critical(nullptr, "Initialization Error",
                                 "Failed to initialize DarkPlay application.\n"
                                 "Please check the installation and try again.");
             return -1;
         }
 
+        // Plugins are loaded, so their encoders are available; no window is made
+        if (headlessExport) {
+            return runExports(launch);
+        }
+
         // Create the main window with exception safety
         std::unique_ptr<DarkPlay::UI::MainWindow> window;
         try {
+            DarkPlay::Core::StartupProfiler::ScopedPhase phase(app.startupProfiler(), "MainWindow");
             window = std::make_unique<DarkPlay::UI::MainWindow>();
             window->show();
         } catch (const std::exception& e) {
@@ -41,6 +169,31 @@ int main(int argc, char *argv[])
             return -2;
         }
 
+        // Later launches and scripts reach the window through the local socket
+        DarkPlay::Core::SingleInstance singleInstance;
+        QPointer<DarkPlay::Controllers::RemoteControl> remoteControl = window->remoteControl();
+        singleInstance.setHandler([remoteControl](const QJsonObject& request) {
+            return remoteControl ? remoteControl->execute(request)
+                                 : QJsonObject{{"ok", false}, {"error", "Player is shutting down"}};
+        });
+        singleInstance.listen();
+
+        // This launch's own files, once the window is up
+        QTimer::singleShot(0, &app, [remoteControl, requests = launch.requests]() {
+            for (const QJsonObject& request : requests) {
+                if (remoteControl) {
+                    remoteControl->execute(request);
+                }
+            }
+        });
+
+        // Report once the first event loop iteration has run, i.e. the window is up
+        QTimer::singleShot(0, &app, [&app]() {
+            if (auto* profiler = app.startupProfiler()) {
+                profiler->report();
+            }
+        });
+
         // Run application event loop
         const int result = QApplication::exec();
 
@@ -1,17 +1,57 @@
 #include "controllers/MediaController.h"
-#include "media/QtMediaEngine.h"
+#include "media/HardwareDecoding.h"
+#include "media/KeyframeIndex.h"
+#include "media/MediaLibrary.h"
+#include "media/MediaEngineRegistry.h"
 #include "media/MediaManager.h"
+#include "media/Playlist.h"
+#include "media/SubtitleService.h"
+#include "media/ThumbnailService.h"
+#include "core/Application.h"
+#include "core/ConfigManager.h"
+#include "core/PluginManager.h"
+#include "core/ResumePositionStore.h"
+#include "plugins/IPlugin.h"
+#ifdef DARKPLAY_HAS_QT_TRANSCODER
+#include "media/QtMediaTranscoder.h"
+#endif
 #include <QFileInfo>
 #include <QDebug>
+#include <QPointer>
 
 namespace DarkPlay::Controllers {
 
+namespace {
+
+constexpr int PLUGIN_ENGINE_PRIORITY = 10;
+
+} // namespace
+
 MediaController::MediaController(QObject* parent)
     : QObject(parent)
+    , m_videoFanout(std::make_unique<Media::VideoFanout>())
     , m_mediaManager(std::make_unique<Media::MediaManager>(this))
-{
+    , m_hardwareDecoding(true)
+    , m_thumbnailService(std::make_unique<Media::ThumbnailService>())
+    , m_subtitleService(std::make_unique<Media::SubtitleService>())
+    , m_library(std::make_unique<Media::MediaLibrary>())
+    , m_exportQueue(std::make_unique<Media::ExportQueue>())
+    , m_rememberPosition(false)
+    , m_resumeTargetMs(0)
+{
+    connectMemoryBudget();
     setupConnections();
     initializeDefaultEngine();
+    connectEnginePlugins();
+    connectAudioEffectPlugins();
+    connectResumePositions();
+    connectSeekMode();
+    connectSubtitles();
+    connectLibrary();
+    connectExport();
+
+    // Video waits for the active engine's audio clock, through gapless swaps too
+    m_videoFanout->setClock([manager = m_mediaManager.get()]() { return manager->clockReading(); });
 }
 
 MediaController::~MediaController() = default;
@@ -73,7 +113,8 @@ void MediaController::togglePlayPause()
 
 void MediaController::seek(qint64 position)
 {
-    m_mediaManager->setPosition(position);
+    m_resumeTargetMs = 0; // The user has moved on from the resume point
+    m_mediaManager->seekTo(position);
 }
 
 void MediaController::seekRelative(qint64 offset)
@@ -81,6 +122,34 @@ void MediaController::seekRelative(qint64 offset)
     m_mediaManager->seek(offset);
 }
 
+void MediaController::scrubTo(qint64 position)
+{
+    m_resumeTargetMs = 0;
+    m_mediaManager->scrubTo(position);
+}
+
+void MediaController::endScrub(qint64 position)
+{
+    m_resumeTargetMs = 0;
+    m_mediaManager->endScrub(position);
+}
+
+bool MediaController::stepFrame(int frames)
+{
+    m_resumeTargetMs = 0;
+    return m_mediaManager->stepFrame(frames);
+}
+
+void MediaController::setSeekMode(Media::SeekMode mode)
+{
+    m_mediaManager->setSeekMode(mode);
+}
+
+Media::SeekMode MediaController::seekMode() const
+{
+    return m_mediaManager->seekMode();
+}
+
 qint64 MediaController::position() const
 {
     return m_mediaManager->position();
@@ -196,6 +265,19 @@ void MediaController::onManagerStateChanged(Media::PlaybackState state)
 
 void MediaController::onManagerPositionChanged(qint64 position)
 {
+    // Only real progress counts - loading and stopping also report positions
+    if (m_rememberPosition && !m_resumeKey.isEmpty() && m_mediaManager->state() == Media::PlaybackState::Playing) {
+        if (m_resumeTargetMs > 0 && position + 1000 >= m_resumeTargetMs) {
+            m_resumeTargetMs = 0;
+        }
+        if (m_resumeTargetMs == 0) {
+            if (auto* store = resumePositionStore()) {
+                store->update(m_resumeKey, position, m_mediaManager->duration());
+            }
+        }
+    }
+
+    m_subtitleService->updatePosition(position);
     emit positionChanged(position);
 }
 
@@ -222,6 +304,30 @@ void MediaController::onManagerPlaybackRateChanged(qreal rate)
 void MediaController::onManagerMediaLoaded(const QString& url)
 {
     m_lastError.clear();
+
+    // Playlist entries may be plain paths rather than URLs
+    QUrl mediaUrl(url);
+    if (mediaUrl.scheme().isEmpty() || QFileInfo::exists(url)) {
+        mediaUrl = QUrl::fromLocalFile(url);
+    }
+    m_thumbnailService->setSource(mediaUrl);
+    m_subtitleService->setSource(mediaUrl);
+    if (mediaUrl.isLocalFile()) {
+        Media::KeyframeIndex::instance()->request(mediaUrl.toLocalFile());
+    }
+
+    m_resumeKey = mediaUrl.isLocalFile() ? mediaUrl.toLocalFile() : mediaUrl.toString();
+    m_resumeTargetMs = 0;
+    if (m_rememberPosition) {
+        if (auto* store = resumePositionStore()) {
+            m_resumeTargetMs = store->position(m_resumeKey);
+            if (m_resumeTargetMs > 0) {
+                qDebug() << "Resuming" << m_resumeKey << "at" << m_resumeTargetMs << "ms";
+                m_mediaManager->setPosition(m_resumeTargetMs);
+            }
+        }
+    }
+
     emit mediaInfoChanged();
     emit mediaOpened(url);
 }
@@ -256,35 +362,494 @@ void MediaController::setupConnections()
 
 void MediaController::initializeDefaultEngine()
 {
-    // Create and set up Qt Media Engine as the default engine
-    auto qtEngine = std::make_unique<Media::QtMediaEngine>();
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    if (configManager) {
+        m_hardwareDecoding = configManager->getValue("media/hardwareAcceleration", true).toBool();
+        connect(configManager, &Core::ConfigManager::configChanged,
+                this, &MediaController::onEngineSettingChanged);
+    }
 
-    if (qtEngine) {
-        m_mediaManager->setMediaEngine(std::move(qtEngine));
-        qDebug() << "MediaController initialized with Qt Media Engine";
-    } else {
-        qWarning() << "Failed to create Qt Media Engine";
+    if (!installEngine(preferredEngineId(), m_hardwareDecoding)) {
+        qWarning() << "Failed to create a media engine";
     }
+
+    // Queued: the engine reporting the failure must not be replaced inside its own signal
+    connect(m_mediaManager.get(), &Media::MediaManager::hardwareDecodingFailed,
+            this, &MediaController::onHardwareDecodingFailed, Qt::QueuedConnection);
 }
 
-void MediaController::setVideoSink(QVideoSink* sink)
+bool MediaController::installEngine(const QString& engineId, bool hardwareDecoding)
 {
-    if (m_mediaManager && m_mediaManager->mediaEngine()) {
-        // Check if the engine supports video output
-        if (auto* qtEngine = qobject_cast<Media::QtMediaEngine*>(m_mediaManager->mediaEngine())) {
-            qtEngine->setVideoSink(sink);
+    auto* registry = Media::MediaEngineRegistry::instance();
+    std::optional<Media::EngineDescriptor> descriptor = registry->select(engineId);
+    if (!descriptor) {
+        return false;
+    }
+
+    Media::EngineOptions options;
+    options.hardwareDecoding = hardwareDecoding;
+
+    std::unique_ptr<Media::IMediaEngine> engine = descriptor->create(options);
+    if (!engine && descriptor->id != QLatin1String(Media::MediaEngineRegistry::BUILTIN_ENGINE_ID)) {
+        qWarning() << "MediaController: Engine" << descriptor->id << "failed to start, using the built-in engine";
+        descriptor = registry->engine(Media::MediaEngineRegistry::BUILTIN_ENGINE_ID);
+        engine = descriptor ? descriptor->create(options) : nullptr;
+    }
+    if (!engine) {
+        return false;
+    }
+
+    m_mediaManager->setMediaEngine(std::move(engine));
+    // Same engine type is used for the warm pre-roll instance
+    m_mediaManager->setEngineFactory([id = descriptor->id, options]() -> std::unique_ptr<Media::IMediaEngine> {
+        return Media::MediaEngineRegistry::instance()->create(id, options);
+    });
+
+    m_engineId = descriptor->id;
+    m_engineOwner = descriptor->owner;
+    m_hardwareDecoding = hardwareDecoding;
+    qDebug() << "MediaController initialized with" << descriptor->displayName
+             << (hardwareDecoding ? "(hardware decoding allowed)" : "(software decoding)");
+    return true;
+}
+
+void MediaController::switchEngine(const QString& engineId, bool hardwareDecoding, bool resumePlayback)
+{
+    const QString url = m_mediaManager->currentMediaUrl();
+    const qint64 position = m_mediaManager->position();
+    const int volume = m_mediaManager->volume();
+    const bool muted = m_mediaManager->isMuted();
+    const qreal rate = m_mediaManager->playbackRate();
+
+    if (!installEngine(engineId, hardwareDecoding)) {
+        qWarning() << "MediaController: Cannot switch to engine" << engineId;
+        return;
+    }
+
+    m_mediaManager->setVolume(volume);
+    m_mediaManager->setMuted(muted);
+    m_mediaManager->setPlaybackRate(rate);
+
+    if (url.isEmpty() || !m_mediaManager->loadMedia(QUrl(url))) {
+        return;
+    }
+    if (position > 0) {
+        m_mediaManager->setPosition(position);
+    }
+    if (resumePlayback) {
+        m_mediaManager->play();
+    }
+}
+
+void MediaController::connectEnginePlugins()
+{
+    auto* app = Core::Application::instance();
+    Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr;
+    if (!pluginManager) {
+        return;
+    }
+
+    auto refresh = [this]() { refreshPluginEngines(); };
+    connect(pluginManager, &Core::PluginManager::pluginLoaded, this, refresh);
+    connect(pluginManager, &Core::PluginManager::pluginEnabled, this, refresh);
+    connect(pluginManager, &Core::PluginManager::pluginDisabled, this,
+            [this](const QString& name) { releasePluginEngines(name); });
+
+    // Direct: an engine from the plugin must be gone before its shutdown() runs
+    connect(pluginManager, &Core::PluginManager::pluginAboutToShutdown, this,
+            [this](const QString& name) { releasePluginEngines(name); }, Qt::DirectConnection);
+
+    refreshPluginEngines();
+}
+
+void MediaController::refreshPluginEngines()
+{
+    auto* app = Core::Application::instance();
+    Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr;
+    if (!pluginManager) {
+        return;
+    }
+
+    auto* registry = Media::MediaEngineRegistry::instance();
+    for (auto* plugin : pluginManager->getPluginsOfType<Plugins::IMediaCodecPlugin>()) {
+        const QPointer<Plugins::IMediaCodecPlugin> guard(plugin);
+        for (const QString& id : plugin->mediaEngineIds()) {
+            if (registry->engine(id)) {
+                continue;
+            }
+            // Plugin engines own their decoder setup, so they take the option per instance
+            registry->registerEngine(Media::EngineDescriptor{
+                id, plugin->mediaEngineName(id), plugin->name(), PLUGIN_ENGINE_PRIORITY, true,
+                [guard, id](const Media::EngineOptions& options) -> std::unique_ptr<Media::IMediaEngine> {
+                    return std::unique_ptr<Media::IMediaEngine>(
+                        guard ? guard->createMediaEngine(id, options.hardwareDecoding) : nullptr);
+                }});
         }
     }
+
+    // The configured engine may only just have become available; switch while idle
+    const QString preferred = preferredEngineId();
+    if (preferred != m_engineId && registry->engine(preferred) && m_mediaManager->currentMediaUrl().isEmpty()) {
+        switchEngine(preferred, m_hardwareDecoding, false);
+    }
 }
 
-QVideoSink* MediaController::videoSink() const
+void MediaController::releasePluginEngines(const QString& pluginName)
+{
+    Media::MediaEngineRegistry::instance()->unregisterOwner(pluginName);
+
+    if (!m_engineOwner.isEmpty() && m_engineOwner == pluginName) {
+        const Media::PlaybackState state = m_mediaManager->state();
+        switchEngine(Media::MediaEngineRegistry::BUILTIN_ENGINE_ID, m_hardwareDecoding,
+                     state == Media::PlaybackState::Playing || state == Media::PlaybackState::Buffering);
+        // The plugin's engines are deleted on the engine thread; the library must outlive that
+        m_mediaManager->waitForEngine();
+    }
+}
+
+void MediaController::onHardwareDecodingFailed(const QString& reason)
+{
+    const QString url = m_mediaManager->currentMediaUrl();
+    if (!m_hardwareDecoding || url.isEmpty() || url == m_softwareFallbackUrl) {
+        return; // Software already failed too: the error stands
+    }
+    m_softwareFallbackUrl = url;
+
+    // Cheapest first: an engine that can switch in place
+    m_mediaManager->setHardwareDecoding(false, [this, url, reason](bool applied) {
+        if (m_mediaManager->currentMediaUrl() != url) {
+            return; // Something else was opened meanwhile
+        }
+        if (!applied) {
+            fallBackToSoftwareEngine(reason);
+            return;
+        }
+        qDebug() << "MediaController: Hardware decoding failed (" << reason << "), retrying in software";
+        m_hardwareDecoding = false;
+        const qint64 position = m_mediaManager->position();
+        if (m_mediaManager->loadMedia(QUrl(url))) {
+            m_mediaManager->setPosition(position);
+            m_mediaManager->play();
+        }
+    });
+}
+
+void MediaController::fallBackToSoftwareEngine(const QString& reason)
+{
+    // An engine that can be created without hardware decoding, this one preferred
+    auto* registry = Media::MediaEngineRegistry::instance();
+    std::optional<Media::EngineDescriptor> fallback = registry->engine(m_engineId);
+    if (!fallback || !fallback->perInstanceHardwareDecoding) {
+        fallback.reset();
+        for (const Media::EngineDescriptor& descriptor : registry->engines()) {
+            if (descriptor.perInstanceHardwareDecoding) {
+                fallback = descriptor;
+                break;
+            }
+        }
+    }
+
+    if (!fallback) {
+        qWarning() << "MediaController: Hardware decoding failed (" << reason
+                   << ") and no engine can switch to software without a restart";
+        return;
+    }
+
+    qDebug() << "MediaController: Hardware decoding failed (" << reason << "), retrying with"
+             << fallback->id << "in software";
+    switchEngine(fallback->id, false, true);
+}
+
+void MediaController::onEngineSettingChanged(const QString& key, const QVariant& value)
 {
-    if (m_mediaManager && m_mediaManager->mediaEngine()) {
-        if (auto* qtEngine = qobject_cast<Media::QtMediaEngine*>(m_mediaManager->mediaEngine())) {
-            return qtEngine->videoSink();
+    if (key == "media/defaultEngine") {
+        const Media::PlaybackState state = m_mediaManager->state();
+        if (value.toString() != m_engineId && Media::MediaEngineRegistry::instance()->engine(value.toString())) {
+            switchEngine(value.toString(), m_hardwareDecoding,
+                         state == Media::PlaybackState::Playing || state == Media::PlaybackState::Buffering);
+        }
+    } else if (key == "media/hardwareAcceleration") {
+        const bool enabled = value.toBool();
+        if (enabled == m_hardwareDecoding) {
+            return;
         }
+        m_softwareFallbackUrl.clear();
+
+        m_mediaManager->setHardwareDecoding(enabled, [this, enabled](bool applied) {
+            const auto descriptor = Media::MediaEngineRegistry::instance()->engine(m_engineId);
+            if (applied) {
+                m_hardwareDecoding = enabled;
+            } else if (descriptor && descriptor->perInstanceHardwareDecoding) {
+                const Media::PlaybackState state = m_mediaManager->state();
+                switchEngine(m_engineId, enabled,
+                             state == Media::PlaybackState::Playing || state == Media::PlaybackState::Buffering);
+            } else {
+                qDebug() << "MediaController: Hardware decoding change for" << m_engineId << "applies after a restart";
+            }
+        });
+    }
+}
+
+QString MediaController::preferredEngineId() const
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    return configManager ? configManager->getValue("media/defaultEngine", "qt").toString()
+                         : QString(Media::MediaEngineRegistry::BUILTIN_ENGINE_ID);
+}
+
+void MediaController::connectAudioEffectPlugins()
+{
+    auto* app = Core::Application::instance();
+    Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr;
+    if (!pluginManager) {
+        return;
+    }
+
+    auto refresh = [this]() { refreshAudioEffects(); };
+    connect(pluginManager, &Core::PluginManager::pluginLoaded, this, refresh);
+    connect(pluginManager, &Core::PluginManager::pluginEnabled, this, refresh);
+    connect(pluginManager, &Core::PluginManager::pluginDisabled, this, refresh);
+    connect(pluginManager, &Core::PluginManager::pluginUnloaded, this, refresh);
+
+    // Direct: the DSP thread must drop the plugin before its shutdown() runs
+    connect(pluginManager, &Core::PluginManager::pluginAboutToShutdown, this,
+            [this](const QString& name) { refreshAudioEffects(name); }, Qt::DirectConnection);
+
+    refreshAudioEffects();
+}
+
+void MediaController::connectResumePositions()
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    if (!configManager) {
+        return;
+    }
+
+    m_rememberPosition = configManager->getValue("playback/rememberPosition", true).toBool();
+    connect(configManager, &Core::ConfigManager::configChanged, this,
+            [this](const QString& key, const QVariant& value) {
+                if (key == "playback/rememberPosition") {
+                    m_rememberPosition = value.toBool();
+                }
+            });
+}
+
+void MediaController::connectSeekMode()
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    if (!configManager) {
+        return;
+    }
+
+    auto apply = [this](const QVariant& value) {
+        setSeekMode(value.toString() == "fast" ? Media::SeekMode::Fast : Media::SeekMode::Exact);
+    };
+    apply(configManager->getValue("playback/seekMode", "exact"));
+    connect(configManager, &Core::ConfigManager::configChanged, this,
+            [apply](const QString& key, const QVariant& value) {
+                if (key == "playback/seekMode") {
+                    apply(value);
+                }
+            });
+}
+
+void MediaController::connectSubtitles()
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    if (!configManager) {
+        return;
+    }
+
+    m_subtitleService->setAutoLoad(configManager->getValue("media/subtitleAutoLoad", true).toBool());
+    connect(configManager, &Core::ConfigManager::configChanged, this,
+            [this](const QString& key, const QVariant& value) {
+                if (key == "media/subtitleAutoLoad") {
+                    m_subtitleService->setAutoLoad(value.toBool());
+                }
+            });
+}
+
+void MediaController::connectLibrary()
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    if (!configManager) {
+        return;
     }
-    return nullptr;
+
+    m_library->setFolders(configManager->getValue("library/folders", QStringList()).toStringList());
+    connect(configManager, &Core::ConfigManager::configChanged, this,
+            [this](const QString& key, const QVariant& value) {
+                if (key == "library/folders") {
+                    m_library->setFolders(value.toStringList());
+                }
+            });
+}
+
+void MediaController::connectMemoryBudget()
+{
+    auto* app = Core::Application::instance();
+    Core::ConfigManager* configManager = app ? app->configManager() : nullptr;
+    auto* budget = Utils::MemoryBudget::instance();
+    if (!configManager || !budget) {
+        return;
+    }
+
+    // 0 MB: a share of physical memory, smaller in low-memory mode
+    constexpr qint64 MB = 1024 * 1024;
+    budget->setLimit(configManager->getValue("memory/budgetMB", 0).toLongLong() * MB);
+    connect(configManager, &Core::ConfigManager::configChanged, this,
+            [budget](const QString& key, const QVariant& value) {
+                if (key == "memory/budgetMB") {
+                    budget->setLimit(value.toLongLong() * MB);
+                }
+            });
+}
+
+void MediaController::connectExport()
+{
+    m_exportQueue->setTranscoderFactory(&MediaController::createTranscoder);
+
+    auto* app = Core::Application::instance();
+    if (Core::ConfigManager* configManager = app ? app->configManager() : nullptr) {
+        // 0: a share of the cores, one in low-memory mode
+        m_exportQueue->setMaxJobs(configManager->getValue("export/maxJobs", 0).toInt());
+        connect(configManager, &Core::ConfigManager::configChanged, this,
+                [this](const QString& key, const QVariant& value) {
+                    if (key == "export/maxJobs") {
+                        m_exportQueue->setMaxJobs(value.toInt());
+                    }
+                });
+    }
+
+    // Direct: a plugin's transcoders must be gone before its shutdown() runs
+    if (Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr) {
+        auto release = [this](const QString& name) { m_exportQueue->cancelOwner(name); };
+        connect(pluginManager, &Core::PluginManager::pluginDisabled, this, release);
+        connect(pluginManager, &Core::PluginManager::pluginAboutToShutdown, this, release, Qt::DirectConnection);
+    }
+}
+
+int MediaController::exportRange(const QUrl& source, const QString& outputPath, qint64 startMs, qint64 endMs)
+{
+    Media::ExportJob job;
+    job.source = source;
+    job.outputPath = outputPath;
+    job.startMs = startMs;
+    job.endMs = endMs;
+    job.hardwareEncoding = Media::HardwareDecoding::isEnabled();
+    return m_exportQueue->enqueue(job);
+}
+
+QList<int> MediaController::exportPlaylist(const QString& directory, const QString& format)
+{
+    // Outputs of jobs still to run count as taken, so two exports never share a name
+    QStringList taken;
+    for (const Media::ExportJobStatus& status : m_exportQueue->jobs()) {
+        if (status.state == Media::ExportState::Queued || status.state == Media::ExportState::Running) {
+            taken.append(status.job.outputPath);
+        }
+    }
+
+    const QString container = format.isEmpty() ? QString::fromLatin1(Media::ExportQueue::DEFAULT_FORMAT) : format;
+    const Media::Playlist* playlist = m_mediaManager->playlist();
+    QList<int> ids;
+    for (int row = 0; row < playlist->count(); ++row) {
+        const QUrl source(playlist->urlAt(row));
+        const QString outputPath = Media::ExportQueue::outputPathFor(source, directory, container, taken);
+        taken.append(outputPath);
+        ids.append(exportRange(source, outputPath));
+    }
+    return ids;
+}
+
+Media::TranscoderInstance MediaController::createTranscoder(const Media::ExportJob& job)
+{
+    auto* app = Core::Application::instance();
+    if (Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr) {
+        for (auto* plugin : pluginManager->getPluginsOfType<Plugins::IMediaCodecPlugin>()) {
+            if (!plugin->isEnabled() || !plugin->canEncode(job.format)) {
+                continue;
+            }
+            if (auto* transcoder = plugin->createTranscoder(job.format, job.hardwareEncoding)) {
+                return {std::unique_ptr<Media::IMediaTranscoder>(transcoder), plugin->name()};
+            }
+        }
+    }
+
+#ifdef DARKPLAY_HAS_QT_TRANSCODER
+    if (Media::QtMediaTranscoder::fileFormat(job.format) != QMediaFormat::UnspecifiedFormat) {
+        return {std::make_unique<Media::QtMediaTranscoder>(), QString()};
+    }
+#endif
+    return {};
+}
+
+Core::ResumePositionStore* MediaController::resumePositionStore() const
+{
+    auto* app = Core::Application::instance();
+    return app ? app->resumePositionStore() : nullptr;
+}
+
+void MediaController::refreshAudioEffects(const QString& excludedPlugin)
+{
+    auto* app = Core::Application::instance();
+    Core::PluginManager* pluginManager = app ? app->pluginManager() : nullptr;
+    if (!pluginManager || !m_mediaManager) {
+        return;
+    }
+
+    QList<Plugins::IAudioEffectPlugin*> effects;
+    for (auto* effect : pluginManager->getPluginsOfType<Plugins::IAudioEffectPlugin>()) {
+        if (effect->name() != excludedPlugin) {
+            effects.append(effect);
+        }
+    }
+
+    m_mediaManager->setAudioEffects(effects);
+    if (!excludedPlugin.isEmpty()) {
+        // The engine thread must have let go of the plugin before it shuts down
+        m_mediaManager->waitForEngine();
+    }
+}
+
+void MediaController::setVideoSink(QVideoSink* sink)
+{
+    if (m_mediaManager) {
+        // Engines without video output ignore the sink
+        m_mediaManager->setVideoSink(sink);
+    }
+}
+
+QVideoSink* MediaController::videoSink() const
+{
+    return m_mediaManager ? m_mediaManager->videoSink() : nullptr;
+}
+
+Media::FrameStats MediaController::frameStats() const
+{
+    return m_mediaManager->frameStats();
+}
+
+Media::StreamingStats MediaController::streamingStats() const
+{
+    return m_mediaManager->streamingStats();
+}
+
+Utils::MemoryStats MediaController::memoryStats() const
+{
+    const auto* budget = Utils::MemoryBudget::instance();
+    return budget ? budget->stats() : Utils::MemoryStats{};
+}
+
+void MediaController::reportFramePresented(qint64 presentationTimeUs)
+{
+    m_mediaManager->reportFramePresented(presentationTimeUs);
 }
 
 } // namespace DarkPlay::Controllers
@@ -0,0 +1,479 @@
+#include "controllers/RemoteControl.h"
+#include "controllers/MediaController.h"
+#include "core/Application.h"
+#include "core/ConfigManager.h"
+#include "media/ExportQueue.h"
+#include "media/Playlist.h"
+#include "utils/Trace.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QUrl>
+
+namespace DarkPlay::Controllers {
+
+namespace {
+
+QJsonObject failure(const QString& error)
+{
+    return QJsonObject{{"ok", false}, {"error", error}};
+}
+
+QString stateName(Media::PlaybackState state)
+{
+    switch (state) {
+    case Media::PlaybackState::Playing:   return QStringLiteral("playing");
+    case Media::PlaybackState::Paused:    return QStringLiteral("paused");
+    case Media::PlaybackState::Buffering: return QStringLiteral("buffering");
+    case Media::PlaybackState::Error:     return QStringLiteral("error");
+    case Media::PlaybackState::Stopped:   break;
+    }
+    return QStringLiteral("stopped");
+}
+
+QString clockSourceName(Media::ClockSource source)
+{
+    switch (source) {
+    case Media::ClockSource::Audio:  return QStringLiteral("audio");
+    case Media::ClockSource::Engine: return QStringLiteral("engine");
+    case Media::ClockSource::None:   break;
+    }
+    return QStringLiteral("none");
+}
+
+// Milliseconds, or [hh:]mm:ss[.fff]; -1 if neither
+qint64 parseTime(const QString& text)
+{
+    bool ok = false;
+    const qint64 ms = text.toLongLong(&ok);
+    if (ok) {
+        return ms >= 0 ? ms : -1;
+    }
+
+    const QStringList parts = text.split(':');
+    if (parts.size() < 2 || parts.size() > 3) {
+        return -1;
+    }
+    const double seconds = parts.last().toDouble(&ok);
+    if (!ok || seconds < 0.0 || seconds >= 60.0) {
+        return -1;
+    }
+    qint64 minutes = 0;
+    for (int i = 0; i < parts.size() - 1; ++i) {
+        const int value = parts.at(i).toInt(&ok);
+        if (!ok || value < 0) {
+            return -1;
+        }
+        minutes = minutes * 60 + value;
+    }
+    return minutes * 60000 + static_cast<qint64>(seconds * 1000.0);
+}
+
+// Local files are sent as absolute paths, everything else as a URL
+QString launchLocation(const QString& argument)
+{
+    const QFileInfo info(argument);
+    if (info.exists()) {
+        return info.absoluteFilePath();
+    }
+    const QUrl url = QUrl::fromUserInput(argument, QDir::currentPath(), QUrl::AssumeLocalFile);
+    return url.isLocalFile() ? url.toLocalFile() : url.toString();
+}
+
+// "--name value" or "--name=value": true if the argument is the option, with i moved past its value
+bool takeOption(const QStringList& arguments, int& i, const QString& name, QString& value)
+{
+    const QString& argument = arguments.at(i);
+    if (argument.startsWith(name + '=')) {
+        value = argument.mid(name.size() + 1);
+        return true;
+    }
+    if (argument != name) {
+        return false;
+    }
+    value = i + 1 < arguments.size() ? arguments.at(++i) : QString();
+    return true;
+}
+
+constexpr const char* USAGE =
+    "Usage: DarkPlay [options] [files or URLs...]\n"
+    "\n"
+    "Options:\n"
+    "  --enqueue           Add the files to the playlist of the running player\n"
+    "  --seek <time>       Start at <time>, in milliseconds or [hh:]mm:ss\n"
+    "  --new-instance      Do not hand the files to a running player\n"
+    "  --low-memory        Smaller caches and decoder queues, for small devices\n"
+    "  --export <path>     Transcode the files without a window: into <path>, or into\n"
+    "                      the directory <path> when there are several\n"
+    "  --from <time>       Export from <time>, in milliseconds or [hh:]mm:ss\n"
+    "  --to <time>         Export up to <time>\n"
+    "  --format <ext>      Container for exports into a directory (default mp4)\n"
+    "  --jobs <n>          Files exported at once (default: from the core count)\n"
+    "  --speed <x>         Decode rate for exports without audio (default 1)\n"
+    "  --trace <file>      Write a Chrome trace of this process to <file> on exit\n"
+    "                      (builds with DARKPLAY_ENABLE_TRACING)\n"
+    "  -h, --help          Show this help\n";
+
+} // namespace
+
+RemoteControl::RemoteControl(MediaController* controller, QObject* parent)
+    : QObject(parent)
+    , m_controller(controller)
+{
+}
+
+RemoteControl::~RemoteControl() = default;
+
+QJsonObject RemoteControl::execute(const QJsonObject& request)
+{
+    const QString command = request.value("command").toString();
+    if (command == "ping") {
+        return {{"ok", true}};
+    }
+    if (command == "raise") {
+        emit activationRequested();
+        return {{"ok", true}};
+    }
+    if (!m_controller) {
+        return failure("Player is shutting down");
+    }
+
+    if (command == "open") {
+        return open(request);
+    }
+    if (command == "enqueue") {
+        return enqueue(request);
+    }
+    if (command == "status") {
+        return status();
+    }
+    if (command == "trace") {
+        const QString path = request.value("path").toString();
+        if (path.isEmpty()) {
+            return failure("trace needs a \"path\" to write to");
+        }
+        if (!Utils::Trace::isEnabled()) {
+            return failure("This build records no trace, see DARKPLAY_ENABLE_TRACING");
+        }
+        if (!Utils::Trace::dump(path)) {
+            return failure(QString("Could not write the trace to %1").arg(path));
+        }
+        return {{"ok", true}, {"path", path}};
+    }
+
+    if (command == "seek") {
+        const qint64 position = request.value("position").toInteger(-1);
+        if (position < 0) {
+            return failure("seek needs a non-negative \"position\" in milliseconds");
+        }
+        m_controller->seek(position);
+    } else if (command == "play") {
+        m_controller->play();
+    } else if (command == "pause") {
+        m_controller->pause();
+    } else if (command == "stop") {
+        m_controller->stop();
+    } else if (command == "toggle") {
+        m_controller->togglePlayPause();
+    } else if (command == "next") {
+        m_controller->mediaManager()->next();
+    } else if (command == "previous") {
+        m_controller->mediaManager()->previous();
+    } else if (command == "volume") {
+        if (!request.value("volume").isDouble()) {
+            return failure("volume needs a numeric \"volume\"");
+        }
+        m_controller->setVolume(qBound(0, request.value("volume").toInt(), 100));
+    } else if (command == "mute") {
+        m_controller->setMuted(request.value("muted").toBool(!m_controller->isMuted()));
+    } else if (command == "rate") {
+        // Any rate in range, not just the menu's steps
+        if (!request.value("rate").isDouble() || request.value("rate").toDouble() <= 0.0) {
+            return failure("rate needs a positive numeric \"rate\", 0.25 to 4");
+        }
+        m_controller->setPlaybackRate(request.value("rate").toDouble());
+    } else if (command == "step") {
+        if (!m_controller->stepFrame(request.value("frames").toInt(1))) {
+            return failure("Frame stepping is not available for the current media");
+        }
+    } else {
+        return failure(QString("Unknown command \"%1\"").arg(command));
+    }
+    return {{"ok", true}};
+}
+
+QJsonObject RemoteControl::open(const QJsonObject& request)
+{
+    const QString location = mediaLocation(request);
+    if (location.isEmpty()) {
+        return failure("open needs a \"path\" or \"url\"");
+    }
+
+    const QUrl url(location);
+    const bool opened = (url.scheme().isEmpty() || QFileInfo::exists(location))
+        ? m_controller->openFile(location)
+        : m_controller->openUrl(url);
+    if (!opened) {
+        return failure(m_controller->errorString());
+    }
+
+    // Same path as the resume position: the engine holds the seek until the media is loaded
+    const qint64 position = request.value("position").toInteger(-1);
+    if (position > 0) {
+        m_controller->seek(position);
+    }
+
+    bool autoPlay = true;
+    if (auto* app = Core::Application::instance()) {
+        if (auto* configManager = app->configManager()) {
+            autoPlay = configManager->value(Core::ConfigKeys::AutoPlay);
+        }
+    }
+    if (request.value("play").toBool(autoPlay)) {
+        m_controller->play();
+    }
+
+    emit mediaOpened(location);
+    return {{"ok", true}};
+}
+
+QJsonObject RemoteControl::enqueue(const QJsonObject& request)
+{
+    QStringList locations;
+    if (request.value("paths").isArray()) {
+        for (const QJsonValue& value : request.value("paths").toArray()) {
+            locations.append(value.toString());
+        }
+    } else {
+        locations.append(mediaLocation(request));
+    }
+    locations.removeAll(QString());
+    if (locations.isEmpty()) {
+        return failure("enqueue needs a \"path\", \"url\" or \"paths\"");
+    }
+
+    QStringList urls;
+    urls.reserve(locations.size());
+    for (const QString& location : locations) {
+        urls.append(QFileInfo::exists(location) ? QUrl::fromLocalFile(location).toString() : location);
+    }
+
+    auto* mediaManager = m_controller->mediaManager();
+    auto* playlist = mediaManager->playlist();
+    const int first = playlist->count();
+    playlist->append(urls);
+
+    // Nothing was playing: start with the first new entry
+    if (!m_controller->hasMedia()) {
+        mediaManager->setCurrentIndex(first);
+        m_controller->play();
+    }
+    return {{"ok", true}, {"count", playlist->count()}};
+}
+
+QJsonObject RemoteControl::status() const
+{
+    const auto* mediaManager = m_controller->mediaManager();
+
+    // Bytes per cache, for watching a long-running player from outside
+    const Utils::MemoryStats memory = m_controller->memoryStats();
+    QJsonObject consumers;
+    for (const Utils::MemoryUsage& usage : memory.consumers) {
+        consumers.insert(usage.name, usage.bytes);
+    }
+    const QJsonObject memoryObject{
+        {"limitBytes", memory.limitBytes},
+        {"totalBytes", memory.totalBytes},
+        {"evictedBytes", memory.evictedBytes},
+        {"underPressure", memory.underPressure},
+        {"lowMemoryMode", memory.lowMemoryMode},
+        {"consumers", consumers}
+    };
+
+    const Media::VideoFanoutStats fanout = m_controller->videoFanoutStats();
+    const QJsonObject videoObject{
+        {"outputs", fanout.outputs},
+        {"framesDistributed", static_cast<qint64>(fanout.framesDistributed)},
+        {"lastSkewUs", fanout.lastSkewUs},
+        {"maxSkewUs", fanout.maxSkewUs},
+        {"framesHeld", fanout.framesHeld},
+        {"framesDroppedLate", static_cast<qint64>(fanout.framesDroppedLate)}
+    };
+
+    const Media::ClockStats clock = m_controller->clockStats();
+    const QJsonObject clockObject{
+        {"source", clockSourceName(clock.source)},
+        {"rate", clock.rate},
+        {"positionUs", clock.positionUs},
+        {"driftUs", clock.driftUs},
+        {"maxDriftUs", clock.maxDriftUs}
+    };
+
+    return {
+        {"ok", true},
+        {"state", stateName(m_controller->state())},
+        {"url", m_controller->currentMediaUrl()},
+        {"positionMs", m_controller->position()},
+        {"durationMs", m_controller->duration()},
+        {"volume", m_controller->volume()},
+        {"muted", m_controller->isMuted()},
+        {"playbackRate", m_controller->playbackRate()},
+        {"playlistCount", mediaManager->playlist()->count()},
+        {"playlistIndex", mediaManager->currentIndex()},
+        {"engine", m_controller->engineId()},
+        {"memory", memoryObject},
+        {"video", videoObject},
+        {"clock", clockObject}
+    };
+}
+
+QString RemoteControl::mediaLocation(const QJsonObject& request)
+{
+    const QString path = request.value("path").toString();
+    return path.isEmpty() ? request.value("url").toString() : path;
+}
+
+RemoteControl::LaunchRequest RemoteControl::parseArguments(const QStringList& arguments)
+{
+    LaunchRequest launch;
+    QStringList locations;
+    bool enqueue = false;
+    qint64 seekMs = -1;
+    QString exportOutput;
+    QString exportFormat;
+    qint64 exportFromMs = 0;
+    qint64 exportToMs = -1;
+    qreal exportSpeed = 1.0;
+    QString value;
+
+    for (int i = 1; i < arguments.size(); ++i) {
+        const QString& argument = arguments.at(i);
+        if (argument == "-h" || argument == "--help") {
+            launch.helpRequested = true;
+            launch.message = QString::fromLatin1(USAGE);
+            return launch;
+        }
+        if (argument == "--enqueue") {
+            enqueue = true;
+        } else if (argument == "--new-instance") {
+            launch.newInstance = true;
+        } else if (argument == "--low-memory") {
+            launch.lowMemory = true;
+        } else if (takeOption(arguments, i, "--seek", value)) {
+            seekMs = parseTime(value);
+            if (seekMs < 0) {
+                launch.message = QString("Invalid --seek time \"%1\"\n\n%2").arg(value, QString::fromLatin1(USAGE));
+                return launch;
+            }
+        } else if (takeOption(arguments, i, "--export", value)) {
+            exportOutput = value;
+            if (exportOutput.isEmpty()) {
+                launch.message = QString("--export needs a path\n\n%1").arg(QString::fromLatin1(USAGE));
+                return launch;
+            }
+        } else if (takeOption(arguments, i, "--from", value) || takeOption(arguments, i, "--to", value)) {
+            const bool from = argument.startsWith("--from");
+            const qint64 ms = parseTime(value);
+            if (ms < 0) {
+                launch.message = QString("Invalid %1 time \"%2\"\n\n%3")
+                                     .arg(from ? "--from" : "--to", value, QString::fromLatin1(USAGE));
+                return launch;
+            }
+            if (from) {
+                exportFromMs = ms;
+            } else {
+                exportToMs = ms;
+            }
+        } else if (takeOption(arguments, i, "--format", value)) {
+            exportFormat = value.toLower();
+        } else if (takeOption(arguments, i, "--jobs", value)) {
+            launch.exportJobs = value.toInt();
+            if (launch.exportJobs <= 0) {
+                launch.message = QString("Invalid --jobs count \"%1\"\n\n%2").arg(value, QString::fromLatin1(USAGE));
+                return launch;
+            }
+        } else if (takeOption(arguments, i, "--speed", value)) {
+            bool ok = false;
+            exportSpeed = value.toDouble(&ok);
+            if (!ok || exportSpeed <= 0.0) {
+                launch.message = QString("Invalid --speed \"%1\"\n\n%2").arg(value, QString::fromLatin1(USAGE));
+                return launch;
+            }
+        } else if (takeOption(arguments, i, "--trace", value)) {
+            if (value.isEmpty() || !Utils::Trace::isEnabled()) {
+                launch.message = QString(value.isEmpty() ? "--trace needs a path\n\n%1"
+                                                         : "--trace needs a build with DARKPLAY_ENABLE_TRACING\n\n%1")
+                                     .arg(QString::fromLatin1(USAGE));
+                return launch;
+            }
+            launch.traceFile = QFileInfo(value).absoluteFilePath();
+        } else if (argument == "--") {
+            for (++i; i < arguments.size(); ++i) {
+                locations.append(launchLocation(arguments.at(i)));
+            }
+        } else if (argument.startsWith("--")) {
+            launch.message = QString("Unknown option \"%1\"\n\n%2").arg(argument, QString::fromLatin1(USAGE));
+            return launch;
+        } else {
+            locations.append(launchLocation(argument));
+        }
+    }
+
+    if (!exportOutput.isEmpty()) {
+        if (locations.isEmpty()) {
+            launch.message = QString("--export needs files or URLs to export\n\n%1").arg(QString::fromLatin1(USAGE));
+            return launch;
+        }
+        if (exportToMs >= 0 && exportToMs <= exportFromMs) {
+            launch.message = QString("--to must come after --from\n\n%1").arg(QString::fromLatin1(USAGE));
+            return launch;
+        }
+
+        // Several files, or an existing directory: one output each, named after the source
+        const QFileInfo output(exportOutput);
+        const bool intoDirectory = locations.size() > 1 || output.isDir() || exportOutput.endsWith('/');
+        QStringList taken;
+        for (const QString& location : std::as_const(locations)) {
+            Media::ExportJob job;
+            job.source = QFileInfo::exists(location) ? QUrl::fromLocalFile(location) : QUrl(location);
+            job.outputPath = intoDirectory
+                ? Media::ExportQueue::outputPathFor(job.source, output.absoluteFilePath(), exportFormat, taken)
+                : output.absoluteFilePath();
+            job.format = intoDirectory && exportFormat.isEmpty() ? QString::fromLatin1(Media::ExportQueue::DEFAULT_FORMAT)
+                                                                 : exportFormat;
+            job.startMs = exportFromMs;
+            job.endMs = exportToMs;
+            job.speed = exportSpeed;
+            taken.append(job.outputPath);
+            launch.exports.append(job);
+        }
+        return launch;
+    }
+
+    if (locations.isEmpty()) {
+        if (seekMs >= 0) {
+            launch.requests.append(QJsonObject{{"command", "seek"}, {"position", seekMs}});
+        }
+        launch.requests.append(QJsonObject{{"command", "raise"}});
+        return launch;
+    }
+
+    // The first file replaces whatever is playing unless asked to queue; the rest always queue
+    if (!enqueue) {
+        QJsonObject open{{"command", "open"}, {"path", locations.takeFirst()}};
+        if (seekMs >= 0) {
+            open.insert("position", seekMs);
+        }
+        launch.requests.append(open);
+    }
+    if (!locations.isEmpty()) {
+        launch.requests.append(QJsonObject{{"command", "enqueue"}, {"paths", QJsonArray::fromStringList(locations)}});
+    }
+    if (!enqueue) {
+        launch.requests.append(QJsonObject{{"command", "raise"}});
+    }
+    return launch;
+}
+
+} // namespace DarkPlay::Controllers
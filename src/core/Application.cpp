@@ -2,6 +2,8 @@
 #include "core/PluginManager.h"
 #include "core/ThemeManager.h"
 #include "core/ConfigManager.h"
+#include "core/ResumePositionStore.h"
+#include "core/StartupProfiler.h"
 #include <QDir>
 #include <QStandardPaths>
 #include <QDebug>
@@ -13,6 +15,7 @@ std::mutex Application::s_instanceMutex;
 
 Application::Application(int &argc, char **argv)
     : QApplication(argc, argv)
+    , m_startupProfiler(std::make_unique<StartupProfiler>())
 {
     // Thread-safe singleton initialization with double-checked locking
     {
@@ -25,10 +28,7 @@ Application::Application(int &argc, char **argv)
     }
 
     // Set application metadata
-    setApplicationName("DarkPlay");
-    setApplicationVersion("0.0.1");
-    setOrganizationName("DarkPlay");
-    setOrganizationDomain("darkheim.net");
+    setApplicationMetadata();
 
     // Connect signal with proper error handling
     connect(this, &QApplication::aboutToQuit, this, &Application::onAboutToQuit);
@@ -52,6 +52,14 @@ Application* Application::instance() noexcept
     return s_instance.load(std::memory_order_acquire);
 }
 
+void Application::setApplicationMetadata()
+{
+    QCoreApplication::setApplicationName("DarkPlay");
+    QCoreApplication::setApplicationVersion("0.0.1");
+    QCoreApplication::setOrganizationName("DarkPlay");
+    QCoreApplication::setOrganizationDomain("darkheim.net");
+}
+
 bool Application::initialize() noexcept
 {
     // Thread-safe initialization with double-checked locking
@@ -67,6 +75,8 @@ bool Application::initialize() noexcept
     }
 
     try {
+        StartupProfiler::ScopedPhase phase(m_startupProfiler.get(), "Application::initialize");
+
         initializeCore();
         validateCoreComponents();
         loadPlugins();
@@ -86,6 +96,8 @@ bool Application::initialize() noexcept
 
 void Application::initializeCore()
 {
+    StartupProfiler::ScopedPhase phase(m_startupProfiler.get(), "initializeCore");
+
     // Initialize configuration manager first - it's required by others
     m_configManager = std::make_unique<ConfigManager>(this);
     if (!m_configManager) {
@@ -98,6 +110,9 @@ void Application::initializeCore()
         throw std::runtime_error(QString("Failed to load config defaults: %1").arg(e.what()).toStdString());
     }
 
+    // Starts reading remembered positions in the background
+    m_resumePositionStore = std::make_unique<ResumePositionStore>(this);
+
     // Initialize theme manager with dependency injection
     m_themeManager = std::make_unique<ThemeManager>(this);
     if (!m_themeManager) {
@@ -106,7 +121,7 @@ void Application::initializeCore()
 
     // Load saved theme or default to dark - with error handling
     try {
-        QString savedTheme = m_configManager->getValue("ui/theme", "dark").toString();
+        QString savedTheme = m_configManager->value(ConfigKeys::Theme);
         m_themeManager->loadTheme(savedTheme);
     } catch (const std::exception& e) {
         qWarning() << "Failed to load theme, using default:" << e.what();
@@ -125,7 +140,7 @@ void Application::initializeCore()
                 // Use weak reference pattern for safety
                 if (auto* config = m_configManager.get()) {
                     try {
-                        config->setValue("ui/theme", themeName);
+                        config->setValue(ConfigKeys::Theme, themeName);
                     } catch (const std::exception& e) {
                         qWarning() << "Failed to save theme preference:" << e.what();
                     }
@@ -148,6 +163,8 @@ void Application::validateCoreComponents() const
 
 void Application::loadPlugins()
 {
+    StartupProfiler::ScopedPhase phase(m_startupProfiler.get(), "loadPlugins");
+
     validateCoreComponents();
 
     // Get plugins directory from config or use default
@@ -166,25 +183,22 @@ void Application::loadPlugins()
         QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/" + pluginsDir
     };
 
-    bool pluginsLoaded = false;
+    // Every location contributes; earlier ones win when two provide the same plugin
+    QStringList existingPaths;
     for (const QString& path : searchPaths) {
-        const QDir pluginDir(path);
-        if (pluginDir.exists()) {
-            try {
-                m_pluginManager->loadAllPlugins(path);
-                pluginsLoaded = true;
-                qDebug() << "Successfully loaded plugins from:" << path;
-                break;
-            } catch (const std::exception& e) {
-                qWarning() << "Failed to load plugins from" << path << ":" << e.what();
-                // Continue to next path
-            }
+        const QString canonicalPath = QDir(path).canonicalPath();
+        if (!canonicalPath.isEmpty() && !existingPaths.contains(canonicalPath)) {
+            existingPaths.append(canonicalPath);
         }
     }
 
-    if (!pluginsLoaded) {
+    if (existingPaths.isEmpty()) {
         qWarning() << "No plugins loaded from any search path";
+        return;
     }
+
+    m_pluginManager->loadAllPlugins(existingPaths);
+    qDebug() << "Loaded plugins from:" << existingPaths;
 }
 
 void Application::shutdown() noexcept
@@ -212,6 +226,10 @@ void Application::shutdown() noexcept
             }
         }
 
+        if (m_resumePositionStore) {
+            m_resumePositionStore->flush();
+        }
+
         if (m_configManager) {
             try {
                 m_configManager->sync();
@@ -223,6 +241,7 @@ void Application::shutdown() noexcept
         // Clear smart pointers in reverse order
         m_pluginManager.reset();
         m_themeManager.reset();
+        m_resumePositionStore.reset();
         m_configManager.reset();
 
         m_initialized.store(false, std::memory_order_release);
@@ -3,25 +3,33 @@
 #include <QJsonDocument>
 #include <QDir>
 #include <QDebug>
-#include <QReadLocker>
-#include <QWriteLocker>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+#include <optional>
 
 namespace DarkPlay::Core {
 
 ConfigManager::ConfigManager(QObject* parent)
     : QObject(parent)
 {
+    m_snapshot.store(std::make_shared<const Snapshot>(), std::memory_order_release);
+
+    m_ioPool.setMaxThreadCount(1); // Flushes reach QSettings in order
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_DELAY_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ConfigManager::flushPending);
+
     try {
         // Ensure config directory exists
-        const QString configPath = QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation);
+        const QString configFile = configFilePath();
+        const QString configPath = QFileInfo(configFile).absolutePath();
         const QDir configDir(configPath);
         
         if (!configDir.exists() && !configDir.mkpath(".")) {
             emitError(QString("Failed to create config directory: %1").arg(configPath));
             return;
         }
-
-        const QString configFile = configPath + "/DarkPlay.conf";
         
         // Create settings with error handling
         m_settings = std::make_unique<QSettings>(configFile, QSettings::IniFormat);
@@ -30,6 +38,16 @@ ConfigManager::ConfigManager(QObject* parent)
             emitError(QString("Failed to initialize settings file: %1").arg(configFile));
             return;
         }
+        m_fileName = m_settings->fileName();
+
+        // One pass over the file; every later read is served from memory
+        auto loaded = std::make_shared<Snapshot>();
+        const QStringList keys = m_settings->allKeys();
+        loaded->values.reserve(keys.size());
+        for (const QString& key : keys) {
+            loaded->values.insert(key, m_settings->value(key));
+        }
+        m_snapshot.store(std::move(loaded), std::memory_order_release);
 
         setupDefaults();
         m_initialized.store(true, std::memory_order_release);
@@ -41,20 +59,21 @@ ConfigManager::ConfigManager(QObject* parent)
     }
 }
 
+ConfigManager::~ConfigManager()
+{
+    sync();
+}
+
 QVariant ConfigManager::getValue(const QString& key, const QVariant& defaultValue) const
 {
     if (!isValidKey(key)) {
         return defaultValue;
     }
 
-    QReadLocker locker(&m_lock);
-    
-    if (!m_settings) {
-        return defaultValue;
-    }
-
     try {
-        return m_settings->value(key, defaultValue);
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        const auto it = current->values.constFind(groupPrefix(*current) + key);
+        return it == current->values.cend() ? defaultValue : *it;
     } catch (const std::exception& e) {
         emitError(QString("Error reading key '%1': %2").arg(key, e.what()));
         return defaultValue;
@@ -71,30 +90,8 @@ bool ConfigManager::setValue(const QString& key, const QVariant& value) noexcept
     }
 
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            emitError("Settings not initialized");
-            return false;
-        }
-
-        const QVariant oldValue = m_settings->value(key);
-
-        // Use strong exception safety - only commit if operation succeeds
-        m_settings->setValue(key, value);
-
-        // Ensure write is successful before emitting signal
-        if (m_settings->status() == QSettings::NoError) {
-            // Only emit if value actually changed
-            if (oldValue != value) {
-                emit configChanged(key, value);
-            }
-            return true;
-        } else {
-            emitError(QString("Failed to write key '%1': Settings error").arg(key));
-            return false;
-        }
-
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        return store(groupPrefix(*current) + key, value);
     } catch (const std::exception& e) {
         emitError(QString("Exception writing key '%1': %2").arg(key, e.what()));
         return false;
@@ -111,8 +108,8 @@ bool ConfigManager::contains(const QString& key) const noexcept
     }
 
     try {
-        QReadLocker locker(&m_lock);
-        return m_settings ? m_settings->contains(key) : false;
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        return current->values.contains(groupPrefix(*current) + key);
     } catch (...) {
         return false;
     }
@@ -125,19 +122,24 @@ bool ConfigManager::remove(const QString& key) noexcept
     }
 
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings || !m_settings->contains(key)) {
-            return false;
-        }
+        QString absoluteKey;
+        {
+            QMutexLocker locker(&m_writeMutex);
+
+            const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+            absoluteKey = groupPrefix(*current) + key;
+            if (!current->values.contains(absoluteKey)) {
+                return false;
+            }
 
-        m_settings->remove(key);
+            publish([&absoluteKey](Snapshot& next) { next.values.remove(absoluteKey); });
+            m_dirtyKeys.insert(absoluteKey);
+        }
+        scheduleFlush();
         
-        const QString section = key.split('/').first();
+        const QString section = absoluteKey.split('/').first();
         
         // Emit signal outside the lock
-        locker.unlock();
-        
         if (!section.isEmpty()) {
             emit sectionChanged(section);
         }
@@ -161,17 +163,8 @@ bool ConfigManager::beginGroup(const QString& prefix) noexcept
     }
 
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            emitError("Settings not initialized");
-            return false;
-        }
-
-        m_settings->beginGroup(prefix);
-        m_currentGroup = prefix;
-        ++m_groupDepth;
-        
+        QMutexLocker locker(&m_writeMutex);
+        publish([&prefix](Snapshot& next) { next.groups.append(prefix); });
         return true;
         
     } catch (const std::exception& e) {
@@ -186,19 +179,9 @@ bool ConfigManager::beginGroup(const QString& prefix) noexcept
 void ConfigManager::endGroup() noexcept
 {
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            return;
-        }
-
-        if (m_groupDepth > 0) {
-            m_settings->endGroup();
-            --m_groupDepth;
-            
-            if (m_groupDepth == 0) {
-                m_currentGroup.clear();
-            }
+        QMutexLocker locker(&m_writeMutex);
+        if (!m_snapshot.load(std::memory_order_acquire)->groups.isEmpty()) {
+            publish([](Snapshot& next) { next.groups.removeLast(); });
         }
         
     } catch (const std::exception& e) {
@@ -211,8 +194,7 @@ void ConfigManager::endGroup() noexcept
 QStringList ConfigManager::childKeys() const
 {
     try {
-        QReadLocker locker(&m_lock);
-        return m_settings ? m_settings->childKeys() : QStringList{};
+        return childrenOf(*m_snapshot.load(std::memory_order_acquire), false);
     } catch (const std::exception& e) {
         emitError(QString("Error getting child keys: %1").arg(e.what()));
         return {};
@@ -225,8 +207,7 @@ QStringList ConfigManager::childKeys() const
 QStringList ConfigManager::childGroups() const
 {
     try {
-        QReadLocker locker(&m_lock);
-        return m_settings ? m_settings->childGroups() : QStringList{};
+        return childrenOf(*m_snapshot.load(std::memory_order_acquire), true);
     } catch (const std::exception& e) {
         emitError(QString("Error getting child groups: %1").arg(e.what()));
         return {};
@@ -244,22 +225,16 @@ QJsonObject ConfigManager::getSection(const QString& section) const
     }
 
     try {
-        QReadLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            emitError("Settings not initialized");
-            return {};
-        }
-
-        m_settings->beginGroup(section);
-        const QStringList keys = m_settings->childKeys();
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        const QString prefix = groupPrefix(*current) + section + '/';
 
+        // Direct children only, as QSettings::childKeys() would list them
         QVariantMap sectionData;
-        for (const QString& key : keys) {
-            sectionData[key] = m_settings->value(key);
+        for (auto it = current->values.cbegin(); it != current->values.cend(); ++it) {
+            if (it.key().startsWith(prefix) && it.key().indexOf('/', prefix.size()) < 0) {
+                sectionData[it.key().mid(prefix.size())] = it.value();
+            }
         }
-
-        m_settings->endGroup();
         return variantMapToJson(sectionData);
         
     } catch (const std::exception& e) {
@@ -279,55 +254,34 @@ bool ConfigManager::setSection(const QString& section, const QJsonObject& data)
     }
 
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            emitError("Settings not initialized");
-            return false;
-        }
-
-        // Use RAII for group management
-        class GroupGuard {
-        public:
-            GroupGuard(QSettings* settings, const QString& group)
-                : m_settings(settings), m_hasGroup(!group.isEmpty()) {
-                if (m_hasGroup) {
-                    m_settings->beginGroup(group);
-                }
-            }
-
-            ~GroupGuard() {
-                if (m_hasGroup && m_settings) {
-                    m_settings->endGroup();
-                }
-            }
-
-        private:
-            QSettings* m_settings;
-            bool m_hasGroup;
-        };
-
         // Convert JSON to variant map for atomic operation
         const QVariantMap variantMap = jsonToVariantMap(data);
 
-        // Ensure atomic write operation
-        GroupGuard guard(m_settings.get(), section);
-
-        // Clear existing keys in section first
-        m_settings->remove("");
-
-        // Write all new values
-        for (auto it = variantMap.constBegin(); it != variantMap.constEnd(); ++it) {
-            m_settings->setValue(it.key(), it.value());
+        {
+            QMutexLocker locker(&m_writeMutex);
+
+            const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+            const QString prefix = groupPrefix(*current) + section + '/';
+
+            // One new snapshot: readers see the old section or the new one, never a mix
+            publish([this, &prefix, &variantMap](Snapshot& next) {
+                next.values.removeIf([this, &prefix](const QHash<QString, QVariant>::iterator& it) {
+                    if (!it.key().startsWith(prefix)) {
+                        return false;
+                    }
+                    m_dirtyKeys.insert(it.key());
+                    return true;
+                });
+                for (auto it = variantMap.constBegin(); it != variantMap.constEnd(); ++it) {
+                    next.values.insert(prefix + it.key(), it.value());
+                    m_dirtyKeys.insert(prefix + it.key());
+                }
+            });
         }
+        scheduleFlush();
 
-        if (m_settings->status() == QSettings::NoError) {
-            emit sectionChanged(section);
-            return true;
-        } else {
-            emitError(QString("Failed to write section '%1'").arg(section));
-            return false;
-        }
+        emit sectionChanged(section);
+        return true;
 
     } catch (const std::exception& e) {
         emitError(QString("Exception writing section '%1': %2").arg(section, e.what()));
@@ -341,16 +295,15 @@ bool ConfigManager::setSection(const QString& section, const QJsonObject& data)
 bool ConfigManager::sync() noexcept
 {
     try {
-        QWriteLocker locker(&m_lock);
-
         if (!m_settings) {
             emitError("Settings not initialized");
             return false;
         }
 
-        m_settings->sync();
+        flushPending();
+        m_ioPool.waitForDone();
         
-        if (m_settings->status() != QSettings::NoError) {
+        if (m_flushFailed.exchange(false)) {
             emitError("Failed to sync settings to disk");
             return false;
         }
@@ -368,12 +321,18 @@ bool ConfigManager::sync() noexcept
 
 QString ConfigManager::fileName() const noexcept
 {
-    try {
-        QReadLocker locker(&m_lock);
-        return m_settings ? m_settings->fileName() : QString{};
-    } catch (...) {
-        return {};
-    }
+    return m_fileName;
+}
+
+QVariant ConfigManager::storedValue(const QString& key, const QVariant& defaultValue)
+{
+    const QSettings settings(configFilePath(), QSettings::IniFormat);
+    return settings.value(key, defaultValue);
+}
+
+QString ConfigManager::configFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/DarkPlay.conf";
 }
 
 bool ConfigManager::loadDefaults() noexcept
@@ -385,18 +344,20 @@ bool ConfigManager::loadDefaults() noexcept
 bool ConfigManager::resetToDefaults() noexcept
 {
     try {
-        QWriteLocker locker(&m_lock);
-        
-        if (!m_settings) {
-            emitError("Settings not initialized");
-            return false;
-        }
+        {
+            QMutexLocker locker(&m_writeMutex);
 
-        m_settings->clear();
-        
-        // Unlock before calling setupDefaults to prevent deadlock
-        locker.unlock();
+            if (!m_settings) {
+                emitError("Settings not initialized");
+                return false;
+            }
+
+            publish([](Snapshot& next) { next.values.clear(); });
+            m_dirtyKeys.clear();
+            m_clearPending = true;
+        }
         
+        // Outside the lock - setupDefaults() writes through setValue()
         setupDefaults();
         sync();
         
@@ -411,6 +372,131 @@ bool ConfigManager::resetToDefaults() noexcept
     }
 }
 
+QString ConfigManager::groupPrefix(const Snapshot& snapshot)
+{
+    return snapshot.groups.isEmpty() ? QString() : snapshot.groups.join('/') + '/';
+}
+
+QStringList ConfigManager::childrenOf(const Snapshot& snapshot, bool groups)
+{
+    const QString prefix = groupPrefix(snapshot);
+
+    QStringList children;
+    for (auto it = snapshot.values.cbegin(); it != snapshot.values.cend(); ++it) {
+        if (!it.key().startsWith(prefix)) {
+            continue;
+        }
+        const QString rest = it.key().mid(prefix.size());
+        const qsizetype slash = rest.indexOf('/');
+        if (groups && slash > 0) {
+            children.append(rest.left(slash));
+        } else if (!groups && slash < 0) {
+            children.append(rest);
+        }
+    }
+
+    children.removeDuplicates();
+    children.sort();
+    return children;
+}
+
+bool ConfigManager::store(const QString& absoluteKey, const QVariant& value) noexcept
+{
+    try {
+        {
+            QMutexLocker locker(&m_writeMutex);
+
+            if (!m_settings) {
+                emitError("Settings not initialized");
+                return false;
+            }
+
+            // Only a real change is worth a snapshot, a flush and a signal
+            const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+            const auto it = current->values.constFind(absoluteKey);
+            if (it != current->values.cend() && *it == value) {
+                return true;
+            }
+
+            publish([&absoluteKey, &value](Snapshot& next) { next.values.insert(absoluteKey, value); });
+            m_dirtyKeys.insert(absoluteKey);
+        }
+        scheduleFlush();
+
+        emit configChanged(absoluteKey, value);
+        return true;
+
+    } catch (const std::exception& e) {
+        emitError(QString("Exception writing key '%1': %2").arg(absoluteKey, e.what()));
+        return false;
+    } catch (...) {
+        emitError(QString("Unknown exception writing key '%1'").arg(absoluteKey));
+        return false;
+    }
+}
+
+template<typename Mutator>
+void ConfigManager::publish(Mutator&& mutate)
+{
+    auto next = std::make_shared<Snapshot>(*m_snapshot.load(std::memory_order_acquire));
+    mutate(*next);
+    m_snapshot.store(std::move(next), std::memory_order_release);
+}
+
+void ConfigManager::scheduleFlush()
+{
+    // The timer belongs to our thread; writers elsewhere ask it to start
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() { scheduleFlush(); }, Qt::QueuedConnection);
+        return;
+    }
+
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void ConfigManager::flushPending()
+{
+    QHash<QString, std::optional<QVariant>> changes;
+    bool clear = false;
+    {
+        QMutexLocker locker(&m_writeMutex);
+        if (!m_settings || (m_dirtyKeys.isEmpty() && !m_clearPending)) {
+            return;
+        }
+
+        const SnapshotPtr current = m_snapshot.load(std::memory_order_acquire);
+        changes.reserve(m_dirtyKeys.size());
+        for (const QString& key : std::as_const(m_dirtyKeys)) {
+            const auto it = current->values.constFind(key);
+            changes.insert(key, it == current->values.cend() ? std::nullopt : std::optional<QVariant>(*it));
+        }
+        m_dirtyKeys.clear();
+        clear = std::exchange(m_clearPending, false);
+    }
+
+    // QSettings is only used from the pool from here on, one flush at a time
+    m_ioPool.start([this, changes = std::move(changes), clear]() {
+        if (clear) {
+            m_settings->clear();
+        }
+        for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+            if (it.value()) {
+                m_settings->setValue(it.key(), *it.value());
+            } else {
+                m_settings->remove(it.key());
+            }
+        }
+
+        m_settings->sync();
+        if (m_settings->status() != QSettings::NoError) {
+            m_flushFailed.store(true);
+            emitError("Failed to write settings to disk");
+        }
+    });
+}
+
 bool ConfigManager::isValidKey(const QString& key) const noexcept
 {
     return !key.isEmpty() && !key.contains("//") && !key.startsWith('/') && !key.endsWith('/');
@@ -425,12 +511,27 @@ void ConfigManager::setupDefaults() noexcept
         {"ui/language", "en"},
         {"ui/windowGeometry", QByteArray()},
         {"ui/windowState", QByteArray()},
+        {"ui/singleInstance", true},
         
         // Media defaults
         {"media/volume", 0.7},
         {"media/muted", false},
         {"media/autoplay", true},
         {"media/defaultEngine", "qt"},
+        {"media/hardwareAcceleration", true},
+        {"media/subtitleAutoLoad", true},
+
+        // Playback defaults
+        {"playback/rememberPosition", true},
+        {"playback/gaplessPreroll", true},
+        {"playback/prerollSeconds", 5},
+        {"playback/seekMode", "exact"},
+
+        // Network streaming defaults
+        {"network/readAheadMB", 32},
+        {"network/diskCacheMB", 256},
+        {"network/adaptiveBitrate", true},
+        {"network/stallRecoverySeconds", 8},
         
         // Plugins defaults
         {"plugins/directory", "plugins"},
@@ -443,7 +544,17 @@ void ConfigManager::setupDefaults() noexcept
         // Recent files
         {"files/recentFiles", QStringList()},
         {"files/maxRecentFiles", 10},
-        {"files/lastDirectory", QStandardPaths::writableLocation(QStandardPaths::MoviesLocation)}
+        {"files/lastDirectory", QStandardPaths::writableLocation(QStandardPaths::MoviesLocation)},
+
+        // Media library
+        {"library/folders", QStringList()},
+
+        // Memory budget; 0 MB picks a share of physical memory
+        {"memory/budgetMB", 0},
+        {"memory/lowMemoryMode", false},
+
+        // Exports running at once; 0 picks from the core count
+        {"export/maxJobs", 0}
     };
 
     try {
@@ -479,6 +590,35 @@ bool ConfigManager::validateValue(const QString& key, const QVariant& value) con
         return ok && max >= 0 && max <= 100;
     }
 
+    if (key == "playback/prerollSeconds") {
+        bool ok;
+        const int seconds = value.toInt(&ok);
+        return ok && seconds >= 1 && seconds <= 60;
+    }
+
+    if (key == "playback/seekMode") {
+        const QString mode = value.toString();
+        return mode == "exact" || mode == "fast";
+    }
+
+    if (key == "network/readAheadMB") {
+        bool ok;
+        const int megabytes = value.toInt(&ok);
+        return ok && megabytes >= 4 && megabytes <= 512;
+    }
+
+    if (key == "network/diskCacheMB") {
+        bool ok;
+        const int megabytes = value.toInt(&ok);
+        return ok && megabytes >= 0 && megabytes <= 4096;
+    }
+
+    if (key == "network/stallRecoverySeconds") {
+        bool ok;
+        const int seconds = value.toInt(&ok);
+        return ok && seconds >= 2 && seconds <= 60;
+    }
+
     if (key == "performance/bufferSize") {
         bool ok;
         const int size = value.toInt(&ok);
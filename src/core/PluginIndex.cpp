@@ -0,0 +1,147 @@
+#include "core/PluginIndex.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPluginLoader>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace DarkPlay::Core {
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x44505049; // "DPPI"
+
+QDataStream& operator<<(QDataStream& stream, const PluginIndex::Entry& entry)
+{
+    return stream << entry.size << entry.modifiedMs << entry.iid << entry.name << entry.version << entry.dependencies;
+}
+
+QDataStream& operator>>(QDataStream& stream, PluginIndex::Entry& entry)
+{
+    return stream >> entry.size >> entry.modifiedMs >> entry.iid >> entry.name >> entry.version >> entry.dependencies;
+}
+
+} // namespace
+
+PluginIndex::PluginIndex()
+    : m_dirty(false)
+    , m_hits(0)
+{
+    load();
+}
+
+PluginIndex::~PluginIndex() = default;
+
+PluginIndex::Entry PluginIndex::entry(const QFileInfo& file)
+{
+    const QString path = file.absoluteFilePath();
+    const qint64 size = file.size();
+    const qint64 modifiedMs = file.lastModified().toMSecsSinceEpoch();
+
+    const auto it = m_entries.constFind(path);
+    if (it != m_entries.cend() && it->size == size && it->modifiedMs == modifiedMs) {
+        ++m_hits;
+        m_seen.insert(path, *it);
+        return *it;
+    }
+
+    Entry entry = readMetaData(file);
+    entry.size = size;
+    entry.modifiedMs = modifiedMs;
+    m_seen.insert(path, entry);
+    m_dirty = true;
+    return entry;
+}
+
+void PluginIndex::update(const QString& filePath, const Entry& entry)
+{
+    m_seen.insert(filePath, entry);
+    m_dirty = true;
+}
+
+void PluginIndex::save()
+{
+    // A library that disappeared is a change too
+    if (!m_dirty && m_seen.size() == m_entries.size()) {
+        return;
+    }
+
+    const QString path = indexPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "PluginIndex: Cannot write" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << INDEX_MAGIC << FORMAT_VERSION << qint32(m_seen.size());
+    for (auto it = m_seen.cbegin(); it != m_seen.cend(); ++it) {
+        stream << it.key() << it.value();
+    }
+
+    if (!file.commit()) {
+        qWarning() << "PluginIndex: Failed to save plugin index";
+        return;
+    }
+    m_entries = m_seen;
+    m_dirty = false;
+}
+
+void PluginIndex::load()
+{
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != FORMAT_VERSION || count < 0) {
+        return;
+    }
+
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        stream >> path >> entry;
+        if (stream.status() == QDataStream::Ok) {
+            m_entries.insert(path, entry);
+        }
+    }
+}
+
+PluginIndex::Entry PluginIndex::readMetaData(const QFileInfo& file)
+{
+    // Reads the embedded JSON from the file; the library is not loaded
+    const QPluginLoader loader(file.absoluteFilePath());
+    const QJsonObject metaData = loader.metaData();
+    const QJsonObject custom = metaData.value("MetaData").toObject();
+
+    Entry entry;
+    entry.iid = metaData.value("IID").toString();
+    entry.name = custom.value("name").toString();
+    entry.version = custom.value("version").toString();
+    for (const QJsonValue& dependency : custom.value("dependencies").toArray()) {
+        entry.dependencies.append(dependency.toString());
+    }
+    return entry;
+}
+
+QString PluginIndex::indexPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/plugin_index.cache";
+}
+
+} // namespace DarkPlay::Core
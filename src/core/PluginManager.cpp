@@ -1,13 +1,27 @@
 #include "core/PluginManager.h"
+#include "core/PluginIndex.h"
 #include "plugins/IPlugin.h"
+#include "utils/Trace.h"
 #include <QDir>
+#include <QElapsedTimer>
 #include <QPluginLoader>
 #include <QDebug>
 #include <QReadLocker>
+#include <QThread>
+#include <QThreadPool>
 #include <QWriteLocker>
+#include <algorithm>
+#include <functional>
+#include <vector>
 
 namespace DarkPlay::Core {
 
+namespace {
+
+constexpr const char* INTERFACE_PREFIX = "com.darkplay.";
+
+} // namespace
+
 PluginManager::PluginManager(QObject* parent)
     : QObject(parent)
 {
@@ -20,70 +34,36 @@ PluginManager::~PluginManager()
 
 bool PluginManager::loadPlugin(const QString& filePath) noexcept
 {
+    DARKPLAY_TRACE_SCOPE("plugins", "loadPlugin");
+
     if (filePath.isEmpty()) {
         emitError("", "Empty file path provided");
         return false;
     }
 
     try {
-        QWriteLocker locker(&m_pluginsLock);
-
         // Create loader with RAII management
         auto loader = std::make_unique<QPluginLoader>(filePath);
-        QObject* pluginObject = loader->instance();
 
-        if (!pluginObject) {
+        QElapsedTimer timer;
+        timer.start();
+        if (!loader->load()) {
             emitError("", QString("Failed to load plugin from %1: %2")
                          .arg(filePath, loader->errorString()));
             return false;
         }
+        const qint64 loadUs = timer.nsecsElapsed() / 1000;
 
-        auto* plugin = qobject_cast<Plugins::IPlugin*>(pluginObject);
-        if (!plugin) {
-            emitError("", QString("Invalid plugin interface in %1").arg(filePath));
-            return false;
-        }
-
-        if (!validatePlugin(plugin)) {
-            emitError("", QString("Plugin validation failed for %1").arg(filePath));
-            return false;
-        }
-
-        const QString pluginName = plugin->name();
-        if (m_loadedPlugins.contains(pluginName)) {
-            emitError(pluginName, "Plugin already loaded");
-            return false;
-        }
-
-        // Initialize plugin before storing
-        // Unlock temporarily for initialization to prevent deadlock
-        locker.unlock();
-
-        try {
-            initializePlugin(plugin);
-        } catch (const std::exception& e) {
-            emitError(pluginName, QString("Initialization failed: %1").arg(e.what()));
+        // A single library is wanted now: instantiate it right away
+        const QString pluginName = registerPlugin(std::move(loader), {}, {}, {}, loadUs);
+        if (pluginName.isEmpty()) {
             return false;
         }
 
-        // Re-lock and store plugin info
-        locker.relock();
-
-        PluginInfo info;
-        info.pluginObject = pluginObject;  // QPluginLoader manages lifetime
-        info.loader = std::move(loader);   // RAII for loader
-        info.filePath = filePath;
-        info.enabled.store(true, std::memory_order_release);
-
-        m_loadedPlugins.emplace(pluginName, std::move(info));
-
-        // Emit signals outside critical section
-        locker.unlock();
-
         emit pluginLoaded(pluginName);
-        emit pluginEnabled(pluginName);
 
-        return true;
+        QSet<QString> visiting;
+        return instantiate(pluginName, visiting);
 
     } catch (const std::exception& e) {
         emitError("", QString("Exception during plugin loading: %1").arg(e.what()));
@@ -115,6 +95,7 @@ bool PluginManager::unloadPlugin(const QString& pluginName) noexcept
         locker.unlock();
 
         if (plugin) {
+            emit pluginAboutToShutdown(pluginName);
             try {
                 plugin->shutdown();
             } catch (const std::exception& e) {
@@ -148,13 +129,27 @@ bool PluginManager::unloadPlugin(const QString& pluginName) noexcept
 void PluginManager::loadAllPlugins(const QString& pluginsDirectory) noexcept
 {
     try {
-        m_pluginsDirectory = pluginsDirectory;
-        const QDir dir(pluginsDirectory);
-
-        if (!dir.exists()) {
+        if (!QDir(pluginsDirectory).exists()) {
             emitError("", QString("Plugins directory does not exist: %1").arg(pluginsDirectory));
             return;
         }
+        loadAllPlugins(QStringList{pluginsDirectory});
+    } catch (...) {
+        emitError("", "Unknown error during bulk loading");
+    }
+}
+
+void PluginManager::loadAllPlugins(const QStringList& pluginsDirectories) noexcept
+{
+    DARKPLAY_TRACE_SCOPE("plugins", "loadAllPlugins");
+
+    try {
+        QElapsedTimer totalTimer;
+        totalTimer.start();
+
+        if (!m_index) {
+            m_index = std::make_unique<PluginIndex>();
+        }
 
         QStringList filters;
 #ifdef Q_OS_WIN
@@ -165,10 +160,155 @@ void PluginManager::loadAllPlugins(const QString& pluginsDirectory) noexcept
         filters << "*.so";
 #endif
 
-        const QStringList pluginFiles = dir.entryList(filters, QDir::Files);
-        for (const QString& fileName : pluginFiles) {
-            const QString filePath = dir.absoluteFilePath(fileName);
-            loadPlugin(filePath);
+        struct Candidate {
+            QString filePath;
+            PluginIndex::Entry entry;
+            std::unique_ptr<QPluginLoader> loader;
+            qint64 loadUs{0};
+            bool loaded{false};
+            int level{0};
+        };
+        std::vector<Candidate> candidates;
+        QSet<QString> seenFiles;
+        m_pluginsDirectory = pluginsDirectories.value(0);
+
+        // Names and dependencies from the index or the libraries' JSON metadata, nothing loaded yet
+        for (const QString& directory : pluginsDirectories) {
+            const QDir dir(directory);
+            if (!dir.exists()) {
+                continue;
+            }
+
+            for (const QFileInfo& file : dir.entryInfoList(filters, QDir::Files, QDir::Name)) {
+                const QString filePath = file.canonicalFilePath();
+                if (filePath.isEmpty() || seenFiles.contains(filePath)) {
+                    continue;
+                }
+                seenFiles.insert(filePath);
+
+                PluginIndex::Entry entry = m_index->entry(QFileInfo(filePath));
+                if (!entry.iid.startsWith(QLatin1String(INTERFACE_PREFIX))) {
+                    emitError("", QString("Invalid plugin interface in %1").arg(filePath));
+                    continue;
+                }
+                candidates.push_back(Candidate{filePath, std::move(entry), nullptr, 0, false, 0});
+            }
+        }
+
+        // Earlier search paths take precedence for a name
+        QHash<QString, qsizetype> byName;
+        for (qsizetype i = 0; i < static_cast<qsizetype>(candidates.size()); ++i) {
+            const QString& name = candidates[i].entry.name;
+            if (name.isEmpty()) {
+                continue;
+            }
+            if (byName.contains(name) || isPluginLoaded(name)) {
+                emitError(name, "Plugin already loaded");
+                candidates[i].level = -1;
+                continue;
+            }
+            byName.insert(name, i);
+        }
+
+        // Dependency depth decides the load wave; a cycle excludes its members
+        std::vector<int> state(candidates.size(), 0); // 0 new, 1 visiting, 2 done
+        std::function<int(qsizetype)> depth = [&](qsizetype i) -> int {
+            if (state[i] == 2) {
+                return candidates[i].level;
+            }
+            if (state[i] == 1) {
+                return -1;
+            }
+            state[i] = 1;
+            int level = 0;
+            for (const QString& dependency : std::as_const(candidates[i].entry.dependencies)) {
+                const auto it = byName.constFind(dependency);
+                if (it == byName.cend()) {
+                    continue; // Already loaded, or checked again at instantiation
+                }
+                const int dependencyLevel = depth(*it);
+                if (dependencyLevel < 0) {
+                    level = -1;
+                    break;
+                }
+                level = std::max(level, dependencyLevel + 1);
+            }
+            state[i] = 2;
+            candidates[i].level = level;
+            return level;
+        };
+
+        int maxLevel = 0;
+        for (qsizetype i = 0; i < static_cast<qsizetype>(candidates.size()); ++i) {
+            if (candidates[i].level < 0) {
+                continue;
+            }
+            if (!candidates[i].entry.name.isEmpty() && depth(i) < 0) {
+                emitError(candidates[i].entry.name, "Circular plugin dependency");
+                continue;
+            }
+            maxLevel = std::max(maxLevel, candidates[i].level);
+        }
+
+        // Each wave loads its libraries concurrently; dependencies are in earlier waves
+        QThreadPool pool;
+        for (int level = 0; level <= maxLevel; ++level) {
+            for (Candidate& candidate : candidates) {
+                if (candidate.level != level) {
+                    continue;
+                }
+                candidate.loader = std::make_unique<QPluginLoader>(candidate.filePath);
+                Candidate* target = &candidate;
+                pool.start([target]() {
+                    QElapsedTimer timer;
+                    timer.start();
+                    target->loaded = target->loader->load();
+                    target->loadUs = timer.nsecsElapsed() / 1000;
+                });
+            }
+            pool.waitForDone();
+        }
+
+        QStringList registered;
+        for (Candidate& candidate : candidates) {
+            if (!candidate.loader) {
+                continue;
+            }
+            if (!candidate.loaded) {
+                emitError(candidate.entry.name, QString("Failed to load plugin from %1: %2")
+                                                   .arg(candidate.filePath, candidate.loader->errorString()));
+                continue;
+            }
+
+            const bool knownName = !candidate.entry.name.isEmpty();
+            const QString name = registerPlugin(std::move(candidate.loader), candidate.entry.name,
+                                                candidate.entry.iid, candidate.entry.dependencies, candidate.loadUs);
+            if (name.isEmpty()) {
+                continue;
+            }
+
+            // Learnt from the instance: the next startup needs no instantiation to know it
+            if (!knownName) {
+                QReadLocker locker(&m_pluginsLock);
+                const auto it = m_loadedPlugins.find(name);
+                if (it != m_loadedPlugins.end()) {
+                    PluginIndex::Entry entry = candidate.entry;
+                    entry.name = name;
+                    entry.dependencies = it->second.dependencies;
+                    m_index->update(candidate.filePath, entry);
+                }
+            }
+            registered.append(name);
+        }
+
+        m_index->save();
+
+        qDebug() << "PluginManager: Loaded" << registered.size() << "of" << candidates.size() << "plugins in"
+                 << totalTimer.elapsed() << "ms (" << m_index->hits() << "indexed,"
+                 << maxLevel + 1 << "dependency waves)";
+
+        for (const QString& name : std::as_const(registered)) {
+            emit pluginLoaded(name);
         }
 
     } catch (const std::exception& e) {
@@ -225,6 +365,8 @@ QStringList PluginManager::availablePlugins() const
 
 Plugins::IPlugin* PluginManager::getPlugin(const QString& name) const
 {
+    const_cast<PluginManager*>(this)->ensureInstantiated(name);
+
     QReadLocker locker(&m_pluginsLock);
     return getPluginUnsafe(name);
 }
@@ -263,6 +405,13 @@ bool PluginManager::enablePlugin(const QString& name) noexcept
             return false;
         }
 
+        // Never instantiated: doing so initialises and enables it
+        if (!it->second.pluginObject) {
+            locker.unlock();
+            QSet<QString> visiting;
+            return instantiate(name, visiting);
+        }
+
         if (it->second.enabled.load(std::memory_order_acquire)) {
             return true; // Already enabled
         }
@@ -307,6 +456,14 @@ bool PluginManager::disablePlugin(const QString& name) noexcept
             return true; // Already disabled
         }
 
+        // Never instantiated: there is nothing to shut down, just keep it that way
+        if (!it->second.pluginObject) {
+            it->second.enabled.store(false, std::memory_order_release);
+            locker.unlock();
+            emit pluginDisabled(name);
+            return true;
+        }
+
         auto* plugin = qobject_cast<Plugins::IPlugin*>(it->second.pluginObject);
         if (!plugin) {
             return false;
@@ -315,6 +472,7 @@ bool PluginManager::disablePlugin(const QString& name) noexcept
         // Unlock for plugin operation
         locker.unlock();
 
+        emit pluginAboutToShutdown(name);
         plugin->shutdown();
         it->second.enabled.store(false, std::memory_order_release);
         emit pluginDisabled(name);
@@ -358,6 +516,21 @@ int PluginManager::enabledPluginCount() const noexcept
     }
 }
 
+QList<PluginManager::PluginTiming> PluginManager::pluginTimings() const
+{
+    QReadLocker locker(&m_pluginsLock);
+
+    QList<PluginTiming> result;
+    result.reserve(static_cast<qsizetype>(m_loadedPlugins.size()));
+    for (const auto& [name, info] : m_loadedPlugins) {
+        result.append(PluginTiming{name, info.loadUs, info.initUs, info.pluginObject != nullptr});
+    }
+    std::sort(result.begin(), result.end(), [](const PluginTiming& a, const PluginTiming& b) {
+        return a.name < b.name;
+    });
+    return result;
+}
+
 bool PluginManager::validatePlugin(const Plugins::IPlugin* plugin) noexcept
 {
     if (!plugin) {
@@ -402,6 +575,207 @@ void PluginManager::initializePlugin(Plugins::IPlugin* plugin)
     }
 }
 
+QString PluginManager::registerPlugin(std::unique_ptr<QPluginLoader> loader, QString name,
+                                     QString iid, QStringList dependencies, qint64 loadUs)
+{
+    const QString filePath = loader->fileName();
+
+    // Without metadata only the plugin itself can say who it is
+    if (name.isEmpty()) {
+        auto* plugin = qobject_cast<Plugins::IPlugin*>(loader->instance());
+        if (!plugin) {
+            emitError("", QString("Invalid plugin interface in %1").arg(filePath));
+            return {};
+        }
+        if (!validatePlugin(plugin)) {
+            emitError("", QString("Plugin validation failed for %1").arg(filePath));
+            return {};
+        }
+        name = plugin->name();
+        dependencies = plugin->dependencies();
+        if (iid.isEmpty()) {
+            iid = loader->metaData().value("IID").toString();
+        }
+    }
+
+    QWriteLocker locker(&m_pluginsLock);
+    if (m_loadedPlugins.contains(name)) {
+        locker.unlock();
+        emitError(name, "Plugin already loaded");
+        return {};
+    }
+
+    PluginInfo info;
+    info.loader = std::move(loader);   // RAII for loader
+    info.filePath = filePath;
+    info.iid = std::move(iid);
+    info.dependencies = std::move(dependencies);
+    info.loadUs = loadUs;
+    info.enabled.store(true, std::memory_order_release); // Enabled once instantiated
+
+    m_loadedPlugins.emplace(name, std::move(info));
+    return name;
+}
+
+bool PluginManager::instantiate(const QString& name, QSet<QString>& visiting)
+{
+    DARKPLAY_TRACE_SCOPE("plugins", "instantiatePlugin");
+
+    QPluginLoader* loader = nullptr;
+    QStringList dependencies;
+    qint64 loadUs = 0;
+    {
+        QReadLocker locker(&m_pluginsLock);
+        const auto it = m_loadedPlugins.find(name);
+        if (it == m_loadedPlugins.end() || it->second.failed) {
+            return false;
+        }
+        if (it->second.pluginObject) {
+            return true;
+        }
+        loader = it->second.loader.get();
+        dependencies = it->second.dependencies;
+        loadUs = it->second.loadUs;
+    }
+
+    if (visiting.contains(name)) {
+        markFailed(name, "Circular plugin dependency");
+        return false;
+    }
+    visiting.insert(name);
+
+    // Dependencies are initialised first
+    for (const QString& dependency : std::as_const(dependencies)) {
+        if (!instantiate(dependency, visiting)) {
+            markFailed(name, QString("Dependency unavailable: %1").arg(dependency));
+            visiting.remove(name);
+            return false;
+        }
+    }
+    visiting.remove(name);
+
+    // A dependency's pluginEnabled handler may have asked for this plugin already
+    {
+        QReadLocker locker(&m_pluginsLock);
+        const auto it = m_loadedPlugins.find(name);
+        if (it == m_loadedPlugins.end() || it->second.failed) {
+            return false;
+        }
+        if (it->second.pluginObject) {
+            return true;
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QObject* pluginObject = loader->instance();
+    auto* plugin = qobject_cast<Plugins::IPlugin*>(pluginObject);
+    if (!plugin) {
+        markFailed(name, QString("Invalid plugin interface in %1: %2").arg(loader->fileName(), loader->errorString()));
+        return false;
+    }
+    if (!validatePlugin(plugin) || plugin->name() != name) {
+        markFailed(name, QString("Plugin validation failed for %1").arg(loader->fileName()));
+        return false;
+    }
+
+    try {
+        initializePlugin(plugin);
+    } catch (const std::exception& e) {
+        markFailed(name, QString("Initialization failed: %1").arg(e.what()));
+        return false;
+    }
+    const qint64 initUs = timer.nsecsElapsed() / 1000;
+
+    {
+        QWriteLocker locker(&m_pluginsLock);
+        const auto it = m_loadedPlugins.find(name);
+        if (it == m_loadedPlugins.end()) {
+            return false; // Unloaded meanwhile
+        }
+        it->second.pluginObject = pluginObject;  // QPluginLoader manages lifetime
+        it->second.initUs = initUs;
+        it->second.enabled.store(true, std::memory_order_release);
+    }
+
+    qDebug() << "PluginManager:" << name << "library loaded in" << loadUs / 1000.0 << "ms, initialised in"
+             << initUs / 1000.0 << "ms";
+    emit pluginEnabled(name);
+    return true;
+}
+
+void PluginManager::ensureInstantiated(const QString& name) noexcept
+{
+    if (QThread::currentThread() != thread()) {
+        return;
+    }
+
+    try {
+        {
+            QReadLocker locker(&m_pluginsLock);
+            const auto it = m_loadedPlugins.find(name);
+            if (it == m_loadedPlugins.end() || it->second.pluginObject || it->second.failed
+                || !it->second.enabled.load(std::memory_order_acquire)) {
+                return;
+            }
+        }
+
+        QSet<QString> visiting;
+        instantiate(name, visiting);
+    } catch (...) {
+        emitError(name, "Unknown error during instantiation");
+    }
+}
+
+void PluginManager::instantiatePending(const char* iid) noexcept
+{
+    if (QThread::currentThread() != thread()) {
+        return;
+    }
+
+    try {
+        // Every DarkPlay interface derives from IPlugin, so asking for it matches all
+        const QString wanted = QString::fromLatin1(iid);
+        const bool any = wanted.isEmpty() || wanted == QLatin1String(qobject_interface_iid<Plugins::IPlugin*>());
+
+        QStringList pending;
+        {
+            QReadLocker locker(&m_pluginsLock);
+            for (const auto& [name, info] : m_loadedPlugins) {
+                if (!info.pluginObject && !info.failed && info.enabled.load(std::memory_order_acquire)
+                    && (any || info.iid.isEmpty() || info.iid == wanted)) {
+                    pending.append(name);
+                }
+            }
+        }
+
+        for (const QString& name : std::as_const(pending)) {
+            QSet<QString> visiting;
+            instantiate(name, visiting);
+        }
+    } catch (...) {
+        emitError("", "Unknown error during instantiation");
+    }
+}
+
+void PluginManager::markFailed(const QString& name, const QString& error) noexcept
+{
+    try {
+        {
+            QWriteLocker locker(&m_pluginsLock);
+            const auto it = m_loadedPlugins.find(name);
+            if (it != m_loadedPlugins.end()) {
+                it->second.failed = true;
+                it->second.enabled.store(false, std::memory_order_release);
+            }
+        }
+        emitError(name, error);
+    } catch (...) {
+        qWarning() << "PluginManager: Failed to record error for" << name;
+    }
+}
+
 void PluginManager::emitError(const QString& pluginName, const QString& error) const noexcept
 {
     try {
@@ -0,0 +1,286 @@
+#include "core/ResumePositionStore.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <utility>
+
+namespace DarkPlay::Core {
+
+namespace {
+
+constexpr quint32 STORE_MAGIC = 0x44505250; // "DPRP"
+
+} // namespace
+
+ResumePositionStore::ResumePositionStore(QObject* parent)
+    : QObject(parent)
+    , m_journalRecords(0)
+    , m_journalDamaged(false)
+    , m_loaded(false)
+    , m_loadResult(std::make_shared<LoadResult>())
+{
+    m_ioPool.setMaxThreadCount(1); // Keeps reads, appends and rewrites in order
+
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(FLUSH_INTERVAL_MS);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ResumePositionStore::writeBehind);
+
+    // Hundreds of thousands of records: read them off the GUI thread
+    QPointer<ResumePositionStore> self(this);
+    m_ioPool.start([self, result = m_loadResult, path = storePath()]() {
+        readJournal(path, *result);
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self]() {
+                if (self) {
+                    self->ensureLoaded();
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+ResumePositionStore::~ResumePositionStore()
+{
+    flush();
+}
+
+qint64 ResumePositionStore::position(const QString& key)
+{
+    ensureLoaded();
+
+    const auto it = m_entries.constFind(key);
+    return it == m_entries.cend() ? 0 : it->positionMs;
+}
+
+void ResumePositionStore::update(const QString& key, qint64 positionMs, qint64 durationMs)
+{
+    if (key.isEmpty() || positionMs < 0) {
+        return;
+    }
+
+    // Barely started or practically finished: next time starts from the top
+    const bool nearStart = positionMs < MIN_RESUME_MS;
+    const bool nearEnd = durationMs > 0 && durationMs - positionMs < END_MARGIN_MS;
+    if (nearStart || nearEnd) {
+        remove(key);
+        return;
+    }
+
+    const auto it = m_entries.constFind(key);
+    if (it != m_entries.cend() && it->durationMs == durationMs
+        && qAbs(it->positionMs - positionMs) < POSITION_GRANULARITY_MS) {
+        return;
+    }
+
+    const Entry entry{positionMs, durationMs, QDateTime::currentSecsSinceEpoch()};
+    m_entries.insert(key, entry);
+    markChanged(key, entry);
+}
+
+void ResumePositionStore::remove(const QString& key)
+{
+    // Until the journal is loaded, it may still hold the key
+    if (m_entries.remove(key) == 0 && m_loaded && !m_pending.contains(key)) {
+        return;
+    }
+    markChanged(key, Entry{-1, 0, QDateTime::currentSecsSinceEpoch()});
+}
+
+qsizetype ResumePositionStore::count()
+{
+    ensureLoaded();
+    return m_entries.size();
+}
+
+void ResumePositionStore::flush() noexcept
+{
+    try {
+        m_flushTimer.stop();
+        writeBehind();
+        m_ioPool.waitForDone();
+    } catch (const std::exception& e) {
+        qWarning() << "ResumePositionStore: Flush failed:" << e.what();
+    }
+}
+
+void ResumePositionStore::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+
+    m_ioPool.waitForDone(); // Usually long finished
+    const std::shared_ptr<LoadResult> result = std::exchange(m_loadResult, nullptr);
+
+    // Everything recorded meanwhile is newer than the file
+    Entries merged = std::move(result->entries);
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (it->positionMs < 0) {
+            merged.remove(it.key());
+        } else {
+            merged.insert(it.key(), it.value());
+        }
+    }
+
+    m_entries = std::move(merged);
+    m_journalRecords = result->records;
+    m_journalDamaged = result->damaged;
+    m_loaded = true;
+    qDebug() << "ResumePositionStore: Loaded" << m_entries.size() << "positions";
+}
+
+void ResumePositionStore::markChanged(const QString& key, const Entry& entry)
+{
+    m_pending.insert(key, entry);
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void ResumePositionStore::writeBehind()
+{
+    ensureLoaded();
+    if (m_pending.isEmpty() && !m_journalDamaged) {
+        return;
+    }
+
+    if (needsCompaction()) {
+        if (m_entries.size() > MAX_ENTRIES) {
+            pruneOldest(m_entries, MAX_ENTRIES);
+        }
+        m_pending.clear();
+        m_journalRecords = m_entries.size();
+        m_journalDamaged = false;
+        m_ioPool.start([path = storePath(), entries = m_entries]() { writeSnapshot(path, entries); });
+        return;
+    }
+
+    // The common case: only what changed since the last write
+    m_journalRecords += m_pending.size();
+    m_ioPool.start([path = storePath(), records = std::exchange(m_pending, {})]() {
+        appendRecords(path, records);
+    });
+}
+
+bool ResumePositionStore::needsCompaction() const noexcept
+{
+    const qint64 live = m_entries.size();
+    const qint64 superseded = m_journalRecords + m_pending.size() - live;
+    return m_journalDamaged || live > MAX_ENTRIES || superseded > std::max(live, COMPACTION_SLACK);
+}
+
+QString ResumePositionStore::storePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/resume_positions.journal";
+}
+
+void ResumePositionStore::readJournal(const QString& path, LoadResult& result)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    stream >> magic >> version;
+    if (magic != STORE_MAGIC || version != FORMAT_VERSION) {
+        result.damaged = file.size() > 0; // Unknown contents are replaced, never appended to
+        return;
+    }
+
+    // Later records supersede earlier ones for the same key
+    while (!stream.atEnd()) {
+        QString key;
+        Entry entry;
+        stream >> key >> entry.positionMs >> entry.durationMs >> entry.updatedSecs;
+        if (stream.status() != QDataStream::Ok) {
+            result.damaged = true;
+            break;
+        }
+
+        ++result.records;
+        if (entry.positionMs < 0) {
+            result.entries.remove(key);
+        } else {
+            result.entries.insert(key, entry);
+        }
+    }
+
+    if (result.damaged) {
+        qWarning() << "ResumePositionStore: Journal is truncated, kept" << result.entries.size() << "positions";
+    }
+}
+
+bool ResumePositionStore::appendRecords(const QString& path, const Entries& records)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "ResumePositionStore: Cannot write" << path;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    if (file.size() == 0) {
+        stream << STORE_MAGIC << FORMAT_VERSION;
+    }
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        stream << it.key() << it->positionMs << it->durationMs << it->updatedSecs;
+    }
+
+    return stream.status() == QDataStream::Ok && file.flush();
+}
+
+bool ResumePositionStore::writeSnapshot(const QString& path, const Entries& entries)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ResumePositionStore: Cannot write" << path;
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << STORE_MAGIC << FORMAT_VERSION;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        stream << it.key() << it->positionMs << it->durationMs << it->updatedSecs;
+    }
+
+    if (!file.commit()) {
+        qWarning() << "ResumePositionStore: Failed to save positions";
+        return false;
+    }
+    return true;
+}
+
+void ResumePositionStore::pruneOldest(Entries& entries, qsizetype keep)
+{
+    // The least recently watched files are forgotten first
+    QList<qint64> updated;
+    updated.reserve(entries.size());
+    for (const Entry& entry : std::as_const(entries)) {
+        updated.append(entry.updatedSecs);
+    }
+    const auto cutoff = updated.begin() + (entries.size() - keep);
+    std::nth_element(updated.begin(), cutoff, updated.end());
+    const qint64 threshold = *cutoff;
+    entries.removeIf([threshold](const Entries::iterator& it) {
+        return it.value().updatedSecs < threshold;
+    });
+}
+
+} // namespace DarkPlay::Core
@@ -0,0 +1,163 @@
+#include "core/SingleInstance.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+namespace DarkPlay::Core {
+
+namespace {
+
+QByteArray encode(const QJsonObject& object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QJsonObject failure(const QString& error)
+{
+    return QJsonObject{{"ok", false}, {"error", error}};
+}
+
+} // namespace
+
+SingleInstance::SingleInstance(QObject* parent)
+    : QObject(parent)
+    , m_server(nullptr)
+{
+}
+
+SingleInstance::~SingleInstance() = default;
+
+QString SingleInstance::serverName()
+{
+    const QByteArray user = QCryptographicHash::hash(QDir::homePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QString("darkplay-%1").arg(QString::fromLatin1(user.left(16)));
+}
+
+bool SingleInstance::forward(const QList<QJsonObject>& requests, QList<QJsonObject>* replies)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName());
+    if (!socket.waitForConnected(CONNECT_TIMEOUT_MS)) {
+        return false;
+    }
+
+    for (const QJsonObject& request : requests) {
+        socket.write(encode(request));
+    }
+    while (socket.bytesToWrite() > 0) {
+        if (!socket.waitForBytesWritten(REPLY_TIMEOUT_MS)) {
+            return false;
+        }
+    }
+
+    // One reply per request; a busy instance still has the requests even if we stop waiting
+    QList<QJsonObject> received;
+    while (received.size() < requests.size()) {
+        if (!socket.canReadLine() && !socket.waitForReadyRead(REPLY_TIMEOUT_MS)) {
+            break;
+        }
+        while (socket.canReadLine() && received.size() < requests.size()) {
+            received.append(QJsonDocument::fromJson(socket.readLine().trimmed()).object());
+        }
+    }
+    socket.disconnectFromServer();
+
+    if (replies) {
+        *replies = received;
+    }
+    return true;
+}
+
+bool SingleInstance::listen()
+{
+    if (isListening()) {
+        return true;
+    }
+
+    if (!m_server) {
+        m_server = new QLocalServer(this);
+        m_server->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    }
+
+    const QString name = serverName();
+    if (m_server->listen(name)) {
+        return true;
+    }
+
+    if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        // A live instance answers; a crashed one only left its socket file
+        QLocalSocket probe;
+        probe.connectToServer(name);
+        if (probe.waitForConnected(CONNECT_TIMEOUT_MS)) {
+            qWarning() << "SingleInstance: Another instance is already listening on" << name;
+            return false;
+        }
+        QLocalServer::removeServer(name);
+        if (m_server->listen(name)) {
+            return true;
+        }
+    }
+
+    qWarning() << "SingleInstance: Cannot listen on" << name << ":" << m_server->errorString();
+    return false;
+}
+
+bool SingleInstance::isListening() const
+{
+    return m_server && m_server->isListening();
+}
+
+void SingleInstance::setHandler(Handler handler)
+{
+    m_handler = std::move(handler);
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { processRequests(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        processRequests(socket);
+    }
+}
+
+void SingleInstance::processRequests(QLocalSocket* socket)
+{
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (!line.isEmpty()) {
+            socket->write(encode(handle(line)));
+        }
+    }
+
+    // A partial line this long is not a request
+    if (socket->bytesAvailable() > MAX_REQUEST_BYTES) {
+        qWarning() << "SingleInstance: Dropping a client that sent an oversized request";
+        socket->abort();
+    }
+}
+
+QJsonObject SingleInstance::handle(const QByteArray& line) const
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        return failure("Malformed request");
+    }
+    if (!m_handler) {
+        return failure("Not ready");
+    }
+
+    QJsonObject reply = m_handler(document.object());
+    if (!reply.contains("ok")) {
+        reply.insert("ok", true);
+    }
+    return reply;
+}
+
+} // namespace DarkPlay::Core
@@ -0,0 +1,66 @@
+#include "core/StartupProfiler.h"
+#include <QDebug>
+
+namespace DarkPlay::Core {
+
+StartupProfiler::ScopedPhase::ScopedPhase(StartupProfiler* profiler, const QString& name)
+    : m_profiler(profiler)
+    , m_index(profiler ? profiler->beginPhase(name) : -1)
+{
+}
+
+StartupProfiler::ScopedPhase::~ScopedPhase()
+{
+    if (m_profiler) {
+        m_profiler->endPhase(m_index);
+    }
+}
+
+StartupProfiler::StartupProfiler()
+    : m_depth(0)
+    , m_reported(false)
+{
+    m_clock.start();
+}
+
+int StartupProfiler::beginPhase(const QString& name)
+{
+    Phase phase;
+    phase.name = name;
+    phase.depth = m_depth++;
+    phase.startNs = m_clock.nsecsElapsed();
+    m_phases.push_back(std::move(phase));
+    return static_cast<int>(m_phases.size()) - 1;
+}
+
+void StartupProfiler::endPhase(int index)
+{
+    if (index < 0 || index >= static_cast<int>(m_phases.size()) || m_phases[index].durationNs >= 0) {
+        return;
+    }
+
+    m_phases[index].durationNs = m_clock.nsecsElapsed() - m_phases[index].startNs;
+    m_depth = qMax(0, m_depth - 1);
+}
+
+void StartupProfiler::report()
+{
+    if (m_reported) {
+        return;
+    }
+    m_reported = true;
+
+    const qint64 totalNs = m_clock.nsecsElapsed();
+    qInfo().noquote() << QString("Startup timing: %1 ms to first event loop iteration")
+                             .arg(totalNs / 1e6, 0, 'f', 1);
+
+    for (const Phase& phase : m_phases) {
+        const QString label = QString(phase.depth * 2, ' ') + phase.name;
+        const QString duration = phase.durationNs >= 0
+                                     ? QString("%1 ms").arg(phase.durationNs / 1e6, 8, 'f', 1)
+                                     : QString("(unfinished)");
+        qInfo().noquote() << QString("  %1 %2").arg(label, -32).arg(duration);
+    }
+}
+
+} // namespace DarkPlay::Core
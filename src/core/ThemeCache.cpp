@@ -0,0 +1,193 @@
+#include "core/ThemeCache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace DarkPlay::Core {
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x44505443; // "DPTC"
+
+QDataStream& operator<<(QDataStream& stream, const ThemeCache::CompiledTheme& theme)
+{
+    return stream << theme.name << theme.colors << theme.styleSheet << theme.styleSheetPath << theme.styleSheetHash;
+}
+
+QDataStream& operator>>(QDataStream& stream, ThemeCache::CompiledTheme& theme)
+{
+    return stream >> theme.name >> theme.colors >> theme.styleSheet >> theme.styleSheetPath >> theme.styleSheetHash;
+}
+
+} // namespace
+
+ThemeCache::ThemeCache()
+    : m_loaded(false)
+    , m_dirty(false)
+{
+}
+
+ThemeCache::~ThemeCache()
+{
+    save();
+}
+
+std::optional<ThemeCache::CompiledTheme> ThemeCache::theme(const QByteArray& sourceHash)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoadedLocked();
+
+    const auto it = m_themes.constFind(sourceHash);
+    if (it == m_themes.cend()) {
+        return std::nullopt;
+    }
+
+    // The theme file is unchanged, but the stylesheet it pulls in may not be
+    if (!it->styleSheetPath.isEmpty()) {
+        QFile file(it->styleSheetPath);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text) || hash(file.readAll()) != it->styleSheetHash) {
+            m_themes.erase(it);
+            m_dirty = true;
+            return std::nullopt;
+        }
+    }
+    return *it;
+}
+
+void ThemeCache::storeTheme(const QByteArray& sourceHash, const CompiledTheme& theme)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoadedLocked();
+
+    // A handful of themes at most; an overflowing cache just starts over
+    if (m_themes.size() >= MAX_THEMES) {
+        m_themes.clear();
+    }
+    m_themes.insert(sourceHash, theme);
+    m_dirty = true;
+}
+
+QString ThemeCache::styleSheet(const QString& key, const std::function<QString()>& generate)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_styleSheets.find(key);
+    if (it == m_styleSheets.end()) {
+        it = m_styleSheets.insert(key, generate());
+    }
+    return *it;
+}
+
+void ThemeCache::save()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty) {
+        return;
+    }
+    m_dirty = false;
+
+    const QString path = indexPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "ThemeCache: Cannot write" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << INDEX_MAGIC << qint32(INDEX_FORMAT_VERSION) << qint32(m_themes.size());
+    for (auto it = m_themes.cbegin(); it != m_themes.cend(); ++it) {
+        stream << it.key() << it.value();
+    }
+
+    if (!file.commit()) {
+        qWarning() << "ThemeCache: Failed to save compiled themes";
+    }
+}
+
+qint64 ThemeCache::memoryBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = 0;
+    for (auto it = m_themes.cbegin(); it != m_themes.cend(); ++it) {
+        bytes += themeBytes(it.key(), it.value());
+    }
+    return bytes;
+}
+
+qint64 ThemeCache::release()
+{
+    // Unsaved themes would be lost, so they go to disk first
+    save();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_dirty) {
+        return 0; // Stored again while we were saving
+    }
+    qint64 freed = 0;
+    for (auto it = m_themes.cbegin(); it != m_themes.cend(); ++it) {
+        freed += themeBytes(it.key(), it.value());
+    }
+    m_themes.clear();
+    m_loaded = false;
+    return freed;
+}
+
+QByteArray ThemeCache::hash(const QByteArray& contents)
+{
+    return QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+}
+
+void ThemeCache::ensureLoadedLocked()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_FORMAT_VERSION || count < 0 || count > MAX_THEMES) {
+        return;
+    }
+
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QByteArray sourceHash;
+        CompiledTheme theme;
+        stream >> sourceHash >> theme;
+        if (stream.status() == QDataStream::Ok) {
+            m_themes.insert(sourceHash, theme);
+        }
+    }
+}
+
+QString ThemeCache::indexPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/themes.cache";
+}
+
+qint64 ThemeCache::themeBytes(const QByteArray& sourceHash, const CompiledTheme& theme)
+{
+    const qsizetype characters = theme.name.size() + theme.styleSheet.size() + theme.styleSheetPath.size();
+    return THEME_OVERHEAD_BYTES + sourceHash.size() + theme.styleSheetHash.size()
+        + characters * static_cast<qint64>(sizeof(QChar)) + theme.colors.size() * COLOR_BYTES;
+}
+
+} // namespace DarkPlay::Core
@@ -1,17 +1,21 @@
 #include "core/ThemeManager.h"
+#include "utils/Trace.h"
 
 #include <QApplication>
 #include <QStyleHints>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QSettings>
 #include <QDir>
 #include <QFileInfo>
+#include <QReadLocker>
 #include <QWriteLocker>
 #include <QMutexLocker>
 #include <QWidget>
+#include <algorithm>
 
 #ifdef Q_OS_WIN
 #include <QSettings>
@@ -30,6 +34,17 @@ ThemeManager::ThemeManager(QObject* parent)
     loadAutoTheme();
 
     m_initialized.store(true, std::memory_order_release);
+
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->registerConsumer("Themes", this);
+    }
+}
+
+ThemeManager::~ThemeManager()
+{
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->unregisterConsumer(this);
+    }
 }
 
 bool ThemeManager::loadTheme(const QString& themeName) noexcept
@@ -59,14 +74,23 @@ bool ThemeManager::loadTheme(ThemeType themeType) noexcept
 
 bool ThemeManager::loadAutoTheme() noexcept
 {
+    DARKPLAY_TRACE_SCOPE("theme", "applyTheme");
+
     try {
+        QElapsedTimer timer;
+        timer.start();
+
         auto themeData = std::make_unique<ThemeData>();
         themeData->name = "auto";
         themeData->type = ThemeType::Auto;
 
         // Apply system theme colors and palette
         bool isDark = m_isSystemDark.load();
-        themeData->palette = isDark ? createDarkPalette() : createLightPalette();
+        std::optional<QPalette>& cachedPalette = isDark ? m_darkPalette : m_lightPalette;
+        if (!cachedPalette) {
+            cachedPalette = isDark ? createDarkPalette() : createLightPalette();
+        }
+        themeData->palette = *cachedPalette;
 
         // Set basic theme colors
         QJsonObject colors;
@@ -84,20 +108,36 @@ bool ThemeManager::loadAutoTheme() noexcept
         themeData->colors = colors;
 
         // Apply the theme
+        bool unchanged = false;
         {
             QMutexLocker locker(&m_currentThemeMutex);
-            m_currentTheme = themeData->name;
-            m_currentThemeType = themeData->type;
-            m_currentThemeData = std::move(themeData);
+            unchanged = m_currentThemeData && m_currentThemeData->name == themeData->name
+                && m_currentThemeData->colors == themeData->colors
+                && m_currentThemeData->palette == themeData->palette;
+            if (!unchanged) {
+                m_currentTheme = themeData->name;
+                m_currentThemeType = themeData->type;
+                m_currentThemeData = std::move(themeData);
+            }
         }
 
-        // Apply palette to application
-        QApplication::setPalette(m_currentThemeData->palette);
+        // Nothing to restyle: skip the application-wide polish entirely
+        if (unchanged) {
+            qDebug() << "ThemeManager: loadTheme unchanged, took" << timer.nsecsElapsed() / 1000 << "us";
+            return true;
+        }
+
+        // Setting the palette repolishes every widget, so only do it when it differs
+        if (QApplication::palette() != m_currentThemeData->palette) {
+            QApplication::setPalette(m_currentThemeData->palette);
+        }
 
         emit themeChanged(m_currentTheme);
         emit themeTypeChanged(m_currentThemeType);
         emit styleSheetChanged(m_currentThemeData->styleSheet);
 
+        qDebug() << "ThemeManager: loadTheme" << (isDark ? "dark" : "light") << "took"
+                 << timer.nsecsElapsed() / 1000 << "us";
         return true;
 
     } catch (const std::exception& e) {
@@ -300,52 +340,83 @@ QPalette ThemeManager::createDarkPalette() const noexcept
 
 bool ThemeManager::loadThemeFromFile(const QString& filePath) noexcept
 {
+    DARKPLAY_TRACE_SCOPE("theme", "loadThemeFromFile");
+
     if (filePath.isEmpty()) {
         emitError("Empty file path provided");
         return false;
     }
 
     try {
+        QElapsedTimer timer;
+        timer.start();
+
         QFile file(filePath);
         if (!file.open(QIODevice::ReadOnly)) {
             emitError(QString("Cannot open theme file: %1").arg(filePath));
             return false;
         }
 
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+        const QByteArray contents = file.readAll();
+        const QByteArray sourceHash = ThemeCache::hash(contents);
 
-        if (parseError.error != QJsonParseError::NoError) {
-            emitError(QString("JSON parse error in %1: %2").arg(filePath, parseError.errorString()));
-            return false;
-        }
+        auto theme = std::make_unique<ThemeData>();
+        theme->type = ThemeType::Auto;
+
+        // An unchanged file skips the JSON parse and the stylesheet read
+        m_cacheUsedMs.store(Utils::MemoryBudget::nowMs(), std::memory_order_relaxed);
+        const std::optional<ThemeCache::CompiledTheme> compiled = m_cache.theme(sourceHash);
+        if (compiled) {
+            theme->name = compiled->name;
+            theme->colors = compiled->colors;
+            theme->styleSheet = compiled->styleSheet;
+        } else {
+            QJsonParseError parseError;
+            QJsonDocument doc = QJsonDocument::fromJson(contents, &parseError);
 
-        const QJsonObject themeObj = doc.object();
+            if (parseError.error != QJsonParseError::NoError) {
+                emitError(QString("JSON parse error in %1: %2").arg(filePath, parseError.errorString()));
+                return false;
+            }
 
-        auto theme = std::make_unique<ThemeData>();
-        theme->name = themeObj["name"].toString();
-        theme->colors = themeObj["colors"].toObject();
+            const QJsonObject themeObj = doc.object();
 
-        if (theme->name.isEmpty()) {
-            emitError(QString("Theme name is empty in file: %1").arg(filePath));
-            return false;
-        }
+            theme->name = themeObj["name"].toString();
+            theme->colors = themeObj["colors"].toObject();
 
-        // Load stylesheet from a separate file or inline
-        if (themeObj.contains("stylesheetFile")) {
-            const QString styleSheetPath = QFileInfo(filePath).dir().absoluteFilePath(
-                themeObj["stylesheetFile"].toString());
-            theme->styleSheet = loadStyleSheetFromFile(styleSheetPath);
-        } else {
-            theme->styleSheet = themeObj["stylesheet"].toString();
-        }
+            if (theme->name.isEmpty()) {
+                emitError(QString("Theme name is empty in file: %1").arg(filePath));
+                return false;
+            }
 
-        if (!validateThemeData(*theme)) {
-            emitError(QString("Invalid theme data in file: %1").arg(filePath));
-            return false;
+            // Load stylesheet from a separate file or inline
+            ThemeCache::CompiledTheme entry;
+            if (themeObj.contains("stylesheetFile")) {
+                entry.styleSheetPath = QFileInfo(filePath).dir().absoluteFilePath(
+                    themeObj["stylesheetFile"].toString());
+                theme->styleSheet = loadStyleSheetFromFile(entry.styleSheetPath);
+                entry.styleSheetHash = ThemeCache::hash(theme->styleSheet.toUtf8());
+            } else {
+                theme->styleSheet = themeObj["stylesheet"].toString();
+            }
+
+            if (!validateThemeData(*theme)) {
+                emitError(QString("Invalid theme data in file: %1").arg(filePath));
+                return false;
+            }
+
+            entry.name = theme->name;
+            entry.colors = theme->colors;
+            entry.styleSheet = theme->styleSheet;
+            m_cache.storeTheme(sourceHash, entry);
+            m_cache.save();
         }
 
+        qDebug() << "ThemeManager: Loaded theme" << theme->name << (compiled ? "from cache" : "from source")
+                 << "in" << timer.nsecsElapsed() / 1000 << "us";
+
         // Store the theme
+        theme->lastUsedMs = Utils::MemoryBudget::nowMs();
         {
             QWriteLocker locker(&m_themesLock);
             m_themes[theme->name] = std::move(theme);
@@ -415,6 +486,11 @@ QString ThemeManager::getColor(const QString& colorName) const
     }
 }
 
+QString ThemeManager::cachedStyleSheet(const QString& key, const std::function<QString()>& generate)
+{
+    return m_cache.styleSheet(key, generate);
+}
+
 bool ThemeManager::isThemeValid(const QString& themeName) const noexcept
 {
     // Only "auto" theme is valid
@@ -439,6 +515,59 @@ bool ThemeManager::validateThemeData(const ThemeData& theme) noexcept
     return !theme.name.isEmpty();
 }
 
+qint64 ThemeManager::themeBytes(const ThemeData& theme) noexcept
+{
+    constexpr qint64 THEME_OVERHEAD_BYTES = 1024; // Palette and the node itself
+    constexpr qint64 COLOR_BYTES = 64;
+    return THEME_OVERHEAD_BYTES + (theme.name.size() + theme.styleSheet.size()) * static_cast<qint64>(sizeof(QChar))
+        + theme.colors.size() * COLOR_BYTES;
+}
+
+qint64 ThemeManager::memoryBytes() const
+{
+    qint64 bytes = m_cache.memoryBytes();
+    QReadLocker locker(&m_themesLock);
+    for (const auto& [name, theme] : m_themes) {
+        bytes += themeBytes(*theme);
+    }
+    return bytes;
+}
+
+qint64 ThemeManager::oldestUseMs() const
+{
+    // The current theme is a copy of its own, so every loaded file may go
+    QReadLocker locker(&m_themesLock);
+    qint64 oldest = -1;
+    for (const auto& [name, theme] : m_themes) {
+        if (oldest < 0 || theme->lastUsedMs < oldest) {
+            oldest = theme->lastUsedMs;
+        }
+    }
+    if (oldest < 0 && m_cache.memoryBytes() > 0) {
+        oldest = m_cacheUsedMs.load(std::memory_order_relaxed);
+    }
+    return oldest;
+}
+
+qint64 ThemeManager::evict(qint64 bytes)
+{
+    qint64 freed = 0;
+    {
+        QWriteLocker locker(&m_themesLock);
+        while (freed < bytes && !m_themes.empty()) {
+            auto oldest = std::min_element(m_themes.begin(), m_themes.end(), [](const auto& a, const auto& b) {
+                return a.second->lastUsedMs < b.second->lastUsedMs;
+            });
+            freed += themeBytes(*oldest->second);
+            m_themes.erase(oldest);
+        }
+    }
+    if (freed < bytes) {
+        freed += m_cache.release();
+    }
+    return freed;
+}
+
 void ThemeManager::emitError(const QString& error) const noexcept
 {
     try {
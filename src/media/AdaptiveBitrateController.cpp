@@ -0,0 +1,361 @@
+#include "media/AdaptiveBitrateController.h"
+#include <QDebug>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QHash>
+#include <algorithm>
+#include <memory>
+#include <optional>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr double THROUGHPUT_SMOOTHING = 0.5; // Measurements are rare, weigh the latest heavily
+
+// Attribute lists are comma separated, but quoted values (CODECS) may contain commas
+QHash<QString, QString> parseAttributes(QStringView list)
+{
+    QHash<QString, QString> attributes;
+    qsizetype position = 0;
+    while (position < list.size()) {
+        const qsizetype equals = list.indexOf(QLatin1Char('='), position);
+        if (equals < 0) {
+            break;
+        }
+        const QString name = list.mid(position, equals - position).trimmed().toString().toUpper();
+
+        qsizetype end = equals + 1;
+        QString value;
+        if (end < list.size() && list.at(end) == QLatin1Char('"')) {
+            const qsizetype closing = list.indexOf(QLatin1Char('"'), end + 1);
+            const qsizetype valueEnd = closing < 0 ? list.size() : closing;
+            value = list.mid(end + 1, valueEnd - end - 1).toString();
+            end = closing < 0 ? list.size() : closing + 1;
+        } else {
+            const qsizetype comma = list.indexOf(QLatin1Char(','), end);
+            const qsizetype valueEnd = comma < 0 ? list.size() : comma;
+            value = list.mid(end, valueEnd - end).trimmed().toString();
+            end = valueEnd;
+        }
+        attributes.insert(name, value);
+
+        const qsizetype comma = list.indexOf(QLatin1Char(','), end);
+        position = comma < 0 ? list.size() : comma + 1;
+    }
+    return attributes;
+}
+
+} // namespace
+
+AdaptiveBitrateController::AdaptiveBitrateController(const StreamingOptions& options, QObject* parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_current(-1)
+    , m_switches(0)
+    , m_throughputKbps(0.0)
+    , m_generation(0)
+    , m_playing(false)
+    , m_upswitchBackoffMs(UPSWITCH_STABLE_MS)
+{
+    m_clock.start();
+    m_upswitchTimer.setSingleShot(true);
+    connect(&m_upswitchTimer, &QTimer::timeout, this, &AdaptiveBitrateController::probeUpswitch);
+}
+
+AdaptiveBitrateController::~AdaptiveBitrateController()
+{
+    stop();
+}
+
+void AdaptiveBitrateController::start(const QUrl& playlistUrl)
+{
+    stop();
+
+    m_playlistUrl = playlistUrl;
+    m_variants.clear();
+    m_current = -1;
+    m_switches = 0;
+    m_recentStalls.clear();
+    m_upswitchBackoffMs = UPSWITCH_STABLE_MS;
+
+    QNetworkReply* reply = get(playlistUrl);
+    const quint64 generation = m_generation;
+    connect(reply, &QNetworkReply::finished, this, [this, reply, generation]() {
+        reply->deleteLater();
+        if (generation == m_generation) {
+            onMasterPlaylist(reply);
+        }
+    });
+}
+
+void AdaptiveBitrateController::stop()
+{
+    ++m_generation;
+    m_upswitchTimer.stop();
+    for (const QPointer<QNetworkReply>& reply : std::as_const(m_replies)) {
+        if (reply) {
+            reply->abort();
+        }
+    }
+    m_replies.clear();
+}
+
+void AdaptiveBitrateController::setPlaying(bool playing)
+{
+    m_playing = playing;
+    if (!playing) {
+        m_upswitchTimer.stop();
+    } else if (!m_upswitchTimer.isActive()) {
+        scheduleUpswitchProbe();
+    }
+}
+
+void AdaptiveBitrateController::reportStall()
+{
+    if (m_variants.size() < 2) {
+        return;
+    }
+
+    const qint64 now = m_clock.elapsed();
+    m_recentStalls.append(now);
+    m_recentStalls.removeIf([now](qint64 stall) { return now - stall > STALL_WINDOW_MS; });
+
+    if (m_recentStalls.size() >= STALLS_BEFORE_DOWNSWITCH) {
+        switchDown();
+    } else {
+        scheduleUpswitchProbe(); // Stability starts over
+    }
+}
+
+void AdaptiveBitrateController::reportLongStall()
+{
+    if (m_variants.size() >= 2) {
+        switchDown();
+    }
+}
+
+QList<HlsVariant> AdaptiveBitrateController::parseMasterPlaylist(const QByteArray& playlist, const QUrl& baseUrl)
+{
+    QList<HlsVariant> variants;
+    const QString text = QString::fromUtf8(playlist);
+    const QStringList lines = text.split(QLatin1Char('\n'));
+
+    std::optional<HlsVariant> pending;
+    for (const QString& rawLine : lines) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        if (line.startsWith(QLatin1String("#EXT-X-STREAM-INF:"))) {
+            const auto attributes = parseAttributes(QStringView(line).mid(18));
+            HlsVariant variant;
+            variant.bandwidth = attributes.value("BANDWIDTH").toLongLong();
+            variant.codecs = attributes.value("CODECS");
+            const QStringList size = attributes.value("RESOLUTION").split(QLatin1Char('x'));
+            if (size.size() == 2) {
+                variant.resolution = QSize(size.at(0).toInt(), size.at(1).toInt());
+            }
+            pending = variant;
+        } else if (!line.startsWith(QLatin1Char('#')) && pending) {
+            pending->url = baseUrl.resolved(QUrl(line));
+            variants.append(*pending);
+            pending.reset();
+        }
+    }
+
+    std::stable_sort(variants.begin(), variants.end(), [](const HlsVariant& a, const HlsVariant& b) {
+        return a.bandwidth < b.bandwidth;
+    });
+    return variants;
+}
+
+QUrl AdaptiveBitrateController::firstSegmentUrl(const QByteArray& playlist, const QUrl& baseUrl)
+{
+    const QString text = QString::fromUtf8(playlist);
+    for (const QString& rawLine : text.split(QLatin1Char('\n'))) {
+        const QString line = rawLine.trimmed();
+        if (!line.isEmpty() && !line.startsWith(QLatin1Char('#'))) {
+            return baseUrl.resolved(QUrl(line));
+        }
+    }
+    return {};
+}
+
+void AdaptiveBitrateController::onMasterPlaylist(QNetworkReply* reply)
+{
+    if (reply->error() != QNetworkReply::NoError) {
+        emit failed(QString("Cannot load stream playlist: %1").arg(reply->errorString()));
+        return;
+    }
+
+    m_variants = parseMasterPlaylist(reply->readAll(), reply->url());
+    if (m_variants.isEmpty()) {
+        emit variantSelected(m_playlistUrl, -1); // A media playlist: nothing to adapt
+        return;
+    }
+    if (m_variants.size() == 1) {
+        select(0);
+        return;
+    }
+
+    qDebug() << "ABR:" << m_variants.size() << "variants, measuring throughput";
+
+    // Start from what the link demonstrably sustains, never from the top
+    measureVariant(0, [this](bool ok, double kbps) {
+        if (ok) {
+            recordThroughput(kbps);
+        }
+        select(ok ? highestSustainable(m_throughputKbps) : 0);
+    });
+}
+
+void AdaptiveBitrateController::measureVariant(int index, MeasureCallback callback)
+{
+    const quint64 generation = m_generation;
+    QNetworkReply* playlistReply = get(m_variants.at(index).url);
+
+    connect(playlistReply, &QNetworkReply::finished, this, [this, playlistReply, generation, callback]() {
+        playlistReply->deleteLater();
+        if (generation != m_generation) {
+            return;
+        }
+
+        const QUrl segmentUrl = playlistReply->error() == QNetworkReply::NoError
+            ? firstSegmentUrl(playlistReply->readAll(), playlistReply->url()) : QUrl();
+        if (!segmentUrl.isValid()) {
+            callback(false, 0.0);
+            return;
+        }
+
+        // Time one segment (or its first couple of megabytes)
+        QNetworkReply* segmentReply = get(segmentUrl);
+        auto timer = std::make_shared<QElapsedTimer>();
+        auto received = std::make_shared<qint64>(0);
+        auto done = std::make_shared<bool>(false);
+        timer->start();
+
+        auto finish = [this, segmentReply, generation, callback, timer, received, done](bool ok) {
+            if (*done) {
+                return;
+            }
+            *done = true;
+            segmentReply->disconnect(this);
+            if (!segmentReply->isFinished()) {
+                segmentReply->abort();
+            }
+            segmentReply->deleteLater();
+            if (generation != m_generation) {
+                return;
+            }
+
+            const qint64 elapsedMs = std::max<qint64>(timer->elapsed(), 1);
+            const bool measured = ok && *received > 0;
+            callback(measured, measured ? static_cast<double>(*received) * 8.0 / static_cast<double>(elapsedMs) : 0.0);
+        };
+
+        connect(segmentReply, &QNetworkReply::readyRead, this, [segmentReply, received, finish]() {
+            *received += segmentReply->readAll().size();
+            if (*received >= MEASURE_MAX_BYTES) {
+                finish(true);
+            }
+        });
+        connect(segmentReply, &QNetworkReply::finished, this, [segmentReply, received, finish]() {
+            *received += segmentReply->readAll().size();
+            finish(segmentReply->error() == QNetworkReply::NoError);
+        });
+        QTimer::singleShot(MEASURE_TIMEOUT_MS, segmentReply, [finish]() { finish(true); });
+    });
+}
+
+void AdaptiveBitrateController::recordThroughput(double kbps)
+{
+    m_throughputKbps = m_throughputKbps > 0.0
+        ? m_throughputKbps + THROUGHPUT_SMOOTHING * (kbps - m_throughputKbps) : kbps;
+}
+
+int AdaptiveBitrateController::highestSustainable(double kbps) const
+{
+    int best = 0;
+    for (int i = 0; i < m_variants.size(); ++i) {
+        if (static_cast<double>(m_variants.at(i).bandwidth) <= kbps * 1000.0 * SAFETY_FACTOR) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void AdaptiveBitrateController::select(int index)
+{
+    if (index < 0 || index >= m_variants.size() || index == m_current) {
+        return;
+    }
+
+    if (m_current >= 0) {
+        ++m_switches;
+    }
+    qDebug() << "ABR: Variant" << index << "at" << m_variants.at(index).bandwidth / 1000 << "kbps"
+             << "(throughput" << qRound(m_throughputKbps) << "kbps)";
+
+    m_current = index;
+    m_recentStalls.clear();
+    emit variantSelected(m_variants.at(index).url, index);
+    scheduleUpswitchProbe();
+}
+
+void AdaptiveBitrateController::switchDown()
+{
+    if (m_current <= 0) {
+        return;
+    }
+
+    // We were too ambitious; wait longer before trying the higher variant again
+    m_upswitchBackoffMs = std::min(m_upswitchBackoffMs * 2, MAX_UPSWITCH_BACKOFF_MS);
+    select(m_current - 1);
+}
+
+void AdaptiveBitrateController::scheduleUpswitchProbe()
+{
+    if (m_playing && m_current >= 0 && m_current < m_variants.size() - 1) {
+        m_upswitchTimer.start(m_upswitchBackoffMs);
+    } else {
+        m_upswitchTimer.stop();
+    }
+}
+
+void AdaptiveBitrateController::probeUpswitch()
+{
+    const int candidate = m_current + 1;
+    if (candidate <= 0 || candidate >= m_variants.size()) {
+        return;
+    }
+
+    measureVariant(candidate, [this, candidate](bool ok, double kbps) {
+        if (ok) {
+            recordThroughput(kbps);
+        }
+        if (ok && candidate == m_current + 1
+            && static_cast<double>(m_variants.at(candidate).bandwidth) <= kbps * 1000.0 * SAFETY_FACTOR) {
+            m_upswitchBackoffMs = UPSWITCH_STABLE_MS;
+            select(candidate); // One step at a time
+            return;
+        }
+        m_upswitchBackoffMs = std::min(m_upswitchBackoffMs * 2, MAX_UPSWITCH_BACKOFF_MS);
+        scheduleUpswitchProbe();
+    });
+}
+
+QNetworkReply* AdaptiveBitrateController::get(const QUrl& url)
+{
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    request.setTransferTimeout(m_options.stallRecoveryMs * 2);
+
+    m_replies.removeIf([](const QPointer<QNetworkReply>& reply) { return reply.isNull(); });
+    QNetworkReply* reply = m_network.get(request);
+    m_replies.append(reply);
+    return reply;
+}
+
+} // namespace DarkPlay::Media
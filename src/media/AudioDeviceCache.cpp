@@ -0,0 +1,89 @@
+#include "media/AudioDeviceCache.h"
+#include <QCoreApplication>
+#include <QMediaDevices>
+#include <QPointer>
+#include <QThread>
+#include <QDebug>
+
+namespace DarkPlay::Media {
+
+AudioDeviceCache* AudioDeviceCache::instance()
+{
+    // Parented to the application so it dies before the multimedia backend
+    static QPointer<AudioDeviceCache> s_instance;
+    if (!s_instance) {
+        s_instance = new AudioDeviceCache(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+AudioDeviceCache::AudioDeviceCache(QObject* parent)
+    : QObject(parent)
+    , m_mediaDevices(nullptr)
+    , m_populated(false)
+{
+}
+
+QAudioDevice AudioDeviceCache::defaultOutput()
+{
+    ensurePopulated();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_defaultOutput;
+}
+
+QList<QAudioDevice> AudioDeviceCache::outputs()
+{
+    ensurePopulated();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_outputs;
+}
+
+void AudioDeviceCache::ensurePopulated()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_populated) {
+            return;
+        }
+
+        m_defaultOutput = QMediaDevices::defaultAudioOutput();
+        m_outputs = QMediaDevices::audioOutputs();
+        m_populated = true;
+
+        qDebug() << "AudioDeviceCache:" << m_outputs.size() << "output device(s), default:"
+                 << (m_defaultOutput.isNull() ? QString("none") : m_defaultOutput.description());
+    }
+
+    // Engines usually ask first, from the engine thread; the watcher belongs on ours
+    if (QThread::currentThread() == thread()) {
+        watchDevices();
+    } else {
+        QMetaObject::invokeMethod(this, &AudioDeviceCache::watchDevices, Qt::QueuedConnection);
+    }
+}
+
+void AudioDeviceCache::watchDevices()
+{
+    m_mediaDevices = new QMediaDevices(this);
+    connect(m_mediaDevices, &QMediaDevices::audioOutputsChanged,
+            this, &AudioDeviceCache::onAudioOutputsChanged);
+}
+
+void AudioDeviceCache::onAudioOutputsChanged()
+{
+    const QAudioDevice defaultOutput = QMediaDevices::defaultAudioOutput();
+    bool defaultChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        defaultChanged = defaultOutput != m_defaultOutput;
+        m_defaultOutput = defaultOutput;
+        m_outputs = QMediaDevices::audioOutputs();
+    }
+
+    emit outputsChanged();
+    if (defaultChanged) {
+        emit defaultOutputChanged(defaultOutput);
+    }
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,877 @@
+#include "media/AudioKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DARKPLAY_KERNELS_AVX2 1
+#include <immintrin.h>
+#define DARKPLAY_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define DARKPLAY_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace DarkPlay::Media::AudioKernels {
+
+namespace {
+
+constexpr float INT16_TO_FLOAT = 1.0f / 32768.0f;
+constexpr float FLOAT_TO_INT16 = 32767.0f;
+constexpr float SURROUND_MIX = 0.70710678f; // -3 dB, ITU-R BS.775
+constexpr float DOWNMIX_51_NORM = 1.0f / (1.0f + 2.0f * SURROUND_MIX);
+constexpr float DOWNMIX_71_NORM = 1.0f / (1.0f + 3.0f * SURROUND_MIX);
+constexpr double PI = 3.14159265358979323846;
+
+struct KernelTable {
+    InstructionSet set;
+    void (*applyGain)(float*, size_t, float) noexcept;
+    void (*applyGainRamp)(float*, size_t, int, float, float) noexcept;
+    void (*int16ToFloat)(const int16_t*, float*, size_t) noexcept;
+    void (*floatToInt16)(const float*, int16_t*, size_t) noexcept;
+    bool (*downmixToStereo)(const float*, float*, size_t, int) noexcept;
+    float (*dotProduct)(const float*, const float*, size_t) noexcept;
+};
+
+// Scalar reference kernels - also the tail handlers of the vector paths
+
+void applyGainScalar(float* samples, size_t count, float gain) noexcept
+{
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] *= gain;
+    }
+}
+
+void applyGainRampScalar(float* samples, size_t frames, int channels, float startGain, float endGain) noexcept
+{
+    if (frames == 0 || channels <= 0) {
+        return;
+    }
+
+    const float step = (endGain - startGain) / static_cast<float>(frames);
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const float gain = startGain + step * static_cast<float>(frame);
+        float* out = samples + frame * channels;
+        for (int c = 0; c < channels; ++c) {
+            out[c] *= gain;
+        }
+    }
+}
+
+void int16ToFloatScalar(const int16_t* input, float* output, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = static_cast<float>(input[i]) * INT16_TO_FLOAT;
+    }
+}
+
+void floatToInt16Scalar(const float* input, int16_t* output, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; ++i) {
+        const float scaled = std::clamp(input[i], -1.0f, 1.0f) * FLOAT_TO_INT16;
+        output[i] = static_cast<int16_t>(std::lrint(scaled));
+    }
+}
+
+void downmixFramesScalar(const float* input, float* output, size_t begin, size_t frames, int inputChannels) noexcept
+{
+    const bool sevenOne = inputChannels == 8;
+    const float norm = sevenOne ? DOWNMIX_71_NORM : DOWNMIX_51_NORM;
+
+    for (size_t frame = begin; frame < frames; ++frame) {
+        const float* in = input + frame * inputChannels;
+        const float center = SURROUND_MIX * in[2];
+        float left = in[0] + center + SURROUND_MIX * in[4];
+        float right = in[1] + center + SURROUND_MIX * in[5];
+        if (sevenOne) {
+            left += SURROUND_MIX * in[6];
+            right += SURROUND_MIX * in[7];
+        }
+        output[frame * 2] = left * norm;
+        output[frame * 2 + 1] = right * norm;
+    }
+}
+
+bool downmixToStereoScalar(const float* input, float* output, size_t frames, int inputChannels) noexcept
+{
+    if (inputChannels != 6 && inputChannels != 8) {
+        return false;
+    }
+    downmixFramesScalar(input, output, 0, frames, inputChannels);
+    return true;
+}
+
+float dotProductScalar(const float* a, const float* b, size_t count) noexcept
+{
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#ifdef DARKPLAY_KERNELS_AVX2
+
+DARKPLAY_TARGET_AVX2 void applyGainAvx2(float* samples, size_t count, float gain) noexcept
+{
+    const __m256 factor = _mm256_set1_ps(gain);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), factor));
+    }
+    applyGainScalar(samples + i, count - i, gain);
+}
+
+DARKPLAY_TARGET_AVX2 void applyGainRampAvx2(float* samples, size_t frames, int channels,
+                                            float startGain, float endGain) noexcept
+{
+    // A vector must hold whole frames so the per-lane frame offset is constant
+    if (frames == 0 || channels <= 0 || 8 % channels != 0) {
+        applyGainRampScalar(samples, frames, channels, startGain, endGain);
+        return;
+    }
+
+    const float step = (endGain - startGain) / static_cast<float>(frames);
+    alignas(32) float laneFrames[8];
+    for (int lane = 0; lane < 8; ++lane) {
+        laneFrames[lane] = static_cast<float>(lane / channels);
+    }
+
+    const __m256 offsets = _mm256_load_ps(laneFrames);
+    const __m256 steps = _mm256_set1_ps(step);
+    const __m256 starts = _mm256_set1_ps(startGain);
+    const size_t framesPerVector = 8 / channels;
+    const size_t count = frames * channels;
+
+    size_t i = 0;
+    size_t frame = 0;
+    for (; i + 8 <= count; i += 8, frame += framesPerVector) {
+        // Gains are recomputed from the frame index, never accumulated, so long ramps don't drift
+        const __m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(frame)), offsets);
+        const __m256 gain = _mm256_fmadd_ps(index, steps, starts);
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), gain));
+    }
+    for (; i < count; ++i) {
+        samples[i] *= startGain + step * static_cast<float>(i / channels);
+    }
+}
+
+DARKPLAY_TARGET_AVX2 void int16ToFloatAvx2(const int16_t* input, float* output, size_t count) noexcept
+{
+    const __m256 scale = _mm256_set1_ps(INT16_TO_FLOAT);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(values, scale));
+    }
+    int16ToFloatScalar(input + i, output + i, count - i);
+}
+
+DARKPLAY_TARGET_AVX2 void floatToInt16Avx2(const float* input, int16_t* output, size_t count) noexcept
+{
+    const __m256 scale = _mm256_set1_ps(FLOAT_TO_INT16);
+    const __m256 low = _mm256_set1_ps(-1.0f);
+    const __m256 high = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256 a = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i), low), high), scale);
+        const __m256 b = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i + 8), low), high), scale);
+        // packs works per 128-bit lane; restore sample order afterwards
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+
+// Two 4-float loads, one per 128-bit lane
+DARKPLAY_TARGET_AVX2 inline __m256 loadLanes(const float* low, const float* high) noexcept
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+// Each lane holds one frame: front = FL FR C LFE, back = BL BR SL SR (7.1) or C LFE BL BR (5.1).
+// With LFE swapped for C, front * frontWeights + back * backWeights = [L0, R0, L1, R1], so
+// L = s0 + s2 and R = s1 + s3
+DARKPLAY_TARGET_AVX2 inline void downmixFourFramesAvx2(const float* input, float* output, size_t stride,
+                                                       size_t backOffset, __m256 frontWeights,
+                                                       __m256 backWeights) noexcept
+{
+    const float* f0 = input;
+    const float* f1 = f0 + stride;
+    const float* f2 = f1 + stride;
+    const float* f3 = f2 + stride;
+
+    // Frames 0/2 and 1/3 share a vector so the final shuffle yields them in order
+    const __m256 even = _mm256_fmadd_ps(loadLanes(f0 + backOffset, f2 + backOffset), backWeights,
+                                        _mm256_mul_ps(_mm256_permute_ps(loadLanes(f0, f2), 0xA4), frontWeights));
+    const __m256 odd = _mm256_fmadd_ps(loadLanes(f1 + backOffset, f3 + backOffset), backWeights,
+                                       _mm256_mul_ps(_mm256_permute_ps(loadLanes(f1, f3), 0xA4), frontWeights));
+
+    const __m256 first = _mm256_shuffle_ps(even, odd, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 second = _mm256_shuffle_ps(even, odd, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm256_storeu_ps(output, _mm256_add_ps(first, second));
+}
+
+DARKPLAY_TARGET_AVX2 bool downmixToStereoAvx2(const float* input, float* output, size_t frames, int inputChannels) noexcept
+{
+    if (inputChannels != 6 && inputChannels != 8) {
+        return false;
+    }
+
+    // Plain loads and in-lane shuffles; strided gathers were slower than the scalar loop.
+    // The normalisation is folded into the weights
+    const bool sevenOne = inputChannels == 8;
+    const float norm = sevenOne ? DOWNMIX_71_NORM : DOWNMIX_51_NORM;
+    const float mix = SURROUND_MIX * norm;
+    const size_t backOffset = sevenOne ? 4 : 2;
+    const __m256 frontWeights = _mm256_setr_ps(norm, norm, mix, mix, norm, norm, mix, mix);
+    const __m256 backWeights = sevenOne ? _mm256_set1_ps(mix)
+                                        : _mm256_setr_ps(0.0f, 0.0f, mix, mix, 0.0f, 0.0f, mix, mix);
+
+    const size_t stride = static_cast<size_t>(inputChannels);
+    size_t frame = 0;
+    for (; frame + 8 <= frames; frame += 8) {
+        downmixFourFramesAvx2(input + frame * stride, output + frame * 2, stride, backOffset, frontWeights, backWeights);
+        downmixFourFramesAvx2(input + (frame + 4) * stride, output + frame * 2 + 8, stride, backOffset,
+                              frontWeights, backWeights);
+    }
+    for (; frame + 4 <= frames; frame += 4) {
+        downmixFourFramesAvx2(input + frame * stride, output + frame * 2, stride, backOffset, frontWeights, backWeights);
+    }
+    downmixFramesScalar(input, output, frame, frames, inputChannels);
+    return true;
+}
+
+DARKPLAY_TARGET_AVX2 float dotProductAvx2(const float* a, const float* b, size_t count) noexcept
+{
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    for (; i + 8 <= count; i += 8) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    }
+
+    const __m256 sum = _mm256_add_ps(sum0, sum1);
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_hadd_ps(half, half);
+    half = _mm_hadd_ps(half, half);
+    return _mm_cvtss_f32(half) + dotProductScalar(a + i, b + i, count - i);
+}
+
+constexpr KernelTable AVX2_KERNELS{
+    InstructionSet::AVX2,
+    &applyGainAvx2,
+    &applyGainRampAvx2,
+    &int16ToFloatAvx2,
+    &floatToInt16Avx2,
+    &downmixToStereoAvx2,
+    &dotProductAvx2
+};
+
+#endif // DARKPLAY_KERNELS_AVX2
+
+#ifdef DARKPLAY_KERNELS_NEON
+
+void applyGainNeon(float* samples, size_t count, float gain) noexcept
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+    }
+    applyGainScalar(samples + i, count - i, gain);
+}
+
+void applyGainRampNeon(float* samples, size_t frames, int channels, float startGain, float endGain) noexcept
+{
+    if (frames == 0 || channels <= 0 || 4 % channels != 0) {
+        applyGainRampScalar(samples, frames, channels, startGain, endGain);
+        return;
+    }
+
+    const float step = (endGain - startGain) / static_cast<float>(frames);
+    float laneFrames[4];
+    for (int lane = 0; lane < 4; ++lane) {
+        laneFrames[lane] = static_cast<float>(lane / channels);
+    }
+
+    const float32x4_t offsets = vld1q_f32(laneFrames);
+    const float32x4_t steps = vdupq_n_f32(step);
+    const float32x4_t starts = vdupq_n_f32(startGain);
+    const size_t framesPerVector = 4 / channels;
+    const size_t count = frames * channels;
+
+    size_t i = 0;
+    size_t frame = 0;
+    for (; i + 4 <= count; i += 4, frame += framesPerVector) {
+        const float32x4_t index = vaddq_f32(vdupq_n_f32(static_cast<float>(frame)), offsets);
+        const float32x4_t gain = vfmaq_f32(starts, index, steps);
+        vst1q_f32(samples + i, vmulq_f32(vld1q_f32(samples + i), gain));
+    }
+    for (; i < count; ++i) {
+        samples[i] *= startGain + step * static_cast<float>(i / channels);
+    }
+}
+
+void int16ToFloatNeon(const int16_t* input, float* output, size_t count) noexcept
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const int16x8_t raw = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw))), INT16_TO_FLOAT));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw))), INT16_TO_FLOAT));
+    }
+    int16ToFloatScalar(input + i, output + i, count - i);
+}
+
+void floatToInt16Neon(const float* input, int16_t* output, size_t count) noexcept
+{
+    const float32x4_t low = vdupq_n_f32(-1.0f);
+    const float32x4_t high = vdupq_n_f32(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const float32x4_t a = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(input + i), low), high), FLOAT_TO_INT16);
+        const float32x4_t b = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(input + i + 4), low), high), FLOAT_TO_INT16);
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+    }
+    floatToInt16Scalar(input + i, output + i, count - i);
+}
+
+float dotProductNeon(const float* a, const float* b, size_t count) noexcept
+{
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(sum0, sum1)) + dotProductScalar(a + i, b + i, count - i);
+}
+
+// No strided NEON load fits six or eight channels; the scalar downmix auto-vectorises well enough
+constexpr KernelTable NEON_KERNELS{
+    InstructionSet::NEON,
+    &applyGainNeon,
+    &applyGainRampNeon,
+    &int16ToFloatNeon,
+    &floatToInt16Neon,
+    &downmixToStereoScalar,
+    &dotProductNeon
+};
+
+#endif // DARKPLAY_KERNELS_NEON
+
+constexpr KernelTable SCALAR_KERNELS{
+    InstructionSet::Scalar,
+    &applyGainScalar,
+    &applyGainRampScalar,
+    &int16ToFloatScalar,
+    &floatToInt16Scalar,
+    &downmixToStereoScalar,
+    &dotProductScalar
+};
+
+const KernelTable* tableFor(InstructionSet set) noexcept
+{
+    switch (set) {
+    case InstructionSet::Scalar:
+        return &SCALAR_KERNELS;
+    case InstructionSet::AVX2:
+#ifdef DARKPLAY_KERNELS_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return &AVX2_KERNELS;
+        }
+#endif
+        return nullptr;
+    case InstructionSet::NEON:
+#ifdef DARKPLAY_KERNELS_NEON
+        return &NEON_KERNELS; // Mandatory on AArch64
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+const KernelTable* bestTable() noexcept
+{
+    for (InstructionSet set : {InstructionSet::AVX2, InstructionSet::NEON}) {
+        if (const KernelTable* table = tableFor(set)) {
+            return table;
+        }
+    }
+    return &SCALAR_KERNELS;
+}
+
+std::atomic<const KernelTable*> s_kernels{nullptr};
+
+const KernelTable& kernels() noexcept
+{
+    const KernelTable* table = s_kernels.load(std::memory_order_acquire);
+    if (!table) {
+        // Racing first callers all store the same table
+        table = bestTable();
+        s_kernels.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+} // namespace
+
+InstructionSet activeInstructionSet() noexcept
+{
+    return kernels().set;
+}
+
+bool isSupported(InstructionSet set) noexcept
+{
+    return tableFor(set) != nullptr;
+}
+
+const char* instructionSetName(InstructionSet set) noexcept
+{
+    switch (set) {
+    case InstructionSet::Scalar:
+        return "scalar";
+    case InstructionSet::AVX2:
+        return "AVX2";
+    case InstructionSet::NEON:
+        return "NEON";
+    }
+    return "unknown";
+}
+
+InstructionSet setInstructionSet(InstructionSet set) noexcept
+{
+    if (const KernelTable* table = tableFor(set)) {
+        s_kernels.store(table, std::memory_order_release);
+    }
+    return activeInstructionSet();
+}
+
+void applyGain(float* samples, size_t count, float gain) noexcept
+{
+    kernels().applyGain(samples, count, gain);
+}
+
+void applyGainRamp(float* samples, size_t frames, int channels, float startGain, float endGain) noexcept
+{
+    kernels().applyGainRamp(samples, frames, channels, startGain, endGain);
+}
+
+void int16ToFloat(const int16_t* input, float* output, size_t count) noexcept
+{
+    kernels().int16ToFloat(input, output, count);
+}
+
+void floatToInt16(const float* input, int16_t* output, size_t count) noexcept
+{
+    kernels().floatToInt16(input, output, count);
+}
+
+bool downmixToStereo(const float* input, float* output, size_t frames, int inputChannels) noexcept
+{
+    return kernels().downmixToStereo(input, output, frames, inputChannels);
+}
+
+float dotProduct(const float* a, const float* b, size_t count) noexcept
+{
+    return kernels().dotProduct(a, b, count);
+}
+
+// GainRamp
+
+GainRamp::GainRamp(int rampFrames, float initialGain) noexcept
+    : m_rampFrames(std::max(0, rampFrames))
+    , m_current(initialGain)
+    , m_target(initialGain)
+    , m_remaining(0)
+{
+}
+
+void GainRamp::setTarget(float gain) noexcept
+{
+    if (gain == m_target) {
+        return;
+    }
+
+    m_target = gain;
+    m_remaining = static_cast<size_t>(m_rampFrames);
+    if (m_remaining == 0) {
+        m_current = gain;
+    }
+}
+
+void GainRamp::reset(float gain) noexcept
+{
+    m_current = gain;
+    m_target = gain;
+    m_remaining = 0;
+}
+
+void GainRamp::process(float* samples, size_t frames, int channels) noexcept
+{
+    if (frames == 0 || channels <= 0) {
+        return;
+    }
+
+    size_t done = 0;
+    if (m_remaining > 0) {
+        done = std::min(frames, m_remaining);
+        const float end = m_current + (m_target - m_current) * (static_cast<float>(done) / static_cast<float>(m_remaining));
+        applyGainRamp(samples, done, channels, m_current, end);
+        m_remaining -= done;
+        m_current = m_remaining == 0 ? m_target : end;
+    }
+
+    if (done < frames && m_current != 1.0f) {
+        applyGain(samples + done * channels, (frames - done) * channels, m_current);
+    }
+}
+
+// SincResampler
+
+SincResampler::SincResampler(int channels, size_t maxInputFrames, int taps, int phases)
+    : m_channels(std::max(1, channels))
+    , m_taps(std::max(4, (taps + 1) & ~1)) // Even, so the kernel is centred between two inputs
+    , m_phases(std::max(1, phases))
+    , m_maxInputFrames(maxInputFrames)
+    , m_ratio(1.0)
+    , m_position(0.0)
+    , m_filter(static_cast<size_t>(m_phases + 1) * m_taps)
+    , m_kernel(m_taps)
+    , m_historyFrames(0)
+{
+    // Worst case left over between calls is one kernel plus one output step
+    const size_t historyCapacity = maxInputFrames + m_taps + static_cast<size_t>(std::ceil(MAX_RATIO)) + 1;
+    m_history.assign(m_channels, std::vector<float>(historyCapacity, 0.0f));
+
+    buildFilter();
+    reset();
+}
+
+void SincResampler::setRatio(double ratio) noexcept
+{
+    ratio = std::clamp(ratio, MIN_RATIO, MAX_RATIO);
+    if (ratio == m_ratio) {
+        return;
+    }
+
+    m_ratio = ratio;
+    buildFilter();
+}
+
+void SincResampler::reset() noexcept
+{
+    // Start with half a kernel of silence so the first input frame is the first output point
+    const size_t half = m_taps / 2;
+    for (auto& row : m_history) {
+        std::fill(row.begin(), row.end(), 0.0f);
+    }
+    m_historyFrames = half - 1;
+    m_position = static_cast<double>(half - 1);
+}
+
+size_t SincResampler::maxOutputFrames(size_t inputFrames) const noexcept
+{
+    return static_cast<size_t>(std::ceil(static_cast<double>(inputFrames) / m_ratio)) + 2;
+}
+
+size_t SincResampler::process(const float* input, size_t inputFrames, float* output, size_t outputCapacity) noexcept
+{
+    const auto channels = static_cast<size_t>(m_channels);
+    const auto taps = static_cast<size_t>(m_taps);
+    const size_t half = taps / 2;
+
+    inputFrames = std::min({inputFrames, m_maxInputFrames, m_history.front().size() - m_historyFrames});
+
+    // Deinterleave into the planar history so each tap run is one contiguous dot product
+    for (size_t c = 0; c < channels; ++c) {
+        float* row = m_history[c].data() + m_historyFrames;
+        for (size_t frame = 0; frame < inputFrames; ++frame) {
+            row[frame] = input[frame * channels + c];
+        }
+    }
+    m_historyFrames += inputFrames;
+
+    size_t written = 0;
+    while (written < outputCapacity) {
+        const auto index = static_cast<size_t>(m_position);
+        if (index + half >= m_historyFrames) {
+            break; // Needs input that has not arrived yet
+        }
+
+        // Interpolate between the two nearest filter phases
+        const double phase = (m_position - static_cast<double>(index)) * m_phases;
+        const auto row = static_cast<size_t>(phase);
+        const auto mix = static_cast<float>(phase - static_cast<double>(row));
+        const float* lower = m_filter.data() + row * taps;
+        const float* upper = lower + taps;
+        for (size_t t = 0; t < taps; ++t) {
+            m_kernel[t] = lower[t] + (upper[t] - lower[t]) * mix;
+        }
+
+        const size_t first = index + 1 - half;
+        float* out = output + written * channels;
+        for (size_t c = 0; c < channels; ++c) {
+            out[c] = dotProduct(m_kernel.data(), m_history[c].data() + first, taps);
+        }
+
+        ++written;
+        m_position += m_ratio;
+    }
+
+    // Keep only the frames the next output point still reaches back to
+    const size_t consumed = std::min(static_cast<size_t>(m_position) + 1 - half, m_historyFrames);
+    if (consumed > 0) {
+        for (auto& row : m_history) {
+            std::copy(row.begin() + consumed, row.begin() + m_historyFrames, row.begin());
+        }
+        m_historyFrames -= consumed;
+        m_position -= static_cast<double>(consumed);
+    }
+
+    return written;
+}
+
+void SincResampler::buildFilter() noexcept
+{
+    // Blackman-windowed sinc; the cutoff drops below Nyquist when downsampling
+    const double cutoff = std::min(1.0, 1.0 / m_ratio);
+    const double half = m_taps / 2.0;
+    const auto taps = static_cast<size_t>(m_taps);
+
+    for (int row = 0; row <= m_phases; ++row) {
+        float* coefficients = m_filter.data() + static_cast<size_t>(row) * taps;
+        const double fraction = static_cast<double>(row) / m_phases;
+        double sum = 0.0;
+
+        for (size_t t = 0; t < taps; ++t) {
+            const double x = static_cast<double>(t) - half + 1.0 - fraction;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(PI * cutoff * x) / (PI * cutoff * x);
+            const double window = 0.42 + 0.5 * std::cos(PI * x / half) + 0.08 * std::cos(2.0 * PI * x / half);
+            const double value = sinc * std::max(0.0, window);
+            coefficients[t] = static_cast<float>(value);
+            sum += value;
+        }
+
+        // Unity gain at DC for every phase
+        if (sum != 0.0) {
+            for (size_t t = 0; t < taps; ++t) {
+                coefficients[t] = static_cast<float>(coefficients[t] / sum);
+            }
+        }
+    }
+}
+
+// TimeStretch
+
+namespace {
+
+constexpr double STRETCH_HOP_SECONDS = 0.012;
+constexpr double STRETCH_SEARCH_SECONDS = 0.006;
+constexpr size_t STRETCH_COARSE_STEP = 8; // Candidate spacing before the fine pass
+constexpr double STRETCH_UNITY_TOLERANCE = 1e-3;
+
+} // namespace
+
+TimeStretch::TimeStretch(int channels, int sampleRate, size_t maxWriteFrames)
+    : m_channels(std::max(1, channels))
+    , m_hop(std::max<size_t>(16, static_cast<size_t>(std::max(1, sampleRate) * STRETCH_HOP_SECONDS)))
+    , m_search(std::max<size_t>(STRETCH_COARSE_STEP, static_cast<size_t>(std::max(1, sampleRate) * STRETCH_SEARCH_SECONDS)))
+    , m_rate(1.0)
+    , m_window(2 * m_hop)
+    , m_inputFrames(0)
+    , m_primed(false)
+    , m_previous(0)
+    , m_nominal(0.0)
+    , m_output(m_hop * m_channels)
+    , m_outputRead(0)
+    , m_outputFrames(0)
+{
+    // Periodic Hann: w[i] + w[i + hop] == 1
+    const size_t length = m_window.size();
+    for (size_t i = 0; i < length; ++i) {
+        m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * static_cast<double>(i) / length));
+    }
+
+    // What one hop at the fastest rate reaches past the oldest frame kept, plus a write
+    const size_t span = static_cast<size_t>(std::ceil(MAX_RATE)) * m_hop + 2 * m_hop + 2 * m_search + 1;
+    m_input.assign((span + maxWriteFrames) * m_channels, 0.0f);
+}
+
+void TimeStretch::setRate(double rate) noexcept
+{
+    m_rate = std::clamp(rate, MIN_RATE, MAX_RATE);
+}
+
+void TimeStretch::reset() noexcept
+{
+    m_inputFrames = 0;
+    m_primed = false;
+    m_previous = 0;
+    m_nominal = 0.0;
+    m_outputRead = 0;
+    m_outputFrames = 0;
+}
+
+size_t TimeStretch::writeAvailable() const noexcept
+{
+    return m_input.size() / m_channels - m_inputFrames;
+}
+
+size_t TimeStretch::write(const float* input, size_t inputFrames) noexcept
+{
+    const size_t frames = std::min(inputFrames, writeAvailable());
+    const auto channels = static_cast<size_t>(m_channels);
+    std::copy(input, input + frames * channels, m_input.begin() + m_inputFrames * channels);
+    m_inputFrames += frames;
+    return frames;
+}
+
+size_t TimeStretch::read(float* output, size_t outputCapacity) noexcept
+{
+    const auto channels = static_cast<size_t>(m_channels);
+    size_t written = 0;
+    while (written < outputCapacity) {
+        if (m_outputRead == m_outputFrames && !produceHop()) {
+            break;
+        }
+        const size_t frames = std::min(outputCapacity - written, m_outputFrames - m_outputRead);
+        std::copy(m_output.begin() + m_outputRead * channels, m_output.begin() + (m_outputRead + frames) * channels,
+                  output + written * channels);
+        m_outputRead += frames;
+        written += frames;
+    }
+    return written;
+}
+
+double TimeStretch::bufferedFrames() const noexcept
+{
+    if (!m_primed) {
+        return static_cast<double>(m_inputFrames);
+    }
+    // The next hop continues from m_previous + hop; what is left of this one ran at m_rate
+    const double pending = static_cast<double>(m_inputFrames) - static_cast<double>(m_previous + m_hop);
+    return std::max(0.0, pending + static_cast<double>(m_outputFrames - m_outputRead) * m_rate);
+}
+
+bool TimeStretch::produceHop() noexcept
+{
+    const auto channels = static_cast<size_t>(m_channels);
+    const size_t segment = 2 * m_hop;
+
+    if (!m_primed) {
+        // Nothing to overlap with: the first hop is the input as it is
+        if (m_inputFrames < segment) {
+            return false;
+        }
+        std::copy(m_input.begin(), m_input.begin() + m_hop * channels, m_output.begin());
+        m_primed = true;
+        m_previous = 0;
+        m_nominal = 0.0;
+    } else {
+        size_t next = 0;
+        if (std::abs(m_rate - 1.0) < STRETCH_UNITY_TOLERANCE) {
+            // Straight continuation: the two window halves add back up to the input
+            next = m_previous + m_hop;
+            if (next + segment > m_inputFrames) {
+                return false;
+            }
+            m_nominal = static_cast<double>(next);
+        } else {
+            const double nominal = m_nominal + static_cast<double>(m_hop) * m_rate;
+            const auto centre = static_cast<size_t>(std::llround(nominal));
+            const size_t first = centre > m_search ? centre - m_search : 0;
+            const size_t last = centre + m_search;
+            if (last + segment > m_inputFrames) {
+                return false;
+            }
+            next = bestSegment(first, last);
+            m_nominal = nominal;
+        }
+
+        // Fade out the previous segment's second half while this one fades in
+        const float* tail = m_input.data() + (m_previous + m_hop) * channels;
+        const float* head = m_input.data() + next * channels;
+        const float* fadeOut = m_window.data() + m_hop;
+        const float* fadeIn = m_window.data();
+        for (size_t frame = 0; frame < m_hop; ++frame) {
+            for (size_t c = 0; c < channels; ++c) {
+                const size_t i = frame * channels + c;
+                m_output[i] = tail[i] * fadeOut[frame] + head[i] * fadeIn[frame];
+            }
+        }
+        m_previous = next;
+    }
+
+    m_outputRead = 0;
+    m_outputFrames = m_hop;
+    compact();
+    return true;
+}
+
+size_t TimeStretch::bestSegment(size_t first, size_t last) const noexcept
+{
+    // Coarse pass over the range, then every frame around the best of it
+    size_t best = first;
+    float bestScore = -std::numeric_limits<float>::infinity();
+    for (size_t candidate = first; candidate <= last; candidate += STRETCH_COARSE_STEP) {
+        const float score = similarity(candidate);
+        if (score > bestScore) {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+
+    const size_t fineFirst = best > first + STRETCH_COARSE_STEP ? best - STRETCH_COARSE_STEP + 1 : first;
+    const size_t fineLast = std::min(last, best + STRETCH_COARSE_STEP - 1);
+    for (size_t candidate = fineFirst; candidate <= fineLast; ++candidate) {
+        const float score = similarity(candidate);
+        if (score > bestScore) {
+            bestScore = score;
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+float TimeStretch::similarity(size_t candidate) const noexcept
+{
+    // Normalised cross-correlation with what naturally follows the previous segment
+    const auto channels = static_cast<size_t>(m_channels);
+    const size_t count = m_hop * channels;
+    const float* natural = m_input.data() + (m_previous + m_hop) * channels;
+    const float* segment = m_input.data() + candidate * channels;
+    const float correlation = dotProduct(natural, segment, count);
+    const float energy = dotProduct(segment, segment, count);
+    return correlation / std::sqrt(energy + 1e-9f);
+}
+
+void TimeStretch::compact() noexcept
+{
+    // Keep the previous segment's second half and everything the next search can reach
+    const size_t overlap = m_previous + m_hop;
+    const double reach = m_nominal - static_cast<double>(m_search);
+    const size_t keepFrom = std::min(overlap, reach > 0.0 ? static_cast<size_t>(reach) : size_t{0});
+    if (keepFrom == 0) {
+        return;
+    }
+
+    const auto channels = static_cast<size_t>(m_channels);
+    std::copy(m_input.begin() + keepFrom * channels, m_input.begin() + m_inputFrames * channels, m_input.begin());
+    m_inputFrames -= keepFrom;
+    m_previous -= keepFrom;
+    m_nominal -= static_cast<double>(keepFrom);
+}
+
+} // namespace DarkPlay::Media::AudioKernels
@@ -0,0 +1,494 @@
+#include "media/AudioPipeline.h"
+#include "media/MediaClock.h"
+#include "plugins/IPlugin.h"
+#include <QAudioBufferOutput>
+#include <QAudioSink>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QIODevice>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace DarkPlay::Media {
+
+/**
+ * @brief Pull-mode source for QAudioSink, backed by the output ring
+ */
+class AudioPipeline::OutputDevice : public QIODevice
+{
+public:
+    explicit OutputDevice(AudioPipeline* pipeline)
+        : m_pipeline(pipeline)
+    {
+    }
+
+    [[nodiscard]] bool isSequential() const override { return true; }
+
+    // Always "has data": missing samples are rendered as silence instead of stalling the sink
+    [[nodiscard]] qint64 bytesAvailable() const override
+    {
+        return m_pipeline->m_sinkFormat.bytesForFrames(RING_FRAMES) + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        return m_pipeline->readOutput(data, maxSize);
+    }
+
+    qint64 writeData(const char* data, qint64 maxSize) override
+    {
+        Q_UNUSED(data)
+        Q_UNUSED(maxSize)
+        return -1;
+    }
+
+private:
+    AudioPipeline* m_pipeline;
+};
+
+AudioPipeline::AudioPipeline(QObject* parent)
+    : QObject(parent)
+    , m_channels(0)
+    , m_sinkIsFloat(true)
+    , m_bufferOutput(nullptr)
+    , m_dspThread(nullptr)
+    , m_inputFramesWritten(0)
+    , m_previousStartUs(-1)
+    , m_previousDurationUs(0)
+    , m_inputFramesConsumed(0)
+    , m_outputFramesWritten(0)
+    , m_outputFramesRead(0)
+    , m_volume(1.0f)
+    , m_muted(false)
+    , m_formatWarningShown(false)
+{
+}
+
+AudioPipeline::~AudioPipeline()
+{
+    stop();
+}
+
+bool AudioPipeline::start(const QAudioDevice& device)
+{
+    if (isRunning()) {
+        return true;
+    }
+
+    if (device.isNull()) {
+        emit errorOccurred("No audio output device available for the DSP pipeline");
+        return false;
+    }
+
+    // Effects always see interleaved float at the device's native rate and layout
+    m_processingFormat = device.preferredFormat();
+    m_processingFormat.setSampleFormat(QAudioFormat::Float);
+    m_channels = m_processingFormat.channelCount();
+    if (m_channels <= 0 || m_processingFormat.sampleRate() <= 0) {
+        emit errorOccurred("Audio device reports no usable format");
+        return false;
+    }
+
+    m_sinkFormat = m_processingFormat;
+    if (!device.isFormatSupported(m_sinkFormat)) {
+        m_sinkFormat.setSampleFormat(QAudioFormat::Int16);
+        if (!device.isFormatSupported(m_sinkFormat)) {
+            emit errorOccurred("Audio device supports neither float nor 16-bit output");
+            return false;
+        }
+    }
+    m_sinkIsFloat = m_sinkFormat.sampleFormat() == QAudioFormat::Float;
+
+    // Every buffer the real-time path touches is allocated here, once
+    m_inputRing.reserve(static_cast<size_t>(RING_FRAMES) * m_channels);
+    m_outputRing.reserve(static_cast<size_t>(RING_FRAMES) * m_channels);
+    m_dspBlock.assign(static_cast<size_t>(BLOCK_FRAMES) * m_channels, 0.0f);
+    m_outputChunk.assign(static_cast<size_t>(OUTPUT_CHUNK_FRAMES) * m_channels, 0.0f);
+    m_pcmChunk.assign(m_sinkIsFloat ? 0 : static_cast<size_t>(OUTPUT_CHUNK_FRAMES) * m_channels, 0);
+    m_outputGain.reset(m_targetGain.load(std::memory_order_relaxed));
+    m_stretch = std::make_unique<AudioKernels::TimeStretch>(m_channels, m_processingFormat.sampleRate(),
+                                                            static_cast<size_t>(BLOCK_FRAMES));
+    m_flushInput.store(false, std::memory_order_relaxed);
+    m_flushOutput.store(false, std::memory_order_relaxed);
+    m_underruns.store(0, std::memory_order_relaxed);
+    m_overruns.store(0, std::memory_order_relaxed);
+    m_droppedInputFrames.store(0, std::memory_order_relaxed);
+    m_formatWarningShown = false;
+
+    m_inputFramesWritten = 0;
+    m_previousStartUs = -1;
+    m_previousDurationUs = 0;
+    m_inputFramesConsumed = 0;
+    m_outputFramesWritten = 0;
+    m_outputFramesRead = 0;
+    m_mediaPerSample.store(1.0, std::memory_order_relaxed);
+    m_resetInputTiming.store(false, std::memory_order_relaxed);
+    m_flushFrame.store(0, std::memory_order_relaxed);
+    m_inputMark.store(InputMark{});
+    m_outputMark.store(OutputMark{});
+
+    // Decode tap: the player converts to our float format; handle it on the delivering thread
+    m_bufferOutput = new QAudioBufferOutput(m_processingFormat, this);
+    connect(m_bufferOutput, &QAudioBufferOutput::audioBufferReceived,
+            this, &AudioPipeline::onAudioBufferReceived, Qt::DirectConnection);
+
+    m_outputDevice = std::make_unique<OutputDevice>(this);
+    m_outputDevice->open(QIODevice::ReadOnly);
+
+    m_sink = std::make_unique<QAudioSink>(device, m_sinkFormat);
+    m_sink->setBufferSize(m_sinkFormat.bytesForFrames(BLOCK_FRAMES * 4));
+    m_sinkBufferFrames.store(BLOCK_FRAMES * 4, std::memory_order_relaxed);
+
+    m_running.store(true, std::memory_order_release);
+    m_dspThread = QThread::create([this]() { dspLoop(); });
+    m_dspThread->setObjectName("DarkPlay DSP");
+    m_dspThread->start(QThread::TimeCriticalPriority);
+
+    m_sink->start(m_outputDevice.get());
+    if (m_sink->error() != QAudio::NoError) {
+        emit errorOccurred(QString("Failed to open audio sink (error %1)").arg(static_cast<int>(m_sink->error())));
+        stop();
+        return false;
+    }
+
+    // The backend may have settled on another size than asked for
+    if (m_sink->bufferSize() > 0) {
+        m_sinkBufferFrames.store(m_sinkFormat.framesForBytes(m_sink->bufferSize()), std::memory_order_relaxed);
+    }
+
+    if (m_paused.load(std::memory_order_relaxed)) {
+        m_sink->suspend();
+    }
+
+    qDebug() << "AudioPipeline started:" << m_processingFormat.sampleRate() << "Hz," << m_channels
+             << "channels, sink" << (m_sinkIsFloat ? "float" : "int16");
+    return true;
+}
+
+void AudioPipeline::stop()
+{
+    // Callers detach bufferOutput() from the player before stopping
+    if (!isRunning()) {
+        return;
+    }
+
+    m_running.store(false, std::memory_order_release);
+    wakeDsp();
+
+    if (m_sink) {
+        m_sink->stop();
+        m_sink.reset();
+    }
+    m_outputDevice.reset();
+
+    if (m_dspThread) {
+        m_dspThread->wait();
+        delete m_dspThread;
+        m_dspThread = nullptr;
+    }
+
+    delete m_bufferOutput;
+    m_bufferOutput = nullptr;
+
+    m_inputRing.clear();
+    m_outputRing.clear();
+
+    // Chains are no longer referenced by any thread
+    m_chainAcknowledged.store(m_chainGeneration.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+void AudioPipeline::setEffects(const QList<Plugins::IAudioEffectPlugin*>& effects)
+{
+    // The inactive slot may only be rewritten once the previous swap has been picked up
+    waitForChainAcknowledged(m_chainGeneration.load(std::memory_order_acquire));
+
+    const int inactive = 1 - m_activeChain.load(std::memory_order_relaxed);
+    m_chains[inactive].assign(effects.cbegin(), effects.cend());
+    m_activeChain.store(inactive, std::memory_order_release);
+    const quint32 generation = m_chainGeneration.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    if (!isRunning()) {
+        m_chainAcknowledged.store(generation, std::memory_order_release);
+        return;
+    }
+
+    // Plugins may be shut down right after this returns
+    wakeDsp();
+    waitForChainAcknowledged(generation);
+}
+
+void AudioPipeline::waitForChainAcknowledged(quint32 generation)
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    // The old chain may still be inside processAudio(), so returning early would let the
+    // caller shut its plugins down under the DSP thread; a slow block only delays us
+    QDeadlineTimer deadline(CHAIN_SWAP_WARN_MS);
+    bool warned = false;
+    while (m_chainAcknowledged.load(std::memory_order_acquire) != generation) {
+        if (!warned && deadline.hasExpired()) {
+            qWarning() << "AudioPipeline: DSP thread is slow to pick up the effect chain, still waiting";
+            warned = true;
+        }
+        wakeDsp();
+        QThread::usleep(100);
+    }
+}
+
+void AudioPipeline::setVolume(float volume)
+{
+    m_volume = qBound(0.0f, volume, 1.0f);
+    updateTargetGain();
+}
+
+void AudioPipeline::setMuted(bool muted)
+{
+    m_muted = muted;
+    updateTargetGain();
+}
+
+void AudioPipeline::setPaused(bool paused)
+{
+    m_paused.store(paused, std::memory_order_relaxed);
+    if (!m_sink) {
+        return;
+    }
+
+    if (paused && m_sink->state() != QAudio::SuspendedState) {
+        m_sink->suspend();
+    } else if (!paused && m_sink->state() == QAudio::SuspendedState) {
+        m_sink->resume();
+    }
+}
+
+void AudioPipeline::flush()
+{
+    // Each ring is drained by its own consumer, so the request is just a flag
+    m_resetInputTiming.store(true, std::memory_order_release);
+    m_flushInput.store(true, std::memory_order_release);
+    wakeDsp();
+}
+
+void AudioPipeline::setPlaybackRate(qreal rate)
+{
+    m_playbackRate.store(rate > 0.0 ? rate : 1.0, std::memory_order_relaxed);
+    wakeDsp();
+}
+
+double AudioPipeline::stretchRateFor(double playbackRate, double mediaPerSample) noexcept
+{
+    const double rate = playbackRate / mediaPerSample;
+    if (std::abs(rate - 1.0) < UNITY_RATE_SNAP) {
+        return 1.0;
+    }
+    return std::clamp(rate, AudioKernels::TimeStretch::MIN_RATE, AudioKernels::TimeStretch::MAX_RATE);
+}
+
+void AudioPipeline::updateTargetGain()
+{
+    // Ramped in by the sink callback; the sink itself stays at unity gain
+    m_targetGain.store(m_muted ? 0.0f : m_volume, std::memory_order_relaxed);
+}
+
+void AudioPipeline::wakeDsp()
+{
+    m_wakeSequence.fetch_add(1, std::memory_order_release);
+    m_wakeSequence.notify_one();
+}
+
+void AudioPipeline::onAudioBufferReceived(const QAudioBuffer& buffer)
+{
+    // Decode stage: producer side of the input ring
+    if (!isRunning() || !buffer.isValid()) {
+        return;
+    }
+
+    const QAudioFormat format = buffer.format();
+    if (format.sampleFormat() != QAudioFormat::Float || format.channelCount() != m_channels) {
+        if (!m_formatWarningShown) {
+            m_formatWarningShown = true;
+            qWarning() << "AudioPipeline: Unexpected buffer format" << format << "- dropping audio";
+        }
+        return;
+    }
+
+    // Backends that play the rate themselves hand over fewer samples per media second
+    const qint64 startUs = buffer.startTime();
+    const qint64 durationUs = buffer.duration();
+    if (m_resetInputTiming.exchange(false, std::memory_order_acq_rel)) {
+        m_previousStartUs = -1;
+    }
+    double mediaPerSample = m_mediaPerSample.load(std::memory_order_relaxed);
+    if (m_previousStartUs >= 0 && m_previousDurationUs > 0 && startUs > m_previousStartUs) {
+        const double measured = static_cast<double>(startUs - m_previousStartUs) / m_previousDurationUs;
+        if (measured >= MIN_MEDIA_PER_SAMPLE && measured <= MAX_MEDIA_PER_SAMPLE) {
+            mediaPerSample += (measured - mediaPerSample) * MEDIA_PER_SAMPLE_SMOOTHING;
+            m_mediaPerSample.store(mediaPerSample, std::memory_order_relaxed);
+        }
+    }
+    m_previousStartUs = startUs;
+    m_previousDurationUs = durationUs;
+
+    // Free space need not be whole frames; a partial one would rotate the channels from then on
+    const size_t channels = static_cast<size_t>(m_channels);
+    const size_t frames = static_cast<size_t>(buffer.frameCount());
+    const size_t writable = std::min(frames, m_inputRing.writeAvailable() / channels);
+    if (writable < frames) {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        m_droppedInputFrames.fetch_add(frames - writable, std::memory_order_relaxed);
+    }
+    m_inputFramesWritten += m_inputRing.write(buffer.constData<float>(), writable * channels) / channels;
+    const qint64 endUs = startUs >= 0 ? startUs + static_cast<qint64>(durationUs * mediaPerSample) : -1;
+    m_inputMark.store(InputMark{m_inputFramesWritten, endUs, mediaPerSample});
+    wakeDsp();
+}
+
+void AudioPipeline::dspLoop()
+{
+    const auto channels = static_cast<size_t>(m_channels);
+    float* block = m_dspBlock.data();
+    AudioKernels::TimeStretch& stretch = *m_stretch;
+
+    while (m_running.load(std::memory_order_acquire)) {
+        const quint32 wakeSequence = m_wakeSequence.load(std::memory_order_acquire);
+
+        // Acknowledging here means the previous chain is no longer referenced
+        const quint32 generation = m_chainGeneration.load(std::memory_order_acquire);
+        const EffectChain& chain = m_chains[m_activeChain.load(std::memory_order_acquire)];
+        m_chainAcknowledged.store(generation, std::memory_order_release);
+
+        if (m_flushInput.exchange(false, std::memory_order_acq_rel)) {
+            m_inputFramesConsumed += m_inputRing.discard(m_inputRing.readAvailable()) / channels;
+            stretch.reset();
+            m_flushFrame.store(m_inputFramesConsumed, std::memory_order_release);
+            m_flushOutput.store(true, std::memory_order_release);
+        }
+
+        stretch.setRate(stretchRateFor(m_playbackRate.load(std::memory_order_relaxed),
+                                       m_mediaPerSample.load(std::memory_order_relaxed)));
+
+        const size_t fed = std::min({m_inputRing.readAvailable() / channels, stretch.writeAvailable(),
+                                     static_cast<size_t>(BLOCK_FRAMES)});
+        if (fed > 0) {
+            m_inputRing.read(block, fed * channels);
+            stretch.write(block, fed);
+            m_inputFramesConsumed += fed;
+        }
+
+        const size_t room = std::min(m_outputRing.writeAvailable() / channels, static_cast<size_t>(BLOCK_FRAMES));
+        const size_t frames = room > 0 ? stretch.read(block, room) : 0;
+
+        if (frames == 0) {
+            if (fed > 0) {
+                continue; // Not a whole hop yet
+            }
+            if (m_inputRing.readAvailable() == 0) {
+                // The decode stage wakes us; so do stop, flush, rate changes and chain swaps
+                m_wakeSequence.wait(wakeSequence, std::memory_order_acquire);
+            } else {
+                // Output is full - the sink callback never signals, to stay syscall-free
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            continue;
+        }
+
+        for (Plugins::IAudioEffectPlugin* effect : chain) {
+            try {
+                effect->processAudio(block, static_cast<int>(frames), m_channels);
+            } catch (...) {
+                // A misbehaving effect must not take the audio thread down
+            }
+        }
+
+        m_outputRing.write(block, frames * channels);
+        m_outputFramesWritten += frames;
+        m_outputMark.store(OutputMark{m_outputFramesWritten,
+                                      static_cast<double>(m_inputFramesConsumed) - stretch.bufferedFrames(),
+                                      stretch.rate()});
+    }
+}
+
+qint64 AudioPipeline::readOutput(char* data, qint64 maxSize) noexcept
+{
+    // Sink callback: ring reads and sample conversion only - no locks, no allocation
+    MediaClock* clock = m_clock.load(std::memory_order_acquire);
+    const qint64 wallNs = clock ? clock->wallNs() : 0;
+
+    if (m_flushOutput.exchange(false, std::memory_order_acq_rel)) {
+        m_outputFramesRead += m_outputRing.discard(m_outputRing.readAvailable()) / m_channels;
+    }
+
+    const qint64 bytesPerSample = m_sinkIsFloat ? qint64(sizeof(float)) : qint64(sizeof(qint16));
+    const qint64 frameBytes = bytesPerSample * m_channels;
+    const qint64 frames = frameBytes > 0 ? maxSize / frameBytes : 0;
+
+    float* chunk = m_outputChunk.data();
+    m_outputGain.setTarget(m_targetGain.load(std::memory_order_relaxed));
+    bool underrun = false;
+    qint64 done = 0;
+
+    while (done < frames) {
+        const qint64 chunkFrames = std::min<qint64>(frames - done, OUTPUT_CHUNK_FRAMES);
+        const size_t wanted = static_cast<size_t>(chunkFrames) * m_channels;
+        const size_t got = m_outputRing.read(chunk, wanted);
+        m_outputFramesRead += got / m_channels;
+        if (got < wanted) {
+            std::fill(chunk + got, chunk + wanted, 0.0f);
+            underrun = true;
+        }
+
+        m_outputGain.process(chunk, static_cast<size_t>(chunkFrames), m_channels);
+
+        // The sink's buffer carries no alignment guarantee, so convert via scratch and copy
+        char* out = data + done * frameBytes;
+        if (m_sinkIsFloat) {
+            std::memcpy(out, chunk, wanted * sizeof(float));
+        } else {
+            AudioKernels::floatToInt16(chunk, m_pcmChunk.data(), wanted);
+            std::memcpy(out, m_pcmChunk.data(), wanted * sizeof(qint16));
+        }
+        done += chunkFrames;
+    }
+
+    if (underrun && !m_paused.load(std::memory_order_relaxed)) {
+        m_underruns.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (clock && !m_paused.load(std::memory_order_relaxed)) {
+        publishAudible(clock, wallNs);
+    }
+
+    return frames * frameBytes;
+}
+
+void AudioPipeline::publishAudible(MediaClock* clock, qint64 wallNs) noexcept
+{
+    OutputMark output;
+    InputMark input;
+    if (!m_outputMark.load(output) || !m_inputMark.load(input) || input.endUs < 0) {
+        return;
+    }
+
+    // What the sink plays now was written its buffer plus the queued ring ago, at the stretch rate
+    const double queued = static_cast<double>(output.frames - std::min(output.frames, m_outputFramesRead))
+        + static_cast<double>(m_sinkBufferFrames.load(std::memory_order_relaxed));
+    const double audibleFrame = output.inputFrame - queued * output.stretchRate;
+    // Still what was queued before a seek, or not decoded yet as far as the mark knows
+    if (audibleFrame < static_cast<double>(m_flushFrame.load(std::memory_order_acquire))
+        || audibleFrame > static_cast<double>(input.frames)) {
+        return;
+    }
+
+    const double usPerFrame = 1000000.0 / m_processingFormat.sampleRate();
+    const double behindUs = (static_cast<double>(input.frames) - audibleFrame) * usPerFrame * input.mediaPerSample;
+    clock->updateFromAudio(input.endUs - static_cast<qint64>(behindUs), wallNs);
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,100 @@
+#include "media/EngineThread.h"
+#include <QDebug>
+#include <QMetaObject>
+#include <future>
+
+namespace DarkPlay::Media {
+
+EngineThread::EngineThread()
+    : m_context(new QObject)
+    , m_drainScheduled(false)
+    , m_coalesced(0)
+{
+    m_thread.setObjectName("DarkPlay media engine");
+    m_context->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+EngineThread::~EngineThread()
+{
+    // Queued behind everything else, so pending commands (engine deletion included) still run
+    post([this]() { m_thread.quit(); });
+    if (!m_thread.wait()) {
+        qWarning() << "EngineThread: Engine thread did not finish";
+    }
+    delete m_context;
+}
+
+void EngineThread::adopt(QObject* object)
+{
+    if (!object) {
+        return;
+    }
+    // Only parentless objects can change threads
+    object->setParent(nullptr);
+    object->moveToThread(&m_thread);
+}
+
+void EngineThread::post(Command command, Coalesce key)
+{
+    bool scheduleDrain = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (key != Coalesce::None) {
+            for (auto it = m_queue.rbegin(); it != m_queue.rend() && it->key != Coalesce::None; ++it) {
+                if (it->key == key) {
+                    m_queue.erase(std::next(it).base());
+                    m_coalesced.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        m_queue.push_back(Entry{std::move(command), key});
+        if (!m_drainScheduled) {
+            m_drainScheduled = true;
+            scheduleDrain = true;
+        }
+    }
+
+    // One event per batch, however many commands arrive before it is delivered
+    if (scheduleDrain) {
+        QMetaObject::invokeMethod(m_context, [this]() { drain(); }, Qt::QueuedConnection);
+    }
+}
+
+void EngineThread::postAndWait(Command command)
+{
+    if (isCurrentThread()) {
+        command();
+        return;
+    }
+
+    std::promise<void> done;
+    std::future<void> finished = done.get_future();
+    post([&command, &done]() {
+        command();
+        done.set_value();
+    });
+    finished.wait();
+}
+
+bool EngineThread::isCurrentThread() const
+{
+    return QThread::currentThread() == &m_thread;
+}
+
+void EngineThread::drain()
+{
+    std::deque<Entry> batch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        batch.swap(m_queue);
+        m_drainScheduled = false;
+    }
+
+    for (Entry& entry : batch) {
+        entry.command();
+    }
+}
+
+} // namespace DarkPlay::Media
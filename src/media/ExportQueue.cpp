@@ -0,0 +1,304 @@
+#include "media/ExportQueue.h"
+#include "utils/MemoryBudget.h"
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+ExportQueue::ExportQueue(QObject* parent)
+    : QObject(parent)
+    , m_maxJobs(0)
+    , m_nextId(1)
+    , m_startPending(false)
+    , m_busy(false)
+{
+}
+
+ExportQueue::~ExportQueue()
+{
+    // Workers call back into us, so every one of them must be gone first
+    for (ExportJobStatus& status : m_jobs) {
+        if (status.state == ExportState::Queued) {
+            status.state = ExportState::Cancelled;
+        }
+    }
+    stopWorkers([](const Worker&) { return true; });
+}
+
+void ExportQueue::setTranscoderFactory(TranscoderFactory factory)
+{
+    m_factory = std::move(factory);
+}
+
+void ExportQueue::setMaxJobs(int jobs)
+{
+    m_maxJobs = std::max(0, jobs);
+    scheduleStart();
+}
+
+int ExportQueue::maxJobs() const
+{
+    return effectiveMaxJobs();
+}
+
+int ExportQueue::effectiveMaxJobs() const
+{
+    if (m_maxJobs > 0) {
+        return m_maxJobs;
+    }
+    // Every job is a decoder and an encoder, each threading on its own
+    if (Utils::MemoryBudget::isLowMemoryMode()) {
+        return 1;
+    }
+    return std::clamp(QThread::idealThreadCount() / 4, 1, MAX_AUTO_JOBS);
+}
+
+int ExportQueue::enqueue(ExportJob job)
+{
+    if (job.format.isEmpty()) {
+        job.format = QFileInfo(job.outputPath).suffix().toLower();
+    }
+
+    ExportJobStatus status;
+    status.id = m_nextId++;
+    status.job = std::move(job);
+    m_jobs.append(status);
+    m_busy = true;
+
+    emit jobQueued(status.id);
+    // Started from the event loop, so callers can connect to the id before anything happens
+    scheduleStart();
+    return status.id;
+}
+
+void ExportQueue::cancel(int id)
+{
+    ExportJobStatus* status = findJob(id);
+    if (!status) {
+        return;
+    }
+
+    if (status->state == ExportState::Queued) {
+        setFinished(*status, ExportState::Cancelled, "Cancelled");
+        scheduleStart();
+        return;
+    }
+
+    // Running: the transcoder removes its partial file and reports back
+    for (Worker& worker : m_workers) {
+        if (worker.id == id && !worker.cancelRequested) {
+            worker.cancelRequested = true;
+            IMediaTranscoder* transcoder = worker.transcoder;
+            QMetaObject::invokeMethod(transcoder, [transcoder]() { transcoder->cancel(); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void ExportQueue::cancelAll()
+{
+    QList<int> ids;
+    for (const ExportJobStatus& status : std::as_const(m_jobs)) {
+        if (status.state == ExportState::Queued || status.state == ExportState::Running) {
+            ids.append(status.id);
+        }
+    }
+    for (int id : std::as_const(ids)) {
+        cancel(id);
+    }
+}
+
+void ExportQueue::cancelOwner(const QString& owner)
+{
+    if (owner.isEmpty()) {
+        return;
+    }
+    // The plugin's code must not run any more once this returns
+    stopWorkers([&owner](const Worker& worker) { return worker.owner == owner; });
+    scheduleStart();
+}
+
+bool ExportQueue::isIdle() const
+{
+    return m_workers.empty() && std::none_of(m_jobs.cbegin(), m_jobs.cend(), [](const ExportJobStatus& status) {
+        return status.state == ExportState::Queued;
+    });
+}
+
+QString ExportQueue::outputPathFor(const QUrl& source, const QString& directory,
+                                   const QString& format, const QStringList& taken)
+{
+    QString baseName = QFileInfo(source.isLocalFile() ? source.toLocalFile() : source.path()).completeBaseName();
+    if (baseName.isEmpty()) {
+        baseName = "export";
+    }
+    const QString suffix = format.isEmpty() ? QString::fromLatin1(DEFAULT_FORMAT) : format.toLower();
+
+    const QDir dir(directory);
+    QString path = dir.filePath(baseName + '.' + suffix);
+    for (int n = 2; QFileInfo::exists(path) || taken.contains(path); ++n) {
+        path = dir.filePath(QString("%1 (%2).%3").arg(baseName).arg(n).arg(suffix));
+    }
+    return path;
+}
+
+void ExportQueue::scheduleStart()
+{
+    if (m_startPending) {
+        return;
+    }
+    m_startPending = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_startPending = false;
+        startNext();
+    }, Qt::QueuedConnection);
+}
+
+void ExportQueue::startNext()
+{
+    // By index: a jobFinished() handler may enqueue more
+    for (qsizetype i = 0; i < m_jobs.size(); ++i) {
+        if (static_cast<int>(m_workers.size()) >= effectiveMaxJobs()) {
+            break;
+        }
+        if (m_jobs[i].state == ExportState::Queued) {
+            launch(m_jobs[i]);
+        }
+    }
+
+    if (m_busy && isIdle()) {
+        m_busy = false;
+        emit idle();
+    }
+}
+
+void ExportQueue::launch(ExportJobStatus& status)
+{
+    const ExportJob& job = status.job;
+    if (!job.source.isValid() || job.outputPath.isEmpty()) {
+        setFinished(status, ExportState::Failed, "An export needs a source and an output path");
+        return;
+    }
+    if (job.source.isLocalFile()
+        && QFileInfo(job.source.toLocalFile()).absoluteFilePath() == QFileInfo(job.outputPath).absoluteFilePath()) {
+        setFinished(status, ExportState::Failed, "The output would overwrite the source");
+        return;
+    }
+
+    TranscoderInstance instance = m_factory ? m_factory(job) : TranscoderInstance{};
+    if (!instance.transcoder) {
+        setFinished(status, ExportState::Failed, QString("Nothing can encode \"%1\"").arg(job.format));
+        return;
+    }
+
+    const int id = status.id;
+    status.state = ExportState::Running;
+    status.encoder = instance.owner;
+
+    auto* thread = new QThread();
+    thread->setObjectName(QString("Export %1").arg(id));
+    IMediaTranscoder* transcoder = instance.transcoder.release();
+    transcoder->moveToThread(thread);
+
+    connect(transcoder, &IMediaTranscoder::progressChanged, this, [this, id](const ExportProgress& progress) {
+        ExportJobStatus* entry = findJob(id);
+        if (entry && entry->state == ExportState::Running) {
+            entry->progress = progress;
+            emit jobProgress(id, progress);
+        }
+    });
+    connect(transcoder, &IMediaTranscoder::finished, this, [this, id](bool ok, const QString& error) {
+        onTranscoderFinished(id, ok, error);
+    });
+    connect(thread, &QThread::finished, transcoder, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    QMetaObject::invokeMethod(transcoder, [transcoder, job]() { transcoder->start(job); }, Qt::QueuedConnection);
+    m_workers.push_back(Worker{id, thread, transcoder, instance.owner, false});
+    thread->start(QThread::LowPriority);
+
+    qDebug() << "ExportQueue: Started job" << id << "with"
+             << (instance.owner.isEmpty() ? QString("the built-in transcoder") : instance.owner)
+             << "-" << m_workers.size() << "of" << effectiveMaxJobs() << "workers busy";
+    emit jobStarted(id);
+}
+
+void ExportQueue::onTranscoderFinished(int id, bool ok, const QString& error)
+{
+    const auto worker = std::find_if(m_workers.begin(), m_workers.end(),
+                                     [id](const Worker& entry) { return entry.id == id; });
+    if (worker == m_workers.end()) {
+        return; // Already stopped by stopWorkers()
+    }
+    const bool cancelled = worker->cancelRequested;
+    if (worker->thread) {
+        worker->thread->quit();
+    }
+    m_workers.erase(worker);
+
+    if (ExportJobStatus* status = findJob(id)) {
+        setFinished(*status, ok ? ExportState::Finished : (cancelled ? ExportState::Cancelled : ExportState::Failed),
+                    ok ? QString() : error);
+    }
+    scheduleStart();
+}
+
+void ExportQueue::setFinished(ExportJobStatus& status, ExportState state, const QString& error)
+{
+    status.state = state;
+    status.error = error;
+    if (state == ExportState::Failed) {
+        qWarning() << "ExportQueue: Job" << status.id << "failed:" << error;
+    }
+    emit jobFinished(status.id, state, error);
+}
+
+void ExportQueue::stopWorkers(const std::function<bool(const Worker&)>& predicate)
+{
+    std::vector<Worker> stopping;
+    std::erase_if(m_workers, [&](const Worker& worker) {
+        if (!predicate(worker)) {
+            return false;
+        }
+        stopping.push_back(worker);
+        return true;
+    });
+
+    for (const Worker& worker : stopping) {
+        bool stopped = true;
+        if (worker.thread && worker.thread->isRunning()) {
+            // Quitting from the same event keeps cancel() from being skipped. Never block on it:
+            // a transcoder stuck in start() would freeze the GUI thread with it
+            IMediaTranscoder* transcoder = worker.transcoder;
+            QMetaObject::invokeMethod(transcoder, [transcoder]() {
+                transcoder->cancel();
+                QThread::currentThread()->quit();
+            }, Qt::QueuedConnection);
+            stopped = worker.thread->wait(QDeadlineTimer(STOP_TIMEOUT_MS));
+        }
+
+        if (stopped) {
+            // The transcoder went with the thread's deferred deletes
+            delete worker.thread.data();
+        } else {
+            // Left to delete itself once it finishes, see launch()
+            qWarning() << "ExportQueue: Job" << worker.id << "did not stop within" << STOP_TIMEOUT_MS
+                       << "ms, abandoning its worker thread";
+        }
+
+        if (ExportJobStatus* status = findJob(worker.id)) {
+            setFinished(*status, ExportState::Cancelled, "Cancelled");
+        }
+    }
+}
+
+ExportJobStatus* ExportQueue::findJob(int id)
+{
+    const auto it = std::find_if(m_jobs.begin(), m_jobs.end(),
+                                 [id](const ExportJobStatus& status) { return status.id == id; });
+    return it != m_jobs.end() ? &*it : nullptr;
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,189 @@
+#include "media/FrameStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DarkPlay::Media {
+
+FrameStatistics::FrameStatistics()
+    : m_playbackRate(1.0)
+    , m_lastPresentationTimeUs(-1)
+    , m_scheduleBaselineUs(0)
+    , m_hasBaseline(false)
+    , m_intervalCount(0)
+    , m_intervalIndex(0)
+    , m_pendingIndex(0)
+    , m_latencyCount(0)
+    , m_latencyIndex(0)
+{
+    m_clock.start();
+}
+
+void FrameStatistics::recordArrival(qint64 presentationTimeUs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const qint64 arrivalUs = nowUs();
+
+    ++m_stats.framesReceived;
+
+    if (presentationTimeUs < 0) {
+        return; // Untimed frames can only be counted
+    }
+
+    // Backward or far forward jumps are seeks, not drops
+    if (m_lastPresentationTimeUs >= 0) {
+        const qint64 delta = presentationTimeUs - m_lastPresentationTimeUs;
+        if (delta <= 0 || delta > DISCONTINUITY_US) {
+            resetTimingLocked();
+        } else {
+            const qint64 interval = nominalIntervalUs();
+            if (interval > 0 && delta * 2 > interval * 3) {
+                const auto missing = static_cast<quint64>(std::llround(static_cast<double>(delta) / interval)) - 1;
+                m_stats.framesDropped += missing;
+            }
+
+            m_intervals[m_intervalIndex] = delta;
+            m_intervalIndex = (m_intervalIndex + 1) % INTERVAL_SAMPLES;
+            m_intervalCount = std::min(m_intervalCount + 1, INTERVAL_SAMPLES);
+        }
+    }
+    m_lastPresentationTimeUs = presentationTimeUs;
+
+    // Wall-clock offset against the media timeline; the smallest one seen is "on time"
+    const qint64 offsetUs = arrivalUs - static_cast<qint64>(presentationTimeUs / m_playbackRate);
+    if (!m_hasBaseline || offsetUs < m_scheduleBaselineUs) {
+        m_scheduleBaselineUs = offsetUs;
+        m_hasBaseline = true;
+    }
+
+    const qint64 interval = nominalIntervalUs();
+    if (interval > 0 && offsetUs - m_scheduleBaselineUs > interval) {
+        ++m_stats.framesLate;
+    }
+
+    // A frame still pending when its slot is reused never made it to the screen
+    PendingFrame& slot = m_pending[m_pendingIndex];
+    if (!slot.settled) {
+        ++m_stats.framesSkipped;
+    }
+    slot.presentationTimeUs = presentationTimeUs;
+    slot.arrivalUs = arrivalUs;
+    slot.settled = false;
+    m_pendingIndex = (m_pendingIndex + 1) % PENDING_FRAMES;
+}
+
+void FrameStatistics::recordPresented(qint64 presentationTimeUs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const qint64 presentUs = nowUs();
+
+    ++m_stats.framesPresented;
+
+    if (presentationTimeUs < 0) {
+        return;
+    }
+
+    for (PendingFrame& frame : m_pending) {
+        if (frame.settled) {
+            continue;
+        }
+
+        if (frame.presentationTimeUs == presentationTimeUs) {
+            m_latencies[m_latencyIndex] = presentUs - frame.arrivalUs;
+            m_latencyIndex = (m_latencyIndex + 1) % LATENCY_SAMPLES;
+            m_latencyCount = std::min(m_latencyCount + 1, LATENCY_SAMPLES);
+            frame.settled = true;
+        } else if (frame.presentationTimeUs < presentationTimeUs) {
+            // The renderer only moves forward - older frames were replaced unseen
+            ++m_stats.framesSkipped;
+            frame.settled = true;
+        }
+    }
+}
+
+void FrameStatistics::markDiscontinuity()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    resetTimingLocked();
+}
+
+void FrameStatistics::setPlaybackRate(qreal rate)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (rate > 0.0 && rate != m_playbackRate) {
+        m_playbackRate = rate;
+        resetTimingLocked();
+    }
+}
+
+void FrameStatistics::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = FrameStats{};
+    m_latencyCount = 0;
+    m_latencyIndex = 0;
+    m_intervalCount = 0;
+    m_intervalIndex = 0;
+    resetTimingLocked();
+}
+
+FrameStats FrameStatistics::stats() const
+{
+    std::array<qint64, LATENCY_SAMPLES> sorted;
+    FrameStats result;
+    int count = 0;
+    qint64 interval = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        result = m_stats;
+        count = m_latencyCount;
+        interval = nominalIntervalUs();
+        std::copy_n(m_latencies.begin(), count, sorted.begin());
+    }
+
+    if (interval > 0) {
+        result.frameRate = 1000000.0 / static_cast<double>(interval);
+    }
+
+    result.latencySamples = count;
+    if (count > 0) {
+        std::sort(sorted.begin(), sorted.begin() + count);
+        auto percentile = [&](int p) { return sorted[std::min(count - 1, count * p / 100)]; };
+        result.latencyP50Us = percentile(50);
+        result.latencyP95Us = percentile(95);
+        result.latencyP99Us = percentile(99);
+    }
+
+    return result;
+}
+
+qint64 FrameStatistics::nowUs() const
+{
+    return m_clock.nsecsElapsed() / 1000;
+}
+
+qint64 FrameStatistics::nominalIntervalUs() const
+{
+    // Median of recent spacing - robust against the gaps we are trying to detect
+    if (m_intervalCount < INTERVAL_SAMPLES / 2) {
+        return 0;
+    }
+
+    std::array<qint64, INTERVAL_SAMPLES> sorted;
+    std::copy_n(m_intervals.begin(), m_intervalCount, sorted.begin());
+    auto middle = sorted.begin() + m_intervalCount / 2;
+    std::nth_element(sorted.begin(), middle, sorted.begin() + m_intervalCount);
+    return *middle;
+}
+
+void FrameStatistics::resetTimingLocked()
+{
+    // Frame spacing survives seeks; the wall-clock schedule and in-flight frames do not
+    m_lastPresentationTimeUs = -1;
+    m_hasBaseline = false;
+    for (PendingFrame& frame : m_pending) {
+        frame.settled = true;
+    }
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,132 @@
+#include "media/HardwareDecoding.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QStringList>
+#include <mutex>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr const char* DEVICE_TYPES_VARIABLE = "QT_FFMPEG_DECODING_HW_DEVICE_TYPES";
+constexpr const char* ENCODING_DEVICE_TYPES_VARIABLE = "QT_FFMPEG_ENCODING_HW_DEVICE_TYPES";
+
+std::mutex s_mutex;
+bool s_enabled = false;
+QList<HardwareDecodeApi> s_activeApis;
+
+// False if the user set the variable, which is kept
+bool setDeviceTypes(const char* variable, const QList<HardwareDecodeApi>& apis)
+{
+    if (qEnvironmentVariableIsSet(variable)) {
+        qDebug() << "HardwareDecoding: Keeping" << variable << "=" << qEnvironmentVariable(variable);
+        return false;
+    }
+
+    // No usable device type leaves FFmpeg with software only
+    QByteArrayList deviceTypes;
+    for (HardwareDecodeApi api : apis) {
+        deviceTypes.append(HardwareDecoding::ffmpegDeviceType(api));
+    }
+    qputenv(variable, deviceTypes.isEmpty() ? QByteArray("none") : deviceTypes.join(','));
+    return true;
+}
+
+} // namespace
+
+QList<HardwareDecodeApi> HardwareDecoding::probe()
+{
+    QList<HardwareDecodeApi> apis;
+
+#if defined(Q_OS_MACOS)
+    apis.append(HardwareDecodeApi::VideoToolbox);
+#elif defined(Q_OS_WIN)
+    apis.append(HardwareDecodeApi::D3D11VA);
+    apis.append(HardwareDecodeApi::Dxva2);
+#elif defined(Q_OS_LINUX)
+    // The NVIDIA driver decodes better through NVDEC than through its VA-API shim
+    if (QFileInfo::exists("/dev/nvidiactl") && QFileInfo::exists("/proc/driver/nvidia/version")) {
+        apis.append(HardwareDecodeApi::Nvdec);
+    }
+    if (!QDir("/dev/dri").entryList({"renderD*"}, QDir::System).isEmpty()) {
+        apis.append(HardwareDecodeApi::Vaapi);
+    }
+#endif
+
+    return apis;
+}
+
+void HardwareDecoding::configure(bool enabled)
+{
+    const QList<HardwareDecodeApi> apis = enabled ? probe() : QList<HardwareDecodeApi>{};
+
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_enabled = enabled && !apis.isEmpty();
+        s_activeApis = apis;
+    }
+
+    // Exports encode on the same devices; DXVA2 only decodes
+    QList<HardwareDecodeApi> encodeApis = apis;
+    encodeApis.removeAll(HardwareDecodeApi::Dxva2);
+    setDeviceTypes(ENCODING_DEVICE_TYPES_VARIABLE, encodeApis);
+
+    if (!setDeviceTypes(DEVICE_TYPES_VARIABLE, apis)) {
+        return;
+    }
+
+    QStringList names;
+    for (HardwareDecodeApi api : apis) {
+        names.append(apiName(api));
+    }
+    qDebug() << "HardwareDecoding:" << (names.isEmpty() ? QString("software only") : names.join(", "));
+}
+
+bool HardwareDecoding::isEnabled() noexcept
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_enabled;
+}
+
+QList<HardwareDecodeApi> HardwareDecoding::activeApis()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_activeApis;
+}
+
+QString HardwareDecoding::apiName(HardwareDecodeApi api)
+{
+    switch (api) {
+    case HardwareDecodeApi::Vaapi:
+        return "VA-API";
+    case HardwareDecodeApi::Nvdec:
+        return "NVDEC";
+    case HardwareDecodeApi::VideoToolbox:
+        return "VideoToolbox";
+    case HardwareDecodeApi::D3D11VA:
+        return "D3D11VA";
+    case HardwareDecodeApi::Dxva2:
+        return "DXVA2";
+    }
+    return {};
+}
+
+QByteArray HardwareDecoding::ffmpegDeviceType(HardwareDecodeApi api)
+{
+    switch (api) {
+    case HardwareDecodeApi::Vaapi:
+        return "vaapi";
+    case HardwareDecodeApi::Nvdec:
+        return "cuda";
+    case HardwareDecodeApi::VideoToolbox:
+        return "videotoolbox";
+    case HardwareDecodeApi::D3D11VA:
+        return "d3d11va";
+    case HardwareDecodeApi::Dxva2:
+        return "dxva2";
+    }
+    return {};
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,880 @@
+#include "media/KeyframeIndex.h"
+#include <QByteArrayView>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThread>
+#include <QtEndian>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x44504b46; // "DPKF"
+constexpr qint64 MAX_TABLE_BYTES = 64 * 1024 * 1024; // moov box or Matroska index element
+constexpr quint64 MAX_SAMPLES = 50000000;
+
+QDataStream& operator<<(QDataStream& stream, const KeyframeTable& table)
+{
+    return stream << table.keyframesMs << table.frameDurationUs << table.intraOnly;
+}
+
+QDataStream& operator>>(QDataStream& stream, KeyframeTable& table)
+{
+    return stream >> table.keyframesMs >> table.frameDurationUs >> table.intraOnly;
+}
+
+// Rounded up: seeking a millisecond early would decode from the previous keyframe
+qint64 toKeyframeMs(qint64 timeUs)
+{
+    return timeUs <= 0 ? 0 : (timeUs + 999) / 1000;
+}
+
+void finishTable(KeyframeTable& table)
+{
+    std::sort(table.keyframesMs.begin(), table.keyframesMs.end());
+    table.keyframesMs.erase(std::unique(table.keyframesMs.begin(), table.keyframesMs.end()), table.keyframesMs.end());
+}
+
+// --- MP4 / QuickTime: stss (sync samples) + stts/ctts (timing) + elst (presentation offset) ---
+
+struct Mp4Box {
+    QByteArrayView type;
+    QByteArrayView payload;
+};
+
+quint32 u32(QByteArrayView data, qsizetype offset)
+{
+    return qFromBigEndian<quint32>(data.data() + offset);
+}
+
+quint64 u64(QByteArrayView data, qsizetype offset)
+{
+    return qFromBigEndian<quint64>(data.data() + offset);
+}
+
+QList<Mp4Box> mp4Children(QByteArrayView data)
+{
+    QList<Mp4Box> boxes;
+    qsizetype offset = 0;
+    while (offset + 8 <= data.size()) {
+        quint64 size = u32(data, offset);
+        qsizetype headerSize = 8;
+        if (size == 1) {
+            if (offset + 16 > data.size()) {
+                break;
+            }
+            size = u64(data, offset + 8);
+            headerSize = 16;
+        } else if (size == 0) {
+            size = quint64(data.size() - offset);
+        }
+        if (size < quint64(headerSize) || size > quint64(data.size() - offset)) {
+            break;
+        }
+        boxes.append({data.sliced(offset + 4, 4), data.sliced(offset + headerSize, qsizetype(size) - headerSize)});
+        offset += qsizetype(size);
+    }
+    return boxes;
+}
+
+std::optional<QByteArrayView> mp4Child(QByteArrayView data, QByteArrayView type)
+{
+    for (const Mp4Box& box : mp4Children(data)) {
+        if (box.type == type) {
+            return box.payload;
+        }
+    }
+    return std::nullopt;
+}
+
+// Timescale field of mvhd/mdhd, which sits after 32- or 64-bit creation/modification times
+std::optional<quint32> mp4Timescale(QByteArrayView header)
+{
+    if (header.isEmpty()) {
+        return std::nullopt;
+    }
+    const qsizetype offset = header[0] == 1 ? 20 : 12;
+    if (header.size() < offset + 4 || u32(header, offset) == 0) {
+        return std::nullopt;
+    }
+    return u32(header, offset);
+}
+
+std::optional<QByteArray> readMp4Moov(QFile& file)
+{
+    const qint64 end = file.size();
+    qint64 offset = 0;
+    while (offset + 8 <= end) {
+        if (!file.seek(offset)) {
+            return std::nullopt;
+        }
+        const QByteArray header = file.read(16);
+        if (header.size() < 8) {
+            return std::nullopt;
+        }
+
+        quint64 size = u32(header, 0);
+        qint64 headerSize = 8;
+        if (size == 1) {
+            if (header.size() < 16) {
+                return std::nullopt;
+            }
+            size = u64(header, 8);
+            headerSize = 16;
+        } else if (size == 0) {
+            size = quint64(end - offset);
+        }
+        if (size < quint64(headerSize) || size > quint64(end - offset)) {
+            return std::nullopt;
+        }
+
+        if (QByteArrayView(header).sliced(4, 4) == QByteArrayView("moov")) {
+            if (qint64(size) - headerSize > MAX_TABLE_BYTES || !file.seek(offset + headerSize)) {
+                return std::nullopt;
+            }
+            QByteArray moov = file.read(qint64(size) - headerSize);
+            if (moov.size() != qint64(size) - headerSize) {
+                return std::nullopt;
+            }
+            return moov;
+        }
+        offset += qint64(size);
+    }
+    return std::nullopt;
+}
+
+std::optional<KeyframeTable> parseMp4Track(QByteArrayView trak, quint32 movieTimescale)
+{
+    const auto mdia = mp4Child(trak, "mdia");
+    if (!mdia) {
+        return std::nullopt;
+    }
+    const auto hdlr = mp4Child(*mdia, "hdlr");
+    if (!hdlr || hdlr->size() < 12 || hdlr->sliced(8, 4) != QByteArrayView("vide")) {
+        return std::nullopt;
+    }
+    const auto mdhd = mp4Child(*mdia, "mdhd");
+    const auto timescale = mdhd ? mp4Timescale(*mdhd) : std::nullopt;
+    const auto minf = mp4Child(*mdia, "minf");
+    const auto stbl = minf ? mp4Child(*minf, "stbl") : std::nullopt;
+    const auto stts = stbl ? mp4Child(*stbl, "stts") : std::nullopt;
+    if (!timescale || !stts || stts->size() < 8) {
+        return std::nullopt;
+    }
+
+    const quint32 sttsCount = u32(*stts, 4);
+    if (quint64(stts->size()) < 8 + quint64(sttsCount) * 8) {
+        return std::nullopt;
+    }
+
+    KeyframeTable table;
+
+    // The longest run of equal sample deltas is the nominal frame duration
+    quint32 longestRun = 0;
+    for (quint32 i = 0; i < sttsCount; ++i) {
+        const quint32 count = u32(*stts, 8 + qsizetype(i) * 8);
+        if (count > longestRun) {
+            longestRun = count;
+            table.frameDurationUs = qint64(u32(*stts, 12 + qsizetype(i) * 8)) * 1000000 / *timescale;
+        }
+    }
+
+    const auto stss = mp4Child(*stbl, "stss");
+    if (!stss) {
+        table.intraOnly = true; // No sync sample table: every sample is one
+        return table;
+    }
+    const quint32 syncCount = stss->size() >= 8 ? u32(*stss, 4) : 0;
+    if (syncCount > MAX_SAMPLES || quint64(stss->size()) < 8 + quint64(syncCount) * 4) {
+        return std::nullopt;
+    }
+
+    // B-frame reordering shifts presentation times by the ctts offset
+    const auto ctts = mp4Child(*stbl, "ctts");
+    quint32 cttsCount = ctts && ctts->size() >= 8 ? u32(*ctts, 4) : 0;
+    if (ctts && quint64(ctts->size()) < 8 + quint64(cttsCount) * 8) {
+        cttsCount = 0;
+    }
+
+    // The edit list maps media time to presentation time: empty edits delay, the first real one trims
+    qint64 mediaStart = 0;
+    qint64 emptyLeadUs = 0;
+    const auto edts = mp4Child(trak, "edts");
+    const auto elst = edts ? mp4Child(*edts, "elst") : std::nullopt;
+    if (elst && elst->size() >= 8) {
+        const bool wide = (*elst)[0] == 1;
+        const qsizetype entrySize = wide ? 20 : 12;
+        const quint32 count = u32(*elst, 4);
+        for (quint32 i = 0; i < count && 8 + qsizetype(i + 1) * entrySize <= elst->size(); ++i) {
+            const qsizetype entry = 8 + qsizetype(i) * entrySize;
+            const qint64 duration = wide ? qint64(u64(*elst, entry)) : qint64(u32(*elst, entry));
+            const qint64 mediaTime = wide ? qint64(u64(*elst, entry + 8)) : qint64(qint32(u32(*elst, entry + 4)));
+            if (mediaTime == -1) {
+                if (movieTimescale > 0) {
+                    emptyLeadUs += duration * 1000000 / movieTimescale;
+                }
+                continue;
+            }
+            mediaStart = mediaTime;
+            break;
+        }
+    }
+
+    // Sync sample numbers ascend, so both run-length tables are walked once
+    quint32 sttsEntry = 0;
+    quint64 sttsFirstSample = 1;
+    qint64 sttsBaseTime = 0;
+    quint32 cttsEntry = 0;
+    quint64 cttsFirstSample = 1;
+
+    table.keyframesMs.reserve(syncCount);
+    for (quint32 i = 0; i < syncCount; ++i) {
+        const quint64 sample = u32(*stss, 8 + qsizetype(i) * 4);
+        if (sample == 0) {
+            continue; // Sample numbers start at 1
+        }
+
+        while (sttsEntry < sttsCount && sample >= sttsFirstSample + u32(*stts, 8 + qsizetype(sttsEntry) * 8)) {
+            const quint32 count = u32(*stts, 8 + qsizetype(sttsEntry) * 8);
+            sttsBaseTime += qint64(count) * u32(*stts, 12 + qsizetype(sttsEntry) * 8);
+            sttsFirstSample += count;
+            ++sttsEntry;
+        }
+        if (sttsEntry >= sttsCount) {
+            break; // Sync sample beyond the timing table
+        }
+        qint64 time = sttsBaseTime + qint64(sample - sttsFirstSample) * u32(*stts, 12 + qsizetype(sttsEntry) * 8);
+
+        while (cttsEntry < cttsCount && sample >= cttsFirstSample + u32(*ctts, 8 + qsizetype(cttsEntry) * 8)) {
+            cttsFirstSample += u32(*ctts, 8 + qsizetype(cttsEntry) * 8);
+            ++cttsEntry;
+        }
+        if (cttsEntry < cttsCount) {
+            time += qint32(u32(*ctts, 12 + qsizetype(cttsEntry) * 8));
+        }
+
+        table.keyframesMs.append(toKeyframeMs((time - mediaStart) * 1000000 / *timescale + emptyLeadUs));
+    }
+
+    finishTable(table);
+    return table;
+}
+
+std::optional<KeyframeTable> parseMp4(QFile& file)
+{
+    const std::optional<QByteArray> moov = readMp4Moov(file);
+    if (!moov) {
+        return std::nullopt; // Fragmented files keep their index in moof boxes, which are not read
+    }
+
+    const auto mvhd = mp4Child(*moov, "mvhd");
+    const quint32 movieTimescale = mvhd ? mp4Timescale(*mvhd).value_or(0) : 0;
+    for (const Mp4Box& box : mp4Children(*moov)) {
+        if (box.type == QByteArrayView("trak")) {
+            if (auto table = parseMp4Track(box.payload, movieTimescale)) {
+                return table;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+// --- Matroska / WebM: Cues, scaled by Info/TimecodeScale ---
+
+constexpr quint32 EBML_HEADER_ID = 0x1A45DFA3;
+constexpr quint32 SEGMENT_ID = 0x18538067;
+constexpr quint32 SEEK_HEAD_ID = 0x114D9B74;
+constexpr quint32 SEEK_ID = 0x4DBB;
+constexpr quint32 SEEK_ID_ID = 0x53AB;
+constexpr quint32 SEEK_POSITION_ID = 0x53AC;
+constexpr quint32 INFO_ID = 0x1549A966;
+constexpr quint32 TIMECODE_SCALE_ID = 0x2AD7B1;
+constexpr quint32 TRACKS_ID = 0x1654AE6B;
+constexpr quint32 TRACK_ENTRY_ID = 0xAE;
+constexpr quint32 TRACK_NUMBER_ID = 0xD7;
+constexpr quint32 TRACK_TYPE_ID = 0x83;
+constexpr quint32 DEFAULT_DURATION_ID = 0x23E383;
+constexpr quint32 CLUSTER_ID = 0x1F43B675;
+constexpr quint32 CUES_ID = 0x1C53BB6B;
+constexpr quint32 CUE_POINT_ID = 0xBB;
+constexpr quint32 CUE_TIME_ID = 0xB3;
+constexpr quint32 CUE_TRACK_POSITIONS_ID = 0xB7;
+constexpr quint32 CUE_TRACK_ID = 0xF7;
+constexpr quint64 MATROSKA_VIDEO_TRACK = 1;
+
+struct EbmlElement {
+    quint32 id{0};
+    QByteArrayView payload;
+};
+
+struct EbmlHeader {
+    quint32 id{0};
+    qint64 dataOffset{0};
+    qint64 size{0};
+    bool unknownSize{false};
+};
+
+// Variable-length integer; ids keep their length marker, sizes drop it
+bool readVint(QByteArrayView data, qsizetype& offset, quint64& value, bool keepMarker, bool* allOnes = nullptr)
+{
+    if (offset >= data.size()) {
+        return false;
+    }
+    const quint8 first = quint8(data[offset]);
+    int length = 1;
+    quint8 marker = 0x80;
+    while (length <= 8 && !(first & marker)) {
+        marker >>= 1;
+        ++length;
+    }
+    if (length > 8 || offset + length > data.size()) {
+        return false;
+    }
+
+    const quint8 valueBits = quint8(marker - 1);
+    quint64 result = keepMarker ? first : (first & valueBits);
+    bool unknown = (first & valueBits) == valueBits;
+    for (int i = 1; i < length; ++i) {
+        const quint8 byte = quint8(data[offset + i]);
+        result = (result << 8) | byte;
+        unknown = unknown && byte == 0xFF;
+    }
+
+    offset += length;
+    value = result;
+    if (allOnes) {
+        *allOnes = unknown;
+    }
+    return true;
+}
+
+quint64 ebmlUnsigned(QByteArrayView payload)
+{
+    quint64 value = 0;
+    for (qsizetype i = 0; i < payload.size() && i < 8; ++i) {
+        value = (value << 8) | quint8(payload[i]);
+    }
+    return value;
+}
+
+QList<EbmlElement> ebmlChildren(QByteArrayView data)
+{
+    QList<EbmlElement> elements;
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        quint64 id = 0;
+        quint64 size = 0;
+        bool unknownSize = false;
+        if (!readVint(data, offset, id, true) || !readVint(data, offset, size, false, &unknownSize)
+            || unknownSize || size > quint64(data.size() - offset)) {
+            break;
+        }
+        elements.append({quint32(id), data.sliced(offset, qsizetype(size))});
+        offset += qsizetype(size);
+    }
+    return elements;
+}
+
+std::optional<EbmlHeader> readEbmlHeader(QFile& file, qint64 offset)
+{
+    if (!file.seek(offset)) {
+        return std::nullopt;
+    }
+    const QByteArray bytes = file.read(12);
+    qsizetype position = 0;
+    quint64 id = 0;
+    quint64 size = 0;
+    EbmlHeader header;
+    if (!readVint(bytes, position, id, true) || !readVint(bytes, position, size, false, &header.unknownSize)) {
+        return std::nullopt;
+    }
+    header.id = quint32(id);
+    header.dataOffset = offset + position;
+    header.size = header.unknownSize ? -1 : qint64(size);
+    return header;
+}
+
+std::optional<QByteArray> readEbmlPayload(QFile& file, const EbmlHeader& header)
+{
+    if (header.unknownSize || header.size > MAX_TABLE_BYTES || !file.seek(header.dataOffset)) {
+        return std::nullopt;
+    }
+    QByteArray payload = file.read(header.size);
+    if (payload.size() != header.size) {
+        return std::nullopt;
+    }
+    return payload;
+}
+
+std::optional<KeyframeTable> parseMatroska(QFile& file)
+{
+    const auto ebml = readEbmlHeader(file, 0);
+    if (!ebml || ebml->id != EBML_HEADER_ID || ebml->unknownSize) {
+        return std::nullopt;
+    }
+    const auto segment = readEbmlHeader(file, ebml->dataOffset + ebml->size);
+    if (!segment || segment->id != SEGMENT_ID) {
+        return std::nullopt;
+    }
+    const qint64 segmentStart = segment->dataOffset;
+    const qint64 segmentEnd = segment->unknownSize ? file.size() : qMin(file.size(), segmentStart + segment->size);
+
+    // Level-1 elements before the first cluster are read in place; the seek head points at the rest
+    QHash<quint32, QByteArray> elements;
+    QHash<quint32, qint64> seekPositions;
+    qint64 offset = segmentStart;
+    while (offset < segmentEnd) {
+        const auto header = readEbmlHeader(file, offset);
+        if (!header || header->unknownSize || header->id == CLUSTER_ID) {
+            break;
+        }
+        if (header->id == SEEK_HEAD_ID || header->id == INFO_ID || header->id == TRACKS_ID || header->id == CUES_ID) {
+            if (auto payload = readEbmlPayload(file, *header)) {
+                elements.insert(header->id, *payload);
+            }
+        }
+        offset = header->dataOffset + header->size;
+    }
+
+    const QByteArray seekHead = elements.value(SEEK_HEAD_ID);
+    for (const EbmlElement& seek : ebmlChildren(seekHead)) {
+        if (seek.id != SEEK_ID) {
+            continue;
+        }
+        quint32 targetId = 0;
+        qint64 position = -1;
+        for (const EbmlElement& field : ebmlChildren(seek.payload)) {
+            if (field.id == SEEK_ID_ID) {
+                targetId = quint32(ebmlUnsigned(field.payload));
+            } else if (field.id == SEEK_POSITION_ID) {
+                position = qint64(ebmlUnsigned(field.payload));
+            }
+        }
+        if (targetId != 0 && position >= 0 && !seekPositions.contains(targetId)) {
+            seekPositions.insert(targetId, position);
+        }
+    }
+
+    for (const quint32 id : {INFO_ID, TRACKS_ID, CUES_ID}) {
+        if (elements.contains(id) || !seekPositions.contains(id)) {
+            continue;
+        }
+        const auto header = readEbmlHeader(file, segmentStart + seekPositions.value(id));
+        if (header && header->id == id) {
+            if (auto payload = readEbmlPayload(file, *header)) {
+                elements.insert(id, *payload);
+            }
+        }
+    }
+
+    if (!elements.contains(CUES_ID)) {
+        return std::nullopt;
+    }
+    const QByteArray info = elements.value(INFO_ID);
+    const QByteArray tracks = elements.value(TRACKS_ID);
+    const QByteArray cues = elements.value(CUES_ID);
+
+    quint64 timecodeScaleNs = 1000000;
+    for (const EbmlElement& field : ebmlChildren(info)) {
+        if (field.id == TIMECODE_SCALE_ID && ebmlUnsigned(field.payload) > 0) {
+            timecodeScaleNs = ebmlUnsigned(field.payload);
+        }
+    }
+
+    KeyframeTable table;
+    quint64 videoTrack = 0;
+    for (const EbmlElement& entry : ebmlChildren(tracks)) {
+        if (entry.id != TRACK_ENTRY_ID) {
+            continue;
+        }
+        quint64 number = 0;
+        quint64 type = 0;
+        quint64 defaultDurationNs = 0;
+        for (const EbmlElement& field : ebmlChildren(entry.payload)) {
+            if (field.id == TRACK_NUMBER_ID) {
+                number = ebmlUnsigned(field.payload);
+            } else if (field.id == TRACK_TYPE_ID) {
+                type = ebmlUnsigned(field.payload);
+            } else if (field.id == DEFAULT_DURATION_ID) {
+                defaultDurationNs = ebmlUnsigned(field.payload);
+            }
+        }
+        if (type == MATROSKA_VIDEO_TRACK) {
+            videoTrack = number;
+            table.frameDurationUs = qint64(defaultDurationNs / 1000);
+            break;
+        }
+    }
+    if (videoTrack == 0) {
+        return std::nullopt;
+    }
+
+    // Cue points are written for video keyframes; audio-only cues would name another track
+    for (const EbmlElement& point : ebmlChildren(cues)) {
+        if (point.id != CUE_POINT_ID) {
+            continue;
+        }
+        std::optional<quint64> time;
+        bool videoCue = false;
+        for (const EbmlElement& field : ebmlChildren(point.payload)) {
+            if (field.id == CUE_TIME_ID) {
+                time = ebmlUnsigned(field.payload);
+            } else if (field.id == CUE_TRACK_POSITIONS_ID) {
+                for (const EbmlElement& position : ebmlChildren(field.payload)) {
+                    if (position.id == CUE_TRACK_ID && ebmlUnsigned(position.payload) == videoTrack) {
+                        videoCue = true;
+                    }
+                }
+            }
+        }
+        if (time && videoCue) {
+            table.keyframesMs.append(toKeyframeMs(qint64(*time * timecodeScaleNs / 1000)));
+        }
+    }
+
+    if (table.keyframesMs.isEmpty()) {
+        return std::nullopt;
+    }
+    finishTable(table);
+    return table;
+}
+
+} // namespace
+
+qint64 KeyframeTable::nearest(qint64 positionMs) const
+{
+    if (keyframesMs.isEmpty()) {
+        return positionMs;
+    }
+    const auto next = std::lower_bound(keyframesMs.cbegin(), keyframesMs.cend(), positionMs);
+    if (next == keyframesMs.cbegin()) {
+        return *next;
+    }
+    if (next == keyframesMs.cend()) {
+        return keyframesMs.last();
+    }
+    const qint64 previous = *(next - 1);
+    return (positionMs - previous) <= (*next - positionMs) ? previous : *next;
+}
+
+std::optional<qint64> KeyframeTable::after(qint64 positionMs) const
+{
+    const auto next = std::upper_bound(keyframesMs.cbegin(), keyframesMs.cend(), positionMs);
+    if (next == keyframesMs.cend()) {
+        return std::nullopt;
+    }
+    return *next;
+}
+
+std::optional<qint64> KeyframeTable::before(qint64 positionMs) const
+{
+    const auto next = std::lower_bound(keyframesMs.cbegin(), keyframesMs.cend(), positionMs);
+    if (next == keyframesMs.cbegin()) {
+        return std::nullopt;
+    }
+    return *(next - 1);
+}
+
+KeyframeIndex* KeyframeIndex::instance()
+{
+    // Parented to the application so it dies before the multimedia backend
+    static QPointer<KeyframeIndex> s_instance;
+    if (!s_instance) {
+        s_instance = new KeyframeIndex(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+KeyframeIndex::KeyframeIndex(QObject* parent)
+    : QObject(parent)
+    , m_loadRequested(false)
+    , m_loaded(false)
+    , m_dirty(false)
+{
+    m_ioPool.setMaxThreadCount(1);
+    m_buildPool.setMaxThreadCount(1);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DELAY_MS);
+    connect(&m_saveTimer, &QTimer::timeout, this, &KeyframeIndex::save);
+}
+
+KeyframeIndex::~KeyframeIndex()
+{
+    m_buildPool.clear();
+    m_buildPool.waitForDone();
+    m_ioPool.waitForDone();
+
+    // Last chance to persist; the event loop is already gone
+    if (m_dirty && m_loaded) {
+        writeIndex(indexPath(), m_entries);
+    }
+}
+
+std::optional<KeyframeTable> KeyframeIndex::lookup(const QString& filePath)
+{
+    ensureLoaded();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(filePath);
+    if (it == m_entries.end()) {
+        return std::nullopt;
+    }
+
+    // A changed file is a different file
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile() || fileInfo.size() != it->size
+        || fileInfo.lastModified().toMSecsSinceEpoch() != it->modifiedMs) {
+        m_entries.erase(it);
+        scheduleSave();
+        return std::nullopt;
+    }
+
+    it->lastUsedSecs = QDateTime::currentSecsSinceEpoch();
+    return it->table;
+}
+
+void KeyframeIndex::request(const QString& filePath)
+{
+    ensureLoaded();
+
+    if (!m_loaded) {
+        m_pendingRequests.append(filePath);
+        return;
+    }
+    if (filePath.isEmpty() || m_requested.contains(filePath) || lookup(filePath)) {
+        return;
+    }
+    m_requested.insert(filePath);
+
+    QPointer<KeyframeIndex> self(this);
+    m_buildPool.start([self, filePath]() {
+        // Shares the disk with playback; stay out of its way
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+
+        const QFileInfo fileInfo(filePath);
+        const qint64 size = fileInfo.size();
+        const qint64 modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+
+        QElapsedTimer timer;
+        timer.start();
+        const std::optional<KeyframeTable> table = build(filePath);
+        if (!table) {
+            return;
+        }
+        qDebug() << "KeyframeIndex: Indexed" << table->keyframesMs.size() << "keyframes of"
+                 << fileInfo.fileName() << "in" << timer.elapsed() << "ms";
+
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self, filePath, size, modifiedMs, result = *table]() {
+                if (self) {
+                    self->onBuilt(filePath, size, modifiedMs, result);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void KeyframeIndex::ensureLoaded()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_loadRequested) {
+            return;
+        }
+        m_loadRequested = true;
+    }
+
+    QPointer<KeyframeIndex> self(this);
+    m_ioPool.start([self, path = indexPath()]() {
+        const QHash<QString, Entry> entries = readIndex(path);
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self, entries]() {
+                if (self) {
+                    self->onLoaded(entries);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void KeyframeIndex::onLoaded(const QHash<QString, Entry>& entries)
+{
+    {
+        // Anything built while loading is newer than the index
+        std::lock_guard<std::mutex> lock(m_mutex);
+        QHash<QString, Entry> merged = entries;
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            merged.insert(it.key(), it.value());
+        }
+        m_entries = std::move(merged);
+        m_loaded = true;
+    }
+
+    const QStringList pending = std::exchange(m_pendingRequests, {});
+    for (const QString& filePath : pending) {
+        if (lookup(filePath)) {
+            emit tableAvailable(filePath);
+        } else {
+            request(filePath);
+        }
+    }
+}
+
+void KeyframeIndex::onBuilt(const QString& filePath, qint64 size, qint64 modifiedMs, const KeyframeTable& table)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry& entry = m_entries[filePath];
+        entry.size = size;
+        entry.modifiedMs = modifiedMs;
+        entry.lastUsedSecs = QDateTime::currentSecsSinceEpoch();
+        entry.table = table;
+        scheduleSave();
+    }
+    emit tableAvailable(filePath);
+}
+
+void KeyframeIndex::scheduleSave()
+{
+    // m_mutex is held; a lookup on the engine thread can get here, but the timer is ours
+    m_dirty = true;
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() {
+            if (!m_saveTimer.isActive()) {
+                m_saveTimer.start();
+            }
+        }, Qt::QueuedConnection);
+    } else if (!m_saveTimer.isActive()) {
+        m_saveTimer.start();
+    }
+}
+
+void KeyframeIndex::save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_dirty) {
+        return;
+    }
+    if (!m_loaded) {
+        m_saveTimer.start(); // Never overwrite an index we have not merged yet
+        return;
+    }
+
+    m_dirty = false;
+    m_ioPool.start([path = indexPath(), entries = m_entries]() { writeIndex(path, entries); });
+}
+
+std::optional<KeyframeTable> KeyframeIndex::build(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    const QByteArray head = file.peek(8);
+    if (head.size() < 8) {
+        return std::nullopt;
+    }
+    if (qFromBigEndian<quint32>(head.constData()) == EBML_HEADER_ID) {
+        return parseMatroska(file);
+    }
+
+    static const QList<QByteArrayView> mp4FirstBoxes = {"ftyp", "moov", "mdat", "free", "skip", "wide"};
+    if (mp4FirstBoxes.contains(QByteArrayView(head).sliced(4, 4))) {
+        return parseMp4(file);
+    }
+    return std::nullopt;
+}
+
+QString KeyframeIndex::indexPath()
+{
+    // Next to MetadataCache's index
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/keyframes.cache";
+}
+
+QHash<QString, KeyframeIndex::Entry> KeyframeIndex::readIndex(const QString& path)
+{
+    QHash<QString, Entry> entries;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entries;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_FORMAT_VERSION || count < 0) {
+        return entries;
+    }
+
+    // The count comes from disk; a corrupt one must not size the hash. A short file ends the loop
+    entries.reserve(std::min(count, qint32(MAX_ENTRIES)));
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString filePath;
+        Entry entry;
+        stream >> filePath >> entry.size >> entry.modifiedMs >> entry.lastUsedSecs >> entry.table;
+        if (stream.status() == QDataStream::Ok) {
+            entries.insert(filePath, entry);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "KeyframeIndex: Index is truncated, kept" << entries.size() << "entries";
+    }
+    return entries;
+}
+
+void KeyframeIndex::writeIndex(const QString& path, QHash<QString, Entry> entries)
+{
+    // Least recently used tables go first once the index is full
+    if (entries.size() > MAX_ENTRIES) {
+        QList<qint64> lastUsed;
+        lastUsed.reserve(entries.size());
+        for (const Entry& entry : std::as_const(entries)) {
+            lastUsed.append(entry.lastUsedSecs);
+        }
+        const auto cutoff = lastUsed.begin() + (entries.size() - MAX_ENTRIES);
+        std::nth_element(lastUsed.begin(), cutoff, lastUsed.end());
+        const qint64 threshold = *cutoff;
+        entries.removeIf([threshold](const QHash<QString, Entry>::iterator& it) {
+            return it.value().lastUsedSecs < threshold;
+        });
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "KeyframeIndex: Cannot write" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << INDEX_MAGIC << qint32(INDEX_FORMAT_VERSION) << qint32(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        stream << it.key() << it->size << it->modifiedMs << it->lastUsedSecs << it->table;
+    }
+
+    if (!file.commit()) {
+        qWarning() << "KeyframeIndex: Failed to save index";
+    }
+}
+
+} // namespace DarkPlay::Media
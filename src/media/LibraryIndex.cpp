@@ -0,0 +1,262 @@
+#include "media/LibraryIndex.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <iterator>
+
+namespace DarkPlay::Media {
+
+LibraryIndex::LibraryIndex()
+    : m_holes(0)
+{
+}
+
+bool LibraryIndex::insert(const LibraryFile& file)
+{
+    const auto existing = m_byPath.constFind(file.path);
+    if (existing != m_byPath.cend()) {
+        // Same path, same name: the trigrams stay as they are
+        Item& item = m_items[*existing];
+        if (item.size == file.size && item.modifiedMs == file.modifiedMs && item.type == file.type) {
+            return false;
+        }
+        item.size = file.size;
+        item.modifiedMs = file.modifiedMs;
+        item.type = file.type;
+        return true;
+    }
+
+    const qsizetype slash = file.path.lastIndexOf(u'/');
+    Item item;
+    item.path = file.path;
+    item.nameOffset = static_cast<quint32>(slash + 1);
+    item.foldedName = QStringView(file.path).mid(slash + 1).toString().toCaseFolded();
+    item.size = file.size;
+    item.modifiedMs = file.modifiedMs;
+    item.type = file.type;
+    item.alive = true;
+
+    const auto id = static_cast<ItemId>(m_items.size());
+    m_items.push_back(std::move(item));
+    m_byPath.insert(file.path, id);
+    m_byDirectory[parentOf(file.path)].push_back(id);
+    indexItem(id);
+    return true;
+}
+
+bool LibraryIndex::remove(const QString& path)
+{
+    const auto it = m_byPath.constFind(path);
+    if (it == m_byPath.cend()) {
+        return false;
+    }
+    const ItemId id = *it;
+
+    const auto directory = m_byDirectory.find(parentOf(path));
+    if (directory != m_byDirectory.end()) {
+        std::erase(*directory, id);
+        if (directory->empty()) {
+            m_byDirectory.erase(directory);
+        }
+    }
+    kill(id);
+    compactIfSparse();
+    return true;
+}
+
+int LibraryIndex::removeUnder(const QString& directory)
+{
+    const QString prefix = directory + u'/';
+    int removed = 0;
+    for (auto it = m_byDirectory.begin(); it != m_byDirectory.end();) {
+        if (it.key() != directory && !it.key().startsWith(prefix)) {
+            ++it;
+            continue;
+        }
+        for (ItemId id : *it) {
+            kill(id);
+            ++removed;
+        }
+        it = m_byDirectory.erase(it);
+    }
+    compactIfSparse();
+    return removed;
+}
+
+void LibraryIndex::clear()
+{
+    m_items.clear();
+    m_byPath.clear();
+    m_byDirectory.clear();
+    m_postings.clear();
+    m_holes = 0;
+}
+
+std::vector<LibraryFile> LibraryIndex::filesIn(const QString& directory) const
+{
+    std::vector<LibraryFile> files;
+    const auto it = m_byDirectory.constFind(directory);
+    if (it != m_byDirectory.cend()) {
+        files.reserve(it->size());
+        for (ItemId id : *it) {
+            files.push_back(fileOf(m_items[id]));
+        }
+    }
+    return files;
+}
+
+LibrarySearchResult LibraryIndex::search(const LibraryQuery& query) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    LibrarySearchResult result;
+    const QString folded = query.text.simplified().toCaseFolded();
+    const QList<QStringView> words = QStringView(folded).split(u' ', Qt::SkipEmptyParts);
+    const QString folderPrefix = query.folder.isEmpty() ? QString() : query.folder + u'/';
+
+    auto consider = [&](ItemId id) {
+        const Item& item = m_items[id];
+        if (!item.alive || (query.type != MediaType::Unknown && item.type != query.type)) {
+            return;
+        }
+        if (!folderPrefix.isEmpty() && !item.path.startsWith(folderPrefix)) {
+            return;
+        }
+        // Trigrams only say the pieces occur somewhere; the words must occur whole
+        for (QStringView word : words) {
+            if (!QStringView(item.foldedName).contains(word)) {
+                return;
+            }
+        }
+        ++result.matchCount;
+        if (result.entries.size() < query.limit) {
+            LibraryEntry entry;
+            entry.path = item.path;
+            entry.name = item.path.mid(item.nameOffset);
+            entry.type = item.type;
+            entry.size = item.size;
+            entry.modifiedMs = item.modifiedMs;
+            result.entries.append(std::move(entry));
+        }
+    };
+
+    std::vector<Trigram> trigrams;
+    for (QStringView word : words) {
+        trigramsOf(word, trigrams);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    if (trigrams.empty()) {
+        for (size_t id = 0; id < m_items.size(); ++id) {
+            consider(static_cast<ItemId>(id));
+        }
+    } else {
+        std::vector<const std::vector<ItemId>*> postings;
+        postings.reserve(trigrams.size());
+        for (Trigram trigram : trigrams) {
+            const auto it = m_postings.constFind(trigram);
+            if (it == m_postings.cend()) {
+                result.elapsedUs = timer.nsecsElapsed() / 1000;
+                return result; // No name has this piece at all
+            }
+            postings.push_back(&*it);
+        }
+
+        // Smallest first keeps every intermediate set as small as it can be
+        std::sort(postings.begin(), postings.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+        std::vector<ItemId> candidates = *postings.front();
+        std::vector<ItemId> narrowed;
+        for (size_t i = 1; i < postings.size() && !candidates.empty(); ++i) {
+            narrowed.clear();
+            std::set_intersection(candidates.begin(), candidates.end(), postings[i]->begin(), postings[i]->end(),
+                                  std::back_inserter(narrowed));
+            candidates.swap(narrowed);
+        }
+        for (ItemId id : candidates) {
+            consider(id);
+        }
+    }
+
+    result.elapsedUs = timer.nsecsElapsed() / 1000;
+    return result;
+}
+
+void LibraryIndex::indexItem(ItemId id)
+{
+    std::vector<Trigram> trigrams;
+    trigramsOf(m_items[id].foldedName, trigrams);
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    // Ids only grow, so appending keeps every list sorted
+    for (Trigram trigram : trigrams) {
+        m_postings[trigram].push_back(id);
+    }
+}
+
+void LibraryIndex::kill(ItemId id)
+{
+    Item& item = m_items[id];
+    if (!item.alive) {
+        return;
+    }
+    m_byPath.remove(item.path);
+    item.alive = false;
+    item.path.clear();
+    item.foldedName.clear();
+    ++m_holes;
+}
+
+void LibraryIndex::compactIfSparse()
+{
+    if (m_holes < MIN_COMPACT_HOLES || m_holes < count()) {
+        return;
+    }
+
+    // Renumber the live items and rebuild the lists around them
+    std::vector<Item> items;
+    items.reserve(m_byPath.size());
+    for (Item& item : m_items) {
+        if (item.alive) {
+            items.push_back(std::move(item));
+        }
+    }
+
+    m_items = std::move(items);
+    m_byPath.clear();
+    m_byDirectory.clear();
+    m_postings.clear();
+    m_holes = 0;
+    for (size_t i = 0; i < m_items.size(); ++i) {
+        const auto id = static_cast<ItemId>(i);
+        m_byPath.insert(m_items[i].path, id);
+        m_byDirectory[parentOf(m_items[i].path)].push_back(id);
+        indexItem(id);
+    }
+}
+
+LibraryFile LibraryIndex::fileOf(const Item& item) const
+{
+    LibraryFile file;
+    file.path = item.path;
+    file.size = item.size;
+    file.modifiedMs = item.modifiedMs;
+    file.type = item.type;
+    return file;
+}
+
+void LibraryIndex::trigramsOf(QStringView text, std::vector<Trigram>& trigrams)
+{
+    for (qsizetype i = 0; i + 2 < text.size(); ++i) {
+        trigrams.push_back((Trigram(text[i].unicode()) << 32) | (Trigram(text[i + 1].unicode()) << 16)
+                           | Trigram(text[i + 2].unicode()));
+    }
+}
+
+QString LibraryIndex::parentOf(const QString& path)
+{
+    return path.left(path.lastIndexOf(u'/'));
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,247 @@
+#include "media/LibraryScanner.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QMimeDatabase>
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr int MIN_SCAN_THREADS = 4;
+constexpr int MAX_SCAN_THREADS = 16;
+constexpr size_t BATCH_FILES = 512;
+constexpr qsizetype BATCH_DIRECTORIES = 256;
+constexpr auto IDLE_WAIT = std::chrono::microseconds(500);
+
+// Per worker: the MIME database is only asked once per suffix
+class SuffixTypes
+{
+public:
+    MediaType typeOf(const QString& suffix)
+    {
+        const auto it = m_types.constFind(suffix);
+        if (it != m_types.cend()) {
+            return *it;
+        }
+
+        static const QMimeDatabase mimeDatabase;
+        const QString name = mimeDatabase.mimeTypeForFile(QStringLiteral("x.") + suffix,
+                                                          QMimeDatabase::MatchExtension).name();
+        MediaType type = MediaType::Unknown;
+        // Playlists carry audio/ MIME types but are not media themselves
+        if (!name.contains(QLatin1String("mpegurl")) && !name.contains(QLatin1String("scpls"))) {
+            if (name.startsWith(QLatin1String("video/"))) {
+                type = MediaType::Video;
+            } else if (name.startsWith(QLatin1String("audio/"))) {
+                type = MediaType::Audio;
+            }
+        }
+        m_types.insert(suffix, type);
+        return type;
+    }
+
+private:
+    QHash<QString, MediaType> m_types;
+};
+
+bool listInto(const QString& directory, SuffixTypes& types, DirectoryListing& listing)
+{
+    const QFileInfo directoryInfo(directory);
+    if (!directoryInfo.isDir()) {
+        return false;
+    }
+
+    QDirIterator it(directory, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Readable);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+
+        // The entry type comes with the listing; only media files cost a stat()
+        if (info.isDir()) {
+            if (!info.isSymLink()) {
+                listing.subdirectories.append(info.absoluteFilePath());
+            }
+            continue;
+        }
+        const MediaType type = types.typeOf(info.suffix().toLower());
+        if (type == MediaType::Unknown) {
+            continue;
+        }
+
+        LibraryFile file;
+        file.path = info.absoluteFilePath();
+        file.size = info.size();
+        file.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+        file.type = type;
+        listing.files.push_back(std::move(file));
+    }
+    return true;
+}
+
+class ScanRun
+{
+public:
+    ScanRun(int workers, const std::function<void(LibraryScanBatch&&)>& onBatch,
+            const std::function<bool()>& cancelled)
+        : m_queues(static_cast<size_t>(workers))
+        , m_onBatch(onBatch)
+        , m_cancelled(cancelled)
+    {
+    }
+
+    void seed(const QStringList& roots)
+    {
+        for (qsizetype i = 0; i < roots.size(); ++i) {
+            m_queues[static_cast<size_t>(i) % m_queues.size()].directories.push_back(roots.at(i));
+        }
+        m_pending.store(static_cast<int>(roots.size()), std::memory_order_release);
+    }
+
+    void work(size_t worker)
+    {
+        SuffixTypes types;
+        LibraryScanBatch batch;
+        QString directory;
+
+        while (!isCancelled()) {
+            if (!take(worker, directory)) {
+                if (m_pending.load(std::memory_order_acquire) == 0) {
+                    break;
+                }
+                // Someone is still listing and may publish subdirectories
+                std::this_thread::sleep_for(IDLE_WAIT);
+                continue;
+            }
+
+            DirectoryListing listing;
+            if (listInto(directory, types, listing)) {
+                // Queued before this directory counts as done, so the walk cannot look finished early
+                if (!listing.subdirectories.isEmpty()) {
+                    m_pending.fetch_add(static_cast<int>(listing.subdirectories.size()), std::memory_order_acq_rel);
+                    WorkQueue& queue = m_queues[worker];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    queue.directories.insert(queue.directories.end(),
+                                             listing.subdirectories.cbegin(), listing.subdirectories.cend());
+                }
+                batch.directories.append(directory);
+                m_files.fetch_add(static_cast<int>(listing.files.size()), std::memory_order_relaxed);
+                for (LibraryFile& file : listing.files) {
+                    batch.files.push_back(std::move(file));
+                }
+                if (batch.files.size() >= BATCH_FILES || batch.directories.size() >= BATCH_DIRECTORIES) {
+                    flush(batch);
+                }
+            }
+            m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        flush(batch);
+    }
+
+    [[nodiscard]] int fileCount() const noexcept { return m_files.load(std::memory_order_relaxed); }
+    [[nodiscard]] bool isCancelled() const { return m_cancelled && m_cancelled(); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<QString> directories;
+    };
+
+    bool take(size_t worker, QString& directory)
+    {
+        // Own work newest first: depth-first keeps the worker inside one subtree
+        {
+            WorkQueue& own = m_queues[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.directories.empty()) {
+                directory = std::move(own.directories.back());
+                own.directories.pop_back();
+                return true;
+            }
+        }
+
+        // Stolen work oldest first: those are the directories nearest a root, the biggest subtrees
+        for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+            WorkQueue& victim = m_queues[(worker + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.directories.empty()) {
+                directory = std::move(victim.directories.front());
+                victim.directories.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void flush(LibraryScanBatch& batch)
+    {
+        if (batch.files.empty() && batch.directories.isEmpty()) {
+            return;
+        }
+        if (m_onBatch) {
+            m_onBatch(std::move(batch));
+        }
+        batch = LibraryScanBatch();
+    }
+
+    std::vector<WorkQueue> m_queues;
+    std::atomic<int> m_pending{0}; // Directories queued or being listed
+    std::atomic<int> m_files{0};
+    const std::function<void(LibraryScanBatch&&)>& m_onBatch;
+    const std::function<bool()>& m_cancelled;
+};
+
+} // namespace
+
+namespace LibraryScanner {
+
+int defaultThreadCount()
+{
+    return qBound(MIN_SCAN_THREADS, QThread::idealThreadCount() * 2, MAX_SCAN_THREADS);
+}
+
+int scan(const QStringList& roots, int threadCount,
+         const std::function<void(LibraryScanBatch&&)>& onBatch,
+         const std::function<bool()>& cancelled)
+{
+    if (roots.isEmpty()) {
+        return 0;
+    }
+
+    const int workers = qBound(1, threadCount, MAX_SCAN_THREADS);
+    ScanRun run(workers, onBatch, cancelled);
+    run.seed(roots);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(workers);
+    for (int i = 0; i < workers; ++i) {
+        pool.start([&run, i]() { run.work(static_cast<size_t>(i)); });
+    }
+    pool.waitForDone();
+
+    return run.isCancelled() ? -1 : run.fileCount();
+}
+
+std::optional<DirectoryListing> listDirectory(const QString& directory)
+{
+    SuffixTypes types;
+    DirectoryListing listing;
+    if (!listInto(directory, types, listing)) {
+        return std::nullopt;
+    }
+    return listing;
+}
+
+} // namespace LibraryScanner
+
+} // namespace DarkPlay::Media
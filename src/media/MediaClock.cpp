@@ -0,0 +1,138 @@
+#include "media/MediaClock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace DarkPlay::Media {
+
+MediaClock::MediaClock()
+    : m_epochNs(0)
+    , m_rate(1.0)
+    , m_paused(true)
+    , m_smoothedDriftUs(0.0)
+    , m_windowMaxDriftUs(0)
+    , m_previousWindowMaxDriftUs(0)
+    , m_windowStartMs(0)
+    , m_driftSamples(0)
+{
+    m_wallClock.start();
+}
+
+bool MediaClock::load(const Utils::SeqLock<Anchor>& anchor, Anchor& value) noexcept
+{
+    return anchor.load(value) && value.mediaUs >= 0;
+}
+
+void MediaClock::reset(qint64 mediaUs) noexcept
+{
+    const qint64 now = wallNs();
+    m_epochNs.store(now);
+    m_engine.store(Anchor{mediaUs, now});
+}
+
+void MediaClock::setRate(double rate) noexcept
+{
+    // Re-anchored first, so the time already run keeps the old rate
+    const ClockReading current = reading();
+    if (current.nowUs >= 0 && current.source == ClockSource::Engine) {
+        m_engine.store(Anchor{current.nowUs, wallNs()});
+    }
+    m_rate.store(rate > 0.0 ? rate : 1.0, std::memory_order_relaxed);
+}
+
+void MediaClock::setPaused(bool paused) noexcept
+{
+    if (paused == m_paused.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // Frozen where it stopped; on resume audio from before the pause no longer counts
+    const qint64 now = wallNs();
+    const qint64 mediaUs = reading().nowUs;
+    if (!paused) {
+        m_epochNs.store(now);
+    }
+    m_engine.store(Anchor{mediaUs, now});
+    m_paused.store(paused, std::memory_order_release);
+}
+
+void MediaClock::updateFromEngine(qint64 mediaUs) noexcept
+{
+    // While paused too: a seek lands after the reset
+    m_engine.store(Anchor{mediaUs, wallNs()});
+}
+
+void MediaClock::updateFromAudio(qint64 mediaUs, qint64 wallNs) noexcept
+{
+    m_audio.store(Anchor{mediaUs, wallNs});
+}
+
+ClockReading MediaClock::reading() const noexcept
+{
+    ClockReading result;
+    result.rate = m_rate.load(std::memory_order_relaxed);
+    result.running = !m_paused.load(std::memory_order_acquire);
+
+    Anchor anchor;
+    const qint64 now = wallNs();
+    if (!result.running) {
+        if (load(m_engine, anchor)) {
+            result.nowUs = anchor.mediaUs;
+            result.source = ClockSource::Engine;
+        }
+        return result;
+    }
+
+    if (load(m_audio, anchor) && anchor.wallNs >= m_epochNs.load() && now - anchor.wallNs < AUDIO_STALE_NS) {
+        result.source = ClockSource::Audio;
+    } else if (load(m_engine, anchor)) {
+        result.source = ClockSource::Engine;
+    } else {
+        return result;
+    }
+    result.nowUs = anchor.mediaUs + static_cast<qint64>(static_cast<double>(now - anchor.wallNs) / 1000.0 * result.rate);
+    return result;
+}
+
+void MediaClock::recordVideoPresented(qint64 frameStartUs)
+{
+    const ClockReading clock = reading();
+    // A frame shown while paused (seek, step) is on time by definition
+    if (frameStartUs < 0 || clock.nowUs < 0 || !clock.running) {
+        return;
+    }
+    const qint64 driftUs = frameStartUs - clock.nowUs;
+
+    std::lock_guard<std::mutex> lock(m_driftMutex);
+    const qint64 nowMs = wallNs() / 1000000;
+    if (nowMs - m_windowStartMs >= DRIFT_WINDOW_MS) {
+        m_previousWindowMaxDriftUs = m_windowMaxDriftUs;
+        m_windowMaxDriftUs = 0;
+        m_windowStartMs = nowMs;
+    }
+    if (std::abs(driftUs) > std::abs(m_windowMaxDriftUs)) {
+        m_windowMaxDriftUs = driftUs;
+    }
+    m_smoothedDriftUs = m_driftSamples == 0
+        ? static_cast<double>(driftUs)
+        : m_smoothedDriftUs + (static_cast<double>(driftUs) - m_smoothedDriftUs) * DRIFT_SMOOTHING;
+    ++m_driftSamples;
+}
+
+ClockStats MediaClock::stats() const
+{
+    const ClockReading clock = reading();
+    ClockStats stats;
+    stats.source = clock.source;
+    stats.rate = clock.rate;
+    stats.positionUs = clock.nowUs;
+
+    std::lock_guard<std::mutex> lock(m_driftMutex);
+    stats.driftUs = static_cast<qint64>(std::llround(m_smoothedDriftUs));
+    stats.maxDriftUs = std::abs(m_windowMaxDriftUs) >= std::abs(m_previousWindowMaxDriftUs)
+        ? m_windowMaxDriftUs
+        : m_previousWindowMaxDriftUs;
+    stats.driftSamples = m_driftSamples;
+    return stats;
+}
+
+} // namespace DarkPlay::Media
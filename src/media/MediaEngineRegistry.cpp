@@ -0,0 +1,100 @@
+#include "media/MediaEngineRegistry.h"
+#include "media/QtMediaEngine.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QPointer>
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+MediaEngineRegistry* MediaEngineRegistry::instance()
+{
+    // Parented to the application so it dies before the multimedia backend
+    static QPointer<MediaEngineRegistry> s_instance;
+    if (!s_instance) {
+        s_instance = new MediaEngineRegistry(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+MediaEngineRegistry::MediaEngineRegistry(QObject* parent)
+    : QObject(parent)
+{
+    // Qt's FFmpeg backend fixes its decode APIs per process (see HardwareDecoding)
+    registerEngine(EngineDescriptor{
+        BUILTIN_ENGINE_ID, "Qt Multimedia", QString(), 0, false,
+        [](const EngineOptions&) -> std::unique_ptr<IMediaEngine> {
+            return std::make_unique<QtMediaEngine>();
+        }});
+}
+
+void MediaEngineRegistry::registerEngine(EngineDescriptor descriptor)
+{
+    if (descriptor.id.isEmpty() || !descriptor.create) {
+        qWarning() << "MediaEngineRegistry: Ignoring incomplete engine" << descriptor.id;
+        return;
+    }
+
+    m_engines.removeIf([&descriptor](const EngineDescriptor& engine) { return engine.id == descriptor.id; });
+    const auto position = std::find_if(m_engines.begin(), m_engines.end(), [&descriptor](const EngineDescriptor& engine) {
+        return engine.priority < descriptor.priority;
+    });
+    qDebug() << "MediaEngineRegistry: Registered" << descriptor.id
+             << (descriptor.owner.isEmpty() ? QString() : QString("from %1").arg(descriptor.owner));
+    m_engines.insert(position, std::move(descriptor));
+    emit enginesChanged();
+}
+
+void MediaEngineRegistry::unregisterEngine(const QString& id)
+{
+    if (id == QLatin1String(BUILTIN_ENGINE_ID)) {
+        return; // Always there to fall back on
+    }
+    if (m_engines.removeIf([&id](const EngineDescriptor& engine) { return engine.id == id; }) > 0) {
+        emit enginesChanged();
+    }
+}
+
+void MediaEngineRegistry::unregisterOwner(const QString& owner)
+{
+    if (owner.isEmpty()) {
+        return;
+    }
+    if (m_engines.removeIf([&owner](const EngineDescriptor& engine) { return engine.owner == owner; }) > 0) {
+        emit enginesChanged();
+    }
+}
+
+QList<EngineDescriptor> MediaEngineRegistry::engines() const
+{
+    return m_engines;
+}
+
+std::optional<EngineDescriptor> MediaEngineRegistry::engine(const QString& id) const
+{
+    for (const EngineDescriptor& engine : m_engines) {
+        if (engine.id == id) {
+            return engine;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<EngineDescriptor> MediaEngineRegistry::select(const QString& id) const
+{
+    if (auto requested = engine(id)) {
+        return requested;
+    }
+    if (m_engines.isEmpty()) {
+        return std::nullopt;
+    }
+    return m_engines.first();
+}
+
+std::unique_ptr<IMediaEngine> MediaEngineRegistry::create(const QString& id, const EngineOptions& options) const
+{
+    const std::optional<EngineDescriptor> descriptor = engine(id);
+    return descriptor ? descriptor->create(options) : nullptr;
+}
+
+} // namespace DarkPlay::Media
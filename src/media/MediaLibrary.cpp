@@ -0,0 +1,324 @@
+#include "media/MediaLibrary.h"
+#include "media/MetadataCache.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMetaObject>
+
+namespace DarkPlay::Media {
+
+MediaLibrary::MediaLibrary(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_activeScans(0)
+    , m_unwatched(0)
+{
+    m_ioPool.setMaxThreadCount(1);
+
+    m_changeTimer.setSingleShot(true);
+    m_changeTimer.setInterval(CHANGE_SETTLE_MS);
+    connect(&m_changeTimer, &QTimer::timeout, this, &MediaLibrary::listChangedDirectories);
+
+    m_notifyTimer.setSingleShot(true);
+    m_notifyTimer.setInterval(NOTIFY_INTERVAL_MS);
+    connect(&m_notifyTimer, &QTimer::timeout, this, &MediaLibrary::contentsChanged);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &MediaLibrary::onDirectoryChanged);
+}
+
+MediaLibrary::~MediaLibrary()
+{
+    // Pool tasks hold a raw pointer to us; the new generation also stops a walk early
+    ++m_generation;
+    m_ioPool.waitForDone();
+}
+
+void MediaLibrary::setFolders(const QStringList& folders)
+{
+    QStringList normalized;
+    for (const QString& folder : folders) {
+        const QString path = normalizedFolder(folder);
+        if (!path.isEmpty() && !normalized.contains(path)) {
+            normalized.append(path);
+        }
+    }
+    if (normalized == m_folders) {
+        return;
+    }
+
+    QStringList added;
+    for (const QString& folder : normalized) {
+        if (!m_folders.contains(folder)) {
+            added.append(folder);
+        }
+    }
+    QStringList removed;
+    for (const QString& folder : std::as_const(m_folders)) {
+        if (!normalized.contains(folder)) {
+            removed.append(folder);
+        }
+    }
+
+    m_folders = normalized;
+
+    // A folder nested in one that stays keeps its files
+    bool changed = false;
+    for (const QString& folder : removed) {
+        if (isInFolders(folder)) {
+            continue;
+        }
+        changed = m_index.removeUnder(folder) > 0 || changed;
+        unwatchUnder(folder);
+    }
+    if (changed) {
+        notifyChanged();
+    }
+
+    startScan(added);
+}
+
+void MediaLibrary::rescan()
+{
+    ++m_generation;
+    m_index.clear();
+    if (!m_watched.isEmpty()) {
+        m_watcher.removePaths(m_watched.values());
+        m_watched.clear();
+    }
+    m_unwatched = 0;
+    m_changedDirectories.clear();
+    m_changeTimer.stop();
+    notifyChanged();
+
+    startScan(m_folders);
+}
+
+void MediaLibrary::startScan(const QStringList& roots)
+{
+    if (roots.isEmpty()) {
+        return;
+    }
+
+    if (m_activeScans++ == 0) {
+        emit scanningChanged(true);
+    }
+
+    const quint64 generation = m_generation;
+    m_ioPool.start([this, generation, roots]() {
+        QElapsedTimer timer;
+        timer.start();
+        const int files = LibraryScanner::scan(
+            roots, LibraryScanner::defaultThreadCount(),
+            [this, generation](LibraryScanBatch&& batch) {
+                QMetaObject::invokeMethod(this, [this, generation, batch = std::move(batch)]() {
+                    onScanBatch(generation, batch);
+                }, Qt::QueuedConnection);
+            },
+            [this, generation]() { return m_generation.load() != generation; });
+
+        const qint64 elapsedMs = timer.elapsed();
+        QMetaObject::invokeMethod(this, [this, generation, roots, files, elapsedMs]() {
+            onScanFinished(generation, roots, files, elapsedMs);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MediaLibrary::onScanBatch(quint64 generation, const LibraryScanBatch& batch)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    // A folder may have been removed while its walk was still reporting
+    bool changed = false;
+    for (const LibraryFile& file : batch.files) {
+        if (isInFolders(file.path)) {
+            changed = m_index.insert(file) || changed;
+        }
+    }
+
+    QStringList directories;
+    directories.reserve(batch.directories.size());
+    for (const QString& directory : batch.directories) {
+        if (isInFolders(directory)) {
+            directories.append(directory);
+        }
+    }
+    watch(directories);
+
+    if (changed) {
+        notifyChanged();
+    }
+}
+
+void MediaLibrary::onScanFinished(quint64 generation, const QStringList& roots, int files, qint64 elapsedMs)
+{
+    // Every walk started is finished, whatever generation it belonged to
+    if (--m_activeScans == 0) {
+        emit scanningChanged(false);
+    }
+    if (generation != m_generation || files < 0) {
+        return;
+    }
+
+    qDebug() << "MediaLibrary: Found" << files << "media files under" << roots << "in" << elapsedMs << "ms";
+    if (m_unwatched > 0) {
+        qWarning() << "MediaLibrary:" << m_unwatched
+                   << "directories are not watched; raise fs.inotify.max_user_watches or use Rescan";
+    }
+}
+
+void MediaLibrary::onDirectoryChanged(const QString& directory)
+{
+    // A copy into a folder fires for every file; list the folder once it quiets down
+    m_changedDirectories.insert(directory);
+    m_changeTimer.start();
+}
+
+void MediaLibrary::listChangedDirectories()
+{
+    const quint64 generation = m_generation;
+    for (const QString& directory : std::as_const(m_changedDirectories)) {
+        m_ioPool.start([this, generation, directory]() {
+            const std::optional<DirectoryListing> listing = LibraryScanner::listDirectory(directory);
+            QMetaObject::invokeMethod(this, [this, generation, directory, listing]() {
+                onDirectoryListed(generation, directory, listing);
+            }, Qt::QueuedConnection);
+        });
+    }
+    m_changedDirectories.clear();
+}
+
+void MediaLibrary::onDirectoryListed(quint64 generation, const QString& directory,
+                                     const std::optional<DirectoryListing>& listing)
+{
+    if (generation != m_generation || !isInFolders(directory)) {
+        return;
+    }
+
+    if (!listing) {
+        // Deleted or moved away, with everything below it
+        const bool changed = m_index.removeUnder(directory) > 0;
+        unwatchUnder(directory);
+        if (changed) {
+            notifyChanged();
+        }
+        return;
+    }
+
+    bool changed = false;
+    QSet<QString> present;
+    QStringList added;
+    for (const LibraryFile& file : listing->files) {
+        present.insert(file.path);
+        if (!m_index.contains(file.path)) {
+            added.append(file.path);
+        }
+        changed = m_index.insert(file) || changed;
+    }
+    for (const LibraryFile& known : m_index.filesIn(directory)) {
+        if (!present.contains(known.path)) {
+            changed = m_index.remove(known.path) || changed;
+        }
+    }
+
+    // Subdirectories that came or went; new ones are walked like a folder of their own
+    const QSet<QString> subdirectories(listing->subdirectories.cbegin(), listing->subdirectories.cend());
+    QStringList vanished;
+    const QString prefix = directory + u'/';
+    for (const QString& watched : std::as_const(m_watched)) {
+        if (watched.startsWith(prefix) && watched.indexOf(u'/', prefix.size()) < 0
+            && !subdirectories.contains(watched)) {
+            vanished.append(watched);
+        }
+    }
+    for (const QString& gone : vanished) {
+        changed = m_index.removeUnder(gone) > 0 || changed;
+        unwatchUnder(gone);
+    }
+    QStringList appeared;
+    for (const QString& subdirectory : listing->subdirectories) {
+        if (!m_watched.contains(subdirectory)) {
+            appeared.append(subdirectory);
+        }
+    }
+    startScan(appeared);
+
+    if (!added.isEmpty()) {
+        MetadataCache::instance()->prefetch(added);
+    }
+    if (changed) {
+        notifyChanged();
+    }
+}
+
+void MediaLibrary::watch(const QStringList& directories)
+{
+    QStringList fresh;
+    for (const QString& directory : directories) {
+        if (!m_watched.contains(directory)) {
+            fresh.append(directory);
+        }
+    }
+    if (fresh.isEmpty()) {
+        return;
+    }
+
+    const QStringList failed = m_watcher.addPaths(fresh);
+    m_unwatched += static_cast<int>(failed.size());
+    const QSet<QString> refused(failed.cbegin(), failed.cend());
+    for (const QString& directory : std::as_const(fresh)) {
+        if (!refused.contains(directory)) {
+            m_watched.insert(directory);
+        }
+    }
+}
+
+void MediaLibrary::unwatchUnder(const QString& directory)
+{
+    const QString prefix = directory + u'/';
+    QStringList paths;
+    for (auto it = m_watched.begin(); it != m_watched.end();) {
+        if (*it == directory || it->startsWith(prefix)) {
+            paths.append(*it);
+            it = m_watched.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (!paths.isEmpty()) {
+        m_watcher.removePaths(paths);
+    }
+}
+
+void MediaLibrary::notifyChanged()
+{
+    if (!m_notifyTimer.isActive()) {
+        m_notifyTimer.start();
+    }
+}
+
+bool MediaLibrary::isInFolders(const QString& path) const
+{
+    for (const QString& folder : m_folders) {
+        if (path == folder || (path.startsWith(folder) && (folder.endsWith(u'/') || path.at(folder.size()) == u'/'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString MediaLibrary::normalizedFolder(const QString& folder)
+{
+    if (folder.trimmed().isEmpty()) {
+        return QString();
+    }
+    QString path = QDir::cleanPath(QDir(folder).absolutePath());
+    // "/" stays as it is, anything else loses a trailing separator
+    if (path.size() > 1 && path.endsWith(u'/')) {
+        path.chop(1);
+    }
+    return path;
+}
+
+} // namespace DarkPlay::Media
@@ -1,101 +1,252 @@
 #include "media/MediaManager.h"
+#include "media/KeyframeIndex.h"
+#include "media/Playlist.h"
 #include <QDebug>
-#include <mutex>
+#include <QMetaObject>
+#include <QTimer>
+#include <utility>
+
+namespace {
+    constexpr int DEFAULT_PREROLL_LEAD_TIME_MS = 5000;
+    constexpr int MAX_PREROLL_LEAD_TIME_S = 60;
+    // Longest a seek may stay in flight without the engine reporting it complete
+    constexpr int SEEK_COMPLETION_TIMEOUT_MS = 500;
+}
 
 namespace DarkPlay::Media {
 
 MediaManager::MediaManager(QObject* parent)
     : QObject(parent)
+    , m_engineThread(std::make_unique<EngineThread>())
+    , m_engineGeneration(0)
+    , m_seekSequence(0)
+    , m_issuedSeek(0)
+    , m_settledSeek(0)
+    , m_deferredSeek(-1)
+    , m_seekTimeout(new QTimer(this))
+    , m_prerollIndex(-1)
+    , m_prerollGeneration(0)
+    , m_prerollEnabled(false)
+    , m_prerollLeadTimeMs(DEFAULT_PREROLL_LEAD_TIME_MS)
+    , m_videoSink(nullptr)
+    , m_playlist(new Playlist(this))
     , m_currentIndex(-1)
     , m_autoPlay(false)
     , m_repeatMode(false)
+    , m_shuffle(false)
     , m_previousVolume(50)
-    , m_positionTimer(new QTimer(this))
+    , m_seekMode(SeekMode::Exact)
 {
-    m_positionTimer->setInterval(100); // Update position every 100ms
-    connect(m_positionTimer, &QTimer::timeout, this, &MediaManager::onPositionTimer);
+    m_snapshot.store(std::make_shared<const PlaybackSnapshot>(), std::memory_order_release);
+    connectPlaylistSignals();
+
+    m_seekTimeout->setSingleShot(true);
+    m_seekTimeout->setInterval(SEEK_COMPLETION_TIMEOUT_MS);
+    connect(m_seekTimeout, &QTimer::timeout, this, &MediaManager::settleSeek);
 }
 
-MediaManager::~MediaManager() = default;
+MediaManager::~MediaManager()
+{
+    // Engines are deleted on their own thread, which is joined before anything else goes
+    discardPreroll();
+    retireEngine(std::move(m_engine));
+    m_engineThread.reset();
+}
 
 void MediaManager::setMediaEngine(std::unique_ptr<IMediaEngine> engine)
 {
-    std::lock_guard<std::recursive_mutex> lock(m_engineMutex);
-
-    if (m_engine) {
-        disconnectEngineSignals();
-        m_engine->stop();
-    }
+    discardPreroll();
+    retireEngine(std::move(m_engine));
 
     m_engine = std::move(engine);
+    ++m_engineGeneration;
+    m_deferredSeek = -1;
 
     if (m_engine) {
-        connectEngineSignals();
+        m_engineThread->adopt(m_engine.get());
+        connectEngineSignals(m_engine.get());
+        postToEngine([sink = m_videoSink, options = m_streamingOptions, effects = m_audioEffects](IMediaEngine& engine) {
+            if (sink) {
+                engine.setVideoSink(sink);
+            }
+            engine.setStreamingOptions(options);
+            if (!effects.isEmpty()) {
+                engine.setAudioEffects(effects);
+            }
+        });
     }
+
+    refreshSnapshot();
 }
 
 IMediaEngine* MediaManager::mediaEngine() const
 {
-    std::lock_guard<std::recursive_mutex> lock(m_engineMutex);
     return m_engine.get();
 }
 
+void MediaManager::setEngineFactory(EngineFactory factory)
+{
+    m_engineFactory = std::move(factory);
+}
+
+void MediaManager::waitForEngine()
+{
+    m_engineThread->postAndWait([]() {});
+}
+
 bool MediaManager::hasEngine() const noexcept
 {
-    std::lock_guard<std::recursive_mutex> lock(m_engineMutex);
     return m_engine != nullptr;
 }
 
-bool MediaManager::loadMedia(const QUrl& url)
+void MediaManager::setVideoSink(QVideoSink* sink)
 {
-    return safeEngineCall([&](IMediaEngine& engine) -> bool {
-        m_currentUrl = url.toString();
-        bool success = engine.loadMedia(url);
+    m_videoSink = sink;
+    postToEngine([sink](IMediaEngine& engine) {
+        engine.setVideoSink(sink);
+    });
+}
 
-        if (success) {
-            emit mediaLoaded(m_currentUrl);
+void MediaManager::setHardwareDecoding(bool enabled, std::function<void(bool applied)> done)
+{
+    IMediaEngine* engine = m_engine.get();
+    if (!engine) {
+        if (done) {
+            done(false);
         }
+        return;
+    }
+
+    m_engineThread->post([this, engine, enabled, done = std::move(done)]() {
+        bool applied = false;
+        try {
+            applied = engine->setHardwareDecoding(enabled);
+        } catch (const std::exception& e) {
+            qWarning() << "Engine operation failed:" << e.what();
+        }
+        if (done) {
+            QMetaObject::invokeMethod(this, [done, applied]() { done(applied); }, Qt::QueuedConnection);
+        }
+    });
+}
+
+// Frame statistics are thread-safe in the engines, so these skip the queue
+FrameStats MediaManager::frameStats() const
+{
+    return m_engine ? m_engine->frameStats() : FrameStats{};
+}
+
+void MediaManager::resetFrameStats()
+{
+    if (m_engine) {
+        m_engine->resetFrameStats();
+    }
+}
+
+void MediaManager::reportFramePresented(qint64 presentationTimeUs)
+{
+    if (m_engine) {
+        m_engine->reportFramePresented(presentationTimeUs);
+    }
+}
 
-        return success;
+ClockReading MediaManager::clockReading() const
+{
+    return m_engine ? m_engine->clockReading() : ClockReading{};
+}
+
+ClockStats MediaManager::clockStats() const
+{
+    return m_engine ? m_engine->clockStats() : ClockStats{};
+}
+
+void MediaManager::setAudioEffects(const QList<Plugins::IAudioEffectPlugin*>& effects)
+{
+    m_audioEffects = effects;
+
+    postToEngine([effects](IMediaEngine& engine) {
+        engine.setAudioEffects(effects);
+    });
+}
+
+void MediaManager::setStreamingOptions(const StreamingOptions& options)
+{
+    m_streamingOptions = options;
+
+    postToEngine([options](IMediaEngine& engine) {
+        engine.setStreamingOptions(options);
     });
 }
 
+StreamingOptions MediaManager::streamingOptions() const
+{
+    return m_streamingOptions;
+}
+
+StreamingStats MediaManager::streamingStats()
+{
+    // Polled by the stats overlay; the engine thread answers in time for the next poll
+    IMediaEngine* engine = m_engine.get();
+    if (engine) {
+        const quint64 generation = m_engineGeneration;
+        m_engineThread->post([this, engine, generation]() {
+            const StreamingStats stats = engine->streamingStats();
+            QMetaObject::invokeMethod(this, [this, generation, stats]() {
+                if (generation == m_engineGeneration) {
+                    m_streamingStats = stats;
+                }
+            }, Qt::QueuedConnection);
+        }, EngineThread::Coalesce::StreamingStats);
+    }
+    return m_streamingStats;
+}
+
+bool MediaManager::loadMedia(const QUrl& url)
+{
+    if (!m_engine || !url.isValid()) {
+        return false;
+    }
+
+    m_currentUrl = url.toString();
+    m_streamingStats = StreamingStats{};
+    m_deferredSeek = -1; // Meant for the previous media
+    postToEngine([url](IMediaEngine& engine) {
+        engine.loadMedia(url);
+    });
+    refreshSnapshot();
+
+    emit mediaLoaded(m_currentUrl);
+    return true;
+}
+
 void MediaManager::play()
 {
-    if (safeEngineCallVoid([](IMediaEngine& engine) {
+    postToEngine([](IMediaEngine& engine) {
         engine.play();
-    })) {
-        if (!m_positionTimer->isActive()) {
-            m_positionTimer->start();
-        }
-    }
+    });
 }
 
 void MediaManager::pause()
 {
-    if (safeEngineCallVoid([](IMediaEngine& engine) {
+    postToEngine([](IMediaEngine& engine) {
         engine.pause();
-    })) {
-        m_positionTimer->stop();
-    }
+    });
 }
 
 void MediaManager::stop()
 {
-    if (safeEngineCallVoid([](IMediaEngine& engine) {
+    postToEngine([](IMediaEngine& engine) {
         engine.stop();
-    })) {
-        m_positionTimer->stop();
-    }
+    });
 }
 
 void MediaManager::togglePlayPause()
 {
-    safeEngineCallVoid([this](IMediaEngine& engine) {
+    // Decided on the engine thread, against the state the queued commands left behind
+    postToEngine([](IMediaEngine& engine) {
         PlaybackState currentState = engine.state();
         if (currentState == PlaybackState::Playing) {
             engine.pause();
-            m_positionTimer->stop();
         } else if (currentState == PlaybackState::Paused || currentState == PlaybackState::Stopped) {
             // FIX: If media has ended (position at the end), reset to beginning
             if (currentState == PlaybackState::Stopped &&
@@ -105,43 +256,164 @@ void MediaManager::togglePlayPause()
             }
 
             engine.play();
-            if (!m_positionTimer->isActive()) {
-                m_positionTimer->start();
-            }
         }
     });
 }
 
 qint64 MediaManager::position() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> qint64 {
-        return engine.position();
-    });
+    return snapshot()->position;
 }
 
 qint64 MediaManager::duration() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> qint64 {
-        return engine.duration();
-    });
+    return snapshot()->duration;
 }
 
 void MediaManager::setPosition(qint64 position)
 {
-    safeEngineCallVoid([position](IMediaEngine& engine) {
-        engine.setPosition(position);
-    });
+    requestSeek(position);
+}
+
+void MediaManager::seekTo(qint64 position)
+{
+    // Relative to the published position, which already includes seeks still in flight
+    const PlaybackSnapshotPtr current = snapshot();
+    requestSeek(resolveSeekTarget(current->position, clampToDuration(position), seekMode()));
 }
 
 void MediaManager::seek(qint64 offset)
 {
-    safeEngineCallVoid([this, offset](IMediaEngine& engine) {
-        qint64 newPosition = engine.position() + offset;
-        newPosition = qMax(0LL, qMin(newPosition, engine.duration()));
-        engine.setPosition(newPosition);
+    const PlaybackSnapshotPtr current = snapshot();
+    const qint64 newPosition = clampToDuration(current->position + offset);
+    requestSeek(resolveSeekTarget(current->position, newPosition, seekMode()));
+}
+
+void MediaManager::scrubTo(qint64 position)
+{
+    // Keyframe seeks whatever the seek mode: each one only has to show roughly where the handle is
+    const PlaybackSnapshotPtr current = snapshot();
+    requestSeek(resolveSeekTarget(current->position, clampToDuration(position), SeekMode::Fast));
+}
+
+void MediaManager::endScrub(qint64 position)
+{
+    // Replaces whatever scrub seek was still waiting
+    requestSeek(clampToDuration(position));
+}
+
+qint64 MediaManager::clampToDuration(qint64 position) const
+{
+    return qMax(0LL, qMin(position, snapshot()->duration));
+}
+
+void MediaManager::requestSeek(qint64 position)
+{
+    if (!m_engine) {
+        return;
+    }
+    if (seekPending()) {
+        // Latest wins; it goes out once the seek in flight completes
+        m_deferredSeek = position;
+        publishSeekTarget(position);
+        return;
+    }
+    postSeek(position);
+}
+
+void MediaManager::postSeek(qint64 position)
+{
+    IMediaEngine* engine = m_engine.get();
+    if (!engine) {
+        return;
+    }
+
+    const quint64 sequence = ++m_seekSequence;
+    m_engineThread->post([this, engine, position, sequence]() {
+        // Acknowledged first, so it is delivered ahead of the engine's seekCompleted()
+        QMetaObject::invokeMethod(this, [this, sequence]() { onSeekIssued(sequence); }, Qt::QueuedConnection);
+        try {
+            engine->setPosition(position);
+        } catch (const std::exception& e) {
+            qWarning() << "Engine operation failed:" << e.what();
+        }
+    }, EngineThread::Coalesce::Seek);
+
+    publishSeekTarget(position);
+}
+
+void MediaManager::publishSeekTarget(qint64 position)
+{
+    // Scrubbing and repeated key seeks see the target at once
+    publishSnapshot([position](PlaybackSnapshot& snapshot) {
+        snapshot.position = position;
+    });
+}
+
+void MediaManager::onSeekIssued(quint64 sequence)
+{
+    m_issuedSeek = qMax(m_issuedSeek, sequence);
+    m_seekTimeout->start();
+}
+
+void MediaManager::settleSeek()
+{
+    m_seekTimeout->stop();
+    m_settledSeek = qMax(m_settledSeek, m_issuedSeek);
+    if (m_deferredSeek >= 0 && !seekPending()) {
+        postSeek(std::exchange(m_deferredSeek, -1));
+    }
+}
+
+void MediaManager::setSeekMode(SeekMode mode)
+{
+    m_seekMode = mode;
+}
+
+SeekMode MediaManager::seekMode() const
+{
+    return m_seekMode;
+}
+
+bool MediaManager::stepFrame(int frames)
+{
+    if (frames == 0 || !snapshot()->hasVideo) {
+        return false;
+    }
+    return postToEngine([frames](IMediaEngine& engine) {
+        engine.stepFrame(frames);
     });
 }
 
+qint64 MediaManager::resolveSeekTarget(qint64 current, qint64 target, SeekMode mode) const
+{
+    if (mode != SeekMode::Fast) {
+        return target;
+    }
+    // Playlist entries may be plain paths rather than URLs
+    QUrl url(m_currentUrl);
+    if (url.scheme().isEmpty()) {
+        url = QUrl::fromLocalFile(m_currentUrl);
+    }
+    if (!url.isLocalFile()) {
+        return target;
+    }
+    const std::optional<KeyframeTable> table = KeyframeIndex::instance()->lookup(url.toLocalFile());
+    if (!table || table->intraOnly) {
+        return target; // Exact seeks are already cheap, or there is nothing to snap to
+    }
+
+    // A short hop must still move: past the nearest keyframe when that is behind us
+    const qint64 snapped = table->nearest(target);
+    if (target > current && snapped <= current) {
+        return table->after(current).value_or(target);
+    }
+    if (target < current && snapped >= current) {
+        return table->before(current).value_or(0);
+    }
+    return snapped;
+}
+
 void MediaManager::seekForward(qint64 seconds)
 {
     seek(seconds * 1000); // Convert seconds to milliseconds
@@ -154,19 +426,24 @@ void MediaManager::seekBackward(qint64 seconds)
 
 int MediaManager::volume() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> int {
-        return engine.volume();
-    });
+    return snapshot()->volume;
 }
 
 void MediaManager::setVolume(int volume)
 {
-    safeEngineCallVoid([this, volume](IMediaEngine& engine) {
-        int clampedVolume = qBound(0, volume, 100);
-        engine.setVolume(clampedVolume);
-        if (clampedVolume > 0) {
-            m_previousVolume = clampedVolume;
-        }
+    const int clampedVolume = qBound(0, volume, 100);
+    if (!postToEngine([clampedVolume](IMediaEngine& engine) {
+            engine.setVolume(clampedVolume);
+        }, EngineThread::Coalesce::Volume)) {
+        return;
+    }
+
+    // Published ahead of the engine so stepping the volume builds on the last request
+    if (clampedVolume > 0) {
+        m_previousVolume = clampedVolume;
+    }
+    publishSnapshot([clampedVolume](PlaybackSnapshot& snapshot) {
+        snapshot.volume = clampedVolume;
     });
 }
 
@@ -182,47 +459,54 @@ void MediaManager::decreaseVolume(int step)
 
 bool MediaManager::isMuted() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> bool {
-        return engine.isMuted();
-    });
+    return snapshot()->muted;
 }
 
 void MediaManager::setMuted(bool muted)
 {
-    safeEngineCallVoid([muted](IMediaEngine& engine) {
-        engine.setMuted(muted);
+    if (!postToEngine([muted](IMediaEngine& engine) {
+            engine.setMuted(muted);
+        }, EngineThread::Coalesce::Muted)) {
+        return;
+    }
+
+    publishSnapshot([muted](PlaybackSnapshot& snapshot) {
+        snapshot.muted = muted;
     });
 }
 
 void MediaManager::toggleMute()
 {
-    safeEngineCallVoid([this](IMediaEngine& engine) {
-        if (engine.isMuted()) {
-            engine.setMuted(false);
-            if (engine.volume() == 0 && m_previousVolume > 0) {
-                engine.setVolume(m_previousVolume);
-            }
-        } else {
-            if (engine.volume() > 0) {
-                m_previousVolume = engine.volume();
-            }
-            engine.setMuted(true);
+    const PlaybackSnapshotPtr current = snapshot();
+    if (current->muted) {
+        setMuted(false);
+        if (current->volume == 0 && m_previousVolume > 0) {
+            setVolume(m_previousVolume);
         }
-    });
+    } else {
+        if (current->volume > 0) {
+            m_previousVolume = current->volume;
+        }
+        setMuted(true);
+    }
 }
 
 qreal MediaManager::playbackRate() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> qreal {
-        return engine.playbackRate();
-    });
+    return snapshot()->playbackRate;
 }
 
 void MediaManager::setPlaybackRate(qreal rate)
 {
-    safeEngineCallVoid([rate](IMediaEngine& engine) {
-        qreal clampedRate = qBound(0.25, rate, 4.0); // Limit playback rate
-        engine.setPlaybackRate(clampedRate);
+    const qreal clampedRate = qBound(0.25, rate, 4.0); // Limit playback rate
+    if (!postToEngine([clampedRate](IMediaEngine& engine) {
+            engine.setPlaybackRate(clampedRate);
+        }, EngineThread::Coalesce::PlaybackRate)) {
+        return;
+    }
+
+    publishSnapshot([clampedRate](PlaybackSnapshot& snapshot) {
+        snapshot.playbackRate = clampedRate;
     });
 }
 
@@ -247,23 +531,22 @@ void MediaManager::resetSpeed()
 
 PlaybackState MediaManager::state() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> PlaybackState {
-        return engine.state();
-    });
+    return snapshot()->state;
 }
 
 MediaType MediaManager::mediaType() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> MediaType {
-        return engine.mediaType();
-    });
+    return snapshot()->mediaType;
 }
 
 QString MediaManager::errorString() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> QString {
-        return engine.errorString();
-    });
+    return snapshot()->errorString;
+}
+
+PlaybackSnapshotPtr MediaManager::snapshot() const noexcept
+{
+    return m_snapshot.load(std::memory_order_acquire);
 }
 
 QString MediaManager::currentMediaUrl() const
@@ -273,96 +556,84 @@ QString MediaManager::currentMediaUrl() const
 
 QString MediaManager::title() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> QString {
-        return engine.title();
-    });
+    return snapshot()->title;
 }
 
 QSize MediaManager::videoSize() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> QSize {
-        return engine.videoSize();
-    });
+    return snapshot()->videoSize;
 }
 
 bool MediaManager::hasVideo() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> bool {
-        return engine.hasVideo();
-    });
+    return snapshot()->hasVideo;
 }
 
 bool MediaManager::hasAudio() const
 {
-    return safeEngineCall([](const IMediaEngine& engine) -> bool {
-        return engine.hasAudio();
-    });
+    return snapshot()->hasAudio;
 }
 
 void MediaManager::setPlaylist(const QStringList& urls)
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
-    m_playlist = urls;
-    m_currentIndex = urls.isEmpty() ? -1 : 0;
-    emit playlistChanged();
-    emit currentIndexChanged(m_currentIndex);
+    m_playlist->cancelImport();
+    m_playlist->reset(urls);
 
     if (!urls.isEmpty() && m_autoPlay) {
         loadCurrentMedia();
     }
 }
 
-QStringList MediaManager::playlist() const
-{
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
-    return m_playlist;
-}
-
 int MediaManager::currentIndex() const
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
     return m_currentIndex;
 }
 
 void MediaManager::setCurrentIndex(int index)
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
     if (isValidIndex(index) && index != m_currentIndex) {
+        const bool prerolled = m_prerollEngine && m_prerollIndex == index;
         m_currentIndex = index;
         emit currentIndexChanged(m_currentIndex);
-        loadCurrentMedia();
+
+        // Use the warm engine if it already holds this item, otherwise open it from scratch
+        if (!prerolled || !swapToPrerolledEngine()) {
+            discardPreroll();
+            loadCurrentMedia();
+        }
     }
 }
 
 void MediaManager::next()
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
-    if (hasNext()) {
-        setCurrentIndex(m_currentIndex + 1);
-    } else if (m_repeatMode && !m_playlist.isEmpty()) {
-        setCurrentIndex(0);
+    const int index = nextIndex();
+    if (index >= 0) {
+        setCurrentIndex(index);
     }
 }
 
 void MediaManager::previous()
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
-    if (hasPrevious()) {
-        setCurrentIndex(m_currentIndex - 1);
-    } else if (m_repeatMode && !m_playlist.isEmpty()) {
-        setCurrentIndex(static_cast<int>(m_playlist.size() - 1));
+    const int index = previousIndex();
+    if (index >= 0) {
+        setCurrentIndex(index);
     }
 }
 
 bool MediaManager::hasNext() const
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
-    return m_currentIndex < m_playlist.size() - 1;
+    if (m_shuffle) {
+        const ShuffleOrder& order = m_playlist->shuffleOrder();
+        return order.positionOf(m_currentIndex) < order.size() - 1;
+    }
+    return m_currentIndex < m_playlist->count() - 1;
 }
 
 bool MediaManager::hasPrevious() const
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
+    if (m_shuffle) {
+        return m_playlist->shuffleOrder().positionOf(m_currentIndex) > 0;
+    }
     return m_currentIndex > 0;
 }
 
@@ -386,27 +657,62 @@ bool MediaManager::repeatMode() const
     return m_repeatMode;
 }
 
-void MediaManager::onPositionTimer()
+void MediaManager::setShuffle(bool enabled)
 {
-    safeEngineCallVoid([this](const IMediaEngine& engine) {
-        if (engine.state() == PlaybackState::Playing) {
-            emit positionChanged(engine.position());
-        }
-    });
+    if (enabled == m_shuffle) {
+        return;
+    }
+
+    m_shuffle = enabled;
+    if (enabled) {
+        m_playlist->reshuffle();
+    }
+    // The warm engine may hold what used to be the next item
+    discardPreroll();
+}
+
+bool MediaManager::shuffle() const
+{
+    return m_shuffle;
+}
+
+void MediaManager::setPrerollEnabled(bool enabled)
+{
+    m_prerollEnabled = enabled;
+    if (!enabled) {
+        discardPreroll();
+    }
+}
+
+bool MediaManager::prerollEnabled() const
+{
+    return m_prerollEnabled;
+}
+
+void MediaManager::setPrerollLeadTime(int seconds)
+{
+    m_prerollLeadTimeMs = qBound(1, seconds, MAX_PREROLL_LEAD_TIME_S) * 1000;
+}
+
+int MediaManager::prerollLeadTime() const
+{
+    return m_prerollLeadTimeMs / 1000;
 }
 
 void MediaManager::onEngineStateChanged(PlaybackState state)
 {
+    publishSnapshot([state](PlaybackSnapshot& snapshot) {
+        snapshot.state = state;
+    });
+    // State transitions are rare - take the opportunity to refresh everything
+    refreshSnapshot();
     emit stateChanged(state);
 
     // Handle automatic playlist advancement
     if (state == PlaybackState::Stopped && m_autoPlay) {
-        std::lock_guard<std::mutex> lock(m_playlistMutex);
-        if (hasNext()) {
-            next();
-            play();
-        } else if (m_repeatMode && !m_playlist.isEmpty()) {
-            setCurrentIndex(0);
+        const int index = nextIndex();
+        if (index >= 0) {
+            setCurrentIndex(index);
             play();
         }
     }
@@ -414,37 +720,72 @@ void MediaManager::onEngineStateChanged(PlaybackState state)
 
 void MediaManager::onEnginePositionChanged(qint64 position)
 {
+    // Reported before the latest seek completed; the published target stays
+    if (seekPending()) {
+        return;
+    }
+
+    // The engine is the only position source; the UI samples the snapshot
+    publishSnapshot([position](PlaybackSnapshot& snapshot) {
+        snapshot.position = position;
+    });
     emit positionChanged(position);
+
+    if (m_prerollEnabled && m_autoPlay) {
+        preparePreroll(position);
+    }
 }
 
 void MediaManager::onEngineDurationChanged(qint64 duration)
 {
+    publishSnapshot([duration](PlaybackSnapshot& snapshot) {
+        snapshot.duration = duration;
+    });
     emit durationChanged(duration);
 }
 
 void MediaManager::onEngineVolumeChanged(int volume)
 {
+    publishSnapshot([volume](PlaybackSnapshot& snapshot) {
+        snapshot.volume = volume;
+    });
     emit volumeChanged(volume);
 }
 
 void MediaManager::onEngineMutedChanged(bool muted)
 {
+    publishSnapshot([muted](PlaybackSnapshot& snapshot) {
+        snapshot.muted = muted;
+    });
     emit mutedChanged(muted);
 }
 
 void MediaManager::onEnginePlaybackRateChanged(qreal rate)
 {
+    publishSnapshot([rate](PlaybackSnapshot& snapshot) {
+        snapshot.playbackRate = rate;
+    });
     emit playbackRateChanged(rate);
 }
 
 void MediaManager::onEngineMediaInfoChanged()
 {
-    emit mediaInfoChanged();
+    // mediaInfoChanged follows once the snapshot holds the new information
+    refreshSnapshot(Refresh::MediaInfo);
+}
+
+void MediaManager::onEngineMediaLoaded()
+{
+    // Title, video size and track information become available once the backend has loaded
+    refreshSnapshot(Refresh::MediaInfo);
 }
 
 void MediaManager::onEngineErrorOccurred(const QString& error)
 {
     qWarning() << "Media engine error:" << error;
+    publishSnapshot([&error](PlaybackSnapshot& snapshot) {
+        snapshot.errorString = error;
+    });
     emit errorOccurred(error);
 
     // Try to continue with next media if auto-play is enabled
@@ -453,96 +794,367 @@ void MediaManager::onEngineErrorOccurred(const QString& error)
     }
 }
 
-void MediaManager::connectEngineSignals()
+void MediaManager::connectEngineSignals(IMediaEngine* engine)
 {
-    if (!m_engine) return;
+    // Queued from the engine thread; whatever a replaced engine still had in flight is dropped
+    const quint64 generation = m_engineGeneration;
+    auto current = [this, generation]() { return generation == m_engineGeneration; };
 
-    connect(m_engine.get(), &IMediaEngine::stateChanged,
-            this, &MediaManager::onEngineStateChanged);
-    connect(m_engine.get(), &IMediaEngine::positionChanged,
-            this, &MediaManager::onEnginePositionChanged);
-    connect(m_engine.get(), &IMediaEngine::durationChanged,
-            this, &MediaManager::onEngineDurationChanged);
-    connect(m_engine.get(), &IMediaEngine::volumeChanged,
-            this, &MediaManager::onEngineVolumeChanged);
-    connect(m_engine.get(), &IMediaEngine::mutedChanged,
-            this, &MediaManager::onEngineMutedChanged);
-    connect(m_engine.get(), &IMediaEngine::playbackRateChanged,
-            this, &MediaManager::onEnginePlaybackRateChanged);
-    connect(m_engine.get(), &IMediaEngine::mediaInfoChanged,
-            this, &MediaManager::onEngineMediaInfoChanged);
-    connect(m_engine.get(), &IMediaEngine::errorOccurred,
-            this, &MediaManager::onEngineErrorOccurred);
+    connect(engine, &IMediaEngine::stateChanged, this, [this, current](PlaybackState state) {
+        if (current()) onEngineStateChanged(state);
+    });
+    connect(engine, &IMediaEngine::positionChanged, this, [this, current](qint64 position) {
+        if (current()) onEnginePositionChanged(position);
+    });
+    connect(engine, &IMediaEngine::durationChanged, this, [this, current](qint64 duration) {
+        if (current()) onEngineDurationChanged(duration);
+    });
+    connect(engine, &IMediaEngine::volumeChanged, this, [this, current](int volume) {
+        if (current()) onEngineVolumeChanged(volume);
+    });
+    connect(engine, &IMediaEngine::mutedChanged, this, [this, current](bool muted) {
+        if (current()) onEngineMutedChanged(muted);
+    });
+    connect(engine, &IMediaEngine::playbackRateChanged, this, [this, current](qreal rate) {
+        if (current()) onEnginePlaybackRateChanged(rate);
+    });
+    connect(engine, &IMediaEngine::mediaInfoChanged, this, [this, current]() {
+        if (current()) onEngineMediaInfoChanged();
+    });
+    connect(engine, &IMediaEngine::errorOccurred, this, [this, current](const QString& error) {
+        if (current()) onEngineErrorOccurred(error);
+    });
+    connect(engine, &IMediaEngine::mediaLoaded, this, [this, current]() {
+        if (current()) onEngineMediaLoaded();
+    });
+    connect(engine, &IMediaEngine::seekCompleted, this, [this, current]() {
+        if (current()) settleSeek();
+    });
+    connect(engine, &IMediaEngine::bufferingProgress, this, [this, current](int progress) {
+        if (current()) emit bufferingProgress(progress);
+    });
+    connect(engine, &IMediaEngine::hardwareDecodingFailed, this, [this, current](const QString& reason) {
+        if (current()) emit hardwareDecodingFailed(reason);
+    });
 }
 
-void MediaManager::disconnectEngineSignals()
+void MediaManager::retireEngine(std::unique_ptr<IMediaEngine> engine)
 {
-    if (!m_engine) return;
-    m_engine->disconnect(this);
+    if (!engine) {
+        return;
+    }
+
+    engine->disconnect(this);
+    // Runs after the engine's own queued commands; effects never run on two engines at once
+    IMediaEngine* retired = engine.release();
+    m_engineThread->post([retired]() {
+        retired->setVideoSink(nullptr);
+        retired->setAudioEffects({});
+        retired->stop();
+        delete retired;
+    });
 }
 
 void MediaManager::loadCurrentMedia()
 {
-    std::lock_guard<std::mutex> lock(m_playlistMutex);
     if (isValidIndex(m_currentIndex)) {
-        const QString& url = m_playlist.at(m_currentIndex);
-        loadMedia(QUrl(url));
+        loadMedia(QUrl(m_playlist->urlAt(m_currentIndex)));
     }
 }
 
 bool MediaManager::isValidIndex(int index) const
 {
-    return index >= 0 && index < m_playlist.size();
+    return index >= 0 && index < m_playlist->count();
 }
 
-// Template implementations
-template<typename Func>
-auto MediaManager::safeEngineCall(Func&& func) const -> decltype(func(std::declval<IMediaEngine&>()))
+int MediaManager::nextIndex() const
 {
-    std::lock_guard<std::recursive_mutex> lock(m_engineMutex);
-
-    using ReturnType = decltype(func(std::declval<IMediaEngine&>()));
+    const int count = m_playlist->count();
 
-    if (!m_engine) {
-        if constexpr (std::is_same_v<ReturnType, bool>) {
-            return false;
-        } else if constexpr (std::is_arithmetic_v<ReturnType>) {
-            return ReturnType{0};
-        } else {
-            return ReturnType{};
+    if (m_shuffle) {
+        const ShuffleOrder& order = m_playlist->shuffleOrder();
+        const int position = order.positionOf(m_currentIndex);
+        if (position < count - 1) {
+            return order.rowAt(position + 1); // -1 maps to the first position
         }
+        return (m_repeatMode && count > 1) ? order.rowAt(0) : -1;
     }
 
-    try {
-        return func(*m_engine);
-    } catch (const std::exception& e) {
-        qWarning() << "Engine operation failed:" << e.what();
-        if constexpr (std::is_same_v<ReturnType, bool>) {
-            return false;
-        } else if constexpr (std::is_arithmetic_v<ReturnType>) {
-            return ReturnType{0};
-        } else {
-            return ReturnType{};
+    if (m_currentIndex < count - 1) {
+        return m_currentIndex + 1;
+    }
+    if (m_repeatMode && count > 1) {
+        return 0;
+    }
+    return -1;
+}
+
+int MediaManager::previousIndex() const
+{
+    const int count = m_playlist->count();
+
+    if (m_shuffle) {
+        const ShuffleOrder& order = m_playlist->shuffleOrder();
+        const int position = order.positionOf(m_currentIndex);
+        if (position > 0) {
+            return order.rowAt(position - 1);
         }
+        return (m_repeatMode && count > 1) ? order.rowAt(count - 1) : -1;
     }
+
+    if (m_currentIndex > 0) {
+        return m_currentIndex - 1;
+    }
+    if (m_repeatMode && count > 1) {
+        return count - 1;
+    }
+    return -1;
 }
 
-template<typename Func>
-bool MediaManager::safeEngineCallVoid(Func&& func) const
+void MediaManager::connectPlaylistSignals()
 {
-    std::lock_guard<std::recursive_mutex> lock(m_engineMutex);
+    connect(m_playlist, &Playlist::rowsInserted, this, &MediaManager::onPlaylistRowsInserted);
+    connect(m_playlist, &Playlist::rowsRemoved, this, &MediaManager::onPlaylistRowsRemoved);
+    connect(m_playlist, &Playlist::rowsMoved, this, &MediaManager::onPlaylistRowsMoved);
+    connect(m_playlist, &Playlist::modelReset, this, [this]() {
+        discardPreroll();
+        m_currentIndex = m_playlist->isEmpty() ? -1 : 0;
+        emit playlistChanged();
+        emit currentIndexChanged(m_currentIndex);
+    });
+}
 
-    if (!m_engine) {
-        return false;
+void MediaManager::onPlaylistRowsInserted(int first, int last)
+{
+    // Row counts changed, so the shuffle order and the pre-rolled item may have too
+    discardPreroll();
+    if (m_currentIndex >= first) {
+        m_currentIndex += last - first + 1;
+        emit currentIndexChanged(m_currentIndex);
+    }
+}
+
+void MediaManager::onPlaylistRowsRemoved(int first, int last)
+{
+    discardPreroll();
+    if (m_currentIndex > last) {
+        m_currentIndex -= last - first + 1;
+    } else if (m_currentIndex >= first) {
+        // The playing item keeps playing; next() continues with the row that followed it
+        m_currentIndex = first - 1;
+    } else {
+        return;
+    }
+    emit currentIndexChanged(m_currentIndex);
+}
+
+void MediaManager::onPlaylistRowsMoved(int first, int last, int destinationRow)
+{
+    discardPreroll();
+
+    const int count = last - first + 1;
+    int index = m_currentIndex;
+    if (index >= first && index <= last) {
+        index += (destinationRow > first) ? destinationRow - first - count : destinationRow - first;
+    } else if (destinationRow > last && index > last && index < destinationRow) {
+        index -= count;
+    } else if (destinationRow < first && index >= destinationRow && index < first) {
+        index += count;
     }
 
+    if (index != m_currentIndex) {
+        m_currentIndex = index;
+        emit currentIndexChanged(m_currentIndex);
+    }
+}
+
+void MediaManager::preparePreroll(qint64 position)
+{
+    if (!m_engine || !m_engineFactory) {
+        return;
+    }
+
+    const int index = nextIndex();
+    if (index < 0 || (m_prerollEngine && m_prerollIndex == index)) {
+        return;
+    }
+
+    const PlaybackSnapshotPtr current = snapshot();
+    const qint64 total = current->duration;
+    if (total <= 0 || total - position > m_prerollLeadTimeMs) {
+        return;
+    }
+
+    discardPreroll();
+
     try {
-        func(*m_engine);
-        return true;
+        auto engine = m_engineFactory();
+        if (!engine) {
+            return;
+        }
+        m_engineThread->adopt(engine.get());
+
+        // A failing pre-roll must never disturb the item that is still playing
+        const quint64 generation = ++m_prerollGeneration;
+        connect(engine.get(), &IMediaEngine::errorOccurred, this, [this, generation](const QString& error) {
+            if (generation != m_prerollGeneration || !m_prerollEngine) {
+                return;
+            }
+            qWarning() << "Pre-roll failed, next item will be opened on demand:" << error;
+            discardPreroll();
+        });
+
+        // Match the audible state of the current item so the swap is seamless
+        IMediaEngine* raw = engine.get();
+        m_engineThread->post([raw, state = *current, options = m_streamingOptions,
+                              url = QUrl(m_playlist->urlAt(index))]() {
+            try {
+                raw->setVolume(state.volume);
+                raw->setMuted(state.muted);
+                raw->setPlaybackRate(state.playbackRate);
+                raw->setStreamingOptions(options);
+                raw->loadMedia(url);
+            } catch (const std::exception& e) {
+                qWarning() << "Failed to pre-roll next item:" << e.what();
+            }
+        });
+
+        m_prerollEngine = std::move(engine);
+        m_prerollIndex = index;
+        qDebug() << "Pre-rolling playlist item" << index;
     } catch (const std::exception& e) {
-        qWarning() << "Engine operation failed:" << e.what();
+        qWarning() << "Failed to pre-roll next item:" << e.what();
+        discardPreroll();
+    }
+}
+
+bool MediaManager::swapToPrerolledEngine()
+{
+    if (!m_prerollEngine) {
+        return false;
+    }
+
+    retireEngine(std::move(m_engine));
+
+    m_prerollEngine->disconnect(this);
+    m_engine = std::move(m_prerollEngine);
+    m_prerollIndex = -1;
+    ++m_engineGeneration;
+    m_deferredSeek = -1;
+
+    connectEngineSignals(m_engine.get());
+    postToEngine([sink = m_videoSink, effects = m_audioEffects](IMediaEngine& engine) {
+        engine.setVideoSink(sink);
+        if (!effects.isEmpty()) {
+            engine.setAudioEffects(effects);
+        }
+    });
+
+    m_currentUrl = m_playlist->urlAt(m_currentIndex);
+    m_streamingStats = StreamingStats{};
+    emit mediaLoaded(m_currentUrl);
+    // The warm engine already knows its duration and position; republish both
+    refreshSnapshot(Refresh::Swap);
+
+    return true;
+}
+
+void MediaManager::discardPreroll()
+{
+    retireEngine(std::move(m_prerollEngine));
+    m_prerollIndex = -1;
+}
+
+// Template implementations
+template<typename Func>
+bool MediaManager::postToEngine(Func&& func, EngineThread::Coalesce key)
+{
+    IMediaEngine* engine = m_engine.get();
+    if (!engine) {
         return false;
     }
+
+    // The engine outlives the command: deletion is queued behind it
+    m_engineThread->post([engine, func = std::forward<Func>(func)]() mutable {
+        try {
+            func(*engine);
+        } catch (const std::exception& e) {
+            qWarning() << "Engine operation failed:" << e.what();
+        }
+    }, key);
+    return true;
+}
+
+template<typename Mutator>
+void MediaManager::publishSnapshot(Mutator&& mutate)
+{
+    // Copy-on-write: readers keep whatever snapshot they already loaded
+    auto next = std::make_shared<PlaybackSnapshot>(*m_snapshot.load(std::memory_order_acquire));
+    mutate(*next);
+    ++next->sequence;
+    m_snapshot.store(std::move(next), std::memory_order_release);
+}
+
+void MediaManager::refreshSnapshot(Refresh refresh)
+{
+    IMediaEngine* engine = m_engine.get();
+    if (!engine) {
+        publishSnapshot([](PlaybackSnapshot& snapshot) {
+            const quint64 sequence = snapshot.sequence;
+            snapshot = PlaybackSnapshot{};
+            snapshot.sequence = sequence;
+        });
+        return;
+    }
+
+    // Read on the engine thread, published back here; quiet refreshes collapse into one
+    const quint64 generation = m_engineGeneration;
+    m_engineThread->post([this, engine, generation, refresh]() {
+        PlaybackSnapshot state;
+        try {
+            state.state = engine->state();
+            state.mediaType = engine->mediaType();
+            state.position = engine->position();
+            state.duration = engine->duration();
+            state.volume = engine->volume();
+            state.muted = engine->isMuted();
+            state.playbackRate = engine->playbackRate();
+            state.title = engine->title();
+            state.errorString = engine->errorString();
+            state.videoSize = engine->videoSize();
+            state.hasVideo = engine->hasVideo();
+            state.hasAudio = engine->hasAudio();
+        } catch (const std::exception& e) {
+            qWarning() << "Failed to refresh playback snapshot:" << e.what();
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this, generation, refresh, state]() {
+            if (generation == m_engineGeneration) {
+                applyEngineState(state, refresh);
+            }
+        }, Qt::QueuedConnection);
+    }, refresh == Refresh::Quiet ? EngineThread::Coalesce::Snapshot : EngineThread::Coalesce::None);
+}
+
+void MediaManager::applyEngineState(const PlaybackSnapshot& state, Refresh refresh)
+{
+    const bool keepPosition = seekPending();
+    publishSnapshot([&state, keepPosition](PlaybackSnapshot& snapshot) {
+        const quint64 sequence = snapshot.sequence;
+        const qint64 position = snapshot.position;
+        snapshot = state;
+        snapshot.sequence = sequence;
+        if (keepPosition) {
+            snapshot.position = position;
+        }
+    });
+
+    if (refresh == Refresh::MediaInfo) {
+        emit mediaInfoChanged();
+    } else if (refresh == Refresh::Swap) {
+        emit durationChanged(state.duration);
+        onEnginePositionChanged(state.position);
+    }
 }
 
 } // namespace DarkPlay::Media
@@ -0,0 +1,569 @@
+#include "media/MetadataCache.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMediaFormat>
+#include <QMediaMetaData>
+#include <QMediaPlayer>
+#include <QMimeDatabase>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x44504d43; // "DPMC"
+constexpr int PROBE_TIMEOUT_MS = 5000;
+
+QDataStream& operator<<(QDataStream& stream, const MediaInfo& info)
+{
+    return stream << info.durationMs << info.resolution << info.videoCodec << info.audioCodec << info.title
+                  << qint32(info.audioTrackCount) << qint32(static_cast<int>(info.mediaType));
+}
+
+QDataStream& operator>>(QDataStream& stream, MediaInfo& info)
+{
+    qint32 audioTracks = 0;
+    qint32 mediaType = 0;
+    stream >> info.durationMs >> info.resolution >> info.videoCodec >> info.audioCodec >> info.title
+           >> audioTracks >> mediaType;
+    info.audioTrackCount = audioTracks;
+    info.mediaType = (mediaType >= 0 && mediaType <= static_cast<int>(MediaType::Unknown))
+        ? static_cast<MediaType>(mediaType) : MediaType::Unknown;
+    return stream;
+}
+
+} // namespace
+
+/**
+ * @brief Background prober: one private QMediaPlayer working through a queue
+ */
+class MetadataProber : public QObject
+{
+public:
+    explicit MetadataProber(MetadataCache* cache)
+        : m_cache(cache)
+        , m_player(nullptr)
+        , m_timeout(nullptr)
+    {
+    }
+
+    // Called on the prober thread
+    void enqueue(const QString& filePath)
+    {
+        ensurePlayer();
+        m_queue.append(filePath);
+        if (m_current.isEmpty()) {
+            probeNext();
+        }
+    }
+
+private:
+    void ensurePlayer()
+    {
+        if (m_player) {
+            return;
+        }
+
+        // Neither audio nor video output: the player only opens and parses
+        m_player = new QMediaPlayer(this);
+        m_timeout = new QTimer(this);
+        m_timeout->setSingleShot(true);
+
+        connect(m_timeout, &QTimer::timeout, this, [this]() { completeCurrent(false); });
+        connect(m_player, &QMediaPlayer::errorOccurred, this, [this]() { completeCurrent(false); });
+        connect(m_player, &QMediaPlayer::mediaStatusChanged, this, [this](QMediaPlayer::MediaStatus status) {
+            if (status == QMediaPlayer::LoadedMedia) {
+                completeCurrent(true);
+            } else if (status == QMediaPlayer::InvalidMedia) {
+                completeCurrent(false);
+            }
+        });
+    }
+
+    void probeNext()
+    {
+        while (!m_queue.isEmpty()) {
+            m_current = m_queue.takeFirst();
+            const QFileInfo fileInfo(m_current);
+            if (!fileInfo.isFile()) {
+                continue;
+            }
+
+            m_size = fileInfo.size();
+            m_modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+            m_timeout->start(PROBE_TIMEOUT_MS);
+            m_player->setSource(QUrl::fromLocalFile(m_current));
+            return;
+        }
+        m_current.clear();
+    }
+
+    void completeCurrent(bool loaded)
+    {
+        if (m_current.isEmpty()) {
+            return;
+        }
+        m_timeout->stop();
+
+        if (loaded) {
+            const MediaInfo info = MetadataCache::infoFromPlayer(*m_player);
+            MetadataCache* cache = m_cache;
+            const QString filePath = m_current;
+            const qint64 size = m_size;
+            const qint64 modifiedMs = m_modifiedMs;
+            QMetaObject::invokeMethod(cache, [cache, filePath, size, modifiedMs, info]() {
+                cache->onProbed(filePath, size, modifiedMs, info);
+            }, Qt::QueuedConnection);
+        }
+
+        // Release the file before moving on
+        m_current.clear();
+        m_player->setSource(QUrl());
+        probeNext();
+    }
+
+    MetadataCache* m_cache; // Outlives the prober thread
+    QMediaPlayer* m_player;
+    QTimer* m_timeout;
+    QStringList m_queue;
+    QString m_current;
+    qint64 m_size{0};
+    qint64 m_modifiedMs{0};
+};
+
+MetadataCache* MetadataCache::instance()
+{
+    // Parented to the application so it dies before the multimedia backend
+    static QPointer<MetadataCache> s_instance;
+    if (!s_instance) {
+        s_instance = new MetadataCache(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+MetadataCache::MetadataCache(QObject* parent)
+    : QObject(parent)
+    , m_entryBytes(0)
+    , m_loadRequested(false)
+    , m_loaded(false)
+    , m_dirty(false)
+    , m_prober(nullptr)
+{
+    qRegisterMetaType<MediaInfo>();
+
+    m_ioPool.setMaxThreadCount(1);
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(SAVE_DELAY_MS);
+    connect(&m_saveTimer, &QTimer::timeout, this, &MetadataCache::save);
+
+    m_probeThread.setObjectName("Metadata prober");
+
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->registerConsumer("Metadata", this);
+    }
+}
+
+MetadataCache::~MetadataCache()
+{
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->unregisterConsumer(this);
+    }
+
+    m_probeThread.quit();
+    m_probeThread.wait();
+    m_ioPool.waitForDone();
+
+    // Last chance to persist; the event loop is already gone
+    if (m_dirty && m_loaded) {
+        writeIndex(indexPath(), m_entries);
+    }
+}
+
+std::optional<MediaInfo> MetadataCache::lookup(const QString& filePath)
+{
+    ensureLoaded();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(filePath);
+    if (it == m_entries.end()) {
+        return std::nullopt;
+    }
+
+    // A changed file is a different file
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile() || fileInfo.size() != it->size
+        || fileInfo.lastModified().toMSecsSinceEpoch() != it->modifiedMs) {
+        m_entryBytes -= entryBytes(it.key(), *it);
+        m_entries.erase(it);
+        scheduleSave();
+        return std::nullopt;
+    }
+
+    it->lastUsedSecs = QDateTime::currentSecsSinceEpoch();
+    return it->info;
+}
+
+void MetadataCache::prefetch(const QStringList& filePaths)
+{
+    ensureLoaded();
+
+    if (!m_loaded) {
+        m_pendingProbes.append(filePaths);
+        return;
+    }
+
+    if (!m_probeThread.isRunning()) {
+        m_prober = new MetadataProber(this);
+        m_prober->moveToThread(&m_probeThread);
+        connect(&m_probeThread, &QThread::finished, m_prober, &QObject::deleteLater);
+        m_probeThread.start(QThread::LowPriority);
+    }
+
+    for (const QString& filePath : filePaths) {
+        if (filePath.isEmpty() || m_probeRequested.contains(filePath) || lookup(filePath)) {
+            continue;
+        }
+
+        m_probeRequested.insert(filePath);
+        MetadataProber* prober = m_prober;
+        QMetaObject::invokeMethod(prober, [prober, filePath]() { prober->enqueue(filePath); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void MetadataCache::store(const QString& filePath, const MediaInfo& info)
+{
+    // Engines store from the engine thread; entries are only ever added on ours
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, filePath, info]() { store(filePath, info); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile()) {
+        return;
+    }
+
+    onProbed(filePath, fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), info);
+}
+
+MediaType MetadataCache::detectMediaType(const QString& filePath)
+{
+    if (const auto cached = lookup(filePath)) {
+        if (cached->mediaType != MediaType::Unknown) {
+            return cached->mediaType;
+        }
+    }
+
+    // The name usually settles it; only sniff the contents when it does not
+    static const QMimeDatabase mimeDatabase;
+    QMimeType mimeType = mimeDatabase.mimeTypeForFile(filePath, QMimeDatabase::MatchExtension);
+    if (mimeType.isDefault()) {
+        mimeType = mimeDatabase.mimeTypeForFile(filePath, QMimeDatabase::MatchContent);
+    }
+
+    const QString name = mimeType.name();
+    if (name.startsWith("video/")) {
+        return MediaType::Video;
+    }
+    if (name.startsWith("audio/")) {
+        return MediaType::Audio;
+    }
+    return MediaType::Unknown;
+}
+
+MediaInfo MetadataCache::infoFromPlayer(const QMediaPlayer& player)
+{
+    const QMediaMetaData metaData = player.metaData();
+
+    MediaInfo info;
+    info.durationMs = player.duration();
+    info.resolution = metaData.value(QMediaMetaData::Resolution).toSize();
+    info.title = metaData.stringValue(QMediaMetaData::Title);
+    info.audioTrackCount = static_cast<int>(player.audioTracks().size());
+
+    const QVariant videoCodec = metaData.value(QMediaMetaData::VideoCodec);
+    if (videoCodec.isValid()) {
+        info.videoCodec = QMediaFormat::videoCodecName(videoCodec.value<QMediaFormat::VideoCodec>());
+    }
+    const QVariant audioCodec = metaData.value(QMediaMetaData::AudioCodec);
+    if (audioCodec.isValid()) {
+        info.audioCodec = QMediaFormat::audioCodecName(audioCodec.value<QMediaFormat::AudioCodec>());
+    }
+
+    if (player.hasVideo()) {
+        info.mediaType = MediaType::Video;
+    } else if (player.hasAudio()) {
+        info.mediaType = MediaType::Audio;
+    }
+    return info;
+}
+
+QString MetadataCache::formatDuration(qint64 milliseconds)
+{
+    const qint64 totalSeconds = milliseconds / 1000;
+    const qint64 hours = totalSeconds / 3600;
+    const qint64 minutes = (totalSeconds % 3600) / 60;
+    const qint64 seconds = totalSeconds % 60;
+
+    if (hours > 0) {
+        return QString("%1:%2:%3").arg(hours).arg(minutes, 2, 10, QChar('0')).arg(seconds, 2, 10, QChar('0'));
+    }
+    return QString("%1:%2").arg(minutes).arg(seconds, 2, 10, QChar('0'));
+}
+
+void MetadataCache::ensureLoaded()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_loadRequested) {
+            return;
+        }
+        m_loadRequested = true;
+    }
+
+    // Tens of thousands of entries: read them off the GUI thread
+    QPointer<MetadataCache> self(this);
+    m_ioPool.start([self, path = indexPath()]() {
+        const QHash<QString, Entry> entries = readIndex(path);
+        if (self) {
+            QMetaObject::invokeMethod(self.data(), [self, entries]() {
+                if (self) {
+                    self->onLoaded(entries);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void MetadataCache::onLoaded(const QHash<QString, Entry>& entries)
+{
+    int count = 0;
+    {
+        // Anything stored while loading is newer than the index
+        std::lock_guard<std::mutex> lock(m_mutex);
+        QHash<QString, Entry> merged = entries;
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            merged.insert(it.key(), it.value());
+        }
+        m_entries = std::move(merged);
+        count = static_cast<int>(m_entries.size());
+        m_entryBytes = 0;
+        for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+            m_entryBytes += entryBytes(it.key(), it.value());
+        }
+    }
+    m_loaded = true;
+    qDebug() << "MetadataCache: Loaded" << count << "entries";
+
+    // Requests made before the index arrived: announce hits, probe the rest
+    const QStringList pending = std::exchange(m_pendingProbes, {});
+    for (const QString& filePath : pending) {
+        if (const auto cached = lookup(filePath)) {
+            emit infoAvailable(filePath, *cached);
+        }
+    }
+    if (!pending.isEmpty()) {
+        prefetch(pending);
+    }
+}
+
+void MetadataCache::onProbed(const QString& filePath, qint64 size, qint64 modifiedMs, const MediaInfo& info)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto existing = m_entries.constFind(filePath);
+        if (existing != m_entries.cend()) {
+            m_entryBytes -= entryBytes(existing.key(), existing.value());
+        }
+        Entry& entry = m_entries[filePath];
+        entry.size = size;
+        entry.modifiedMs = modifiedMs;
+        entry.lastUsedSecs = QDateTime::currentSecsSinceEpoch();
+        entry.info = info;
+        m_entryBytes += entryBytes(filePath, entry);
+        scheduleSave();
+    }
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->requestCheck();
+    }
+    emit infoAvailable(filePath, info);
+}
+
+qint64 MetadataCache::memoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entryBytes;
+}
+
+qint64 MetadataCache::oldestUseMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Before the index is merged, whatever we dropped would come back from disk
+    if (!m_loaded || m_entries.isEmpty()) {
+        return -1;
+    }
+    qint64 oldest = std::numeric_limits<qint64>::max();
+    for (const Entry& entry : m_entries) {
+        oldest = std::min(oldest, entry.lastUsedSecs);
+    }
+    return oldest * 1000;
+}
+
+qint64 MetadataCache::evict(qint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_loaded) {
+        return 0;
+    }
+
+    QList<std::pair<qint64, QString>> byAge;
+    byAge.reserve(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        byAge.append({it->lastUsedSecs, it.key()});
+    }
+    std::sort(byAge.begin(), byAge.end());
+
+    qint64 freed = 0;
+    for (const auto& [lastUsedSecs, filePath] : std::as_const(byAge)) {
+        if (freed >= bytes) {
+            break;
+        }
+        const auto it = m_entries.find(filePath);
+        freed += entryBytes(it.key(), *it);
+        m_entries.erase(it);
+    }
+    m_entryBytes -= freed;
+    if (freed > 0) {
+        scheduleSave();
+    }
+    return freed;
+}
+
+void MetadataCache::scheduleSave()
+{
+    // m_mutex is held; a lookup on the engine thread can get here, but the timer is ours
+    m_dirty = true;
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this]() {
+            if (!m_saveTimer.isActive()) {
+                m_saveTimer.start();
+            }
+        }, Qt::QueuedConnection);
+    } else if (!m_saveTimer.isActive()) {
+        m_saveTimer.start();
+    }
+}
+
+void MetadataCache::save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_dirty) {
+        return;
+    }
+    if (!m_loaded) {
+        m_saveTimer.start(); // Never overwrite an index we have not merged yet
+        return;
+    }
+
+    m_dirty = false;
+    m_ioPool.start([path = indexPath(), entries = m_entries]() { writeIndex(path, entries); });
+}
+
+qint64 MetadataCache::entryBytes(const QString& filePath, const Entry& entry)
+{
+    const qsizetype characters = filePath.size() + entry.info.videoCodec.size() + entry.info.audioCodec.size()
+        + entry.info.title.size();
+    return ENTRY_OVERHEAD_BYTES + characters * static_cast<qint64>(sizeof(QChar));
+}
+
+QString MetadataCache::indexPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/metadata.cache";
+}
+
+QHash<QString, MetadataCache::Entry> MetadataCache::readIndex(const QString& path)
+{
+    QHash<QString, Entry> entries;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return entries;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != INDEX_MAGIC || version != INDEX_FORMAT_VERSION || count < 0) {
+        return entries;
+    }
+
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString filePath;
+        Entry entry;
+        stream >> filePath >> entry.size >> entry.modifiedMs >> entry.lastUsedSecs >> entry.info;
+        if (stream.status() == QDataStream::Ok) {
+            entries.insert(filePath, entry);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "MetadataCache: Index is truncated, kept" << entries.size() << "entries";
+    }
+    return entries;
+}
+
+void MetadataCache::writeIndex(const QString& path, QHash<QString, Entry> entries)
+{
+    // Least recently used entries go first once the cache is full
+    if (entries.size() > MAX_ENTRIES) {
+        QList<qint64> lastUsed;
+        lastUsed.reserve(entries.size());
+        for (const Entry& entry : std::as_const(entries)) {
+            lastUsed.append(entry.lastUsedSecs);
+        }
+        const auto cutoff = lastUsed.begin() + (entries.size() - MAX_ENTRIES);
+        std::nth_element(lastUsed.begin(), cutoff, lastUsed.end());
+        const qint64 threshold = *cutoff;
+        entries.removeIf([threshold](const QHash<QString, Entry>::iterator& it) {
+            return it.value().lastUsedSecs < threshold;
+        });
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "MetadataCache: Cannot write" << path;
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << INDEX_MAGIC << qint32(INDEX_FORMAT_VERSION) << qint32(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        stream << it.key() << it->size << it->modifiedMs << it->lastUsedSecs << it->info;
+    }
+
+    if (!file.commit()) {
+        qWarning() << "MetadataCache: Failed to save index";
+    }
+}
+
+} // namespace DarkPlay::Media
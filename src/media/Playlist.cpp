@@ -0,0 +1,426 @@
+#include "media/Playlist.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+// splitmix64 finaliser: cheap and well mixed, enough for a play order
+quint64 mix(quint64 value) noexcept
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// Prefix is everything up to and including the last separator
+qsizetype splitPosition(const QString& url)
+{
+    const qsizetype slash = std::max(url.lastIndexOf(QLatin1Char('/')), url.lastIndexOf(QLatin1Char('\\')));
+    return slash + 1;
+}
+
+QString resolveImportedEntry(const QString& entry, const QDir& baseDir)
+{
+    // URLs and absolute paths as written; relative paths are relative to the playlist file
+    if (entry.contains(QLatin1String("://")) || QDir::isAbsolutePath(entry)) {
+        return entry;
+    }
+    return QDir::cleanPath(baseDir.absoluteFilePath(entry));
+}
+
+} // namespace
+
+ShuffleOrder::ShuffleOrder(int size, quint64 seed)
+    : m_size(std::max(size, 0))
+    , m_seed(seed)
+{
+    // Smallest even-width domain that holds every row; cycle walking skips the rest
+    int bits = 2;
+    while (bits < 32 && (quint64(1) << bits) < quint64(m_size)) {
+        bits += 2;
+    }
+    m_halfBits = bits / 2;
+    m_halfMask = (quint32(1) << m_halfBits) - 1;
+}
+
+int ShuffleOrder::rowAt(int position) const
+{
+    if (position < 0 || position >= m_size) {
+        return -1;
+    }
+
+    // The domain is at most four times the size, so this loops about twice on average
+    quint32 value = encrypt(static_cast<quint32>(position));
+    while (value >= static_cast<quint32>(m_size)) {
+        value = encrypt(value);
+    }
+    return static_cast<int>(value);
+}
+
+int ShuffleOrder::positionOf(int row) const
+{
+    if (row < 0 || row >= m_size) {
+        return -1;
+    }
+
+    quint32 value = decrypt(static_cast<quint32>(row));
+    while (value >= static_cast<quint32>(m_size)) {
+        value = decrypt(value);
+    }
+    return static_cast<int>(value);
+}
+
+quint32 ShuffleOrder::round(quint32 half, int roundIndex) const noexcept
+{
+    return static_cast<quint32>(mix(m_seed ^ (quint64(roundIndex) << 56) ^ half)) & m_halfMask;
+}
+
+quint32 ShuffleOrder::encrypt(quint32 value) const noexcept
+{
+    quint32 left = value >> m_halfBits;
+    quint32 right = value & m_halfMask;
+    for (int i = 0; i < ROUNDS; ++i) {
+        const quint32 next = left ^ round(right, i);
+        left = right;
+        right = next;
+    }
+    return (left << m_halfBits) | right;
+}
+
+quint32 ShuffleOrder::decrypt(quint32 value) const noexcept
+{
+    quint32 left = value >> m_halfBits;
+    quint32 right = value & m_halfMask;
+    for (int i = ROUNDS - 1; i >= 0; --i) {
+        const quint32 previous = right ^ round(left, i);
+        right = left;
+        left = previous;
+    }
+    return (left << m_halfBits) | right;
+}
+
+Playlist::Playlist(QObject* parent)
+    : QObject(parent)
+    , m_garbageBytes(0)
+    , m_nextId(1)
+    , m_shuffleOrder(0, QRandomGenerator::global()->generate64())
+    , m_importGeneration(0)
+    , m_importing(false)
+    , m_importedCount(0)
+{
+    m_ioPool.setMaxThreadCount(1);
+}
+
+Playlist::~Playlist()
+{
+    ++m_importGeneration;
+    m_ioPool.waitForDone();
+}
+
+QString Playlist::urlAt(int row) const
+{
+    if (row < 0 || row >= count()) {
+        return {};
+    }
+    const Entry& entry = m_entries[row];
+    return m_prefixes.at(entry.prefix) + QString::fromUtf8(m_names.constData() + entry.nameOffset, entry.nameLength);
+}
+
+Playlist::EntryId Playlist::idAt(int row) const
+{
+    return (row >= 0 && row < count()) ? m_entries[row].id : 0;
+}
+
+QString Playlist::displayNameAt(int row) const
+{
+    if (row < 0 || row >= count()) {
+        return {};
+    }
+    const Entry& entry = m_entries[row];
+    return QString::fromUtf8(m_names.constData() + entry.nameOffset, entry.nameLength);
+}
+
+int Playlist::indexOfId(EntryId id) const
+{
+    const auto it = std::find_if(m_entries.cbegin(), m_entries.cend(),
+                                 [id](const Entry& entry) { return entry.id == id; });
+    return it == m_entries.cend() ? -1 : static_cast<int>(it - m_entries.cbegin());
+}
+
+void Playlist::insert(int row, const QStringList& urls)
+{
+    if (urls.isEmpty()) {
+        return;
+    }
+    row = std::clamp(row, 0, count());
+
+    std::vector<Entry> added;
+    added.reserve(urls.size());
+    for (const QString& url : urls) {
+        added.push_back(makeEntry(url));
+    }
+
+    const int last = row + static_cast<int>(added.size()) - 1;
+    emit rowsAboutToBeInserted(row, last);
+    m_entries.insert(m_entries.begin() + row, added.cbegin(), added.cend());
+    updateShuffleOrder();
+    emit rowsInserted(row, last);
+}
+
+void Playlist::append(const QStringList& urls)
+{
+    insert(count(), urls);
+}
+
+void Playlist::remove(int row, int count)
+{
+    if (row < 0 || count <= 0 || row + count > this->count()) {
+        return;
+    }
+
+    const int last = row + count - 1;
+    emit rowsAboutToBeRemoved(row, last);
+    const auto first = m_entries.cbegin() + row;
+    releaseEntries(first, first + count);
+    m_entries.erase(first, first + count);
+    updateShuffleOrder();
+    emit rowsRemoved(row, last);
+
+    compactNames();
+}
+
+bool Playlist::move(int row, int count, int destinationRow)
+{
+    // Same rules as beginMoveRows: the destination may not fall inside the moved block
+    if (row < 0 || count <= 0 || row + count > this->count()
+        || destinationRow < 0 || destinationRow > this->count()
+        || (destinationRow >= row && destinationRow <= row + count)) {
+        return false;
+    }
+
+    const int last = row + count - 1;
+    emit rowsAboutToBeMoved(row, last, destinationRow);
+    const auto begin = m_entries.begin();
+    if (destinationRow > row) {
+        std::rotate(begin + row, begin + row + count, begin + destinationRow);
+    } else {
+        std::rotate(begin + destinationRow, begin + row, begin + row + count);
+    }
+    emit rowsMoved(row, last, destinationRow);
+    return true;
+}
+
+void Playlist::reset(const QStringList& urls)
+{
+    emit modelAboutToBeReset();
+
+    m_entries.clear();
+    m_names.clear();
+    m_garbageBytes = 0;
+    m_prefixes.clear();
+    m_prefixIds.clear();
+
+    m_entries.reserve(urls.size());
+    for (const QString& url : urls) {
+        m_entries.push_back(makeEntry(url));
+    }
+    updateShuffleOrder();
+
+    emit modelReset();
+}
+
+void Playlist::clear()
+{
+    cancelImport();
+    reset({});
+}
+
+void Playlist::reshuffle()
+{
+    m_shuffleOrder = ShuffleOrder(count(), QRandomGenerator::global()->generate64());
+}
+
+void Playlist::importFile(const QString& filePath)
+{
+    cancelImport();
+
+    const quint64 generation = m_importGeneration.load();
+    m_importing = true;
+    m_importedCount = 0;
+    m_ioPool.start([this, generation, filePath]() { runImport(generation, filePath); });
+}
+
+void Playlist::cancelImport()
+{
+    if (!m_importing) {
+        return;
+    }
+
+    // Batches already queued carry the old generation and are dropped on arrival
+    ++m_importGeneration;
+    m_importing = false;
+    emit importFinished(m_importedCount, QStringLiteral("Import cancelled"));
+}
+
+Playlist::Entry Playlist::makeEntry(const QString& url)
+{
+    const qsizetype split = splitPosition(url);
+    const QByteArray name = QStringView(url).mid(split).toUtf8();
+
+    Entry entry;
+    entry.id = m_nextId++;
+    entry.prefix = internPrefix(url.left(split));
+    entry.nameOffset = static_cast<quint32>(m_names.size());
+    entry.nameLength = static_cast<quint32>(name.size());
+    m_names.append(name);
+    return entry;
+}
+
+quint32 Playlist::internPrefix(const QString& prefix)
+{
+    const auto it = m_prefixIds.constFind(prefix);
+    if (it != m_prefixIds.cend()) {
+        return it.value();
+    }
+
+    const auto id = static_cast<quint32>(m_prefixes.size());
+    m_prefixes.append(prefix);
+    m_prefixIds.insert(prefix, id);
+    return id;
+}
+
+void Playlist::releaseEntries(std::vector<Entry>::const_iterator first, std::vector<Entry>::const_iterator last)
+{
+    for (auto it = first; it != last; ++it) {
+        m_garbageBytes += it->nameLength;
+    }
+}
+
+void Playlist::compactNames()
+{
+    // Rewrite the arena once removed names make up most of it; prefixes are few and stay interned
+    if (m_garbageBytes < MIN_COMPACT_BYTES || m_garbageBytes * 2 < m_names.size()) {
+        return;
+    }
+
+    QByteArray compacted;
+    compacted.reserve(m_names.size() - m_garbageBytes);
+    for (Entry& entry : m_entries) {
+        const auto offset = static_cast<quint32>(compacted.size());
+        compacted.append(m_names.constData() + entry.nameOffset, entry.nameLength);
+        entry.nameOffset = offset;
+    }
+    m_names = std::move(compacted);
+    m_garbageBytes = 0;
+}
+
+void Playlist::updateShuffleOrder()
+{
+    if (m_shuffleOrder.size() != count()) {
+        m_shuffleOrder = ShuffleOrder(count(), m_shuffleOrder.seed());
+    }
+}
+
+void Playlist::runImport(quint64 generation, const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QString error = QString("Cannot open %1: %2").arg(filePath, file.errorString());
+        QMetaObject::invokeMethod(this, [this, generation, error]() { onImportFinished(generation, error); },
+                                  Qt::QueuedConnection);
+        return;
+    }
+
+    const QDir baseDir = QFileInfo(filePath).absoluteDir();
+    QTextStream stream(&file); // Detects UTF-8/UTF-16 BOMs, assumes UTF-8 otherwise
+    bool pls = filePath.endsWith(QLatin1String(".pls"), Qt::CaseInsensitive);
+    bool firstLine = true;
+
+    QStringList batch;
+    batch.reserve(IMPORT_BATCH_SIZE);
+    QString line;
+    while (stream.readLineInto(&line)) {
+        if (m_importGeneration.load() != generation) {
+            return;
+        }
+
+        const QString trimmed = line.trimmed();
+        if (firstLine) {
+            firstLine = false;
+            if (trimmed.compare(QLatin1String("[playlist]"), Qt::CaseInsensitive) == 0) {
+                pls = true;
+                continue;
+            }
+        }
+        if (trimmed.isEmpty()) {
+            continue;
+        }
+
+        QString entry;
+        if (pls) {
+            // FileN=<location>; titles and lengths come from the media itself
+            if (!trimmed.startsWith(QLatin1String("file"), Qt::CaseInsensitive)) {
+                continue;
+            }
+            const qsizetype equals = trimmed.indexOf(QLatin1Char('='));
+            if (equals < 0) {
+                continue;
+            }
+            entry = trimmed.mid(equals + 1).trimmed();
+        } else if (!trimmed.startsWith(QLatin1Char('#'))) {
+            entry = trimmed;
+        }
+        if (entry.isEmpty()) {
+            continue;
+        }
+
+        batch.append(resolveImportedEntry(entry, baseDir));
+        if (batch.size() >= IMPORT_BATCH_SIZE) {
+            QMetaObject::invokeMethod(this, [this, generation, urls = std::move(batch)]() {
+                onImportBatch(generation, urls);
+            }, Qt::QueuedConnection);
+            batch = QStringList();
+            batch.reserve(IMPORT_BATCH_SIZE);
+        }
+    }
+
+    const QString error = (stream.status() == QTextStream::Ok) ? QString() : QString("Read error in %1").arg(filePath);
+    QMetaObject::invokeMethod(this, [this, generation, urls = std::move(batch), error]() {
+        onImportBatch(generation, urls);
+        onImportFinished(generation, error);
+    }, Qt::QueuedConnection);
+}
+
+void Playlist::onImportBatch(quint64 generation, const QStringList& urls)
+{
+    if (generation != m_importGeneration.load() || urls.isEmpty()) {
+        return;
+    }
+
+    append(urls);
+    m_importedCount += static_cast<int>(urls.size());
+    emit importProgress(m_importedCount);
+}
+
+void Playlist::onImportFinished(quint64 generation, const QString& error)
+{
+    if (generation != m_importGeneration.load()) {
+        return;
+    }
+
+    m_importing = false;
+    if (!error.isEmpty()) {
+        qWarning() << "Playlist import:" << error;
+    }
+    emit importFinished(m_importedCount, error);
+}
+
+} // namespace DarkPlay::Media
@@ -1,13 +1,21 @@
 #include "media/QtMediaEngine.h"
+#include "media/AdaptiveBitrateController.h"
+#include "media/HardwareDecoding.h"
+#include "media/KeyframeIndex.h"
+#include "media/AudioDeviceCache.h"
+#include "media/StreamBuffer.h"
+#include "utils/Trace.h"
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+#include "media/AudioPipeline.h"
+#endif
 #include <QFileInfo>
 #include <QDebug>
 #include <QVideoSink>
+#include <QVideoFrame>
 #include <QMediaMetaData>
 #include <QAudioDevice>
-#include <QMediaDevices>
 #include <QAudioFormat>
-#include <QProcess>
-#include <QRegularExpression>
+#include <utility>
 
 namespace DarkPlay::Media {
 
@@ -16,8 +24,24 @@ QtMediaEngine::QtMediaEngine(QObject* parent)
     , m_player(std::make_unique<QMediaPlayer>(this))
     , m_audioOutput(std::make_unique<QAudioOutput>(this))
     , m_videoSink(nullptr)
+    , m_lastFrameStartUs(-1)
+    , m_seekLanding(false)
+    , m_stepTargetUs(-1)
+    , m_stepFromFrameUs(-1)
+    , m_timeStretch(false)
     , m_currentMediaType(MediaType::Unknown)
-{
+    , m_pendingSeek(-1)
+    , m_stallRecoveryTimer(this) // Parented, so it follows the engine to its thread
+    , m_sourcePending(false)
+    , m_playWhenReady(false)
+    , m_resumePosition(-1)
+    , m_resumePlaying(false)
+{
+    // Engines are built on the GUI thread and run on the engine thread, which
+    // uses these caches too; they must be created here, on their own thread
+    static_cast<void>(MetadataCache::instance());
+    static_cast<void>(KeyframeIndex::instance());
+
     // Initialize audio output with proper settings
     initializeAudioOutput();
 
@@ -35,6 +59,24 @@ QtMediaEngine::QtMediaEngine(QObject* parent)
             this, &QtMediaEngine::onPlayerPositionChanged);
     connect(m_player.get(), &QMediaPlayer::durationChanged,
             this, &QtMediaEngine::onPlayerDurationChanged);
+    connect(m_player.get(), &QMediaPlayer::playbackRateChanged,
+            this, &QtMediaEngine::playbackRateChanged);
+    connect(m_player.get(), &QMediaPlayer::metaDataChanged,
+            this, &QtMediaEngine::onPlayerMetaDataChanged);
+    connect(m_player.get(), &QMediaPlayer::hasVideoChanged,
+            this, &QtMediaEngine::mediaInfoChanged);
+    connect(m_player.get(), &QMediaPlayer::hasAudioChanged,
+            this, &QtMediaEngine::mediaInfoChanged);
+    connect(m_player.get(), &QMediaPlayer::bufferProgressChanged,
+            this, &QtMediaEngine::onPlayerBufferProgressChanged);
+
+    // A stall that outlasts this is handed to the ABR controller
+    m_stallRecoveryTimer.setSingleShot(true);
+    connect(&m_stallRecoveryTimer, &QTimer::timeout, this, [this]() {
+        if (m_abrController) {
+            m_abrController->reportLongStall();
+        }
+    });
 
     // Audio output signals
     connect(m_audioOutput.get(), &QAudioOutput::volumeChanged,
@@ -45,10 +87,17 @@ QtMediaEngine::QtMediaEngine(QObject* parent)
     qDebug() << "QtMediaEngine initialized";
 }
 
-QtMediaEngine::~QtMediaEngine() = default;
+QtMediaEngine::~QtMediaEngine()
+{
+    // The player must let go of the stream device and the pipeline's buffer output first
+    releaseStream();
+    disableAudioPipeline();
+}
 
 bool QtMediaEngine::loadMedia(const QUrl& url)
 {
+    DARKPLAY_TRACE_SCOPE("media", "loadMedia");
+
     if (!url.isValid()) {
         m_lastError = "Invalid URL provided";
         emit errorOccurred(m_lastError);
@@ -64,22 +113,63 @@ bool QtMediaEngine::loadMedia(const QUrl& url)
 
     // Reset position to beginning for new media
     m_player->setPosition(0);
+    m_pendingSeek = -1;
+    m_seekLanding.store(false, std::memory_order_relaxed);
 
     // Clear previous video info
     m_videoSize = QSize();
+    m_frameStatistics.reset();
+    m_lastFrameStartUs.store(-1, std::memory_order_relaxed);
+    m_stepTargetUs = -1;
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    // Back to direct output once nothing needs the pipeline any more
+    if (m_timeStretch && qFuzzyCompare(m_player->playbackRate(), 1.0)) {
+        m_timeStretch = false;
+        if (!audioPipelineWanted()) {
+            disableAudioPipeline();
+        }
+    }
+    if (m_audioPipeline) {
+        m_audioPipeline->flush();
+    }
+#endif
+    m_clock.reset(0);
+
+    // A cache hit lets the UI show duration and size before the backend has probed
+    m_cachedInfo.reset();
+    if (url.isLocalFile()) {
+        m_cachedInfo = MetadataCache::instance()->lookup(url.toLocalFile());
+    }
+    if (m_cachedInfo) {
+        m_videoSize = m_cachedInfo->resolution;
+    }
 
     m_currentMediaType = detectMediaType(url);
-    m_player->setSource(url);
+    releaseStream();
+    m_playWhenReady = false;
+    if (url.isLocalFile() || url.isRelative() || url.scheme() == "qrc") {
+        m_player->setSource(url);
+    } else {
+        openStream(url);
+    }
 
     // Emit signals to reset UI state
     emit positionChanged(0);
-    emit durationChanged(0);
+    emit durationChanged(m_cachedInfo ? m_cachedInfo->durationMs : 0);
+    if (m_cachedInfo) {
+        emit mediaInfoChanged();
+    }
 
     return true;
 }
 
 void QtMediaEngine::play()
 {
+    if (m_sourcePending) {
+        m_playWhenReady = true; // The stream probe is still running
+        return;
+    }
+
     if (m_player->source().isEmpty()) {
         m_lastError = "No media loaded";
         emit errorOccurred(m_lastError);
@@ -99,11 +189,13 @@ void QtMediaEngine::play()
 
 void QtMediaEngine::pause()
 {
+    m_playWhenReady = false;
     m_player->pause();
 }
 
 void QtMediaEngine::stop()
 {
+    m_playWhenReady = false;
     m_player->stop();
 }
 
@@ -114,14 +206,90 @@ qint64 QtMediaEngine::position() const
 
 qint64 QtMediaEngine::duration() const
 {
-    return m_player->duration();
+    const qint64 duration = m_player->duration();
+    if (duration <= 0 && m_cachedInfo) {
+        return m_cachedInfo->durationMs;
+    }
+    return duration;
 }
 
 void QtMediaEngine::setPosition(qint64 position)
 {
+    DARKPLAY_TRACE_INSTANT("media", "seek", position);
+
+    m_clock.reset(position * 1000);
+
+    // The backend drops seeks while it is still opening the source
+    if (m_sourcePending || m_player->mediaStatus() == QMediaPlayer::LoadingMedia) {
+        m_pendingSeek = position;
+        // Completes with the first frame once the media has loaded and the seek is applied
+        m_seekLanding.store(true, std::memory_order_relaxed);
+        return;
+    }
+
+    m_frameStatistics.markDiscontinuity();
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    // Buffered audio belongs to the old position
+    if (m_audioPipeline) {
+        m_audioPipeline->flush();
+    }
+#endif
+    m_seekLanding.store(true, std::memory_order_relaxed);
     m_player->setPosition(position);
 }
 
+bool QtMediaEngine::stepFrame(int frames)
+{
+    if (frames == 0 || m_sourcePending || !m_player->hasVideo()) {
+        return false;
+    }
+    const qint64 frameUs = frameDurationUs();
+    if (frameUs <= 0) {
+        return false;
+    }
+
+    if (m_player->playbackState() == QMediaPlayer::PlayingState) {
+        m_player->pause();
+    }
+
+    // Repeated steps arrive faster than frames; until the last one is on screen, build on its target
+    const qint64 shownUs = m_lastFrameStartUs.load(std::memory_order_relaxed);
+    qint64 currentUs = shownUs >= 0 ? shownUs : m_player->position() * 1000;
+    if (m_stepTargetUs >= 0 && shownUs == m_stepFromFrameUs) {
+        currentUs = m_stepTargetUs;
+    }
+
+    qint64 targetUs = qMax<qint64>(0, currentUs + frames * frameUs);
+    const qint64 durationUs = m_player->duration() * 1000;
+    if (durationUs > frameUs) {
+        targetUs = qMin(targetUs, durationUs - frameUs);
+    }
+    m_stepTargetUs = targetUs;
+    m_stepFromFrameUs = shownUs;
+
+    // Mid-frame, so the millisecond position cannot round onto a neighbour
+    setPosition((targetUs + frameUs / 2) / 1000);
+    return true;
+}
+
+qint64 QtMediaEngine::frameDurationUs() const
+{
+    if (m_player->source().isLocalFile()) {
+        const auto table = KeyframeIndex::instance()->lookup(m_player->source().toLocalFile());
+        if (table && table->frameDurationUs > 0) {
+            return table->frameDurationUs;
+        }
+    }
+
+    const double measuredRate = m_frameStatistics.stats().frameRate;
+    if (measuredRate > 0.0) {
+        return qRound64(1000000.0 / measuredRate);
+    }
+
+    const qreal nominalRate = m_player->metaData().value(QMediaMetaData::VideoFrameRate).toReal();
+    return nominalRate > 0.0 ? qRound64(1000000.0 / nominalRate) : 0;
+}
+
 int QtMediaEngine::volume() const
 {
     // Convert from 0.0-1.0 to 0-100
@@ -152,6 +320,20 @@ qreal QtMediaEngine::playbackRate() const
 
 void QtMediaEngine::setPlaybackRate(qreal rate)
 {
+    m_frameStatistics.setPlaybackRate(rate);
+    m_clock.setRate(rate);
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    // Stretched in the pipeline, so the voice keeps its pitch; it stays up for later changes
+    if (!qFuzzyCompare(rate, 1.0) && !m_timeStretch) {
+        m_timeStretch = true;
+        if (!m_audioPipeline) {
+            enableAudioPipeline();
+        }
+    }
+    if (m_audioPipeline) {
+        m_audioPipeline->setPlaybackRate(rate);
+    }
+#endif
     m_player->setPlaybackRate(rate);
 }
 
@@ -177,6 +359,9 @@ QString QtMediaEngine::title() const
     if (metaData.stringValue(QMediaMetaData::Title).isEmpty() == false) {
         return metaData.stringValue(QMediaMetaData::Title);
     }
+    if (m_cachedInfo && !m_cachedInfo->title.isEmpty()) {
+        return m_cachedInfo->title;
+    }
 
     // Fallback to filename
     QUrl source = m_player->source();
@@ -205,8 +390,26 @@ bool QtMediaEngine::hasAudio() const
 
 void QtMediaEngine::setVideoSink(QVideoSink* sink)
 {
+    disconnect(m_sinkFrameConnection);
+
     m_videoSink = sink;
     m_player->setVideoSink(sink);
+
+    // Direct connection: timestamp frames on the delivering thread, before any queueing
+    if (sink) {
+        m_sinkFrameConnection = connect(sink, &QVideoSink::videoFrameChanged, this,
+                                        [this](const QVideoFrame& frame) {
+                                            if (frame.isValid()) {
+                                                DARKPLAY_TRACE_INSTANT("video", "frameArrived", frame.startTime());
+                                                m_frameStatistics.recordArrival(frame.startTime());
+                                                m_lastFrameStartUs.store(frame.startTime(), std::memory_order_relaxed);
+                                                if (m_seekLanding.exchange(false, std::memory_order_relaxed)) {
+                                                    DARKPLAY_TRACE_INSTANT("media", "seekLanded", frame.startTime());
+                                                    emit seekCompleted(frame.startTime() >= 0 ? frame.startTime() / 1000 : -1);
+                                                }
+                                            }
+                                        }, Qt::DirectConnection);
+    }
 }
 
 QVideoSink* QtMediaEngine::videoSink() const
@@ -214,22 +417,114 @@ QVideoSink* QtMediaEngine::videoSink() const
     return m_videoSink;
 }
 
+FrameStats QtMediaEngine::frameStats() const
+{
+    return m_frameStatistics.stats();
+}
+
+void QtMediaEngine::resetFrameStats()
+{
+    m_frameStatistics.reset();
+}
+
+void QtMediaEngine::reportFramePresented(qint64 presentationTimeUs)
+{
+    m_frameStatistics.recordPresented(presentationTimeUs);
+    m_clock.recordVideoPresented(presentationTimeUs);
+}
+
+void QtMediaEngine::setAudioEffects(const QList<Plugins::IAudioEffectPlugin*>& effects)
+{
+    m_audioEffects = effects;
+
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    // Without effects or a rate to stretch QAudioOutput plays directly, at no extra latency
+    if (!audioPipelineWanted()) {
+        disableAudioPipeline();
+        return;
+    }
+
+    if (!m_audioPipeline && !enableAudioPipeline()) {
+        return;
+    }
+    m_audioPipeline->setEffects(effects);
+#else
+    if (!effects.isEmpty()) {
+        qWarning() << "Audio effect plugins need Qt 6.8 or newer; playing unprocessed audio";
+    }
+#endif
+}
+
 // Private slots
 void QtMediaEngine::onPlayerStateChanged(QMediaPlayer::PlaybackState state)
 {
+    DARKPLAY_TRACE_INSTANT("media", "playbackState", state);
+
+    // Paused time must not count against the frame schedule
+    m_frameStatistics.markDiscontinuity();
+    m_clock.setPaused(state != QMediaPlayer::PlayingState);
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    if (m_audioPipeline) {
+        m_audioPipeline->setPaused(state != QMediaPlayer::PlayingState);
+    }
+#endif
+    if (m_abrController) {
+        m_abrController->setPlaying(state == QMediaPlayer::PlayingState);
+    }
     emit stateChanged(convertState(state));
 }
 
 void QtMediaEngine::onPlayerMediaStatusChanged(QMediaPlayer::MediaStatus status)
 {
+    DARKPLAY_TRACE_INSTANT("media", "mediaStatus", status);
+
     switch (status) {
     case QMediaPlayer::LoadedMedia:
         updateVideoInfo();
+        if (m_resumePosition >= 0) {
+            // Variant switch: same item, so pick up where the old variant was
+            if (m_resumePosition > 0) {
+                m_player->setPosition(m_resumePosition);
+            }
+            if (m_resumePlaying) {
+                m_player->play();
+            }
+            m_resumePosition = -1;
+            emit mediaInfoChanged();
+            break;
+        }
+        if (m_pendingSeek >= 0) {
+            m_player->setPosition(std::exchange(m_pendingSeek, -1));
+        }
+        if (m_player->source().isLocalFile()) {
+            // Refresh the cache with what the backend found, so the next open is instant
+            const MediaInfo info = MetadataCache::infoFromPlayer(*m_player);
+            MetadataCache::instance()->store(m_player->source().toLocalFile(), info);
+            m_cachedInfo = info;
+            if (info.mediaType != MediaType::Unknown) {
+                m_currentMediaType = info.mediaType;
+            }
+        }
         emit mediaLoaded();
         break;
     case QMediaPlayer::BufferingMedia:
         emit stateChanged(PlaybackState::Buffering);
         break;
+    case QMediaPlayer::BufferedMedia:
+        m_streamingStatistics.markBuffered();
+        m_stallRecoveryTimer.stop();
+        break;
+    case QMediaPlayer::StalledMedia:
+        // Playback ran dry - this is the rebuffering users notice
+        m_streamingStatistics.markStalled();
+        if (m_abrController) {
+            m_abrController->reportStall();
+        }
+        if (m_streamingStatistics.isActive()) {
+            m_stallRecoveryTimer.start(m_streamingOptions.stallRecoveryMs);
+        }
+        emit stateChanged(PlaybackState::Buffering);
+        break;
     case QMediaPlayer::EndOfMedia:
         // When media reaches the end, emit stopped state
         emit stateChanged(PlaybackState::Stopped);
@@ -245,8 +540,6 @@ void QtMediaEngine::onPlayerMediaStatusChanged(QMediaPlayer::MediaStatus status)
 
 void QtMediaEngine::onPlayerErrorOccurred(QMediaPlayer::Error error, const QString& errorString)
 {
-    Q_UNUSED(error)
-
     // Filter out common non-critical warnings
     if (errorString.contains("env_facs_q") ||
         errorString.contains("AAC") ||
@@ -257,11 +550,22 @@ void QtMediaEngine::onPlayerErrorOccurred(QMediaPlayer::Error error, const QStri
 
     m_lastError = errorString.isEmpty() ? "Unknown media error" : errorString;
     emit errorOccurred(m_lastError);
+
+    // A video that fails to decode with hardware decoding on may play in software
+    if ((error == QMediaPlayer::FormatError || error == QMediaPlayer::ResourceError)
+        && hardwareDecodingActive() && m_currentMediaType != MediaType::Audio) {
+        emit hardwareDecodingFailed(m_lastError);
+    }
 }
 
 void QtMediaEngine::onPlayerPositionChanged(qint64 position)
 {
+    m_clock.updateFromEngine(position * 1000);
     emit positionChanged(position);
+    // Without frames to wait for, the first report from the new position completes the seek
+    if ((!m_videoSink || !m_player->hasVideo()) && m_seekLanding.exchange(false, std::memory_order_relaxed)) {
+        emit seekCompleted(position);
+    }
 }
 
 void QtMediaEngine::onPlayerDurationChanged(qint64 duration)
@@ -269,14 +573,56 @@ void QtMediaEngine::onPlayerDurationChanged(qint64 duration)
     emit durationChanged(duration);
 }
 
+void QtMediaEngine::onPlayerBufferProgressChanged(float progress)
+{
+    const int percent = qBound(0, qRound(progress * 100.0f), 100);
+    m_streamingStatistics.setBufferProgress(percent);
+    emit bufferingProgress(percent);
+}
+
+void QtMediaEngine::onVariantSelected(const QUrl& url, int index)
+{
+    Q_UNUSED(index)
+
+    if (m_sourcePending) {
+        m_player->setSource(url);
+        finishPendingLoad();
+        return;
+    }
+
+    // The backend cannot switch renditions in place; reopen at the current position
+    m_resumePosition = m_player->duration() > 0 ? m_player->position() : 0;
+    m_resumePlaying = m_player->playbackState() == QMediaPlayer::PlayingState;
+    m_player->setSource(url);
+}
+
+void QtMediaEngine::onPlayerMetaDataChanged()
+{
+    updateVideoInfo();
+    emit mediaInfoChanged();
+}
+
 void QtMediaEngine::onAudioOutputVolumeChanged(float volume)
 {
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    // QAudioOutput stays the volume/mute model while the pipeline owns the device
+    if (m_audioPipeline) {
+        m_audioPipeline->setVolume(volume);
+    }
+#endif
+
     // Convert from 0.0-1.0 to 0-100
     emit volumeChanged(static_cast<int>(volume * 100));
 }
 
 void QtMediaEngine::onAudioOutputMutedChanged(bool muted)
 {
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    if (m_audioPipeline) {
+        m_audioPipeline->setMuted(muted);
+    }
+#endif
+
     emit mutedChanged(muted);
 }
 
@@ -296,18 +642,11 @@ PlaybackState QtMediaEngine::convertState(QMediaPlayer::PlaybackState qtState) c
 
 MediaType QtMediaEngine::detectMediaType(const QUrl& url) const
 {
+    if (m_cachedInfo && m_cachedInfo->mediaType != MediaType::Unknown) {
+        return m_cachedInfo->mediaType;
+    }
     if (url.isLocalFile()) {
-        QFileInfo fileInfo(url.toLocalFile());
-        QString suffix = fileInfo.suffix().toLower();
-
-        QStringList videoExtensions = {"mp4", "avi", "mkv", "mov", "wmv", "flv", "webm", "m4v"};
-        QStringList audioExtensions = {"mp3", "wav", "flac", "ogg", "aac", "m4a", "wma"};
-
-        if (videoExtensions.contains(suffix)) {
-            return MediaType::Video;
-        } else if (audioExtensions.contains(suffix)) {
-            return MediaType::Audio;
-        }
+        return MetadataCache::instance()->detectMediaType(url.toLocalFile());
     }
 
     return MediaType::Unknown;
@@ -320,95 +659,235 @@ void QtMediaEngine::updateVideoInfo()
     QSize resolution = metaData.value(QMediaMetaData::Resolution).toSize();
     if (resolution.isValid()) {
         m_videoSize = resolution;
+    } else if (m_cachedInfo && m_cachedInfo->resolution.isValid()) {
+        m_videoSize = m_cachedInfo->resolution;
     } else {
         // Fallback to default size if no metadata available
         m_videoSize = QSize();
     }
 }
 
-void QtMediaEngine::initializeAudioOutput()
+void QtMediaEngine::openStream(const QUrl& url)
 {
-    // Get the default audio output device
-    QAudioDevice defaultDevice = QMediaDevices::defaultAudioOutput();
+    const bool http = url.scheme() == "http" || url.scheme() == "https";
+    const QString path = url.path().toLower();
 
-    if (defaultDevice.isNull()) {
-        qWarning() << "No default audio output device found";
+    if (!http) {
+        openDirect(url, "Direct");
         return;
     }
 
-    // Set the audio device for the output
-    m_audioOutput->setDevice(defaultDevice);
+    if (path.endsWith(".m3u8")) {
+        if (!m_streamingOptions.adaptiveBitrate) {
+            openDirect(url, "HLS");
+            return;
+        }
 
-    // NEW APPROACH: Always use high volume for media player, ignore system volume
-    // Media players should be loud and user can adjust if needed
-    float mediaVolume = 0.95f; // Start with 95% - very loud but safe
+        m_streamingStatistics.start("HLS");
+        m_abrController = std::make_unique<AdaptiveBitrateController>(m_streamingOptions);
+        connect(m_abrController.get(), &AdaptiveBitrateController::variantSelected,
+                this, &QtMediaEngine::onVariantSelected);
+        connect(m_abrController.get(), &AdaptiveBitrateController::failed, this, [this, url](const QString& error) {
+            qWarning() << "Adaptive bitrate unavailable, backend opens the stream itself:" << error;
+            m_abrController->disconnect(this);
+            m_abrController.release()->deleteLater(); // We are inside its signal
+            openDirect(url, "HLS");
+        });
+        m_sourcePending = true;
+        m_abrController->start(url);
+        return;
+    }
 
-    // Try to get system volume only for logging purposes
-    float systemVolume = getSystemVolumeLevel();
-    if (systemVolume > 0.0f) {
-        qDebug() << "System volume detected:" << systemVolume << "but using media volume:" << mediaVolume;
-    } else {
-        qDebug() << "System volume unavailable, using high media volume:" << mediaVolume;
+    // DASH manifests are left to the backend's demuxer
+    if (path.endsWith(".mpd")) {
+        openDirect(url, "DASH");
+        return;
     }
 
-    // Set high volume for media playback
-    m_audioOutput->setVolume(mediaVolume);
+    m_streamingStatistics.start("Progressive");
+    m_streamBuffer = std::make_unique<StreamBuffer>(url, m_streamingOptions);
+    StreamBuffer* buffer = m_streamBuffer.get();
+    connect(buffer, &StreamBuffer::ready, this, [this, buffer, url]() {
+        if (buffer == m_streamBuffer.get()) {
+            m_player->setSourceDevice(buffer, url);
+            finishPendingLoad();
+        }
+    });
+    connect(buffer, &StreamBuffer::fallbackRequired, this, [this, buffer, url](const QString& reason) {
+        if (buffer != m_streamBuffer.get()) {
+            return;
+        }
+        qDebug() << "Read-ahead unavailable:" << reason << "- backend streams directly";
+        m_streamBuffer.release()->deleteLater(); // We are inside its signal
+        openDirect(url, "Direct");
+    });
+    connect(buffer, &StreamBuffer::failed, this, [this, buffer](const QString& error) {
+        if (buffer == m_streamBuffer.get()) {
+            m_lastError = error;
+            emit errorOccurred(m_lastError);
+        }
+    });
+    m_sourcePending = true;
+    buffer->start();
+}
+
+void QtMediaEngine::openDirect(const QUrl& url, const QString& mode)
+{
+    m_streamingStatistics.start(mode);
+    m_player->setSource(url);
+    finishPendingLoad();
+}
 
-    // Ensure audio is not muted
-    m_audioOutput->setMuted(false);
+void QtMediaEngine::releaseStream()
+{
+    m_stallRecoveryTimer.stop();
+    m_sourcePending = false;
+    m_resumePosition = -1;
+    m_streamingStatistics.reset();
 
-    qDebug() << "Audio output initialized with device:" << defaultDevice.description();
-    qDebug() << "Media volume set to:" << mediaVolume << "(95%)";
-    qDebug() << "Final audio output volume:" << m_audioOutput->volume();
-    qDebug() << "Audio output muted:" << m_audioOutput->isMuted();
+    if (m_abrController) {
+        m_abrController->disconnect(this);
+        m_abrController.reset();
+    }
 
-    // List available audio devices for debugging
-    auto audioDevices = QMediaDevices::audioOutputs();
-    qDebug() << "Available audio output devices:";
-    for (const auto& device : audioDevices) {
-        qDebug() << "  -" << device.description() << (device.isDefault() ? "(default)" : "");
+    if (m_streamBuffer) {
+        // Wake a demuxer blocked in read() before the player tears it down
+        m_streamBuffer->close();
+        m_player->setSource(QUrl());
+        m_streamBuffer.reset();
     }
 }
 
-float QtMediaEngine::getSystemVolumeLevel() const
+void QtMediaEngine::finishPendingLoad()
 {
-    // Try to get system volume from PulseAudio (common on Linux)
-    QProcess process;
-    process.start("pactl", QStringList() << "get-sink-volume" << "@DEFAULT_SINK@");
-    process.waitForFinished(1000);
+    m_sourcePending = false;
+    if (m_playWhenReady) {
+        m_playWhenReady = false;
+        play();
+    }
+}
 
-    if (process.exitCode() == 0) {
-        QString output = process.readAllStandardOutput();
-        QRegularExpression re(R"((\d+)%)");
-        QRegularExpressionMatch match = re.match(output);
+bool QtMediaEngine::hardwareDecodingActive() const
+{
+    return HardwareDecoding::isEnabled();
+}
 
-        if (match.hasMatch()) {
-            int volumePercent = match.captured(1).toInt();
-            float volume = volumePercent / 100.0f;
-            qDebug() << "System volume detected:" << volumePercent << "% (" << volume << ")";
-            return qBound(0.0f, volume, 1.0f);
-        }
+void QtMediaEngine::setStreamingOptions(const StreamingOptions& options)
+{
+    m_streamingOptions = options;
+}
+
+StreamingStats QtMediaEngine::streamingStats() const
+{
+    StreamingStats stats = m_streamingStatistics.stats();
+
+    if (m_streamBuffer) {
+        const StreamBuffer::Stats buffer = m_streamBuffer->stats();
+        stats.bytesReceived = buffer.bytesReceived;
+        stats.bufferedAheadBytes = buffer.bufferedAheadBytes;
+        stats.throughputKbps = buffer.throughputKbps;
+        stats.reconnects = buffer.reconnects;
+    }
+
+    if (m_abrController) {
+        const auto& variants = m_abrController->variants();
+        const int current = m_abrController->currentVariant();
+        stats.variantCount = static_cast<int>(variants.size());
+        stats.variantIndex = current;
+        stats.variantBandwidth = (current >= 0 && current < variants.size()) ? variants.at(current).bandwidth : 0;
+        stats.variantSwitches = m_abrController->switchCount();
+        stats.throughputKbps = m_abrController->throughputKbps();
     }
 
-    // Fallback: try ALSA mixer
-    process.start("amixer", QStringList() << "get" << "Master");
-    process.waitForFinished(1000);
+    return stats;
+}
+
+void QtMediaEngine::initializeAudioOutput()
+{
+    // Media players should be loud and user can adjust if needed
+    m_audioOutput->setVolume(DEFAULT_MEDIA_VOLUME);
+    m_audioOutput->setMuted(false);
+
+    // QAudioOutput already starts on the system default device. Binding it
+    // explicitly needs device enumeration, which must not hold up construction
+    connect(AudioDeviceCache::instance(), &AudioDeviceCache::defaultOutputChanged,
+            this, &QtMediaEngine::applyDefaultAudioDevice);
+    QMetaObject::invokeMethod(this, &QtMediaEngine::applyDefaultAudioDevice, Qt::QueuedConnection);
+}
+
+void QtMediaEngine::applyDefaultAudioDevice()
+{
+    DARKPLAY_TRACE_SCOPE("audio", "applyDefaultAudioDevice");
+
+    const QAudioDevice device = AudioDeviceCache::instance()->defaultOutput();
+    if (device.isNull()) {
+        qWarning() << "No default audio output device found";
+        return;
+    }
 
-    if (process.exitCode() == 0) {
-        QString output = process.readAllStandardOutput();
-        QRegularExpression re(R"(\[(\d+)%\])");
-        QRegularExpressionMatch match = re.match(output);
+    if (m_audioOutput->device() != device) {
+        m_audioOutput->setDevice(device);
+        qDebug() << "Audio output device:" << device.description();
 
-        if (match.hasMatch()) {
-            int volumePercent = match.captured(1).toInt();
-            float volume = volumePercent / 100.0f;
-            qDebug() << "ALSA system volume detected:" << volumePercent << "% (" << volume << ")";
-            return qBound(0.0f, volume, 1.0f);
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+        // The pipeline's sink is bound to the old device - reopen it
+        if (m_audioPipeline) {
+            disableAudioPipeline();
+            setAudioEffects(m_audioEffects);
         }
+#endif
+    }
+}
+
+bool QtMediaEngine::enableAudioPipeline()
+{
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    QAudioDevice device = m_audioOutput->device();
+    if (device.isNull()) {
+        device = AudioDeviceCache::instance()->defaultOutput();
+    }
+
+    auto pipeline = std::make_unique<AudioPipeline>();
+    connect(pipeline.get(), &AudioPipeline::errorOccurred, this, [](const QString& error) {
+        qWarning() << "Audio pipeline:" << error;
+    });
+    pipeline->setVolume(m_audioOutput->volume());
+    pipeline->setMuted(m_audioOutput->isMuted());
+    pipeline->setPaused(m_player->playbackState() != QMediaPlayer::PlayingState);
+    pipeline->setPlaybackRate(m_player->playbackRate());
+    pipeline->setClock(&m_clock);
+
+    if (!pipeline->start(device)) {
+        qWarning() << "Audio effects and pitch-kept speed disabled: could not start the DSP pipeline";
+        return false;
+    }
+
+    m_player->setAudioOutput(nullptr);
+    m_player->setAudioBufferOutput(pipeline->bufferOutput());
+    m_audioPipeline = std::move(pipeline);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool QtMediaEngine::audioPipelineWanted() const
+{
+    return !m_audioEffects.isEmpty() || m_timeStretch;
+}
+
+void QtMediaEngine::disableAudioPipeline()
+{
+#ifdef DARKPLAY_HAS_AUDIO_PIPELINE
+    if (!m_audioPipeline) {
+        return;
     }
 
-    qDebug() << "Could not detect system volume, using default";
-    return -1.0f; // Signal that system volume is unavailable
+    m_player->setAudioBufferOutput(nullptr);
+    m_player->setAudioOutput(m_audioOutput.get());
+    m_audioPipeline.reset();
+#endif
 }
+
 } // namespace DarkPlay::Media
 
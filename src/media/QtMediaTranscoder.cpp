@@ -0,0 +1,407 @@
+#include "media/QtMediaTranscoder.h"
+#include <QAudioBufferInput>
+#include <QAudioBufferOutput>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMediaCaptureSession>
+#include <QVideoFrameInput>
+#include <QVideoSink>
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr qreal MIN_SPEED = 0.25;
+constexpr qreal MAX_SPEED = 8.0;
+
+bool isAudioOnly(QMediaFormat::FileFormat format)
+{
+    switch (format) {
+    case QMediaFormat::WMA:
+    case QMediaFormat::AAC:
+    case QMediaFormat::MP3:
+    case QMediaFormat::Wave:
+    case QMediaFormat::Mpeg4Audio:
+    case QMediaFormat::FLAC:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+QtMediaTranscoder::QtMediaTranscoder(QObject* parent)
+    : IMediaTranscoder(parent)
+    , m_startUs(0)
+    , m_endUs(0)
+    , m_player(nullptr)
+    , m_videoSink(nullptr)
+    , m_audioOutput(nullptr)
+    , m_session(nullptr)
+    , m_recorder(nullptr)
+    , m_videoInput(nullptr)
+    , m_audioInput(nullptr)
+    , m_progressTimer(nullptr)
+    , m_stalled(false)
+    , m_recording(false)
+    , m_ending(false)
+    , m_finished(false)
+    , m_frames(0)
+    , m_droppedFrames(0)
+    , m_processedUs(0)
+    , m_lastProcessedUs(0)
+    , m_idleTicks(0)
+{
+}
+
+QtMediaTranscoder::~QtMediaTranscoder()
+{
+    // Torn down mid-job, e.g. at exit: close the file before removing what was written
+    if (m_recording && !m_finished) {
+        m_player->stop();
+        delete m_recorder;
+        m_recorder = nullptr;
+        QFile::remove(m_job.outputPath);
+    }
+}
+
+QMediaFormat::FileFormat QtMediaTranscoder::fileFormat(const QString& format)
+{
+    const QString name = format.toLower();
+    if (name == "mp4" || name == "m4v") return QMediaFormat::MPEG4;
+    if (name == "mkv") return QMediaFormat::Matroska;
+    if (name == "webm") return QMediaFormat::WebM;
+    if (name == "mov") return QMediaFormat::QuickTime;
+    if (name == "avi") return QMediaFormat::AVI;
+    if (name == "wmv") return QMediaFormat::WMV;
+    if (name == "ogg" || name == "ogv" || name == "oga") return QMediaFormat::Ogg;
+    if (name == "mp3") return QMediaFormat::MP3;
+    if (name == "m4a") return QMediaFormat::Mpeg4Audio;
+    if (name == "aac") return QMediaFormat::AAC;
+    if (name == "flac") return QMediaFormat::FLAC;
+    if (name == "wav") return QMediaFormat::Wave;
+    if (name == "wma") return QMediaFormat::WMA;
+    return QMediaFormat::UnspecifiedFormat;
+}
+
+void QtMediaTranscoder::start(const ExportJob& job)
+{
+    m_job = job;
+    m_startUs = std::max<qint64>(0, job.startMs) * 1000;
+
+    m_player = new QMediaPlayer(this);
+    m_videoSink = new QVideoSink(this);
+    m_audioOutput = new QAudioBufferOutput(this);
+    m_player->setVideoSink(m_videoSink);
+    m_player->setAudioBufferOutput(m_audioOutput);
+
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &QtMediaTranscoder::onMediaStatusChanged);
+    connect(m_player, &QMediaPlayer::errorOccurred, this, [this]() { fail(m_player->errorString()); });
+    connect(m_videoSink, &QVideoSink::videoFrameChanged, this, &QtMediaTranscoder::onVideoFrame);
+    connect(m_audioOutput, &QAudioBufferOutput::audioBufferReceived, this, &QtMediaTranscoder::onAudioBuffer);
+
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(PROGRESS_INTERVAL_MS);
+    connect(m_progressTimer, &QTimer::timeout, this, &QtMediaTranscoder::reportProgress);
+
+    QTimer::singleShot(LOAD_TIMEOUT_MS, this, [this]() {
+        if (!m_recording && !m_finished) {
+            fail("Timed out opening the source");
+        }
+    });
+
+    m_elapsed.start();
+    m_player->setSource(job.source);
+}
+
+void QtMediaTranscoder::cancel()
+{
+    fail("Cancelled");
+}
+
+void QtMediaTranscoder::onMediaStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    if (m_finished) {
+        return;
+    }
+    if (status == QMediaPlayer::InvalidMedia) {
+        fail(m_player->errorString().isEmpty() ? QString("Cannot open the source") : m_player->errorString());
+    } else if (status == QMediaPlayer::LoadedMedia && !m_recording && m_error.isEmpty()) {
+        beginRecording();
+    } else if (status == QMediaPlayer::EndOfMedia && m_recording) {
+        endOfRange();
+    }
+}
+
+void QtMediaTranscoder::beginRecording()
+{
+    const qint64 duration = m_player->duration();
+    qint64 endMs = m_job.endMs;
+    if (endMs < 0 || (duration > 0 && endMs > duration)) {
+        endMs = duration;
+    }
+    if (endMs <= 0) {
+        fail("The source has no known length; give an end time");
+        return;
+    }
+    if (endMs * 1000 <= m_startUs) {
+        fail("The range is empty");
+        return;
+    }
+    m_endUs = endMs * 1000;
+
+    const QMediaFormat::FileFormat container = fileFormat(m_job.format);
+    if (container == QMediaFormat::UnspecifiedFormat) {
+        fail(QString("Unsupported output format \"%1\"").arg(m_job.format));
+        return;
+    }
+    const bool encodeVideo = m_player->hasVideo() && !isAudioOnly(container);
+    const bool encodeAudio = m_player->hasAudio();
+    if (!encodeVideo && !encodeAudio) {
+        fail(QString("Nothing in the source can go into \"%1\"").arg(m_job.format));
+        return;
+    }
+
+    m_session = new QMediaCaptureSession(this);
+    m_recorder = new QMediaRecorder(this);
+    m_session->setRecorder(m_recorder);
+    if (encodeVideo) {
+        m_videoInput = new QVideoFrameInput(this);
+        m_session->setVideoFrameInput(m_videoInput);
+        connect(m_videoInput, &QVideoFrameInput::readyToSendVideoFrame, this, &QtMediaTranscoder::drainPending);
+    } else {
+        // Not decoded at all when it cannot be kept
+        m_player->setVideoSink(nullptr);
+    }
+    if (encodeAudio) {
+        m_audioInput = new QAudioBufferInput(this);
+        m_session->setAudioBufferInput(m_audioInput);
+        connect(m_audioInput, &QAudioBufferInput::readyToSendAudioBuffer, this, &QtMediaTranscoder::drainPending);
+    } else {
+        m_player->setAudioBufferOutput(nullptr);
+    }
+
+    // Codecs are left to the recorder, which resolves the container's defaults
+    m_recorder->setMediaFormat(QMediaFormat(container));
+    m_recorder->setQuality(QMediaRecorder::HighQuality);
+    m_recorder->setOutputLocation(QUrl::fromLocalFile(m_job.outputPath));
+    connect(m_recorder, &QMediaRecorder::recorderStateChanged, this, &QtMediaTranscoder::onRecorderStateChanged);
+    connect(m_recorder, &QMediaRecorder::errorOccurred, this,
+            [this](QMediaRecorder::Error, const QString& errorString) { fail(errorString); });
+
+    // Overwritten, like any export target
+    QFile::remove(m_job.outputPath);
+    m_recording = true;
+    m_recorder->record();
+
+    // Audio plays at 1x so it is never time-stretched; video alone decodes as fast as asked
+    const qreal rate = encodeAudio ? 1.0 : std::clamp(m_job.speed, MIN_SPEED, MAX_SPEED);
+    m_player->setPlaybackRate(rate);
+    m_player->setPosition(m_startUs / 1000);
+    m_player->play();
+
+    m_elapsed.restart();
+    m_progressTimer->start();
+    qDebug() << "QtMediaTranscoder: Exporting" << m_job.source.toString() << "to" << m_job.outputPath
+             << "from" << m_startUs / 1000 << "to" << endMs << "ms at" << rate << "x";
+}
+
+void QtMediaTranscoder::onVideoFrame(const QVideoFrame& frame)
+{
+    if (!m_recording || m_ending || !m_videoInput || !frame.isValid()) {
+        return;
+    }
+
+    // The seek lands on the keyframe before the cut; those frames are not part of the clip
+    const qint64 startTime = frame.startTime();
+    if (startTime >= 0 && startTime < m_startUs) {
+        return;
+    }
+    if (startTime >= m_endUs) {
+        endOfRange();
+        return;
+    }
+
+    QVideoFrame output(frame);
+    if (startTime >= 0) {
+        output.setStartTime(startTime - m_startUs);
+        m_processedUs = std::max(m_processedUs, startTime - m_startUs);
+    }
+    if (frame.endTime() >= 0) {
+        output.setEndTime(frame.endTime() - m_startUs);
+    }
+    ++m_frames;
+
+    if (!m_pendingFrames.isEmpty() || !m_videoInput->sendVideoFrame(output)) {
+        if (m_pendingFrames.size() < MAX_PENDING) {
+            m_pendingFrames.append(output);
+        } else {
+            ++m_droppedFrames;
+        }
+        stall();
+    }
+}
+
+void QtMediaTranscoder::onAudioBuffer(const QAudioBuffer& buffer)
+{
+    if (!m_recording || m_ending || !m_audioInput || !buffer.isValid()) {
+        return;
+    }
+
+    const qint64 startTime = buffer.startTime();
+    if (startTime >= 0 && startTime + buffer.duration() <= m_startUs) {
+        return;
+    }
+    if (startTime >= m_endUs) {
+        endOfRange();
+        return;
+    }
+
+    const qint64 outputStart = startTime >= 0 ? std::max<qint64>(0, startTime - m_startUs) : -1;
+    const QAudioBuffer output(QByteArray(buffer.constData<char>(), buffer.byteCount()), buffer.format(), outputStart);
+    if (startTime >= 0) {
+        m_processedUs = std::max(m_processedUs, startTime + buffer.duration() - m_startUs);
+    }
+
+    if (!m_pendingAudio.isEmpty() || !m_audioInput->sendAudioBuffer(output)) {
+        if (m_pendingAudio.size() < MAX_PENDING) {
+            m_pendingAudio.append(output);
+        } else {
+            ++m_droppedFrames;
+        }
+        stall();
+    }
+}
+
+void QtMediaTranscoder::stall()
+{
+    if (!m_stalled && !m_ending) {
+        m_stalled = true;
+        m_player->pause();
+    }
+}
+
+void QtMediaTranscoder::drainPending()
+{
+    if (m_finished || !m_recorder) {
+        return;
+    }
+
+    while (!m_pendingFrames.isEmpty() && m_videoInput->sendVideoFrame(m_pendingFrames.first())) {
+        m_pendingFrames.removeFirst();
+    }
+    while (!m_pendingAudio.isEmpty() && m_audioInput->sendAudioBuffer(m_pendingAudio.first())) {
+        m_pendingAudio.removeFirst();
+    }
+    if (!m_pendingFrames.isEmpty() || !m_pendingAudio.isEmpty()) {
+        return; // The inputs signal again once they have room
+    }
+
+    if (m_ending) {
+        if (m_recorder->recorderState() != QMediaRecorder::StoppedState) {
+            m_recorder->stop();
+        }
+    } else if (m_stalled) {
+        m_stalled = false;
+        m_player->play();
+    }
+}
+
+void QtMediaTranscoder::endOfRange()
+{
+    if (m_ending) {
+        return;
+    }
+    m_ending = true;
+    m_player->pause();
+    // Whatever is still held back goes in first; the recorder stops after it
+    drainPending();
+}
+
+void QtMediaTranscoder::onRecorderStateChanged(QMediaRecorder::RecorderState state)
+{
+    if (state == QMediaRecorder::StoppedState && m_recording) {
+        finish(m_error.isEmpty(), m_error);
+    }
+}
+
+void QtMediaTranscoder::fail(const QString& error)
+{
+    if (m_finished || !m_error.isEmpty()) {
+        return;
+    }
+    m_error = error;
+    qWarning() << "QtMediaTranscoder:" << m_job.source.toString() << "-" << error;
+
+    m_ending = true;
+    m_pendingFrames.clear();
+    m_pendingAudio.clear();
+    if (m_player) {
+        m_player->stop();
+    }
+
+    // A running recorder finishes the file first; finish() follows its StoppedState
+    if (m_recorder && m_recorder->recorderState() != QMediaRecorder::StoppedState) {
+        m_recorder->stop();
+    } else {
+        finish(false, error);
+    }
+}
+
+void QtMediaTranscoder::finish(bool ok, const QString& error)
+{
+    if (m_finished) {
+        return;
+    }
+
+    if (m_player) {
+        reportProgress();
+        m_progressTimer->stop();
+        m_player->stop();
+    }
+    m_finished = true;
+
+    if (!ok) {
+        QFile::remove(m_job.outputPath);
+    } else {
+        qDebug() << "QtMediaTranscoder: Wrote" << m_job.outputPath << "-" << m_frames << "frames in"
+                 << m_elapsed.elapsed() << "ms" << (m_droppedFrames > 0 ? QString("(%1 dropped)").arg(m_droppedFrames) : QString());
+    }
+    emit finished(ok, error);
+}
+
+void QtMediaTranscoder::reportProgress()
+{
+    if (m_finished) {
+        return;
+    }
+
+    ExportProgress progress;
+    progress.processedMs = m_processedUs / 1000;
+    progress.totalMs = m_endUs > 0 ? (m_endUs - m_startUs) / 1000 : 0;
+    progress.frames = m_frames;
+    const qint64 elapsedMs = m_elapsed.elapsed();
+    if (elapsedMs > 0) {
+        progress.fps = m_frames * 1000.0 / elapsedMs;
+        progress.realtimeFactor = static_cast<double>(progress.processedMs) / elapsedMs;
+    }
+    const QFileInfo output(m_job.outputPath);
+    progress.bytesWritten = output.exists() ? output.size() : 0;
+
+    // A source that stops delivering (a dead network stream) would otherwise hang the queue
+    if (m_recording && !m_ending) {
+        m_idleTicks = m_processedUs == m_lastProcessedUs ? m_idleTicks + 1 : 0;
+        m_lastProcessedUs = m_processedUs;
+        if (m_idleTicks >= STALL_TICKS) {
+            emit progressChanged(progress);
+            fail(QString("No progress for %1 seconds").arg(STALL_TICKS * PROGRESS_INTERVAL_MS / 1000));
+            return;
+        }
+    }
+    emit progressChanged(progress);
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,757 @@
+#include "media/StreamBuffer.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr int TICK_INTERVAL_MS = 250;
+constexpr int MAX_RETRIES = 5;
+constexpr int MAX_RETRY_DELAY_MS = 10000;
+constexpr qint64 REPLY_READ_BUFFER = 1024 * 1024;     // Back-pressure once this much is unread
+constexpr qint64 SEEK_SLACK_BYTES = 2 * 1024 * 1024;  // Closer than this, let the open reply catch up
+constexpr double THROUGHPUT_SMOOTHING = 0.2;
+constexpr qint64 LOW_MEMORY_READ_AHEAD_BYTES = 4 * 1024 * 1024;
+constexpr qint64 LOW_MEMORY_BEHIND_RAM_BYTES = 1024 * 1024;
+
+// Low-memory mode caps the window the demuxer is fed from, whatever the settings say
+StreamingOptions effectiveOptions(const StreamingOptions& options)
+{
+    StreamingOptions effective = options;
+    if (Utils::MemoryBudget::isLowMemoryMode()) {
+        effective.readAheadBytes = std::min(effective.readAheadBytes, LOW_MEMORY_READ_AHEAD_BYTES);
+    }
+    return effective;
+}
+
+// "bytes 0-1023/4096" -> 4096; -1 when absent or "*"
+qint64 totalFromContentRange(const QByteArray& contentRange)
+{
+    const qsizetype slash = contentRange.lastIndexOf('/');
+    if (slash < 0) {
+        return -1;
+    }
+    bool ok = false;
+    const qint64 total = contentRange.mid(slash + 1).trimmed().toLongLong(&ok);
+    return ok ? total : -1;
+}
+
+} // namespace
+
+/**
+ * @brief Network side of StreamBuffer, living on its fetch thread
+ */
+class StreamFetcher : public QObject
+{
+public:
+    explicit StreamFetcher(StreamBuffer* buffer)
+        : m_buffer(buffer)
+        , m_network(nullptr)
+        , m_reply(nullptr)
+        , m_tick(nullptr)
+        , m_replyOffset(0)
+        , m_tickBytes(0)
+        , m_retries(0)
+        , m_probing(true)
+        , m_paused(false)
+        , m_retryPending(false)
+    {
+    }
+
+    void start()
+    {
+        m_network = new QNetworkAccessManager(this);
+        m_tick = new QTimer(this);
+        m_tick->setInterval(TICK_INTERVAL_MS);
+        connect(m_tick, &QTimer::timeout, this, [this]() { onTick(); });
+        m_tick->start();
+        m_tickClock.start();
+
+        request(0);
+    }
+
+    // Decides what, if anything, to download next
+    void schedule()
+    {
+        m_buffer->m_schedulePending = false;
+        if (m_probing || m_retryPending) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_buffer->m_mutex);
+        if (m_buffer->m_closed || m_buffer->m_failed) {
+            lock.unlock();
+            abortReply();
+            return;
+        }
+
+        const qint64 readPosition = m_buffer->m_readPosition;
+        const qint64 total = m_buffer->m_total;
+        const qint64 target = m_buffer->firstMissingFromLocked(readPosition);
+        const bool windowFull = target >= total || target - readPosition >= m_buffer->m_options.readAheadBytes;
+        m_buffer->m_fetcherPaused = windowFull;
+        lock.unlock();
+
+        if (target >= total) {
+            abortReply(); // Everything up to the end is buffered
+            return;
+        }
+
+        // The open reply is at or just short of the target - keep using it
+        if (m_reply && target >= m_replyOffset && target - m_replyOffset <= SEEK_SLACK_BYTES) {
+            if (m_paused && !windowFull) {
+                m_lastData.start(); // Silence while paused was our own doing
+            }
+            m_paused = windowFull;
+            if (!m_paused) {
+                drain();
+            }
+            return;
+        }
+
+        if (windowFull) {
+            abortReply();
+            return;
+        }
+        request(target);
+    }
+
+private:
+    void request(qint64 offset)
+    {
+        abortReply();
+
+        QNetworkRequest networkRequest(m_buffer->m_url);
+        networkRequest.setRawHeader("Range", QByteArray("bytes=") + QByteArray::number(offset) + '-');
+        networkRequest.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                                    QNetworkRequest::NoLessSafeRedirectPolicy);
+
+        m_reply = m_network->get(networkRequest);
+        m_reply->setReadBufferSize(REPLY_READ_BUFFER);
+        m_replyOffset = offset;
+        m_paused = false;
+        m_lastData.start();
+
+        QNetworkReply* reply = m_reply;
+        connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply]() { onMetaData(reply); });
+        connect(reply, &QNetworkReply::readyRead, this, [this, reply]() {
+            if (reply == m_reply) {
+                drain();
+            }
+        });
+        connect(reply, &QNetworkReply::finished, this, [this, reply]() { onFinished(reply); });
+    }
+
+    void abortReply()
+    {
+        if (!m_reply) {
+            return;
+        }
+        QNetworkReply* reply = std::exchange(m_reply, nullptr);
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+
+    void onMetaData(QNetworkReply* reply)
+    {
+        if (reply != m_reply) {
+            return;
+        }
+
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (m_probing) {
+            qint64 total = -1;
+            if (status == 206) {
+                total = totalFromContentRange(reply->rawHeader("Content-Range"));
+            } else if (status == 200 && reply->rawHeader("Accept-Ranges").contains("bytes")) {
+                total = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+            }
+
+            if (total <= 0) {
+                abortReply();
+                m_probing = false;
+                postToBuffer([](StreamBuffer* buffer) {
+                    emit buffer->fallbackRequired("Server does not support range requests");
+                });
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+                m_buffer->m_total = total;
+            }
+            m_probing = false;
+            postToBuffer([](StreamBuffer* buffer) { emit buffer->ready(); });
+            return;
+        }
+
+        // A resumed request must answer with the range we asked for
+        if (status != 206 && !(status == 200 && m_replyOffset == 0)) {
+            qWarning() << "StreamBuffer: Server ignored range request, status" << status;
+            abortReply();
+            fail(QString("Unexpected HTTP status %1 on a range request").arg(status));
+        }
+    }
+
+    void drain()
+    {
+        while (m_reply && !m_paused && m_reply->bytesAvailable() > 0) {
+            const QByteArray chunk = m_reply->read(std::min(m_reply->bytesAvailable(), StreamBuffer::BLOCK_SIZE));
+            if (chunk.isEmpty()) {
+                break;
+            }
+
+            bool ranIntoBufferedData = false;
+            {
+                std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+                m_buffer->storeLocked(m_replyOffset, chunk.constData(), chunk.size());
+                m_replyOffset += chunk.size();
+                m_buffer->m_stats.bytesReceived += chunk.size();
+                m_buffer->evictLocked();
+
+                const qint64 readPosition = m_buffer->m_readPosition;
+                const qint64 target = m_buffer->firstMissingFromLocked(readPosition);
+                m_paused = target >= m_buffer->m_total
+                    || target - readPosition >= m_buffer->m_options.readAheadBytes;
+                m_buffer->m_fetcherPaused = m_paused;
+                ranIntoBufferedData = m_buffer->firstMissingFromLocked(m_replyOffset) != m_replyOffset;
+            }
+            m_buffer->m_dataArrived.notify_all();
+
+            m_tickBytes += chunk.size();
+            m_lastData.start();
+            m_retries = 0;
+
+            if (ranIntoBufferedData) {
+                schedule(); // Skip over what is already here
+                return;
+            }
+        }
+    }
+
+    void onFinished(QNetworkReply* reply)
+    {
+        if (reply != m_reply) {
+            return;
+        }
+
+        if (reply->error() == QNetworkReply::NoError) {
+            m_paused = false;
+            drain();
+            if (m_reply == reply) {
+                m_reply = nullptr;
+                reply->deleteLater();
+            }
+            schedule();
+            return;
+        }
+
+        const QString error = reply->errorString();
+        m_reply = nullptr;
+        reply->deleteLater();
+
+        if (++m_retries > MAX_RETRIES) {
+            fail(error);
+            return;
+        }
+
+        // Congested links drop connections; back off and resume where we stopped
+        const int delayMs = std::min(MAX_RETRY_DELAY_MS, 500 << m_retries);
+        qDebug() << "StreamBuffer: Request failed (" << error << "), retrying in" << delayMs << "ms";
+        m_retryPending = true;
+        QTimer::singleShot(delayMs, this, [this]() {
+            m_retryPending = false;
+            if (m_probing) {
+                request(0);
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+                ++m_buffer->m_stats.reconnects;
+            }
+            schedule();
+        });
+    }
+
+    void onTick()
+    {
+        const qint64 elapsedMs = m_tickClock.restart();
+        if (m_reply && !m_paused && elapsedMs > 0) {
+            const double kbps = static_cast<double>(m_tickBytes) * 8.0 / static_cast<double>(elapsedMs);
+            std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+            double& throughput = m_buffer->m_stats.throughputKbps;
+            throughput = throughput > 0.0 ? throughput + THROUGHPUT_SMOOTHING * (kbps - throughput) : kbps;
+        }
+        m_tickBytes = 0;
+
+        // A connection that stopped delivering while we wanted data is re-established
+        if (m_reply && !m_paused && !m_probing && m_lastData.elapsed() > m_buffer->m_options.stallRecoveryMs) {
+            qDebug() << "StreamBuffer: No data for" << m_lastData.elapsed() << "ms, reconnecting";
+            {
+                std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+                ++m_buffer->m_stats.reconnects;
+            }
+            request(m_replyOffset);
+        }
+
+        schedule();
+    }
+
+    void fail(const QString& error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_buffer->m_mutex);
+            m_buffer->m_failed = true;
+        }
+        m_buffer->m_dataArrived.notify_all();
+        m_probing = false;
+        postToBuffer([error](StreamBuffer* buffer) { emit buffer->failed(error); });
+    }
+
+    template<typename Func>
+    void postToBuffer(Func&& func)
+    {
+        StreamBuffer* buffer = m_buffer;
+        QMetaObject::invokeMethod(buffer, [buffer, func = std::forward<Func>(func)]() { func(buffer); },
+                                  Qt::QueuedConnection);
+    }
+
+    StreamBuffer* m_buffer; // Outlives the fetch thread
+    QNetworkAccessManager* m_network;
+    QNetworkReply* m_reply;
+    QTimer* m_tick;
+    QElapsedTimer m_tickClock;
+    QElapsedTimer m_lastData;
+    qint64 m_replyOffset; // Stream offset of the next byte the reply delivers
+    qint64 m_tickBytes;
+    int m_retries;
+    bool m_probing;
+    bool m_paused;        // Window is full; unread data applies back-pressure
+    bool m_retryPending;
+};
+
+StreamBuffer::StreamBuffer(const QUrl& url, const StreamingOptions& options, QObject* parent)
+    : QIODevice(parent)
+    , m_url(url)
+    , m_options(effectiveOptions(options))
+    , m_behindRamBytes(Utils::MemoryBudget::isLowMemoryMode() ? LOW_MEMORY_BEHIND_RAM_BYTES : BEHIND_RAM_BYTES)
+    , m_total(-1)
+    , m_readPosition(0)
+    , m_ramBytes(0)
+    , m_closed(false)
+    , m_failed(false)
+    , m_fetcherPaused(false)
+    , m_nextDiskSlot(0)
+    , m_spillUnavailable(false)
+    , m_schedulePending(false)
+    , m_fetcher(nullptr)
+{
+    m_fetchThread.setObjectName("Stream fetcher");
+
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->registerConsumer("Read-ahead", this);
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->unregisterConsumer(this);
+    }
+    close();
+    m_fetchThread.quit();
+    m_fetchThread.wait();
+}
+
+void StreamBuffer::start()
+{
+    if (m_fetcher) {
+        return;
+    }
+
+    // Unbuffered: pos() is exactly what readData() is asked for
+    QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+    m_fetcher = new StreamFetcher(this);
+    m_fetcher->moveToThread(&m_fetchThread);
+    StreamFetcher* fetcher = m_fetcher;
+    connect(&m_fetchThread, &QThread::started, fetcher, [fetcher]() { fetcher->start(); });
+    connect(&m_fetchThread, &QThread::finished, fetcher, &QObject::deleteLater);
+    m_fetchThread.start();
+}
+
+StreamBuffer::Stats StreamBuffer::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.bufferedAheadBytes = contiguousFromLocked(m_readPosition);
+    return stats;
+}
+
+qint64 StreamBuffer::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::max<qint64>(m_total, 0);
+}
+
+qint64 StreamBuffer::bytesAvailable() const
+{
+    const qint64 position = pos();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return contiguousFromLocked(position) + QIODevice::bytesAvailable();
+}
+
+bool StreamBuffer::atEnd() const
+{
+    const qint64 position = pos();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed || (m_total >= 0 && position >= m_total);
+}
+
+bool StreamBuffer::seek(qint64 position)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (position < 0 || (m_total >= 0 && position > m_total)) {
+            return false;
+        }
+        m_readPosition = position;
+        requestScheduleLocked(); // Start fetching before the first read arrives
+    }
+    return QIODevice::seek(position);
+}
+
+void StreamBuffer::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_dataArrived.notify_all();
+
+    if (isOpen()) {
+        QIODevice::close();
+    }
+}
+
+qint64 StreamBuffer::readData(char* data, qint64 maxSize)
+{
+    const qint64 position = pos();
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_total >= 0 && position >= m_total) {
+        return 0;
+    }
+    m_readPosition = position;
+
+    QElapsedTimer waited;
+    while (!m_closed && !m_failed && contiguousFromLocked(position) == 0) {
+        if (!waited.isValid()) {
+            waited.start();
+            ++m_stats.readStalls;
+            requestScheduleLocked();
+        }
+        if (waited.elapsed() > READ_GIVE_UP_MS) {
+            qWarning() << "StreamBuffer: Gave up waiting for data at offset" << position;
+            return -1;
+        }
+        m_dataArrived.wait_for(lock, std::chrono::milliseconds(WAIT_SLICE_MS));
+    }
+
+    if (waited.isValid()) {
+        m_stats.readStallMs += waited.elapsed();
+    }
+    if (m_closed || m_failed) {
+        return -1;
+    }
+
+    const qint64 copied = copyLocked(position, data, maxSize);
+    m_readPosition = position + copied;
+
+    // Consuming data may have opened the window again
+    if (m_fetcherPaused) {
+        requestScheduleLocked();
+    }
+    return copied;
+}
+
+qint64 StreamBuffer::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return -1;
+}
+
+void StreamBuffer::storeLocked(qint64 offset, const char* data, qint64 length)
+{
+    const qint64 nowMs = Utils::MemoryBudget::nowMs();
+    while (length > 0) {
+        const qint64 index = offset / BLOCK_SIZE;
+        const qint64 inBlock = offset % BLOCK_SIZE;
+        const qint64 toBlockEnd = BLOCK_SIZE - inBlock;
+        Block& block = m_blocks[index];
+
+        qint64 consumed = 0;
+        if (block.diskSlot >= 0 || inBlock > block.length) {
+            // Already complete on disk, or a gap we cannot fill from here
+            consumed = std::min(toBlockEnd, length);
+            if (block.diskSlot < 0 && block.length == 0) {
+                m_blocks.erase(index);
+            }
+        } else if (inBlock < block.length) {
+            consumed = std::min(block.length - inBlock, length); // Overlap with buffered bytes
+        } else {
+            consumed = std::min(toBlockEnd, length);
+            if (block.data.isEmpty()) {
+                block.data.reserve(BLOCK_SIZE);
+            }
+            block.data.append(data, consumed);
+            block.length += consumed;
+            m_ramBytes += consumed;
+            block.lastUsedMs = nowMs;
+        }
+
+        offset += consumed;
+        data += consumed;
+        length -= consumed;
+    }
+}
+
+qint64 StreamBuffer::contiguousFromLocked(qint64 offset) const
+{
+    qint64 available = 0;
+    qint64 position = offset;
+    while (m_total < 0 || position < m_total) {
+        const qint64 index = position / BLOCK_SIZE;
+        const auto it = m_blocks.find(index);
+        if (it == m_blocks.end()) {
+            break;
+        }
+        const qint64 inBlock = position % BLOCK_SIZE;
+        if (inBlock >= it->second.length) {
+            break;
+        }
+        available += it->second.length - inBlock;
+        position = index * BLOCK_SIZE + it->second.length;
+        if (!isBlockCompleteLocked(index, it->second)) {
+            break;
+        }
+    }
+    return available;
+}
+
+qint64 StreamBuffer::firstMissingFromLocked(qint64 offset) const
+{
+    qint64 position = offset;
+    while (m_total < 0 || position < m_total) {
+        const qint64 index = position / BLOCK_SIZE;
+        const auto it = m_blocks.find(index);
+        if (it == m_blocks.end()) {
+            return index * BLOCK_SIZE; // Blocks are always filled from their start
+        }
+        if (!isBlockCompleteLocked(index, it->second)) {
+            return index * BLOCK_SIZE + it->second.length;
+        }
+        position = (index + 1) * BLOCK_SIZE;
+    }
+    return m_total;
+}
+
+qint64 StreamBuffer::copyLocked(qint64 offset, char* data, qint64 maxSize)
+{
+    qint64 copied = 0;
+    while (copied < maxSize) {
+        const qint64 index = offset / BLOCK_SIZE;
+        const auto it = m_blocks.find(index);
+        if (it == m_blocks.end()) {
+            break;
+        }
+        Block& block = it->second;
+        const qint64 inBlock = offset % BLOCK_SIZE;
+        if (inBlock >= block.length) {
+            break;
+        }
+        block.lastUsedMs = Utils::MemoryBudget::nowMs();
+
+        const qint64 count = std::min(block.length - inBlock, maxSize - copied);
+        if (block.diskSlot >= 0) {
+            if (!m_spillFile->seek(block.diskSlot * BLOCK_SIZE + inBlock)
+                || m_spillFile->read(data + copied, count) != count) {
+                qWarning() << "StreamBuffer: Spill file read failed, dropping block" << index;
+                m_freeDiskSlots.push_back(block.diskSlot);
+                m_blocks.erase(it);
+                break;
+            }
+        } else {
+            std::memcpy(data + copied, block.data.constData() + inBlock, static_cast<size_t>(count));
+        }
+        copied += count;
+        offset += count;
+    }
+    return copied;
+}
+
+bool StreamBuffer::isBlockCompleteLocked(qint64 index, const Block& block) const
+{
+    return block.length == BLOCK_SIZE || (m_total >= 0 && index * BLOCK_SIZE + block.length >= m_total);
+}
+
+void StreamBuffer::evictLocked()
+{
+    const qint64 budget = m_options.readAheadBytes + m_behindRamBytes;
+    const qint64 readBlock = m_readPosition / BLOCK_SIZE;
+
+    while (m_ramBytes > budget) {
+        // Farthest from the read position goes first; data behind it counts double
+        auto victim = m_blocks.end();
+        qint64 victimScore = -1;
+        for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+            // The download frontier and the block being read stay put
+            if (it->second.diskSlot >= 0 || it->first == readBlock || !isBlockCompleteLocked(it->first, it->second)) {
+                continue;
+            }
+            const qint64 score = it->first < readBlock ? (readBlock - it->first) * 2 : it->first - readBlock;
+            if (score > victimScore) {
+                victimScore = score;
+                victim = it;
+            }
+        }
+        if (victim == m_blocks.end()) {
+            break;
+        }
+        releaseLocked(victim);
+    }
+}
+
+void StreamBuffer::releaseLocked(std::map<qint64, Block>::iterator victim)
+{
+    // Out of RAM: into the spill file if there is room, else gone
+    Block& block = victim->second;
+    m_ramBytes -= block.length;
+
+    const qint64 slot = m_options.diskCacheBytes > 0 ? acquireDiskSlotLocked() : -1;
+    if (slot >= 0 && m_spillFile->seek(slot * BLOCK_SIZE)
+        && m_spillFile->write(block.data.constData(), block.length) == block.length) {
+        block.data = QByteArray();
+        block.diskSlot = slot;
+    } else {
+        if (slot >= 0) {
+            m_freeDiskSlots.push_back(slot);
+        }
+        m_blocks.erase(victim);
+    }
+}
+
+bool StreamBuffer::isReleasableBehindLocked(qint64 index, const Block& block) const
+{
+    return block.diskSlot < 0 && index < m_readPosition / BLOCK_SIZE && isBlockCompleteLocked(index, block);
+}
+
+qint64 StreamBuffer::memoryBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ramBytes;
+}
+
+qint64 StreamBuffer::oldestUseMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    qint64 oldest = -1;
+    for (const auto& [index, block] : m_blocks) {
+        if (isReleasableBehindLocked(index, block) && (oldest < 0 || block.lastUsedMs < oldest)) {
+            oldest = block.lastUsedMs;
+        }
+    }
+    return oldest;
+}
+
+qint64 StreamBuffer::evict(qint64 bytes)
+{
+    // Only what has been read already; the window ahead is what playback is waiting for
+    std::lock_guard<std::mutex> lock(m_mutex);
+    qint64 freed = 0;
+    while (freed < bytes) {
+        auto victim = m_blocks.end();
+        for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+            if (isReleasableBehindLocked(it->first, it->second)
+                && (victim == m_blocks.end() || it->second.lastUsedMs < victim->second.lastUsedMs)) {
+                victim = it;
+            }
+        }
+        if (victim == m_blocks.end()) {
+            break;
+        }
+        freed += victim->second.length;
+        releaseLocked(victim);
+    }
+    return freed;
+}
+
+qint64 StreamBuffer::acquireDiskSlotLocked()
+{
+    if (m_spillUnavailable) {
+        return -1;
+    }
+    if (!m_spillFile) {
+        m_spillFile = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/darkplay-stream-XXXXXX");
+        if (!m_spillFile->open()) {
+            qWarning() << "StreamBuffer: Cannot create spill file, keeping RAM only";
+            m_spillFile.reset();
+            m_spillUnavailable = true;
+            return -1;
+        }
+    }
+
+    if (!m_freeDiskSlots.empty()) {
+        const qint64 slot = m_freeDiskSlots.back();
+        m_freeDiskSlots.pop_back();
+        return slot;
+    }
+    if ((m_nextDiskSlot + 1) * BLOCK_SIZE <= m_options.diskCacheBytes) {
+        return m_nextDiskSlot++;
+    }
+
+    // Disk budget is full - reuse the slot of the block farthest from the read position
+    const qint64 readBlock = m_readPosition / BLOCK_SIZE;
+    auto victim = m_blocks.end();
+    qint64 victimDistance = -1;
+    for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it) {
+        if (it->second.diskSlot < 0) {
+            continue;
+        }
+        const qint64 distance = std::abs(it->first - readBlock);
+        if (distance > victimDistance) {
+            victimDistance = distance;
+            victim = it;
+        }
+    }
+    if (victim == m_blocks.end()) {
+        return -1;
+    }
+
+    const qint64 slot = victim->second.diskSlot;
+    m_blocks.erase(victim);
+    return slot;
+}
+
+void StreamBuffer::requestScheduleLocked()
+{
+    if (!m_fetcher || m_schedulePending.exchange(true)) {
+        return;
+    }
+    StreamFetcher* fetcher = m_fetcher;
+    QMetaObject::invokeMethod(fetcher, [fetcher]() { fetcher->schedule(); }, Qt::QueuedConnection);
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,69 @@
+#include "media/StreamingStatistics.h"
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+void StreamingStatistics::start(const QString& mode)
+{
+    m_stats = StreamingStats{};
+    m_stats.active = true;
+    m_stats.mode = mode;
+    m_loadTimer.start();
+    m_stallTimer.invalidate();
+}
+
+void StreamingStatistics::reset()
+{
+    m_stats = StreamingStats{};
+    m_loadTimer.invalidate();
+    m_stallTimer.invalidate();
+}
+
+void StreamingStatistics::markBuffered()
+{
+    if (!m_stats.active) {
+        return;
+    }
+
+    if (!hasStarted()) {
+        m_stats.startupMs = m_loadTimer.elapsed();
+    }
+
+    if (m_stats.stalled) {
+        const qint64 stallMs = m_stallTimer.elapsed();
+        m_stats.rebufferMs += stallMs;
+        m_stats.longestStallMs = std::max(m_stats.longestStallMs, stallMs);
+        m_stats.stalled = false;
+        m_stallTimer.invalidate();
+    }
+}
+
+void StreamingStatistics::markStalled()
+{
+    // Before the first buffered state this is still startup
+    if (!m_stats.active || !hasStarted() || m_stats.stalled) {
+        return;
+    }
+
+    m_stats.stalled = true;
+    ++m_stats.stallCount;
+    m_stallTimer.start();
+}
+
+qint64 StreamingStatistics::currentStallMs() const
+{
+    return m_stats.stalled ? m_stallTimer.elapsed() : 0;
+}
+
+StreamingStats StreamingStatistics::stats() const
+{
+    StreamingStats stats = m_stats;
+    if (stats.stalled) {
+        const qint64 stallMs = m_stallTimer.elapsed();
+        stats.rebufferMs += stallMs;
+        stats.longestStallMs = std::max(stats.longestStallMs, stallMs);
+    }
+    return stats;
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,439 @@
+#include "media/SubtitleParser.h"
+#include <QFileInfo>
+#include <QIODevice>
+#include <QList>
+#include <QStringDecoder>
+#include <QVarLengthArray>
+#include <algorithm>
+
+namespace DarkPlay::Media::SubtitleParser {
+
+namespace {
+
+constexpr qint64 MAX_LINE_BYTES = 64 * 1024; // Longer lines are split rather than buffered whole
+constexpr int CANCEL_CHECK_LINES = 512;
+
+// ASS/SSA default event format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text
+constexpr int ASS_DEFAULT_FIELDS = 10;
+constexpr int ASS_DEFAULT_START_FIELD = 1;
+constexpr int ASS_DEFAULT_END_FIELD = 2;
+
+/**
+ * @brief Decoded lines without their line endings, UTF-8 until a line proves otherwise
+ */
+class LineReader
+{
+public:
+    LineReader(QIODevice& device, const std::function<bool()>& cancelled)
+        : m_device(device)
+        , m_cancelled(cancelled)
+        , m_lineCount(0)
+        , m_firstLine(true)
+        , m_legacyEncoding(false)
+        , m_aborted(false)
+    {
+    }
+
+    bool next(QString& line)
+    {
+        if (m_cancelled && ++m_lineCount % CANCEL_CHECK_LINES == 0 && m_cancelled()) {
+            m_aborted = true;
+            return false;
+        }
+
+        QByteArray raw = m_device.readLine(MAX_LINE_BYTES);
+        if (raw.isEmpty()) {
+            return false;
+        }
+        if (m_firstLine) {
+            m_firstLine = false;
+            if (raw.startsWith("\xEF\xBB\xBF")) {
+                raw.remove(0, 3);
+            }
+        }
+        qsizetype length = raw.size();
+        while (length > 0 && (raw.at(length - 1) == '\n' || raw.at(length - 1) == '\r')) {
+            --length;
+        }
+        raw.truncate(length);
+
+        if (!m_legacyEncoding) {
+            QStringDecoder decoder(QStringConverter::Utf8);
+            line = decoder(raw);
+            if (!decoder.hasError()) {
+                return true;
+            }
+            // Lines read so far were plain ASCII, so they decode the same either way
+            m_legacyEncoding = true;
+        }
+        line = QString::fromLocal8Bit(raw);
+        return true;
+    }
+
+    [[nodiscard]] bool aborted() const noexcept { return m_aborted; }
+
+private:
+    QIODevice& m_device;
+    const std::function<bool()>& m_cancelled;
+    int m_lineCount;
+    bool m_firstLine;
+    bool m_legacyEncoding;
+    bool m_aborted;
+};
+
+void appendEscaped(QString& out, QChar c)
+{
+    switch (c.unicode()) {
+    case u'<': out += QLatin1String("&lt;"); break;
+    case u'>': out += QLatin1String("&gt;"); break;
+    case u'&': out += QLatin1String("&amp;"); break;
+    default:   out += c; break;
+    }
+}
+
+bool isKeptStyleTag(QStringView name)
+{
+    return name.size() == 1 && (name.front().toLower() == u'b' || name.front().toLower() == u'i' ||
+                                name.front().toLower() == u'u');
+}
+
+// [hh:]mm:ss[,.]fff, or ASS h:mm:ss.cc
+std::optional<qint64> parseTimestamp(QStringView text)
+{
+    text = text.trimmed();
+    const qsizetype fractionAt = std::max(text.lastIndexOf(u','), text.lastIndexOf(u'.'));
+    const QStringView whole = fractionAt >= 0 ? text.left(fractionAt) : text;
+    QStringView fraction = fractionAt >= 0 ? text.mid(fractionAt + 1) : QStringView();
+
+    const QList<QStringView> fields = whole.split(u':');
+    if (fields.size() < 2 || fields.size() > 3) {
+        return std::nullopt;
+    }
+    qint64 ms = 0;
+    for (QStringView field : fields) {
+        bool ok = false;
+        const int value = field.toInt(&ok);
+        if (!ok || value < 0) {
+            return std::nullopt;
+        }
+        ms = ms * 60 + value;
+    }
+    ms *= 1000;
+
+    if (!fraction.isEmpty()) {
+        fraction = fraction.left(3);
+        bool ok = false;
+        int value = fraction.toInt(&ok);
+        if (!ok || value < 0) {
+            return std::nullopt;
+        }
+        for (qsizetype digits = fraction.size(); digits < 3; ++digits) {
+            value *= 10;
+        }
+        ms += value;
+    }
+    return ms;
+}
+
+// "start --> end [cue settings]"
+bool parseTiming(QStringView line, qint64& startMs, qint64& endMs)
+{
+    const qsizetype arrow = line.indexOf(u"-->");
+    if (arrow < 0) {
+        return false;
+    }
+    const QStringView rest = line.mid(arrow + 3).trimmed();
+    qsizetype endLength = 0;
+    while (endLength < rest.size() && !rest.at(endLength).isSpace()) {
+        ++endLength;
+    }
+
+    const std::optional<qint64> start = parseTimestamp(line.left(arrow));
+    const std::optional<qint64> end = parseTimestamp(rest.left(endLength));
+    if (!start || !end) {
+        return false;
+    }
+    startMs = *start;
+    endMs = *end;
+    return true;
+}
+
+// SRT/WebVTT payload: <b>, <i>, <u> survive; font, class, voice, ruby and timestamp tags are dropped
+void appendTaggedLine(QString& out, QStringView line)
+{
+    for (qsizetype i = 0; i < line.size(); ++i) {
+        const QChar c = line.at(i);
+        if (c == u'<') {
+            const qsizetype close = line.indexOf(u'>', i + 1);
+            if (close >= 0) {
+                QStringView tag = line.mid(i + 1, close - i - 1).trimmed();
+                const bool closing = tag.startsWith(u'/');
+                if (closing) {
+                    tag = tag.mid(1);
+                }
+                qsizetype nameLength = 0;
+                while (nameLength < tag.size() && tag.at(nameLength).isLetter()) {
+                    ++nameLength;
+                }
+                const QStringView name = tag.left(nameLength);
+                if (isKeptStyleTag(name)) {
+                    out += closing ? QLatin1String("</") : QLatin1String("<");
+                    out += name.front().toLower();
+                    out += u'>';
+                }
+                i = close;
+                continue;
+            }
+        } else if (c == u'{' && i + 1 < line.size() && line.at(i + 1) == u'\\') {
+            // ASS override blocks turn up in SRT files too
+            const qsizetype close = line.indexOf(u'}', i + 1);
+            if (close >= 0) {
+                i = close;
+                continue;
+            }
+        } else if (c == u'&') {
+            // Entities pass through (WebVTT requires them); a bare ampersand is escaped
+            qsizetype end = i + 1;
+            while (end < line.size() && end - i <= 8 && (line.at(end).isLetterOrNumber() || line.at(end) == u'#')) {
+                ++end;
+            }
+            if (end > i + 1 && end < line.size() && line.at(end) == u';') {
+                out += line.mid(i, end - i + 1);
+                i = end;
+                continue;
+            }
+        }
+        appendEscaped(out, c);
+    }
+}
+
+// SRT and WebVTT share the block layout: [id], timing line, payload lines, blank line
+void parseCueBlocks(LineReader& reader, SubtitleTrack::Builder& builder)
+{
+    QString line;
+    QString html;
+    qint64 startMs = 0;
+    qint64 endMs = 0;
+    bool inCue = false;
+    bool skippingBlock = false;  // WebVTT NOTE, STYLE and REGION blocks
+    qsizetype lastLineAt = 0;    // Where the last payload line begins in html
+    bool lastLineNumeric = false;
+
+    auto flush = [&]() {
+        if (inCue) {
+            builder.addCue(startMs, endMs, html);
+        }
+        inCue = false;
+        html.clear();
+    };
+
+    while (reader.next(line)) {
+        const QStringView trimmed = QStringView(line).trimmed();
+        if (trimmed.isEmpty()) {
+            flush();
+            skippingBlock = false;
+            continue;
+        }
+        if (skippingBlock) {
+            continue;
+        }
+
+        qint64 start = 0;
+        qint64 end = 0;
+        if (parseTiming(trimmed, start, end)) {
+            // No blank line before it: the previous line was this cue's number, not text
+            if (inCue && lastLineNumeric) {
+                html.truncate(lastLineAt);
+            }
+            flush();
+            inCue = true;
+            startMs = start;
+            endMs = end;
+            lastLineNumeric = false;
+            continue;
+        }
+
+        if (!inCue) {
+            // Cue numbers and ids, the WEBVTT header line
+            if (trimmed.startsWith(u"NOTE") || trimmed == u"STYLE" || trimmed == u"REGION") {
+                skippingBlock = true;
+            }
+            continue;
+        }
+
+        lastLineAt = html.size();
+        bool numeric = false;
+        static_cast<void>(trimmed.toLongLong(&numeric));
+        lastLineNumeric = numeric;
+        if (!html.isEmpty()) {
+            html += QLatin1String("<br>");
+        }
+        appendTaggedLine(html, trimmed);
+    }
+    flush();
+}
+
+// Override tags of one {...} block: \b, \i, \u toggle styling; \p1 and up start a vector drawing
+void applyAssOverrides(QString& out, QStringView block, bool& drawing)
+{
+    for (QStringView tag : block.split(u'\\', Qt::SkipEmptyParts)) {
+        tag = tag.trimmed();
+        if (tag.size() < 2) {
+            continue;
+        }
+        const QChar name = tag.front();
+        bool ok = false;
+        const int value = tag.mid(1).toInt(&ok);
+        if (!ok) {
+            continue; // \bord, \blur, \pos(...) and the like
+        }
+        if (name == u'p') {
+            drawing = value > 0;
+        } else if (name == u'b' || name == u'i' || name == u'u') {
+            // \b also takes a font weight
+            const bool on = name == u'b' ? (value == 1 || value >= 500) : value != 0;
+            out += on ? QLatin1String("<") : QLatin1String("</");
+            out += name;
+            out += u'>';
+        }
+    }
+}
+
+// Event text: \N is a hard break, \h a hard space; typesetting (positions, fades, karaoke) is dropped
+void appendAssText(QString& out, QStringView text)
+{
+    bool drawing = false;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const QChar c = text.at(i);
+        if (c == u'{') {
+            const qsizetype close = text.indexOf(u'}', i + 1);
+            if (close >= 0) {
+                applyAssOverrides(out, text.mid(i + 1, close - i - 1), drawing);
+                i = close;
+                continue;
+            }
+        }
+        if (drawing) {
+            continue;
+        }
+        if (c == u'\\' && i + 1 < text.size()) {
+            const QChar escape = text.at(i + 1);
+            if (escape == u'N' || escape == u'n') {
+                out += QLatin1String("<br>");
+                ++i;
+                continue;
+            }
+            if (escape == u'h') {
+                out += QLatin1String("&nbsp;");
+                ++i;
+                continue;
+            }
+        }
+        appendEscaped(out, c);
+    }
+}
+
+void parseAss(LineReader& reader, SubtitleTrack::Builder& builder)
+{
+    int fieldCount = ASS_DEFAULT_FIELDS;
+    int startField = ASS_DEFAULT_START_FIELD;
+    int endField = ASS_DEFAULT_END_FIELD;
+    bool inEvents = false;
+    QString line;
+    QString html;
+
+    while (reader.next(line)) {
+        const QStringView trimmed = QStringView(line).trimmed();
+        if (trimmed.startsWith(u'[')) {
+            inEvents = trimmed.compare(u"[Events]", Qt::CaseInsensitive) == 0;
+            continue;
+        }
+        if (!inEvents) {
+            continue;
+        }
+
+        if (trimmed.startsWith(u"Format:", Qt::CaseInsensitive)) {
+            const QList<QStringView> names = trimmed.mid(7).split(u',');
+            fieldCount = static_cast<int>(names.size());
+            startField = -1;
+            endField = -1;
+            for (int i = 0; i < fieldCount; ++i) {
+                const QStringView name = names.at(i).trimmed();
+                if (name.compare(u"Start", Qt::CaseInsensitive) == 0) {
+                    startField = i;
+                } else if (name.compare(u"End", Qt::CaseInsensitive) == 0) {
+                    endField = i;
+                }
+            }
+            // Text is always the last field; anything else is a broken header
+            if (startField < 0 || endField < 0 || startField >= fieldCount - 1 || endField >= fieldCount - 1) {
+                fieldCount = ASS_DEFAULT_FIELDS;
+                startField = ASS_DEFAULT_START_FIELD;
+                endField = ASS_DEFAULT_END_FIELD;
+            }
+            continue;
+        }
+        if (!trimmed.startsWith(u"Dialogue:", Qt::CaseInsensitive)) {
+            continue; // Comments, styles of other sections
+        }
+
+        // The text may contain commas; only the fields before it are split off
+        QStringView rest = trimmed.mid(9);
+        QVarLengthArray<QStringView, ASS_DEFAULT_FIELDS> fields;
+        while (fields.size() < fieldCount - 1) {
+            const qsizetype comma = rest.indexOf(u',');
+            if (comma < 0) {
+                break;
+            }
+            fields.append(rest.left(comma));
+            rest = rest.mid(comma + 1);
+        }
+        if (fields.size() != fieldCount - 1) {
+            continue;
+        }
+
+        const std::optional<qint64> start = parseTimestamp(fields.at(startField));
+        const std::optional<qint64> end = parseTimestamp(fields.at(endField));
+        if (!start || !end) {
+            continue;
+        }
+        html.clear();
+        appendAssText(html, rest);
+        builder.addCue(*start, *end, html);
+    }
+}
+
+} // namespace
+
+std::optional<SubtitleFormat> formatForPath(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "srt") {
+        return SubtitleFormat::SubRip;
+    }
+    if (suffix == "vtt") {
+        return SubtitleFormat::WebVtt;
+    }
+    if (suffix == "ass" || suffix == "ssa") {
+        return SubtitleFormat::Ass;
+    }
+    return std::nullopt;
+}
+
+SubtitleTrackPtr parse(QIODevice& device, SubtitleFormat format, const std::function<bool()>& cancelled)
+{
+    LineReader reader(device, cancelled);
+    SubtitleTrack::Builder builder;
+    if (format == SubtitleFormat::Ass) {
+        parseAss(reader, builder);
+    } else {
+        parseCueBlocks(reader, builder);
+    }
+
+    if (reader.aborted() || builder.cueCount() == 0) {
+        return nullptr;
+    }
+    return builder.finish();
+}
+
+} // namespace DarkPlay::Media::SubtitleParser
@@ -0,0 +1,227 @@
+#include "media/SubtitleService.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+#include <QMetaObject>
+#include <algorithm>
+
+namespace DarkPlay::Media {
+
+SubtitleService::SubtitleService(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_autoLoad(true)
+    , m_currentTrack(-1)
+    , m_positionMs(0)
+{
+    m_ioPool.setMaxThreadCount(1);
+}
+
+SubtitleService::~SubtitleService()
+{
+    // Pool tasks hold a raw pointer to us; the new generation also stops a parse early
+    ++m_generation;
+    m_ioPool.waitForDone();
+}
+
+void SubtitleService::setSource(const QUrl& mediaUrl)
+{
+    clear();
+    if (!mediaUrl.isLocalFile()) {
+        return; // Sidecar files only exist next to local media
+    }
+
+    m_source = mediaUrl;
+    discover();
+}
+
+void SubtitleService::clear()
+{
+    ++m_generation;
+
+    const bool hadTracks = !m_tracks.isEmpty();
+    const bool hadSelection = m_currentTrack >= 0;
+    m_source.clear();
+    m_tracks.clear();
+    m_currentTrack = -1;
+    m_track.reset();
+    m_lookup = SubtitleTrack::Lookup();
+    m_positionMs = 0;
+    setText(QString());
+
+    if (hadTracks) {
+        emit tracksChanged();
+    }
+    if (hadSelection) {
+        emit currentTrackChanged(-1);
+    }
+}
+
+void SubtitleService::setAutoLoad(bool enabled)
+{
+    m_autoLoad = enabled;
+    // Takes effect on the next file, except that turning it on picks a track right away
+    if (enabled && m_currentTrack < 0 && !m_tracks.isEmpty()) {
+        selectTrack(preferredTrack(m_tracks));
+    }
+}
+
+void SubtitleService::selectTrack(int index)
+{
+    if (index < -1 || index >= m_tracks.size() || index == m_currentTrack) {
+        return;
+    }
+
+    // Cancels a parse of the previous selection
+    ++m_generation;
+    m_currentTrack = index;
+    m_track.reset();
+    m_lookup = SubtitleTrack::Lookup();
+    setText(QString());
+    emit currentTrackChanged(index);
+
+    if (index < 0) {
+        return;
+    }
+
+    const quint64 generation = m_generation;
+    const SubtitleTrackInfo info = m_tracks.at(index);
+    m_ioPool.start([this, generation, info]() {
+        const SubtitleTrackPtr track = load(info, [this, generation]() { return m_generation.load() != generation; });
+        QMetaObject::invokeMethod(this, [this, generation, track]() {
+            onParsed(generation, track);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SubtitleService::updatePosition(qint64 positionMs)
+{
+    m_positionMs = positionMs;
+    if (!m_track) {
+        return;
+    }
+
+    // No cue starts or ends inside the span the last lookup covered
+    if (positionMs >= m_lookup.validFromMs && positionMs < m_lookup.validUntilMs) {
+        return;
+    }
+    m_lookup = m_track->cuesAt(positionMs);
+    setText(m_lookup.html);
+}
+
+void SubtitleService::discover()
+{
+    const quint64 generation = m_generation;
+    const QString mediaPath = m_source.toLocalFile();
+    m_ioPool.start([this, generation, mediaPath]() {
+        const QList<SubtitleTrackInfo> tracks = findSidecars(mediaPath);
+        QMetaObject::invokeMethod(this, [this, generation, tracks]() {
+            onDiscovered(generation, tracks);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void SubtitleService::onDiscovered(quint64 generation, const QList<SubtitleTrackInfo>& tracks)
+{
+    if (generation != m_generation || tracks.isEmpty()) {
+        return;
+    }
+
+    m_tracks = tracks;
+    emit tracksChanged();
+    if (m_autoLoad) {
+        selectTrack(preferredTrack(m_tracks));
+    }
+}
+
+void SubtitleService::onParsed(quint64 generation, const SubtitleTrackPtr& track)
+{
+    if (generation != m_generation || !track) {
+        return;
+    }
+
+    m_track = track;
+    m_lookup = SubtitleTrack::Lookup();
+    updatePosition(m_positionMs);
+}
+
+void SubtitleService::setText(const QString& html)
+{
+    if (html == m_text) {
+        return;
+    }
+    m_text = html;
+    emit textChanged(m_text);
+}
+
+QList<SubtitleTrackInfo> SubtitleService::findSidecars(const QString& mediaPath)
+{
+    // movie.mkv takes movie.srt, movie.en.srt, movie.en.forced.ass, ...
+    const QFileInfo media(mediaPath);
+    const QString baseName = media.completeBaseName();
+    const QStringList candidates = media.absoluteDir().entryList(
+        {"*.srt", "*.vtt", "*.ass", "*.ssa"}, QDir::Files | QDir::Readable, QDir::Name);
+
+    QList<SubtitleTrackInfo> tracks;
+    for (const QString& fileName : candidates) {
+        const QString stem = QFileInfo(fileName).completeBaseName();
+        if (!stem.startsWith(baseName, Qt::CaseInsensitive) ||
+            (stem.size() > baseName.size() && stem.at(baseName.size()) != u'.')) {
+            continue;
+        }
+        const std::optional<SubtitleFormat> format = SubtitleParser::formatForPath(fileName);
+        if (!format) {
+            continue;
+        }
+
+        SubtitleTrackInfo info;
+        info.filePath = media.absoluteDir().filePath(fileName);
+        info.label = stem.mid(baseName.size() + 1);
+        info.format = *format;
+        tracks.append(info);
+    }
+
+    // The file named exactly like the media comes first
+    std::stable_sort(tracks.begin(), tracks.end(), [](const SubtitleTrackInfo& a, const SubtitleTrackInfo& b) {
+        return a.label.isEmpty() && !b.label.isEmpty();
+    });
+    return tracks;
+}
+
+int SubtitleService::preferredTrack(const QList<SubtitleTrackInfo>& tracks)
+{
+    // A track labelled with the system language, else the first one
+    const QString language = QLocale::system().name().section(u'_', 0, 0);
+    for (int i = 0; i < tracks.size(); ++i) {
+        const QString labelLanguage = tracks.at(i).label.section(u'.', 0, 0);
+        if (!language.isEmpty() && labelLanguage.compare(language, Qt::CaseInsensitive) == 0) {
+            return i;
+        }
+    }
+    return tracks.isEmpty() ? -1 : 0;
+}
+
+SubtitleTrackPtr SubtitleService::load(const SubtitleTrackInfo& info, const std::function<bool()>& cancelled)
+{
+    QFile file(info.filePath);
+    if (file.size() > MAX_FILE_BYTES) {
+        qWarning() << "SubtitleService: Skipping oversized subtitle file" << info.filePath;
+        return nullptr;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "SubtitleService: Cannot open" << info.filePath << "-" << file.errorString();
+        return nullptr;
+    }
+
+    const SubtitleTrackPtr track = SubtitleParser::parse(file, info.format, cancelled);
+    if (track) {
+        qDebug() << "SubtitleService: Loaded" << track->cueCount() << "cues from" << info.filePath;
+    } else if (!cancelled()) {
+        qWarning() << "SubtitleService: No cues in" << info.filePath;
+    }
+    return track;
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,107 @@
+#include "media/SubtitleTrack.h"
+#include <algorithm>
+#include <limits>
+
+namespace DarkPlay::Media {
+
+void SubtitleTrack::Builder::addCue(qint64 startMs, qint64 endMs, QStringView html)
+{
+    if (endMs <= startMs || html.isEmpty()) {
+        return;
+    }
+    // The arena is addressed with 32-bit offsets; a subtitle file never gets close
+    if (m_text.size() + html.size() > std::numeric_limits<quint32>::max()) {
+        return;
+    }
+
+    Cue cue;
+    cue.startMs = startMs;
+    cue.endMs = endMs;
+    cue.textOffset = static_cast<quint32>(m_text.size());
+    cue.textLength = static_cast<quint32>(html.size());
+    m_text.append(html);
+    m_cues.push_back(cue);
+}
+
+std::shared_ptr<const SubtitleTrack> SubtitleTrack::Builder::finish()
+{
+    // ASS events need not be in time order; ties keep file order
+    std::stable_sort(m_cues.begin(), m_cues.end(), [](const Cue& a, const Cue& b) {
+        return a.startMs < b.startMs;
+    });
+
+    std::shared_ptr<SubtitleTrack> track(new SubtitleTrack);
+    track->m_cues = std::move(m_cues);
+    track->m_text = std::move(m_text);
+    track->m_text.squeeze();
+    track->m_maxEndMs.resize(track->m_cues.size());
+    track->buildIndex(0, track->cueCount());
+
+    m_cues = {};
+    m_text.clear();
+    return track;
+}
+
+qint64 SubtitleTrack::buildIndex(int begin, int end)
+{
+    if (begin >= end) {
+        return std::numeric_limits<qint64>::min();
+    }
+    const int node = begin + (end - begin) / 2;
+    const qint64 left = buildIndex(begin, node);
+    const qint64 right = buildIndex(node + 1, end);
+    m_maxEndMs[node] = std::max({m_cues[node].endMs, left, right});
+    return m_maxEndMs[node];
+}
+
+void SubtitleTrack::collect(int begin, int end, qint64 positionMs, std::vector<int>& active) const
+{
+    if (begin >= end) {
+        return;
+    }
+    const int node = begin + (end - begin) / 2;
+    // Everything below ended already
+    if (m_maxEndMs[node] <= positionMs) {
+        return;
+    }
+
+    collect(begin, node, positionMs, active);
+    const Cue& cue = m_cues[node];
+    if (cue.startMs > positionMs) {
+        return; // The right subtree starts later still
+    }
+    if (cue.endMs > positionMs) {
+        active.push_back(node);
+    }
+    collect(node + 1, end, positionMs, active);
+}
+
+SubtitleTrack::Lookup SubtitleTrack::cuesAt(qint64 positionMs) const
+{
+    Lookup lookup;
+    lookup.validFromMs = positionMs;
+
+    // The next cue to start bounds the answer even when nothing is showing
+    const auto next = std::upper_bound(m_cues.begin(), m_cues.end(), positionMs,
+                                       [](qint64 position, const Cue& cue) { return position < cue.startMs; });
+    lookup.validUntilMs = next != m_cues.end() ? next->startMs : std::numeric_limits<qint64>::max();
+
+    std::vector<int> active;
+    collect(0, cueCount(), positionMs, active);
+    for (int index : active) {
+        const Cue& cue = m_cues[index];
+        if (!lookup.html.isEmpty()) {
+            lookup.html += QStringLiteral("<br>");
+        }
+        lookup.html += text(cue);
+        lookup.validUntilMs = std::min(lookup.validUntilMs, cue.endMs);
+    }
+    return lookup;
+}
+
+QStringView SubtitleTrack::text(const Cue& cue) const noexcept
+{
+    return QStringView(m_text).mid(cue.textOffset, cue.textLength);
+}
+
+} // namespace DarkPlay::Media
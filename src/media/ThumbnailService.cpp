@@ -0,0 +1,622 @@
+#include "media/ThumbnailService.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMediaPlayer>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QVideoFrame>
+#include <QVideoSink>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace DarkPlay::Media {
+
+namespace {
+
+constexpr quint32 CACHE_MAGIC = 0x44505448; // "DPTH"
+constexpr qint64 HASH_CHUNK_BYTES = 1024 * 1024;
+constexpr int MAX_THUMBNAILS = 400;
+constexpr qint64 MIN_INTERVAL_MS = 2000;
+constexpr int LOAD_TIMEOUT_MS = 10000;
+constexpr int FRAME_TIMEOUT_MS = 3000;
+constexpr qint64 FRAME_TOLERANCE_MS = 1000;
+constexpr int COARSE_STRIDE = 64;
+
+// Same answer in every worker, so they agree on the layout without talking to each other
+qint64 thumbnailInterval(qint64 durationMs)
+{
+    return std::max(MIN_INTERVAL_MS, (durationMs + MAX_THUMBNAILS - 1) / MAX_THUMBNAILS);
+}
+
+} // namespace
+
+/**
+ * @brief One worker: a private QMediaPlayer that seeks through a share of the thumbnails
+ *
+ * Lives on its own QThread and reports back through queued calls on the service.
+ */
+class ThumbnailDecoder : public QObject
+{
+public:
+    ThumbnailDecoder(ThumbnailService* service, quint64 generation, const QUrl& url,
+                     int workerIndex, int workerCount)
+        : m_service(service)
+        , m_generation(generation)
+        , m_url(url)
+        , m_workerIndex(workerIndex)
+        , m_workerCount(workerCount)
+        , m_player(nullptr)
+        , m_timeout(nullptr)
+        , m_currentIndex(-1)
+        , m_targetMs(0)
+        , m_intervalMs(0)
+        , m_planned(false)
+        , m_finished(false)
+    {
+    }
+
+    // Runs on the worker thread
+    void start()
+    {
+        // No audio output: the player only ever decodes video
+        m_player = new QMediaPlayer(this);
+        auto* sink = new QVideoSink(this);
+        m_player->setVideoSink(sink);
+
+        m_timeout = new QTimer(this);
+        m_timeout->setSingleShot(true);
+        connect(m_timeout, &QTimer::timeout, this, [this]() {
+            if (m_planned) {
+                seekNext(); // Give up on this frame, keep the rest
+            } else {
+                finish();
+            }
+        });
+
+        connect(m_player, &QMediaPlayer::mediaStatusChanged, this,
+                [this](QMediaPlayer::MediaStatus status) { onMediaStatusChanged(status); });
+        connect(m_player, &QMediaPlayer::errorOccurred, this, [this]() { finish(); });
+        connect(sink, &QVideoSink::videoFrameChanged, this,
+                [this](const QVideoFrame& frame) { onVideoFrameChanged(frame); });
+
+        m_timeout->start(LOAD_TIMEOUT_MS);
+        m_player->setSource(m_url);
+    }
+
+private:
+    void onMediaStatusChanged(QMediaPlayer::MediaStatus status)
+    {
+        if (status == QMediaPlayer::InvalidMedia) {
+            finish();
+            return;
+        }
+
+        if (status != QMediaPlayer::LoadedMedia || m_planned) {
+            return;
+        }
+
+        const qint64 duration = m_player->duration();
+        if (!m_player->hasVideo() || duration <= 0) {
+            finish();
+            return;
+        }
+
+        plan(duration);
+        m_player->pause(); // Paused, every seek still delivers one frame
+        seekNext();
+    }
+
+    void plan(qint64 durationMs)
+    {
+        m_planned = true;
+        m_intervalMs = thumbnailInterval(durationMs);
+        const int count = static_cast<int>(std::min<qint64>(durationMs / m_intervalMs + 1, MAX_THUMBNAILS));
+
+        // Coarse-to-fine, so the whole timeline gets usable previews early
+        std::vector<bool> queued(count, false);
+        for (int stride = COARSE_STRIDE; stride >= 1; stride /= 2) {
+            for (int index = 0; index < count; index += stride) {
+                if (!queued[index] && index % m_workerCount == m_workerIndex) {
+                    queued[index] = true;
+                    m_queue.append(index);
+                }
+            }
+        }
+
+        ThumbnailService* service = m_service;
+        const quint64 generation = m_generation;
+        const qint64 interval = m_intervalMs;
+        QMetaObject::invokeMethod(service, [service, generation, count, interval]() {
+            service->onPlanned(generation, count, interval);
+        }, Qt::QueuedConnection);
+    }
+
+    void seekNext()
+    {
+        if (m_queue.isEmpty()) {
+            finish();
+            return;
+        }
+
+        m_currentIndex = m_queue.takeFirst();
+        m_targetMs = m_currentIndex * m_intervalMs;
+        m_timeout->start(FRAME_TIMEOUT_MS);
+        m_player->setPosition(m_targetMs);
+    }
+
+    void onVideoFrameChanged(const QVideoFrame& frame)
+    {
+        if (m_finished || m_currentIndex < 0 || !frame.isValid()) {
+            return;
+        }
+
+        // Frames still in flight from the previous seek are not ours
+        const qint64 tolerance = std::max(FRAME_TOLERANCE_MS, m_intervalMs / 2);
+        if (frame.startTime() >= 0 && qAbs(frame.startTime() / 1000 - m_targetMs) > tolerance) {
+            return;
+        }
+
+        const QImage image = frame.toImage().scaled(ThumbnailService::THUMBNAIL_WIDTH,
+                                                    ThumbnailService::THUMBNAIL_HEIGHT,
+                                                    Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        if (!image.isNull()) {
+            ThumbnailService* service = m_service;
+            const quint64 generation = m_generation;
+            const int index = m_currentIndex;
+            QMetaObject::invokeMethod(service, [service, generation, index, image]() {
+                service->onThumbnailDecoded(generation, index, image);
+            }, Qt::QueuedConnection);
+        }
+
+        m_currentIndex = -1;
+        seekNext();
+    }
+
+    void finish()
+    {
+        if (m_finished) {
+            return;
+        }
+        m_finished = true;
+
+        m_timeout->stop();
+        m_player->stop();
+
+        ThumbnailService* service = m_service;
+        const quint64 generation = m_generation;
+        QMetaObject::invokeMethod(service, [service, generation]() {
+            service->onDecoderFinished(generation);
+        }, Qt::QueuedConnection);
+
+        thread()->quit();
+    }
+
+    ThumbnailService* m_service; // Outlives the thread, see ~ThumbnailService()
+    quint64 m_generation;
+    QUrl m_url;
+    int m_workerIndex;
+    int m_workerCount;
+
+    QMediaPlayer* m_player;
+    QTimer* m_timeout;
+    QList<int> m_queue;
+    int m_currentIndex;
+    qint64 m_targetMs;
+    qint64 m_intervalMs;
+    bool m_planned;
+    bool m_finished;
+};
+
+ThumbnailService::ThumbnailService(QObject* parent)
+    : QObject(parent)
+    , m_generation(0)
+    , m_decodedCount(0)
+    , m_complete(false)
+    , m_sheetBytes(0)
+    , m_lastUseMs(0)
+    , m_evicted(false)
+    , m_reloading(false)
+    , m_runningDecoders(0)
+{
+    m_ioPool.setMaxThreadCount(1);
+
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->registerConsumer("Thumbnails", this);
+    }
+}
+
+ThumbnailService::~ThumbnailService()
+{
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->unregisterConsumer(this);
+    }
+
+    // Decoders and pool tasks hold a raw pointer to us - both must be gone first
+    ++m_generation;
+    stopDecoders();
+    for (const QPointer<QThread>& thread : std::as_const(m_decoderThreads)) {
+        if (thread) {
+            thread->wait();
+        }
+    }
+    m_ioPool.waitForDone();
+}
+
+void ThumbnailService::setSource(const QUrl& url)
+{
+    if (url == m_source && (m_complete || m_runningDecoders > 0)) {
+        return;
+    }
+
+    clear();
+    if (!url.isLocalFile()) {
+        return; // The cache key needs the file contents
+    }
+
+    m_source = url;
+    const quint64 generation = m_generation;
+    const QString filePath = url.toLocalFile();
+
+    m_ioPool.start([this, generation, filePath]() {
+        const QString cacheKey = computeCacheKey(filePath);
+        SpriteSheets cached;
+        if (!cacheKey.isEmpty()) {
+            loadSheets(cacheKey, cached);
+        }
+
+        QMetaObject::invokeMethod(this, [this, generation, cacheKey, cached]() {
+            onCacheLookupFinished(generation, cacheKey, cached);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ThumbnailService::clear()
+{
+    ++m_generation;
+    stopDecoders();
+
+    m_source.clear();
+    m_cacheKey.clear();
+    m_thumbnails = SpriteSheets();
+    m_decodedCount = 0;
+    m_complete = false;
+    m_sheetBytes = 0;
+    m_evicted = false;
+    m_reloading = false;
+
+    emit thumbnailsUpdated();
+}
+
+QImage ThumbnailService::thumbnailAt(qint64 positionMs)
+{
+    m_lastUseMs = Utils::MemoryBudget::nowMs();
+    if (m_evicted) {
+        reloadSheets();
+        return {};
+    }
+
+    const int count = m_thumbnails.count;
+    if (m_decodedCount == 0 || count <= 0 || m_thumbnails.intervalMs <= 0) {
+        return {};
+    }
+
+    const int wanted = static_cast<int>(qBound<qint64>(0, qRound64(static_cast<double>(positionMs) / m_thumbnails.intervalMs), count - 1));
+
+    // While decoding is still coarse, fall back to the closest neighbour
+    for (int distance = 0; distance < count; ++distance) {
+        for (int index : {wanted - distance, wanted + distance}) {
+            if (index < 0 || index >= count || !m_thumbnails.decoded.testBit(index)) {
+                continue;
+            }
+
+            const int sheet = index / THUMBNAILS_PER_SHEET;
+            const int cell = index % THUMBNAILS_PER_SHEET;
+            if (sheet >= m_thumbnails.sheets.size()) {
+                return {};
+            }
+            return m_thumbnails.sheets.at(sheet).copy((cell % SHEET_COLUMNS) * THUMBNAIL_WIDTH,
+                                                      (cell / SHEET_COLUMNS) * THUMBNAIL_HEIGHT,
+                                                      THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+        }
+    }
+
+    return {};
+}
+
+void ThumbnailService::onCacheLookupFinished(quint64 generation, const QString& cacheKey, const SpriteSheets& cached)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_cacheKey = cacheKey;
+    m_evicted = false;
+    m_reloading = false;
+    if (cached.count > 0) {
+        m_thumbnails = cached;
+        m_decodedCount = static_cast<int>(cached.decoded.count(true));
+        m_complete = true;
+        m_lastUseMs = Utils::MemoryBudget::nowMs();
+        updateSheetBytes();
+        qDebug() << "ThumbnailService: Loaded" << m_decodedCount << "cached thumbnails";
+        emit thumbnailsUpdated();
+        return;
+    }
+
+    // Evicted sheets that did not make it to disk are decoded again
+    m_complete = false;
+
+    if (!cacheKey.isEmpty()) {
+        startDecoders();
+    }
+}
+
+void ThumbnailService::startDecoders()
+{
+    // Every decoder is a whole player with its own frame queue; low-memory mode keeps one
+    const int maxDecoders = Utils::MemoryBudget::isLowMemoryMode() ? 1 : MAX_DECODERS;
+    const int workerCount = qBound(1, QThread::idealThreadCount() / 4, maxDecoders);
+    m_runningDecoders = workerCount;
+
+    for (int i = 0; i < workerCount; ++i) {
+        auto* thread = new QThread();
+        thread->setObjectName(QString("Thumbnail decoder %1").arg(i));
+
+        auto* decoder = new ThumbnailDecoder(this, m_generation, m_source, i, workerCount);
+        decoder->moveToThread(thread);
+
+        connect(thread, &QThread::started, decoder, [decoder]() { decoder->start(); });
+        connect(thread, &QThread::finished, decoder, &QObject::deleteLater);
+        connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+        m_decoderThreads.append(thread);
+        thread->start(QThread::LowPriority);
+    }
+}
+
+void ThumbnailService::stopDecoders()
+{
+    // Non-blocking: stale workers wind down on their own and their results are ignored
+    for (const QPointer<QThread>& thread : std::as_const(m_decoderThreads)) {
+        if (thread) {
+            thread->quit();
+        }
+    }
+    m_decoderThreads.removeIf([](const QPointer<QThread>& thread) { return thread.isNull(); });
+    m_runningDecoders = 0;
+}
+
+void ThumbnailService::onPlanned(quint64 generation, int count, qint64 intervalMs)
+{
+    if (generation != m_generation || m_thumbnails.count > 0 || count <= 0) {
+        return;
+    }
+
+    m_thumbnails.count = count;
+    m_thumbnails.intervalMs = intervalMs;
+    m_thumbnails.decoded = QBitArray(count, false);
+
+    for (int first = 0; first < count; first += THUMBNAILS_PER_SHEET) {
+        const int cells = std::min(THUMBNAILS_PER_SHEET, count - first);
+        const int rows = (cells + SHEET_COLUMNS - 1) / SHEET_COLUMNS;
+        QImage sheet(SHEET_COLUMNS * THUMBNAIL_WIDTH, rows * THUMBNAIL_HEIGHT, QImage::Format_RGB32);
+        sheet.fill(Qt::black);
+        m_thumbnails.sheets.append(sheet);
+    }
+    m_lastUseMs = Utils::MemoryBudget::nowMs();
+    updateSheetBytes();
+    if (auto* budget = Utils::MemoryBudget::instance()) {
+        budget->requestCheck();
+    }
+}
+
+void ThumbnailService::onThumbnailDecoded(quint64 generation, int index, const QImage& image)
+{
+    if (generation != m_generation || index < 0 || index >= m_thumbnails.count) {
+        return;
+    }
+
+    // Letterbox into the fixed cell
+    QImage& sheet = m_thumbnails.sheets[index / THUMBNAILS_PER_SHEET];
+    const int cell = index % THUMBNAILS_PER_SHEET;
+    const QRect cellRect((cell % SHEET_COLUMNS) * THUMBNAIL_WIDTH, (cell / SHEET_COLUMNS) * THUMBNAIL_HEIGHT,
+                         THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+    QRect target(QPoint(0, 0), image.size());
+    target.moveCenter(cellRect.center());
+
+    QPainter painter(&sheet);
+    painter.fillRect(cellRect, Qt::black);
+    painter.drawImage(target, image);
+    painter.end();
+
+    if (!m_thumbnails.decoded.testBit(index)) {
+        m_thumbnails.decoded.setBit(index);
+        ++m_decodedCount;
+    }
+    emit thumbnailsUpdated();
+}
+
+void ThumbnailService::onDecoderFinished(quint64 generation)
+{
+    if (generation != m_generation || --m_runningDecoders > 0) {
+        return;
+    }
+
+    m_complete = true;
+    qDebug() << "ThumbnailService: Decoded" << m_decodedCount << "of" << m_thumbnails.count << "thumbnails";
+    storeSheets();
+    emit thumbnailsUpdated();
+}
+
+void ThumbnailService::storeSheets()
+{
+    if (m_cacheKey.isEmpty() || m_decodedCount == 0) {
+        return;
+    }
+
+    // Images are implicitly shared; the copy is cheap and detaches only if we paint again
+    const QString cacheKey = m_cacheKey;
+    const SpriteSheets thumbnails = m_thumbnails;
+    m_ioPool.start([cacheKey, thumbnails]() { saveSheets(cacheKey, thumbnails); });
+}
+
+qint64 ThumbnailService::oldestUseMs() const
+{
+    // Only a set that is on disk can come back; one still decoding stays
+    const bool evictable = m_complete && !m_evicted && m_decodedCount > 0 && !m_cacheKey.isEmpty();
+    return evictable ? m_lastUseMs : -1;
+}
+
+qint64 ThumbnailService::evict(qint64 bytes)
+{
+    Q_UNUSED(bytes)
+    if (oldestUseMs() < 0) {
+        return 0;
+    }
+
+    // One file's sheets go as a whole; thumbnailAt() brings them back
+    const qint64 freed = m_sheetBytes;
+    m_thumbnails = SpriteSheets();
+    m_decodedCount = 0;
+    m_sheetBytes = 0;
+    m_evicted = true;
+    qDebug() << "ThumbnailService: Released" << freed / 1024 << "KB of sprite sheets";
+
+    // Not from inside the budget's check: a listener may ask it for stats
+    QMetaObject::invokeMethod(this, &ThumbnailService::thumbnailsUpdated, Qt::QueuedConnection);
+    return freed;
+}
+
+void ThumbnailService::reloadSheets()
+{
+    if (m_reloading || m_cacheKey.isEmpty()) {
+        return;
+    }
+    m_reloading = true;
+
+    // Queued behind the save of these sheets, if it is still running
+    const quint64 generation = m_generation;
+    const QString cacheKey = m_cacheKey;
+    m_ioPool.start([this, generation, cacheKey]() {
+        SpriteSheets cached;
+        loadSheets(cacheKey, cached);
+        QMetaObject::invokeMethod(this, [this, generation, cacheKey, cached]() {
+            onCacheLookupFinished(generation, cacheKey, cached);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ThumbnailService::updateSheetBytes()
+{
+    m_sheetBytes = 0;
+    for (const QImage& sheet : std::as_const(m_thumbnails.sheets)) {
+        m_sheetBytes += sheet.sizeInBytes();
+    }
+}
+
+QString ThumbnailService::computeCacheKey(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    // Size plus head and tail identifies a media file without reading all of it
+    const qint64 size = file.size();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(size));
+    hash.addData(QByteArray::number(CACHE_FORMAT_VERSION));
+    hash.addData(file.read(HASH_CHUNK_BYTES));
+    if (size > HASH_CHUNK_BYTES) {
+        file.seek(std::max(HASH_CHUNK_BYTES, size - HASH_CHUNK_BYTES));
+        hash.addData(file.read(HASH_CHUNK_BYTES));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString ThumbnailService::cacheDirectory(const QString& cacheKey)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails/" + cacheKey;
+}
+
+bool ThumbnailService::loadSheets(const QString& cacheKey, SpriteSheets& result)
+{
+    const QDir directory(cacheDirectory(cacheKey));
+    QFile indexFile(directory.filePath("index.dat"));
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&indexFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    qint32 version = 0;
+    qint32 count = 0;
+    qint64 intervalMs = 0;
+    qint32 width = 0;
+    qint32 height = 0;
+    qint32 sheetCount = 0;
+    QBitArray decoded;
+    stream >> magic >> version >> count >> intervalMs >> width >> height >> sheetCount >> decoded;
+
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_FORMAT_VERSION
+        || width != THUMBNAIL_WIDTH || height != THUMBNAIL_HEIGHT || count <= 0 || intervalMs <= 0
+        || decoded.size() != count || sheetCount != (count + THUMBNAILS_PER_SHEET - 1) / THUMBNAILS_PER_SHEET) {
+        return false;
+    }
+
+    QList<QImage> sheets;
+    for (int i = 0; i < sheetCount; ++i) {
+        QImage sheet(directory.filePath(QString("sheet%1.jpg").arg(i)));
+        if (sheet.isNull()) {
+            return false;
+        }
+        sheets.append(sheet.convertToFormat(QImage::Format_RGB32));
+    }
+
+    result.count = count;
+    result.intervalMs = intervalMs;
+    result.decoded = decoded;
+    result.sheets = sheets;
+    return true;
+}
+
+void ThumbnailService::saveSheets(const QString& cacheKey, const SpriteSheets& thumbnails)
+{
+    const QDir directory(cacheDirectory(cacheKey));
+    if (!directory.mkpath(".")) {
+        qWarning() << "ThumbnailService: Cannot create cache directory" << directory.path();
+        return;
+    }
+
+    for (int i = 0; i < thumbnails.sheets.size(); ++i) {
+        if (!thumbnails.sheets.at(i).save(directory.filePath(QString("sheet%1.jpg").arg(i)), "JPG", 85)) {
+            qWarning() << "ThumbnailService: Failed to write sprite sheet" << i;
+            return;
+        }
+    }
+
+    // The index goes last: a cache entry without one is ignored
+    QSaveFile indexFile(directory.filePath("index.dat"));
+    if (!indexFile.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&indexFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << CACHE_MAGIC << qint32(CACHE_FORMAT_VERSION) << qint32(thumbnails.count) << thumbnails.intervalMs
+           << qint32(THUMBNAIL_WIDTH) << qint32(THUMBNAIL_HEIGHT) << qint32(thumbnails.sheets.size())
+           << thumbnails.decoded;
+    if (!indexFile.commit()) {
+        qWarning() << "ThumbnailService: Failed to write thumbnail index";
+    }
+}
+
+} // namespace DarkPlay::Media
@@ -0,0 +1,187 @@
+#include "media/VideoFanout.h"
+#include "utils/Trace.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace DarkPlay::Media {
+
+VideoFanout::VideoFanout(QObject* parent)
+    : QObject(parent)
+    , m_framesDistributed(0)
+    , m_framesDroppedLate(0)
+    , m_skewFrameUs(-1)
+    , m_skewFirstNs(0)
+    , m_skewReports(0)
+    , m_lastSkewUs(-1)
+    , m_windowMaxSkewUs(-1)
+    , m_previousWindowMaxSkewUs(-1)
+    , m_windowStartMs(0)
+{
+    m_clock.start();
+
+    m_presentTimer.setSingleShot(true);
+    m_presentTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_presentTimer, &QTimer::timeout, this, &VideoFanout::presentDue);
+
+    // Queued onto our thread when the engine delivers from its own, then one pass over all outputs
+    connect(&m_input, &QVideoSink::videoFrameChanged, this, &VideoFanout::onFrameArrived);
+}
+
+void VideoFanout::addOutput(QVideoSink* sink)
+{
+    if (!sink || sink == &m_input) {
+        return;
+    }
+    std::erase_if(m_outputs, [](const QPointer<QVideoSink>& output) { return output.isNull(); });
+    if (std::find(m_outputs.begin(), m_outputs.end(), sink) != m_outputs.end()) {
+        return;
+    }
+
+    m_outputs.emplace_back(sink);
+    // A paused video would otherwise leave the new output black until the next frame
+    if (m_currentFrame.isValid()) {
+        sink->setVideoFrame(m_currentFrame);
+    }
+    qDebug() << "VideoFanout:" << outputCount() << "outputs";
+}
+
+void VideoFanout::removeOutput(QVideoSink* sink)
+{
+    std::erase_if(m_outputs, [sink](const QPointer<QVideoSink>& output) {
+        return output.isNull() || output == sink;
+    });
+    m_skewReports = 0;
+}
+
+int VideoFanout::outputCount() const
+{
+    return static_cast<int>(std::count_if(m_outputs.begin(), m_outputs.end(),
+                                          [](const QPointer<QVideoSink>& output) { return !output.isNull(); }));
+}
+
+void VideoFanout::setClock(ClockReader reader)
+{
+    m_clockReader = std::move(reader);
+}
+
+ClockReading VideoFanout::readClock() const
+{
+    return m_clockReader ? m_clockReader() : ClockReading{};
+}
+
+void VideoFanout::onFrameArrived(const QVideoFrame& frame)
+{
+    const ClockReading clock = readClock();
+    const bool scheduled = clock.source == ClockSource::Audio && clock.running && clock.nowUs >= 0;
+    if (!scheduled || !frame.isValid() || frame.startTime() < 0) {
+        // Paused (seeks, steps), no audio to follow, or nothing to schedule by: as it comes
+        m_held.clear();
+        m_presentTimer.stop();
+        distribute(frame);
+        return;
+    }
+
+    m_held.push_back(frame);
+    presentDue();
+}
+
+void VideoFanout::presentDue()
+{
+    if (m_held.empty()) {
+        return;
+    }
+
+    const ClockReading clock = readClock();
+    if (clock.source != ClockSource::Audio || !clock.running || clock.nowUs < 0) {
+        // The clock stopped or lost its audio while frames waited; the newest is what it shows now
+        const QVideoFrame newest = m_held.back();
+        m_held.clear();
+        m_presentTimer.stop();
+        distribute(newest);
+        return;
+    }
+
+    // Of the frames that are due only the newest is worth showing
+    const size_t none = m_held.size();
+    size_t due = none;
+    for (size_t i = 0; i < m_held.size(); ++i) {
+        if (m_held[i].startTime() <= clock.nowUs + PRESENT_TOLERANCE_US) {
+            due = i;
+        }
+    }
+    // Far ahead means the stream and the clock disagree, and a full queue means the decoder is
+    // racing it; either way waiting would only freeze the picture
+    if (due == none && (m_held.front().startTime() - clock.nowUs > MAX_AHEAD_US || m_held.size() > MAX_HELD_FRAMES)) {
+        due = 0;
+    }
+
+    if (due != none) {
+        m_framesDroppedLate += due;
+        const QVideoFrame frame = m_held[due];
+        m_held.erase(m_held.begin(), m_held.begin() + static_cast<std::ptrdiff_t>(due) + 1);
+        distribute(frame);
+    }
+
+    if (m_held.empty()) {
+        m_presentTimer.stop();
+        return;
+    }
+    // Media time runs at the playback rate, the timer in wall time
+    const double waitUs = (m_held.front().startTime() - PRESENT_TOLERANCE_US - clock.nowUs) / clock.rate;
+    m_presentTimer.start(std::max(1, static_cast<int>(std::ceil(waitUs / 1000.0))));
+}
+
+void VideoFanout::distribute(const QVideoFrame& frame)
+{
+    DARKPLAY_TRACE_SCOPE("video", "distributeFrame");
+
+    m_currentFrame = frame;
+    ++m_framesDistributed;
+    m_skewFrameUs = frame.startTime();
+    m_skewReports = 0;
+
+    // By reference: each output holds the same buffers
+    for (const QPointer<QVideoSink>& output : m_outputs) {
+        if (output) {
+            output->setVideoFrame(frame);
+        }
+    }
+}
+
+void VideoFanout::reportPresented(qint64 presentationTimeUs)
+{
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    const qint64 nowMs = nowNs / 1000000;
+    if (nowMs - m_windowStartMs >= SKEW_WINDOW_MS) {
+        m_previousWindowMaxSkewUs = m_windowMaxSkewUs;
+        m_windowMaxSkewUs = -1;
+        m_windowStartMs = nowMs;
+    }
+
+    // Only the newest frame counts; an output still drawing an older one fell behind
+    if (presentationTimeUs != m_skewFrameUs || m_skewFrameUs < 0) {
+        return;
+    }
+    if (m_skewReports++ == 0) {
+        m_skewFirstNs = nowNs;
+    }
+    if (m_skewReports == outputCount() && m_skewReports > 1) {
+        m_lastSkewUs = (nowNs - m_skewFirstNs) / 1000;
+        m_windowMaxSkewUs = std::max(m_windowMaxSkewUs, m_lastSkewUs);
+    }
+}
+
+VideoFanoutStats VideoFanout::stats() const
+{
+    VideoFanoutStats stats;
+    stats.outputs = outputCount();
+    stats.framesDistributed = m_framesDistributed;
+    stats.lastSkewUs = m_lastSkewUs;
+    stats.maxSkewUs = std::max(m_windowMaxSkewUs, m_previousWindowMaxSkewUs);
+    stats.framesHeld = static_cast<int>(m_held.size());
+    stats.framesDroppedLate = m_framesDroppedLate;
+    return stats;
+}
+
+} // namespace DarkPlay::Media
@@ -7,6 +7,7 @@ namespace DarkPlay::UI {
 ClickableSlider::ClickableSlider(Qt::Orientation orientation, QWidget *parent)
     : QSlider(orientation, parent)
 {
+    setMouseTracking(true); // Hover previews need moves without a pressed button
 }
 
 void ClickableSlider::mousePressEvent(QMouseEvent *event)
@@ -18,11 +19,11 @@ void ClickableSlider::mousePressEvent(QMouseEvent *event)
             return;
         }
 
-        int position = (orientation() == Qt::Horizontal) ? event->pos().x() : event->pos().y();
-        int value = calculateValueFromPosition(position);
+        int value = calculateValueFromPosition(eventPosition(event));
 
         // Additional safety check before setting value
         if (value >= minimum() && value <= maximum()) {
+            m_trackDragging = true;
             setValue(value);
             emit sliderPressed();
             emit sliderMoved(value);
@@ -34,6 +35,53 @@ void ClickableSlider::mousePressEvent(QMouseEvent *event)
     }
 }
 
+void ClickableSlider::mouseMoveEvent(QMouseEvent *event)
+{
+    if (minimum() >= maximum()) {
+        QSlider::mouseMoveEvent(event);
+        return;
+    }
+
+    const int value = calculateValueFromPosition(eventPosition(event));
+    emit hoverMoved(value, event->position().toPoint());
+
+    // The press was taken over from QSlider, so it cannot track the drag itself
+    if (m_trackDragging) {
+        if (value != this->value()) {
+            setValue(value);
+            emit sliderMoved(value);
+        }
+        event->accept();
+        return;
+    }
+
+    QSlider::mouseMoveEvent(event);
+}
+
+void ClickableSlider::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (m_trackDragging && event->button() == Qt::LeftButton) {
+        m_trackDragging = false;
+        emit sliderReleased();
+        event->accept();
+        return;
+    }
+
+    QSlider::mouseReleaseEvent(event);
+}
+
+void ClickableSlider::leaveEvent(QEvent *event)
+{
+    emit hoverLeft();
+    QSlider::leaveEvent(event);
+}
+
+int ClickableSlider::eventPosition(const QMouseEvent *event) const
+{
+    const QPoint position = event->position().toPoint();
+    return (orientation() == Qt::Horizontal) ? position.x() : position.y();
+}
+
 int ClickableSlider::calculateValueFromPosition(int position) const
 {
     // Safety checks
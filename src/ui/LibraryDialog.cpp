@@ -0,0 +1,288 @@
+#include "ui/LibraryDialog.h"
+#include "core/Application.h"
+#include "core/ConfigManager.h"
+#include "media/MediaLibrary.h"
+#include "media/MetadataCache.h"
+
+#include <QComboBox>
+#include <QDir>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace DarkPlay::UI {
+
+namespace {
+
+enum Column { NameColumn, DurationColumn, FolderColumn };
+
+constexpr int PathRole = Qt::UserRole;
+
+} // namespace
+
+LibraryDialog::LibraryDialog(Media::MediaLibrary* library, QWidget* parent)
+    : QDialog(parent)
+    , m_library(library)
+    , m_matchCount(0)
+    , m_searchUs(0)
+{
+    setWindowTitle(tr("Media Library"));
+    resize(760, 520);
+
+    auto* layout = new QVBoxLayout(this);
+
+    auto* filterLayout = new QHBoxLayout();
+    m_searchEdit = new QLineEdit(this);
+    m_searchEdit->setPlaceholderText(tr("Search file names..."));
+    m_searchEdit->setClearButtonEnabled(true);
+    m_typeCombo = new QComboBox(this);
+    m_typeCombo->addItem(tr("Audio and video"), static_cast<int>(Media::MediaType::Unknown));
+    m_typeCombo->addItem(tr("Video"), static_cast<int>(Media::MediaType::Video));
+    m_typeCombo->addItem(tr("Audio"), static_cast<int>(Media::MediaType::Audio));
+    m_folderCombo = new QComboBox(this);
+    m_folderCombo->setMinimumContentsLength(20);
+    m_folderCombo->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    filterLayout->addWidget(m_searchEdit, 1);
+    filterLayout->addWidget(m_typeCombo);
+    filterLayout->addWidget(m_folderCombo);
+    layout->addLayout(filterLayout);
+
+    m_results = new QTreeWidget(this);
+    m_results->setColumnCount(3);
+    m_results->setHeaderLabels({tr("Name"), tr("Duration"), tr("Folder")});
+    m_results->setRootIsDecorated(false);
+    m_results->setUniformRowHeights(true);
+    m_results->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_results->header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    m_results->header()->setSectionResizeMode(DurationColumn, QHeaderView::ResizeToContents);
+    m_results->header()->setSectionResizeMode(FolderColumn, QHeaderView::Interactive);
+    layout->addWidget(m_results, 1);
+
+    m_statusLabel = new QLabel(this);
+    layout->addWidget(m_statusLabel);
+
+    auto* buttonLayout = new QHBoxLayout();
+    m_addFolderButton = new QPushButton(tr("Add Folder..."), this);
+    m_removeFolderButton = new QPushButton(tr("Remove Folder"), this);
+    m_rescanButton = new QPushButton(tr("Rescan"), this);
+    m_enqueueButton = new QPushButton(tr("Add to Playlist"), this);
+    m_playButton = new QPushButton(tr("Play"), this);
+    m_playButton->setDefault(true);
+    buttonLayout->addWidget(m_addFolderButton);
+    buttonLayout->addWidget(m_removeFolderButton);
+    buttonLayout->addWidget(m_rescanButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_enqueueButton);
+    buttonLayout->addWidget(m_playButton);
+    layout->addLayout(buttonLayout);
+
+    m_durationTimer.setSingleShot(true);
+    m_durationTimer.setInterval(DURATION_DELAY_MS);
+    connect(&m_durationTimer, &QTimer::timeout, this, &LibraryDialog::fillDurations);
+
+    connect(m_searchEdit, &QLineEdit::textChanged, this, &LibraryDialog::search);
+    connect(m_typeCombo, &QComboBox::currentIndexChanged, this, &LibraryDialog::search);
+    connect(m_folderCombo, &QComboBox::currentIndexChanged, this, [this]() {
+        m_removeFolderButton->setEnabled(m_folderCombo->currentIndex() > 0);
+        search();
+    });
+    connect(m_addFolderButton, &QPushButton::clicked, this, &LibraryDialog::addFolder);
+    connect(m_removeFolderButton, &QPushButton::clicked, this, &LibraryDialog::removeFolder);
+    connect(m_rescanButton, &QPushButton::clicked, m_library, &Media::MediaLibrary::rescan);
+    connect(m_playButton, &QPushButton::clicked, this, [this]() {
+        if (const QStringList paths = selectedPaths(); !paths.isEmpty()) {
+            emit playRequested(paths);
+        }
+    });
+    connect(m_enqueueButton, &QPushButton::clicked, this, [this]() {
+        if (const QStringList paths = selectedPaths(); !paths.isEmpty()) {
+            emit enqueueRequested(paths);
+        }
+    });
+    connect(m_results, &QTreeWidget::itemActivated, this, [this](QTreeWidgetItem* item) {
+        emit playRequested({item->data(NameColumn, PathRole).toString()});
+    });
+    connect(m_results, &QTreeWidget::itemSelectionChanged, this, [this]() {
+        const bool hasSelection = !m_results->selectedItems().isEmpty();
+        m_playButton->setEnabled(hasSelection);
+        m_enqueueButton->setEnabled(hasSelection);
+    });
+
+    connect(m_library, &Media::MediaLibrary::contentsChanged, this, &LibraryDialog::search);
+    connect(m_library, &Media::MediaLibrary::scanningChanged, this, &LibraryDialog::updateStatus);
+    connect(Media::MetadataCache::instance(), &Media::MetadataCache::infoAvailable,
+            this, &LibraryDialog::onInfoAvailable);
+
+    m_playButton->setEnabled(false);
+    m_enqueueButton->setEnabled(false);
+    updateFolders();
+    search();
+}
+
+void LibraryDialog::search()
+{
+    Media::LibraryQuery query;
+    query.text = m_searchEdit->text();
+    query.type = static_cast<Media::MediaType>(m_typeCombo->currentData().toInt());
+    query.folder = m_folderCombo->currentData().toString();
+    query.limit = RESULT_LIMIT;
+    const Media::LibrarySearchResult result = m_library->search(query);
+    m_matchCount = result.matchCount;
+    m_searchUs = result.elapsedUs;
+
+    // Keep the selection across refreshes while the library is still filling up
+    QSet<QString> selected;
+    for (const QTreeWidgetItem* item : m_results->selectedItems()) {
+        selected.insert(item->data(NameColumn, PathRole).toString());
+    }
+
+    m_results->setUpdatesEnabled(false);
+    m_results->clear();
+    m_rowsByPath.clear();
+    QList<QTreeWidgetItem*> items;
+    items.reserve(result.entries.size());
+    for (const Media::LibraryEntry& entry : result.entries) {
+        auto* item = new QTreeWidgetItem();
+        item->setText(NameColumn, entry.name);
+        item->setData(NameColumn, PathRole, entry.path);
+        item->setToolTip(NameColumn, QDir::toNativeSeparators(entry.path));
+        item->setText(FolderColumn, QDir::toNativeSeparators(entry.path.left(entry.path.size() - entry.name.size() - 1)));
+        items.append(item);
+        m_rowsByPath.insert(entry.path, item);
+    }
+    m_results->addTopLevelItems(items);
+    for (QTreeWidgetItem* item : std::as_const(items)) {
+        if (selected.contains(item->data(NameColumn, PathRole).toString())) {
+            item->setSelected(true);
+        }
+    }
+    m_results->setUpdatesEnabled(true);
+
+    updateStatus();
+    m_durationTimer.start();
+}
+
+void LibraryDialog::fillDurations()
+{
+    auto* cache = Media::MetadataCache::instance();
+    QStringList missing;
+    const int rows = qMin(DURATION_ROWS, m_results->topLevelItemCount());
+    for (int row = 0; row < rows; ++row) {
+        QTreeWidgetItem* item = m_results->topLevelItem(row);
+        if (!item->text(DurationColumn).isEmpty()) {
+            continue;
+        }
+        const QString path = item->data(NameColumn, PathRole).toString();
+        if (const auto info = cache->lookup(path)) {
+            item->setText(DurationColumn, Media::MetadataCache::formatDuration(info->durationMs));
+        } else {
+            missing.append(path);
+        }
+    }
+    // Probed in the background; onInfoAvailable() fills the rows in
+    cache->prefetch(missing);
+}
+
+void LibraryDialog::onInfoAvailable(const QString& filePath, const Media::MediaInfo& info)
+{
+    if (QTreeWidgetItem* item = m_rowsByPath.value(filePath)) {
+        item->setText(DurationColumn, Media::MetadataCache::formatDuration(info.durationMs));
+    }
+}
+
+void LibraryDialog::addFolder()
+{
+    const QString folder = QFileDialog::getExistingDirectory(
+        this, tr("Add Folder to Library"), QStandardPaths::writableLocation(QStandardPaths::MoviesLocation));
+    if (folder.isEmpty()) {
+        return;
+    }
+
+    QStringList folders = m_library->folders();
+    folders.append(folder);
+    setFolders(folders);
+}
+
+void LibraryDialog::removeFolder()
+{
+    const QString folder = m_folderCombo->currentData().toString();
+    if (folder.isEmpty()) {
+        return;
+    }
+
+    QStringList folders = m_library->folders();
+    folders.removeAll(folder);
+    setFolders(folders);
+}
+
+void LibraryDialog::setFolders(const QStringList& folders)
+{
+    // The controller follows library/folders and hands the list to the library
+    if (auto* app = Core::Application::instance(); app && app->configManager()) {
+        app->configManager()->setValue("library/folders", folders);
+    } else {
+        m_library->setFolders(folders);
+    }
+    updateFolders();
+    search();
+}
+
+void LibraryDialog::updateFolders()
+{
+    const QString current = m_folderCombo->currentData().toString();
+
+    const QSignalBlocker blocker(m_folderCombo);
+    m_folderCombo->clear();
+    m_folderCombo->addItem(tr("All folders"), QString());
+    for (const QString& folder : m_library->folders()) {
+        m_folderCombo->addItem(QDir::toNativeSeparators(folder), folder);
+    }
+    const int index = m_folderCombo->findData(current);
+    m_folderCombo->setCurrentIndex(index >= 0 ? index : 0);
+    m_removeFolderButton->setEnabled(m_folderCombo->currentIndex() > 0);
+}
+
+void LibraryDialog::updateStatus()
+{
+    QString text;
+    if (m_library->folders().isEmpty()) {
+        text = tr("Add a folder to start the library.");
+    } else {
+        text = tr("%1 files, %2 matches in %3 ms")
+                   .arg(m_library->count())
+                   .arg(m_matchCount)
+                   .arg(m_searchUs / 1000.0, 0, 'f', 1);
+        if (m_matchCount > RESULT_LIMIT) {
+            text += tr(" (first %1 shown)").arg(RESULT_LIMIT);
+        }
+        if (m_library->isScanning()) {
+            text += tr(", scanning...");
+        }
+        if (m_library->unwatchedDirectories() > 0) {
+            text += tr(", %1 folders not watched").arg(m_library->unwatchedDirectories());
+        }
+    }
+    m_statusLabel->setText(text);
+}
+
+QStringList LibraryDialog::selectedPaths() const
+{
+    // In result order rather than click order
+    QStringList paths;
+    for (int row = 0; row < m_results->topLevelItemCount(); ++row) {
+        const QTreeWidgetItem* item = m_results->topLevelItem(row);
+        if (item->isSelected()) {
+            paths.append(item->data(NameColumn, PathRole).toString());
+        }
+    }
+    return paths;
+}
+
+} // namespace DarkPlay::UI
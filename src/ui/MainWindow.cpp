@@ -1,18 +1,32 @@
 #include "ui/MainWindow.h"
 #include "ui/ClickableSlider.h"
+#include "ui/LibraryDialog.h"
+#include "ui/SeekPreviewPopup.h"
 #include "ui/SettingDialog.h"
+#include "ui/StatsOverlay.h"
+#include "ui/VideoRenderWidget.h"
+#include "ui/VideoWall.h"
 #include "controllers/MediaController.h"
+#include "controllers/RemoteControl.h"
 #include "core/Application.h"
 #include "core/ConfigManager.h"
 #include "core/PluginManager.h"
+#include "core/StartupProfiler.h"
 #include "core/ThemeManager.h"
 #include "media/IMediaEngine.h"
-#include "media/QtMediaEngine.h"
+#include "media/MetadataCache.h"
+#include "media/Playlist.h"
+#include "media/SubtitleService.h"
+#include "media/ThumbnailService.h"
+#include "utils/AllocationCounter.h"
+#include "utils/Trace.h"
 
 #include <QActionGroup>
 #include <QApplication>
 #include <QCloseEvent>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QKeyEvent>
@@ -23,6 +37,9 @@
 #include <QResizeEvent>
 #include <QStandardPaths>
 #include <QStatusBar>
+#include <QStyle>
+#include <QUrl>
+#include <algorithm>
 #include <stdexcept>
 
 
@@ -31,6 +48,7 @@ namespace DarkPlay::UI {
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_app(Core::Application::instance())
+    , m_remoteControl(nullptr)
     , m_centralWidget(nullptr)
     , m_mainLayout(nullptr)
     , m_videoWidget(nullptr)
@@ -61,7 +79,7 @@ MainWindow::MainWindow(QWidget *parent)
     , m_fullScreenPlayPauseButton(nullptr)
     , m_fullScreenProgressSlider(nullptr)
     , m_fullScreenVolumeSlider(nullptr)
-    , m_updateTimer(std::make_unique<QTimer>(this))
+    , m_playbackUiTimer(std::make_unique<QTimer>(this))
     , m_controlsHideTimer(std::make_unique<QTimer>(this))
     , m_mouseMoveDebounceTimer(std::make_unique<QTimer>(this))
 {
@@ -73,16 +91,19 @@ MainWindow::MainWindow(QWidget *parent)
     // Initialize with exception safety
     try {
         // Create media controller first as it's needed by UI setup
-        m_mediaController = std::make_unique<Controllers::MediaController>(this);
+        {
+            Core::StartupProfiler::ScopedPhase phase(m_app->startupProfiler(), "MediaController");
+            m_mediaController = std::make_unique<Controllers::MediaController>(this);
+        }
+        m_remoteControl = new Controllers::RemoteControl(m_mediaController.get(), this);
 
         setupUI();
         setupMenuBar();
         setupStatusBar();
         connectSignals();
+        connectRemoteControl();
+        setupPlaybackUiRefresh();
         loadSettings();
-
-        // Start update timer
-        m_updateTimer->start(UPDATE_INTERVAL_MS);
         
     } catch (const std::exception& e) {
         qCritical() << "Failed to initialize MainWindow:" << e.what();
@@ -98,13 +119,8 @@ MainWindow::~MainWindow()
     m_isDestructing = true;
     m_sliderUpdatesEnabled = false;
 
-    // Lock mutex to ensure no slider operations are in progress
-    std::lock_guard<std::recursive_mutex> lock(m_sliderMutex);
-
-    // Stop timer first to prevent callbacks during destruction
-    if (m_updateTimer) {
-        m_updateTimer->stop();
-    }
+    // Stop the playback UI refresh first to prevent ticks during destruction
+    m_playbackUiTimer->stop();
 
     try {
         saveSettings();
@@ -134,10 +150,10 @@ void MainWindow::setupUI()
 
 void MainWindow::setupVideoWidget()
 {
-    m_videoWidget = new QVideoWidget(this);
+    // OpenGL renderer: frames are uploaded in their native YUV layout and converted on the GPU
+    m_videoWidget = new VideoRenderWidget(this);
     m_videoWidget->setMinimumSize(480, 270); // 16:9 aspect ratio minimum
     m_videoWidget->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    m_videoWidget->setStyleSheet("background-color: black;");
 
     // Enable mouse tracking for fullscreen controls
     m_videoWidget->setMouseTracking(true);
@@ -145,10 +161,43 @@ void MainWindow::setupVideoWidget()
     // Add video widget to main layout with higher stretch factor
     m_mainLayout->addWidget(m_videoWidget, 100); // Higher stretch factor
 
+    // Frame timing overlay, hidden until toggled
+    m_statsOverlay = new StatsOverlay(m_videoWidget);
+    m_statsOverlay->move(STATS_OVERLAY_MARGIN, STATS_OVERLAY_MARGIN);
+
+    m_seekPreview = new SeekPreviewPopup(this);
+
     // CRITICAL FIX: Connect video widget to media controller
     if (m_mediaController) {
         connectVideoOutput();
         optimizeVideoWidgetRendering();
+
+        connect(m_videoWidget, &VideoRenderWidget::framePresented, this, [this](qint64 presentationTimeUs) {
+            if (m_mediaController) {
+                m_mediaController->reportFramePresented(presentationTimeUs);
+            }
+        });
+        m_statsOverlay->setStatsProvider([this]() {
+            return m_mediaController ? m_mediaController->frameStats() : Media::FrameStats{};
+        });
+        m_statsOverlay->setStreamingStatsProvider([this]() {
+            return m_mediaController ? m_mediaController->streamingStats() : Media::StreamingStats{};
+        });
+        // The UI line is only meaningful where allocations are counted
+        if (Utils::AllocationCounter::isEnabled()) {
+            m_statsOverlay->setUiStatsProvider([this]() {
+                return UiRefreshStats{m_playbackUiAllocationsPerSecond, m_playbackUiUpdatesPerSecond};
+            });
+        }
+        m_statsOverlay->setMemoryStatsProvider([this]() {
+            return m_mediaController ? m_mediaController->memoryStats() : Utils::MemoryStats{};
+        });
+        m_statsOverlay->setFanoutStatsProvider([this]() {
+            return m_mediaController ? m_mediaController->videoFanoutStats() : Media::VideoFanoutStats{};
+        });
+        m_statsOverlay->setClockStatsProvider([this]() {
+            return m_mediaController ? m_mediaController->clockStats() : Media::ClockStats{};
+        });
     }
 }
 
@@ -175,6 +224,7 @@ void MainWindow::setupMediaControls()
     m_currentTimeLabel->setObjectName("timeLabel");
     m_currentTimeLabel->setMinimumWidth(50);
     m_currentTimeLabel->setAlignment(Qt::AlignCenter);
+    m_currentTimeLabel->setTextFormat(Qt::PlainText);
 
     // Create position slider - remove custom styling, use theme
     m_positionSlider = std::make_unique<ClickableSlider>(Qt::Horizontal, this);
@@ -186,6 +236,7 @@ void MainWindow::setupMediaControls()
     m_totalTimeLabel->setObjectName("timeLabel");
     m_totalTimeLabel->setMinimumWidth(50);
     m_totalTimeLabel->setAlignment(Qt::AlignCenter);
+    m_totalTimeLabel->setTextFormat(Qt::PlainText);
 
     // Add to progress layout
     m_progressLayout->addWidget(m_currentTimeLabel);
@@ -256,6 +307,10 @@ void MainWindow::setupMenuBar()
     openAction->setShortcut(QKeySequence::Open);
     connect(openAction, &QAction::triggered, this, &MainWindow::openFile);
 
+    auto* libraryAction = fileMenu->addAction("Media &Library...");
+    libraryAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_L));
+    connect(libraryAction, &QAction::triggered, this, &MainWindow::showLibrary);
+
     fileMenu->addSeparator();
 
     // Recent files submenu
@@ -289,6 +344,14 @@ void MainWindow::setupMenuBar()
         });
     }
 
+    viewMenu->addSeparator();
+
+    m_videoWallAction = viewMenu->addAction("Video &Wall");
+    m_videoWallAction->setCheckable(true);
+    m_videoWallAction->setShortcut(QKeySequence(Qt::CTRL | Qt::SHIFT | Qt::Key_W));
+    addAction(m_videoWallAction); // Shortcut must keep working while the menu bar is hidden in fullscreen
+    connect(m_videoWallAction, &QAction::toggled, this, &MainWindow::setVideoWallActive);
+
     // Tools menu
     auto* toolsMenu = menuBar()->addMenu("&Tools");
 
@@ -299,6 +362,29 @@ void MainWindow::setupMenuBar()
     auto* pluginManagerAction = toolsMenu->addAction("&Plugin Manager...");
     connect(pluginManagerAction, &QAction::triggered, this, &MainWindow::showPluginManager);
 
+    m_statsAction = toolsMenu->addAction("Playback &Statistics");
+    m_statsAction->setCheckable(true);
+    m_statsAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_I));
+    addAction(m_statsAction); // Shortcut must keep working while the menu bar is hidden in fullscreen
+    connect(m_statsAction, &QAction::toggled, this, &MainWindow::setStatsOverlayVisible);
+
+    // Only builds with DARKPLAY_ENABLE_TRACING record anything
+    if (Utils::Trace::isEnabled()) {
+        auto* traceAction = toolsMenu->addAction("Save &Trace...");
+        connect(traceAction, &QAction::triggered, this, [this]() {
+            const QString path = QFileDialog::getSaveFileName(this, "Save Trace",
+                QDir::home().filePath("darkplay-trace.json"), "Chrome trace (*.json)");
+            if (path.isEmpty()) {
+                return;
+            }
+            if (Utils::Trace::dump(path)) {
+                statusBar()->showMessage(QString("Trace saved to %1").arg(path), 3000);
+            } else {
+                QMessageBox::warning(this, "Save Trace", QString("Could not write the trace to %1").arg(path));
+            }
+        });
+    }
+
     toolsMenu->addSeparator();
 
     // Auto-play toggle
@@ -306,12 +392,12 @@ void MainWindow::setupMenuBar()
     autoPlayAction->setCheckable(true);
 
     // Load current auto-play setting
-    bool autoPlay = m_app->configManager()->getValue("playback/autoPlay", true).toBool();
+    bool autoPlay = m_app->configManager()->value(Core::ConfigKeys::AutoPlay);
     autoPlayAction->setChecked(autoPlay);
 
     connect(autoPlayAction, &QAction::triggered, [this](bool checked) {
         if (auto* configManager = m_app->configManager()) {
-            configManager->setValue("playback/autoPlay", checked);
+            configManager->setValue(Core::ConfigKeys::AutoPlay, checked);
             QString message = checked ? "Auto-play enabled" : "Auto-play disabled";
             statusBar()->showMessage(message, 2000);
         }
@@ -347,15 +433,28 @@ void MainWindow::connectSignals()
         return;
     }
 
-    // Media controller signals
-    connect(m_mediaController.get(), &Controllers::MediaController::positionChanged,
-            this, &MainWindow::onPositionChanged);
+    // Media controller signals - position is picked up by the playback UI refresh
     connect(m_mediaController.get(), &Controllers::MediaController::durationChanged,
             this, &MainWindow::onDurationChanged);
     connect(m_mediaController.get(), &Controllers::MediaController::stateChanged,
             this, &MainWindow::onStateChanged);
     connect(m_mediaController.get(), &Controllers::MediaController::errorOccurred,
             this, &MainWindow::onErrorOccurred);
+    if (auto* mediaManager = m_mediaController->mediaManager()) {
+        connect(mediaManager, &Media::MediaManager::bufferingProgress, this, [this](int progress) {
+            if (m_mediaController && m_mediaController->state() == Media::PlaybackState::Buffering) {
+                statusBar()->showMessage(QString("Buffering... %1%").arg(progress));
+            }
+        });
+    }
+    // Subtitles are drawn by the renderer, over the picture
+    if (auto* subtitles = m_mediaController->subtitleService()) {
+        connect(subtitles, &Media::SubtitleService::textChanged, this, [this](const QString& html) {
+            if (m_videoWidget) {
+                m_videoWidget->setSubtitleText(html);
+            }
+        });
+    }
 
     // UI control signals
     connect(m_openFileButton, &QPushButton::clicked, this, &MainWindow::openFile);
@@ -368,28 +467,35 @@ void MainWindow::connectSignals()
         m_isSeekingByUser = true;
     });
 
-    connect(m_positionSlider.get(), &QSlider::sliderReleased, [this]() {
-        m_isSeekingByUser = false;
-        // Perform seek only when user releases the slider
+    // Scrub while dragging: throttled keyframe seeks, then one exact seek on release
+    connect(m_positionSlider.get(), &QSlider::sliderMoved, [this](int value) {
         if (m_mediaController) {
-            m_mediaController->seek(m_positionSlider->value());
+            m_mediaController->scrubTo(value);
         }
     });
 
-    // Handle clicks on the slider track (instant seeking)
-    connect(m_positionSlider.get(), &QSlider::sliderMoved, [this](int value) {
-        // This allows instant seeking when user clicks on the track
-        if (m_mediaController && m_isSeekingByUser) {
-            m_mediaController->seek(value);
+    connect(m_positionSlider.get(), &QSlider::sliderReleased, [this]() {
+        m_isSeekingByUser = false;
+        hideSeekPreview();
+        if (m_mediaController) {
+            m_mediaController->endScrub(m_positionSlider->value());
         }
     });
 
+    // The thumbnail preview follows the handle ahead of the scrub seeks
+    connectSeekPreview(m_positionSlider.get());
+
+    // Background probes fill in recent-file durations as they complete
+    connect(Media::MetadataCache::instance(), &Media::MetadataCache::infoAvailable,
+            this, [this](const QString& filePath) {
+                if (m_recentFiles.contains(filePath)) {
+                    updateRecentFilesMenu();
+                }
+            });
+
     // Volume slider signal
     connect(m_volumeSlider, &QSlider::valueChanged, this, &MainWindow::onVolumeChanged);
 
-    // Update timer
-    connect(m_updateTimer.get(), &QTimer::timeout, this, &MainWindow::updateTimeLabels);
-
     // Controls hide timer for fullscreen mode
     m_controlsHideTimer->setSingleShot(true);
     // Disconnect any existing connections before reconnecting to prevent duplicates
@@ -458,7 +564,7 @@ void MainWindow::openFile()
             configManager->setValue("files/lastDirectory", fileInfo.absolutePath());
 
             // Auto-play feature: automatically start playback if enabled
-            bool autoPlay = configManager->getValue("playback/autoPlay", true).toBool();
+            bool autoPlay = configManager->value(Core::ConfigKeys::AutoPlay);
             if (autoPlay) {
                 // SAFE: Use QPointer to protect against object deletion
                 QPointer<MainWindow> safeThis = this;
@@ -499,7 +605,7 @@ void MainWindow::openRecentFile()
 
         // Auto-play feature for recent files too
         if (auto* configManager = m_app->configManager()) {
-            bool autoPlay = configManager->getValue("playback/autoPlay", true).toBool();
+            bool autoPlay = configManager->value(Core::ConfigKeys::AutoPlay);
             if (autoPlay) {
                 // SAFE: Use QPointer to protect against object deletion
                 QPointer<MainWindow> safeThis = this;
@@ -518,7 +624,7 @@ void MainWindow::openRecentFile()
         // Remove invalid file from recent files
         m_recentFiles.removeAll(fileName);
         if (auto* configManager = m_app->configManager()) {
-            configManager->setValue("files/recentFiles", m_recentFiles);
+            configManager->setValue(Core::ConfigKeys::RecentFiles, m_recentFiles);
         }
         updateRecentFilesMenu();
         statusBar()->showMessage(tr("Failed to load: %1").arg(QFileInfo(fileName).fileName()), 3000);
@@ -529,11 +635,51 @@ void MainWindow::clearRecentFiles()
 {
     m_recentFiles.clear();
     if (auto* configManager = m_app->configManager()) {
-        configManager->setValue("files/recentFiles", m_recentFiles);
+        configManager->setValue(Core::ConfigKeys::RecentFiles, m_recentFiles);
     }
     updateRecentFilesMenu();
 }
 
+void MainWindow::showLibrary()
+{
+    if (!m_mediaController || !m_mediaController->library()) return;
+
+    if (!m_libraryDialog) {
+        m_libraryDialog = new LibraryDialog(m_mediaController->library(), this);
+        connect(m_libraryDialog, &LibraryDialog::playRequested, this, [this](const QStringList& filePaths) {
+            addLibraryFiles(filePaths, true);
+        });
+        connect(m_libraryDialog, &LibraryDialog::enqueueRequested, this, [this](const QStringList& filePaths) {
+            addLibraryFiles(filePaths, false);
+        });
+    }
+    m_libraryDialog->show();
+    m_libraryDialog->raise();
+    m_libraryDialog->activateWindow();
+}
+
+void MainWindow::addLibraryFiles(const QStringList& filePaths, bool playNow)
+{
+    auto* mediaManager = m_mediaController ? m_mediaController->mediaManager() : nullptr;
+    if (!mediaManager || filePaths.isEmpty()) return;
+
+    QStringList urls;
+    urls.reserve(filePaths.size());
+    for (const QString& filePath : filePaths) {
+        urls.append(QUrl::fromLocalFile(filePath).toString());
+    }
+
+    auto* playlist = mediaManager->playlist();
+    const int first = playlist->count();
+    playlist->append(urls);
+
+    // Enqueued files only start on their own when nothing was playing
+    if (playNow || !m_mediaController->hasMedia()) {
+        mediaManager->setCurrentIndex(first);
+        m_mediaController->play();
+    }
+}
+
 void MainWindow::togglePlayPause()
 {
     if (!m_mediaController) return;
@@ -596,280 +742,11 @@ void MainWindow::nextTrack()
     statusBar()->showMessage("Next track - Playlist functionality coming soon", 2000);
 }
 
-void MainWindow::onPositionChanged(qint64 position)
-{
-    // ULTIMATE CRASH PROTECTION: Check atomic flags first
-    if (m_isDestructing.load() || !m_sliderUpdatesEnabled.load()) {
-        return; // Silently ignore updates during destruction or when disabled
-    }
-
-    // Lock mutex to ensure thread safety
-    std::lock_guard<std::recursive_mutex> lock(m_sliderMutex);
-
-    // Double-check flags after acquiring lock
-    if (m_isDestructing.load() || !m_sliderUpdatesEnabled.load()) {
-        return;
-    }
-
-    // THREAD-SAFE: Ultra-safe regular position slider update
-    if (!m_isSeekingByUser && m_positionSlider) {
-        try {
-            // CRITICAL VALIDATION: Check if slider object is valid before any operations
-            if (!m_positionSlider) {
-                return;
-            }
-
-            // Additional safety checks for regular slider with widget validity
-            if (m_positionSlider->isVisible() &&
-                m_positionSlider->isEnabled() &&
-                !m_positionSlider->signalsBlocked()) {
-
-                // Get slider range safely with exception handling
-                int minVal = 0, maxVal = 100;
-                try {
-                    minVal = m_positionSlider->minimum();
-                    maxVal = m_positionSlider->maximum();
-                } catch (...) {
-                    // Silent fallback to defaults
-                }
-
-                // CRITICAL FIX: Validate that the slider has a valid range before setValue
-                if (maxVal <= minVal) {
-                    return;
-                }
-
-                // Validate position value within acceptable bounds
-                int newValue = static_cast<int>(position);
-                if (newValue >= minVal && newValue <= maxVal) {
-                    // ULTIMATE SAFETY: Use QMetaObject::invokeMethod with QPointer protection
-                    QPointer<ClickableSlider> safeSlider(m_positionSlider.get()); // Используем .get()
-                    QMetaObject::invokeMethod(this, [safeSlider, newValue, this]() {
-                        // Triple-check everything is still valid inside the queued call
-                        if (!m_isDestructing.load() && m_sliderUpdatesEnabled.load() &&
-                            safeSlider && !safeSlider.isNull() && safeSlider.data() &&
-                            !m_isSeekingByUser &&
-                            safeSlider->isVisible() && safeSlider->isEnabled()) {
-
-                            // FINAL SAFETY CHECK: Validate range again before setValue
-                            try {
-                                int currentMin = safeSlider->minimum();
-                                int currentMax = safeSlider->maximum();
-
-                                if (currentMax > currentMin && newValue >= currentMin && newValue <= currentMax) {
-                                    safeSlider->setValue(newValue);
-                                }
-                            } catch (const std::exception& e) {
-                                // Silent error handling - just skip the update
-                            } catch (...) {
-                                // Silent error handling - just skip the update
-                            }
-                        }
-                    }, Qt::QueuedConnection);
-                }
-            }
-        } catch (const std::exception& e) {
-            // Silent error handling - just skip the update
-        } catch (...) {
-            // Silent error handling - just skip the update
-        }
-    }
-
-    // THREAD-SAFE: Update fullscreen slider only when controls are visible and we're still valid
-    if (!m_isSeekingByUser && m_isFullScreen && m_controlsVisible &&
-        !m_isDestructing.load() && m_sliderUpdatesEnabled.load()) {
-
-        // Create completely isolated lambda with QPointer protection
-        auto safeUpdateLambda = [this, position]() {
-            // Ultra-safe checks with atomic flags
-            try {
-                // Verify we're still in valid state with atomic checks
-                if (m_isDestructing.load() || !m_sliderUpdatesEnabled.load() ||
-                    !m_isFullScreen || m_isSeekingByUser || !m_controlsVisible) {
-                    return;
-                }
-
-                // Lock for thread safety in lambda
-                std::lock_guard<std::recursive_mutex> lambdaLock(m_sliderMutex);
-
-                // Verify QPointer validity with multiple comprehensive checks
-                if (!m_fullScreenProgressSlider ||
-                    !m_fullScreenProgressSlider.data() ||
-                    m_fullScreenProgressSlider.isNull()) {
-                    return; // Silent return - expected when controls are hidden
-                }
-
-                // Check widget state safely
-                QWidget* sliderWidget = m_fullScreenProgressSlider.data();
-                if (!sliderWidget->isVisible() ||
-                    sliderWidget->signalsBlocked() ||
-                    !sliderWidget->isEnabled()) {
-                    return; // Silent return - normal when controls are hidden
-                }
-
-                // Verify parent overlay validity
-                if (!m_fullScreenControlsOverlay ||
-                    !m_fullScreenControlsOverlay.data() ||
-                    !m_fullScreenControlsOverlay->isVisible()) {
-                    return; // Silent return - overlay might be hidden
-                }
-
-                // Get slider range with exception protection
-                int minVal = 0, maxVal = 100;
-                try {
-                    minVal = m_fullScreenProgressSlider->minimum();
-                    maxVal = m_fullScreenProgressSlider->maximum();
-                } catch (...) {
-                    qDebug() << "onPositionChanged: Exception getting fullscreen slider range, using defaults";
-                }
-
-                // Validate position value
-                int newValue = static_cast<int>(position);
-                if (newValue < minVal || newValue > maxVal) {
-                    // Only log if the range seems reasonable (not default 0-100)
-                    if (maxVal > 100) {
-                        qDebug() << "onPositionChanged: Fullscreen position value" << newValue
-                                 << "is out of range [" << minVal << "," << maxVal << "]";
-                    }
-                    return;
-                }
-
-                // Final ultra-safe setValue with QPointer protection
-                QPointer<QWidget> safeWidget(sliderWidget);
-                QMetaObject::invokeMethod(sliderWidget, [safeWidget, newValue, this]() {
-                    try {
-                        // Ultimate validation inside the final queued call
-                        if (!m_isDestructing.load() && m_sliderUpdatesEnabled.load() &&
-                            safeWidget && safeWidget->isVisible() && safeWidget->isEnabled()) {
-
-                            // Use blockSignals to prevent recursive calls
-                            bool wasBlocked = safeWidget->signalsBlocked();
-                            safeWidget->blockSignals(true);
-
-                            // Safe casting and setValue call
-                            if (auto* slider = qobject_cast<QSlider*>(safeWidget.data())) {
-                                slider->setValue(newValue);
-                            } else if (auto* clickableSlider = qobject_cast<ClickableSlider*>(safeWidget.data())) {
-                                clickableSlider->setValue(newValue);
-                            }
-
-                            // Restore signal blocking state
-                            safeWidget->blockSignals(wasBlocked);
-                        }
-                    } catch (const std::exception& e) {
-                        qDebug() << "onPositionChanged: CRITICAL - Exception in final fullscreen setValue:" << e.what();
-                    } catch (...) {
-                        qDebug() << "onPositionChanged: CRITICAL - Unknown exception in final fullscreen setValue";
-                    }
-                }, Qt::QueuedConnection);
-
-            } catch (const std::exception& e) {
-                qDebug() << "onPositionChanged: Exception in fullscreen safe update lambda:" << e.what();
-            } catch (...) {
-                qDebug() << "onPositionChanged: Unknown exception in fullscreen safe update lambda";
-            }
-        };
-
-        // Execute the safe lambda with ultimate protection
-        try {
-            safeUpdateLambda();
-        } catch (...) {
-            qDebug() << "onPositionChanged: FATAL - Exception even in isolated fullscreen lambda execution";
-        }
-    }
-}
-
 void MainWindow::onDurationChanged(qint64 duration)
 {
-    // Regular duration slider update with basic safety
-    if (m_positionSlider) {
-        try {
-            m_positionSlider->setRange(0, static_cast<int>(duration));
-        } catch (const std::exception& e) {
-            qDebug() << "onDurationChanged: Exception in regular slider setRange:" << e.what();
-        } catch (...) {
-            qDebug() << "onDurationChanged: Unknown exception in regular slider setRange";
-        }
-    }
-
-    // OPTIMIZED CRASH PROTECTION: Update fullscreen slider range only when controls are visible
-    if (m_isFullScreen && m_controlsVisible) {
-        // Create a completely isolated lambda for range setting
-        auto safeRangeUpdateLambda = [this, duration]() {
-            try {
-                // Check if we're still in a valid state
-                if (!this || !m_isFullScreen || !m_controlsVisible) {
-                    return;
-                }
-
-                // Verify QPointer validity with multiple checks
-                if (!m_fullScreenProgressSlider ||
-                    !m_fullScreenProgressSlider.data() ||
-                    m_fullScreenProgressSlider.isNull()) {
-                    return; // Silent return - this is expected when controls are hidden
-                }
-
-                // Check if widget is being destroyed or in invalid state
-                QWidget* sliderWidget = m_fullScreenProgressSlider.data();
-                if (!sliderWidget->isVisible() ||
-                    sliderWidget->signalsBlocked() ||
-                    !sliderWidget->isEnabled()) {
-                    return; // Silent return - this is normal when controls are hidden
-                }
-
-                // Verify parent overlay is also valid
-                if (!m_fullScreenControlsOverlay ||
-                    !m_fullScreenControlsOverlay.data() ||
-                    !m_fullScreenControlsOverlay->isVisible()) {
-                    return; // Silent return - overlay might be hidden
-                }
-
-                // Validate duration value
-                int newMaxValue = static_cast<int>(duration);
-                if (newMaxValue < 0) {
-                    qDebug() << "onDurationChanged: Invalid duration value" << newMaxValue;
-                    return;
-                }
-
-                // Final ultra-safe setRange call with exception isolation
-                QMetaObject::invokeMethod(sliderWidget, [sliderWidget, newMaxValue]() {
-                    try {
-                        // Triple-check widget validity inside the final call
-                        if (sliderWidget && sliderWidget->isVisible() && sliderWidget->isEnabled()) {
-                            // Use blockSignals to prevent recursive calls
-                            bool wasBlocked = sliderWidget->signalsBlocked();
-                            sliderWidget->blockSignals(true);
-
-                            // Cast to QSlider safely and call setRange
-                            if (auto* slider = qobject_cast<QSlider*>(sliderWidget)) {
-                                slider->setRange(0, newMaxValue);
-                            } else if (auto* clickableSlider = qobject_cast<ClickableSlider*>(sliderWidget)) {
-                                clickableSlider->setRange(0, newMaxValue);
-                            }
-
-                            // Restore signal blocking state
-                            sliderWidget->blockSignals(wasBlocked);
-                        }
-                    } catch (const std::exception& e) {
-                        qDebug() << "onDurationChanged: CRITICAL - Exception in final setRange call:" << e.what();
-                    } catch (...) {
-                        qDebug() << "onDurationChanged: CRITICAL - Unknown exception in final setRange call";
-                    }
-                }, Qt::QueuedConnection);
-
-            } catch (const std::exception& e) {
-                qDebug() << "onDurationChanged: Exception in safe range update lambda:" << e.what();
-            } catch (...) {
-                qDebug() << "onDurationChanged: Unknown exception in safe range update lambda";
-            }
-        };
-
-        // Execute the safe lambda with additional protection
-        try {
-            safeRangeUpdateLambda();
-        } catch (...) {
-            qDebug() << "onDurationChanged: FATAL - Exception even in isolated lambda execution";
-        }
-    }
+    Q_UNUSED(duration)
+    // The snapshot carries it already; show it now rather than on the next tick
+    refreshPlaybackUi();
 }
 
 void MainWindow::onStateChanged(Media::PlaybackState state)
@@ -922,55 +799,158 @@ void MainWindow::onVolumeChanged(int value)
 
         // Save to config
         if (auto* configManager = m_app->configManager()) {
-            configManager->setValue("media/volume", volume);
+            configManager->setValue(Core::ConfigKeys::Volume, volume);
         }
     }
 }
 
 
-void MainWindow::updateTimeLabels()
+void MainWindow::refreshPlaybackUi()
 {
-    if (m_mediaController && m_mediaController->hasMedia()) {
-        QString currentTime = formatTime(m_mediaController->position());
-        QString totalTime = formatTime(m_mediaController->duration());
+    DARKPLAY_TRACE_SCOPE("ui", "refreshPlaybackUi");
 
-        // Update main window labels
-        if (m_currentTimeLabel) {
-            m_currentTimeLabel->setText(currentTime);
+    if (m_isDestructing || !m_mediaController) {
+        return;
+    }
+
+    // Runs 20 times a second: nothing below may allocate unless a widget changes
+    const Utils::AllocationCounter::Scope countAllocations;
+
+    const Media::PlaybackSnapshotPtr snapshot = m_mediaController->snapshot();
+    if (!m_playbackUi.valid || m_playbackUi.sequence != snapshot->sequence) {
+        const bool wasValid = m_playbackUi.valid;
+        m_playbackUi.valid = true;
+        m_playbackUi.sequence = snapshot->sequence;
+        bool changed = false;
+
+        // The overlay slider mirrors the main one; its own signals stay quiet
+        ClickableSlider* overlaySlider = m_isFullScreen && m_controlsVisible ? m_fullScreenProgressSlider.data() : nullptr;
+
+        if (!wasValid || m_playbackUi.duration != snapshot->duration) {
+            m_playbackUi.duration = snapshot->duration;
+            const int maximum = static_cast<int>(qMax<qint64>(0, snapshot->duration));
+            if (m_positionSlider) {
+                m_positionSlider->setRange(0, maximum);
+            }
+            if (overlaySlider) {
+                const QSignalBlocker blocker(overlaySlider);
+                overlaySlider->setRange(0, maximum);
+            }
+            changed = true;
         }
-        if (m_totalTimeLabel) {
-            m_totalTimeLabel->setText(totalTime);
+
+        if (m_sliderUpdatesEnabled && !m_isSeekingByUser) {
+            applyPlaybackPosition(m_positionSlider.get(), snapshot->position);
+            applyPlaybackPosition(overlaySlider, snapshot->position);
         }
 
-        // Update fullscreen labels if they exist
-        if (m_fullScreenCurrentTimeLabel) {
-            m_fullScreenCurrentTimeLabel->setText(currentTime);
+        // mm:ss only changes once a second
+        const qint64 positionSeconds = snapshot->position / 1000;
+        if (m_playbackUi.currentTime.seconds != positionSeconds) {
+            const QString& text = m_playbackUi.currentTime.update(snapshot->position);
+            m_currentTimeLabel->setText(text);
+            if (m_fullScreenCurrentTimeLabel) {
+                m_fullScreenCurrentTimeLabel->setText(text);
+            }
+            changed = true;
         }
-        if (m_fullScreenTotalTimeLabel) {
-            m_fullScreenTotalTimeLabel->setText(totalTime);
+        const qint64 durationSeconds = snapshot->duration / 1000;
+        if (m_playbackUi.totalTime.seconds != durationSeconds) {
+            const QString& text = m_playbackUi.totalTime.update(snapshot->duration);
+            m_totalTimeLabel->setText(text);
+            if (m_fullScreenTotalTimeLabel) {
+                m_fullScreenTotalTimeLabel->setText(text);
+            }
+            changed = true;
         }
 
-        // CRITICAL FIX: Periodically sync play/pause button state to prevent desync
-        // This ensures button state is correct even if signals are missed
-        static int updateCounter = 0;
-        updateCounter++;
-        if (updateCounter % 10 == 0) { // Every 10th update (roughly every second with default 100ms timer)
-            Media::PlaybackState currentState = m_mediaController->state();
-            QString expectedButtonText = (currentState == Media::PlaybackState::Playing) ? "⏸" : "▶";
-
-            // Check main button
-            if (m_playPauseButton && m_playPauseButton->text() != expectedButtonText) {
-                m_playPauseButton->setText(expectedButtonText);
-                qDebug() << "updateTimeLabels: Fixed main button desync to:" << expectedButtonText;
+        // Keeps the buttons right even if a state signal was missed
+        const bool playing = snapshot->state == Media::PlaybackState::Playing;
+        if (!wasValid || m_playbackUi.playing != playing) {
+            m_playbackUi.playing = playing;
+            const QString buttonText = playing ? QStringLiteral("⏸") : QStringLiteral("▶");
+            m_playPauseButton->setText(buttonText);
+            if (m_fullScreenPlayPauseButton) {
+                m_fullScreenPlayPauseButton->setText(buttonText);
             }
+            changed = true;
+        }
 
-            // Check fullscreen button
-            if (m_fullScreenPlayPauseButton && m_fullScreenPlayPauseButton->text() != expectedButtonText) {
-                m_fullScreenPlayPauseButton->setText(expectedButtonText);
-                qDebug() << "updateTimeLabels: Fixed fullscreen button desync to:" << expectedButtonText;
-            }
+        if (changed) {
+            ++m_playbackUiUpdates;
         }
     }
+
+    // Rates for the stats overlay; a tick that allocates without touching a widget is a regression
+    if (!m_playbackUiRateClock.isValid()) {
+        m_playbackUiRateClock.start();
+    } else if (const qint64 elapsed = m_playbackUiRateClock.elapsed(); elapsed >= 1000) {
+        const quint64 allocations = Utils::AllocationCounter::total();
+        m_playbackUiAllocationsPerSecond = (allocations - m_playbackUiAllocationsAtSample) * 1000 / elapsed;
+        m_playbackUiUpdatesPerSecond = (m_playbackUiUpdates - m_playbackUiUpdatesAtSample) * 1000 / elapsed;
+        m_playbackUiAllocationsAtSample = allocations;
+        m_playbackUiUpdatesAtSample = m_playbackUiUpdates;
+        m_playbackUiRateClock.restart();
+    }
+}
+
+void MainWindow::applyPlaybackPosition(ClickableSlider* slider, qint64 position)
+{
+    if (!slider || !slider->isVisible() || !slider->isEnabled() || slider->maximum() <= slider->minimum()) {
+        return;
+    }
+    const int value = static_cast<int>(position);
+    if (value < slider->minimum() || value > slider->maximum() || value == slider->value()) {
+        return;
+    }
+
+    // Only move the handle when it lands on another pixel; a long file would repaint every tick otherwise
+    const int span = slider->width();
+    if (QStyle::sliderPositionFromValue(slider->minimum(), slider->maximum(), value, span) ==
+        QStyle::sliderPositionFromValue(slider->minimum(), slider->maximum(), slider->value(), span)) {
+        return;
+    }
+
+    // The overlay slider's signals stay quiet while it mirrors playback
+    const QSignalBlocker blocker(slider != m_positionSlider.get() ? slider : nullptr);
+    slider->setValue(value);
+    ++m_playbackUiUpdates;
+}
+
+void MainWindow::setupPlaybackUiRefresh()
+{
+    // One GUI-thread tick reads the latest snapshot for sliders, labels and buttons alike
+    m_playbackUiTimer->setInterval(PLAYBACK_UI_INTERVAL_MS);
+    connect(m_playbackUiTimer.get(), &QTimer::timeout, this, &MainWindow::refreshPlaybackUi);
+    updatePlaybackUiRefresh();
+}
+
+void MainWindow::updatePlaybackUiRefresh()
+{
+    if (m_isDestructing) {
+        return;
+    }
+
+    // Nobody can see the controls - don't wake up for them
+    const bool controlsOnScreen = !isMinimized() && (!m_isFullScreen || m_controlsVisible);
+    if (!controlsOnScreen) {
+        m_playbackUiTimer->stop();
+        return;
+    }
+
+    // Widgets may have been rebuilt or hidden while playback moved on; catch up right away
+    invalidatePlaybackUi();
+    if (!m_playbackUiTimer->isActive()) {
+        m_playbackUiTimer->start();
+    }
+    refreshPlaybackUi();
+}
+
+void MainWindow::invalidatePlaybackUi()
+{
+    m_playbackUi.valid = false;
+    m_playbackUi.currentTime.seconds = -1;
+    m_playbackUi.totalTime.seconds = -1;
 }
 
 void MainWindow::updatePlayPauseButton()
@@ -1023,8 +1003,14 @@ void MainWindow::onThemeChanged(const QString& themeName)
     // Apply the new theme to the UI
     statusBar()->showMessage(QString("Theme changed to: %1").arg(themeName), 2000);
 
-    // The actual theme application is handled by the ThemeManager
-    // This slot just provides UI feedback
+    // The actual theme application is handled by the ThemeManager; only the
+    // overlay carries its own stylesheet, and restyling it is only worth it on a change
+    if (m_fullScreenControlsOverlay) {
+        const QString sheet = fullScreenStyleSheet();
+        if (m_fullScreenControlsOverlay->styleSheet() != sheet) {
+            m_fullScreenControlsOverlay->setStyleSheet(sheet);
+        }
+    }
     qDebug() << "Theme changed to:" << themeName;
 }
 
@@ -1037,11 +1023,7 @@ void MainWindow::updateRecentFilesMenu()
         emptyAction->setEnabled(false);
     } else {
         for (const QString& file : m_recentFiles) {
-            QFileInfo fileInfo(file);
-            auto* action = m_recentFilesMenu->addAction(fileInfo.fileName());
-            action->setData(file);
-            action->setToolTip(file);
-            connect(action, &QAction::triggered, this, &MainWindow::openRecentFile);
+            addRecentFileAction(m_recentFilesMenu, file);
         }
 
         m_recentFilesMenu->addSeparator();
@@ -1050,6 +1032,57 @@ void MainWindow::updateRecentFilesMenu()
     }
 }
 
+void MainWindow::addRecentFileAction(QMenu* menu, const QString& filePath)
+{
+    QFileInfo fileInfo(filePath);
+    QString text = fileInfo.fileName();
+    QString toolTip = filePath;
+
+    // Only what is already cached - menus must not wait on probes
+    if (const auto info = Media::MetadataCache::instance()->lookup(filePath)) {
+        if (info->durationMs > 0) {
+            text += QString("  (%1)").arg(Media::MetadataCache::formatDuration(info->durationMs));
+        }
+        if (info->resolution.isValid()) {
+            toolTip += QString("\n%1x%2").arg(info->resolution.width()).arg(info->resolution.height());
+        }
+        QStringList codecs;
+        for (const QString& codec : {info->videoCodec, info->audioCodec}) {
+            if (!codec.isEmpty()) {
+                codecs.append(codec);
+            }
+        }
+        if (!codecs.isEmpty()) {
+            toolTip += "\n" + codecs.join(" / ");
+        }
+    }
+
+    auto* action = menu->addAction(text);
+    action->setData(filePath);
+    action->setToolTip(toolTip);
+    connect(action, &QAction::triggered, this, &MainWindow::openRecentFile);
+}
+
+void MainWindow::connectRemoteControl()
+{
+    // Only local files go to the recent list; openRecentFile cannot reopen URLs
+    connect(m_remoteControl, &Controllers::RemoteControl::mediaOpened, this, [this](const QString& path) {
+        if (QFileInfo::exists(path)) {
+            addToRecentFiles(path);
+        }
+        statusBar()->showMessage(tr("Loaded: %1").arg(QFileInfo(path).fileName()), 3000);
+    });
+
+    connect(m_remoteControl, &Controllers::RemoteControl::activationRequested, this, [this]() {
+        if (isMinimized()) {
+            setWindowState(windowState() & ~Qt::WindowMinimized);
+        }
+        show();
+        raise();
+        activateWindow();
+    });
+}
+
 void MainWindow::addToRecentFiles(const QString& filePath)
 {
     m_recentFiles.removeAll(filePath); // Remove if already exists
@@ -1061,7 +1094,7 @@ void MainWindow::addToRecentFiles(const QString& filePath)
     }
 
     if (m_app && m_app->configManager()) {
-        m_app->configManager()->setValue("files/recentFiles", m_recentFiles);
+        m_app->configManager()->setValue(Core::ConfigKeys::RecentFiles, m_recentFiles);
     }
     updateRecentFilesMenu();
 }
@@ -1090,26 +1123,88 @@ void MainWindow::loadSettings()
     }
 
     // Recent files
-    m_recentFiles = configManager->getValue("files/recentFiles").toStringList();
+    m_recentFiles = configManager->value(Core::ConfigKeys::RecentFiles);
     updateRecentFilesMenu();
+    Media::MetadataCache::instance()->prefetch(m_recentFiles);
 
     // Volume - use MediaController instead of direct engine access
     float volume = configManager->getValue("media/volume", 0.85).toFloat(); // Increased from 0.7 to 0.85
     m_volumeSlider->setValue(static_cast<int>(volume * 100));
     if (m_mediaController) {
         m_mediaController->setVolume(volume);
+
+        // Gapless playlist transitions
+        if (auto* mediaManager = m_mediaController->mediaManager()) {
+            mediaManager->setPrerollEnabled(configManager->getValue("playback/gaplessPreroll", true).toBool());
+            mediaManager->setPrerollLeadTime(configManager->getValue("playback/prerollSeconds", 5).toInt());
+        }
+    }
+
+    applyStreamingSettings();
+}
+
+void MainWindow::applyStreamingSettings()
+{
+    if (!m_app || !m_app->configManager() || !m_mediaController || !m_mediaController->mediaManager()) {
+        return;
     }
+
+    auto* configManager = m_app->configManager();
+    constexpr qint64 MB = 1024 * 1024;
+
+    Media::StreamingOptions options;
+    options.readAheadBytes = configManager->getValue("network/readAheadMB", 32).toLongLong() * MB;
+    options.diskCacheBytes = configManager->getValue("network/diskCacheMB", 256).toLongLong() * MB;
+    options.adaptiveBitrate = configManager->getValue("network/adaptiveBitrate", true).toBool();
+    options.stallRecoveryMs = configManager->getValue("network/stallRecoverySeconds", 8).toInt() * 1000;
+    m_mediaController->mediaManager()->setStreamingOptions(options);
 }
 
 QString MainWindow::formatTime(qint64 milliseconds)
 {
-    qint64 seconds = milliseconds / 1000;
-    qint64 minutes = seconds / 60;
-    seconds %= 60;
+    std::array<QChar, TIME_TEXT_CAPACITY> text;
+    return QString(text.data(), formatTime(milliseconds, text.data()));
+}
 
-    return QString("%1:%2")
-        .arg(minutes, 2, 10, QChar('0'))
-        .arg(seconds, 2, 10, QChar('0'));
+qsizetype MainWindow::formatTime(qint64 milliseconds, QChar* out) noexcept
+{
+    const qint64 totalSeconds = qMax<qint64>(0, milliseconds) / 1000;
+    qint64 minutes = totalSeconds / 60;
+    const int seconds = static_cast<int>(totalSeconds % 60);
+
+    // Minutes take at least two digits and as many more as they need
+    std::array<char, 20> digits;
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + minutes % 10);
+        minutes /= 10;
+    } while (minutes > 0);
+    if (count < 2) {
+        digits[count++] = '0';
+    }
+
+    qsizetype length = 0;
+    while (count > 0) {
+        out[length++] = QLatin1Char(digits[--count]);
+    }
+    out[length++] = u':';
+    out[length++] = QLatin1Char(static_cast<char>('0' + seconds / 10));
+    out[length++] = QLatin1Char(static_cast<char>('0' + seconds % 10));
+    return length;
+}
+
+const QString& MainWindow::TimeText::update(qint64 milliseconds)
+{
+    seconds = milliseconds / 1000;
+
+    // The labels hold the buffer written last, so this one is ours alone and keeps its capacity
+    QString& buffer = buffers[next];
+    next ^= 1;
+    std::array<QChar, TIME_TEXT_CAPACITY> text;
+    const qsizetype length = formatTime(milliseconds, text.data());
+    buffer.resize(length);
+    std::copy_n(text.data(), length, buffer.data());
+    return buffer;
 }
 
 void MainWindow::resizeEvent(QResizeEvent *event)
@@ -1132,6 +1227,32 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
+    // Frame stepping, windowed and fullscreen alike
+    if ((event->key() == Qt::Key_Comma || event->key() == Qt::Key_Period) && m_mediaController) {
+        m_mediaController->stepFrame(event->key() == Qt::Key_Period ? 1 : -1);
+        if (m_isFullScreen) {
+            showFullScreenUI();
+        }
+        return;
+    }
+
+    // Playback speed; audio keeps its pitch while the DSP pipeline is available
+    if ((event->key() == Qt::Key_BracketLeft || event->key() == Qt::Key_BracketRight
+         || event->key() == Qt::Key_Backspace) && m_mediaController) {
+        auto* mediaManager = m_mediaController->mediaManager();
+        if (event->key() == Qt::Key_BracketLeft) {
+            mediaManager->decreaseSpeed();
+        } else if (event->key() == Qt::Key_BracketRight) {
+            mediaManager->increaseSpeed();
+        } else {
+            mediaManager->resetSpeed();
+        }
+        if (m_isFullScreen) {
+            showFullScreenUI();
+        }
+        return;
+    }
+
     if (m_isFullScreen) {
         switch (event->key()) {
         case Qt::Key_Escape:
@@ -1192,6 +1313,8 @@ void MainWindow::mouseDoubleClickEvent(QMouseEvent *event)
 
 void MainWindow::toggleFullScreen()
 {
+    DARKPLAY_TRACE_SCOPE("ui", "toggleFullScreen");
+
     if (m_isFullScreen) {
         // Exit fullscreen mode - CRITICAL: Set flag first to prevent race conditions
         m_isFullScreen = false;
@@ -1203,6 +1326,8 @@ void MainWindow::toggleFullScreen()
             disconnect(m_controlsHideTimer.get(), nullptr, this, nullptr);
         }
 
+        hideSeekPreview();
+
         // CRITICAL FIX: Safely destroy overlay with comprehensive cleanup
         if (m_fullScreenControlsOverlay) {
             // Block all signals from the overlay to prevent any callbacks during destruction
@@ -1277,6 +1402,7 @@ void MainWindow::toggleFullScreen()
                     m_controlsWidget->show();
                     m_controlsVisible = true;
                 }
+                updatePlaybackUiRefresh();
                 menuBar()->show();
                 statusBar()->show();
 
@@ -1298,6 +1424,7 @@ void MainWindow::toggleFullScreen()
 
                 // Re-enable slider updates AFTER everything is restored
                 m_sliderUpdatesEnabled = true;
+                invalidatePlaybackUi();
 
                 // Reconnect the timer after cleanup with safety checks
                 if (m_controlsHideTimer) {
@@ -1311,6 +1438,8 @@ void MainWindow::toggleFullScreen()
         });
     } else {
         // Enter fullscreen mode
+        QElapsedTimer entryTimer;
+        entryTimer.start();
         showFullScreen();
 
         // CRITICAL FIX: Set fullscreen flag BEFORE creating overlay
@@ -1344,8 +1473,10 @@ void MainWindow::toggleFullScreen()
 
         // Create fullscreen overlay controls AFTER setting m_isFullScreen = true
         createFullScreenOverlay();
+        qDebug() << "toggleFullScreen: Entered fullscreen in" << entryTimer.nsecsElapsed() / 1000 << "us";
 
         m_controlsVisible = false;
+        updatePlaybackUiRefresh();
 
         // Show controls briefly, then start hide timer with delay
         QTimer::singleShot(100, this, [this]() {
@@ -1411,6 +1542,107 @@ void MainWindow::leaveEvent(QEvent *event)
     QMainWindow::leaveEvent(event);
 }
 
+void MainWindow::changeEvent(QEvent *event)
+{
+    QMainWindow::changeEvent(event);
+
+    // Minimised windows don't need position updates at all
+    if (event->type() == QEvent::WindowStateChange) {
+        updatePlaybackUiRefresh();
+    }
+}
+
+void MainWindow::connectSeekPreview(ClickableSlider* slider)
+{
+    if (!slider) {
+        return;
+    }
+
+    connect(slider, &ClickableSlider::hoverMoved, this, [this, slider](int value, const QPoint& position) {
+        showSeekPreview(slider, value, position);
+    });
+    connect(slider, &ClickableSlider::hoverLeft, this, [this]() {
+        // A drag keeps its preview even when the cursor strays off the slider
+        if (!m_isSeekingByUser) {
+            hideSeekPreview();
+        }
+    });
+}
+
+void MainWindow::showSeekPreview(ClickableSlider* slider, int value, const QPoint& position)
+{
+    if (!m_seekPreview || !slider || m_isDestructing || slider->maximum() <= slider->minimum()) {
+        return;
+    }
+
+    QImage thumbnail;
+    if (m_mediaController) {
+        if (auto* thumbnails = m_mediaController->thumbnailService()) {
+            thumbnail = thumbnails->thumbnailAt(value);
+        }
+    }
+
+    const QPoint anchor = slider->mapToGlobal(QPoint(position.x(), 0));
+    m_seekPreview->showPreview(thumbnail, formatTime(value), anchor);
+}
+
+void MainWindow::hideSeekPreview()
+{
+    if (m_seekPreview) {
+        m_seekPreview->hide();
+    }
+}
+
+void MainWindow::setStatsOverlayVisible(bool visible)
+{
+    if (!m_statsOverlay) {
+        return;
+    }
+
+    m_statsOverlay->setVisible(visible);
+    if (visible) {
+        m_statsOverlay->raise();
+    }
+}
+
+void MainWindow::setVideoWallActive(bool active)
+{
+    if (!m_mediaController || !m_videoWidget) {
+        return;
+    }
+    auto* fanout = m_mediaController->videoFanout();
+
+    if (!m_videoWall) {
+        if (!active) {
+            return;
+        }
+        m_videoWall = new VideoWall(fanout, this);
+        connect(m_videoWall, &VideoWall::framePresented, this, [this](qint64 presentationTimeUs) {
+            if (m_mediaController) {
+                m_mediaController->reportFramePresented(presentationTimeUs);
+            }
+        });
+        // Also reached when Escape on a tile stops the wall without going through the action
+        connect(m_videoWall, &VideoWall::activeChanged, this, [this, fanout](bool wallActive) {
+            // The window would only draw what the tiles already show, and report it twice
+            if (wallActive) {
+                fanout->removeOutput(m_videoWidget->videoSink());
+            } else {
+                fanout->addOutput(m_videoWidget->videoSink());
+            }
+            if (m_videoWallAction) {
+                m_videoWallAction->setChecked(wallActive);
+            }
+        });
+    }
+
+    if (active) {
+        m_videoWall->start();
+    } else {
+        m_videoWall->stop();
+    }
+}
+
 void MainWindow::optimizeVideoWidgetRendering()
 {
     if (!m_videoWidget) {
@@ -1444,21 +1676,17 @@ void MainWindow::connectVideoOutput()
         return;
     }
 
-    // Get the current media engine
-    auto* mediaEngine = mediaManager->mediaEngine();
-    if (!mediaEngine) {
+    if (!mediaManager->hasEngine()) {
         qWarning() << "connectVideoOutput: Media engine not available";
         return;
     }
 
-    // Try to cast to QtMediaEngine to access setVideoSink method
-    if (auto* qtMediaEngine = dynamic_cast<Media::QtMediaEngine*>(mediaEngine)) {
-        // Set the video sink to connect video output to the widget
-        qtMediaEngine->setVideoSink(m_videoWidget->videoSink());
-        qDebug() << "connectVideoOutput: Video output connected successfully";
-    } else {
-        qWarning() << "connectVideoOutput: Media engine is not QtMediaEngine, cannot connect video output";
-    }
+    // The engine renders into the fanout, which hands each frame to the GL widget and any
+    // video wall tiles without copying; replacement engines pick up the same sink
+    auto* fanout = m_mediaController->videoFanout();
+    fanout->addOutput(m_videoWidget->videoSink());
+    mediaManager->setVideoSink(fanout->inputSink());
+    qDebug() << "connectVideoOutput: Video output connected";
 }
 
 void MainWindow::createFullScreenOverlay()
@@ -1511,7 +1739,7 @@ void MainWindow::createFullScreenOverlay()
     m_fullScreenControlsOverlay->setFocusPolicy(Qt::NoFocus);
 
     // Enhanced styling with modern media player design
-    m_fullScreenControlsOverlay->setStyleSheet(generateFullScreenStyleSheet());
+    m_fullScreenControlsOverlay->setStyleSheet(fullScreenStyleSheet());
 
     // Create layout for overlay
     auto* overlayLayout = new QVBoxLayout(m_fullScreenControlsOverlay);
@@ -1526,6 +1754,7 @@ void MainWindow::createFullScreenOverlay()
     currentTimeLabel->setObjectName("TimeLabel");
     currentTimeLabel->setMinimumWidth(55);
     currentTimeLabel->setAlignment(Qt::AlignCenter);
+    currentTimeLabel->setTextFormat(Qt::PlainText);
 
     auto* progressSlider = new ClickableSlider(Qt::Horizontal, m_fullScreenControlsOverlay);
     progressSlider->setObjectName("ProgressSlider");
@@ -1537,6 +1766,7 @@ void MainWindow::createFullScreenOverlay()
     totalTimeLabel->setObjectName("TimeLabel");
     totalTimeLabel->setMinimumWidth(55);
     totalTimeLabel->setAlignment(Qt::AlignCenter);
+    totalTimeLabel->setTextFormat(Qt::PlainText);
 
     m_fullScreenCurrentTimeLabel = currentTimeLabel;
     m_fullScreenTotalTimeLabel = totalTimeLabel;
@@ -1552,6 +1782,7 @@ void MainWindow::createFullScreenOverlay()
 
     connect(progressSlider, &QSlider::sliderReleased, [this]() {
         m_isSeekingByUser = false;
+        hideSeekPreview();
         // Perform seek when user releases the slider
         if (m_mediaController && m_fullScreenProgressSlider) {
             qint64 seekPosition = m_fullScreenProgressSlider->value();
@@ -1563,22 +1794,23 @@ void MainWindow::createFullScreenOverlay()
                 seekPosition = 0;
                 m_fullScreenProgressSlider->setValue(0);
                 // Also start playing automatically when seeking from end to beginning
+                m_mediaController->endScrub(seekPosition);
                 m_mediaController->play();
             } else {
-                m_mediaController->seek(seekPosition);
+                m_mediaController->endScrub(seekPosition);
             }
         }
         resetControlsHideTimer(); // Restart hide timer after seeking
     });
 
-    // Handle clicks on the slider track for instant seeking in fullscreen
+    // Scrubbing in fullscreen too; the exact seek happens on release
     connect(progressSlider, &QSlider::sliderMoved, [this](int value) {
-        // Allow instant seeking when user clicks on the track in fullscreen
-        if (m_mediaController && m_isSeekingByUser) {
-            m_mediaController->seek(value);
+        if (m_mediaController) {
+            m_mediaController->scrubTo(value);
         }
         resetControlsHideTimer(); // Keep controls visible during interaction
     });
+    connectSeekPreview(progressSlider);
 
     // Sync fullscreen slider range with main slider when available
     if (m_positionSlider) {
@@ -1737,6 +1969,7 @@ void MainWindow::showFullScreenUI()
         m_fullScreenControlsOverlay->show();
         m_fullScreenControlsOverlay->raise();
         m_controlsVisible = true;
+        updatePlaybackUiRefresh();
     }
 
     // Reset hide timer
@@ -1753,6 +1986,7 @@ void MainWindow::hideFullScreenUI()
     if (m_fullScreenControlsOverlay && m_controlsVisible) {
         m_fullScreenControlsOverlay->hide();
         m_controlsVisible = false;
+        updatePlaybackUiRefresh();
     }
 
     // Hide cursor
@@ -1793,13 +2027,13 @@ void MainWindow::resetControlsHideTimer()
         return;
     }
 
-    if (m_isDestructing.load()) {
+    if (m_isDestructing) {
         return;
     }
 
     try {
         m_controlsHideTimer->stop();
-        if (m_isFullScreen && !m_isDestructing.load()) {
+        if (m_isFullScreen && !m_isDestructing) {
             m_controlsHideTimer->start(CONTROLS_HIDE_TIMEOUT_MS);
         }
     } catch (const std::exception& e) {
@@ -1841,6 +2075,7 @@ void MainWindow::showSettings()
             // Settings were applied and saved
             qDebug() << "Settings dialog accepted - changes saved";
             statusBar()->showMessage("Settings saved successfully", 2000);
+            applyStreamingSettings();
 
             // Optionally refresh UI elements that might be affected by settings changes
             // This could include theme updates, language changes, etc.
@@ -1870,15 +2105,18 @@ void MainWindow::showPreferences()
 void MainWindow::showPluginManager()
 {
     if (auto* pluginManager = m_app->pluginManager()) {
-        QStringList plugins = pluginManager->availablePlugins();
+        const QList<Core::PluginManager::PluginTiming> plugins = pluginManager->pluginTimings();
 
         QString message = "Plugin Manager\n\n";
         if (plugins.isEmpty()) {
             message += "No plugins currently loaded.";
         } else {
             message += QString("Loaded plugins (%1):\n").arg(plugins.size());
-            for (const QString& plugin : plugins) {
-                message += "• " + plugin + "\n";
+            for (const auto& plugin : plugins) {
+                const QString timing = plugin.instantiated
+                    ? QString("load %1 ms, init %2 ms").arg(plugin.loadUs / 1000.0, 0, 'f', 1).arg(plugin.initUs / 1000.0, 0, 'f', 1)
+                    : QString("load %1 ms, not used yet").arg(plugin.loadUs / 1000.0, 0, 'f', 1);
+                message += "• " + plugin.name + " (" + timing + ")\n";
             }
         }
 
@@ -1904,11 +2142,7 @@ void MainWindow::showContextMenu(const QPoint& position)
     if (!m_recentFiles.isEmpty()) {
         auto* recentMenu = contextMenu.addMenu("Recent Files");
         for (const QString& file : m_recentFiles) {
-            QFileInfo fileInfo(file);
-            auto* recentAction = recentMenu->addAction(fileInfo.fileName());
-            recentAction->setData(file);
-            recentAction->setToolTip(file);
-            connect(recentAction, &QAction::triggered, this, &MainWindow::openRecentFile);
+            addRecentFileAction(recentMenu, file);
         }
     }
 
@@ -1946,6 +2180,74 @@ void MainWindow::showContextMenu(const QPoint& position)
             }
         });
 
+        auto* previousFrameAction = contextMenu.addAction("⏮ Previous Frame");
+        previousFrameAction->setShortcut(Qt::Key_Comma);
+        connect(previousFrameAction, &QAction::triggered, [this]() {
+            if (m_mediaController) {
+                m_mediaController->stepFrame(-1);
+            }
+        });
+
+        auto* nextFrameAction = contextMenu.addAction("⏭ Next Frame");
+        nextFrameAction->setShortcut(Qt::Key_Period);
+        connect(nextFrameAction, &QAction::triggered, [this]() {
+            if (m_mediaController) {
+                m_mediaController->stepFrame(1);
+            }
+        });
+
+        auto* speedMenu = contextMenu.addMenu("⏱ Speed");
+        auto* speedGroup = new QActionGroup(speedMenu);
+        const qreal currentRate = m_mediaController->playbackRate();
+        for (const qreal rate : {0.5, 0.75, 1.0, 1.25, 1.5, 2.0}) {
+            auto* action = speedMenu->addAction(QString("%1x").arg(rate));
+            action->setCheckable(true);
+            action->setChecked(qFuzzyCompare(currentRate, rate));
+            speedGroup->addAction(action);
+            connect(action, &QAction::triggered, [this, rate]() {
+                if (m_mediaController) {
+                    m_mediaController->setPlaybackRate(rate);
+                }
+            });
+        }
+        speedMenu->addSeparator();
+        auto* slowerAction = speedMenu->addAction("Slower");
+        slowerAction->setShortcut(Qt::Key_BracketLeft);
+        connect(slowerAction, &QAction::triggered, [this]() {
+            if (m_mediaController) {
+                m_mediaController->mediaManager()->decreaseSpeed();
+            }
+        });
+        auto* fasterAction = speedMenu->addAction("Faster");
+        fasterAction->setShortcut(Qt::Key_BracketRight);
+        connect(fasterAction, &QAction::triggered, [this]() {
+            if (m_mediaController) {
+                m_mediaController->mediaManager()->increaseSpeed();
+            }
+        });
+
+        // Sidecar subtitle tracks found next to the file
+        auto* subtitles = m_mediaController->subtitleService();
+        if (subtitles && !subtitles->tracks().isEmpty()) {
+            auto* subtitleMenu = contextMenu.addMenu("💬 Subtitles");
+            auto* subtitleGroup = new QActionGroup(subtitleMenu);
+            auto addSubtitleAction = [subtitles, subtitleMenu, subtitleGroup](int index, const QString& text) {
+                auto* action = subtitleMenu->addAction(text);
+                action->setCheckable(true);
+                action->setChecked(subtitles->currentTrack() == index);
+                subtitleGroup->addAction(action);
+                connect(action, &QAction::triggered, subtitles, [subtitles, index]() {
+                    subtitles->selectTrack(index);
+                });
+            };
+            addSubtitleAction(-1, "Off");
+            const QList<Media::SubtitleTrackInfo>& tracks = subtitles->tracks();
+            for (int i = 0; i < tracks.size(); ++i) {
+                const Media::SubtitleTrackInfo& track = tracks.at(i);
+                addSubtitleAction(i, track.label.isEmpty() ? QFileInfo(track.filePath).fileName() : track.label);
+            }
+        }
+
         contextMenu.addSeparator();
     }
 
@@ -2070,6 +2372,10 @@ void MainWindow::showContextMenu(const QPoint& position)
     auto* pluginManagerAction = contextMenu.addAction("🔌 Plugin Manager...");
     connect(pluginManagerAction, &QAction::triggered, this, &MainWindow::showPluginManager);
 
+    if (m_statsAction) {
+        contextMenu.addAction(m_statsAction);
+    }
+
     // About section
     contextMenu.addSeparator();
 
@@ -2093,6 +2399,18 @@ void MainWindow::showContextMenu(const QPoint& position)
     contextMenu.exec(position);
 }
 
+QString MainWindow::fullScreenStyleSheet() const
+{
+    if (!m_app || !m_app->themeManager()) {
+        return generateFullScreenStyleSheet();
+    }
+
+    // Only two variants exist; each is generated once per session
+    Core::ThemeManager* themeManager = m_app->themeManager();
+    const QString key = themeManager->isSystemDarkTheme() ? "fullscreenOverlay/dark" : "fullscreenOverlay/light";
+    return themeManager->cachedStyleSheet(key, [this]() { return generateFullScreenStyleSheet(); });
+}
+
 QString MainWindow::generateFullScreenStyleSheet() const
 {
     // Determine if we're using dark theme
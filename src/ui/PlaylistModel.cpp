@@ -0,0 +1,94 @@
+#include "ui/PlaylistModel.h"
+#include "media/Playlist.h"
+#include <QFont>
+
+namespace DarkPlay::UI {
+
+PlaylistModel::PlaylistModel(Media::Playlist* playlist, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_playlist(playlist)
+    , m_currentRow(-1)
+{
+    if (!m_playlist) {
+        return;
+    }
+
+    using Media::Playlist;
+    connect(playlist, &Playlist::rowsAboutToBeInserted, this, [this](int first, int last) {
+        beginInsertRows(QModelIndex(), first, last);
+    });
+    connect(playlist, &Playlist::rowsInserted, this, [this]() { endInsertRows(); });
+    connect(playlist, &Playlist::rowsAboutToBeRemoved, this, [this](int first, int last) {
+        beginRemoveRows(QModelIndex(), first, last);
+    });
+    connect(playlist, &Playlist::rowsRemoved, this, [this]() { endRemoveRows(); });
+    connect(playlist, &Playlist::rowsAboutToBeMoved, this, [this](int first, int last, int destinationRow) {
+        beginMoveRows(QModelIndex(), first, last, QModelIndex(), destinationRow);
+    });
+    connect(playlist, &Playlist::rowsMoved, this, [this]() { endMoveRows(); });
+    connect(playlist, &Playlist::modelAboutToBeReset, this, [this]() { beginResetModel(); });
+    connect(playlist, &Playlist::modelReset, this, [this]() {
+        m_currentRow = -1;
+        endResetModel();
+    });
+}
+
+int PlaylistModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !m_playlist) {
+        return 0;
+    }
+    return m_playlist->count();
+}
+
+QVariant PlaylistModel::data(const QModelIndex& index, int role) const
+{
+    if (!m_playlist || !index.isValid() || index.row() >= m_playlist->count()) {
+        return {};
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return m_playlist->displayNameAt(index.row());
+    case Qt::ToolTipRole:
+    case UrlRole:
+        return m_playlist->urlAt(index.row());
+    case EntryIdRole:
+        return m_playlist->idAt(index.row());
+    case Qt::FontRole:
+        if (index.row() == m_currentRow) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return {};
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> PlaylistModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(UrlRole, "url");
+    roles.insert(EntryIdRole, "entryId");
+    return roles;
+}
+
+void PlaylistModel::setCurrentRow(int row)
+{
+    if (row == m_currentRow) {
+        return;
+    }
+
+    const int previous = m_currentRow;
+    m_currentRow = row;
+    for (int changed : {previous, row}) {
+        if (changed >= 0 && changed < rowCount()) {
+            const QModelIndex changedIndex = index(changed);
+            emit dataChanged(changedIndex, changedIndex, {Qt::FontRole});
+        }
+    }
+}
+
+} // namespace DarkPlay::UI
@@ -0,0 +1,63 @@
+#include "ui/SeekPreviewPopup.h"
+#include <QGuiApplication>
+#include <QLabel>
+#include <QPixmap>
+#include <QScreen>
+#include <QVBoxLayout>
+
+namespace DarkPlay::UI {
+
+SeekPreviewPopup::SeekPreviewPopup(QWidget* parent)
+    : QFrame(parent, Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowDoesNotAcceptFocus)
+    , m_imageLabel(new QLabel(this))
+    , m_timeLabel(new QLabel(this))
+{
+    setObjectName("seekPreviewPopup");
+    setStyleSheet("QFrame#seekPreviewPopup {"
+                  " background-color: rgba(0, 0, 0, 200);"
+                  " border: 1px solid rgba(255, 255, 255, 60);"
+                  " border-radius: 4px;"
+                  "}"
+                  "QLabel { color: #f0f0f0; background: transparent; }");
+    setAttribute(Qt::WA_ShowWithoutActivating, true);
+    setAttribute(Qt::WA_TransparentForMouseEvents, true);
+
+    m_imageLabel->setAlignment(Qt::AlignCenter);
+    m_timeLabel->setAlignment(Qt::AlignCenter);
+
+    auto* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 4, 4);
+    layout->setSpacing(2);
+    layout->addWidget(m_imageLabel);
+    layout->addWidget(m_timeLabel);
+
+    hide();
+}
+
+void SeekPreviewPopup::showPreview(const QImage& thumbnail, const QString& timeText, const QPoint& anchor)
+{
+    if (thumbnail.isNull()) {
+        m_imageLabel->hide();
+    } else {
+        m_imageLabel->setPixmap(QPixmap::fromImage(thumbnail));
+        m_imageLabel->show();
+    }
+    m_timeLabel->setText(timeText);
+    adjustSize();
+
+    // Centre above the anchor, kept on the anchor's screen
+    QPoint topLeft(anchor.x() - width() / 2, anchor.y() - height() - ANCHOR_GAP);
+    if (const QScreen* screen = QGuiApplication::screenAt(anchor)) {
+        const QRect bounds = screen->availableGeometry();
+        topLeft.setX(qBound(bounds.left(), topLeft.x(), bounds.right() - width()));
+        topLeft.setY(qMax(bounds.top(), topLeft.y()));
+    }
+    move(topLeft);
+
+    if (!isVisible()) {
+        show();
+    }
+    raise();
+}
+
+} // namespace DarkPlay::UI
@@ -1,6 +1,8 @@
 #include "ui/SettingDialog.h"
 #include "core/Application.h"
 #include "core/ConfigManager.h"
+#include "media/HardwareDecoding.h"
+#include "media/MediaEngineRegistry.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QDialogButtonBox>
@@ -22,15 +24,25 @@ namespace DarkPlay::UI {
         // General Settings
         , m_autoPlayCheckBox(nullptr)
         , m_rememberPositionCheckBox(nullptr)
+        , m_gaplessPrerollCheckBox(nullptr)
+        , m_prerollSecondsSpinBox(nullptr)
+        , m_seekModeComboBox(nullptr)
         , m_defaultDirectoryEdit(nullptr)
         , m_browseButton(nullptr)
         , m_recentFilesCountSpinBox(nullptr)
+        , m_singleInstanceCheckBox(nullptr)
         // Media Settings
         , m_defaultVolumeSlider(nullptr)
         , m_volumeLabel(nullptr)
         , m_hardwareAccelerationCheckBox(nullptr)
+        , m_hardwareApisLabel(nullptr)
+        , m_engineComboBox(nullptr)
         , m_audioOutputComboBox(nullptr)
         , m_subtitleAutoLoadCheckBox(nullptr)
+        , m_readAheadSpinBox(nullptr)
+        , m_diskCacheSpinBox(nullptr)
+        , m_adaptiveBitrateCheckBox(nullptr)
+        , m_stallRecoverySpinBox(nullptr)
         // Interface Settings
         , m_showStatusBarCheckBox(nullptr)
         , m_hideControlsInFullscreenCheckBox(nullptr)
@@ -91,8 +103,21 @@ namespace DarkPlay::UI {
         m_autoPlayCheckBox = new QCheckBox("Auto-play files when opened");
         m_rememberPositionCheckBox = new QCheckBox("Remember playback position");
 
+        m_gaplessPrerollCheckBox = new QCheckBox("Gapless playlist transitions (pre-roll next item)");
+        m_prerollSecondsSpinBox = new QSpinBox();
+        m_prerollSecondsSpinBox->setRange(1, 60);
+        m_prerollSecondsSpinBox->setValue(5);
+        m_prerollSecondsSpinBox->setSuffix(" seconds");
+
+        m_seekModeComboBox = new QComboBox();
+        m_seekModeComboBox->addItem("Exact (frame-accurate)", "exact");
+        m_seekModeComboBox->addItem("Fast (nearest keyframe)", "fast");
+
         playbackLayout->addRow(m_autoPlayCheckBox);
         playbackLayout->addRow(m_rememberPositionCheckBox);
+        playbackLayout->addRow(m_gaplessPrerollCheckBox);
+        playbackLayout->addRow("Pre-roll lead time:", m_prerollSecondsSpinBox);
+        playbackLayout->addRow("Seeking:", m_seekModeComboBox);
 
         // File Management Group
         auto* fileGroup = new QGroupBox("File Management", generalWidget);
@@ -108,8 +133,11 @@ namespace DarkPlay::UI {
         m_recentFilesCountSpinBox->setRange(0, 50);
         m_recentFilesCountSpinBox->setValue(10);
 
+        m_singleInstanceCheckBox = new QCheckBox("Open files in the running window");
+
         fileLayout->addRow("Default directory:", dirLayout);
         fileLayout->addRow("Recent files count:", m_recentFilesCountSpinBox);
+        fileLayout->addRow(m_singleInstanceCheckBox);
 
         layout->addWidget(playbackGroup);
         layout->addWidget(fileGroup);
@@ -120,6 +148,7 @@ namespace DarkPlay::UI {
         // Connect signals
         connect(m_autoPlayCheckBox, &QCheckBox::toggled, this, &SettingDialog::onAutoPlayToggled);
         connect(m_browseButton, &QPushButton::clicked, this, &SettingDialog::browseForDirectory);
+        connect(m_gaplessPrerollCheckBox, &QCheckBox::toggled, m_prerollSecondsSpinBox, &QSpinBox::setEnabled);
     }
 
     void SettingDialog::createMediaTab()
@@ -151,7 +180,21 @@ namespace DarkPlay::UI {
 
         m_hardwareAccelerationCheckBox = new QCheckBox("Enable hardware acceleration");
 
+        QStringList apiNames;
+        for (Media::HardwareDecodeApi api : Media::HardwareDecoding::probe()) {
+            apiNames.append(Media::HardwareDecoding::apiName(api));
+        }
+        m_hardwareApisLabel = new QLabel(apiNames.isEmpty() ? QString("No hardware decoder found")
+                                                            : QString("Available: %1").arg(apiNames.join(", ")));
+
+        m_engineComboBox = new QComboBox();
+        for (const Media::EngineDescriptor& engine : Media::MediaEngineRegistry::instance()->engines()) {
+            m_engineComboBox->addItem(engine.displayName, engine.id);
+        }
+
+        videoLayout->addRow("Playback engine:", m_engineComboBox);
         videoLayout->addRow(m_hardwareAccelerationCheckBox);
+        videoLayout->addRow(m_hardwareApisLabel);
 
         // Subtitle Settings Group
         auto* subtitleGroup = new QGroupBox("Subtitle Settings", mediaWidget);
@@ -161,9 +204,37 @@ namespace DarkPlay::UI {
 
         subtitleLayout->addRow(m_subtitleAutoLoadCheckBox);
 
+        // Network Streaming Group
+        auto* networkGroup = new QGroupBox("Network Streaming", mediaWidget);
+        auto* networkLayout = new QFormLayout(networkGroup);
+
+        m_readAheadSpinBox = new QSpinBox();
+        m_readAheadSpinBox->setRange(4, 512);
+        m_readAheadSpinBox->setValue(32);
+        m_readAheadSpinBox->setSuffix(" MB");
+
+        m_diskCacheSpinBox = new QSpinBox();
+        m_diskCacheSpinBox->setRange(0, 4096);
+        m_diskCacheSpinBox->setValue(256);
+        m_diskCacheSpinBox->setSuffix(" MB");
+        m_diskCacheSpinBox->setSpecialValueText("Disabled");
+
+        m_adaptiveBitrateCheckBox = new QCheckBox("Adaptive bitrate for HLS streams");
+
+        m_stallRecoverySpinBox = new QSpinBox();
+        m_stallRecoverySpinBox->setRange(2, 60);
+        m_stallRecoverySpinBox->setValue(8);
+        m_stallRecoverySpinBox->setSuffix(" seconds");
+
+        networkLayout->addRow("Read-ahead window:", m_readAheadSpinBox);
+        networkLayout->addRow("Disk cache:", m_diskCacheSpinBox);
+        networkLayout->addRow(m_adaptiveBitrateCheckBox);
+        networkLayout->addRow("Stall recovery after:", m_stallRecoverySpinBox);
+
         layout->addWidget(audioGroup);
         layout->addWidget(videoGroup);
         layout->addWidget(subtitleGroup);
+        layout->addWidget(networkGroup);
         layout->addStretch();
 
         m_tabWidget->addTab(mediaWidget, "Media");
@@ -212,21 +283,33 @@ namespace DarkPlay::UI {
         // Load General Settings
         m_autoPlayCheckBox->setChecked(m_configManager->getValue("playback/autoPlay", true).toBool());
         m_rememberPositionCheckBox->setChecked(m_configManager->getValue("playback/rememberPosition", true).toBool());
+        m_gaplessPrerollCheckBox->setChecked(m_configManager->getValue("playback/gaplessPreroll", true).toBool());
+        m_prerollSecondsSpinBox->setValue(m_configManager->getValue("playback/prerollSeconds", 5).toInt());
+        m_prerollSecondsSpinBox->setEnabled(m_gaplessPrerollCheckBox->isChecked());
+        const int seekModeIndex = m_seekModeComboBox->findData(m_configManager->getValue("playback/seekMode", "exact").toString());
+        if (seekModeIndex >= 0) m_seekModeComboBox->setCurrentIndex(seekModeIndex);
         m_defaultDirectoryEdit->setText(m_configManager->getValue("files/lastDirectory",
                                        QStandardPaths::writableLocation(QStandardPaths::MoviesLocation)).toString());
         m_recentFilesCountSpinBox->setValue(m_configManager->getValue("files/maxRecentFiles", 10).toInt());
+        m_singleInstanceCheckBox->setChecked(m_configManager->getValue("ui/singleInstance", true).toBool());
 
         // Load Media Settings
         int volume = static_cast<int>(m_configManager->getValue("media/volume", 0.7).toFloat() * 100);
         m_defaultVolumeSlider->setValue(volume);
         m_volumeLabel->setText(QString("%1%").arg(volume));
         m_hardwareAccelerationCheckBox->setChecked(m_configManager->getValue("media/hardwareAcceleration", true).toBool());
+        const int engineIndex = m_engineComboBox->findData(m_configManager->getValue("media/defaultEngine", "qt").toString());
+        if (engineIndex >= 0) m_engineComboBox->setCurrentIndex(engineIndex);
 
         QString audioOutput = m_configManager->getValue("media/audioOutput", "Default").toString();
         int audioIndex = m_audioOutputComboBox->findText(audioOutput);
         if (audioIndex >= 0) m_audioOutputComboBox->setCurrentIndex(audioIndex);
 
         m_subtitleAutoLoadCheckBox->setChecked(m_configManager->getValue("media/subtitleAutoLoad", true).toBool());
+        m_readAheadSpinBox->setValue(m_configManager->getValue("network/readAheadMB", 32).toInt());
+        m_diskCacheSpinBox->setValue(m_configManager->getValue("network/diskCacheMB", 256).toInt());
+        m_adaptiveBitrateCheckBox->setChecked(m_configManager->getValue("network/adaptiveBitrate", true).toBool());
+        m_stallRecoverySpinBox->setValue(m_configManager->getValue("network/stallRecoverySeconds", 8).toInt());
 
         // Load Interface Settings
         m_showStatusBarCheckBox->setChecked(m_configManager->getValue("ui/showStatusBar", true).toBool());
@@ -241,15 +324,24 @@ namespace DarkPlay::UI {
         // Save General Settings
         m_configManager->setValue("playback/autoPlay", m_autoPlayCheckBox->isChecked());
         m_configManager->setValue("playback/rememberPosition", m_rememberPositionCheckBox->isChecked());
+        m_configManager->setValue("playback/gaplessPreroll", m_gaplessPrerollCheckBox->isChecked());
+        m_configManager->setValue("playback/prerollSeconds", m_prerollSecondsSpinBox->value());
+        m_configManager->setValue("playback/seekMode", m_seekModeComboBox->currentData().toString());
         m_configManager->setValue("files/lastDirectory", m_defaultDirectoryEdit->text());
         m_configManager->setValue("files/maxRecentFiles", m_recentFilesCountSpinBox->value());
+        m_configManager->setValue("ui/singleInstance", m_singleInstanceCheckBox->isChecked());
 
         // Save Media Settings
         float volume = static_cast<float>(m_defaultVolumeSlider->value()) / 100.0f;
         m_configManager->setValue("media/volume", volume);
         m_configManager->setValue("media/hardwareAcceleration", m_hardwareAccelerationCheckBox->isChecked());
+        m_configManager->setValue("media/defaultEngine", m_engineComboBox->currentData().toString());
         m_configManager->setValue("media/audioOutput", m_audioOutputComboBox->currentText());
         m_configManager->setValue("media/subtitleAutoLoad", m_subtitleAutoLoadCheckBox->isChecked());
+        m_configManager->setValue("network/readAheadMB", m_readAheadSpinBox->value());
+        m_configManager->setValue("network/diskCacheMB", m_diskCacheSpinBox->value());
+        m_configManager->setValue("network/adaptiveBitrate", m_adaptiveBitrateCheckBox->isChecked());
+        m_configManager->setValue("network/stallRecoverySeconds", m_stallRecoverySpinBox->value());
 
         // Save Interface Settings
         m_configManager->setValue("ui/showStatusBar", m_showStatusBarCheckBox->isChecked());
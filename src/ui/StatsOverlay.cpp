@@ -0,0 +1,199 @@
+#include "ui/StatsOverlay.h"
+#include <QFontDatabase>
+#include <QStringList>
+
+namespace DarkPlay::UI {
+
+StatsOverlay::StatsOverlay(QWidget* parent)
+    : QLabel(parent)
+{
+    setObjectName("statsOverlay");
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setStyleSheet("QLabel#statsOverlay {"
+                  " background-color: rgba(0, 0, 0, 170);"
+                  " color: #e0e0e0;"
+                  " border-radius: 4px;"
+                  " padding: 6px 8px;"
+                  "}");
+    setTextFormat(Qt::PlainText);
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+
+    // Purely informational - clicks and double clicks belong to the video
+    setAttribute(Qt::WA_TransparentForMouseEvents, true);
+
+    m_refreshTimer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &StatsOverlay::refresh);
+
+    hide();
+}
+
+void StatsOverlay::setStatsProvider(StatsProvider provider)
+{
+    m_provider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::setStreamingStatsProvider(StreamingStatsProvider provider)
+{
+    m_streamingProvider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::setUiStatsProvider(UiStatsProvider provider)
+{
+    m_uiProvider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::setMemoryStatsProvider(MemoryStatsProvider provider)
+{
+    m_memoryProvider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::setFanoutStatsProvider(FanoutStatsProvider provider)
+{
+    m_fanoutProvider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::setClockStatsProvider(ClockStatsProvider provider)
+{
+    m_clockProvider = std::move(provider);
+    if (isVisible()) {
+        refresh();
+    }
+}
+
+void StatsOverlay::showEvent(QShowEvent* event)
+{
+    QLabel::showEvent(event);
+    refresh();
+    m_refreshTimer.start();
+}
+
+void StatsOverlay::hideEvent(QHideEvent* event)
+{
+    QLabel::hideEvent(event);
+    m_refreshTimer.stop();
+}
+
+void StatsOverlay::refresh()
+{
+    const Media::FrameStats stats = m_provider ? m_provider() : Media::FrameStats{};
+
+    auto ms = [](qint64 us) { return QString::number(us / 1000.0, 'f', 1); };
+
+    QString text = QString("Frames   %1 received, %2 presented\n"
+                    "Dropped  %3   Skipped %4   Late %5\n"
+                    "Rate     %6 fps\n"
+                    "Latency  p50 %7 ms  p95 %8 ms  p99 %9 ms")
+                .arg(stats.framesReceived)
+                .arg(stats.framesPresented)
+                .arg(stats.framesDropped)
+                .arg(stats.framesSkipped)
+                .arg(stats.framesLate)
+                .arg(stats.frameRate, 0, 'f', 2)
+                .arg(ms(stats.latencyP50Us), ms(stats.latencyP95Us), ms(stats.latencyP99Us));
+
+    const Media::StreamingStats stream = m_streamingProvider ? m_streamingProvider() : Media::StreamingStats{};
+    if (stream.active) {
+        auto mb = [](qint64 bytes) { return QString::number(bytes / (1024.0 * 1024.0), 'f', 1); };
+
+        const QString fill = QString::number(stream.bufferProgress) + (stream.stalled ? "%, stalled" : "%");
+
+        text += QString("\nStream   %1, startup %2\n"
+                        "Buffer   %3 MB ahead, %4\n"
+                        "Stalls   %5, rebuffer %6 s, longest %7 s\n"
+                        "Network  %8 kbps, %9 MB received")
+                    .arg(stream.mode,
+                         stream.startupMs >= 0 ? QString("%1 ms").arg(stream.startupMs) : QString("pending"),
+                         mb(stream.bufferedAheadBytes), fill)
+                    .arg(stream.stallCount)
+                    .arg(stream.rebufferMs / 1000.0, 0, 'f', 1)
+                    .arg(stream.longestStallMs / 1000.0, 0, 'f', 1)
+                    .arg(qRound(stream.throughputKbps))
+                    .arg(mb(stream.bytesReceived));
+        if (stream.reconnects > 0) {
+            text += QString(", %1 reconnects").arg(stream.reconnects);
+        }
+        if (stream.variantCount > 0) {
+            text += QString("\nVariant  %1/%2 at %3 kbps, %4 switches")
+                        .arg(stream.variantIndex + 1)
+                        .arg(stream.variantCount)
+                        .arg(stream.variantBandwidth / 1000)
+                        .arg(stream.variantSwitches);
+        }
+    }
+
+    if (m_uiProvider) {
+        const UiRefreshStats ui = m_uiProvider();
+        text += QString("\nUI       %1 allocs/s, %2 updates/s")
+                    .arg(ui.allocationsPerSecond)
+                    .arg(ui.updatesPerSecond);
+    }
+
+    if (m_memoryProvider) {
+        const Utils::MemoryStats memory = m_memoryProvider();
+        auto mb = [](qint64 bytes) { return QString::number(bytes / (1024.0 * 1024.0), 'f', 1); };
+
+        text += QString("\nMemory   %1 of %2 MB").arg(mb(memory.totalBytes), mb(memory.limitBytes));
+        if (memory.underPressure) {
+            text += ", system under pressure";
+        }
+        if (memory.lowMemoryMode) {
+            text += ", low-memory mode";
+        }
+        QStringList parts;
+        for (const Utils::MemoryUsage& usage : memory.consumers) {
+            parts.append(QString("%1 %2").arg(usage.name, mb(usage.bytes)));
+        }
+        if (!parts.isEmpty()) {
+            text += "\n         " + parts.join(", ");
+        }
+        if (memory.evictedBytes > 0) {
+            text += QString("\n         %1 MB evicted").arg(mb(memory.evictedBytes));
+        }
+    }
+
+    const Media::VideoFanoutStats fanout = m_fanoutProvider ? m_fanoutProvider() : Media::VideoFanoutStats{};
+    if (m_fanoutProvider) {
+        // A single output has nothing to be out of step with
+        if (fanout.outputs > 1) {
+            text += QString("\nWall     %1 outputs, skew %2 ms (max %3 ms)")
+                        .arg(fanout.outputs)
+                        .arg(fanout.lastSkewUs >= 0 ? ms(fanout.lastSkewUs) : QString("-"),
+                             fanout.maxSkewUs >= 0 ? ms(fanout.maxSkewUs) : QString("-"));
+        }
+    }
+
+    if (m_clockProvider) {
+        const Media::ClockStats clock = m_clockProvider();
+        if (clock.source != Media::ClockSource::None) {
+            auto signedMs = [&ms](qint64 us) { return (us >= 0 ? "+" : "") + ms(us); };
+            text += QString("\nClock    %1 at %2x, drift %3 ms (max %4 ms)")
+                        .arg(clock.source == Media::ClockSource::Audio ? QString("audio") : QString("engine"))
+                        .arg(clock.rate, 0, 'f', 2)
+                        .arg(clock.driftSamples > 0 ? signedMs(clock.driftUs) : QString("-"),
+                             clock.driftSamples > 0 ? signedMs(clock.maxDriftUs) : QString("-"));
+            if (fanout.framesHeld > 0 || fanout.framesDroppedLate > 0) {
+                text += QString(", %1 held, %2 dropped").arg(fanout.framesHeld).arg(fanout.framesDroppedLate);
+            }
+        }
+    }
+
+    setText(text);
+    adjustSize();
+}
+
+} // namespace DarkPlay::UI
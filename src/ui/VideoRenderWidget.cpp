@@ -0,0 +1,772 @@
+#include "ui/VideoRenderWidget.h"
+#include "utils/Trace.h"
+#include <QAbstractTextDocumentLayout>
+#include <QDebug>
+#include <QImage>
+#include <QOpenGLContext>
+#include <QPainter>
+#include <QTextDocument>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Not every GL header set exposes the GL 3 / GLES 3 enums
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+#ifndef GL_RG
+#define GL_RG 0x8227
+#endif
+#ifndef GL_R8
+#define GL_R8 0x8229
+#endif
+#ifndef GL_RG8
+#define GL_RG8 0x822B
+#endif
+#ifndef GL_R16
+#define GL_R16 0x822A
+#endif
+#ifndef GL_RG16
+#define GL_RG16 0x822C
+#endif
+
+namespace DarkPlay::UI {
+
+namespace {
+
+// Subtitle size follows the picture, the way burnt-in subtitles would
+constexpr qreal SUBTITLE_FONT_SCALE = 0.055;    // Of the picture height
+constexpr qreal SUBTITLE_MIN_FONT_PX = 12.0;
+constexpr qreal SUBTITLE_WIDTH_FRACTION = 0.9;  // Lines wrap beyond this share of the picture width
+constexpr qreal SUBTITLE_BOTTOM_MARGIN = 0.05;  // Of the picture height
+constexpr qreal SUBTITLE_OUTLINE_SCALE = 0.08;  // Of the font size
+
+const char* const VERTEX_SHADER = R"(
+attribute vec2 a_position;
+attribute vec2 a_texCoord;
+varying vec2 v_texCoord;
+void main()
+{
+    v_texCoord = a_texCoord;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+const char* const FRAGMENT_SHADER = R"(
+#ifdef GL_ES
+precision mediump float;
+#endif
+uniform sampler2D u_plane0;
+uniform sampler2D u_plane1;
+uniform sampler2D u_plane2;
+uniform int u_layout;          // 1 = packed RGB, 2 = semi-planar, 3 = planar, 4 = overlay
+uniform bool u_swapRedBlue;
+uniform bool u_luminanceAlpha; // GLES 2 chroma lives in .ra instead of .rg
+uniform mat4 u_colorMatrix;
+varying vec2 v_texCoord;
+void main()
+{
+    if (u_layout == 4) {
+        gl_FragColor = texture2D(u_plane0, v_texCoord); // Premultiplied, blended by the caller
+        return;
+    }
+    if (u_layout == 1) {
+        vec4 color = texture2D(u_plane0, v_texCoord);
+        gl_FragColor = u_swapRedBlue ? vec4(color.bgr, 1.0) : vec4(color.rgb, 1.0);
+        return;
+    }
+
+    float y = texture2D(u_plane0, v_texCoord).r;
+    vec2 chroma;
+    if (u_layout == 2) {
+        vec4 uv = texture2D(u_plane1, v_texCoord);
+        chroma = u_luminanceAlpha ? uv.ra : uv.rg;
+    } else {
+        chroma = vec2(texture2D(u_plane1, v_texCoord).r, texture2D(u_plane2, v_texCoord).r);
+    }
+    gl_FragColor = vec4((u_colorMatrix * vec4(y, chroma, 1.0)).rgb, 1.0);
+}
+)";
+
+/**
+ * @brief Build the Y'CbCr -> R'G'B' matrix including range expansion
+ */
+QMatrix4x4 yuvToRgbMatrix(QVideoFrameFormat::ColorSpace colorSpace, QVideoFrameFormat::ColorRange range,
+                          int frameHeight, bool swapChroma)
+{
+    // Untagged streams: HD and above is almost always BT.709
+    if (colorSpace == QVideoFrameFormat::ColorSpace_Undefined) {
+        colorSpace = frameHeight > 576 ? QVideoFrameFormat::ColorSpace_BT709 : QVideoFrameFormat::ColorSpace_BT601;
+    }
+
+    float kr = 0.299f;
+    float kb = 0.114f;
+    switch (colorSpace) {
+    case QVideoFrameFormat::ColorSpace_BT709:
+        kr = 0.2126f;
+        kb = 0.0722f;
+        break;
+    case QVideoFrameFormat::ColorSpace_BT2020:
+        kr = 0.2627f;
+        kb = 0.0593f;
+        break;
+    default:
+        break;
+    }
+    const float kg = 1.0f - kr - kb;
+
+    const bool fullRange = range == QVideoFrameFormat::ColorRange_Full;
+    const float yScale = fullRange ? 1.0f : 255.0f / 219.0f;
+    const float cScale = fullRange ? 1.0f : 255.0f / 224.0f;
+    const float yOffset = fullRange ? 0.0f : 16.0f / 255.0f;
+    const float cOffset = 128.0f / 255.0f;
+
+    // Cb/Cr coefficients per output channel
+    const float rCr = 2.0f * (1.0f - kr);
+    const float gCb = -2.0f * kb * (1.0f - kb) / kg;
+    const float gCr = -2.0f * kr * (1.0f - kr) / kg;
+    const float bCb = 2.0f * (1.0f - kb);
+
+    auto row = [&](float cb, float cr, float* out) {
+        out[0] = yScale;
+        out[1] = (swapChroma ? cr : cb) * cScale;
+        out[2] = (swapChroma ? cb : cr) * cScale;
+        out[3] = -(yScale * yOffset + (cb + cr) * cScale * cOffset);
+    };
+
+    float r[4], g[4], b[4];
+    row(0.0f, rCr, r);
+    row(gCb, gCr, g);
+    row(bCb, 0.0f, b);
+
+    return QMatrix4x4(r[0], r[1], r[2], r[3],
+                      g[0], g[1], g[2], g[3],
+                      b[0], b[1], b[2], b[3],
+                      0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+} // namespace
+
+VideoRenderWidget::VideoRenderWidget(QWidget* parent)
+    : QOpenGLWidget(parent)
+    , m_videoSink(new QVideoSink(this))
+    , m_frameDirty(false)
+    , m_presentPending(false)
+    , m_vertexBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_glInitialized(false)
+    , m_hasRedTextures(false)
+    , m_hasUnpackRowLength(false)
+    , m_hasShortTextures(false)
+    , m_layout(PlaneLayout::None)
+    , m_swapRedBlue(false)
+    , m_mirrored(false)
+    , m_bottomToTop(false)
+    , m_geometryDirty(true)
+    , m_fallbackFormat(QVideoFrameFormat::Format_Invalid)
+    , m_aspectRatioMode(Qt::KeepAspectRatio)
+    , m_subtitleTexture(0)
+    , m_subtitleBuffer(QOpenGLBuffer::VertexBuffer)
+    , m_subtitleDirty(false)
+    , m_subtitleReady(false)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
+    setAttribute(Qt::WA_NoSystemBackground, true);
+
+    connect(m_videoSink, &QVideoSink::videoFrameChanged,
+            this, &VideoRenderWidget::onVideoFrameChanged);
+}
+
+VideoRenderWidget::~VideoRenderWidget()
+{
+    cleanupGL();
+}
+
+void VideoRenderWidget::setWallViewport(const QRectF& wall, const QRectF& viewport)
+{
+    if (m_wall == wall && m_wallViewport == viewport) {
+        return;
+    }
+    m_wall = wall;
+    m_wallViewport = viewport;
+    m_geometryDirty = true;
+    update();
+}
+
+void VideoRenderWidget::setAspectRatioMode(Qt::AspectRatioMode mode)
+{
+    if (m_aspectRatioMode == mode) {
+        return;
+    }
+
+    m_aspectRatioMode = mode;
+    m_geometryDirty = true;
+    update();
+}
+
+void VideoRenderWidget::setSubtitleText(const QString& html)
+{
+    if (html == m_subtitleHtml) {
+        return;
+    }
+
+    m_subtitleHtml = html;
+    m_subtitleDirty = true;
+    update();
+}
+
+void VideoRenderWidget::onVideoFrameChanged(const QVideoFrame& frame)
+{
+    // Keep only the newest frame; upload happens once per repaint
+    m_currentFrame = frame;
+    m_frameDirty = true;
+    update();
+}
+
+void VideoRenderWidget::initializeGL()
+{
+    initializeOpenGLFunctions();
+
+    QOpenGLContext* glContext = context();
+    const bool isGLES = glContext->isOpenGLES();
+    const int majorVersion = glContext->format().majorVersion();
+    m_hasRedTextures = !isGLES || majorVersion >= 3;
+    m_hasUnpackRowLength = !isGLES || majorVersion >= 3;
+    m_hasShortTextures = !isGLES;
+
+    // The context is recreated when the widget is reparented (fullscreen switch)
+    connect(glContext, &QOpenGLContext::aboutToBeDestroyed,
+            this, &VideoRenderWidget::cleanupGL, Qt::DirectConnection);
+
+    if (!createShaderProgram()) {
+        return;
+    }
+
+    glGenTextures(MAX_PLANES, m_textures.data());
+    for (GLuint texture : m_textures) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glGenTextures(1, &m_subtitleTexture);
+    glBindTexture(GL_TEXTURE_2D, m_subtitleTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_planeSizes.fill(QSize());
+    m_planeFormats.fill(0);
+
+    m_vertexArray.create();
+    m_vertexBuffer.create();
+    m_vertexBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+    m_subtitleBuffer.create();
+    m_subtitleBuffer.setUsagePattern(QOpenGLBuffer::DynamicDraw);
+
+    m_glInitialized = true;
+    m_geometryDirty = true;
+
+    // Re-upload whatever we were showing before the context was lost
+    m_frameDirty = m_currentFrame.isValid();
+    m_subtitleDirty = true;
+
+    qDebug() << "VideoRenderWidget initialized:" << (isGLES ? "OpenGL ES" : "OpenGL")
+             << majorVersion << "." << glContext->format().minorVersion();
+}
+
+bool VideoRenderWidget::createShaderProgram()
+{
+    m_program = std::make_unique<QOpenGLShaderProgram>();
+
+    if (!m_program->addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER) ||
+        !m_program->addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER)) {
+        qWarning() << "VideoRenderWidget: Failed to compile shaders:" << m_program->log();
+        m_program.reset();
+        return false;
+    }
+
+    m_program->bindAttributeLocation("a_position", 0);
+    m_program->bindAttributeLocation("a_texCoord", 1);
+
+    if (!m_program->link()) {
+        qWarning() << "VideoRenderWidget: Failed to link shader program:" << m_program->log();
+        m_program.reset();
+        return false;
+    }
+
+    m_program->bind();
+    m_program->setUniformValue("u_plane0", 0);
+    m_program->setUniformValue("u_plane1", 1);
+    m_program->setUniformValue("u_plane2", 2);
+    m_program->release();
+    return true;
+}
+
+void VideoRenderWidget::cleanupGL()
+{
+    if (!m_glInitialized) {
+        return;
+    }
+
+    // Called both from the destructor and when the context goes away
+    makeCurrent();
+    glDeleteTextures(MAX_PLANES, m_textures.data());
+    m_textures.fill(0);
+    glDeleteTextures(1, &m_subtitleTexture);
+    m_subtitleTexture = 0;
+    m_subtitleReady = false;
+    m_subtitleBuffer.destroy();
+    m_vertexBuffer.destroy();
+    m_vertexArray.destroy();
+    m_program.reset();
+    doneCurrent();
+
+    m_layout = PlaneLayout::None;
+    m_glInitialized = false;
+}
+
+void VideoRenderWidget::resizeGL(int w, int h)
+{
+    Q_UNUSED(w)
+    Q_UNUSED(h)
+    m_geometryDirty = true;
+}
+
+void VideoRenderWidget::paintGL()
+{
+    DARKPLAY_TRACE_SCOPE("video", "paintGL");
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (!m_glInitialized || !m_program) {
+        return;
+    }
+
+    if (m_frameDirty) {
+        m_frameDirty = false;
+        if (uploadFrame()) {
+            m_presentPending = true;
+        } else {
+            m_layout = PlaneLayout::None;
+        }
+    }
+
+    if (m_layout == PlaneLayout::None) {
+        return;
+    }
+
+    QOpenGLVertexArrayObject::Binder vertexArrayBinder(&m_vertexArray);
+    if (m_geometryDirty) {
+        updateQuad();
+    }
+
+    m_program->bind();
+    m_program->setUniformValue("u_layout", static_cast<int>(m_layout));
+    m_program->setUniformValue("u_swapRedBlue", static_cast<GLint>(m_swapRedBlue));
+    m_program->setUniformValue("u_luminanceAlpha", static_cast<GLint>(!m_hasRedTextures));
+    m_program->setUniformValue("u_colorMatrix", m_colorMatrix);
+
+    const int planeCount = m_layout == PlaneLayout::Planar ? 3 : (m_layout == PlaneLayout::SemiPlanar ? 2 : 1);
+    for (int i = 0; i < planeCount; ++i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, m_textures[i]);
+    }
+
+    m_vertexBuffer.bind();
+    m_program->enableAttributeArray(0);
+    m_program->enableAttributeArray(1);
+    m_program->setAttributeBuffer(0, GL_FLOAT, 0, 2, 4 * sizeof(GLfloat));
+    m_program->setAttributeBuffer(1, GL_FLOAT, 2 * sizeof(GLfloat), 2, 4 * sizeof(GLfloat));
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    m_program->disableAttributeArray(0);
+    m_program->disableAttributeArray(1);
+    m_vertexBuffer.release();
+    m_program->release();
+    glActiveTexture(GL_TEXTURE0);
+
+    if (!m_subtitleHtml.isEmpty()) {
+        drawSubtitle();
+    }
+
+    // Redraws of the same frame (resize, expose) are not presentations
+    if (m_presentPending) {
+        m_presentPending = false;
+        DARKPLAY_TRACE_INSTANT("video", "framePresented", m_currentFrame.startTime());
+        emit framePresented(m_currentFrame.startTime());
+    }
+}
+
+bool VideoRenderWidget::uploadFrame()
+{
+    DARKPLAY_TRACE_SCOPE("video", "uploadFrame");
+
+    QVideoFrame frame = m_currentFrame;
+    if (!frame.isValid()) {
+        return false; // Playback stopped - show black
+    }
+
+    const QVideoFrameFormat format = frame.surfaceFormat();
+    const QSize frameSize = frame.size();
+    const bool bottomToTop = format.scanLineDirection() == QVideoFrameFormat::BottomToTop;
+    if (frameSize != m_frameSize || format.isMirrored() != m_mirrored || bottomToTop != m_bottomToTop) {
+        m_frameSize = frameSize;
+        m_mirrored = format.isMirrored();
+        m_bottomToTop = bottomToTop;
+        m_geometryDirty = true;
+    }
+
+    if (uploadNativeFrame(frame)) {
+        return true;
+    }
+
+    return uploadFallbackFrame(frame);
+}
+
+bool VideoRenderWidget::uploadNativeFrame(QVideoFrame& frame)
+{
+    const QVideoFrameFormat::PixelFormat pixelFormat = frame.pixelFormat();
+    const bool sixteenBit = pixelFormat == QVideoFrameFormat::Format_P010 ||
+                            pixelFormat == QVideoFrameFormat::Format_P016;
+
+    switch (pixelFormat) {
+    case QVideoFrameFormat::Format_NV12:
+    case QVideoFrameFormat::Format_NV21:
+    case QVideoFrameFormat::Format_YUV420P:
+    case QVideoFrameFormat::Format_YV12:
+    case QVideoFrameFormat::Format_RGBA8888:
+    case QVideoFrameFormat::Format_RGBX8888:
+    case QVideoFrameFormat::Format_BGRA8888:
+    case QVideoFrameFormat::Format_BGRX8888:
+        break;
+    case QVideoFrameFormat::Format_P010:
+    case QVideoFrameFormat::Format_P016:
+        if (!m_hasShortTextures) {
+            return false;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    // Hardware frames are downloaded by map(); software frames map in place
+    if (!frame.map(QVideoFrame::ReadOnly)) {
+        qWarning() << "VideoRenderWidget: Failed to map video frame";
+        return false;
+    }
+
+    const int width = frame.width();
+    const int height = frame.height();
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    switch (pixelFormat) {
+    case QVideoFrameFormat::Format_NV12:
+    case QVideoFrameFormat::Format_NV21:
+    case QVideoFrameFormat::Format_P010:
+    case QVideoFrameFormat::Format_P016: {
+        const int bytesPerChannel = sixteenBit ? 2 : 1;
+        uploadPlane(0, width, height, 1, bytesPerChannel, frame.bits(0), frame.bytesPerLine(0));
+        uploadPlane(1, chromaWidth, chromaHeight, 2, bytesPerChannel, frame.bits(1), frame.bytesPerLine(1));
+        m_layout = PlaneLayout::SemiPlanar;
+        updateColorMatrix(frame.surfaceFormat(), pixelFormat == QVideoFrameFormat::Format_NV21);
+        break;
+    }
+    case QVideoFrameFormat::Format_YUV420P:
+    case QVideoFrameFormat::Format_YV12:
+        uploadPlane(0, width, height, 1, 1, frame.bits(0), frame.bytesPerLine(0));
+        uploadPlane(1, chromaWidth, chromaHeight, 1, 1, frame.bits(1), frame.bytesPerLine(1));
+        uploadPlane(2, chromaWidth, chromaHeight, 1, 1, frame.bits(2), frame.bytesPerLine(2));
+        m_layout = PlaneLayout::Planar;
+        updateColorMatrix(frame.surfaceFormat(), pixelFormat == QVideoFrameFormat::Format_YV12);
+        break;
+    default:
+        uploadPlane(0, width, height, 4, 1, frame.bits(0), frame.bytesPerLine(0));
+        m_layout = PlaneLayout::Packed;
+        m_swapRedBlue = pixelFormat == QVideoFrameFormat::Format_BGRA8888 ||
+                        pixelFormat == QVideoFrameFormat::Format_BGRX8888;
+        break;
+    }
+
+    frame.unmap();
+    return true;
+}
+
+bool VideoRenderWidget::uploadFallbackFrame(const QVideoFrame& frame)
+{
+    if (m_fallbackFormat != frame.pixelFormat()) {
+        m_fallbackFormat = frame.pixelFormat();
+        qWarning() << "VideoRenderWidget: No native upload path for"
+                   << QVideoFrameFormat::pixelFormatToString(m_fallbackFormat)
+                   << "- converting on the CPU";
+    }
+
+    const QImage image = frame.toImage().convertToFormat(QImage::Format_RGBA8888);
+    if (image.isNull()) {
+        return false;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    uploadPlane(0, image.width(), image.height(), 4, 1, image.constBits(), static_cast<int>(image.bytesPerLine()));
+    m_layout = PlaneLayout::Packed;
+    m_swapRedBlue = false;
+
+    // toImage() already applies mirroring and scan line direction
+    if (m_mirrored || m_bottomToTop) {
+        m_mirrored = false;
+        m_bottomToTop = false;
+        m_geometryDirty = true;
+    }
+    return true;
+}
+
+void VideoRenderWidget::uploadPlane(int index, int width, int height, int channels, int bytesPerChannel,
+                                    const uchar* data, int bytesPerLine)
+{
+    GLint internalFormat = GL_RGBA;
+    GLenum dataFormat = GL_RGBA;
+    const GLenum dataType = bytesPerChannel == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+
+    if (channels == 1) {
+        internalFormat = bytesPerChannel == 2 ? GL_R16 : (m_hasRedTextures ? GL_R8 : GL_LUMINANCE);
+        dataFormat = m_hasRedTextures ? GL_RED : GL_LUMINANCE;
+    } else if (channels == 2) {
+        internalFormat = bytesPerChannel == 2 ? GL_RG16 : (m_hasRedTextures ? GL_RG8 : GL_LUMINANCE_ALPHA);
+        dataFormat = m_hasRedTextures ? GL_RG : GL_LUMINANCE_ALPHA;
+    }
+
+    // Upload straight from the mapped decoder memory; repack only on GLES 2 with padded rows
+    const int pixelBytes = channels * bytesPerChannel;
+    const int tightBytesPerLine = width * pixelBytes;
+    const uchar* pixels = data;
+    bool rowLengthSet = false;
+
+    if (bytesPerLine != tightBytesPerLine) {
+        if (m_hasUnpackRowLength && bytesPerLine % pixelBytes == 0) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, bytesPerLine / pixelBytes);
+            rowLengthSet = true;
+        } else {
+            m_repackBuffer.resize(static_cast<qsizetype>(tightBytesPerLine) * height);
+            auto* dst = reinterpret_cast<uchar*>(m_repackBuffer.data());
+            for (int y = 0; y < height; ++y) {
+                std::memcpy(dst + static_cast<qsizetype>(y) * tightBytesPerLine,
+                            data + static_cast<qsizetype>(y) * bytesPerLine, tightBytesPerLine);
+            }
+            pixels = dst;
+        }
+    }
+
+    glActiveTexture(GL_TEXTURE0 + index);
+    glBindTexture(GL_TEXTURE_2D, m_textures[index]);
+
+    // Reallocate storage only when the plane geometry or format changes
+    const QSize planeSize(width, height);
+    if (m_planeSizes[index] != planeSize || m_planeFormats[index] != internalFormat) {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, dataFormat, dataType, pixels);
+        m_planeSizes[index] = planeSize;
+        m_planeFormats[index] = internalFormat;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, dataFormat, dataType, pixels);
+    }
+
+    if (rowLengthSet) {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+}
+
+void VideoRenderWidget::updateColorMatrix(const QVideoFrameFormat& format, bool swapChroma)
+{
+    m_colorMatrix = yuvToRgbMatrix(format.colorSpace(), format.colorRange(), format.frameHeight(), swapChroma);
+    m_swapRedBlue = false;
+}
+
+void VideoRenderWidget::updateQuad()
+{
+    m_geometryDirty = false;
+
+    // The picture is laid out on the wall - the widget itself unless it is a wall tile
+    const bool tiled = !m_wall.isEmpty() && !m_wallViewport.isEmpty();
+    const QRectF wall = tiled ? m_wall : QRectF(rect());
+    const QRectF viewport = tiled ? m_wallViewport : QRectF(rect());
+
+    // Mirroring QVideoWidget's aspect modes
+    QRectF picture = wall;
+    if (m_frameSize.isValid() && !wall.isEmpty() && m_aspectRatioMode != Qt::IgnoreAspectRatio) {
+        const QSizeF scaled = QSizeF(m_frameSize).scaled(wall.size(), m_aspectRatioMode);
+        picture = QRectF(QPointF(wall.center().x() - scaled.width() / 2.0, wall.center().y() - scaled.height() / 2.0),
+                         scaled);
+    }
+    const QRectF visible = picture.intersected(viewport);
+
+    // Subtitles are laid out against the visible part of the picture
+    const qreal toWidgetX = viewport.width() > 0 ? width() / viewport.width() : 0.0;
+    const qreal toWidgetY = viewport.height() > 0 ? height() / viewport.height() : 0.0;
+    m_videoRect = visible.isEmpty()
+        ? QRectF()
+        : QRectF((visible.left() - viewport.left()) * toWidgetX, (visible.top() - viewport.top()) * toWidgetY,
+                 visible.width() * toWidgetX, visible.height() * toWidgetY);
+    m_subtitleDirty = true;
+
+    // Viewport to normalised device coordinates, and the visible part of the picture to texture space
+    float x0 = 0.0f, x1 = 0.0f, y0 = 0.0f, y1 = 0.0f;
+    float u0 = 0.0f, u1 = 1.0f, v0 = 0.0f, v1 = 1.0f;
+    if (!visible.isEmpty()) {
+        x0 = static_cast<float>(-1.0 + 2.0 * (visible.left() - viewport.left()) / viewport.width());
+        x1 = static_cast<float>(-1.0 + 2.0 * (visible.right() - viewport.left()) / viewport.width());
+        y0 = static_cast<float>(1.0 - 2.0 * (visible.top() - viewport.top()) / viewport.height());
+        y1 = static_cast<float>(1.0 - 2.0 * (visible.bottom() - viewport.top()) / viewport.height());
+        u0 = static_cast<float>((visible.left() - picture.left()) / picture.width());
+        u1 = static_cast<float>((visible.right() - picture.left()) / picture.width());
+        v0 = static_cast<float>((visible.top() - picture.top()) / picture.height());
+        v1 = static_cast<float>((visible.bottom() - picture.top()) / picture.height());
+    }
+
+    const float left = m_mirrored ? 1.0f - u0 : u0;
+    const float right = m_mirrored ? 1.0f - u1 : u1;
+    const float top = m_bottomToTop ? 1.0f - v0 : v0;
+    const float bottom = m_bottomToTop ? 1.0f - v1 : v1;
+
+    // Interleaved position / texture coordinate, triangle strip
+    const GLfloat vertices[] = {
+        x0, y1, left,  bottom,
+        x1, y1, right, bottom,
+        x0, y0, left,  top,
+        x1, y0, right, top,
+    };
+
+    m_vertexBuffer.bind();
+    m_vertexBuffer.allocate(vertices, sizeof(vertices));
+    m_vertexBuffer.release();
+}
+
+void VideoRenderWidget::drawSubtitle()
+{
+    if (m_subtitleDirty) {
+        m_subtitleDirty = false;
+        uploadSubtitle();
+    }
+    if (!m_subtitleReady) {
+        return;
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    m_program->bind();
+    m_program->setUniformValue("u_layout", static_cast<int>(PlaneLayout::Overlay));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_subtitleTexture);
+
+    m_subtitleBuffer.bind();
+    m_program->enableAttributeArray(0);
+    m_program->enableAttributeArray(1);
+    m_program->setAttributeBuffer(0, GL_FLOAT, 0, 2, 4 * sizeof(GLfloat));
+    m_program->setAttributeBuffer(1, GL_FLOAT, 2 * sizeof(GLfloat), 2, 4 * sizeof(GLfloat));
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    m_program->disableAttributeArray(0);
+    m_program->disableAttributeArray(1);
+    m_subtitleBuffer.release();
+    m_program->release();
+    glDisable(GL_BLEND);
+}
+
+void VideoRenderWidget::uploadSubtitle()
+{
+    m_subtitleReady = false;
+    if (m_subtitleHtml.isEmpty() || m_videoRect.isEmpty()) {
+        return;
+    }
+
+    const qreal fontPixels = std::max(SUBTITLE_MIN_FONT_PX, m_videoRect.height() * SUBTITLE_FONT_SCALE);
+    const qreal outline = std::max(1.0, fontPixels * SUBTITLE_OUTLINE_SCALE);
+    const qreal maxWidth = m_videoRect.width() * SUBTITLE_WIDTH_FRACTION;
+
+    QFont subtitleFont = font();
+    subtitleFont.setPixelSize(qRound(fontPixels));
+    subtitleFont.setWeight(QFont::DemiBold);
+
+    QTextDocument document;
+    document.setDefaultFont(subtitleFont);
+    document.setDocumentMargin(outline); // Room for the outline
+    document.setDefaultTextOption(QTextOption(Qt::AlignHCenter));
+    document.setHtml(m_subtitleHtml);
+    document.setTextWidth(maxWidth);
+    // Shrink to the widest line, so the texture covers no more than the text
+    document.setTextWidth(std::min(maxWidth, document.idealWidth()));
+    const QSizeF textSize = document.size();
+
+    const qreal ratio = devicePixelRatioF();
+    QImage image(QSize(static_cast<int>(std::ceil(textSize.width() * ratio)),
+                       static_cast<int>(std::ceil(textSize.height() * ratio))),
+                 QImage::Format_RGBA8888_Premultiplied);
+    if (image.isNull()) {
+        return;
+    }
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        QAbstractTextDocumentLayout* layout = document.documentLayout();
+        QAbstractTextDocumentLayout::PaintContext context;
+
+        // Outline: the same layout stamped in black around the white text
+        context.palette.setColor(QPalette::Text, Qt::black);
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                if (dx == 0 && dy == 0) {
+                    continue;
+                }
+                painter.save();
+                painter.translate(dx * outline, dy * outline);
+                layout->draw(&painter, context);
+                painter.restore();
+            }
+        }
+        context.palette.setColor(QPalette::Text, Qt::white);
+        layout->draw(&painter, context);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_subtitleTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width(), image.height(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, image.constBits());
+
+    // Bottom centre of the picture, in normalised device coordinates
+    const QRectF target(m_videoRect.center().x() - textSize.width() / 2.0,
+                        m_videoRect.bottom() - m_videoRect.height() * SUBTITLE_BOTTOM_MARGIN - textSize.height(),
+                        textSize.width(), textSize.height());
+    const auto toNdcX = [this](qreal x) { return static_cast<GLfloat>(2.0 * x / width() - 1.0); };
+    const auto toNdcY = [this](qreal y) { return static_cast<GLfloat>(1.0 - 2.0 * y / height()); };
+    const GLfloat left = toNdcX(target.left());
+    const GLfloat right = toNdcX(target.right());
+    const GLfloat top = toNdcY(target.top());
+    const GLfloat bottom = toNdcY(target.bottom());
+
+    const GLfloat vertices[] = {
+        left,  bottom, 0.0f, 1.0f,
+        right, bottom, 1.0f, 1.0f,
+        left,  top,    0.0f, 0.0f,
+        right, top,    1.0f, 0.0f,
+    };
+
+    m_subtitleBuffer.bind();
+    m_subtitleBuffer.allocate(vertices, sizeof(vertices));
+    m_subtitleBuffer.release();
+    m_subtitleReady = true;
+}
+
+} // namespace DarkPlay::UI
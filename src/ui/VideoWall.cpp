@@ -0,0 +1,116 @@
+#include "ui/VideoWall.h"
+#include "ui/VideoRenderWidget.h"
+#include "media/VideoFanout.h"
+#include <QDebug>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <QScreen>
+
+namespace DarkPlay::UI {
+
+VideoWall::VideoWall(Media::VideoFanout* fanout, QObject* parent)
+    : QObject(parent)
+    , m_fanout(fanout)
+    , m_active(false)
+{
+    // Screens plugged in or out while the wall is up get a new layout
+    connect(qGuiApp, &QGuiApplication::screenAdded, this, [this]() {
+        if (m_active) {
+            layoutTiles();
+        }
+    });
+    connect(qGuiApp, &QGuiApplication::screenRemoved, this, [this]() {
+        if (m_active) {
+            layoutTiles();
+        }
+    });
+}
+
+VideoWall::~VideoWall()
+{
+    clearTiles();
+}
+
+void VideoWall::start()
+{
+    if (m_active || !m_fanout) {
+        return;
+    }
+    m_active = true;
+    layoutTiles();
+    emit activeChanged(true);
+}
+
+void VideoWall::stop()
+{
+    if (!m_active) {
+        return;
+    }
+    m_active = false;
+    clearTiles();
+    emit activeChanged(false);
+}
+
+bool VideoWall::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::KeyPress && static_cast<QKeyEvent*>(event)->key() == Qt::Key_Escape) {
+        // Deletes the tile that got the key, so finish delivering first
+        QMetaObject::invokeMethod(this, &VideoWall::stop, Qt::QueuedConnection);
+        return true;
+    }
+    if (event->type() == QEvent::Close) {
+        QMetaObject::invokeMethod(this, &VideoWall::stop, Qt::QueuedConnection);
+        event->ignore();
+        return true;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void VideoWall::layoutTiles()
+{
+    clearTiles();
+    if (!m_fanout) {
+        return;
+    }
+
+    const QList<QScreen*> screens = QGuiApplication::screens();
+    QRect wall;
+    for (const QScreen* screen : screens) {
+        wall = wall.united(screen->geometry());
+    }
+
+    for (QScreen* screen : screens) {
+        auto* tile = new VideoRenderWidget();
+        tile->setWindowFlags(Qt::Window | Qt::FramelessWindowHint);
+        tile->setWindowTitle("DarkPlay Video Wall");
+        tile->setCursor(Qt::BlankCursor);
+        tile->setWallViewport(wall, screen->geometry());
+        tile->installEventFilter(this);
+
+        m_fanout->addOutput(tile->videoSink());
+        connect(tile, &VideoRenderWidget::framePresented, m_fanout.data(), &Media::VideoFanout::reportPresented);
+        if (m_tiles.empty()) {
+            connect(tile, &VideoRenderWidget::framePresented, this, &VideoWall::framePresented);
+        }
+
+        tile->setGeometry(screen->geometry());
+        tile->showFullScreen();
+        m_tiles.push_back(tile);
+    }
+
+    qDebug() << "VideoWall:" << m_tiles.size() << "tiles over" << wall;
+}
+
+void VideoWall::clearTiles()
+{
+    for (VideoRenderWidget* tile : m_tiles) {
+        if (m_fanout) {
+            m_fanout->removeOutput(tile->videoSink());
+        }
+        tile->removeEventFilter(this);
+        delete tile;
+    }
+    m_tiles.clear();
+}
+
+} // namespace DarkPlay::UI
@@ -0,0 +1,102 @@
+#include "utils/AllocationCounter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Constant-initialised, so reading it is safe from the very first allocation of a thread
+thread_local int t_scopeDepth = 0;
+std::atomic<std::uint64_t> g_counted{0};
+
+void* allocate(std::size_t size, std::size_t alignment = 0)
+{
+    if (t_scopeDepth > 0) {
+        g_counted.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (size == 0) {
+        size = 1;
+    }
+
+    for (;;) {
+        // aligned_alloc wants a size that is a multiple of the alignment
+        void* block = alignment == 0 ? std::malloc(size)
+                                     : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        if (block) {
+            return block;
+        }
+        const std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size, std::size_t alignment = 0) noexcept
+{
+    try {
+        return allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+namespace DarkPlay::Utils {
+
+AllocationCounter::Scope::Scope() noexcept
+{
+    ++t_scopeDepth;
+}
+
+AllocationCounter::Scope::~Scope()
+{
+    --t_scopeDepth;
+}
+
+std::uint64_t AllocationCounter::total() noexcept
+{
+    return g_counted.load(std::memory_order_relaxed);
+}
+
+} // namespace DarkPlay::Utils
+
+// Replacement allocation functions; every form releases through free()
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete[](void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t) noexcept { std::free(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { std::free(block); }
+
+void operator delete(void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { std::free(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { std::free(block); }
@@ -0,0 +1,327 @@
+#include "utils/MemoryBudget.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QPointer>
+#include <algorithm>
+
+#if defined(Q_OS_MACOS)
+#include <dispatch/dispatch.h>
+#include <sys/sysctl.h>
+#elif defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace DarkPlay::Utils {
+
+namespace {
+
+constexpr qint64 MB = 1024 * 1024;
+constexpr qint64 MIN_LIMIT_BYTES = 32 * MB;
+constexpr qint64 MAX_LIMIT_BYTES = 512 * MB;
+constexpr qint64 FALLBACK_PHYSICAL_BYTES = 1024 * MB;
+constexpr int PHYSICAL_SHARE = 8; // Caches may use an eighth of RAM, a sixteenth in low-memory mode
+
+#if defined(Q_OS_LINUX)
+constexpr double PSI_SOME_PERCENT = 10.0; // Share of time some task stalled on memory, last 10 s
+constexpr int LOW_AVAILABLE_PERCENT = 10; // MemAvailable below this share of MemTotal
+#elif defined(Q_OS_WIN)
+constexpr int HIGH_MEMORY_LOAD = 90;      // dwMemoryLoad at or above this
+#endif
+
+QPointer<MemoryBudget> s_instance;
+bool s_destroyed = false;
+
+#if defined(Q_OS_LINUX)
+// "Key:   1234 kB" from /proc/meminfo, in bytes; -1 if absent
+qint64 meminfoValue(const QByteArray& meminfo, const QByteArray& key)
+{
+    const qsizetype start = meminfo.indexOf(key);
+    if (start < 0) {
+        return -1;
+    }
+    const qsizetype end = meminfo.indexOf('\n', start);
+    const QList<QByteArray> fields = meminfo.mid(start + key.size(), end - start - key.size()).simplified().split(' ');
+    bool ok = false;
+    const qint64 kilobytes = fields.value(0).toLongLong(&ok);
+    return ok ? kilobytes * 1024 : -1;
+}
+
+QByteArray readProcFile(const char* path)
+{
+    // procfs reports a size of 0, so read to the end rather than by size
+    QFile file(QString::fromLatin1(path));
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+#endif
+
+} // namespace
+
+std::atomic<bool> MemoryBudget::s_lowMemoryMode{false};
+
+MemoryBudget* MemoryBudget::instance()
+{
+    // Parented to the application; consumers torn down after it find no budget to leave
+    if (!s_instance && !s_destroyed && QCoreApplication::instance()) {
+        s_instance = new MemoryBudget(QCoreApplication::instance());
+    }
+    return s_instance;
+}
+
+void MemoryBudget::setLowMemoryMode(bool enabled) noexcept
+{
+    s_lowMemoryMode.store(enabled, std::memory_order_relaxed);
+}
+
+bool MemoryBudget::isLowMemoryMode() noexcept
+{
+    return s_lowMemoryMode.load(std::memory_order_relaxed);
+}
+
+qint64 MemoryBudget::nowMs()
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+MemoryBudget::MemoryBudget(QObject* parent)
+    : QObject(parent)
+    , m_limit(defaultLimit(physicalMemoryBytes()))
+    , m_checkPending(false)
+    , m_evictedBytes(0)
+    , m_underPressure(false)
+    , m_pressureSource(nullptr)
+{
+    m_checkTimer.setInterval(CHECK_INTERVAL_MS);
+    connect(&m_checkTimer, &QTimer::timeout, this, [this]() {
+        pollPressure();
+        check();
+    });
+    m_checkTimer.start();
+
+    setupPressureNotifications();
+    qDebug() << "MemoryBudget: Limit" << m_limit.load() / MB << "MB" << (isLowMemoryMode() ? "(low-memory mode)" : "");
+}
+
+MemoryBudget::~MemoryBudget()
+{
+    s_destroyed = true;
+#if defined(Q_OS_MACOS)
+    if (m_pressureSource) {
+        auto source = static_cast<dispatch_source_t>(m_pressureSource);
+        dispatch_source_cancel(source);
+        dispatch_release(source);
+    }
+#endif
+}
+
+void MemoryBudget::registerConsumer(const QString& name, MemoryConsumer* consumer)
+{
+    if (!consumer) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_consumers.push_back(Consumer{name, consumer});
+    }
+    requestCheck();
+}
+
+void MemoryBudget::unregisterConsumer(MemoryConsumer* consumer)
+{
+    // Waits out a check that is calling the consumer right now
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::erase_if(m_consumers, [consumer](const Consumer& entry) { return entry.consumer == consumer; });
+}
+
+void MemoryBudget::setLimit(qint64 bytes)
+{
+    m_limit.store(bytes > 0 ? std::max(bytes, MIN_LIMIT_BYTES) : defaultLimit(physicalMemoryBytes()),
+                  std::memory_order_relaxed);
+    requestCheck();
+}
+
+void MemoryBudget::requestCheck()
+{
+    if (m_checkPending.exchange(true)) {
+        return;
+    }
+    QMetaObject::invokeMethod(this, [this]() {
+        m_checkPending = false;
+        check();
+    }, Qt::QueuedConnection);
+}
+
+MemoryStats MemoryBudget::stats() const
+{
+    MemoryStats stats;
+    stats.limitBytes = limit();
+    stats.underPressure = m_underPressure;
+    stats.lowMemoryMode = isLowMemoryMode();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.evictedBytes = m_evictedBytes;
+    for (const Consumer& entry : m_consumers) {
+        const qint64 bytes = entry.consumer->memoryBytes();
+        stats.totalBytes += bytes;
+        const auto same = std::find_if(stats.consumers.begin(), stats.consumers.end(),
+                                       [&entry](const MemoryUsage& usage) { return usage.name == entry.name; });
+        if (same != stats.consumers.end()) {
+            same->bytes += bytes;
+        } else {
+            stats.consumers.append(MemoryUsage{entry.name, bytes});
+        }
+    }
+    return stats;
+}
+
+void MemoryBudget::check()
+{
+    // Under pressure the caches give back half of what the limit allows them
+    const qint64 target = m_underPressure ? limit() / 2 : limit();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    enforceLocked(target);
+}
+
+void MemoryBudget::enforceLocked(qint64 target)
+{
+    qint64 total = 0;
+    for (const Consumer& entry : m_consumers) {
+        total += entry.consumer->memoryBytes();
+    }
+    if (total <= target) {
+        return;
+    }
+
+    // A slice at a time from whoever holds the oldest entry: LRU across every cache
+    const qint64 before = total;
+    std::vector<bool> exhausted(m_consumers.size(), false);
+    while (total > target) {
+        int victim = -1;
+        qint64 victimUse = 0;
+        for (size_t i = 0; i < m_consumers.size(); ++i) {
+            if (exhausted[i]) {
+                continue;
+            }
+            const qint64 oldest = m_consumers[i].consumer->oldestUseMs();
+            if (oldest < 0) {
+                exhausted[i] = true;
+            } else if (victim < 0 || oldest < victimUse) {
+                victim = static_cast<int>(i);
+                victimUse = oldest;
+            }
+        }
+        if (victim < 0) {
+            break;
+        }
+
+        const qint64 freed = m_consumers[victim].consumer->evict(std::min(total - target, EVICT_SLICE_BYTES));
+        if (freed <= 0) {
+            exhausted[victim] = true;
+            continue;
+        }
+        total -= freed;
+        m_evictedBytes += freed;
+    }
+
+    qDebug() << "MemoryBudget: Evicted" << (before - total) / 1024 << "KB, now" << total / 1024
+             << "KB of" << target / 1024 << "KB" << (m_underPressure ? "under pressure" : "");
+}
+
+void MemoryBudget::pollPressure()
+{
+#if defined(Q_OS_LINUX)
+    bool pressure = false;
+
+    // PSI, where the kernel has it: "some avg10=12.34 avg60=... total=..."
+    const QByteArray psi = readProcFile("/proc/pressure/memory");
+    if (psi.startsWith("some ")) {
+        const qsizetype start = psi.indexOf("avg10=");
+        if (start >= 0) {
+            const qsizetype end = psi.indexOf(' ', start);
+            pressure = psi.mid(start + 6, end - start - 6).toDouble() >= PSI_SOME_PERCENT;
+        }
+    }
+
+    const QByteArray meminfo = readProcFile("/proc/meminfo");
+    const qint64 total = meminfoValue(meminfo, "MemTotal:");
+    const qint64 available = meminfoValue(meminfo, "MemAvailable:");
+    if (total > 0 && available >= 0 && available * 100 < total * LOW_AVAILABLE_PERCENT) {
+        pressure = true;
+    }
+    setUnderPressure(pressure);
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status)) {
+        setUnderPressure(status.dwMemoryLoad >= HIGH_MEMORY_LOAD);
+    }
+#endif
+    // macOS pushes its events instead, see setupPressureNotifications()
+}
+
+void MemoryBudget::setUnderPressure(bool underPressure)
+{
+    if (underPressure == m_underPressure) {
+        return;
+    }
+    m_underPressure = underPressure;
+    qDebug() << "MemoryBudget:" << (underPressure ? "System memory pressure, trimming caches" : "Memory pressure over");
+    emit pressureChanged(underPressure);
+    if (underPressure) {
+        check();
+    }
+}
+
+void MemoryBudget::setupPressureNotifications()
+{
+#if defined(Q_OS_MACOS)
+    dispatch_source_t source = dispatch_source_create(
+        DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0,
+        DISPATCH_MEMORYPRESSURE_NORMAL | DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+        dispatch_get_main_queue());
+    if (!source) {
+        return;
+    }
+    dispatch_set_context(source, this);
+    dispatch_source_set_event_handler_f(source, [](void* context) {
+        auto* budget = static_cast<MemoryBudget*>(context);
+        const auto level = dispatch_source_get_data(static_cast<dispatch_source_t>(budget->m_pressureSource));
+        const bool pressure = (level & (DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL)) != 0;
+        QMetaObject::invokeMethod(budget, [budget, pressure]() { budget->setUnderPressure(pressure); },
+                                  Qt::QueuedConnection);
+    });
+    m_pressureSource = source;
+    dispatch_resume(source);
+#endif
+}
+
+qint64 MemoryBudget::physicalMemoryBytes()
+{
+#if defined(Q_OS_LINUX)
+    const qint64 total = meminfoValue(readProcFile("/proc/meminfo"), "MemTotal:");
+    return total > 0 ? total : FALLBACK_PHYSICAL_BYTES;
+#elif defined(Q_OS_MACOS)
+    quint64 total = 0;
+    size_t length = sizeof(total);
+    return sysctlbyname("hw.memsize", &total, &length, nullptr, 0) == 0 ? static_cast<qint64>(total)
+                                                                         : FALLBACK_PHYSICAL_BYTES;
+#elif defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    return GlobalMemoryStatusEx(&status) ? static_cast<qint64>(status.ullTotalPhys) : FALLBACK_PHYSICAL_BYTES;
+#else
+    return FALLBACK_PHYSICAL_BYTES;
+#endif
+}
+
+qint64 MemoryBudget::defaultLimit(qint64 physicalBytes)
+{
+    const int share = isLowMemoryMode() ? PHYSICAL_SHARE * 2 : PHYSICAL_SHARE;
+    return std::clamp(physicalBytes / share, MIN_LIMIT_BYTES, MAX_LIMIT_BYTES);
+}
+
+} // namespace DarkPlay::Utils
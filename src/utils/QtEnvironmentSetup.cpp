@@ -1,4 +1,5 @@
 #include "utils/QtEnvironmentSetup.h"
+#include "media/HardwareDecoding.h"
 #include <QDebug>
 #include <QLoggingCategory>
 #include <cstdlib>
@@ -7,7 +8,7 @@ Q_LOGGING_CATEGORY(qtEnvSetup, "darkplay.utils.qtenv")
 
 namespace DarkPlay::Utils {
 
-void setupOptimalQtEnvironment() {
+void setupOptimalQtEnvironment(bool hardwareAcceleration) {
     qCDebug(qtEnvSetup) << "Setting up optimal Qt environment for stable video rendering...";
 
     // Platform settings
@@ -18,16 +19,20 @@ void setupOptimalQtEnvironment() {
 
     // OpenGL settings for stable rendering
     if (!qEnvironmentVariableIsSet("QT_OPENGL")) {
-        qputenv("QT_OPENGL", "desktop");
-        qCDebug(qtEnvSetup) << "Set QT_OPENGL=desktop";
+        const QByteArray openGl = hardwareAcceleration ? "desktop" : "software";
+        qputenv("QT_OPENGL", openGl);
+        qCDebug(qtEnvSetup) << "Set QT_OPENGL to" << openGl;
     }
 
-    // Multimedia settings
+    // Multimedia settings - the FFmpeg backend is the one with hardware decoding
     if (!qEnvironmentVariableIsSet("QT_MULTIMEDIA_PREFERRED_PLUGINS")) {
         qputenv("QT_MULTIMEDIA_PREFERRED_PLUGINS", "ffmpeg");
         qCDebug(qtEnvSetup) << "Set QT_MULTIMEDIA_PREFERRED_PLUGINS=ffmpeg";
     }
 
+    // Decode and encode APIs from what this machine actually has
+    Media::HardwareDecoding::configure(hardwareAcceleration);
+
     // Qt Quick settings for stability
     if (!qEnvironmentVariableIsSet("QT_QUICK_BACKEND")) {
         qputenv("QT_QUICK_BACKEND", "software");
@@ -71,6 +76,8 @@ void logQtEnvironmentInfo() {
     qCInfo(qtEnvSetup) << "QT_QPA_PLATFORM:" << qEnvironmentVariable("QT_QPA_PLATFORM", "not set");
     qCInfo(qtEnvSetup) << "QT_OPENGL:" << qEnvironmentVariable("QT_OPENGL", "not set");
     qCInfo(qtEnvSetup) << "QT_MULTIMEDIA_PREFERRED_PLUGINS:" << qEnvironmentVariable("QT_MULTIMEDIA_PREFERRED_PLUGINS", "not set");
+    qCInfo(qtEnvSetup) << "QT_FFMPEG_DECODING_HW_DEVICE_TYPES:" << qEnvironmentVariable("QT_FFMPEG_DECODING_HW_DEVICE_TYPES", "not set");
+    qCInfo(qtEnvSetup) << "QT_FFMPEG_ENCODING_HW_DEVICE_TYPES:" << qEnvironmentVariable("QT_FFMPEG_ENCODING_HW_DEVICE_TYPES", "not set");
     qCInfo(qtEnvSetup) << "QT_QUICK_BACKEND:" << qEnvironmentVariable("QT_QUICK_BACKEND", "not set");
     qCInfo(qtEnvSetup) << "QSG_RENDER_LOOP:" << qEnvironmentVariable("QSG_RENDER_LOOP", "not set");
     qCInfo(qtEnvSetup) << "QT_XCB_GL_INTEGRATION:" << qEnvironmentVariable("QT_XCB_GL_INTEGRATION", "not set");
@@ -0,0 +1,262 @@
+#include "utils/Trace.h"
+#include <QDebug>
+
+#ifdef DARKPLAY_ENABLE_TRACING
+#include <QCoreApplication>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#endif
+
+namespace DarkPlay::Utils {
+
+#ifdef DARKPLAY_ENABLE_TRACING
+
+namespace {
+
+constexpr size_t EVENTS_PER_THREAD = 4096; // About 200 KB a thread
+constexpr size_t MAX_THREAD_BUFFERS = 64;  // Past this, exited threads' buffers are reused
+
+// Seqlock: odd while the owning thread rewrites it, so dump() skips torn events
+struct Slot {
+    std::atomic<quint64> sequence{0};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<qint64> startNs{0};
+    std::atomic<qint64> durationNs{0}; // -1 for an instant
+    std::atomic<qint64> value{0};
+};
+
+struct ThreadBuffer {
+    std::array<Slot, EVENTS_PER_THREAD> events;
+    std::atomic<quint64> written{0};
+    std::atomic<bool> alive{true};
+    int threadId{0};
+    QString threadName; // Guarded by the registry mutex
+};
+
+struct Registry {
+    QMutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    int nextThreadId{1};
+};
+
+// Never destroyed: threads still running at exit keep writing into their buffers
+Registry& registry()
+{
+    static auto* instance = new Registry();
+    return *instance;
+}
+
+qint64 nowNs() noexcept
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+ThreadBuffer* registerThread()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    ThreadBuffer* buffer = nullptr;
+    if (reg.buffers.size() < MAX_THREAD_BUFFERS) {
+        reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = reg.buffers.back().get();
+    } else {
+        for (const auto& candidate : reg.buffers) {
+            if (!candidate->alive.load(std::memory_order_acquire)) {
+                buffer = candidate.get();
+                break;
+            }
+        }
+        if (!buffer) {
+            return nullptr; // Every buffer belongs to a live thread: this one goes untraced
+        }
+        buffer->written.store(0, std::memory_order_relaxed);
+        buffer->alive.store(true, std::memory_order_relaxed);
+    }
+
+    buffer->threadId = reg.nextThreadId++;
+    QThread* thread = QThread::currentThread();
+    buffer->threadName = thread ? thread->objectName() : QString();
+    if (buffer->threadName.isEmpty()) {
+        buffer->threadName = (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            ? QString("Main")
+            : QString("Thread %1").arg(buffer->threadId);
+    }
+    return buffer;
+}
+
+// Hands the buffer back once its thread exits
+struct ThreadSlot {
+    ThreadBuffer* buffer{nullptr};
+    bool registered{false};
+
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            buffer->alive.store(false, std::memory_order_release);
+        }
+    }
+};
+
+ThreadBuffer* threadBuffer()
+{
+    thread_local ThreadSlot slot;
+    if (!slot.registered) {
+        slot.registered = true;
+        slot.buffer = registerThread();
+    }
+    return slot.buffer;
+}
+
+void record(const char* category, const char* name, qint64 startNs, qint64 durationNs, qint64 value) noexcept
+{
+    ThreadBuffer* buffer = threadBuffer();
+    if (!buffer) {
+        return;
+    }
+
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    Slot& slot = buffer->events[index % EVENTS_PER_THREAD];
+    const quint64 sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void appendJsonString(QByteArray& out, const char* text)
+{
+    out += '"';
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+        }
+        out += (static_cast<unsigned char>(*c) < 0x20) ? ' ' : *c;
+    }
+    out += '"';
+}
+
+void appendMicroseconds(QByteArray& out, qint64 ns)
+{
+    out += QByteArray::number(ns / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+Trace::Span::Span(const char* category, const char* name) noexcept
+    : m_category(category)
+    , m_name(name)
+    , m_startNs(nowNs())
+{
+}
+
+Trace::Span::~Span()
+{
+    record(m_category, m_name, m_startNs, nowNs() - m_startNs, 0);
+}
+
+void Trace::instant(const char* category, const char* name, qint64 value) noexcept
+{
+    record(category, name, nowNs(), -1, value);
+}
+
+bool Trace::dump(const QString& path)
+{
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out;
+    out.reserve(1024 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    int eventCount = 0;
+    int threads = 0;
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    Registry& reg = registry();
+    {
+        QMutexLocker locker(&reg.mutex);
+        for (const auto& buffer : reg.buffers) {
+            const QByteArray tid = QByteArray::number(buffer->threadId);
+            separator();
+            out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"args\":{\"name\":";
+            appendJsonString(out, buffer->threadName.toUtf8().constData());
+            out += "}}";
+            ++threads;
+
+            const quint64 written = buffer->written.load(std::memory_order_acquire);
+            const quint64 begin = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+            for (quint64 i = begin; i < written; ++i) {
+                const Slot& slot = buffer->events[i % EVENTS_PER_THREAD];
+                const quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence & 1) {
+                    continue;
+                }
+                const char* category = slot.category.load(std::memory_order_relaxed);
+                const char* name = slot.name.load(std::memory_order_relaxed);
+                const qint64 startNs = slot.startNs.load(std::memory_order_relaxed);
+                const qint64 durationNs = slot.durationNs.load(std::memory_order_relaxed);
+                const qint64 value = slot.value.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != sequence || !name) {
+                    continue; // Overwritten while we read it
+                }
+
+                separator();
+                out += "{\"name\":";
+                appendJsonString(out, name);
+                out += ",\"cat\":";
+                appendJsonString(out, category);
+                out += ",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":";
+                appendMicroseconds(out, startNs);
+                if (durationNs >= 0) {
+                    out += ",\"ph\":\"X\",\"dur\":";
+                    appendMicroseconds(out, durationNs);
+                } else {
+                    out += ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"value\":" + QByteArray::number(value) + '}';
+                }
+                out += '}';
+                ++eventCount;
+            }
+        }
+    }
+    out += "]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        qWarning() << "Trace: Could not write" << path << "-" << file.errorString();
+        return false;
+    }
+    qDebug() << "Trace: Wrote" << eventCount << "events from" << threads << "threads to" << path;
+    return true;
+}
+
+#else
+
+bool Trace::dump(const QString& path)
+{
+    qWarning() << "Trace: Not written to" << path << "- built without DARKPLAY_ENABLE_TRACING";
+    return false;
+}
+
+#endif
+
+} // namespace DarkPlay::Utils